@@ -291,6 +291,8 @@ function(generate_build_flags)
         set(BUILD_CRL_MONITOR "yes" PARENT_SCOPE)
     endif()
     set(BUILD_QUIC ${WOLFSSL_QUIC} PARENT_SCOPE)
+    set(BUILD_KTLS ${WOLFSSL_KTLS} PARENT_SCOPE)
+    set(BUILD_DTLS_DISPATCH ${WOLFSSL_DTLS_DISPATCH} PARENT_SCOPE)
     set(BUILD_WNR ${WOLFSSL_WNR} PARENT_SCOPE)
     if(WOLFSSL_SRP OR WOLFSSL_USER_SETTINGS)
         set(BUILD_SRP "yes" PARENT_SCOPE)
@@ -638,6 +640,9 @@ function(generate_lib_src_list LIB_SOURCES)
 
         if(NOT BUILD_FIPS_V2 AND BUILD_RNG)
             list(APPEND LIB_SOURCES wolfcrypt/src/random.c)
+            if(WOLFSSL_RNG_BANK)
+                list(APPEND LIB_SOURCES wolfcrypt/src/rng_bank.c)
+            endif()
         endif()
 
         if(NOT BUILD_FIPS_V2)
@@ -1261,6 +1266,10 @@ function(generate_lib_src_list LIB_SOURCES)
                 list(APPEND LIB_SOURCES src/quic.c)
             endif()
 
+            if(BUILD_KTLS)
+                list(APPEND LIB_SOURCES src/ktls.c)
+            endif()
+
             if(BUILD_OCSP)
                 list(APPEND LIB_SOURCES src/ocsp.c)
             endif()
@@ -1277,6 +1286,10 @@ function(generate_lib_src_list LIB_SOURCES)
                 list(APPEND LIB_SOURCES src/dtls.c)
             endif()
 
+            if(BUILD_DTLS_DISPATCH)
+                list(APPEND LIB_SOURCES src/dtls_dispatch.c)
+            endif()
+
             if(BUILD_QUIC)
                 list(APPEND LIB_SOURCES src/quic.c)
             endif()
@@ -0,0 +1,449 @@
+/* ca_bench.c
+ *
+ * Copyright (C) 2006-2026 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+/*
+ * CA load and lookup benchmark over a synthetic trust bundle.
+ *
+ *   ./ca_bench -n 40000 -d 1
+ *
+ * -n self signed CA certs are generated, each with its own subject name and
+ * subject key identifier. Bundles of an eighth, a quarter, a half and all of
+ * them are loaded into a new certificate manager with
+ * wolfSSL_CertManagerLoadCA(). A leaf cert issued by the last CA of the
+ * bundle is then verified with wolfSSL_CertManagerVerifyBuffer() for -d
+ * seconds, which looks the CA up by the leaf's authority key identifier.
+ *
+ * Files read by wolfSSL_CertManagerLoadCA() are limited to
+ * MAX_WOLFSSL_FILE_SIZE, so the bundle is written as PEM files of at most
+ * -c certs into a temporary directory that is loaded as the CA path. With -b
+ * the bundle is loaded from one buffer with wolfSSL_CertManagerLoadCABuffer()
+ * instead.
+ *
+ * Compare a build with --enable-ca-index (WOLFSSL_CA_INDEX) against one
+ * without to see the effect of the CA index. Without it, loading is
+ * quadratic in the number of CAs.
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+#ifndef WOLFSSL_USER_SETTINGS
+    #include <wolfssl/options.h>
+#endif
+
+#include <wolfssl/wolfcrypt/settings.h>
+#include <wolfssl/ssl.h>
+
+#include <stdio.h>
+
+#if defined(WOLFSSL_CERT_GEN) && defined(WOLFSSL_CERT_EXT) && \
+    defined(HAVE_ECC) && !defined(NO_CERTS) && !defined(NO_ASN) && \
+    !defined(NO_FILESYSTEM) && !defined(NO_WOLFSSL_DIR) && \
+    !defined(USE_WINDOWS_API)
+    #define CA_BENCH_ENABLED
+#endif
+
+#ifdef CA_BENCH_ENABLED
+
+#include <wolfssl/wolfcrypt/asn_public.h>
+#include <wolfssl/wolfcrypt/ecc.h>
+#include <wolfssl/wolfcrypt/random.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+
+#define DEFAULT_CAS        40000
+#define DEFAULT_DURATION   1
+#define DEFAULT_PER_FILE   2000
+#define MAX_CAS            1000000
+#define CERT_DER_MAX       1024
+#define CERT_PEM_MAX       (CERT_DER_MAX * 2)
+
+/* A generated cert in DER and PEM. */
+typedef struct BenchCert {
+    byte der[CERT_DER_MAX];
+    int  derSz;
+    char pem[CERT_PEM_MAX];
+    int  pemSz;
+} BenchCert;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        perror("clock_gettime");
+        exit(EXIT_FAILURE);
+    }
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* Key identifier of CA number n. Spread over all bytes like a real one. */
+static void make_kid(int n, byte* kid)
+{
+    word32 x = (word32)n * 2654435761U;
+    int i;
+
+    for (i = 0; i < 20; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        kid[i] = (byte)(x ^ (word32)n);
+    }
+}
+
+static int make_pem(BenchCert* c)
+{
+    c->pemSz = wc_DerToPem(c->der, (word32)c->derSz, (byte*)c->pem,
+        sizeof(c->pem), CERT_TYPE);
+    return (c->pemSz > 0) ? 0 : -1;
+}
+
+/* Make self signed CA cert number n. */
+static int make_ca(int n, ecc_key* key, WC_RNG* rng, BenchCert* c)
+{
+    Cert cert;
+    int ret;
+
+    if (wc_InitCert(&cert) != 0)
+        return -1;
+    strncpy(cert.subject.country, "US", CTC_NAME_SIZE);
+    strncpy(cert.subject.org, "wolfSSL", CTC_NAME_SIZE);
+    (void)snprintf(cert.subject.commonName, CTC_NAME_SIZE,
+        "Bench Tenant CA %d", n);
+    cert.selfSigned = 1;
+    cert.isCA = 1;
+    cert.sigType = CTC_SHA256wECDSA;
+    make_kid(n, cert.skid);
+    cert.skidSz = 20;
+
+    ret = wc_MakeCert(&cert, c->der, sizeof(c->der), NULL, key, rng);
+    if (ret > 0) {
+        ret = wc_SignCert(cert.bodySz, cert.sigType, c->der, sizeof(c->der),
+            NULL, key, rng);
+    }
+    if (ret <= 0)
+        return -1;
+    c->derSz = ret;
+    return make_pem(c);
+}
+
+/* Make a leaf cert issued by CA number n. */
+static int make_leaf(int n, const BenchCert* ca, ecc_key* key, WC_RNG* rng,
+    BenchCert* c)
+{
+    Cert cert;
+    int ret;
+
+    if (wc_InitCert(&cert) != 0)
+        return -1;
+    strncpy(cert.subject.country, "US", CTC_NAME_SIZE);
+    strncpy(cert.subject.org, "wolfSSL", CTC_NAME_SIZE);
+    strncpy(cert.subject.commonName, "www.wolfssl.com", CTC_NAME_SIZE);
+    cert.sigType = CTC_SHA256wECDSA;
+    if (wc_SetIssuerBuffer(&cert, ca->der, ca->derSz) != 0)
+        return -1;
+    make_kid(n, cert.akid);
+    cert.akidSz = 20;
+
+    ret = wc_MakeCert(&cert, c->der, sizeof(c->der), NULL, key, rng);
+    if (ret > 0) {
+        ret = wc_SignCert(cert.bodySz, cert.sigType, c->der, sizeof(c->der),
+            NULL, key, rng);
+    }
+    if (ret <= 0)
+        return -1;
+    c->derSz = ret;
+    return 0;
+}
+
+/* Write the first cnt CAs as PEM files of at most perFile certs into dir. */
+static int write_bundle(const char* dir, const BenchCert* cas, int cnt,
+    int perFile, int* files)
+{
+    char path[256];
+    FILE* f = NULL;
+    int i;
+
+    *files = 0;
+    for (i = 0; i < cnt; i++) {
+        if (i % perFile == 0) {
+            if (f != NULL)
+                fclose(f);
+            (void)snprintf(path, sizeof(path), "%s/bundle-%05d.pem", dir,
+                *files);
+            f = fopen(path, "wb");
+            if (f == NULL) {
+                fprintf(stderr, "Opening %s failed\n", path);
+                return -1;
+            }
+            (*files)++;
+        }
+        if (fwrite(cas[i].pem, 1, (size_t)cas[i].pemSz, f) !=
+                (size_t)cas[i].pemSz) {
+            fprintf(stderr, "Writing %s failed\n", path);
+            fclose(f);
+            return -1;
+        }
+    }
+    if (f != NULL)
+        fclose(f);
+    return 0;
+}
+
+static void remove_bundle(const char* dir, int files)
+{
+    char path[256];
+    int i;
+
+    for (i = 0; i < files; i++) {
+        (void)snprintf(path, sizeof(path), "%s/bundle-%05d.pem", dir, i);
+        (void)remove(path);
+    }
+}
+
+/* Concatenate the first cnt CAs as PEM. */
+static char* make_buffer(const BenchCert* cas, int cnt, long* sz)
+{
+    char* buf;
+    long len = 0;
+    int i;
+
+    for (i = 0; i < cnt; i++)
+        len += cas[i].pemSz;
+    buf = (char*)malloc((size_t)len);
+    if (buf == NULL)
+        return NULL;
+    len = 0;
+    for (i = 0; i < cnt; i++) {
+        memcpy(buf + len, cas[i].pem, (size_t)cas[i].pemSz);
+        len += cas[i].pemSz;
+    }
+    *sz = len;
+    return buf;
+}
+
+static int run_bench(const BenchCert* cas, int cnt, const BenchCert* leaf,
+    const char* dir, int perFile, int duration)
+{
+    WOLFSSL_CERT_MANAGER* cm = NULL;
+    char* buf = NULL;
+    long bufSz = 0;
+    int files = 0;
+    double start;
+    double loadTime;
+    double elapsed;
+    long lookups = 0;
+    int ret;
+
+    if (dir != NULL) {
+        ret = write_bundle(dir, cas, cnt, perFile, &files);
+    }
+    else {
+        buf = make_buffer(cas, cnt, &bufSz);
+        ret = (buf != NULL) ? 0 : -1;
+    }
+    cm = wolfSSL_CertManagerNew();
+    if (ret != 0 || cm == NULL) {
+        fprintf(stderr, "Setup failed\n");
+        ret = -1;
+        goto done;
+    }
+
+    start = now_sec();
+    if (dir != NULL) {
+        ret = wolfSSL_CertManagerLoadCA(cm, NULL, dir);
+    }
+    else {
+        ret = wolfSSL_CertManagerLoadCABuffer(cm, (const byte*)buf, bufSz,
+            WOLFSSL_FILETYPE_PEM);
+    }
+    loadTime = now_sec() - start;
+    if (ret != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "Loading CAs failed: %d\n", ret);
+        ret = -1;
+        goto done;
+    }
+
+    start = now_sec();
+    do {
+        ret = wolfSSL_CertManagerVerifyBuffer(cm, leaf->der, leaf->derSz,
+            WOLFSSL_FILETYPE_ASN1);
+        if (ret != WOLFSSL_SUCCESS) {
+            fprintf(stderr, "Verifying leaf failed: %d\n", ret);
+            ret = -1;
+            goto done;
+        }
+        lookups++;
+        elapsed = now_sec() - start;
+    } while (elapsed < duration);
+    ret = 0;
+
+    printf("%9d %10.2f %10.2f %12.0f %10.3f\n", cnt, loadTime * 1000.0,
+        loadTime * 1000000.0 / cnt, lookups / elapsed,
+        elapsed * 1000000.0 / lookups);
+
+done:
+    wolfSSL_CertManagerFree(cm);
+    if (dir != NULL)
+        remove_bundle(dir, files);
+    free(buf);
+    return ret;
+}
+
+static void usage(const char* prog)
+{
+    printf("%s: CA load and lookup benchmark\n", prog);
+    printf("-n <num>  CA certs in the largest bundle (default %d)\n",
+        DEFAULT_CAS);
+    printf("-d <sec>  Duration of each verify run (default %d)\n",
+        DEFAULT_DURATION);
+    printf("-c <num>  CA certs per bundle file (default %d)\n",
+        DEFAULT_PER_FILE);
+    printf("-b        Load the bundle from a buffer instead of files\n");
+    printf("-h        This help\n");
+}
+
+int main(int argc, char** argv)
+{
+    BenchCert* cas = NULL;
+    BenchCert leaf;
+    ecc_key key;
+    WC_RNG rng;
+    char dirTmpl[] = "/tmp/ca_bench_XXXXXX";
+    char* dir = NULL;
+    int useBuffer = 0;
+    int total = DEFAULT_CAS;
+    int duration = DEFAULT_DURATION;
+    int perFile = DEFAULT_PER_FILE;
+    double start;
+    int ret = 0;
+    int i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:d:c:bh")) != -1) {
+        switch (opt) {
+            case 'n':
+                total = atoi(optarg);
+                break;
+            case 'd':
+                duration = atoi(optarg);
+                break;
+            case 'c':
+                perFile = atoi(optarg);
+                break;
+            case 'b':
+                useBuffer = 1;
+                break;
+            case 'h':
+                usage(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (total < 8 || total > MAX_CAS || duration < 1 || perFile < 1) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    wolfSSL_Init();
+
+    if (wc_InitRng(&rng) != 0) {
+        fprintf(stderr, "wc_InitRng failed\n");
+        return EXIT_FAILURE;
+    }
+    if (wc_ecc_init(&key) != 0 ||
+        wc_ecc_make_key(&rng, 32, &key) != 0) {
+        fprintf(stderr, "Making ECC key failed\n");
+        ret = -1;
+    }
+    if (ret == 0) {
+        cas = (BenchCert*)calloc((size_t)total, sizeof(BenchCert));
+        if (cas == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            ret = -1;
+        }
+    }
+    if (ret == 0 && !useBuffer) {
+        dir = mkdtemp(dirTmpl);
+        if (dir == NULL) {
+            perror("mkdtemp");
+            ret = -1;
+        }
+    }
+
+    /* All CAs share one key. They are told apart by their subject names and
+     * subject key identifiers. */
+    start = now_sec();
+    for (i = 0; ret == 0 && i < total; i++) {
+        if (make_ca(i, &key, &rng, &cas[i]) != 0) {
+            fprintf(stderr, "Making CA %d failed\n", i);
+            ret = -1;
+        }
+    }
+
+    if (ret == 0) {
+        printf("Generated %d CAs in %.2f s\n", total, now_sec() - start);
+    #ifdef WOLFSSL_CA_INDEX
+        printf("CA index: enabled\n");
+    #else
+        printf("CA index: disabled\n");
+    #endif
+        printf("Loading from: %s\n", useBuffer ? "buffer" : "files");
+        printf("%9s %10s %10s %12s %10s\n", "CAs", "load ms", "us/CA",
+            "verifies/sec", "us/verify");
+    }
+    for (i = 8; ret == 0 && i >= 1; i /= 2) {
+        int cnt = total / i;
+
+        if (make_leaf(cnt - 1, &cas[cnt - 1], &key, &rng, &leaf) != 0) {
+            fprintf(stderr, "Making leaf failed\n");
+            ret = -1;
+            break;
+        }
+        ret = run_bench(cas, cnt, &leaf, dir, perFile, duration);
+    }
+
+    if (dir != NULL)
+        (void)rmdir(dir);
+    free(cas);
+    wc_ecc_free(&key);
+    wc_FreeRng(&rng);
+    wolfSSL_Cleanup();
+
+    return (ret == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#else
+
+int main(void)
+{
+    printf("ca_bench requires certificate generation, certificate extensions "
+           "and ECC\n");
+    return 0;
+}
+
+#endif /* CA_BENCH_ENABLED */
@@ -0,0 +1,416 @@
+/* crl_bench.c
+ *
+ * Copyright (C) 2006-2026 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+/*
+ * CRL load and revocation lookup benchmark over a synthetic CRL.
+ *
+ *   ./crl_bench -n 1000000 -d 2
+ *
+ * A CRL with -n revoked serials is generated and signed with the 2048-bit
+ * test CA key and loaded into a certificate manager. The server test cert
+ * is then checked against it with wolfSSL_CertManagerCheckCRL() for -d
+ * seconds, once against a CRL that doesn't list it and once against one that
+ * lists it last, which is the worst case for a search of the revoked list.
+ * A run against an empty CRL gives the cost of decoding and verifying the
+ * cert that is part of every lookup.
+ *
+ * Compare a build with --enable-crl-index (CRL_REVOKED_INDEX) against one
+ * without to see the effect of the revoked cert index.
+ *
+ * With -f the CRL is written to the given file and loaded from it with
+ * wolfSSL_CertManagerLoadCRLFile(). A build with --enable-crl-mmap
+ * (HAVE_CRL_MMAP) maps the file instead of decoding the revoked certs.
+ */
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+#ifndef WOLFSSL_USER_SETTINGS
+    #include <wolfssl/options.h>
+#endif
+
+#include <wolfssl/wolfcrypt/settings.h>
+#include <wolfssl/ssl.h>
+
+#include <stdio.h>
+
+#if defined(HAVE_CRL) && defined(WOLFSSL_CERT_GEN) && !defined(NO_RSA) && \
+    !defined(NO_CERTS) && !defined(NO_ASN) && !defined(USE_WINDOWS_API)
+    #define CRL_BENCH_ENABLED
+#endif
+
+#ifdef CRL_BENCH_ENABLED
+
+#include <wolfssl/wolfcrypt/asn.h>
+#include <wolfssl/wolfcrypt/asn_public.h>
+#include <wolfssl/wolfcrypt/rsa.h>
+#include <wolfssl/wolfcrypt/random.h>
+
+#define USE_CERT_BUFFERS_2048
+#include <wolfssl/certs_test.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+
+#define DEFAULT_ENTRIES    1000000
+#define DEFAULT_DURATION   1
+/* Serials are 0x10 followed by three bytes of the entry number. */
+#define MAX_ENTRIES        0xFFFFFF
+#define SIG_OVERHEAD       1024
+
+/* What is in the CRL apart from the synthetic serials. */
+enum {
+    RUN_EMPTY,
+    RUN_MISS,
+    RUN_HIT
+};
+
+static const char* run_names[] = { "empty", "not revoked", "revoked" };
+
+static double now_sec(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        perror("clock_gettime");
+        exit(EXIT_FAILURE);
+    }
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* Get the header size of the DER element at idx and its total size. */
+static word32 der_elem(const byte* der, word32 sz, word32 idx, word32* elemSz)
+{
+    word32 len = 0;
+    word32 hdr = 2;
+    word32 i;
+
+    *elemSz = 0;
+    if (idx + 2 > sz)
+        return 0;
+    if (der[idx + 1] < 0x80) {
+        len = der[idx + 1];
+    }
+    else {
+        word32 n = der[idx + 1] & 0x7F;
+
+        if (n > 3 || idx + 2 + n > sz)
+            return 0;
+        for (i = 0; i < n; i++)
+            len = (len << 8) | der[idx + 2 + i];
+        hdr += n;
+    }
+    if (idx + hdr + len > sz)
+        return 0;
+    *elemSz = hdr + len;
+    return hdr;
+}
+
+/* Find the issuer Name of the self signed test CA, which is also the issuer
+ * of the generated CRLs. */
+static int get_ca_name(const byte** name, word32* nameSz)
+{
+    const byte* der = ca_cert_der_2048;
+    word32 sz = sizeof_ca_cert_der_2048;
+    word32 idx;
+    word32 elemSz;
+    int i;
+
+    /* Certificate and tbsCertificate headers. */
+    idx = der_elem(der, sz, 0, &elemSz);
+    idx += der_elem(der, sz, idx, &elemSz);
+    if (idx >= sz)
+        return -1;
+    /* Optional version, serialNumber and signature. */
+    if (der[idx] == (ASN_CONTEXT_SPECIFIC | ASN_CONSTRUCTED)) {
+        (void)der_elem(der, sz, idx, &elemSz);
+        idx += elemSz;
+    }
+    for (i = 0; i < 2; i++) {
+        if (der_elem(der, sz, idx, &elemSz) == 0)
+            return -1;
+        idx += elemSz;
+    }
+    if (der_elem(der, sz, idx, &elemSz) == 0)
+        return -1;
+
+    *name = der + idx;
+    *nameSz = elemSz;
+    return 0;
+}
+
+/* Make and sign a CRL listing the certs in rc. */
+static int make_crl(RevokedCert* rc, RsaKey* key, WC_RNG* rng, byte** crl,
+    int* crlSz)
+{
+    static const byte thisUpdate[] = "260101000000Z";
+    static const byte nextUpdate[] = "491231235959Z";
+    const byte* issuer;
+    word32 issuerSz;
+    int tbsSz;
+    int ret;
+
+    *crl = NULL;
+    if (get_ca_name(&issuer, &issuerSz) != 0) {
+        fprintf(stderr, "Failed to find CA name\n");
+        return -1;
+    }
+
+    tbsSz = wc_MakeCRL_ex(issuer, issuerSz, thisUpdate, ASN_UTC_TIME,
+        nextUpdate, ASN_UTC_TIME, rc, NULL, 0, CTC_SHA256wRSA, 2, NULL, 0);
+    if (tbsSz <= 0) {
+        fprintf(stderr, "wc_MakeCRL_ex size failed: %d\n", tbsSz);
+        return -1;
+    }
+    *crl = (byte*)malloc((size_t)tbsSz + SIG_OVERHEAD);
+    if (*crl == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return -1;
+    }
+    ret = wc_MakeCRL_ex(issuer, issuerSz, thisUpdate, ASN_UTC_TIME,
+        nextUpdate, ASN_UTC_TIME, rc, NULL, 0, CTC_SHA256wRSA, 2, *crl,
+        (word32)tbsSz + SIG_OVERHEAD);
+    if (ret == tbsSz) {
+        ret = wc_SignCRL_ex(*crl, tbsSz, CTC_SHA256wRSA, *crl,
+            (word32)tbsSz + SIG_OVERHEAD, key, NULL, rng);
+    }
+    if (ret <= 0) {
+        fprintf(stderr, "Making CRL failed: %d\n", ret);
+        free(*crl);
+        *crl = NULL;
+        return -1;
+    }
+
+    *crlSz = ret;
+    return 0;
+}
+
+static int run_bench(int run, RevokedCert* rc, int entries, RsaKey* key,
+    WC_RNG* rng, int duration, const char* file)
+{
+    WOLFSSL_CERT_MANAGER* cm = NULL;
+    byte* crl = NULL;
+    int crlSz = 0;
+    int expected = (run == RUN_HIT) ? CRL_CERT_REVOKED : WOLFSSL_SUCCESS;
+    double start;
+    double loadTime;
+    double elapsed;
+    long lookups = 0;
+    int ret;
+
+    /* The first entry is encoded first and ends up last on the list of
+     * revoked certs built by the parser. */
+    rc[0].serialNumber[0] = (run == RUN_HIT) ? 0x01 : 0x7F;
+
+    if (make_crl((run == RUN_EMPTY) ? NULL : rc, key, rng, &crl, &crlSz) != 0)
+        return -1;
+
+    cm = wolfSSL_CertManagerNew();
+    if (cm == NULL ||
+        wolfSSL_CertManagerLoadCABuffer(cm, ca_cert_der_2048,
+            sizeof_ca_cert_der_2048, WOLFSSL_FILETYPE_ASN1) !=
+            WOLFSSL_SUCCESS ||
+        wolfSSL_CertManagerEnableCRL(cm, WOLFSSL_CRL_CHECKALL) !=
+            WOLFSSL_SUCCESS) {
+        fprintf(stderr, "Certificate manager setup failed\n");
+        ret = -1;
+        goto done;
+    }
+
+    if (file != NULL) {
+        FILE* f = fopen(file, "wb");
+
+        if (f == NULL || fwrite(crl, 1, (size_t)crlSz, f) != (size_t)crlSz) {
+            fprintf(stderr, "Writing %s failed\n", file);
+            if (f != NULL)
+                fclose(f);
+            ret = -1;
+            goto done;
+        }
+        fclose(f);
+    }
+
+    start = now_sec();
+    if (file != NULL) {
+        ret = wolfSSL_CertManagerLoadCRLFile(cm, file, WOLFSSL_FILETYPE_ASN1);
+    }
+    else {
+        ret = wolfSSL_CertManagerLoadCRLBuffer(cm, crl, crlSz,
+            WOLFSSL_FILETYPE_ASN1);
+    }
+    loadTime = now_sec() - start;
+    if (ret != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "Loading CRL failed: %d\n", ret);
+        ret = -1;
+        goto done;
+    }
+
+    start = now_sec();
+    do {
+        ret = wolfSSL_CertManagerCheckCRL(cm, server_cert_der_2048,
+            sizeof_server_cert_der_2048);
+        if (ret != expected) {
+            fprintf(stderr, "CRL check returned %d, expected %d\n", ret,
+                expected);
+            ret = -1;
+            goto done;
+        }
+        lookups++;
+        elapsed = now_sec() - start;
+    } while (elapsed < duration);
+    ret = 0;
+
+    printf("%-12s %9d %10d %10.2f %12.0f %10.3f\n", run_names[run],
+        (run == RUN_EMPTY) ? 0 : entries + 1, crlSz, loadTime * 1000.0,
+        lookups / elapsed, elapsed * 1000000.0 / lookups);
+
+done:
+    wolfSSL_CertManagerFree(cm);
+    if (file != NULL)
+        (void)remove(file);
+    free(crl);
+    return ret;
+}
+
+static void usage(const char* prog)
+{
+    printf("%s: CRL load and revocation lookup benchmark\n", prog);
+    printf("-n <num>  Synthetic revoked serials in the CRL (default %d)\n",
+        DEFAULT_ENTRIES);
+    printf("-d <sec>  Duration of each lookup run (default %d)\n",
+        DEFAULT_DURATION);
+    printf("-f <file> Load the CRL from this file instead of a buffer\n");
+    printf("-h        This help\n");
+}
+
+int main(int argc, char** argv)
+{
+    static const byte revDate[] = "250101000000Z";
+    RevokedCert* rc = NULL;
+    RsaKey key;
+    WC_RNG rng;
+    word32 idx = 0;
+    int entries = DEFAULT_ENTRIES;
+    int duration = DEFAULT_DURATION;
+    const char* file = NULL;
+    int run;
+    int ret = 0;
+    int i;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:d:f:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                entries = atoi(optarg);
+                break;
+            case 'd':
+                duration = atoi(optarg);
+                break;
+            case 'f':
+                file = optarg;
+                break;
+            case 'h':
+                usage(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (entries < 1 || entries > MAX_ENTRIES || duration < 1) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    wolfSSL_Init();
+
+    if (wc_InitRng(&rng) != 0) {
+        fprintf(stderr, "wc_InitRng failed\n");
+        return EXIT_FAILURE;
+    }
+    if (wc_InitRsaKey(&key, NULL) != 0 ||
+        wc_RsaPrivateKeyDecode(ca_key_der_2048, &idx, &key,
+            sizeof_ca_key_der_2048) != 0) {
+        fprintf(stderr, "Loading CA key failed\n");
+        ret = -1;
+    }
+
+    /* Entry 0 is the cert that is or isn't revoked, see run_bench(). */
+    if (ret == 0) {
+        rc = (RevokedCert*)calloc((size_t)entries + 1, sizeof(RevokedCert));
+        if (rc == NULL) {
+            fprintf(stderr, "Out of memory\n");
+            ret = -1;
+        }
+    }
+    for (i = 0; ret == 0 && i <= entries; i++) {
+        if (i == 0) {
+            rc[i].serialSz = 1;
+        }
+        else {
+            rc[i].serialNumber[0] = 0x10;
+            rc[i].serialNumber[1] = (byte)(i >> 16);
+            rc[i].serialNumber[2] = (byte)(i >> 8);
+            rc[i].serialNumber[3] = (byte)i;
+            rc[i].serialSz = 4;
+        }
+        memcpy(rc[i].revDate, revDate, sizeof(revDate) - 1);
+        rc[i].revDateFormat = ASN_UTC_TIME;
+        rc[i].reasonCode = -1;
+        rc[i].next = (i < entries) ? &rc[i + 1] : NULL;
+    }
+
+    if (ret == 0) {
+    #ifdef CRL_REVOKED_INDEX
+        printf("Revoked cert index: enabled\n");
+    #else
+        printf("Revoked cert index: disabled\n");
+    #endif
+    #ifdef HAVE_CRL_MMAP
+        printf("CRL file mapping: %s\n", (file != NULL) ? "enabled" :
+            "enabled, unused without -f");
+    #endif
+        printf("%-12s %9s %10s %10s %12s %10s\n", "lookup", "revoked",
+            "CRL bytes", "load ms", "lookups/sec", "us/lookup");
+    }
+    for (run = RUN_EMPTY; ret == 0 && run <= RUN_HIT; run++)
+        ret = run_bench(run, rc, entries, &key, &rng, duration, file);
+
+    free(rc);
+    wc_FreeRsaKey(&key);
+    wc_FreeRng(&rng);
+    wolfSSL_Cleanup();
+
+    return (ret == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#else
+
+int main(void)
+{
+    printf("crl_bench requires CRL, certificate generation and RSA\n");
+    return 0;
+}
+
+#endif /* CRL_BENCH_ENABLED */
@@ -0,0 +1,1111 @@
+/* handshake_bench.c
+ *
+ * Copyright (C) 2006-2026 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+/*
+ * Multi-threaded TLS handshake and session resumption benchmark over
+ * in-memory I/O.
+ *
+ *   ./handshake_bench -t 1,2,4,8 -l 1,64 -d 3
+ *   ./handshake_bench -v 13 -g ECC_X25519,X25519MLKEM768 -m full -p -o csv
+ *
+ * Every thread drives its own client/server pair through in-memory
+ * wolfSSL_CTX_SetIORecv()/wolfSSL_CTX_SetIOSend() callbacks, so no sockets or
+ * kernel time are involved. Both ends of a pair run on the same thread (and
+ * with -p on the same CPU), so a pair measures the cost of both sides of the
+ * handshake.
+ *
+ * In full mode (-m full) every connection is a full handshake. In resume
+ * mode (-m resume) a pair does one full handshake and then resumes that
+ * session in a loop: by session ID with TLS 1.2, which makes the server look
+ * the session up in the shared server session cache every time, and with a
+ * session ticket with TLS 1.3.
+ *
+ * The run is repeated for every cipher suite (-c), key exchange group (-g),
+ * mode, thread count (-t) and session cache lock count (-l, see
+ * wolfSSL_SetSessionCacheLocks()). Each run reports handshakes/sec,
+ * resumptions/sec, the median and 99th percentile connection latency and
+ * the bytes/sec put on the wire by both ends. Resumptions/sec that stop
+ * scaling with threads at a low lock count show lock contention on the
+ * cache. Build with HUGE_SESSION_CACHE or TITAN_SESSION_CACHE so the sessions
+ * of all threads fit in the cache; evicted sessions are counted as full
+ * handshakes.
+ *
+ * With the TLS RNG bank built in (--enable-tls-rng-bank), -r conn,bank runs
+ * every configuration once with each connection instantiating its own DRBG
+ * and once with connections drawing from the shared bank, to show what the
+ * per-connection entropy read and DRBG instantiate cost in connections/sec.
+ *
+ * With key share pools built in (--enable-keysharepool), -k <depth> keeps depth
+ * pre-generated key shares of the TLS 1.3 group (-g) ready on both CTXs, so
+ * handshakes skip key generation while the pool keeps up.
+ *
+ * -o csv and -o json print one record per run for regression tracking.
+ */
+
+#ifdef __linux__
+    #ifndef _GNU_SOURCE
+        /* For CPU_SET() and sched_setaffinity(). */
+        #define _GNU_SOURCE 1
+    #endif
+    /* Ahead of options.h, which may undefine _GNU_SOURCE. */
+    #include <sched.h>
+#endif
+
+#ifdef HAVE_CONFIG_H
+    #include <config.h>
+#endif
+#ifndef WOLFSSL_USER_SETTINGS
+    #include <wolfssl/options.h>
+#endif
+
+#include <wolfssl/wolfcrypt/settings.h>
+#include <wolfssl/ssl.h>
+
+#include <stdio.h>
+
+#if !defined(NO_WOLFSSL_CLIENT) && !defined(NO_WOLFSSL_SERVER) && \
+    (!defined(WOLFSSL_NO_TLS12) || defined(WOLFSSL_TLS13)) && \
+    !defined(NO_TLS) && !defined(NO_SESSION_CACHE) && \
+    !defined(SINGLE_THREADED) && !defined(USE_WINDOWS_API) && \
+    (!defined(NO_RSA) || defined(HAVE_ECC))
+    #define HANDSHAKE_BENCH_ENABLED
+#endif
+
+#ifdef HANDSHAKE_BENCH_ENABLED
+
+#include <wolfssl/wolfio.h>
+
+#ifndef NO_RSA
+    #define USE_CERT_BUFFERS_2048
+#else
+    #define USE_CERT_BUFFERS_256
+#endif
+#include <wolfssl/certs_test.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+
+#define DEFAULT_DURATION   3
+#define MAX_RUNS           32
+/* Largest flight in the handshake is the server's certificate flight. */
+#define MEM_BUF_SZ         (16 * 1024)
+#define HANDSHAKE_STEPS    32
+/* Application data is echoed in pieces that fit in the in-memory buffers. */
+#define DATA_CHUNK_SZ      4096
+#define MAX_DATA_SZ        (1024 * 1024)
+#define LAT_INIT_CNT       1024
+
+enum {
+    OUT_TEXT,
+    OUT_CSV,
+    OUT_JSON
+};
+
+enum {
+    MODE_FULL   = 0x01,
+    MODE_RESUME = 0x02
+};
+
+/* Where connections get their random numbers from. */
+enum {
+    RNG_CONN = 0x01,    /* a DRBG instantiated per connection */
+    RNG_BANK = 0x02     /* the shared TLS RNG bank */
+};
+
+typedef struct mem_buf {
+    unsigned char buf[MEM_BUF_SZ];
+    int           len;
+    long          total;   /* bytes ever written into the buffer */
+} mem_buf;
+
+/* One side of an in-memory connection. */
+typedef struct mem_end {
+    mem_buf* in;
+    mem_buf* out;
+} mem_end;
+
+/* What a run benchmarks. */
+typedef struct bench_cfg {
+    int         version;    /* 12 or 13 */
+    const char* suite;      /* NULL for the default cipher list */
+    word16      group;      /* 0 for the default groups */
+    const char* groupName;
+    int         resume;
+    int         dataSz;     /* application data echoed per connection */
+    int         rng;        /* RNG_CONN or RNG_BANK */
+    int         poolDepth;  /* key share pool depth, 0 for none */
+    int         pin;
+    int         duration;
+} bench_cfg;
+
+typedef struct bench_thread {
+    THREAD_TYPE      tid;
+    WOLFSSL_CTX*     cliCtx;
+    WOLFSSL_CTX*     srvCtx;
+    const bench_cfg* cfg;
+    int              cpu;
+    long             resumed;
+    long             full;
+    int              err;
+    const char*      suite;  /* negotiated on the first connection */
+    const char*      group;
+    double*          lat;    /* seconds per connection */
+    long             latCnt;
+    long             latMax;
+    mem_buf          c2s;
+    mem_buf          s2c;
+} bench_thread;
+
+#ifdef HAVE_SUPPORTED_CURVES
+typedef struct bench_group {
+    word16      group;
+    const char* name;
+} bench_group;
+
+/* Key exchange groups that can be picked with -g. Names as in tls_bench. */
+static const bench_group bench_groups[] = {
+#ifdef HAVE_ECC
+    { WOLFSSL_ECC_SECP256R1, "ECC_SECP256R1" },
+    { WOLFSSL_ECC_SECP384R1, "ECC_SECP384R1" },
+    { WOLFSSL_ECC_SECP521R1, "ECC_SECP521R1" },
+#endif
+#ifdef HAVE_CURVE25519
+    { WOLFSSL_ECC_X25519, "ECC_X25519" },
+#endif
+#ifdef HAVE_CURVE448
+    { WOLFSSL_ECC_X448, "ECC_X448" },
+#endif
+#ifdef HAVE_FFDHE
+    { WOLFSSL_FFDHE_2048, "FFDHE_2048" },
+    { WOLFSSL_FFDHE_3072, "FFDHE_3072" },
+#endif
+#if defined(WOLFSSL_TLS13) && defined(WOLFSSL_HAVE_MLKEM) && \
+    !defined(WOLFSSL_NO_ML_KEM)
+    #ifndef WOLFSSL_TLS_NO_MLKEM_STANDALONE
+    { WOLFSSL_ML_KEM_512, "ML_KEM_512" },
+    { WOLFSSL_ML_KEM_768, "ML_KEM_768" },
+    { WOLFSSL_ML_KEM_1024, "ML_KEM_1024" },
+    #endif /* !WOLFSSL_TLS_NO_MLKEM_STANDALONE */
+    #ifdef WOLFSSL_PQC_HYBRIDS
+    { WOLFSSL_SECP256R1MLKEM768,   "SecP256r1MLKEM768"   },
+    { WOLFSSL_SECP384R1MLKEM1024,  "SecP384r1MLKEM1024"  },
+    { WOLFSSL_X25519MLKEM768, "X25519MLKEM768" },
+    #endif /* WOLFSSL_PQC_HYBRIDS */
+    #ifdef WOLFSSL_EXTRA_PQC_HYBRIDS
+    { WOLFSSL_SECP256R1MLKEM512,   "SecP256r1MLKEM512"   },
+    { WOLFSSL_SECP384R1MLKEM768,   "SecP384r1MLKEM768"   },
+    { WOLFSSL_SECP521R1MLKEM1024,  "SecP521r1MLKEM1024"  },
+    { WOLFSSL_X25519MLKEM512, "X25519MLKEM512" },
+    { WOLFSSL_X448MLKEM768,   "X448MLKEM768"   },
+    #endif /* WOLFSSL_EXTRA_PQC_HYBRIDS */
+#endif
+    { 0, NULL }
+};
+#endif /* HAVE_SUPPORTED_CURVES */
+
+static int outFmt = OUT_TEXT;
+static int outCnt = 0;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        perror("clock_gettime");
+        exit(EXIT_FAILURE);
+    }
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int mem_recv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    mem_buf* in = ((mem_end*)ctx)->in;
+    int      n;
+
+    (void)ssl;
+
+    if (in->len == 0)
+        return WOLFSSL_CBIO_ERR_WANT_READ;
+
+    n = (sz < in->len) ? sz : in->len;
+    memcpy(buf, in->buf, (size_t)n);
+    in->len -= n;
+    if (in->len > 0)
+        memmove(in->buf, in->buf + n, (size_t)in->len);
+
+    return n;
+}
+
+static int mem_send(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    mem_buf* out = ((mem_end*)ctx)->out;
+    int      n;
+
+    (void)ssl;
+
+    n = MEM_BUF_SZ - out->len;
+    if (n == 0)
+        return WOLFSSL_CBIO_ERR_WANT_WRITE;
+    if (sz < n)
+        n = sz;
+    memcpy(out->buf + out->len, buf, (size_t)n);
+    out->len += n;
+    out->total += n;
+
+    return n;
+}
+
+static int want_io(WOLFSSL* ssl, int ret)
+{
+    int err = wolfSSL_get_error(ssl, ret);
+    return (err == WOLFSSL_ERROR_WANT_READ) ||
+           (err == WOLFSSL_ERROR_WANT_WRITE);
+}
+
+/* Step client and server in turn until both finish the handshake. */
+static int do_handshake(WOLFSSL* cli, WOLFSSL* srv)
+{
+    int cliDone = 0;
+    int srvDone = 0;
+    int ret;
+    int i;
+
+    for (i = 0; (i < HANDSHAKE_STEPS) && !(cliDone && srvDone); i++) {
+        if (!cliDone) {
+            ret = wolfSSL_connect(cli);
+            if (ret == WOLFSSL_SUCCESS)
+                cliDone = 1;
+            else if (!want_io(cli, ret))
+                return wolfSSL_get_error(cli, ret);
+        }
+        if (!srvDone) {
+            ret = wolfSSL_accept(srv);
+            if (ret == WOLFSSL_SUCCESS)
+                srvDone = 1;
+            else if (!want_io(srv, ret))
+                return wolfSSL_get_error(srv, ret);
+        }
+    }
+
+    return (cliDone && srvDone) ? 0 : -1;
+}
+
+/* Read exactly sz bytes that the peer has already written. */
+static int read_all(WOLFSSL* ssl, unsigned char* buf, int sz)
+{
+    int got = 0;
+
+    while (got < sz) {
+        int ret = wolfSSL_read(ssl, buf + got, sz - got);
+        if (ret <= 0)
+            return wolfSSL_get_error(ssl, ret);
+        got += ret;
+    }
+
+    return 0;
+}
+
+/* Client sends sz bytes of application data and the server echoes them. */
+static int do_data(WOLFSSL* cli, WOLFSSL* srv, int sz)
+{
+    unsigned char buf[DATA_CHUNK_SZ];
+    int           ret = 0;
+    int           off;
+
+    memset(buf, 0x5a, sizeof(buf));
+    for (off = 0; (ret == 0) && (off < sz); off += DATA_CHUNK_SZ) {
+        int n = (sz - off < DATA_CHUNK_SZ) ? sz - off : DATA_CHUNK_SZ;
+
+        if (wolfSSL_write(cli, buf, n) != n)
+            ret = wolfSSL_get_error(cli, 0);
+        if (ret == 0)
+            ret = read_all(srv, buf, n);
+        if ((ret == 0) && (wolfSSL_write(srv, buf, n) != n))
+            ret = wolfSSL_get_error(srv, 0);
+        if (ret == 0)
+            ret = read_all(cli, buf, n);
+    }
+
+    return ret;
+}
+
+static int add_latency(bench_thread* t, double lat)
+{
+    if (t->latCnt == t->latMax) {
+        long    max = (t->latMax == 0) ? LAT_INIT_CNT : t->latMax * 2;
+        double* p = (double*)realloc(t->lat, (size_t)max * sizeof(double));
+        if (p == NULL)
+            return MEMORY_E;
+        t->lat    = p;
+        t->latMax = max;
+    }
+    t->lat[t->latCnt++] = lat;
+
+    return 0;
+}
+
+static void pin_thread(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0)
+        perror("sched_setaffinity");
+#else
+    (void)cpu;
+#endif
+}
+
+static THREAD_RETURN WOLFSSL_THREAD bench_thread_run(void* args)
+{
+    bench_thread*    t = (bench_thread*)args;
+    const bench_cfg* cfg = t->cfg;
+    WOLFSSL_SESSION* session = NULL;
+    mem_end          cliEnd;
+    mem_end          srvEnd;
+    double           end;
+
+    if (cfg->pin)
+        pin_thread(t->cpu);
+
+    cliEnd.in  = &t->s2c;
+    cliEnd.out = &t->c2s;
+    srvEnd.in  = &t->c2s;
+    srvEnd.out = &t->s2c;
+
+    end = now_sec() + cfg->duration;
+    while (t->err == 0 && now_sec() < end) {
+        double   start = now_sec();
+        WOLFSSL* cli = wolfSSL_new(t->cliCtx);
+        WOLFSSL* srv = wolfSSL_new(t->srvCtx);
+
+        if (cli == NULL || srv == NULL) {
+            t->err = MEMORY_E;
+        }
+        else {
+            t->c2s.len = 0;
+            t->s2c.len = 0;
+            wolfSSL_SetIOReadCtx(cli, &cliEnd);
+            wolfSSL_SetIOWriteCtx(cli, &cliEnd);
+            wolfSSL_SetIOReadCtx(srv, &srvEnd);
+            wolfSSL_SetIOWriteCtx(srv, &srvEnd);
+            if (session != NULL)
+                wolfSSL_set_session(cli, session);
+        #ifdef WOLFSSL_TLS13
+            /* Send the key share up front so there is no HelloRetryRequest.
+             */
+            if (cfg->version == 13 && cfg->group != 0 &&
+                    wolfSSL_UseKeyShare(cli, cfg->group) != WOLFSSL_SUCCESS) {
+                t->err = BAD_FUNC_ARG;
+            }
+        #endif
+
+            if (t->err == 0)
+                t->err = do_handshake(cli, srv);
+            if (t->err == 0 && cfg->dataSz > 0)
+                t->err = do_data(cli, srv, cfg->dataSz);
+        #if defined(WOLFSSL_TLS13) && defined(HAVE_SESSION_TICKET)
+            if (t->err == 0 && cfg->resume && cfg->version == 13 &&
+                    !wolfSSL_session_reused(cli)) {
+                unsigned char b;
+                /* Take in the NewSessionTicket to resume with. */
+                (void)wolfSSL_read(cli, &b, 1);
+            }
+        #endif
+        }
+        if (t->err == 0)
+            t->err = add_latency(t, now_sec() - start);
+        if (t->err == 0) {
+            if (t->suite == NULL) {
+                t->suite = wolfSSL_get_cipher_name(cli);
+            #if defined(HAVE_ECC) || defined(HAVE_CURVE25519) || \
+                defined(HAVE_CURVE448) || !defined(NO_DH) || \
+                (defined(WOLFSSL_TLS13) && defined(WOLFSSL_HAVE_MLKEM))
+                t->group = wolfSSL_get_curve_name(cli);
+            #endif
+            }
+            if (wolfSSL_session_reused(srv)) {
+                t->resumed++;
+            }
+            else {
+                /* Full mode, first connection or session evicted from the
+                 * cache. */
+                t->full++;
+                if (cfg->resume) {
+                    wolfSSL_SESSION_free(session);
+                    session = wolfSSL_get1_session(cli);
+                }
+            }
+        }
+
+        wolfSSL_free(cli);
+        wolfSSL_free(srv);
+    }
+
+    wolfSSL_SESSION_free(session);
+    WOLFSSL_RETURN_FROM_THREAD(0);
+}
+
+static WOLFSSL_METHOD* client_method(int version)
+{
+#ifdef WOLFSSL_TLS13
+    if (version == 13)
+        return wolfTLSv1_3_client_method();
+#endif
+#ifndef WOLFSSL_NO_TLS12
+    if (version == 12)
+        return wolfTLSv1_2_client_method();
+#endif
+    return NULL;
+}
+
+static WOLFSSL_METHOD* server_method(int version)
+{
+#ifdef WOLFSSL_TLS13
+    if (version == 13)
+        return wolfTLSv1_3_server_method();
+#endif
+#ifndef WOLFSSL_NO_TLS12
+    if (version == 12)
+        return wolfTLSv1_2_server_method();
+#endif
+    return NULL;
+}
+
+static int setup_ctx(const bench_cfg* cfg, WOLFSSL_CTX** cliCtx,
+                     WOLFSSL_CTX** srvCtx)
+{
+    *cliCtx = wolfSSL_CTX_new(client_method(cfg->version));
+    *srvCtx = wolfSSL_CTX_new(server_method(cfg->version));
+    if (*cliCtx == NULL || *srvCtx == NULL)
+        return MEMORY_E;
+
+#ifndef NO_RSA
+    if (wolfSSL_CTX_use_certificate_buffer(*srvCtx, server_cert_der_2048,
+            sizeof_server_cert_der_2048, WOLFSSL_FILETYPE_ASN1) !=
+            WOLFSSL_SUCCESS ||
+        wolfSSL_CTX_use_PrivateKey_buffer(*srvCtx, server_key_der_2048,
+            sizeof_server_key_der_2048, WOLFSSL_FILETYPE_ASN1) !=
+            WOLFSSL_SUCCESS) {
+        return WOLFSSL_FATAL_ERROR;
+    }
+#else
+    if (wolfSSL_CTX_use_certificate_buffer(*srvCtx, serv_ecc_der_256,
+            sizeof_serv_ecc_der_256, WOLFSSL_FILETYPE_ASN1) !=
+            WOLFSSL_SUCCESS ||
+        wolfSSL_CTX_use_PrivateKey_buffer(*srvCtx, ecc_key_der_256,
+            sizeof_ecc_key_der_256, WOLFSSL_FILETYPE_ASN1) !=
+            WOLFSSL_SUCCESS) {
+        return WOLFSSL_FATAL_ERROR;
+    }
+#endif
+
+    if (cfg->suite != NULL &&
+        (wolfSSL_CTX_set_cipher_list(*cliCtx, cfg->suite) != WOLFSSL_SUCCESS ||
+         wolfSSL_CTX_set_cipher_list(*srvCtx, cfg->suite) !=
+            WOLFSSL_SUCCESS)) {
+        fprintf(stderr, "cipher suite %s not available\n", cfg->suite);
+        return WOLFSSL_FATAL_ERROR;
+    }
+#ifdef HAVE_SUPPORTED_CURVES
+    /* TLS 1.3 picks the group with the key share instead. */
+    if (cfg->group != 0 && cfg->version == 12 &&
+            wolfSSL_CTX_UseSupportedCurve(*cliCtx, cfg->group) !=
+            WOLFSSL_SUCCESS) {
+        fprintf(stderr, "group %s not available\n", cfg->groupName);
+        return WOLFSSL_FATAL_ERROR;
+    }
+#endif
+
+    /* Only the server's session cache is under test. */
+    wolfSSL_CTX_set_verify(*cliCtx, WOLFSSL_VERIFY_NONE, NULL);
+    wolfSSL_CTX_set_session_cache_mode(*cliCtx, WOLFSSL_SESS_CACHE_OFF);
+
+    wolfSSL_CTX_SetIORecv(*cliCtx, mem_recv);
+    wolfSSL_CTX_SetIOSend(*cliCtx, mem_send);
+    wolfSSL_CTX_SetIORecv(*srvCtx, mem_recv);
+    wolfSSL_CTX_SetIOSend(*srvCtx, mem_send);
+
+#ifdef WOLFSSL_TLS_RNG_BANK
+    (void)wolfSSL_CTX_UseRngBank(*cliCtx, cfg->rng == RNG_BANK);
+    (void)wolfSSL_CTX_UseRngBank(*srvCtx, cfg->rng == RNG_BANK);
+#endif
+#ifdef WOLFSSL_KEY_SHARE_POOL
+    if (cfg->poolDepth > 0 &&
+        (wolfSSL_CTX_UseKeySharePool(*cliCtx, &cfg->group, 1,
+            cfg->poolDepth) != WOLFSSL_SUCCESS ||
+         wolfSSL_CTX_UseKeySharePool(*srvCtx, &cfg->group, 1,
+            cfg->poolDepth) != WOLFSSL_SUCCESS)) {
+        fprintf(stderr, "key share pool of %s not available\n",
+                cfg->groupName);
+        return WOLFSSL_FATAL_ERROR;
+    }
+#endif
+
+    return 0;
+}
+
+static const char* rng_name(int rng)
+{
+    return (rng == RNG_BANK) ? "bank" : "conn";
+}
+
+static int cmp_double(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x < y) ? -1 : (x > y);
+}
+
+/* Latency in milliseconds at percentile pct of the sorted latencies. */
+static double percentile(const double* lat, long cnt, int pct)
+{
+    if (cnt == 0)
+        return 0;
+    return lat[((cnt - 1) * pct) / 100] * 1000.0;
+}
+
+static void print_header(const bench_cfg* cfg)
+{
+    if (outFmt == OUT_CSV) {
+        if (outCnt == 0) {
+            printf("version,suite,group,mode,threads,locks,handshakes,full,"
+                   "resumed,handshakes_per_sec,resumptions_per_sec,"
+                   "p50_ms,p99_ms,bytes_per_sec,rng,key_share_pool\n");
+        }
+    }
+    else if (outFmt == OUT_TEXT) {
+        printf("\nTLS 1.%d %s, %s, %s, %d B data, %s, %d s per run\n",
+               cfg->version - 10,
+               (cfg->suite != NULL) ? cfg->suite : "default suites",
+               (cfg->groupName != NULL) ? cfg->groupName : "default groups",
+               cfg->resume ? "resumption" : "full handshakes", cfg->dataSz,
+               (cfg->rng == RNG_BANK) ? "banked DRBG" :
+                                        "DRBG per connection",
+               cfg->duration);
+        if (cfg->poolDepth > 0)
+            printf("key share pool depth %d\n", cfg->poolDepth);
+        printf("%7s %7s %10s %10s %12s %12s %9s %9s %12s\n", "threads",
+               "locks", "full", "resumed", "handshakes/s", "resumed/s",
+               "p50 ms", "p99 ms", "kB/s");
+    }
+}
+
+static void print_result(const bench_cfg* cfg, const bench_thread* t0,
+                         int threads, long full, long resumed, double p50,
+                         double p99, long bytes)
+{
+    double      dur = cfg->duration;
+    long        hs = full + resumed;
+    const char* suite = (t0->suite != NULL) ? t0->suite : "";
+    const char* group = (cfg->groupName != NULL) ? cfg->groupName :
+                        (t0->group != NULL) ? t0->group : "";
+
+    if (outFmt == OUT_TEXT) {
+        printf("%7d %7d %10ld %10ld %12.1f %12.1f %9.3f %9.3f %12.1f\n",
+               threads, wolfSSL_GetSessionCacheLocks(), full, resumed,
+               (double)hs / dur, (double)resumed / dur, p50, p99,
+               (double)bytes / dur / 1024.0);
+    }
+    else if (outFmt == OUT_CSV) {
+        printf("1.%d,%s,%s,%s,%d,%d,%ld,%ld,%ld,%.1f,%.1f,%.3f,%.3f,%.0f,"
+               "%s,%d\n",
+               cfg->version - 10, suite, group,
+               cfg->resume ? "resume" : "full", threads,
+               wolfSSL_GetSessionCacheLocks(), hs, full, resumed,
+               (double)hs / dur, (double)resumed / dur, p50, p99,
+               (double)bytes / dur, rng_name(cfg->rng), cfg->poolDepth);
+    }
+    else {
+        printf("%s  {\"version\": \"1.%d\", \"suite\": \"%s\", "
+               "\"group\": \"%s\", \"mode\": \"%s\", \"threads\": %d, "
+               "\"locks\": %d, \"handshakes\": %ld, \"full\": %ld, "
+               "\"resumed\": %ld, \"handshakes_per_sec\": %.1f, "
+               "\"resumptions_per_sec\": %.1f, \"p50_ms\": %.3f, "
+               "\"p99_ms\": %.3f, \"bytes_per_sec\": %.0f, "
+               "\"rng\": \"%s\", \"key_share_pool\": %d}",
+               (outCnt == 0) ? "[\n" : ",\n", cfg->version - 10, suite,
+               group, cfg->resume ? "resume" : "full", threads,
+               wolfSSL_GetSessionCacheLocks(), hs, full, resumed,
+               (double)hs / dur, (double)resumed / dur, p50, p99,
+               (double)bytes / dur, rng_name(cfg->rng), cfg->poolDepth);
+    }
+    outCnt++;
+}
+
+/* Run threads client/server pairs with the session cache striped over locks
+ * locks. */
+static int run_bench(const bench_cfg* cfg, int threads, int locks)
+{
+    WOLFSSL_CTX*  cliCtx = NULL;
+    WOLFSSL_CTX*  srvCtx = NULL;
+    bench_thread* t;
+    double*       lat = NULL;
+    long          latCnt = 0;
+    long          resumed = 0;
+    long          full = 0;
+    long          bytes = 0;
+    long          cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int           ret;
+    int           i;
+
+    ret = wolfSSL_SetSessionCacheLocks(locks);
+    if (ret == WOLFSSL_SUCCESS)
+        ret = wolfSSL_Init();
+    if (ret != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "wolfSSL init with %d locks failed: %d\n", locks,
+                ret);
+        return ret;
+    }
+
+    t = (bench_thread*)calloc((size_t)threads, sizeof(*t));
+    ret = (t == NULL) ? MEMORY_E : setup_ctx(cfg, &cliCtx, &srvCtx);
+
+    for (i = 0; (ret == 0) && (i < threads); i++) {
+        t[i].cliCtx = cliCtx;
+        t[i].srvCtx = srvCtx;
+        t[i].cfg    = cfg;
+        t[i].cpu    = (cpus > 0) ? (int)(i % cpus) : 0;
+        if (wolfSSL_NewThread(&t[i].tid, bench_thread_run, &t[i]) != 0) {
+            ret = WOLFSSL_FATAL_ERROR;
+            break;
+        }
+    }
+    while (--i >= 0) {
+        wolfSSL_JoinThread(t[i].tid);
+        if (t[i].err != 0 && ret == 0)
+            ret = t[i].err;
+        resumed += t[i].resumed;
+        full    += t[i].full;
+        bytes   += t[i].c2s.total + t[i].s2c.total;
+        latCnt  += t[i].latCnt;
+    }
+
+    if (ret == 0 && latCnt > 0) {
+        lat = (double*)malloc((size_t)latCnt * sizeof(double));
+        if (lat == NULL)
+            ret = MEMORY_E;
+    }
+    if (ret == 0) {
+        latCnt = 0;
+        for (i = 0; i < threads; i++) {
+            memcpy(lat + latCnt, t[i].lat,
+                   (size_t)t[i].latCnt * sizeof(double));
+            latCnt += t[i].latCnt;
+        }
+        qsort(lat, (size_t)latCnt, sizeof(double), cmp_double);
+
+        print_result(cfg, &t[0], threads, full, resumed,
+                     percentile(lat, latCnt, 50), percentile(lat, latCnt, 99),
+                     bytes);
+    }
+    else {
+        fprintf(stderr, "%d threads, %d locks failed: %d\n", threads, locks,
+                ret);
+    }
+
+    wolfSSL_CTX_free(cliCtx);
+    wolfSSL_CTX_free(srvCtx);
+    for (i = 0; (t != NULL) && (i < threads); i++)
+        free(t[i].lat);
+    free(t);
+    free(lat);
+    wolfSSL_Cleanup();
+
+    return ret;
+}
+
+static int parse_list(const char* arg, int* list)
+{
+    int cnt = 0;
+
+    while (*arg != '\0' && cnt < MAX_RUNS) {
+        char* end;
+        long  v = strtol(arg, &end, 10);
+        if (end == arg || v <= 0 || v > 4096)
+            return -1;
+        list[cnt++] = (int)v;
+        arg = (*end == ',') ? end + 1 : end;
+        if (*end != ',' && *end != '\0')
+            return -1;
+    }
+
+    return cnt;
+}
+
+/* Split arg in place on sep. */
+static int split_list(char* arg, char sep, const char** list)
+{
+    int cnt = 0;
+
+    while (arg != NULL && *arg != '\0' && cnt < MAX_RUNS) {
+        char* end = strchr(arg, sep);
+        if (end != NULL)
+            *end++ = '\0';
+        list[cnt++] = arg;
+        arg = end;
+    }
+
+    return cnt;
+}
+
+static int parse_modes(char* arg)
+{
+    const char* list[MAX_RUNS];
+    int         cnt = split_list(arg, ',', list);
+    int         modes = 0;
+    int         i;
+
+    for (i = 0; i < cnt; i++) {
+        if (strcmp(list[i], "full") == 0)
+            modes |= MODE_FULL;
+        else if (strcmp(list[i], "resume") == 0)
+            modes |= MODE_RESUME;
+        else
+            return -1;
+    }
+
+    return modes;
+}
+
+static int parse_rngs(char* arg)
+{
+    const char* list[MAX_RUNS];
+    int         cnt = split_list(arg, ',', list);
+    int         rngs = 0;
+    int         i;
+
+    for (i = 0; i < cnt; i++) {
+        if (strcmp(list[i], "conn") == 0)
+            rngs |= RNG_CONN;
+    #ifdef WOLFSSL_TLS_RNG_BANK
+        else if (strcmp(list[i], "bank") == 0)
+            rngs |= RNG_BANK;
+    #endif
+        else
+            return -1;
+    }
+
+    return rngs;
+}
+
+#ifdef HAVE_SUPPORTED_CURVES
+/* Whether the client can offer group with the TLS version - the table has
+ * hybrids whose classical half may be compiled out. */
+static int group_available(int version, word16 group)
+{
+    WOLFSSL_CTX* ctx;
+    WOLFSSL*     ssl = NULL;
+    int          ret = 0;
+
+    if (wolfSSL_Init() != WOLFSSL_SUCCESS)
+        return 0;
+    ctx = wolfSSL_CTX_new(client_method(version));
+    if (ctx != NULL)
+        ssl = wolfSSL_new(ctx);
+    if (ssl != NULL) {
+    #ifdef WOLFSSL_TLS13
+        if (version == 13)
+            ret = (wolfSSL_UseKeyShare(ssl, group) == WOLFSSL_SUCCESS);
+        else
+    #endif
+            /* The ML-KEM groups are TLS 1.3 only. */
+            ret = (group <= WOLFSSL_FFDHE_END) &&
+                  (wolfSSL_UseSupportedCurve(ssl, group) == WOLFSSL_SUCCESS);
+    }
+    wolfSSL_free(ssl);
+    wolfSSL_CTX_free(ctx);
+    wolfSSL_Cleanup();
+
+    return ret;
+}
+#endif
+
+/* Look up the groups named in arg. "all" is every group this build can
+ * offer with the TLS version. */
+static int parse_groups(char* arg, int version, word16* groups,
+                        const char** names)
+{
+#ifdef HAVE_SUPPORTED_CURVES
+    const char* list[MAX_RUNS];
+    int         listCnt = split_list(arg, ',', list);
+    int         cnt = 0;
+    int         i;
+    int         j;
+
+    for (i = 0; i < listCnt; i++) {
+        int all = (strcmp(list[i], "all") == 0);
+        int found = 0;
+
+        for (j = 0; (bench_groups[j].name != NULL) && (cnt < MAX_RUNS); j++) {
+            if ((all || strcmp(list[i], bench_groups[j].name) == 0) &&
+                    group_available(version, bench_groups[j].group)) {
+                groups[cnt] = bench_groups[j].group;
+                names[cnt++] = bench_groups[j].name;
+                found = 1;
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "group %s not available with TLS 1.%d\n",
+                    list[i], version - 10);
+            return -1;
+        }
+    }
+
+    return cnt;
+#else
+    (void)arg;
+    (void)version;
+    (void)groups;
+    (void)names;
+    fprintf(stderr, "groups need HAVE_SUPPORTED_CURVES\n");
+    return -1;
+#endif
+}
+
+static void usage(const char* prog)
+{
+    printf("usage: %s [-t threads] [-l locks] [-d seconds] [-v version]\n"
+           "       [-c suites] [-g groups] [-m modes] [-b bytes] [-r rngs] "
+           "[-k depth]\n       [-p] [-o format]\n", prog);
+    printf("  -t <n,..>  client/server thread pairs per run "
+           "(default 1,2,4,.. up to CPUs)\n");
+    printf("  -l <n,..>  session cache locks per resumption run "
+           "(default 1,%d)\n", wolfSSL_GetSessionCacheLocksMax());
+    printf("  -d <sec>   seconds per run (default %d)\n", DEFAULT_DURATION);
+#ifndef WOLFSSL_NO_TLS12
+    printf("  -v <12|13> TLS version (default 12)\n");
+#else
+    printf("  -v <12|13> TLS version (default 13)\n");
+#endif
+    printf("  -c <s:..>  cipher suites, each benchmarked on its own\n");
+#ifdef HAVE_SUPPORTED_CURVES
+    {
+        int i;
+        printf("  -g <g,..>  key exchange groups, each benchmarked on its "
+               "own, or all of:\n            ");
+        for (i = 0; bench_groups[i].name != NULL; i++)
+            printf(" %s", bench_groups[i].name);
+        printf("\n");
+    }
+#endif
+    printf("  -m <m,..>  full and/or resume (default full,resume)\n");
+    printf("  -b <n>     application data bytes echoed per connection "
+           "(default 0)\n");
+#ifdef WOLFSSL_TLS_RNG_BANK
+    printf("  -r <r,..>  conn (DRBG per connection) and/or bank (shared TLS "
+           "RNG bank)\n             (default bank)\n");
+#else
+    printf("  -r <r,..>  conn (DRBG per connection), bank needs "
+           "--enable-tls-rng-bank\n");
+#endif
+#ifdef WOLFSSL_KEY_SHARE_POOL
+    printf("  -k <n>     pool n pre-generated key shares of the TLS 1.3 group "
+           "(-g)\n");
+#else
+    printf("  -k <n>     key share pool depth, needs --enable-keysharepool\n");
+#endif
+    printf("  -p         pin thread pair i to CPU i\n");
+    printf("  -o <fmt>   text, csv or json (default text)\n");
+}
+
+int main(int argc, char** argv)
+{
+    bench_cfg   cfg;
+    int         threads[MAX_RUNS];
+    int         locks[MAX_RUNS];
+    const char* suites[MAX_RUNS];
+    word16      groups[MAX_RUNS];
+    const char* groupNames[MAX_RUNS];
+    char*       groupArg = NULL;
+    int         threadCnt = 0;
+    int         lockCnt = 0;
+    int         suiteCnt = 0;
+    int         groupCnt = 0;
+    int         modes = MODE_FULL | MODE_RESUME;
+#ifdef WOLFSSL_TLS_RNG_BANK
+    int         rngs = RNG_BANK;
+#else
+    int         rngs = RNG_CONN;
+#endif
+    int         ret = 0;
+    int         s;
+    int         g;
+    int         m;
+    int         r;
+    int         i;
+    int         j;
+    int         opt;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.duration = DEFAULT_DURATION;
+#ifndef WOLFSSL_NO_TLS12
+    cfg.version = 12;
+#else
+    cfg.version = 13;
+#endif
+
+    while ((opt = getopt(argc, argv, "t:l:d:v:c:g:m:b:r:k:po:h")) != -1) {
+        switch (opt) {
+            case 't':
+                threadCnt = parse_list(optarg, threads);
+                break;
+            case 'l':
+                lockCnt = parse_list(optarg, locks);
+                break;
+            case 'd':
+                cfg.duration = atoi(optarg);
+                break;
+            case 'v':
+                cfg.version = atoi(optarg);
+                if (client_method(cfg.version) == NULL) {
+                    fprintf(stderr, "TLS version %s not available\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'c':
+                suiteCnt = split_list(optarg, ':', suites);
+                break;
+            case 'g':
+                /* Looked up once the TLS version is known. */
+                groupArg = optarg;
+                break;
+            case 'm':
+                modes = parse_modes(optarg);
+                break;
+            case 'b':
+                cfg.dataSz = atoi(optarg);
+                break;
+            case 'r':
+                rngs = parse_rngs(optarg);
+                break;
+            case 'k':
+                cfg.poolDepth = atoi(optarg);
+                break;
+            case 'p':
+                cfg.pin = 1;
+                break;
+            case 'o':
+                if (strcmp(optarg, "text") == 0)
+                    outFmt = OUT_TEXT;
+                else if (strcmp(optarg, "csv") == 0)
+                    outFmt = OUT_CSV;
+                else if (strcmp(optarg, "json") == 0)
+                    outFmt = OUT_JSON;
+                else
+                    modes = -1;
+                break;
+            case 'h':
+                usage(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+        if (threadCnt < 0 || lockCnt < 0 || cfg.duration <= 0 ||
+                modes <= 0 || rngs <= 0 || cfg.poolDepth < 0 ||
+                cfg.dataSz < 0 ||
+                cfg.dataSz > MAX_DATA_SZ) {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (groupArg != NULL) {
+        groupCnt = parse_groups(groupArg, cfg.version, groups, groupNames);
+        if (groupCnt < 0)
+            return EXIT_FAILURE;
+    }
+    if (cfg.poolDepth > 0) {
+    #ifdef WOLFSSL_KEY_SHARE_POOL
+        if (cfg.version != 13 || groupCnt == 0) {
+            fprintf(stderr, "-k needs TLS 1.3 and -g\n");
+            return EXIT_FAILURE;
+        }
+    #else
+        fprintf(stderr, "-k needs --enable-keysharepool\n");
+        return EXIT_FAILURE;
+    #endif
+    }
+
+    if (threadCnt == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        for (i = 1; (i <= cpus || threadCnt == 0) && threadCnt < MAX_RUNS;
+                i *= 2) {
+            threads[threadCnt++] = i;
+        }
+    }
+    if (lockCnt == 0) {
+        locks[lockCnt++] = 1;
+        if (wolfSSL_GetSessionCacheLocksMax() > 1)
+            locks[lockCnt++] = wolfSSL_GetSessionCacheLocksMax();
+    }
+    if (suiteCnt == 0)
+        suites[suiteCnt++] = NULL;
+    if (groupCnt == 0) {
+        groups[0] = 0;
+        groupNames[groupCnt++] = NULL;
+    }
+
+    for (s = 0; (ret == 0) && (s < suiteCnt); s++) {
+        for (g = 0; (ret == 0) && (g < groupCnt); g++) {
+            for (m = MODE_FULL; (ret == 0) && (m <= MODE_RESUME); m <<= 1) {
+                for (r = RNG_CONN; (ret == 0) && (r <= RNG_BANK); r <<= 1) {
+                    if ((modes & m) == 0 || (rngs & r) == 0)
+                        continue;
+                    cfg.suite     = suites[s];
+                    cfg.group     = groups[g];
+                    cfg.groupName = groupNames[g];
+                    cfg.resume    = (m == MODE_RESUME);
+                    cfg.rng       = r;
+
+                    print_header(&cfg);
+                    /* The lock count only matters to the session cache. */
+                    for (j = 0;
+                            (ret == 0) && (j < (cfg.resume ? lockCnt : 1));
+                            j++) {
+                        for (i = 0; (ret == 0) && (i < threadCnt); i++) {
+                            ret = run_bench(&cfg, threads[i], locks[j]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    if (outFmt == OUT_JSON)
+        printf("%s]\n", (outCnt == 0) ? "[" : "\n");
+
+    return (ret == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#else
+
+int main(void)
+{
+    printf("handshake_bench requires TLS client and server, the session "
+           "cache and threading\n");
+    return 0;
+}
+
+#endif /* HANDSHAKE_BENCH_ENABLED */
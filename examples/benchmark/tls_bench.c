@@ -97,6 +97,31 @@ Or
 #define BENCH_USE_NONBLOCK
 #endif
 
+/* Event loop latency mode needs the async worker pool and both sides */
+#if defined(WOLFSSL_ASYNC_THREADPOOL) && !defined(NO_WOLFSSL_CLIENT) && \
+    !defined(NO_WOLFSSL_SERVER)
+    #define BENCH_EVLOOP
+    #include <poll.h>
+    #ifndef EVLOOP_CONNS
+        #define EVLOOP_CONNS    8 /* handshakes in flight */
+    #endif
+#endif
+
+/* Idle connection footprint mode counts heap use through the wolfSSL
+ * allocator hooks */
+#if !defined(NO_WOLFSSL_CLIENT) && !defined(NO_WOLFSSL_SERVER) && \
+    defined(USE_WOLFSSL_MEMORY) && !defined(WOLFSSL_STATIC_MEMORY) && \
+    !defined(WOLFSSL_NO_MALLOC)
+    #define BENCH_IDLE
+    #ifndef IDLE_CONNS
+        #define IDLE_CONNS      100000 /* default idle connections */
+    #endif
+    #if defined(OPENSSL_EXTRA) || defined(HAVE_WEBSERVER) || \
+        defined(HAVE_MEMCACHED)
+        #define BENCH_IDLE_RELEASE /* wolfSSL_CTX_set_mode() available */
+    #endif
+#endif
+
 /* Defaults for configuration parameters */
 #define BENCH_DEFAULT_HOST  "localhost"
 #define BENCH_DEFAULT_PORT  11112
@@ -1742,6 +1767,908 @@ static THREAD_RETURN_NOJOIN WOLFSSL_THREAD_NO_JOIN server_thread(void* args)
 #endif /* !NO_WOLFSSL_SERVER */
 
 
+#ifdef BENCH_EVLOOP
+/* Event loop latency mode: one thread keeps EVLOOP_CONNS handshakes in flight
+ * over memory buffers, the way an event driven server does. Time spent in the
+ * server's wolfSSL_accept() and wolfSSL_AsyncPoll() calls is time the loop
+ * can't serve anything else. The clients run in the same loop but stand in
+ * for remote peers, so their time isn't counted. */
+typedef struct {
+    unsigned char buf[MEM_BUFFER_SZ];
+    int len;
+} evBuf_t;
+
+typedef struct {
+    WOLFSSL* cli;
+    WOLFSSL* srv;
+    evBuf_t to_server;
+    evBuf_t to_client;
+    int cliDone;
+    int srvDone;
+    int srvPending;
+} evConn_t;
+
+typedef struct {
+    int handshakes;
+    int calls;
+    double stallTotal;
+    double stallMax;
+    double elapsed;
+} evStats_t;
+
+static int EvBufSend(evBuf_t* b, char* buf, int sz)
+{
+    if (sz > MEM_BUFFER_SZ - b->len) {
+        sz = MEM_BUFFER_SZ - b->len;
+    }
+    if (sz == 0) {
+        return WOLFSSL_CBIO_ERR_WANT_WRITE;
+    }
+    XMEMCPY(&b->buf[b->len], buf, (size_t)sz);
+    b->len += sz;
+    return sz;
+}
+
+static int EvBufRecv(evBuf_t* b, char* buf, int sz)
+{
+    if (b->len == 0) {
+        return WOLFSSL_CBIO_ERR_WANT_READ;
+    }
+    if (sz > b->len) {
+        sz = b->len;
+    }
+    XMEMCPY(buf, b->buf, (size_t)sz);
+    b->len -= sz;
+    XMEMMOVE(b->buf, &b->buf[sz], (size_t)b->len);
+    return sz;
+}
+
+static int EvServerSend(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    return EvBufSend(&((evConn_t*)ctx)->to_client, buf, sz);
+}
+
+static int EvServerRecv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    return EvBufRecv(&((evConn_t*)ctx)->to_server, buf, sz);
+}
+
+static int EvClientSend(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    return EvBufSend(&((evConn_t*)ctx)->to_server, buf, sz);
+}
+
+static int EvClientRecv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    return EvBufRecv(&((evConn_t*)ctx)->to_client, buf, sz);
+}
+
+static WOLFSSL_CTX* EvCtxNew(const char* cipher, int server)
+{
+    WOLFSSL_CTX* ctx;
+    int tls13 = XSTRNCMP(cipher, "TLS13", 5) == 0;
+    int ret;
+
+#ifdef WOLFSSL_TLS13
+    if (tls13) {
+        ctx = wolfSSL_CTX_new(server ? wolfTLSv1_3_server_method() :
+                                       wolfTLSv1_3_client_method());
+    }
+    else
+#endif
+    {
+    #if !defined(WOLFSSL_TLS13)
+        ctx = wolfSSL_CTX_new(server ? wolfSSLv23_server_method() :
+                                       wolfSSLv23_client_method());
+    #elif !defined(WOLFSSL_NO_TLS12)
+        ctx = wolfSSL_CTX_new(server ? wolfTLSv1_2_server_method() :
+                                       wolfTLSv1_2_client_method());
+    #else
+        ctx = NULL;
+    #endif
+    }
+    if (ctx == NULL) {
+        return NULL;
+    }
+
+#ifndef NO_CERTS
+    if (server) {
+    #ifdef HAVE_ECC
+        if (XSTRSTR(cipher, "ECDSA")) {
+            ret = wolfSSL_CTX_use_PrivateKey_buffer(ctx, ecc_key_der_256,
+                sizeof_ecc_key_der_256, WOLFSSL_FILETYPE_ASN1);
+            if (ret == WOLFSSL_SUCCESS) {
+                ret = wolfSSL_CTX_use_certificate_buffer(ctx,
+                    serv_ecc_der_256, sizeof_serv_ecc_der_256,
+                    WOLFSSL_FILETYPE_ASN1);
+            }
+        }
+        else
+    #endif
+        {
+            ret = wolfSSL_CTX_use_PrivateKey_buffer(ctx, server_key_der_2048,
+                sizeof_server_key_der_2048, WOLFSSL_FILETYPE_ASN1);
+            if (ret == WOLFSSL_SUCCESS) {
+                ret = wolfSSL_CTX_use_certificate_buffer(ctx,
+                    server_cert_der_2048, sizeof_server_cert_der_2048,
+                    WOLFSSL_FILETYPE_ASN1);
+            }
+        }
+    }
+    else {
+    #ifdef HAVE_ECC
+        if (XSTRSTR(cipher, "ECDSA")) {
+            ret = wolfSSL_CTX_load_verify_buffer(ctx, ca_ecc_cert_der_256,
+                sizeof_ca_ecc_cert_der_256, WOLFSSL_FILETYPE_ASN1);
+        }
+        else
+    #endif
+        {
+            ret = wolfSSL_CTX_load_verify_buffer(ctx, ca_cert_der_2048,
+                sizeof_ca_cert_der_2048, WOLFSSL_FILETYPE_ASN1);
+        }
+    }
+    if (ret != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "error loading %s certificates\n",
+            server ? "server" : "client");
+        wolfSSL_CTX_free(ctx);
+        return NULL;
+    }
+#endif /* !NO_CERTS */
+
+    if (server) {
+        wolfSSL_CTX_SetIOSend(ctx, EvServerSend);
+        wolfSSL_CTX_SetIORecv(ctx, EvServerRecv);
+    }
+    else {
+        wolfSSL_CTX_SetIOSend(ctx, EvClientSend);
+        wolfSSL_CTX_SetIORecv(ctx, EvClientRecv);
+    }
+
+    ret = wolfSSL_CTX_set_cipher_list(ctx, cipher);
+#ifndef NO_DH
+    if (ret == WOLFSSL_SUCCESS) {
+        ret = wolfSSL_CTX_SetMinDhKey_Sz(ctx, MIN_DHKEY_BITS);
+    }
+#endif
+    if (ret != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "error setting cipher suite\n");
+        wolfSSL_CTX_free(ctx);
+        return NULL;
+    }
+
+#ifndef NO_PSK
+    if (server) {
+        wolfSSL_CTX_set_psk_server_callback(ctx, my_psk_server_cb);
+    #ifdef WOLFSSL_TLS13
+        wolfSSL_CTX_set_psk_server_tls13_callback(ctx,
+            my_psk_server_tls13_cb);
+    #endif
+    }
+    else {
+        wolfSSL_CTX_set_psk_client_callback(ctx, my_psk_client_cb);
+    #ifdef WOLFSSL_TLS13
+        #if !defined(WOLFSSL_PSK_TLS13_CB) && !defined(WOLFSSL_PSK_ONE_ID)
+        wolfSSL_CTX_set_psk_client_cs_callback(ctx, my_psk_client_cs_cb);
+        #else
+        wolfSSL_CTX_set_psk_client_tls13_callback(ctx,
+            my_psk_client_tls13_cb);
+        #endif
+    #endif
+        wolfSSL_CTX_set_psk_callback_ctx(ctx, (void*)cipher);
+    }
+#endif /* !NO_PSK */
+
+    (void)tls13;
+
+    return ctx;
+}
+
+static int EvConnStart(evConn_t* c, WOLFSSL_CTX* cli_ctx,
+    WOLFSSL_CTX* srv_ctx)
+{
+    XMEMSET(c, 0, sizeof(*c));
+    c->cli = wolfSSL_new(cli_ctx);
+    c->srv = wolfSSL_new(srv_ctx);
+    if (c->cli == NULL || c->srv == NULL) {
+        fprintf(stderr, "error creating ssl objects\n");
+        return MEMORY_E;
+    }
+    wolfSSL_SetIOReadCtx(c->cli, c);
+    wolfSSL_SetIOWriteCtx(c->cli, c);
+    wolfSSL_SetIOReadCtx(c->srv, c);
+    wolfSSL_SetIOWriteCtx(c->srv, c);
+#ifndef NO_DH
+    wolfSSL_SetTmpDH(c->srv, dhp, sizeof(dhp), dhg, sizeof(dhg));
+#endif
+    return 0;
+}
+
+static void EvConnFree(evConn_t* c)
+{
+    wolfSSL_free(c->cli);
+    wolfSSL_free(c->srv);
+    c->cli = NULL;
+    c->srv = NULL;
+}
+
+/* One server step: accept, or check on an op the pool is running. Returns 1
+ * when still waiting on the pool, 0 otherwise or a negative error. */
+static int EvServerStep(evConn_t* c, evStats_t* st)
+{
+    double t;
+    int ret, err, waiting = 0;
+
+    t = gettime_secs(1);
+    if (c->srvPending) {
+        ret = wolfSSL_AsyncPoll(c->srv, WOLF_POLL_FLAG_CHECK_HW);
+        if (ret == 0) {
+            waiting = 1;
+        }
+        else if (ret > 0) {
+            c->srvPending = 0;
+            ret = 0;
+        }
+    }
+    else {
+        ret = wolfSSL_accept(c->srv);
+        if (ret == WOLFSSL_SUCCESS) {
+            c->srvDone = 1;
+            ret = 0;
+        }
+        else {
+            err = wolfSSL_get_error(c->srv, ret);
+            ret = 0;
+            if (err == WC_NO_ERR_TRACE(WC_PENDING_E)) {
+                c->srvPending = 1;
+            }
+            else if (err != WOLFSSL_ERROR_WANT_READ &&
+                     err != WOLFSSL_ERROR_WANT_WRITE) {
+                fprintf(stderr, "error on server accept\n");
+                ret = err;
+            }
+        }
+    }
+    t = gettime_secs(0) - t;
+
+    st->calls++;
+    st->stallTotal += t;
+    if (t > st->stallMax) {
+        st->stallMax = t;
+    }
+
+    return (ret < 0) ? ret : waiting;
+}
+
+static int bench_tls_evloop(const char* cipher, int runTimeSec, int devId,
+    evStats_t* st)
+{
+    WOLFSSL_CTX* cli_ctx = NULL;
+    WOLFSSL_CTX* srv_ctx = NULL;
+    evConn_t* conns = NULL;
+    evConn_t* c;
+    struct pollfd pfd;
+    double start;
+    int ret = 0, err, i, active, waiting, running;
+
+    XMEMSET(st, 0, sizeof(*st));
+
+    cli_ctx = EvCtxNew(cipher, 0);
+    srv_ctx = EvCtxNew(cipher, 1);
+    if (cli_ctx == NULL || srv_ctx == NULL) {
+        ret = MEMORY_E; goto exit;
+    }
+    /* only the server's public key ops go to the pool */
+    wolfSSL_CTX_SetDevId(srv_ctx, devId);
+
+    conns = (evConn_t*)XMALLOC(sizeof(evConn_t) * EVLOOP_CONNS, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER);
+    if (conns == NULL) {
+        ret = MEMORY_E; goto exit;
+    }
+    XMEMSET(conns, 0, sizeof(evConn_t) * EVLOOP_CONNS);
+    for (i = 0; i < EVLOOP_CONNS && ret == 0; i++) {
+        ret = EvConnStart(&conns[i], cli_ctx, srv_ctx);
+    }
+
+    pfd.fd = (devId != INVALID_DEVID) ? wolfAsync_ThreadPoolGetFd() : -1;
+    pfd.events = POLLIN;
+
+    start = gettime_secs(1);
+    while (ret == 0) {
+        active = waiting = 0;
+        running = (gettime_secs(0) - start) < runTimeSec;
+
+        for (i = 0; i < EVLOOP_CONNS && ret == 0; i++) {
+            c = &conns[i];
+            if (c->cli == NULL) {
+                continue;
+            }
+            if (!c->cliDone) {
+                ret = wolfSSL_connect(c->cli);
+                if (ret == WOLFSSL_SUCCESS) {
+                    c->cliDone = 1;
+                }
+                else {
+                    err = wolfSSL_get_error(c->cli, ret);
+                    if (err != WOLFSSL_ERROR_WANT_READ &&
+                        err != WOLFSSL_ERROR_WANT_WRITE) {
+                        fprintf(stderr, "error on client connect\n");
+                        ret = err;
+                        break;
+                    }
+                }
+                ret = 0;
+            }
+            if (!c->srvDone) {
+                ret = EvServerStep(c, st);
+                if (ret < 0) {
+                    break;
+                }
+                waiting += ret;
+                ret = 0;
+            }
+            if (c->cliDone && c->srvDone) {
+                st->handshakes++;
+                EvConnFree(c);
+                if (running) {
+                    ret = EvConnStart(c, cli_ctx, srv_ctx);
+                    active++;
+                }
+                continue;
+            }
+            active++;
+        }
+        if (active == 0) {
+            break;
+        }
+        /* Everyone is waiting on the pool: sleep until an op completes. */
+        if (ret == 0 && waiting == active && pfd.fd >= 0) {
+            pfd.revents = 0;
+            (void)poll(&pfd, 1, 1000);
+            wolfAsync_ThreadPoolClearFd();
+        }
+    }
+    st->elapsed = gettime_secs(0) - start;
+
+exit:
+    if (conns != NULL) {
+        for (i = 0; i < EVLOOP_CONNS; i++) {
+            EvConnFree(&conns[i]);
+        }
+        XFREE(conns, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    }
+    wolfSSL_CTX_free(cli_ctx);
+    wolfSSL_CTX_free(srv_ctx);
+
+    return ret;
+}
+
+static void print_evloop_stats(evStats_t* st, const char* desc,
+    const char* cipher)
+{
+    fprintf(stderr, "%-6s  %-33s  %9d  %11.1f  %15.3f  %15.3f\n",
+            desc,
+            cipher,
+            st->handshakes,
+            st->handshakes / st->elapsed,
+            st->calls ? st->stallTotal * 1000 / st->calls : 0.0,
+            st->stallMax * 1000);
+}
+
+/* Run each cipher with the server's crypto inline and then on the pool. */
+static int bench_tls_evloop_all(char* cipher, int runTimeSec)
+{
+    evStats_t st;
+    char* next_cipher;
+    int devId = INVALID_DEVID;
+    int ret;
+
+    ret = wolfAsync_DevOpen(&devId);
+    if (ret != 0 || devId == INVALID_DEVID) {
+        fprintf(stderr, "error opening async device\n");
+        return (ret != 0) ? ret : ASYNC_INIT_E;
+    }
+
+    fprintf(stderr, "%-6s  %-33s  %9s  %11s  %15s  %15s\n",
+            "Loop", "Cipher", "Num Conns", "Conns/sec", "Stall Avg ms",
+            "Stall Max ms");
+
+    while (ret == 0 && cipher != NULL && cipher[0] != '\0') {
+        next_cipher = strchr(cipher, ':');
+        if (next_cipher != NULL) {
+            cipher[next_cipher - cipher] = '\0';
+        }
+
+        ret = bench_tls_evloop(cipher, runTimeSec, INVALID_DEVID, &st);
+        if (ret == 0) {
+            print_evloop_stats(&st, "Inline", cipher);
+            ret = bench_tls_evloop(cipher, runTimeSec, devId, &st);
+        }
+        if (ret == 0) {
+            print_evloop_stats(&st, "Pool", cipher);
+        }
+
+        cipher = (next_cipher != NULL) ? (next_cipher + 1) : NULL;
+    }
+
+    wolfAsync_DevClose(&devId);
+
+    return ret;
+}
+#endif /* BENCH_EVLOOP */
+
+#ifdef BENCH_IDLE
+/* Idle connection footprint mode: open many connections over memory
+ * buffers, echo one message on each and leave the server side open with the
+ * peer gone quiet. Reports the heap each idle server connection still holds,
+ * by default and with SSL_MODE_RELEASE_BUFFERS. Connections are set up one at
+ * a time, so a single pair of transfer buffers serves them all. */
+typedef struct {
+    unsigned char buf[MEM_BUFFER_SZ];
+    int len;
+} idleBuf_t;
+
+typedef union {
+    size_t sz;
+    byte   align[16];
+} idleHdr_t;
+
+static idleBuf_t idleToServer;
+static idleBuf_t idleToClient;
+static long idleMemCur;     /* heap bytes in use */
+static long idleMemPeak;    /* most heap bytes in use */
+
+#ifdef WOLFSSL_DEBUG_MEMORY
+static void* IdleMalloc(size_t sz, const char* func, unsigned int line)
+#else
+static void* IdleMalloc(size_t sz)
+#endif
+{
+    idleHdr_t* hdr = (idleHdr_t*)malloc(sizeof(idleHdr_t) + sz);
+#ifdef WOLFSSL_DEBUG_MEMORY
+    (void)func;
+    (void)line;
+#endif
+    if (hdr == NULL) {
+        return NULL;
+    }
+    hdr->sz = sz;
+    idleMemCur += (long)sz;
+    if (idleMemCur > idleMemPeak) {
+        idleMemPeak = idleMemCur;
+    }
+    return hdr + 1;
+}
+
+#ifdef WOLFSSL_DEBUG_MEMORY
+static void IdleFree(void* ptr, const char* func, unsigned int line)
+#else
+static void IdleFree(void* ptr)
+#endif
+{
+    idleHdr_t* hdr;
+#ifdef WOLFSSL_DEBUG_MEMORY
+    (void)func;
+    (void)line;
+#endif
+    if (ptr == NULL) {
+        return;
+    }
+    hdr = (idleHdr_t*)ptr - 1;
+    idleMemCur -= (long)hdr->sz;
+    free(hdr);
+}
+
+#ifdef WOLFSSL_DEBUG_MEMORY
+static void* IdleRealloc(void* ptr, size_t sz, const char* func,
+    unsigned int line)
+#else
+static void* IdleRealloc(void* ptr, size_t sz)
+#endif
+{
+    idleHdr_t* hdr = NULL;
+    size_t oldSz = 0;
+#ifdef WOLFSSL_DEBUG_MEMORY
+    (void)func;
+    (void)line;
+#endif
+    if (ptr != NULL) {
+        hdr = (idleHdr_t*)ptr - 1;
+        oldSz = hdr->sz;
+    }
+    hdr = (idleHdr_t*)realloc(hdr, sizeof(idleHdr_t) + sz);
+    if (hdr == NULL) {
+        return NULL;
+    }
+    hdr->sz = sz;
+    idleMemCur += (long)sz - (long)oldSz;
+    if (idleMemCur > idleMemPeak) {
+        idleMemPeak = idleMemCur;
+    }
+    return hdr + 1;
+}
+
+static int IdleBufSend(idleBuf_t* b, char* buf, int sz)
+{
+    if (sz > MEM_BUFFER_SZ - b->len) {
+        sz = MEM_BUFFER_SZ - b->len;
+    }
+    if (sz == 0) {
+        return WOLFSSL_CBIO_ERR_WANT_WRITE;
+    }
+    XMEMCPY(&b->buf[b->len], buf, (size_t)sz);
+    b->len += sz;
+    return sz;
+}
+
+static int IdleBufRecv(idleBuf_t* b, char* buf, int sz)
+{
+    if (b->len == 0) {
+        return WOLFSSL_CBIO_ERR_WANT_READ;
+    }
+    if (sz > b->len) {
+        sz = b->len;
+    }
+    XMEMCPY(buf, b->buf, (size_t)sz);
+    b->len -= sz;
+    XMEMMOVE(b->buf, &b->buf[sz], (size_t)b->len);
+    return sz;
+}
+
+static int IdleServerSend(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    (void)ctx;
+    return IdleBufSend(&idleToClient, buf, sz);
+}
+
+static int IdleServerRecv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    (void)ctx;
+    return IdleBufRecv(&idleToServer, buf, sz);
+}
+
+static int IdleClientSend(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    (void)ctx;
+    return IdleBufSend(&idleToServer, buf, sz);
+}
+
+static int IdleClientRecv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    (void)ssl;
+    (void)ctx;
+    return IdleBufRecv(&idleToClient, buf, sz);
+}
+
+static WOLFSSL_CTX* IdleCtxNew(const char* cipher, int server)
+{
+    WOLFSSL_CTX* ctx;
+    int ret = WOLFSSL_SUCCESS;
+#if !defined(NO_CERTS) && defined(HAVE_ECC)
+    int ecc = (cipher == NULL) || (XSTRSTR(cipher, "RSA") == NULL);
+#endif
+
+#ifndef WOLFSSL_NO_TLS12
+    if (cipher != NULL && XSTRNCMP(cipher, "TLS13", 5) != 0) {
+        ctx = wolfSSL_CTX_new(server ? wolfTLSv1_2_server_method() :
+                                       wolfTLSv1_2_client_method());
+    }
+    else
+#endif
+    {
+        ctx = wolfSSL_CTX_new(server ? wolfSSLv23_server_method() :
+                                       wolfSSLv23_client_method());
+    }
+    if (ctx == NULL) {
+        return NULL;
+    }
+
+#ifndef NO_CERTS
+    if (server) {
+    #ifdef HAVE_ECC
+        if (ecc) {
+            ret = wolfSSL_CTX_use_PrivateKey_buffer(ctx, ecc_key_der_256,
+                sizeof_ecc_key_der_256, WOLFSSL_FILETYPE_ASN1);
+            if (ret == WOLFSSL_SUCCESS) {
+                ret = wolfSSL_CTX_use_certificate_buffer(ctx,
+                    serv_ecc_der_256, sizeof_serv_ecc_der_256,
+                    WOLFSSL_FILETYPE_ASN1);
+            }
+        }
+        else
+    #endif
+        {
+            ret = wolfSSL_CTX_use_PrivateKey_buffer(ctx, server_key_der_2048,
+                sizeof_server_key_der_2048, WOLFSSL_FILETYPE_ASN1);
+            if (ret == WOLFSSL_SUCCESS) {
+                ret = wolfSSL_CTX_use_certificate_buffer(ctx,
+                    server_cert_der_2048, sizeof_server_cert_der_2048,
+                    WOLFSSL_FILETYPE_ASN1);
+            }
+        }
+    }
+    else {
+    #ifdef HAVE_ECC
+        if (ecc) {
+            ret = wolfSSL_CTX_load_verify_buffer(ctx, ca_ecc_cert_der_256,
+                sizeof_ca_ecc_cert_der_256, WOLFSSL_FILETYPE_ASN1);
+        }
+        else
+    #endif
+        {
+            ret = wolfSSL_CTX_load_verify_buffer(ctx, ca_cert_der_2048,
+                sizeof_ca_cert_der_2048, WOLFSSL_FILETYPE_ASN1);
+        }
+    }
+    if (ret != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "error loading %s certificates\n",
+            server ? "server" : "client");
+        wolfSSL_CTX_free(ctx);
+        return NULL;
+    }
+#endif /* !NO_CERTS */
+
+    if (server) {
+        wolfSSL_CTX_SetIOSend(ctx, IdleServerSend);
+        wolfSSL_CTX_SetIORecv(ctx, IdleServerRecv);
+    }
+    else {
+        wolfSSL_CTX_SetIOSend(ctx, IdleClientSend);
+        wolfSSL_CTX_SetIORecv(ctx, IdleClientRecv);
+    }
+
+    if (cipher != NULL) {
+        ret = wolfSSL_CTX_set_cipher_list(ctx, cipher);
+    }
+#ifndef NO_DH
+    if (ret == WOLFSSL_SUCCESS) {
+        ret = wolfSSL_CTX_SetMinDhKey_Sz(ctx, MIN_DHKEY_BITS);
+    }
+#endif
+    if (ret != WOLFSSL_SUCCESS) {
+        fprintf(stderr, "error setting cipher suite\n");
+        wolfSSL_CTX_free(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
+/* Handshake a new server connection, echo one message over it and drop the
+ * client, leaving the server connection idle. The first client's session is
+ * kept and resumed by the rest, so setting up many connections is quick. */
+static int IdleConnOpen(WOLFSSL_CTX* cli_ctx, WOLFSSL_CTX* srv_ctx,
+    WOLFSSL** srvOut, WOLFSSL_SESSION** sess, int pktSz)
+{
+    static char msg[MEM_BUFFER_SZ];
+    WOLFSSL* cli;
+    WOLFSSL* srv;
+    int cliDone = 0, srvDone = 0;
+    int ret = 0, err, rounds, len, tot;
+
+    idleToServer.len = 0;
+    idleToClient.len = 0;
+    cli = wolfSSL_new(cli_ctx);
+    srv = wolfSSL_new(srv_ctx);
+    if (cli == NULL || srv == NULL) {
+        fprintf(stderr, "error creating ssl objects\n");
+        wolfSSL_free(cli);
+        wolfSSL_free(srv);
+        return MEMORY_E;
+    }
+#ifndef NO_DH
+    wolfSSL_SetTmpDH(srv, dhp, sizeof(dhp), dhg, sizeof(dhg));
+#endif
+#ifdef WOLFSSL_TLS_READ_AHEAD
+    wolfSSL_set_read_ahead(srv, 1);
+#endif
+    if (*sess != NULL) {
+        wolfSSL_set_session(cli, *sess);
+    }
+
+    for (rounds = 0; (!cliDone || !srvDone) && rounds < 100; rounds++) {
+        if (!cliDone) {
+            if (wolfSSL_connect(cli) == WOLFSSL_SUCCESS) {
+                cliDone = 1;
+            }
+            else {
+                err = wolfSSL_get_error(cli, 0);
+                if (err != WOLFSSL_ERROR_WANT_READ &&
+                        err != WOLFSSL_ERROR_WANT_WRITE) {
+                    fprintf(stderr, "client handshake error %d\n", err);
+                    ret = err;
+                    break;
+                }
+            }
+        }
+        if (!srvDone) {
+            if (wolfSSL_accept(srv) == WOLFSSL_SUCCESS) {
+                srvDone = 1;
+            }
+            else {
+                err = wolfSSL_get_error(srv, 0);
+                if (err != WOLFSSL_ERROR_WANT_READ &&
+                        err != WOLFSSL_ERROR_WANT_WRITE) {
+                    fprintf(stderr, "server handshake error %d\n", err);
+                    ret = err;
+                    break;
+                }
+            }
+        }
+    }
+    if (ret == 0 && (!cliDone || !srvDone)) {
+        fprintf(stderr, "handshake did not complete\n");
+        ret = WOLFSSL_FATAL_ERROR;
+    }
+
+    if (ret == 0) {
+        len = (int)XSTRLEN(kTestStr);
+        if (len > pktSz) {
+            len = pktSz;
+        }
+        if (wolfSSL_write(cli, kTestStr, len) != len) {
+            ret = WOLFSSL_FATAL_ERROR;
+        }
+        for (tot = 0; ret == 0 && tot < len; ) {
+            err = wolfSSL_read(srv, msg + tot, len - tot);
+            if (err > 0) {
+                tot += err;
+            }
+            else {
+                ret = WOLFSSL_FATAL_ERROR;
+            }
+        }
+        if (ret == 0 && wolfSSL_write(srv, msg, len) != len) {
+            ret = WOLFSSL_FATAL_ERROR;
+        }
+        for (tot = 0; ret == 0 && tot < len; ) {
+            err = wolfSSL_read(cli, msg + tot, len - tot);
+            if (err > 0) {
+                tot += err;
+            }
+            else {
+                ret = WOLFSSL_FATAL_ERROR;
+            }
+        }
+        if (ret != 0) {
+            fprintf(stderr, "error echoing message\n");
+        }
+    }
+    if (ret == 0 && *sess == NULL) {
+        *sess = wolfSSL_get1_session(cli);
+    }
+
+    wolfSSL_free(cli);
+    if (ret != 0) {
+        wolfSSL_free(srv);
+        srv = NULL;
+    }
+    *srvOut = srv;
+
+    return ret;
+}
+
+static int bench_tls_idle_run(const char* cipher, int conns, int pktSz,
+    int release)
+{
+    WOLFSSL_CTX* cli_ctx;
+    WOLFSSL_CTX* srv_ctx;
+    WOLFSSL** srv = NULL;
+    WOLFSSL_SESSION* sess = NULL;
+    long base;
+    double start, elapsed;
+    int i, opened = 0, ret = 0;
+
+    cli_ctx = IdleCtxNew(cipher, 0);
+    srv_ctx = IdleCtxNew(cipher, 1);
+    if (cli_ctx == NULL || srv_ctx == NULL) {
+        ret = MEMORY_E;
+    }
+#ifdef WOLFSSL_TLS13
+    if (ret == 0) {
+        /* resume without a new key exchange */
+        wolfSSL_CTX_no_dhe_psk(cli_ctx);
+    }
+#endif
+#ifdef BENCH_IDLE_RELEASE
+    if (ret == 0 && release) {
+        wolfSSL_CTX_set_mode(srv_ctx, WOLFSSL_MODE_RELEASE_BUFFERS);
+    }
+#endif
+    if (ret == 0) {
+        srv = (WOLFSSL**)XMALLOC(sizeof(WOLFSSL*) * (size_t)conns, NULL,
+            DYNAMIC_TYPE_TMP_BUFFER);
+        if (srv == NULL) {
+            ret = MEMORY_E;
+        }
+    }
+
+    base = idleMemCur;
+    idleMemPeak = idleMemCur;
+    start = gettime_secs(1);
+    for (i = 0; ret == 0 && i < conns; i++) {
+        ret = IdleConnOpen(cli_ctx, srv_ctx, &srv[i], &sess, pktSz);
+        if (ret == 0) {
+            opened++;
+        }
+    }
+    elapsed = gettime_secs(0) - start;
+
+    if (opened > 0) {
+        fprintf(stderr, "%-8s  %9d  %11.1f  %13.1f  %15.1f  %13.1f\n",
+                release ? "Release" : "Default",
+                opened,
+                opened / elapsed,
+                (double)(idleMemCur - base) / (1024 * 1024),
+                (double)(idleMemCur - base) / opened,
+                (double)(idleMemPeak - base) / (1024 * 1024));
+    }
+
+    for (i = 0; i < opened; i++) {
+        wolfSSL_free(srv[i]);
+    }
+    XFREE(srv, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    wolfSSL_SESSION_free(sess);
+    wolfSSL_CTX_free(cli_ctx);
+    wolfSSL_CTX_free(srv_ctx);
+
+    return ret;
+}
+
+/* Run the idle footprint with the library's heap use counted. The counting
+ * allocator only sees memory allocated while it is installed, so the library
+ * is restarted around the run. */
+static int bench_tls_idle(const char* cipher, int conns, int pktSz)
+{
+    wolfSSL_Malloc_cb  mf = NULL;
+    wolfSSL_Free_cb    ff = NULL;
+    wolfSSL_Realloc_cb rf = NULL;
+    int ret;
+
+    wolfSSL_Cleanup();
+    ret = wolfSSL_GetAllocators(&mf, &ff, &rf);
+    if (ret == 0) {
+        ret = wolfSSL_SetAllocators(IdleMalloc, IdleFree, IdleRealloc);
+    }
+    if (ret != 0) {
+        fprintf(stderr, "error installing counting allocator\n");
+        wolfSSL_Init();
+        return ret;
+    }
+    idleMemCur = 0;
+    wolfSSL_Init();
+
+    fprintf(stderr, "%-8s  %9s  %11s  %13s  %15s  %13s\n",
+            "Buffers", "Num Conns", "Conns/sec", "Idle Heap MB",
+            "Bytes/Idle Conn", "Peak Heap MB");
+    ret = bench_tls_idle_run(cipher, conns, pktSz, 0);
+#ifdef BENCH_IDLE_RELEASE
+    if (ret == 0) {
+        ret = bench_tls_idle_run(cipher, conns, pktSz, 1);
+    }
+#else
+    fprintf(stderr, "SSL_MODE_RELEASE_BUFFERS not available in this build\n");
+#endif
+
+    wolfSSL_Cleanup();
+    /* Anything still allocated must be freed by the counting allocator. */
+    if (idleMemCur == 0) {
+        wolfSSL_SetAllocators(mf, ff, rf);
+    }
+    wolfSSL_Init();
+
+    return ret;
+}
+#endif /* BENCH_IDLE */
+
 static void print_stats(stats_t* wcStat, const char* desc, const char* cipher, const char *group, int verbose)
 {
     if (verbose) {
@@ -1817,6 +2744,12 @@ static void Usage(void)
 #ifdef WOLFSSL_DTLS
     fprintf(stderr, "-u          Use DTLS\n");
 #endif
+#ifdef BENCH_EVLOOP
+    fprintf(stderr, "-a          Event loop latency, server crypto inline vs async thread pool\n");
+#endif
+#ifdef BENCH_IDLE
+    fprintf(stderr, "-I <num>    Heap held by <num> idle connections (0 for %d), default vs SSL_MODE_RELEASE_BUFFERS\n", IDLE_CONNS);
+#endif
 }
 
 static void ShowCiphers(void)
@@ -1928,6 +2861,12 @@ int bench_tls(void* args)
     int group_index = 0;
     int argDoGroups = 0;
 #endif
+#ifdef BENCH_EVLOOP
+    int argEvLoop = 0;
+#endif
+#ifdef BENCH_IDLE
+    int argIdleConns = 0;
+#endif
 
     if (args != NULL) {
         argc = ((func_args*)args)->argc;
@@ -1956,7 +2895,7 @@ int bench_tls(void* args)
 #endif /* HAVE_FIPS && HAVE_FIPS_VERSION == 5 */
 
     /* Parse command line arguments */
-    while ((ch = mygetopt(argc, argv, "?" "udeil:p:t:vT:sch:P:mS:g")) != -1) {
+    while ((ch = mygetopt(argc, argv, "?" "udeil:p:t:vT:sch:P:mS:gaI:")) != -1) {
         switch (ch) {
             case '?' :
                 Usage();
@@ -2051,6 +2990,27 @@ int bench_tls(void* args)
                 #endif
             #endif
                 break;
+            case 'a':
+            #ifdef BENCH_EVLOOP
+                argEvLoop = 1;
+                break;
+            #else
+                fprintf(stderr, "Event loop mode requires the async thread pool\n");
+                Usage();
+                ret = MY_EX_USAGE; goto exit;
+            #endif
+            case 'I':
+            #ifdef BENCH_IDLE
+                argIdleConns = atoi(myoptarg);
+                if (argIdleConns <= 0) {
+                    argIdleConns = IDLE_CONNS;
+                }
+                break;
+            #else
+                fprintf(stderr, "Idle connection mode requires the wolfSSL allocator\n");
+                Usage();
+                ret = MY_EX_USAGE; goto exit;
+            #endif
             default:
                 Usage();
                 ret = MY_EX_USAGE; goto exit;
@@ -2060,6 +3020,14 @@ int bench_tls(void* args)
     /* reset for test cases */
     myoptind = 0;
 
+#ifdef BENCH_IDLE
+    if (argIdleConns > 0) {
+        fprintf(stderr, "Running TLS Idle Connection Footprint...\n");
+        ret = bench_tls_idle(argCipherList, argIdleConns, argTestPacketSize);
+        goto exit;
+    }
+#endif
+
     if (argCipherList != NULL) {
         /* Use the list from CL argument */
         cipher = argCipherList;
@@ -2082,6 +3050,14 @@ int bench_tls(void* args)
     }
 #endif
 
+#ifdef BENCH_EVLOOP
+    if (argEvLoop) {
+        fprintf(stderr, "Running TLS Event Loop Benchmarks...\n");
+        ret = bench_tls_evloop_all(cipher, argRuntimeSec);
+        goto exit;
+    }
+#endif
+
     /* for server or client side only, only 1 thread is allowed */
     if (argServerOnly || argClientOnly) {
         argThreadPairs = 1;
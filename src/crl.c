@@ -32,6 +32,24 @@ CRL Options:
  * CRL_REPORT_LOAD_ERRORS:                                         default: off
  *                         Return any errors encountered during loading CRL
  *                         from a directory.
+ * CRL_REVOKED_INDEX:                                              default: off
+ *                         Build an immutable hash index over the revoked
+ *                         certs of each CRL when it is loaded so revocation
+ *                         lookups by serial or serial hash are O(1).
+ * CRL_REVOKED_INDEX_MIN:                                          default: 16
+ *                         Smallest number of revoked certs that gets an
+ *                         index. Shorter lists are searched directly.
+ * CRL_REVOKED_INDEX_NO_BLOOM:                                     default: off
+ *                         Don't put a bloom filter in front of the index.
+ *                         The filter answers most lookups of certs that are
+ *                         not revoked without touching the hash tables.
+ * HAVE_CRL_MMAP:                                                  default: off
+ *                         Map DER CRL files loaded from a file or directory
+ *                         instead of decoding their revoked certs. The
+ *                         signature is checked at load, then the serials
+ *                         are copied out and the file is unmapped. Mapped
+ *                         CRLs don't keep revocation dates, reasons or
+ *                         entry extensions. Enables CRL_REVOKED_INDEX.
 */
 
 #ifndef WOLFCRYPT_ONLY
@@ -148,6 +166,372 @@ static void SortCRL_CertList(RevokedCert* certs, int totalCerts)
 }
 #endif /* CRL_STATIC_REVOKED_LIST */
 
+#ifdef CRL_REVOKED_INDEX
+/* Upper bound on indexed certs, keeps the index size inside a word32. */
+#define CRL_REVOKED_INDEX_MAX_CERTS     (1 << 24)
+/* Number of bloom filter bits set per key. */
+#define CRL_REVOKED_BLOOM_PROBES        4
+/* Bloom filter bits per key, both keys of every cert are added. */
+#define CRL_REVOKED_BLOOM_BITS_PER_KEY  8
+
+/* Lookup index over the revoked certs of one CRL entry. Built in a single
+ * allocation when the entry is loaded and never modified afterwards so
+ * readers only need the CRL read lock. Serials are referenced in place, in
+ * the revoked cert list or the serials copied from a mapped CRL file. Table slots hold the
+ * position of the cert plus one, zero marks an empty slot. */
+struct CRL_RevokedIndex {
+    const byte**  serials;    /* serial number of each cert */
+    word32*       serialTbl;  /* open addressed table keyed on serial */
+    word32*       hashTbl;    /* open addressed table keyed on serial hash */
+#ifndef CRL_REVOKED_INDEX_NO_BLOOM
+    word32*       bloom;      /* bloom filter over both keys */
+    word32        bloomMask;  /* number of bloom bits - 1 */
+#endif
+    byte*         serialSzs;  /* size of each serial */
+    byte*         hashes;     /* CalcHashId() of each serial */
+    word32        mask;       /* number of table slots - 1 */
+    word32        count;      /* number of indexed certs */
+};
+
+/* FNV-1a with a final avalanche so sequential serials spread over the low
+ * bits used to pick a table slot. */
+static word32 RevokedIndexHash(const byte* data, word32 len)
+{
+    word32 h = 0x811C9DC5U ^ len;
+    word32 i;
+
+    for (i = 0; i < len; i++) {
+        h ^= data[i];
+        h *= 0x01000193U;
+    }
+    h ^= h >> 16;
+    h *= 0x85EBCA6BU;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35U;
+    h ^= h >> 16;
+
+    return h;
+}
+
+#ifndef CRL_REVOKED_INDEX_NO_BLOOM
+static void RevokedIndexBloomAdd(CRL_RevokedIndex* idx, word32 h)
+{
+    word32 step = ((h << 15) | (h >> 17)) | 1;
+    word32 bit;
+    int i;
+
+    for (i = 0; i < CRL_REVOKED_BLOOM_PROBES; i++) {
+        bit = h & idx->bloomMask;
+        idx->bloom[bit >> 5] |= (word32)1 << (bit & 31);
+        h += step;
+    }
+}
+
+static int RevokedIndexBloomCheck(const CRL_RevokedIndex* idx, word32 h)
+{
+    word32 step = ((h << 15) | (h >> 17)) | 1;
+    word32 bit;
+    int i;
+
+    for (i = 0; i < CRL_REVOKED_BLOOM_PROBES; i++) {
+        bit = h & idx->bloomMask;
+        if ((idx->bloom[bit >> 5] & ((word32)1 << (bit & 31))) == 0)
+            return 0;
+        h += step;
+    }
+
+    return 1;
+}
+#endif /* !CRL_REVOKED_INDEX_NO_BLOOM */
+
+static void RevokedIndexInsert(word32* tbl, word32 mask, word32 h, word32 pos)
+{
+    word32 slot = h & mask;
+
+    /* Tables are at most half full so an empty slot is always found. */
+    while (tbl[slot] != 0)
+        slot = (slot + 1) & mask;
+    tbl[slot] = pos + 1;
+}
+
+/* Allocate an empty index with room for n certs, NULL on failure. */
+static CRL_RevokedIndex* RevokedIndexNew(word32 n, void* heap)
+{
+    CRL_RevokedIndex* idx;
+    word32 slots;
+    word32 bloomWords = 0;
+    word32 sz;
+    byte* p;
+
+    if (n == 0 || n > CRL_REVOKED_INDEX_MAX_CERTS) {
+        WOLFSSL_MSG("Too many revoked certs to index");
+        return NULL;
+    }
+
+    /* Keep the load factor at or below one half. */
+    for (slots = 2; slots < 2 * n; slots <<= 1)
+        ;
+#ifndef CRL_REVOKED_INDEX_NO_BLOOM
+    for (bloomWords = 1;
+            bloomWords * 32 < 2 * n * CRL_REVOKED_BLOOM_BITS_PER_KEY;
+            bloomWords <<= 1)
+        ;
+#endif
+
+    sz = (word32)sizeof(CRL_RevokedIndex) + n * (word32)sizeof(byte*) +
+         (2 * slots + bloomWords) * (word32)sizeof(word32) +
+         n * (1 + SIGNER_DIGEST_SIZE);
+    idx = (CRL_RevokedIndex*)XMALLOC(sz, heap, DYNAMIC_TYPE_CRL_ENTRY);
+    if (idx == NULL) {
+        WOLFSSL_MSG("Revoked cert index alloc failed");
+        return NULL;
+    }
+    XMEMSET(idx, 0, sz);
+
+    p = (byte*)(idx + 1);
+    idx->serials = (const byte**)p;
+    p += n * sizeof(byte*);
+    idx->serialTbl = (word32*)p;
+    p += slots * sizeof(word32);
+    idx->hashTbl = (word32*)p;
+    p += slots * sizeof(word32);
+#ifndef CRL_REVOKED_INDEX_NO_BLOOM
+    idx->bloom = (word32*)p;
+    idx->bloomMask = bloomWords * 32 - 1;
+    p += bloomWords * sizeof(word32);
+#endif
+    idx->serialSzs = p;
+    p += n;
+    idx->hashes = p;
+    idx->mask = slots - 1;
+
+    (void)heap;
+    return idx;
+}
+
+/* Add a serial to an index made by RevokedIndexNew(). The serial is not
+ * copied and must outlive the index. Callers add at most n serials. */
+static int RevokedIndexAdd(CRL_RevokedIndex* idx, const byte* serial,
+        int serialSz)
+{
+    word32 pos = idx->count;
+    byte* hash = idx->hashes + pos * SIGNER_DIGEST_SIZE;
+    word32 h;
+    int ret;
+
+    if (serialSz <= 0 || serialSz > EXTERNAL_SERIAL_SIZE)
+        return BAD_FUNC_ARG;
+
+    ret = CalcHashId(serial, (word32)serialSz, hash);
+    if (ret != 0)
+        return ret;
+
+    idx->serials[pos] = serial;
+    idx->serialSzs[pos] = (byte)serialSz;
+    idx->count++;
+
+    h = RevokedIndexHash(serial, (word32)serialSz);
+    RevokedIndexInsert(idx->serialTbl, idx->mask, h, pos);
+#ifndef CRL_REVOKED_INDEX_NO_BLOOM
+    RevokedIndexBloomAdd(idx, h);
+#endif
+    h = RevokedIndexHash(hash, SIGNER_DIGEST_SIZE);
+    RevokedIndexInsert(idx->hashTbl, idx->mask, h, pos);
+#ifndef CRL_REVOKED_INDEX_NO_BLOOM
+    RevokedIndexBloomAdd(idx, h);
+#endif
+
+    return 0;
+}
+
+static void CRL_RevokedIndex_free(CRL_Entry* crle, void* heap)
+{
+    XFREE(crle->revokedIdx, heap, DYNAMIC_TYPE_CRL_ENTRY);
+    crle->revokedIdx = NULL;
+    (void)heap;
+}
+
+/* Build the lookup index for the revoked certs of crle. The index only speeds
+ * up FindRevokedSerial() so when it can't be built the entry is left without
+ * one and the list is searched instead.
+ * Returns 0 on success or when no index is needed. */
+static int CRL_RevokedIndex_build(CRL_Entry* crle, void* heap)
+{
+    CRL_RevokedIndex* idx;
+    word32 n;
+    int ret = 0;
+#ifdef CRL_STATIC_REVOKED_LIST
+    int i;
+#else
+    RevokedCert* rc;
+#endif
+
+    CRL_RevokedIndex_free(crle, heap);
+
+#ifdef HAVE_CRL_MMAP
+    /* Mapped certs are looked up through the index of the map. */
+    if (crle->map != NULL)
+        return 0;
+#endif
+    if (crle->totalCerts < CRL_REVOKED_INDEX_MIN)
+        return 0;
+    n = (word32)crle->totalCerts;
+
+    idx = RevokedIndexNew(n, heap);
+    if (idx == NULL) {
+        WOLFSSL_MSG("No revoked cert index, using list search");
+        return (n > CRL_REVOKED_INDEX_MAX_CERTS) ? 0 : MEMORY_E;
+    }
+
+#ifdef CRL_STATIC_REVOKED_LIST
+    for (i = 0; ret == 0 && i < crle->totalCerts; i++) {
+        ret = RevokedIndexAdd(idx, crle->certs[i].serialNumber,
+                crle->certs[i].serialSz);
+    }
+#else
+    for (rc = crle->certs; ret == 0 && rc != NULL && idx->count < n;
+            rc = rc->next) {
+        ret = RevokedIndexAdd(idx, rc->serialNumber, rc->serialSz);
+    }
+#endif
+
+    if (ret != 0) {
+        WOLFSSL_MSG("Revoked cert index build failed, using list search");
+        XFREE(idx, heap, DYNAMIC_TYPE_CRL_ENTRY);
+        return ret;
+    }
+
+    crle->revokedIdx = idx;
+    return 0;
+}
+
+static int CRL_RevokedIndex_find(const CRL_RevokedIndex* idx,
+        const byte* serial, int serialSz, const byte* serialHash)
+{
+    const word32* tbl;
+    word32 h;
+    word32 slot;
+    word32 pos;
+
+    if (serialHash == NULL) {
+        h = RevokedIndexHash(serial, (word32)serialSz);
+        tbl = idx->serialTbl;
+    }
+    else {
+        h = RevokedIndexHash(serialHash, SIGNER_DIGEST_SIZE);
+        tbl = idx->hashTbl;
+    }
+
+#ifndef CRL_REVOKED_INDEX_NO_BLOOM
+    if (!RevokedIndexBloomCheck(idx, h))
+        return 0;
+#endif
+
+    for (slot = h & idx->mask; (pos = tbl[slot]) != 0;
+            slot = (slot + 1) & idx->mask) {
+        pos--;
+        if (serialHash == NULL) {
+            if (idx->serialSzs[pos] == serialSz &&
+                    XMEMCMP(idx->serials[pos], serial,
+                            (size_t)serialSz) == 0) {
+                WOLFSSL_MSG("Cert revoked");
+                return CRL_CERT_REVOKED;
+            }
+        }
+        else if (XMEMCMP(idx->hashes + pos * SIGNER_DIGEST_SIZE, serialHash,
+                    SIGNER_DIGEST_SIZE) == 0) {
+            WOLFSSL_MSG("Cert revoked");
+            return CRL_CERT_REVOKED;
+        }
+    }
+
+    return 0;
+}
+#endif /* CRL_REVOKED_INDEX */
+
+#ifdef HAVE_CRL_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* Serials of a DER CRL file loaded through a read only mapping. Its revoked
+ * certs are not decoded, the serials are copied out of the mapping once the
+ * signature has been checked and the file is unmapped before the entry is
+ * used. Entries duplicated from the one the file was loaded into share the
+ * map. */
+struct CRL_Map {
+    byte*             serials; /* copy of all serials, back to back */
+    CRL_RevokedIndex* idx;     /* index over the serials */
+    wolfSSL_Ref       ref;     /* entries using the map */
+};
+
+/* Serials found while parsing a mapped CRL. */
+typedef struct CRL_MapSerials {
+    const byte** serials;
+    byte*        sizes;
+    word32       count;
+    word32       cap;
+    void*        heap;
+} CRL_MapSerials;
+
+static void CRL_Map_free(CRL_Map* map, void* heap)
+{
+    int doFree = 0;
+    int ret;
+
+    if (map == NULL)
+        return;
+
+    wolfSSL_RefDec(&map->ref, &doFree, &ret);
+    if (ret != 0)
+        WOLFSSL_MSG("Couldn't lock CRL map mutex");
+    if (!doFree)
+        return;
+
+    XFREE(map->idx, heap, DYNAMIC_TYPE_CRL_ENTRY);
+    XFREE(map->serials, heap, DYNAMIC_TYPE_CRL_ENTRY);
+    wolfSSL_RefFree(&map->ref);
+    XFREE(map, heap, DYNAMIC_TYPE_CRL_ENTRY);
+    (void)heap;
+}
+
+/* ParseCRL() revoked cert callback, records where each serial is. */
+static int CRL_MapCollect(void* ctx, const byte* serial, int serialSz)
+{
+    CRL_MapSerials* ms = (CRL_MapSerials*)ctx;
+
+    if (ms->count == ms->cap) {
+        word32 cap = (ms->cap == 0) ? 256 : ms->cap * 2;
+        const byte** serials;
+        byte* sizes;
+
+        if (cap > CRL_REVOKED_INDEX_MAX_CERTS) {
+            WOLFSSL_MSG("Too many revoked certs in mapped CRL");
+            return MEMORY_E;
+        }
+        serials = (const byte**)XREALLOC((void*)ms->serials,
+                cap * sizeof(byte*), ms->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        if (serials == NULL)
+            return MEMORY_E;
+        ms->serials = serials;
+        sizes = (byte*)XREALLOC(ms->sizes, cap, ms->heap,
+                DYNAMIC_TYPE_TMP_BUFFER);
+        if (sizes == NULL)
+            return MEMORY_E;
+        ms->sizes = sizes;
+        ms->cap = cap;
+    }
+
+    ms->serials[ms->count] = serial;
+    ms->sizes[ms->count] = (byte)serialSz;
+    ms->count++;
+
+    return 0;
+}
+#endif /* HAVE_CRL_MMAP */
+
 /* Initialize CRL Entry */
 static int InitCRL_Entry(CRL_Entry* crle, DecodedCRL* dcrl, const byte* buff,
                          int verified, void* heap)
@@ -241,6 +625,10 @@ static int InitCRL_Entry(CRL_Entry* crle, DecodedCRL* dcrl, const byte* buff,
         crle->signature = NULL;
     }
 
+#ifdef CRL_REVOKED_INDEX
+    (void)CRL_RevokedIndex_build(crle, heap);
+#endif
+
     (void)verified;
     (void)heap;
 
@@ -294,6 +682,13 @@ static void CRL_Entry_free(CRL_Entry* crle, void* heap)
         }
 
     }
+#endif
+#ifdef CRL_REVOKED_INDEX
+    CRL_RevokedIndex_free(crle, heap);
+#endif
+#ifdef HAVE_CRL_MMAP
+    CRL_Map_free(crle->map, heap);
+    crle->map = NULL;
 #endif
     XFREE(crle->signature, heap, DYNAMIC_TYPE_CRL_ENTRY);
     XFREE(crle->toBeSigned, heap, DYNAMIC_TYPE_CRL_ENTRY);
@@ -379,11 +774,31 @@ void FreeCRL(WOLFSSL_CRL* crl, int dynamic)
         XFREE(crl, crl->heap, DYNAMIC_TYPE_CRL);
 }
 
-static int FindRevokedSerial(RevokedCert* rc, byte* serial, int serialSz,
-        byte* serialHash, int totalCerts)
+static int FindRevokedSerial(CRL_Entry* crle, byte* serial, int serialSz,
+        byte* serialHash)
 {
     int ret = 0;
     byte hash[SIGNER_DIGEST_SIZE];
+    RevokedCert* rc = crle->certs;
+#ifdef CRL_STATIC_REVOKED_LIST
+    int totalCerts = crle->totalCerts;
+#endif
+
+#ifdef HAVE_CRL_MMAP
+    if (crle->map != NULL && crle->map->idx != NULL) {
+        ret = CRL_RevokedIndex_find(crle->map->idx, serial, serialSz,
+                serialHash);
+        /* Certs added after loading are on the list. */
+        if (ret != 0 || rc == NULL)
+            return ret;
+    }
+#endif
+#ifdef CRL_REVOKED_INDEX
+    if (crle->revokedIdx != NULL) {
+        return CRL_RevokedIndex_find(crle->revokedIdx, serial, serialSz,
+                serialHash);
+    }
+#endif
 #ifdef CRL_STATIC_REVOKED_LIST
     if (serialHash == NULL) {
         /* Binary search by (serialSz, serialNumber). The array was sorted in
@@ -434,7 +849,6 @@ static int FindRevokedSerial(RevokedCert* rc, byte* serial, int serialSz,
         }
     }
 #else
-    (void)totalCerts;
     /* search in the linked list*/
     while (rc) {
         if (serialHash == NULL) {
@@ -573,8 +987,7 @@ static int CheckCertCRLList(WOLFSSL_CRL* crl, byte* issuerHash, byte* serial,
             }
             if (nextDateValid) {
                 foundEntry = 1;
-                ret = FindRevokedSerial(crle->certs, serial, serialSz,
-                        serialHash, crle->totalCerts);
+                ret = FindRevokedSerial(crle, serial, serialSz, serialHash);
                 if (ret != 0)
                     break;
             }
@@ -825,6 +1238,7 @@ static int AddCRL(WOLFSSL_CRL* crl, DecodedCRL* dcrl, CRL_Entry* crle,
 {
     CRL_Entry* curr = NULL;
     CRL_Entry* prev = NULL;
+    CRL_Entry* replaced = NULL;
 #ifdef HAVE_CRL_UPDATE_CB
     CrlInfo old;
     CrlInfo cnew;
@@ -879,8 +1293,10 @@ static int AddCRL(WOLFSSL_CRL* crl, DecodedCRL* dcrl, CRL_Entry* crle,
             }
 #endif
 
-            /* Remove the current entry which was replaced */
-            CRL_Entry_free(curr, crl->heap);
+            /* Remove the current entry which was replaced. Readers only
+             * use entries while holding the read lock so it is freed once
+             * the write lock is released. */
+            replaced = curr;
 
             break;
         }
@@ -894,6 +1310,13 @@ static int AddCRL(WOLFSSL_CRL* crl, DecodedCRL* dcrl, CRL_Entry* crle,
     }
 
     wc_UnLockRwLock(&crl->crlLock);
+
+#ifdef WOLFSSL_CHAIN_CACHE
+    /* Revocation state changed - verified chains need checking again. */
+    CM_ChainCacheInvalidate(crl->cm);
+#endif
+
+    CRL_Entry_free(replaced, crl->heap);
     return 0;
 }
 
@@ -982,6 +1405,164 @@ int BufferLoadCRL(WOLFSSL_CRL* crl, const byte* buff, long sz, int type,
     return ret ? ret : WOLFSSL_SUCCESS; /* convert 0 to WOLFSSL_SUCCESS */
 }
 
+#ifdef HAVE_CRL_MMAP
+/* Load a DER CRL file without decoding its revoked certs into RevokedCert
+ * objects. The file is mapped read only and the signature is checked once
+ * here. The serials are then copied into owned memory and the file is
+ * unmapped, rewriting it later can't fault lookups or swap in serials that
+ * were never verified. A file changed while it is being loaded is rejected.
+ * WOLFSSL_SUCCESS on ok */
+int LoadMappedCRL(WOLFSSL_CRL* crl, const char* file)
+{
+    int            ret = 0;
+    int            fd;
+    struct stat    st;
+    struct stat    st2;
+    void*          base;
+    size_t         sz;
+    CRL_Map*       map = NULL;
+    CRL_Entry*     crle = NULL;
+    CRL_MapSerials ms;
+    word32         total = 0;
+    word32         i;
+    WC_DECLARE_VAR(dcrl, DecodedCRL, 1, 0);
+
+    WOLFSSL_ENTER("LoadMappedCRL");
+
+    if (crl == NULL || file == NULL)
+        return BAD_FUNC_ARG;
+
+    fd = open(file, O_RDONLY);
+    if (fd < 0) {
+        WOLFSSL_MSG("Couldn't open CRL file");
+        return WOLFSSL_BAD_FILE;
+    }
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+            (word64)st.st_size >= (word64)0xFFFFFFFFUL) {
+        WOLFSSL_MSG("Bad CRL file size");
+        close(fd);
+        return WOLFSSL_BAD_FILE;
+    }
+    sz = (size_t)st.st_size;
+    base = mmap(NULL, sz, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) {
+        WOLFSSL_MSG("Couldn't map CRL file");
+        close(fd);
+        return WOLFSSL_BAD_FILE;
+    }
+
+    map = (CRL_Map*)XMALLOC(sizeof(CRL_Map), crl->heap,
+            DYNAMIC_TYPE_CRL_ENTRY);
+    if (map == NULL) {
+        (void)munmap(base, sz);
+        close(fd);
+        return MEMORY_E;
+    }
+    XMEMSET(map, 0, sizeof(CRL_Map));
+    wolfSSL_RefInit(&map->ref, &ret);
+    if (ret != 0) {
+        (void)munmap(base, sz);
+        close(fd);
+        XFREE(map, crl->heap, DYNAMIC_TYPE_CRL_ENTRY);
+        return ret;
+    }
+
+    crle = CRL_Entry_new(crl->heap);
+    if (crle == NULL) {
+        WOLFSSL_MSG_CERT_LOG("alloc CRL Entry failed");
+        CRL_Map_free(map, crl->heap);
+        (void)munmap(base, sz);
+        close(fd);
+        return MEMORY_E;
+    }
+    /* Entry owns the map from here on. */
+    crle->map = map;
+
+#ifdef WOLFSSL_SMALL_STACK
+    dcrl = (DecodedCRL*)XMALLOC(sizeof(DecodedCRL), NULL,
+            DYNAMIC_TYPE_TMP_BUFFER);
+    if (dcrl == NULL) {
+        CRL_Entry_free(crle, crl->heap);
+        (void)munmap(base, sz);
+        close(fd);
+        return MEMORY_E;
+    }
+#endif
+
+    XMEMSET(&ms, 0, sizeof(ms));
+    ms.heap = crl->heap;
+
+    InitDecodedCRL(dcrl, crl->heap);
+#ifdef WC_ASN_UNKNOWN_EXT_CB
+    if (crl->cm != NULL) {
+        dcrl->unknownExtCallback      = crl->cm->crlUnknownExtCallback;
+        dcrl->unknownExtCallbackEx    = crl->cm->crlUnknownExtCallbackEx;
+        dcrl->unknownExtCallbackExCtx = crl->cm->crlUnknownExtCallbackExCtx;
+    }
+#endif
+    dcrl->revokedCallback    = CRL_MapCollect;
+    dcrl->revokedCallbackCtx = &ms;
+
+    ret = ParseCRL(crle->certs, dcrl, (const byte*)base, (word32)sz, VERIFY,
+                   crl->cm);
+    if (ret != 0) {
+        WOLFSSL_MSG_CERT_LOG("ParseCRL error");
+    }
+
+    /* Copy the verified serials out of the mapping. */
+    if (ret == 0 && ms.count > 0) {
+        for (i = 0; i < ms.count; i++)
+            total += ms.sizes[i];
+        map->serials = (byte*)XMALLOC(total, crl->heap,
+                DYNAMIC_TYPE_CRL_ENTRY);
+        if (map->serials == NULL)
+            ret = MEMORY_E;
+        total = 0;
+        for (i = 0; ret == 0 && i < ms.count; i++) {
+            XMEMCPY(map->serials + total, ms.serials[i], ms.sizes[i]);
+            ms.serials[i] = map->serials + total;
+            total += ms.sizes[i];
+        }
+    }
+    /* Only keep the copies when the file wasn't written to while it was
+     * parsed, verified and copied. */
+    if (ret == 0 && (fstat(fd, &st2) != 0 || st2.st_dev != st.st_dev ||
+            st2.st_ino != st.st_ino || st2.st_size != st.st_size ||
+            st2.st_mtime != st.st_mtime || st2.st_ctime != st.st_ctime)) {
+        WOLFSSL_MSG_CERT_LOG("CRL file changed while loading");
+        ret = WOLFSSL_BAD_FILE;
+    }
+
+    if (ret == 0 && ms.count > 0) {
+        map->idx = RevokedIndexNew(ms.count, crl->heap);
+        if (map->idx == NULL)
+            ret = MEMORY_E;
+        for (i = 0; ret == 0 && i < ms.count; i++)
+            ret = RevokedIndexAdd(map->idx, ms.serials[i], ms.sizes[i]);
+    }
+
+    if (ret == 0) {
+        ret = AddCRL(crl, dcrl, crle, (const byte*)base, 1);
+        if (ret != 0) {
+            WOLFSSL_MSG_CERT_LOG("AddCRL error");
+        }
+    }
+    if (ret != 0) {
+        CRL_Entry_free(crle, crl->heap);
+    }
+
+    XFREE((void*)ms.serials, crl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(ms.sizes, crl->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    FreeDecodedCRL(dcrl);
+    WC_FREE_VAR_EX(dcrl, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    /* Nothing that was kept points into the mapping. */
+    (void)munmap(base, sz);
+    close(fd);
+
+    return ret ? ret : WOLFSSL_SUCCESS;
+}
+#endif /* HAVE_CRL_MMAP */
+
 /* Store CRL into a buffer in DER or PEM format.
  * If buff is NULL, updates inOutSz with required size and returns success.
  * Returns WOLFSSL_SUCCESS on success, negative on failure.
@@ -1417,6 +1998,23 @@ static CRL_Entry* DupCRL_Entry(const CRL_Entry* ent, void* heap)
         return NULL;
     }
 #endif
+#ifdef HAVE_CRL_MMAP
+    if (ent->map != NULL) {
+        int err;
+
+        /* The serials are never modified, share them. */
+        wolfSSL_RefInc(&ent->map->ref, &err);
+        if (err != 0) {
+            CRL_Entry_free(dupl, heap);
+            return NULL;
+        }
+        dupl->map = ent->map;
+    }
+#endif
+#ifdef CRL_REVOKED_INDEX
+    /* The index points into the original list so build a new one. */
+    (void)CRL_RevokedIndex_build(dupl, heap);
+#endif
 #ifdef OPENSSL_EXTRA
     dupl->issuer = wolfSSL_X509_NAME_dup(ent->issuer);
     if (ent->issuer != NULL && dupl->issuer == NULL) {
@@ -1730,12 +2328,19 @@ static int SwapLists(WOLFSSL_CRL* crl)
 
     newList = tmp->crlList;
 
-    /* swap lists */
+    /* swap lists. The new entries were loaded, indexed and verified above
+     * so the write lock is only held for the swap. Readers only use entries
+     * while holding the read lock so the old list is freed after it is
+     * released. */
     tmp->crlList  = crl->crlList;
     crl->crlList = newList;
 
     wc_UnLockRwLock(&crl->crlLock);
 
+#ifdef WOLFSSL_CHAIN_CACHE
+    CM_ChainCacheInvalidate(crl->cm);
+#endif
+
     FreeCRL(tmp, 0);
 
     WC_FREE_VAR_EX(tmp, NULL, DYNAMIC_TYPE_TMP_BUFFER);
@@ -2256,6 +2861,16 @@ static int StartMonitorCRL(WOLFSSL_CRL* crl)
 
 #if !defined(NO_FILESYSTEM) && !defined(NO_WOLFSSL_DIR)
 
+/* Load one CRL file found in a directory, WOLFSSL_SUCCESS on ok */
+static int LoadCRLDirFile(WOLFSSL_CRL* crl, const char* name, int type)
+{
+#ifdef HAVE_CRL_MMAP
+    if (type == WOLFSSL_FILETYPE_ASN1)
+        return LoadMappedCRL(crl, name);
+#endif
+    return ProcessFile(NULL, name, type, CRL_TYPE, NULL, 0, crl, VERIFY);
+}
+
 /* Load CRL path files of type, WOLFSSL_SUCCESS on ok */
 int LoadCRL(WOLFSSL_CRL* crl, const char* path, int type, int monitor)
 {
@@ -2290,13 +2905,12 @@ int LoadCRL(WOLFSSL_CRL* crl, const char* path, int type, int monitor)
         }
 
 #ifndef CRL_REPORT_LOAD_ERRORS
-        if (!skip && ProcessFile(NULL, name, type, CRL_TYPE, NULL, 0, crl,
-                                 VERIFY) != WOLFSSL_SUCCESS) {
+        if (!skip && LoadCRLDirFile(crl, name, type) != WOLFSSL_SUCCESS) {
             WOLFSSL_MSG("CRL file load failed, continuing");
         }
 #else
         if (!skip) {
-            ret = ProcessFile(NULL, name, type, CRL_TYPE, NULL, 0, crl, VERIFY);
+            ret = LoadCRLDirFile(crl, name, type);
             if (ret != WOLFSSL_SUCCESS) {
                 WOLFSSL_MSG("CRL file load failed");
                 wc_ReadDirClose(readCtx);
@@ -2614,6 +3228,13 @@ int wolfSSL_X509_CRL_add_revoked(WOLFSSL_X509_CRL* crl,
     }
     entry->totalCerts++;
 
+#ifdef CRL_REVOKED_INDEX
+    /* Entries built up one cert at a time are searched through the list,
+     * rebuilding on every add would be quadratic. DupCRL_Entry() indexes
+     * the copy again. */
+    CRL_RevokedIndex_free(entry, crl->heap);
+#endif
+
     /* Invalidate cached STACK_OF(X509_REVOKED) since list changed */
     if (crl->revokedStack != NULL) {
         wolfSSL_sk_pop_free(crl->revokedStack, NULL);
@@ -0,0 +1,1093 @@
+/* dtls_dispatch.c
+ *
+ * Copyright (C) 2006-2026 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+/* Server side DTLS dispatcher for many peers on one UDP socket.
+ *
+ * The dispatcher owns an unconnected UDP socket and the WOLFSSL objects of
+ * the peers talking to it:
+ *  - datagrams are read in batches with recvmmsg(),
+ *  - a datagram carrying one of our connection IDs is routed by CID, any
+ *    other by the peer's address,
+ *  - datagrams from unknown peers go to a stateless listener
+ *    (wolfDTLS_accept_stateless()) that answers with a cookie. Only a
+ *    ClientHello with a valid cookie creates a connection, which then
+ *    continues with wolfSSL_accept(),
+ *  - datagrams written by any connection are queued and sent in batches with
+ *    sendmmsg(). Runs of equal sized datagrams to one peer go out as a single
+ *    UDP GSO send.
+ *
+ * Received datagrams are copied to the connection they belong to and given to
+ * wolfSSL by its receive callback one datagram per read, as EmbedReceiveFrom()
+ * would. When a CID routed datagram arrives from a new address it is staged
+ * with wolfSSL_dtls_set_pending_peer() and only becomes the peer's address
+ * once wolfSSL has authenticated a record from it.
+ *
+ * Without recvmmsg()/sendmmsg() (not Linux, or
+ * WOLFSSL_DTLS_DISPATCH_NO_MMSG) the same batches are read and written with
+ * one recvfrom()/sendto() per datagram.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    /* recvmmsg() and sendmmsg() */
+    #define _GNU_SOURCE 1
+#endif
+
+#include <wolfssl/wolfcrypt/libwolfssl_sources.h>
+
+#ifdef NO_INLINE
+    #include <wolfssl/wolfcrypt/misc.h>
+#else
+    #define WOLFSSL_MISC_INCLUDED
+    #include <wolfcrypt/src/misc.c>
+#endif
+
+#ifndef WOLFCRYPT_ONLY
+#ifdef WOLFSSL_DTLS_DISPATCH
+
+#include <wolfssl/error-ssl.h>
+#include <wolfssl/ssl.h>
+#include <wolfssl/internal.h>
+
+#ifndef USE_WOLFSSL_IO
+    #error The DTLS dispatcher requires the wolfSSL socket I/O
+#endif
+
+#include <errno.h>
+
+#if defined(__linux__) && !defined(WOLFSSL_DTLS_DISPATCH_NO_MMSG)
+    #define DTLS_DISPATCH_MMSG
+    #ifndef WOLFSSL_DTLS_DISPATCH_NO_GSO
+        #define DTLS_DISPATCH_GSO
+        #include <netinet/udp.h>
+        #ifndef SOL_UDP
+            #define SOL_UDP         17
+        #endif
+        #ifndef UDP_SEGMENT
+            #define UDP_SEGMENT     103
+        #endif
+    #endif
+#endif
+
+/* Number of datagrams read or written with one system call. */
+#ifndef WOLFSSL_DTLS_DISPATCH_BATCH
+    #define WOLFSSL_DTLS_DISPATCH_BATCH         32
+#endif
+/* Number of buckets in each of the address and CID tables. Power of 2. */
+#ifndef WOLFSSL_DTLS_DISPATCH_BUCKETS
+    #define WOLFSSL_DTLS_DISPATCH_BUCKETS       256
+#endif
+/* Datagrams held for a connection before further ones are dropped. */
+#ifndef WOLFSSL_DTLS_DISPATCH_MAX_QUEUED
+    #define WOLFSSL_DTLS_DISPATCH_MAX_QUEUED    16
+#endif
+
+#if (WOLFSSL_DTLS_DISPATCH_BUCKETS & (WOLFSSL_DTLS_DISPATCH_BUCKETS - 1)) != 0
+    #error WOLFSSL_DTLS_DISPATCH_BUCKETS must be a power of 2
+#endif
+
+/* Largest datagram read. The size wolfSSL reads a DTLS datagram into. */
+#define DTLS_DISPATCH_DGRAM_SZ  (MAX_MTU + DTLS_MTU_ADDITIONAL_READ_BUFFER)
+/* Size of the buffer outgoing datagrams are queued in. */
+#define DTLS_DISPATCH_TX_SZ     \
+    (WOLFSSL_DTLS_DISPATCH_BATCH * DTLS_DISPATCH_DGRAM_SZ)
+/* Size of the cookie secret shared by all listeners. */
+#define DTLS_DISPATCH_SECRET_SZ 32
+/* Attempts at picking a CID that is not in use. */
+#define DTLS_DISPATCH_CID_TRIES 8
+
+#ifdef DTLS_DISPATCH_GSO
+/* Kernel limit on the number of segments in one GSO send. */
+#define DTLS_DISPATCH_GSO_MAX_SEGS  64
+/* Largest UDP payload of one GSO send. */
+#define DTLS_DISPATCH_GSO_MAX_SZ    65000
+#endif
+
+/* A received datagram waiting for its connection to read it. The datagram
+ * data follows the structure. */
+typedef struct DtlsDispatchDgram {
+    struct DtlsDispatchDgram* next;
+    SOCKADDR_S peer;            /* Address the datagram came from */
+    XSOCKLENT  peerSz;
+    int        sz;
+    byte       viaCid;          /* Routed by connection ID */
+} DtlsDispatchDgram;
+
+/* A connection, or the stateless listener, owned by the dispatcher. */
+typedef struct DtlsDispatchPeer {
+    struct DtlsDispatchPeer* addrNext;  /* Next in address bucket */
+    struct DtlsDispatchPeer* cidNext;   /* Next in CID bucket */
+    struct DtlsDispatchPeer* readyNext; /* Next in ready list */
+    WOLFSSL_DTLS_DISPATCHER*   d;
+    WOLFSSL*                 ssl;
+    DtlsDispatchDgram*       head;      /* Queue of received datagrams */
+    DtlsDispatchDgram*       tail;
+    int                      queued;
+    SOCKADDR_S               addr;      /* Key in address table */
+    XSOCKLENT                addrSz;
+#ifdef WOLFSSL_DTLS_CID
+    byte                     cid[DTLS_CID_MAX_SIZE]; /* Key in CID table */
+#endif
+    byte                     linked;    /* In address and CID tables */
+    byte                     ready;     /* In ready list */
+} DtlsDispatchPeer;
+
+/* A datagram queued to be sent. */
+typedef struct DtlsDispatchTx {
+    SOCKADDR_S peer;
+    XSOCKLENT  peerSz;
+    word32     off;             /* Offset of data in transmit buffer */
+    word32     sz;
+} DtlsDispatchTx;
+
+struct WOLFSSL_DTLS_DISPATCHER {
+    WOLFSSL_CTX*              ctx;
+    void*                     heap;
+    int                       sfd;
+    int                       cidSz;
+    word32                    seed;         /* Seed of table hashes */
+    WC_RNG                    rng;
+    byte                      rngInit;
+#ifdef DTLS_DISPATCH_GSO
+    byte                      gso;          /* Coalesce sends with GSO */
+#endif
+    byte                      secret[DTLS_DISPATCH_SECRET_SZ];
+    DtlsDispatchPeer*         addrTbl[WOLFSSL_DTLS_DISPATCH_BUCKETS];
+#ifdef WOLFSSL_DTLS_CID
+    DtlsDispatchPeer*         cidTbl[WOLFSSL_DTLS_DISPATCH_BUCKETS];
+#endif
+    DtlsDispatchPeer*         readyHead;
+    DtlsDispatchPeer*         readyTail;
+    DtlsDispatchPeer*         listener;
+    WolfDtlsDispatchNewPeerCb newPeerCb;
+    void*                     newPeerCtx;
+
+    byte*                     rxBuf;
+    SOCKADDR_S                rxPeer[WOLFSSL_DTLS_DISPATCH_BATCH];
+#ifdef DTLS_DISPATCH_MMSG
+    struct mmsghdr            rxMsg[WOLFSSL_DTLS_DISPATCH_BATCH];
+    struct iovec              rxIov[WOLFSSL_DTLS_DISPATCH_BATCH];
+    struct mmsghdr            txMsg[WOLFSSL_DTLS_DISPATCH_BATCH];
+    struct iovec              txIov[WOLFSSL_DTLS_DISPATCH_BATCH];
+    int                       txMsgCnt[WOLFSSL_DTLS_DISPATCH_BATCH];
+#ifdef DTLS_DISPATCH_GSO
+    union {
+        struct cmsghdr        hdr;
+        byte                  buf[CMSG_SPACE(sizeof(word16))];
+    }                         txCtrl[WOLFSSL_DTLS_DISPATCH_BATCH];
+#endif
+#endif
+
+    byte*                     txBuf;
+    word32                    txUsed;
+    int                       txCnt;
+    DtlsDispatchTx            tx[WOLFSSL_DTLS_DISPATCH_BATCH];
+};
+
+/* FNV-1a hash of data, seeded per dispatcher so that peers can't pick
+ * addresses that collide. */
+static word32 DtlsDispatchHash(word32 h, const byte* data, word32 sz)
+{
+    word32 i;
+
+    for (i = 0; i < sz; i++) {
+        h ^= data[i];
+        h *= 0x01000193;
+    }
+    return h;
+}
+
+/* Hash bucket of a peer address. Only the port and address are hashed as the
+ * rest of the socket address is not compared by sockAddrEqual(). */
+static word32 DtlsDispatchAddrBucket(const WOLFSSL_DTLS_DISPATCHER* d,
+    const SOCKADDR_S* addr, XSOCKLENT addrSz)
+{
+    word32 h = d->seed;
+
+    if (addr->ss_family == WOLFSSL_IP4 &&
+            addrSz >= (XSOCKLENT)sizeof(SOCKADDR_IN)) {
+        const SOCKADDR_IN* in = (const SOCKADDR_IN*)addr;
+        h = DtlsDispatchHash(h, (const byte*)&in->sin_port,
+            sizeof(in->sin_port));
+        h = DtlsDispatchHash(h, (const byte*)&in->sin_addr,
+            sizeof(in->sin_addr));
+    }
+#ifdef WOLFSSL_IPV6
+    else if (addr->ss_family == WOLFSSL_IP6 &&
+            addrSz >= (XSOCKLENT)sizeof(SOCKADDR_IN6)) {
+        const SOCKADDR_IN6* in6 = (const SOCKADDR_IN6*)addr;
+        h = DtlsDispatchHash(h, (const byte*)&in6->sin6_port,
+            sizeof(in6->sin6_port));
+        h = DtlsDispatchHash(h, (const byte*)&in6->sin6_addr,
+            sizeof(in6->sin6_addr));
+    }
+#endif
+
+    return h & (WOLFSSL_DTLS_DISPATCH_BUCKETS - 1);
+}
+
+/* Find the connection with the peer address. */
+static DtlsDispatchPeer* DtlsDispatchFindAddr(WOLFSSL_DTLS_DISPATCHER* d,
+    SOCKADDR_S* addr, XSOCKLENT addrSz)
+{
+    DtlsDispatchPeer* p = d->addrTbl[DtlsDispatchAddrBucket(d, addr, addrSz)];
+
+    while (p != NULL && !sockAddrEqual(&p->addr, p->addrSz, addr, addrSz))
+        p = p->addrNext;
+    return p;
+}
+
+static void DtlsDispatchLinkAddr(WOLFSSL_DTLS_DISPATCHER* d, DtlsDispatchPeer* p)
+{
+    word32 b = DtlsDispatchAddrBucket(d, &p->addr, p->addrSz);
+
+    p->addrNext = d->addrTbl[b];
+    d->addrTbl[b] = p;
+}
+
+static void DtlsDispatchUnlinkAddr(WOLFSSL_DTLS_DISPATCHER* d,
+    DtlsDispatchPeer* p)
+{
+    DtlsDispatchPeer** pp =
+        &d->addrTbl[DtlsDispatchAddrBucket(d, &p->addr, p->addrSz)];
+
+    while (*pp != NULL && *pp != p)
+        pp = &(*pp)->addrNext;
+    if (*pp != NULL)
+        *pp = p->addrNext;
+    p->addrNext = NULL;
+}
+
+#ifdef WOLFSSL_DTLS_CID
+static word32 DtlsDispatchCidBucket(const WOLFSSL_DTLS_DISPATCHER* d,
+    const byte* cid)
+{
+    return DtlsDispatchHash(d->seed, cid, (word32)d->cidSz) &
+        (WOLFSSL_DTLS_DISPATCH_BUCKETS - 1);
+}
+
+/* Find the connection, or listener, using the CID. */
+static DtlsDispatchPeer* DtlsDispatchFindCid(WOLFSSL_DTLS_DISPATCHER* d,
+    const byte* cid)
+{
+    DtlsDispatchPeer* p = d->cidTbl[DtlsDispatchCidBucket(d, cid)];
+
+    while (p != NULL && XMEMCMP(p->cid, cid, (size_t)d->cidSz) != 0)
+        p = p->cidNext;
+    return p;
+}
+
+static void DtlsDispatchLinkCid(WOLFSSL_DTLS_DISPATCHER* d, DtlsDispatchPeer* p)
+{
+    word32 b = DtlsDispatchCidBucket(d, p->cid);
+
+    p->cidNext = d->cidTbl[b];
+    d->cidTbl[b] = p;
+}
+
+static void DtlsDispatchUnlinkCid(WOLFSSL_DTLS_DISPATCHER* d,
+    DtlsDispatchPeer* p)
+{
+    DtlsDispatchPeer** pp = &d->cidTbl[DtlsDispatchCidBucket(d, p->cid)];
+
+    while (*pp != NULL && *pp != p)
+        pp = &(*pp)->cidNext;
+    if (*pp != NULL)
+        *pp = p->cidNext;
+    p->cidNext = NULL;
+}
+#endif /* WOLFSSL_DTLS_CID */
+
+/* Put a connection into the lookup tables. */
+static void DtlsDispatchLink(WOLFSSL_DTLS_DISPATCHER* d, DtlsDispatchPeer* p)
+{
+    DtlsDispatchLinkAddr(d, p);
+#ifdef WOLFSSL_DTLS_CID
+    if (d->cidSz > 0)
+        DtlsDispatchLinkCid(d, p);
+#endif
+    p->linked = 1;
+}
+
+/* Add a connection to the end of the ready list. */
+static void DtlsDispatchSetReady(WOLFSSL_DTLS_DISPATCHER* d, DtlsDispatchPeer* p)
+{
+    if (!p->ready) {
+        p->ready = 1;
+        p->readyNext = NULL;
+        if (d->readyTail != NULL)
+            d->readyTail->readyNext = p;
+        else
+            d->readyHead = p;
+        d->readyTail = p;
+    }
+}
+
+/* Copy a datagram to the end of the connection's receive queue.
+ *
+ * @return  0 on success.
+ * @return  BUFFER_E when the queue is full and the datagram was dropped.
+ * @return  MEMORY_E on dynamic memory allocation failure.
+ */
+static int DtlsDispatchQueue(DtlsDispatchPeer* p, const byte* data, int sz,
+    const SOCKADDR_S* peer, XSOCKLENT peerSz, byte viaCid)
+{
+    DtlsDispatchDgram* dg;
+
+    if (p->queued >= WOLFSSL_DTLS_DISPATCH_MAX_QUEUED) {
+        WOLFSSL_MSG("DTLS dispatch queue full, dropping datagram");
+        return BUFFER_E;
+    }
+    dg = (DtlsDispatchDgram*)XMALLOC(sizeof(DtlsDispatchDgram) + (size_t)sz,
+        p->d->heap, DYNAMIC_TYPE_DTLS_BUFFER);
+    if (dg == NULL)
+        return MEMORY_E;
+
+    dg->next = NULL;
+    XMEMCPY(&dg->peer, peer, (size_t)peerSz);
+    dg->peerSz = peerSz;
+    dg->sz = sz;
+    dg->viaCid = viaCid;
+    XMEMCPY((byte*)(dg + 1), data, (size_t)sz);
+
+    if (p->tail != NULL)
+        p->tail->next = dg;
+    else
+        p->head = dg;
+    p->tail = dg;
+    p->queued++;
+
+    return 0;
+}
+
+/* Drop all datagrams queued for the connection. */
+static void DtlsDispatchDrop(DtlsDispatchPeer* p)
+{
+    while (p->head != NULL) {
+        DtlsDispatchDgram* dg = p->head;
+        p->head = dg->next;
+        XFREE(dg, p->d->heap, DYNAMIC_TYPE_DTLS_BUFFER);
+    }
+    p->tail = NULL;
+    p->queued = 0;
+}
+
+/* Free a connection or listener, removing it from all lists. */
+static void DtlsDispatchFreePeer(WOLFSSL_DTLS_DISPATCHER* d, DtlsDispatchPeer* p)
+{
+    if (p->linked) {
+        DtlsDispatchUnlinkAddr(d, p);
+    #ifdef WOLFSSL_DTLS_CID
+        if (d->cidSz > 0)
+            DtlsDispatchUnlinkCid(d, p);
+    #endif
+    }
+    if (p->ready) {
+        DtlsDispatchPeer** pp = &d->readyHead;
+        DtlsDispatchPeer*  prev = NULL;
+
+        while (*pp != NULL && *pp != p) {
+            prev = *pp;
+            pp = &(*pp)->readyNext;
+        }
+        if (*pp != NULL) {
+            *pp = p->readyNext;
+            if (d->readyTail == p)
+                d->readyTail = prev;
+        }
+    }
+    if (d->listener == p)
+        d->listener = NULL;
+
+    DtlsDispatchDrop(p);
+    wolfSSL_free(p->ssl);
+    XFREE(p, d->heap, DYNAMIC_TYPE_DTLS_POOL);
+}
+
+#ifdef DTLS_DISPATCH_MMSG
+/* Fill in one message per datagram, or per run of datagrams to the same peer
+ * when they can be sent with GSO, starting at queued datagram idx.
+ *
+ * @return  Number of messages.
+ */
+static int DtlsDispatchTxMsgs(WOLFSSL_DTLS_DISPATCHER* d, int idx)
+{
+    int cnt = 0;
+
+    while (idx < d->txCnt) {
+        DtlsDispatchTx* tx = &d->tx[idx];
+        struct msghdr* msg = &d->txMsg[cnt].msg_hdr;
+        int segs = 1;
+        word32 sz = tx->sz;
+
+    #ifdef DTLS_DISPATCH_GSO
+        /* All but the last segment must be the same size. */
+        while (d->gso && idx + segs < d->txCnt &&
+                segs < DTLS_DISPATCH_GSO_MAX_SEGS &&
+                d->tx[idx + segs - 1].sz == tx->sz &&
+                d->tx[idx + segs].sz <= tx->sz &&
+                sz + d->tx[idx + segs].sz <= DTLS_DISPATCH_GSO_MAX_SZ &&
+                sockAddrEqual(&d->tx[idx + segs].peer,
+                    d->tx[idx + segs].peerSz, &tx->peer, tx->peerSz)) {
+            sz += d->tx[idx + segs].sz;
+            segs++;
+        }
+    #endif
+
+        /* Datagrams are queued back to back so a run is contiguous. */
+        d->txIov[cnt].iov_base = d->txBuf + tx->off;
+        d->txIov[cnt].iov_len = sz;
+        XMEMSET(msg, 0, sizeof(*msg));
+        msg->msg_name = &tx->peer;
+        msg->msg_namelen = tx->peerSz;
+        msg->msg_iov = &d->txIov[cnt];
+        msg->msg_iovlen = 1;
+    #ifdef DTLS_DISPATCH_GSO
+        if (segs > 1) {
+            struct cmsghdr* cmsg;
+            word16 segSz = (word16)tx->sz;
+
+            msg->msg_control = d->txCtrl[cnt].buf;
+            msg->msg_controllen = sizeof(d->txCtrl[cnt].buf);
+            cmsg = CMSG_FIRSTHDR(msg);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(segSz));
+            XMEMCPY(CMSG_DATA(cmsg), &segSz, sizeof(segSz));
+        }
+    #endif
+        d->txMsgCnt[cnt] = segs;
+
+        idx += segs;
+        cnt++;
+    }
+
+    return cnt;
+}
+#endif /* DTLS_DISPATCH_MMSG */
+
+/* Send the queued datagrams.
+ *
+ * A datagram the socket rejects with an error other than would block is
+ * dropped, as a lost datagram would be, and the rest are still sent.
+ *
+ * @return  0 when all queued datagrams were handed to the socket.
+ * @return  WANT_WRITE when the socket would block. Unsent datagrams stay
+ *          queued.
+ * @return  SOCKET_ERROR_E when a datagram was dropped on an error.
+ */
+static int DtlsDispatchSend(WOLFSSL_DTLS_DISPATCHER* d)
+{
+    int ret = 0;
+    int idx = 0;
+    int err;
+
+    while (idx < d->txCnt) {
+    #ifdef DTLS_DISPATCH_MMSG
+        int cnt = DtlsDispatchTxMsgs(d, idx);
+        int sent;
+        int i;
+
+        sent = sendmmsg(d->sfd, d->txMsg, (unsigned int)cnt, MSG_DONTWAIT);
+        if (sent > 0) {
+            for (i = 0; i < sent; i++)
+                idx += d->txMsgCnt[i];
+            continue;
+        }
+        err = errno;
+        #ifdef DTLS_DISPATCH_GSO
+        if (d->gso && d->txMsgCnt[0] > 1 && err != SOCKET_EWOULDBLOCK &&
+                err != SOCKET_EAGAIN && err != SOCKET_EINTR) {
+            /* No GSO for this socket or device. Send datagrams one by one. */
+            WOLFSSL_MSG("DTLS dispatch: UDP GSO not available");
+            d->gso = 0;
+            continue;
+        }
+        #endif
+    #else
+        DtlsDispatchTx* tx = &d->tx[idx];
+
+        if ((int)sendto(d->sfd, (const char*)d->txBuf + tx->off,
+                (size_t)tx->sz, MSG_DONTWAIT, (const SOCKADDR*)&tx->peer,
+                tx->peerSz) >= 0) {
+            idx++;
+            continue;
+        }
+        err = errno;
+    #endif
+        if (err == SOCKET_EINTR)
+            continue;
+        if (err == SOCKET_EWOULDBLOCK || err == SOCKET_EAGAIN) {
+            ret = WANT_WRITE;
+            break;
+        }
+        WOLFSSL_MSG("DTLS dispatch: dropping datagram on send error");
+        ret = SOCKET_ERROR_E;
+    #ifdef DTLS_DISPATCH_MMSG
+        idx += d->txMsgCnt[0];
+    #else
+        idx++;
+    #endif
+    }
+
+    /* Move what is left to the front of the buffer. */
+    if (idx == d->txCnt) {
+        d->txCnt = 0;
+        d->txUsed = 0;
+    }
+    else if (idx > 0) {
+        word32 base = d->tx[idx].off;
+        int i;
+
+        XMEMMOVE(d->txBuf, d->txBuf + base, d->txUsed - base);
+        d->txUsed -= base;
+        for (i = idx; i < d->txCnt; i++) {
+            d->tx[i - idx] = d->tx[i];
+            d->tx[i - idx].off -= base;
+        }
+        d->txCnt -= idx;
+    }
+
+    return ret;
+}
+
+/* Receive callback of connections: next datagram queued for the connection.
+ */
+static int DtlsDispatchIORecv(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    DtlsDispatchPeer* p = (DtlsDispatchPeer*)ctx;
+    DtlsDispatchDgram* dg = p->head;
+    int ret;
+
+    if (dg == NULL)
+        return WOLFSSL_CBIO_ERR_WANT_READ;
+
+    p->head = dg->next;
+    if (p->head == NULL)
+        p->tail = NULL;
+    p->queued--;
+
+#ifdef WOLFSSL_DTLS_CID
+    if (dg->viaCid) {
+        /* Becomes the peer address if the record authenticates. Ignored when
+         * it already is. */
+        (void)wolfSSL_dtls_set_pending_peer(ssl, &dg->peer,
+            (unsigned int)dg->peerSz);
+    }
+#else
+    (void)ssl;
+#endif
+
+    /* Truncate like recvfrom() into a short buffer. */
+    ret = (int)min((word32)dg->sz, (word32)sz);
+    XMEMCPY(buf, (byte*)(dg + 1), (size_t)ret);
+    XFREE(dg, p->d->heap, DYNAMIC_TYPE_DTLS_BUFFER);
+
+    return ret;
+}
+
+/* Send callback of connections: queue the datagram for the peer. */
+static int DtlsDispatchIOSend(WOLFSSL* ssl, char* buf, int sz, void* ctx)
+{
+    DtlsDispatchPeer* p = (DtlsDispatchPeer*)ctx;
+    WOLFSSL_DTLS_DISPATCHER* d = p->d;
+    DtlsDispatchTx* tx;
+    SOCKADDR_S peer;
+    unsigned int peerSz = (unsigned int)sizeof(peer);
+
+    if (sz <= 0 || sz > DTLS_DISPATCH_TX_SZ)
+        return WOLFSSL_CBIO_ERR_GENERAL;
+    if (wolfSSL_dtls_get_peer(ssl, &peer, &peerSz) != WOLFSSL_SUCCESS)
+        return WOLFSSL_CBIO_ERR_GENERAL;
+
+    if (p->linked && !sockAddrEqual(&peer, (XSOCKLENT)peerSz, &p->addr,
+            p->addrSz)) {
+        /* wolfSSL moved the connection to an authenticated new address. */
+        DtlsDispatchUnlinkAddr(d, p);
+        XMEMCPY(&p->addr, &peer, peerSz);
+        p->addrSz = (XSOCKLENT)peerSz;
+        DtlsDispatchLinkAddr(d, p);
+    }
+
+    if (d->txCnt == WOLFSSL_DTLS_DISPATCH_BATCH ||
+            d->txUsed + (word32)sz > DTLS_DISPATCH_TX_SZ) {
+        (void)DtlsDispatchSend(d);
+        if (d->txCnt == WOLFSSL_DTLS_DISPATCH_BATCH ||
+                d->txUsed + (word32)sz > DTLS_DISPATCH_TX_SZ) {
+            return WOLFSSL_CBIO_ERR_WANT_WRITE;
+        }
+    }
+
+    tx = &d->tx[d->txCnt++];
+    XMEMCPY(&tx->peer, &peer, peerSz);
+    tx->peerSz = (XSOCKLENT)peerSz;
+    tx->off = d->txUsed;
+    tx->sz = (word32)sz;
+    XMEMCPY(d->txBuf + d->txUsed, buf, (size_t)sz);
+    d->txUsed += (word32)sz;
+
+    return sz;
+}
+
+/* Create the stateless listener that new peers' datagrams go to. It becomes
+ * the peer's connection once a ClientHello with a valid cookie arrives.
+ *
+ * @return  0 on success.
+ * @return  MEMORY_E on dynamic memory allocation failure.
+ * @return  Other negative value on failure.
+ */
+static int DtlsDispatchNewListener(WOLFSSL_DTLS_DISPATCHER* d)
+{
+    int ret = 0;
+    DtlsDispatchPeer* p;
+
+    p = (DtlsDispatchPeer*)XMALLOC(sizeof(DtlsDispatchPeer), d->heap,
+        DYNAMIC_TYPE_DTLS_POOL);
+    if (p == NULL)
+        return MEMORY_E;
+    XMEMSET(p, 0, sizeof(DtlsDispatchPeer));
+    p->d = d;
+
+    p->ssl = wolfSSL_new(d->ctx);
+    if (p->ssl == NULL)
+        ret = MEMORY_E;
+    if (ret == 0) {
+        wolfSSL_SSLSetIORecv(p->ssl, DtlsDispatchIORecv);
+        wolfSSL_SSLSetIOSend(p->ssl, DtlsDispatchIOSend);
+        wolfSSL_SetIOReadCtx(p->ssl, p);
+        wolfSSL_SetIOWriteCtx(p->ssl, p);
+        wolfSSL_dtls_set_using_nonblock(p->ssl, 1);
+
+        /* Every listener uses the same cookie secret so that a cookie stays
+         * valid after the listener that issued it became a connection. */
+        if (wolfSSL_DTLS_SetCookieSecret(p->ssl, d->secret,
+                DTLS_DISPATCH_SECRET_SZ) != 0) {
+            ret = WOLFSSL_FATAL_ERROR;
+        }
+    }
+#if defined(WOLFSSL_DTLS13) && defined(WOLFSSL_SEND_HRR_COOKIE)
+    if (ret == 0 && IsAtLeastTLSv1_3(p->ssl->version) &&
+            wolfSSL_send_hrr_cookie(p->ssl, d->secret,
+                DTLS_DISPATCH_SECRET_SZ) != WOLFSSL_SUCCESS) {
+        ret = WOLFSSL_FATAL_ERROR;
+    }
+#endif
+#ifdef WOLFSSL_DTLS_CID
+    if (ret == 0 && d->cidSz > 0) {
+        int i;
+
+        for (i = 0; ret == 0 && i < DTLS_DISPATCH_CID_TRIES; i++) {
+            ret = wc_RNG_GenerateBlock(&d->rng, p->cid, (word32)d->cidSz);
+            if (ret == 0 && DtlsDispatchFindCid(d, p->cid) == NULL)
+                break;
+        }
+        if (ret == 0 && i == DTLS_DISPATCH_CID_TRIES)
+            ret = WOLFSSL_FATAL_ERROR;
+        if (ret == 0 && (wolfSSL_dtls_cid_use(p->ssl) != WOLFSSL_SUCCESS ||
+                wolfSSL_dtls_cid_set(p->ssl, p->cid, (unsigned int)d->cidSz)
+                    != WOLFSSL_SUCCESS)) {
+            ret = WOLFSSL_FATAL_ERROR;
+        }
+    }
+#endif
+
+    if (ret == 0)
+        d->listener = p;
+    else
+        DtlsDispatchFreePeer(d, p);
+
+    return ret;
+}
+
+/* Datagram from an unknown peer: give it to the stateless listener.
+ *
+ * The listener answers a ClientHello without a cookie with a cookie request
+ * and keeps no state. A ClientHello with a valid cookie turns the listener
+ * into the peer's connection.
+ */
+static void DtlsDispatchAccept(WOLFSSL_DTLS_DISPATCHER* d, const byte* data,
+    int sz, SOCKADDR_S* peer, XSOCKLENT peerSz)
+{
+    DtlsDispatchPeer* p;
+    int ret;
+
+    if (d->listener == NULL && DtlsDispatchNewListener(d) != 0)
+        return;
+    p = d->listener;
+
+    /* Address the cookie is bound to and replies go to. */
+    if (wolfSSL_dtls_set_peer(p->ssl, peer, (unsigned int)peerSz) !=
+            WOLFSSL_SUCCESS) {
+        return;
+    }
+    if (DtlsDispatchQueue(p, data, sz, peer, peerSz, 0) != 0)
+        return;
+
+    ret = wolfDTLS_accept_stateless(p->ssl);
+    DtlsDispatchDrop(p);
+
+    if (ret == WOLFSSL_SUCCESS) {
+        d->listener = NULL;
+        XMEMCPY(&p->addr, peer, (size_t)peerSz);
+        p->addrSz = peerSz;
+        DtlsDispatchLink(d, p);
+
+        if (d->newPeerCb != NULL && d->newPeerCb(p->ssl, d->newPeerCtx) != 0) {
+            WOLFSSL_MSG("DTLS dispatch: new peer rejected by application");
+            DtlsDispatchFreePeer(d, p);
+        }
+        else {
+            DtlsDispatchSetReady(d, p);
+        }
+    }
+    else if (ret == WC_NO_ERR_TRACE(WOLFSSL_FATAL_ERROR)) {
+        /* Listener can't be reused. A new one is made for the next peer. */
+        DtlsDispatchFreePeer(d, p);
+    }
+}
+
+/* Pass a received datagram to its connection or to the listener. */
+static void DtlsDispatchRoute(WOLFSSL_DTLS_DISPATCHER* d, const byte* data,
+    int sz, SOCKADDR_S* peer, XSOCKLENT peerSz)
+{
+    DtlsDispatchPeer* p = NULL;
+    byte viaCid = 0;
+
+    if (sz <= 0)
+        return;
+
+#ifdef WOLFSSL_DTLS_CID
+    if (d->cidSz > 0) {
+        const byte* cid = wolfSSL_dtls_cid_parse(data, (unsigned int)sz,
+            (unsigned int)d->cidSz);
+        if (cid != NULL) {
+            p = DtlsDispatchFindCid(d, cid);
+            viaCid = (p != NULL);
+        }
+    }
+#endif
+    if (p == NULL)
+        p = DtlsDispatchFindAddr(d, peer, peerSz);
+
+    if (p == NULL)
+        DtlsDispatchAccept(d, data, sz, peer, peerSz);
+    else if (DtlsDispatchQueue(p, data, sz, peer, peerSz, viaCid) == 0)
+        DtlsDispatchSetReady(d, p);
+}
+
+/* Read a batch of datagrams from the socket and route them.
+ *
+ * @return  0 on success, including when nothing was waiting.
+ * @return  SOCKET_ERROR_E when reading from the socket failed.
+ */
+static int DtlsDispatchRecvBatch(WOLFSSL_DTLS_DISPATCHER* d)
+{
+    int i;
+    int n;
+
+#ifdef DTLS_DISPATCH_MMSG
+    for (i = 0; i < WOLFSSL_DTLS_DISPATCH_BATCH; i++) {
+        d->rxMsg[i].msg_hdr.msg_namelen = (socklen_t)sizeof(SOCKADDR_S);
+        d->rxMsg[i].msg_hdr.msg_flags = 0;
+    }
+    do {
+        n = recvmmsg(d->sfd, d->rxMsg, WOLFSSL_DTLS_DISPATCH_BATCH,
+            MSG_DONTWAIT, NULL);
+    } while (n < 0 && errno == SOCKET_EINTR);
+    if (n < 0) {
+        if (errno == SOCKET_EWOULDBLOCK || errno == SOCKET_EAGAIN)
+            return 0;
+        WOLFSSL_MSG("DTLS dispatch: recvmmsg failed");
+        return SOCKET_ERROR_E;
+    }
+
+    for (i = 0; i < n; i++) {
+        if ((d->rxMsg[i].msg_hdr.msg_flags & MSG_TRUNC) != 0) {
+            WOLFSSL_MSG("DTLS dispatch: dropping truncated datagram");
+            continue;
+        }
+        DtlsDispatchRoute(d, d->rxBuf + i * DTLS_DISPATCH_DGRAM_SZ,
+            (int)d->rxMsg[i].msg_len, &d->rxPeer[i],
+            (XSOCKLENT)d->rxMsg[i].msg_hdr.msg_namelen);
+    }
+#else
+    for (i = 0; i < WOLFSSL_DTLS_DISPATCH_BATCH; i++) {
+        XSOCKLENT peerSz = (XSOCKLENT)sizeof(SOCKADDR_S);
+
+        n = (int)recvfrom(d->sfd, (char*)d->rxBuf, DTLS_DISPATCH_DGRAM_SZ,
+            MSG_DONTWAIT, (SOCKADDR*)&d->rxPeer[0], &peerSz);
+        if (n < 0) {
+            if (errno == SOCKET_EINTR)
+                continue;
+            if (errno == SOCKET_EWOULDBLOCK || errno == SOCKET_EAGAIN)
+                break;
+            WOLFSSL_MSG("DTLS dispatch: recvfrom failed");
+            return SOCKET_ERROR_E;
+        }
+        DtlsDispatchRoute(d, d->rxBuf, n, &d->rxPeer[0], peerSz);
+    }
+#endif
+
+    return 0;
+}
+
+/* Create a dispatcher serving DTLS peers on a UDP socket.
+ *
+ * Connections are created with ctx, which must be a DTLS server context and
+ * must outlive the dispatcher. Settings wanted on every connection are made on
+ * ctx, or in the new peer callback once the peer has returned a cookie.
+ *
+ * @param [in] ctx    DTLS server context.
+ * @param [in] sfd    Unconnected UDP socket bound to the server's address.
+ * @param [in] cidSz  Length of the connection IDs to give peers. 0 for none.
+ * @return  Dispatcher on success.
+ * @return  NULL on bad argument or memory allocation failure.
+ */
+WOLFSSL_DTLS_DISPATCHER* wolfDTLS_DispatchNew(WOLFSSL_CTX* ctx, int sfd,
+    int cidSz)
+{
+    WOLFSSL_DTLS_DISPATCHER* d;
+    int ret = 0;
+#ifdef DTLS_DISPATCH_MMSG
+    int i;
+#endif
+
+    WOLFSSL_ENTER("wolfDTLS_DispatchNew");
+
+    if (ctx == NULL || sfd < 0 || cidSz < 0 || cidSz > DTLS_CID_MAX_SIZE ||
+            ctx->method->side != WOLFSSL_SERVER_END ||
+            ctx->method->version.major != DTLS_MAJOR) {
+        return NULL;
+    }
+
+    d = (WOLFSSL_DTLS_DISPATCHER*)XMALLOC(sizeof(WOLFSSL_DTLS_DISPATCHER),
+        ctx->heap, DYNAMIC_TYPE_DTLS_POOL);
+    if (d == NULL)
+        return NULL;
+    XMEMSET(d, 0, sizeof(WOLFSSL_DTLS_DISPATCHER));
+    d->ctx = ctx;
+    d->heap = ctx->heap;
+    d->sfd = sfd;
+    d->cidSz = cidSz;
+#ifdef DTLS_DISPATCH_GSO
+    d->gso = 1;
+#endif
+
+    d->rxBuf = (byte*)XMALLOC((size_t)WOLFSSL_DTLS_DISPATCH_BATCH *
+        DTLS_DISPATCH_DGRAM_SZ, d->heap, DYNAMIC_TYPE_DTLS_BUFFER);
+    d->txBuf = (byte*)XMALLOC(DTLS_DISPATCH_TX_SZ, d->heap,
+        DYNAMIC_TYPE_DTLS_BUFFER);
+    if (d->rxBuf == NULL || d->txBuf == NULL)
+        ret = MEMORY_E;
+
+    if (ret == 0) {
+        ret = wc_InitRng_ex(&d->rng, d->heap, INVALID_DEVID);
+        if (ret == 0)
+            d->rngInit = 1;
+    }
+    if (ret == 0)
+        ret = wc_RNG_GenerateBlock(&d->rng, d->secret, sizeof(d->secret));
+    if (ret == 0) {
+        ret = wc_RNG_GenerateBlock(&d->rng, (byte*)&d->seed,
+            sizeof(d->seed));
+    }
+
+#ifdef DTLS_DISPATCH_MMSG
+    for (i = 0; ret == 0 && i < WOLFSSL_DTLS_DISPATCH_BATCH; i++) {
+        d->rxIov[i].iov_base = d->rxBuf + i * DTLS_DISPATCH_DGRAM_SZ;
+        d->rxIov[i].iov_len = DTLS_DISPATCH_DGRAM_SZ;
+        d->rxMsg[i].msg_hdr.msg_name = &d->rxPeer[i];
+        d->rxMsg[i].msg_hdr.msg_iov = &d->rxIov[i];
+        d->rxMsg[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
+
+    if (ret != 0) {
+        wolfDTLS_DispatchFree(d);
+        d = NULL;
+    }
+
+    WOLFSSL_LEAVE("wolfDTLS_DispatchNew", ret);
+
+    return d;
+}
+
+/* Free a dispatcher and all the connections it owns.
+ *
+ * Datagrams still queued to be sent are discarded. Call
+ * wolfDTLS_DispatchFlush() first to send them. The socket is not closed.
+ *
+ * @param [in] d  Dispatcher. May be NULL.
+ */
+void wolfDTLS_DispatchFree(WOLFSSL_DTLS_DISPATCHER* d)
+{
+    int i;
+
+    if (d == NULL)
+        return;
+
+    for (i = 0; i < WOLFSSL_DTLS_DISPATCH_BUCKETS; i++) {
+        while (d->addrTbl[i] != NULL) {
+            DtlsDispatchPeer* p = d->addrTbl[i];
+
+            d->addrTbl[i] = p->addrNext;
+            p->linked = 0;
+            p->ready = 0;
+            DtlsDispatchDrop(p);
+            wolfSSL_free(p->ssl);
+            XFREE(p, d->heap, DYNAMIC_TYPE_DTLS_POOL);
+        }
+    }
+    if (d->listener != NULL)
+        DtlsDispatchFreePeer(d, d->listener);
+
+    if (d->rngInit)
+        wc_FreeRng(&d->rng);
+    ForceZero(d->secret, sizeof(d->secret));
+    XFREE(d->rxBuf, d->heap, DYNAMIC_TYPE_DTLS_BUFFER);
+    XFREE(d->txBuf, d->heap, DYNAMIC_TYPE_DTLS_BUFFER);
+    XFREE(d, d->heap, DYNAMIC_TYPE_DTLS_POOL);
+}
+
+/* Set the callback told of each new connection.
+ *
+ * The callback is called when a peer has returned a valid cookie and its
+ * connection has been created. Returning non-zero rejects the peer: the
+ * connection is freed.
+ *
+ * @param [in] d    Dispatcher.
+ * @param [in] cb   New peer callback. NULL to accept all peers.
+ * @param [in] arg  Argument passed to the callback.
+ * @return  WOLFSSL_SUCCESS on success.
+ * @return  BAD_FUNC_ARG when d is NULL.
+ */
+int wolfDTLS_DispatchSetNewPeerCb(WOLFSSL_DTLS_DISPATCHER* d,
+    WolfDtlsDispatchNewPeerCb cb, void* arg)
+{
+    if (d == NULL)
+        return BAD_FUNC_ARG;
+
+    d->newPeerCb = cb;
+    d->newPeerCtx = arg;
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Read waiting datagrams from the socket and route them to connections.
+ *
+ * Reads one batch of datagrams without blocking. Cookie requests to new peers
+ * are sent before returning.
+ *
+ * The connections that have datagrams to read are returned. Call
+ * wolfSSL_accept() on those still handshaking, including new ones, and
+ * wolfSSL_read() on the others. Connections that didn't fit in ready are
+ * returned by the next call. Then call wolfDTLS_DispatchFlush() to send what
+ * they wrote.
+ *
+ * @param [in]  d      Dispatcher.
+ * @param [out] ready  Connections with datagrams to read.
+ * @param [in]  max    Number of entries in ready.
+ * @return  Number of connections put in ready.
+ * @return  BAD_FUNC_ARG when d is NULL, ready is NULL or max is negative.
+ * @return  SOCKET_ERROR_E when reading from the socket failed.
+ */
+int wolfDTLS_DispatchRecv(WOLFSSL_DTLS_DISPATCHER* d, WOLFSSL** ready, int max)
+{
+    int ret;
+    int cnt = 0;
+
+    WOLFSSL_ENTER("wolfDTLS_DispatchRecv");
+
+    if (d == NULL || ready == NULL || max < 0)
+        return BAD_FUNC_ARG;
+
+    ret = DtlsDispatchRecvBatch(d);
+    /* Send cookie requests now. The socket keeps any that don't fit. */
+    (void)DtlsDispatchSend(d);
+
+    if (ret == 0) {
+        while (cnt < max && d->readyHead != NULL) {
+            DtlsDispatchPeer* p = d->readyHead;
+
+            d->readyHead = p->readyNext;
+            if (d->readyHead == NULL)
+                d->readyTail = NULL;
+            p->readyNext = NULL;
+            p->ready = 0;
+            ready[cnt++] = p->ssl;
+        }
+        ret = cnt;
+    }
+
+    WOLFSSL_LEAVE("wolfDTLS_DispatchRecv", ret);
+
+    return ret;
+}
+
+/* Send the datagrams written by connections.
+ *
+ * @param [in] d  Dispatcher.
+ * @return  WOLFSSL_SUCCESS when all datagrams were sent.
+ * @return  BAD_FUNC_ARG when d is NULL.
+ * @return  WANT_WRITE when the socket would block. Call again when it is
+ *          writable.
+ * @return  SOCKET_ERROR_E when a datagram was dropped on a socket error.
+ */
+int wolfDTLS_DispatchFlush(WOLFSSL_DTLS_DISPATCHER* d)
+{
+    int ret;
+
+    if (d == NULL)
+        return BAD_FUNC_ARG;
+
+    ret = DtlsDispatchSend(d);
+    if (ret == 0)
+        ret = WOLFSSL_SUCCESS;
+
+    return ret;
+}
+
+/* Remove a connection from the dispatcher and free it.
+ *
+ * Datagrams it has already queued to be sent are still sent.
+ *
+ * @param [in] d    Dispatcher.
+ * @param [in] ssl  Connection returned by wolfDTLS_DispatchRecv().
+ * @return  WOLFSSL_SUCCESS on success.
+ * @return  BAD_FUNC_ARG when d or ssl is NULL, or ssl is not one of the
+ *          dispatcher's connections.
+ */
+int wolfDTLS_DispatchRemove(WOLFSSL_DTLS_DISPATCHER* d, WOLFSSL* ssl)
+{
+    DtlsDispatchPeer* p;
+
+    if (d == NULL || ssl == NULL || ssl->CBIORecv != DtlsDispatchIORecv)
+        return BAD_FUNC_ARG;
+    p = (DtlsDispatchPeer*)ssl->IOCB_ReadCtx;
+    if (p == NULL || p->d != d || p->ssl != ssl || !p->linked)
+        return BAD_FUNC_ARG;
+
+    DtlsDispatchFreePeer(d, p);
+
+    return WOLFSSL_SUCCESS;
+}
+
+#endif /* WOLFSSL_DTLS_DISPATCH */
+#endif /* !WOLFCRYPT_ONLY */
@@ -195,6 +195,10 @@
     #endif
 #endif
 
+#ifdef WOLFSSL_TLS_RNG_BANK
+    #include <wolfssl/wolfcrypt/rng_bank.h>
+#endif
+
 #ifdef __sun
     #include <sys/filio.h>
 #endif
@@ -693,6 +697,12 @@ int IsEncryptionOn(const WOLFSSL* ssl, int isSend)
             return 0;
         }
 #endif /* WOLFSSL_QUIC */
+#ifdef WOLFSSL_KTLS
+    /* The kernel protects records in this direction. */
+    if (WOLFSSL_IS_KTLS(ssl, isSend)) {
+        return 0;
+    }
+#endif /* WOLFSSL_KTLS */
     return ssl->keys.encryptionOn &&
         (isSend ? ssl->encrypt.setup : ssl->decrypt.setup);
 }
@@ -2687,6 +2697,15 @@ int InitSSL_Ctx(WOLFSSL_CTX* ctx, WOLFSSL_METHOD* method, void* heap)
     (void)ret;
 #endif
 
+#ifdef WOLFSSL_IO_BUFFER_POOL
+    if (InitBufferPool(&ctx->bufferPool) != 0) {
+        WOLFSSL_MSG("Mutex error on CTX buffer pool init");
+        ctx->err = CTX_INIT_MUTEX_E;
+        WOLFSSL_ERROR_VERBOSE(BAD_MUTEX_E);
+        return BAD_MUTEX_E;
+    }
+#endif
+
 #ifndef NO_CERTS
     ctx->privateKeyDevId = INVALID_DEVID;
 #ifdef WOLFSSL_DUAL_ALG_CERTS
@@ -3204,9 +3223,25 @@ void SSL_CtxResourceFree(WOLFSSL_CTX* ctx)
     }
     #endif
 #endif
+#if defined(OPENSSL_EXTRA) && !defined(NO_SESSION_CACHE)
+    XFREE(ctx->sessCacheIds, ctx->heap, DYNAMIC_TYPE_SESSION);
+    ctx->sessCacheIds = NULL;
+    #ifndef SINGLE_THREADED
+    if (ctx->sessCacheLockInit) {
+        wc_FreeMutex(&ctx->sessCacheLock);
+        ctx->sessCacheLockInit = 0;
+    }
+    #endif
+#endif
 #if defined(WOLFSSL_TLS13) && defined(HAVE_ECH)
     FreeEchConfigs(ctx->echConfigs, ctx->heap);
     ctx->echConfigs = NULL;
+#endif
+#ifdef WOLFSSL_IO_BUFFER_POOL
+    FreeBufferPool(&ctx->bufferPool, ctx->heap);
+#endif
+#ifdef WOLFSSL_KEY_SHARE_POOL
+    TLSX_KeySharePool_Free(ctx);
 #endif
     (void)heapAtCTXInit;
 }
@@ -7804,6 +7839,7 @@ int SetSSL_CTX(WOLFSSL* ssl, WOLFSSL_CTX* ctx, int writeDup)
     ssl->options.sendVerify     = ctx->sendVerify;
 
     ssl->options.partialWrite  = ctx->partialWrite;
+    ssl->options.releaseBuffers = ctx->releaseBuffers;
     ssl->options.quietShutdown = ctx->quietShutdown;
     ssl->options.groupMessages = ctx->groupMessages;
 
@@ -7900,98 +7936,178 @@ int SetSSL_CTX(WOLFSSL* ssl, WOLFSSL_CTX* ctx, int writeDup)
     return ret;
 }
 
-int InitHandshakeHashes(WOLFSSL* ssl)
+/* Start running the handshake hashes asked for.
+ *
+ * @param [in, out] hsHashes  Handshake hashes.
+ * @param [in]      hashes    HS_HASH_* bits of hashes to start.
+ * @param [in]      heap      Dynamic memory hint.
+ * @param [in]      devId     Device identifier.
+ * @param [out]     started   HS_HASH_* bits of hashes started, even on error.
+ * @return  0 on success.
+ */
+static int HsHashesInit(HS_Hashes* hsHashes, word16 hashes, void* heap,
+    int devId, word16* started)
 {
-    int ret;
-
-    /* make sure existing handshake hashes are free'd */
-    if (ssl->hsHashes != NULL) {
-        FreeHandshakeHashes(ssl);
-    }
+    int ret = 0;
 
-    /* allocate handshake hashes */
-    ssl->hsHashes = (HS_Hashes*)XMALLOC(sizeof(HS_Hashes), ssl->heap,
-                                                           DYNAMIC_TYPE_HASHES);
-    if (ssl->hsHashes == NULL) {
-        WOLFSSL_MSG("HS_Hashes Memory error");
-        return MEMORY_E;
-    }
-    XMEMSET(ssl->hsHashes, 0, sizeof(HS_Hashes));
+    *started = 0;
+    (void)hsHashes;
+    (void)hashes;
+    (void)heap;
+    (void)devId;
 
 #if !defined(NO_MD5) && !defined(NO_OLD_TLS)
-    ret = wc_InitMd5_ex(&ssl->hsHashes->hashMd5, ssl->heap, ssl->devId);
-    if (ret != 0)
-        return ret;
-    #ifdef WOLFSSL_HASH_FLAGS
-        wc_Md5SetFlags(&ssl->hsHashes->hashMd5, WC_HASH_FLAG_WILLCOPY);
-    #endif
+    if ((ret == 0) && ((hashes & HS_HASH_MD5) != 0)) {
+        ret = wc_InitMd5_ex(&hsHashes->hashMd5, heap, devId);
+        if (ret == 0) {
+            *started |= HS_HASH_MD5;
+        #ifdef WOLFSSL_HASH_FLAGS
+            wc_Md5SetFlags(&hsHashes->hashMd5, WC_HASH_FLAG_WILLCOPY);
+        #endif
+        }
+    }
 #endif
 #if !defined(NO_SHA) && (!defined(NO_OLD_TLS) || \
                           defined(WOLFSSL_ALLOW_TLS_SHA1))
-    ret = wc_InitSha_ex(&ssl->hsHashes->hashSha, ssl->heap, ssl->devId);
-    if (ret != 0)
-        return ret;
-    #ifdef WOLFSSL_HASH_FLAGS
-        wc_ShaSetFlags(&ssl->hsHashes->hashSha, WC_HASH_FLAG_WILLCOPY);
-    #endif
+    if ((ret == 0) && ((hashes & HS_HASH_SHA) != 0)) {
+        ret = wc_InitSha_ex(&hsHashes->hashSha, heap, devId);
+        if (ret == 0) {
+            *started |= HS_HASH_SHA;
+        #ifdef WOLFSSL_HASH_FLAGS
+            wc_ShaSetFlags(&hsHashes->hashSha, WC_HASH_FLAG_WILLCOPY);
+        #endif
+        }
+    }
 #endif
 #ifndef NO_SHA256
-    ret = wc_InitSha256_ex(&ssl->hsHashes->hashSha256, ssl->heap, ssl->devId);
-    if (ret != 0)
-        return ret;
-    #ifdef WOLFSSL_HASH_FLAGS
-        wc_Sha256SetFlags(&ssl->hsHashes->hashSha256, WC_HASH_FLAG_WILLCOPY);
-    #endif
+    if ((ret == 0) && ((hashes & HS_HASH_SHA256) != 0)) {
+        ret = wc_InitSha256_ex(&hsHashes->hashSha256, heap, devId);
+        if (ret == 0) {
+            *started |= HS_HASH_SHA256;
+        #ifdef WOLFSSL_HASH_FLAGS
+            wc_Sha256SetFlags(&hsHashes->hashSha256, WC_HASH_FLAG_WILLCOPY);
+        #endif
+        }
+    }
 #endif
 #ifdef WOLFSSL_SHA384
-    ret = wc_InitSha384_ex(&ssl->hsHashes->hashSha384, ssl->heap, ssl->devId);
-    if (ret != 0)
-        return ret;
-    #ifdef WOLFSSL_HASH_FLAGS
-        wc_Sha384SetFlags(&ssl->hsHashes->hashSha384, WC_HASH_FLAG_WILLCOPY);
-    #endif
+    if ((ret == 0) && ((hashes & HS_HASH_SHA384) != 0)) {
+        ret = wc_InitSha384_ex(&hsHashes->hashSha384, heap, devId);
+        if (ret == 0) {
+            *started |= HS_HASH_SHA384;
+        #ifdef WOLFSSL_HASH_FLAGS
+            wc_Sha384SetFlags(&hsHashes->hashSha384, WC_HASH_FLAG_WILLCOPY);
+        #endif
+        }
+    }
 #endif
 #ifdef WOLFSSL_SHA512
-    ret = wc_InitSha512_ex(&ssl->hsHashes->hashSha512, ssl->heap, ssl->devId);
-    if (ret != 0)
-        return ret;
-    #ifdef WOLFSSL_HASH_FLAGS
-        wc_Sha512SetFlags(&ssl->hsHashes->hashSha512, WC_HASH_FLAG_WILLCOPY);
-    #endif
+    if ((ret == 0) && ((hashes & HS_HASH_SHA512) != 0)) {
+        ret = wc_InitSha512_ex(&hsHashes->hashSha512, heap, devId);
+        if (ret == 0) {
+            *started |= HS_HASH_SHA512;
+        #ifdef WOLFSSL_HASH_FLAGS
+            wc_Sha512SetFlags(&hsHashes->hashSha512, WC_HASH_FLAG_WILLCOPY);
+        #endif
+        }
+    }
 #endif
 #ifdef WOLFSSL_SM3
-    ret = wc_InitSm3(&ssl->hsHashes->hashSm3, ssl->heap, ssl->devId);
-    if (ret != 0)
-        return ret;
-    #ifdef WOLFSSL_HASH_FLAGS
-        wc_Sm3SetFlags(&ssl->hsHashes->hashSm3, WC_HASH_FLAG_WILLCOPY);
-    #endif
+    if ((ret == 0) && ((hashes & HS_HASH_SM3) != 0)) {
+        ret = wc_InitSm3(&hsHashes->hashSm3, heap, devId);
+        if (ret == 0) {
+            *started |= HS_HASH_SM3;
+        #ifdef WOLFSSL_HASH_FLAGS
+            wc_Sm3SetFlags(&hsHashes->hashSm3, WC_HASH_FLAG_WILLCOPY);
+        #endif
+        }
+    }
 #endif
 
     return ret;
 }
 
-void Free_HS_Hashes(HS_Hashes* hsHashes, void* heap)
+/* Dispose of the handshake hashes asked for.
+ *
+ * @param [in, out] hsHashes  Handshake hashes.
+ * @param [in]      hashes    HS_HASH_* bits of hashes to free.
+ */
+static void HsHashesFree(HS_Hashes* hsHashes, word16 hashes)
 {
-    if (hsHashes) {
-    #if !defined(NO_MD5) && !defined(NO_OLD_TLS)
+    (void)hsHashes;
+    (void)hashes;
+
+#if !defined(NO_MD5) && !defined(NO_OLD_TLS)
+    if ((hashes & HS_HASH_MD5) != 0)
         wc_Md5Free(&hsHashes->hashMd5);
-    #endif
-    #if !defined(NO_SHA) && (!defined(NO_OLD_TLS) || \
-                              defined(WOLFSSL_ALLOW_TLS_SHA1))
+#endif
+#if !defined(NO_SHA) && (!defined(NO_OLD_TLS) || \
+                          defined(WOLFSSL_ALLOW_TLS_SHA1))
+    if ((hashes & HS_HASH_SHA) != 0)
         wc_ShaFree(&hsHashes->hashSha);
-    #endif
-    #ifndef NO_SHA256
+#endif
+#ifndef NO_SHA256
+    if ((hashes & HS_HASH_SHA256) != 0)
         wc_Sha256Free(&hsHashes->hashSha256);
-    #endif
-    #ifdef WOLFSSL_SHA384
+#endif
+#ifdef WOLFSSL_SHA384
+    if ((hashes & HS_HASH_SHA384) != 0)
         wc_Sha384Free(&hsHashes->hashSha384);
-    #endif
-    #ifdef WOLFSSL_SHA512
+#endif
+#ifdef WOLFSSL_SHA512
+    if ((hashes & HS_HASH_SHA512) != 0)
         wc_Sha512Free(&hsHashes->hashSha512);
-    #endif
-    #ifdef WOLFSSL_SM3
+#endif
+#ifdef WOLFSSL_SM3
+    if ((hashes & HS_HASH_SM3) != 0)
         wc_Sm3Free(&hsHashes->hashSm3);
+#endif
+}
+
+int InitHandshakeHashes(WOLFSSL* ssl)
+{
+    int ret = 0;
+
+    /* make sure existing handshake hashes are free'd */
+    if (ssl->hsHashes != NULL) {
+        FreeHandshakeHashes(ssl);
+    }
+
+    /* allocate handshake hashes */
+    ssl->hsHashes = (HS_Hashes*)XMALLOC(sizeof(HS_Hashes), ssl->heap,
+                                                           DYNAMIC_TYPE_HASHES);
+    if (ssl->hsHashes == NULL) {
+        WOLFSSL_MSG("HS_Hashes Memory error");
+        return MEMORY_E;
+    }
+    XMEMSET(ssl->hsHashes, 0, sizeof(HS_Hashes));
+
+#ifndef WOLFSSL_LAZY_HS_HASHES
+    {
+        word16 started;
+
+        ret = HsHashesInit(ssl->hsHashes, HS_HASH_ALL, ssl->heap, ssl->devId,
+            &started);
+    }
+#endif
+    /* With lazy hashes, messages are kept in the transcript until it is
+     * known which hashes the handshake needs. */
+
+    return ret;
+}
+
+void Free_HS_Hashes(HS_Hashes* hsHashes, void* heap)
+{
+    if (hsHashes) {
+    #ifdef WOLFSSL_LAZY_HS_HASHES
+        HsHashesFree(hsHashes, hsHashes->started);
+        if (hsHashes->transcript != NULL) {
+            ForceZero(hsHashes->transcript, hsHashes->transcriptSz);
+            XFREE(hsHashes->transcript, heap, DYNAMIC_TYPE_HASHES);
+            hsHashes->transcript = NULL;
+        }
+    #else
+        HsHashesFree(hsHashes, HS_HASH_ALL);
     #endif
     #if (defined(HAVE_ED25519) || defined(HAVE_ED448) || \
          (defined(WOLFSSL_SM2) && defined(WOLFSSL_SM3))) && \
@@ -8041,36 +8157,40 @@ int InitHandshakeHashesAndCopy(WOLFSSL* ssl, HS_Hashes* source,
      * scratch buffers are preallocated at init and will leak if overwritten.
      */
     XMEMSET(*destination, 0, sizeof(HS_Hashes));
+#ifdef WOLFSSL_LAZY_HS_HASHES
+    (*destination)->started = source->started;
+    (*destination)->selected = source->selected;
+#endif
 
   /* now copy the source contents to the destination */
     ret = 0;
 #ifndef NO_OLD_TLS
     #ifndef NO_SHA
-    if (ret == 0)
+    if (ret == 0 && HS_HASH_RUNNING(source, HS_HASH_SHA))
         ret = wc_ShaCopy(&source->hashSha, &(*destination)->hashSha);
     #endif
     #ifndef NO_MD5
-    if (ret == 0)
+    if (ret == 0 && HS_HASH_RUNNING(source, HS_HASH_MD5))
         ret = wc_Md5Copy(&source->hashMd5, &(*destination)->hashMd5);
     #endif
 #endif /* !NO_OLD_TLS */
     #ifndef NO_SHA256
-    if (ret == 0)
+    if (ret == 0 && HS_HASH_RUNNING(source, HS_HASH_SHA256))
         ret = wc_Sha256Copy(&source->hashSha256,
             &(*destination)->hashSha256);
     #endif
     #ifdef WOLFSSL_SHA384
-    if (ret == 0)
+    if (ret == 0 && HS_HASH_RUNNING(source, HS_HASH_SHA384))
         ret = wc_Sha384Copy(&source->hashSha384,
             &(*destination)->hashSha384);
     #endif
     #ifdef WOLFSSL_SHA512
-    if (ret == 0)
+    if (ret == 0 && HS_HASH_RUNNING(source, HS_HASH_SHA512))
         ret = wc_Sha512Copy(&source->hashSha512,
             &(*destination)->hashSha512);
     #endif
     #ifdef WOLFSSL_SM3
-    if (ret == 0)
+    if (ret == 0 && HS_HASH_RUNNING(source, HS_HASH_SM3))
         ret = wc_Sm3Copy(&source->hashSm3,
             &(*destination)->hashSm3);
     #endif
@@ -8093,9 +8213,119 @@ int InitHandshakeHashesAndCopy(WOLFSSL* ssl, HS_Hashes* source,
         }
     }
     #endif
+#ifdef WOLFSSL_LAZY_HS_HASHES
+    if (ret == 0 && source->transcript != NULL) {
+        ret = HashTranscriptAdd(*destination, ssl->heap, source->transcript,
+            source->transcriptSz);
+    }
+#endif
+
+    return ret;
+}
+
+#ifdef WOLFSSL_TLS_RNG_BANK
+static struct wc_rng_bank* tlsRngBank = NULL;
+/* Bank slot handed to the next thread that checks out a DRBG. */
+static wolfSSL_Atomic_Uint tlsRngBankNextSlot;
+/* Connections given a reference to the bank, for the reseed interval. */
+static wolfSSL_Atomic_Uint tlsRngBankConns;
+static THREAD_LS_T int tlsRngBankSlot = -1;
+
+/* Affinity callback: each thread sticks to the bank slot it was first given,
+ * so the checkout compare-and-swap on the handshake path normally succeeds on
+ * the first try. Without thread local storage all threads start at the same
+ * slot and rely on fail over. */
+static int TlsRngBankGetId(void* arg, int* id)
+{
+    struct wc_rng_bank* bank = (struct wc_rng_bank*)arg;
+
+    if (tlsRngBankSlot < 0) {
+        tlsRngBankSlot = (int)(wolfSSL_Atomic_Uint_FetchAdd(
+            &tlsRngBankNextSlot, 1) & 0x7fffffff);
+    }
+    *id = tlsRngBankSlot % bank->n_rngs;
+
+    return 0;
+}
+
+/* Seed the bank of DRBGs shared by all connections. Called by wolfSSL_Init().
+ * Failure is not fatal: connections fall back to their own WC_RNG. */
+int InitTlsRngBank(void)
+{
+    int ret;
+
+    if (tlsRngBank != NULL)
+        return 0;
+
+    ret = wc_rng_bank_new(&tlsRngBank, WOLFSSL_TLS_RNG_BANK_SZ,
+        WC_RNG_BANK_FLAG_NONE, 0, NULL, INVALID_DEVID);
+    if (ret == 0) {
+        ret = wc_rng_bank_set_affinity_handlers(tlsRngBank, NULL,
+            TlsRngBankGetId, NULL, tlsRngBank);
+        if (ret != 0)
+            (void)wc_rng_bank_free(&tlsRngBank);
+    }
+    if (ret != 0) {
+        WOLFSSL_MSG_EX("TLS RNG bank init failed %d, using per connection "
+                       "RNGs", ret);
+        tlsRngBank = NULL;
+    }
+    wolfSSL_Atomic_Uint_Init(&tlsRngBankConns, 0);
+
+    return ret;
+}
+
+/* Called by wolfSSL_Cleanup(). A bank still referenced by a WOLFSSL is left
+ * allocated rather than freed under it. */
+int FreeTlsRngBank(void)
+{
+    int ret;
+
+    if (tlsRngBank == NULL)
+        return 0;
+
+    ret = wc_rng_bank_free(&tlsRngBank);
+    if (ret != 0)
+        WOLFSSL_MSG("TLS RNG bank still in use, not freed");
+    tlsRngBank = NULL;
+
+    return ret;
+}
+
+/* Make rng a reference to the shared bank. Each generate call checks out an
+ * instance with a compare-and-swap; no entropy is read and no DRBG is
+ * instantiated per connection. The instances reseed themselves when their
+ * reseed counter runs out and, through the getpid() check in the DRBG, in a
+ * forked child. Every WOLFSSL_TLS_RNG_BANK_RESEED_CONNS connections all
+ * instances are additionally marked to reseed on their next use. Returns
+ * non-zero when the bank can not be used. */
+static int TlsRngBankRef(WOLFSSL* ssl, WOLFSSL_CTX* ctx, WC_RNG* rng)
+{
+    int ret;
+
+    if (tlsRngBank == NULL || ctx->noRngBank)
+        return BAD_STATE_E;
+#if defined(WOLFSSL_ASYNC_CRYPT) || defined(WOLF_CRYPTO_CB)
+    /* random data for a device comes from its own RNG */
+    if (ssl->devId != INVALID_DEVID)
+        return BAD_STATE_E;
+#endif
+
+    ret = wc_InitRng_BankRef(tlsRngBank, rng);
+#if WOLFSSL_TLS_RNG_BANK_RESEED_CONNS > 0
+    if (ret == 0 && (wolfSSL_Atomic_Uint_FetchAdd(&tlsRngBankConns, 1) %
+            WOLFSSL_TLS_RNG_BANK_RESEED_CONNS) ==
+            WOLFSSL_TLS_RNG_BANK_RESEED_CONNS - 1) {
+        /* Only marks the instances, the reseed happens on their next
+         * generate. An instance checked out right now is skipped. */
+        if (wc_rng_bank_reseed(tlsRngBank, 0, WC_RNG_BANK_FLAG_NONE) != 0)
+            WOLFSSL_MSG("TLS RNG bank reseed skipped a busy instance");
+    }
+#endif
 
     return ret;
 }
+#endif /* WOLFSSL_TLS_RNG_BANK */
 
 /* called if user attempts to reuse WOLFSSL object for a new session.
  * For example wolfSSL_clear() is called then wolfSSL_connect or accept */
@@ -8147,6 +8377,12 @@ int ReinitSSL(WOLFSSL* ssl, WOLFSSL_CTX* ctx, int writeDup)
         XMEMSET(ssl->rng, 0, sizeof(WC_RNG));
         ssl->options.weOwnRng = 1;
 
+#ifdef WOLFSSL_TLS_RNG_BANK
+        if (TlsRngBankRef(ssl, ctx, ssl->rng) == 0) {
+            /* draws from the shared bank, nothing to seed */
+        }
+        else
+#endif
         /* FIPS RNG API does not accept a heap hint */
 #ifndef HAVE_FIPS
         if ( (ret = wc_InitRng_ex(ssl->rng, ssl->heap, ssl->devId)) != 0) {
@@ -9896,6 +10132,9 @@ void wolfSSL_ResourceFree(WOLFSSL* ssl)
 #ifdef WOLFSSL_QUIC
     wolfSSL_quic_free(ssl);
 #endif
+#ifdef WOLFSSL_KTLS
+    wolfSSL_ktls_free(ssl);
+#endif
 #if defined(WOLFSSL_HAPROXY)
     wolfSSL_CTX_free(ssl->initial_ctx);
     ssl->initial_ctx = NULL;
@@ -11511,6 +11750,323 @@ static int EdDSA_Update(WOLFSSL* ssl, const byte* data, int sz)
 }
 #endif /* (HAVE_ED25519 || HAVE_ED448) && !WOLFSSL_NO_CLIENT_AUTH */
 
+#ifdef WOLFSSL_LAZY_HS_HASHES
+/* Initial size of the buffer of messages kept before hashes are chosen. Holds
+ * a typical ClientHello and ServerHello. */
+#ifndef HS_TRANSCRIPT_INIT_SZ
+    #define HS_TRANSCRIPT_INIT_SZ   1024
+#endif
+
+/* Append data to the transcript kept until the handshake hashes are chosen.
+ *
+ * @param [in, out] hsHashes  Handshake hashes.
+ * @param [in]      heap      Dynamic memory hint.
+ * @param [in]      data      Handshake message data.
+ * @param [in]      sz        Length of data in bytes.
+ * @return  0 on success.
+ * @return  MEMORY_E when dynamic memory allocation fails.
+ * @return  BUFFER_E when the transcript would be too long.
+ */
+int HashTranscriptAdd(HS_Hashes* hsHashes, void* heap, const byte* data,
+    word32 sz)
+{
+    if (sz > WOLFSSL_MAX_32BIT - hsHashes->transcriptSz)
+        return BUFFER_E;
+
+    if (hsHashes->transcriptSz + sz > hsHashes->transcriptMax) {
+        word32 max = hsHashes->transcriptMax;
+        byte*  transcript;
+
+        if (max == 0)
+            max = HS_TRANSCRIPT_INIT_SZ;
+        while ((max < hsHashes->transcriptSz + sz) &&
+               (max <= WOLFSSL_MAX_32BIT / 2)) {
+            max *= 2;
+        }
+        if (max < hsHashes->transcriptSz + sz)
+            max = hsHashes->transcriptSz + sz;
+
+        /* Allocate new rather than realloc so old data can be zeroized. */
+        transcript = (byte*)XMALLOC(max, heap, DYNAMIC_TYPE_HASHES);
+        if (transcript == NULL)
+            return MEMORY_E;
+        if (hsHashes->transcript != NULL) {
+            XMEMCPY(transcript, hsHashes->transcript, hsHashes->transcriptSz);
+            ForceZero(hsHashes->transcript, hsHashes->transcriptSz);
+            XFREE(hsHashes->transcript, heap, DYNAMIC_TYPE_HASHES);
+        }
+        hsHashes->transcript = transcript;
+        hsHashes->transcriptMax = max;
+    }
+
+    XMEMCPY(hsHashes->transcript + hsHashes->transcriptSz, data, sz);
+    hsHashes->transcriptSz += sz;
+
+    return 0;
+}
+
+/* Update the handshake hashes asked for with data.
+ *
+ * @param [in, out] hsHashes  Handshake hashes.
+ * @param [in]      hashes    HS_HASH_* bits of hashes to update.
+ * @param [in]      data      Handshake message data.
+ * @param [in]      sz        Length of data in bytes.
+ * @return  0 on success.
+ */
+static int HsHashesUpdate(HS_Hashes* hsHashes, word16 hashes,
+    const byte* data, word32 sz)
+{
+    int ret = 0;
+
+    (void)hsHashes;
+    (void)hashes;
+    (void)data;
+    (void)sz;
+
+#if !defined(NO_MD5) && !defined(NO_OLD_TLS)
+    if ((ret == 0) && ((hashes & HS_HASH_MD5) != 0))
+        ret = wc_Md5Update(&hsHashes->hashMd5, data, sz);
+#endif
+#if !defined(NO_SHA) && (!defined(NO_OLD_TLS) || \
+                          defined(WOLFSSL_ALLOW_TLS_SHA1))
+    if ((ret == 0) && ((hashes & HS_HASH_SHA) != 0))
+        ret = wc_ShaUpdate(&hsHashes->hashSha, data, sz);
+#endif
+#ifndef NO_SHA256
+    if ((ret == 0) && ((hashes & HS_HASH_SHA256) != 0))
+        ret = wc_Sha256Update(&hsHashes->hashSha256, data, sz);
+#endif
+#ifdef WOLFSSL_SHA384
+    if ((ret == 0) && ((hashes & HS_HASH_SHA384) != 0))
+        ret = wc_Sha384Update(&hsHashes->hashSha384, data, sz);
+#endif
+#ifdef WOLFSSL_SHA512
+    if ((ret == 0) && ((hashes & HS_HASH_SHA512) != 0))
+        ret = wc_Sha512Update(&hsHashes->hashSha512, data, sz);
+#endif
+#ifdef WOLFSSL_SM3
+    if ((ret == 0) && ((hashes & HS_HASH_SM3) != 0))
+        ret = wc_Sm3Update(&hsHashes->hashSm3, data, sz);
+#endif
+
+    return ret;
+}
+
+/* Get the handshake hashes compiled in.
+ *
+ * @return  HS_HASH_* bits of hashes.
+ */
+static word16 HsHashesAvailable(void)
+{
+    word16 hashes = 0;
+
+#if !defined(NO_MD5) && !defined(NO_OLD_TLS)
+    hashes |= HS_HASH_MD5;
+#endif
+#if !defined(NO_SHA) && (!defined(NO_OLD_TLS) || \
+                          defined(WOLFSSL_ALLOW_TLS_SHA1))
+    hashes |= HS_HASH_SHA;
+#endif
+#ifndef NO_SHA256
+    hashes |= HS_HASH_SHA256;
+#endif
+#ifdef WOLFSSL_SHA384
+    hashes |= HS_HASH_SHA384;
+#endif
+#ifdef WOLFSSL_SHA512
+    hashes |= HS_HASH_SHA512;
+#endif
+#ifdef WOLFSSL_SM3
+    hashes |= HS_HASH_SM3;
+#endif
+
+    return hashes;
+}
+
+/* Get the handshake hash used with the MAC algorithm of a cipher suite.
+ *
+ * @param [in] macAlgo  MAC algorithm of cipher suite.
+ * @return  HS_HASH_* bit of hash.
+ */
+word16 HandshakeHashForMac(byte macAlgo)
+{
+    switch (macAlgo) {
+        case sha384_mac:
+            return HS_HASH_SHA384;
+        case sha512_mac:
+            return HS_HASH_SHA512;
+        case sm3_mac:
+            return HS_HASH_SM3;
+        default:
+            /* PRF of TLS v1.2 uses SHA-256 for weaker MACs. */
+            return HS_HASH_SHA256;
+    }
+}
+
+/* Get the handshake hash of the hash algorithm of a signature algorithm.
+ *
+ * @param [in] hashAlgo  Hash algorithm as a MAC algorithm value.
+ * @return  HS_HASH_* bit of hash or 0 when not a handshake hash.
+ */
+WC_MAYBE_UNUSED static word16 HandshakeHashForSigHash(byte hashAlgo)
+{
+    switch (hashAlgo) {
+        case sha_mac:
+            return HS_HASH_SHA;
+        case sha256_mac:
+            return HS_HASH_SHA256;
+        case sha384_mac:
+            return HS_HASH_SHA384;
+        case sha512_mac:
+            return HS_HASH_SHA512;
+        case sm3_mac:
+            return HS_HASH_SM3;
+        default:
+            return 0;
+    }
+}
+
+#if !defined(WOLFSSL_NO_TLS12) && !defined(NO_CERTS) && \
+    !defined(WOLFSSL_NO_CLIENT_AUTH) && !defined(NO_WOLFSSL_SERVER)
+static void GetServerCertReqHashSigAlgo(const WOLFSSL* ssl,
+        byte* hashSigAlgo, word16* hashSigAlgoSz);
+
+/* Get the handshake hashes a client may sign its CertificateVerify with.
+ *
+ * Only the signature algorithms sent in the CertificateRequest are accepted.
+ * EdDSA signs the messages rather than a hash of them.
+ *
+ * @param [in] ssl  SSL/TLS object.
+ * @return  HS_HASH_* bits of hashes.
+ */
+static word16 HandshakeHashesForCertReq(const WOLFSSL* ssl)
+{
+    byte   hashSigAlgo[WOLFSSL_MAX_SIGALGO];
+    word16 hashSigAlgoSz = 0;
+    word16 hashes = 0;
+    word16 i;
+
+    GetServerCertReqHashSigAlgo(ssl, hashSigAlgo, &hashSigAlgoSz);
+    for (i = 0; (i + 1) < hashSigAlgoSz; i += HELLO_EXT_SIGALGO_SZ) {
+        byte hashAlgo = 0;
+        byte sigAlgo = 0;
+
+        DecodeSigAlg(&hashSigAlgo[i], &hashAlgo, &sigAlgo);
+        if ((sigAlgo != ed25519_sa_algo) && (sigAlgo != ed448_sa_algo))
+            hashes |= HandshakeHashForSigHash(hashAlgo);
+    }
+
+    return hashes;
+}
+#endif
+
+/* Make sure the handshake hashes asked for are running.
+ *
+ * Hashes not yet started are started and caught up from the transcript. Once
+ * the hashes have been chosen the transcript is gone and no more can start.
+ *
+ * @param [in] ssl     SSL/TLS object.
+ * @param [in] hashes  HS_HASH_* bits of hashes needed.
+ * @return  0 on success.
+ * @return  BAD_FUNC_ARG when ssl or the handshake hashes are NULL.
+ * @return  BAD_STATE_E when a hash is needed that wasn't chosen.
+ */
+int StartHandshakeHashes(const WOLFSSL* ssl, word16 hashes)
+{
+    int        ret;
+    HS_Hashes* hsHashes;
+    word16     start;
+    word16     started = 0;
+
+    if ((ssl == NULL) || (ssl->hsHashes == NULL))
+        return BAD_FUNC_ARG;
+    hsHashes = ssl->hsHashes;
+
+    start = (word16)(hashes & HsHashesAvailable() & ~hsHashes->started);
+    if (start == 0)
+        return 0;
+    if (hsHashes->selected) {
+        WOLFSSL_MSG("Handshake hash needed that wasn't chosen");
+        return BAD_STATE_E;
+    }
+
+    ret = HsHashesInit(hsHashes, start, ssl->heap, ssl->devId, &started);
+    hsHashes->started |= started;
+    if ((ret == 0) && (hsHashes->transcriptSz > 0)) {
+        ret = HsHashesUpdate(hsHashes, started, hsHashes->transcript,
+            hsHashes->transcriptSz);
+    }
+
+    return ret;
+}
+
+/* Choose the handshake hashes now that the protocol version and cipher suite
+ * are known.
+ *
+ * TLS v1.3 only ever uses the hash of the cipher suite. TLS v1.2 uses it for
+ * the PRF and, with client authentication, the hash of the CertificateVerify
+ * signature algorithm: any sent in the server's CertificateRequest, or the
+ * one the client picked. A client only knows that once ServerHelloDone is
+ * processed, so until then it runs the PRF hash and keeps the transcript.
+ * Earlier versions use MD5 and SHA-1.
+ * The transcript is no longer needed and is disposed of.
+ *
+ * @param [in] ssl  SSL/TLS object.
+ * @return  0 on success.
+ */
+int SelectHandshakeHashes(WOLFSSL* ssl)
+{
+    int        ret;
+    HS_Hashes* hsHashes = ssl->hsHashes;
+    word16     keep;
+
+    if ((hsHashes == NULL) || hsHashes->selected)
+        return 0;
+
+    if (IsAtLeastTLSv1_3(ssl->version)) {
+        keep = HandshakeHashForMac(ssl->specs.mac_algorithm);
+    }
+    else if (!IsAtLeastTLSv1_2(ssl)) {
+        keep = HS_HASH_MD5 | HS_HASH_SHA;
+    }
+    else {
+        keep = HandshakeHashForMac(ssl->specs.mac_algorithm);
+    #if !defined(NO_CERTS) && !defined(WOLFSSL_NO_CLIENT_AUTH)
+        if (ssl->options.side == WOLFSSL_SERVER_END) {
+        #ifndef NO_WOLFSSL_SERVER
+            if (!ssl->options.resuming && ssl->options.verifyPeer)
+                keep |= HandshakeHashesForCertReq(ssl);
+        #endif
+        }
+        else if (ssl->options.serverState < SERVER_HELLODONE_COMPLETE) {
+            return StartHandshakeHashes(ssl, keep);
+        }
+        else if (ssl->options.sendVerify == SEND_CERT) {
+            keep |= HandshakeHashForSigHash(ssl->options.hashAlgo);
+        }
+    #endif
+    }
+
+    ret = StartHandshakeHashes(ssl, keep);
+    if (ret == 0) {
+        /* Hashes started for a PSK binder with a different hash. */
+        HsHashesFree(hsHashes, (word16)(hsHashes->started & ~keep));
+        hsHashes->started &= keep;
+
+        if (hsHashes->transcript != NULL) {
+            ForceZero(hsHashes->transcript, hsHashes->transcriptSz);
+            XFREE(hsHashes->transcript, ssl->heap, DYNAMIC_TYPE_HASHES);
+            hsHashes->transcript = NULL;
+        }
+        hsHashes->transcriptSz = 0;
+        hsHashes->transcriptMax = 0;
+        hsHashes->selected = 1;
+    }
+
+    return ret;
+}
+#endif /* WOLFSSL_LAZY_HS_HASHES */
+
 int HashRaw(WOLFSSL* ssl, const byte* data, int sz)
 {
     int ret = 0;
@@ -11537,54 +12093,76 @@ int HashRaw(WOLFSSL* ssl, const byte* data, int sz)
     }
 #endif /* WOLFSSL_RENESAS_TSIP_TLS */
 
+#ifdef WOLFSSL_LAZY_HS_HASHES
+    /* Keep messages for hashes that may yet be started. */
+    if (!ssl->hsHashes->selected) {
+        ret = HashTranscriptAdd(ssl->hsHashes, ssl->heap, data, (word32)sz);
+        if (ret != 0)
+            return ret;
+    }
+#endif
+
 #if !defined(NO_SHA) && (!defined(NO_OLD_TLS) || \
                           defined(WOLFSSL_ALLOW_TLS_SHA1))
-    wc_ShaUpdate(&ssl->hsHashes->hashSha, data, (word32)(sz));
+    if (HS_HASH_RUNNING(ssl->hsHashes, HS_HASH_SHA))
+        wc_ShaUpdate(&ssl->hsHashes->hashSha, data, (word32)(sz));
 #endif
 #if !defined(NO_MD5) && !defined(NO_OLD_TLS)
-    wc_Md5Update(&ssl->hsHashes->hashMd5, data, (word32)(sz));
+    if (HS_HASH_RUNNING(ssl->hsHashes, HS_HASH_MD5))
+        wc_Md5Update(&ssl->hsHashes->hashMd5, data, (word32)(sz));
 #endif
 
     if (IsAtLeastTLSv1_2(ssl)) {
     #ifndef NO_SHA256
-        ret = wc_Sha256Update(&ssl->hsHashes->hashSha256, data, (word32)sz);
-        if (ret != 0)
-            return ret;
-    #ifdef WOLFSSL_DEBUG_TLS
-        WOLFSSL_MSG("Sha256");
-        wc_Sha256GetHash(&ssl->hsHashes->hashSha256, digest);
-        WOLFSSL_BUFFER(digest, WC_SHA256_DIGEST_SIZE);
-    #endif
+        if (HS_HASH_RUNNING(ssl->hsHashes, HS_HASH_SHA256)) {
+            ret = wc_Sha256Update(&ssl->hsHashes->hashSha256, data,
+                (word32)sz);
+            if (ret != 0)
+                return ret;
+        #ifdef WOLFSSL_DEBUG_TLS
+            WOLFSSL_MSG("Sha256");
+            wc_Sha256GetHash(&ssl->hsHashes->hashSha256, digest);
+            WOLFSSL_BUFFER(digest, WC_SHA256_DIGEST_SIZE);
+        #endif
+        }
     #endif
     #ifdef WOLFSSL_SHA384
-        ret = wc_Sha384Update(&ssl->hsHashes->hashSha384, data, (word32)sz);
-        if (ret != 0)
-            return ret;
-    #ifdef WOLFSSL_DEBUG_TLS
-        WOLFSSL_MSG("Sha384");
-        wc_Sha384GetHash(&ssl->hsHashes->hashSha384, digest);
-        WOLFSSL_BUFFER(digest, WC_SHA384_DIGEST_SIZE);
-    #endif
+        if (HS_HASH_RUNNING(ssl->hsHashes, HS_HASH_SHA384)) {
+            ret = wc_Sha384Update(&ssl->hsHashes->hashSha384, data,
+                (word32)sz);
+            if (ret != 0)
+                return ret;
+        #ifdef WOLFSSL_DEBUG_TLS
+            WOLFSSL_MSG("Sha384");
+            wc_Sha384GetHash(&ssl->hsHashes->hashSha384, digest);
+            WOLFSSL_BUFFER(digest, WC_SHA384_DIGEST_SIZE);
+        #endif
+        }
     #endif
     #ifdef WOLFSSL_SHA512
-        ret = wc_Sha512Update(&ssl->hsHashes->hashSha512, data, (word32)sz);
-        if (ret != 0)
-            return ret;
-    #ifdef WOLFSSL_DEBUG_TLS
-        WOLFSSL_MSG("Sha512");
-        wc_Sha512GetHash(&ssl->hsHashes->hashSha512, digest);
-        WOLFSSL_BUFFER(digest, WC_SHA512_DIGEST_SIZE);
-    #endif
+        if (HS_HASH_RUNNING(ssl->hsHashes, HS_HASH_SHA512)) {
+            ret = wc_Sha512Update(&ssl->hsHashes->hashSha512, data,
+                (word32)sz);
+            if (ret != 0)
+                return ret;
+        #ifdef WOLFSSL_DEBUG_TLS
+            WOLFSSL_MSG("Sha512");
+            wc_Sha512GetHash(&ssl->hsHashes->hashSha512, digest);
+            WOLFSSL_BUFFER(digest, WC_SHA512_DIGEST_SIZE);
+        #endif
+        }
     #endif
     #ifdef WOLFSSL_SM3
-        ret = wc_Sm3Update(&ssl->hsHashes->hashSm3, data, sz);
-        if (ret != 0)
-            return ret;
-    #ifdef WOLFSSL_DEBUG_TLS
-        WOLFSSL_MSG("SM3");
-        wc_Sm3GetHash(&ssl->hsHashes->hashSm3, digest);
-        WOLFSSL_BUFFER(digest, WC_SM3_DIGEST_SIZE);
-    #endif
+        if (HS_HASH_RUNNING(ssl->hsHashes, HS_HASH_SM3)) {
+            ret = wc_Sm3Update(&ssl->hsHashes->hashSm3, data, sz);
+            if (ret != 0)
+                return ret;
+        #ifdef WOLFSSL_DEBUG_TLS
+            WOLFSSL_MSG("SM3");
+            wc_Sm3GetHash(&ssl->hsHashes->hashSm3, digest);
+            WOLFSSL_BUFFER(digest, WC_SM3_DIGEST_SIZE);
+        #endif
+        }
     #endif
     #if !defined(WOLFSSL_NO_CLIENT_AUTH) && \
                ((defined(WOLFSSL_SM2) && defined(WOLFSSL_SM3)) || \
@@ -12006,6 +12584,13 @@ static int wolfSSLReceive(WOLFSSL* ssl, byte* buf, word32 sz)
         return wolfSSL_quic_receive(ssl, buf, sz);
     }
 #endif
+#ifdef WOLFSSL_KTLS
+    if (WOLFSSL_IS_KTLS(ssl, 0)) {
+        /* Records are decrypted by the kernel and handed over with a
+         * plaintext record header. */
+        return wolfSSL_ktls_receive(ssl, buf, sz);
+    }
+#endif
 
     if (ssl->CBIORecv == NULL) {
         WOLFSSL_MSG("Your IO Recv callback is null, please set");
@@ -12106,6 +12691,141 @@ retry:
 }
 
 
+#ifdef WOLFSSL_IO_BUFFER_POOL
+static const word32 bufferPoolClassSz[WOLFSSL_BUFFER_POOL_CLASSES] = {
+    512, 2048, 8192, WOLFSSL_BUFFER_POOL_MAX_SZ
+};
+
+int InitBufferPool(BufferPool* pool)
+{
+    XMEMSET(pool, 0, sizeof(BufferPool));
+#ifndef SINGLE_THREADED
+    if (wc_InitMutex(&pool->lock) != 0)
+        return BAD_MUTEX_E;
+#endif
+    pool->init = 1;
+    return 0;
+}
+
+/* Release every pooled buffer. Only called once no WOLFSSL uses the CTX. */
+void FreeBufferPool(BufferPool* pool, void* heap)
+{
+    int i;
+
+    if (!pool->init)
+        return;
+
+    for (i = 0; i < WOLFSSL_BUFFER_POOL_CLASSES; i++) {
+        while (pool->head[i] != NULL) {
+            byte* buf = pool->head[i];
+            XMEMCPY(&pool->head[i], buf, sizeof(byte*));
+            XFREE(buf, heap, DYNAMIC_TYPE_IN_BUFFER);
+        }
+        pool->count[i] = 0;
+    }
+#ifndef SINGLE_THREADED
+    wc_FreeMutex(&pool->lock);
+#endif
+    pool->init = 0;
+    (void)heap;
+}
+
+/* Take a buffer of at least sz bytes from the CTX pool, allocating one of the
+ * class size when the class is empty. Returns NULL when sz is above the
+ * largest class or on allocation failure; *poolClass is the class + 1. */
+static byte* BufferPoolGet(WOLFSSL_CTX* ctx, word32 sz, byte* poolClass)
+{
+    BufferPool* pool = &ctx->bufferPool;
+    byte* buf = NULL;
+    int i;
+
+    for (i = 0; i < WOLFSSL_BUFFER_POOL_CLASSES; i++) {
+        if (sz <= bufferPoolClassSz[i])
+            break;
+    }
+    if (i == WOLFSSL_BUFFER_POOL_CLASSES || !pool->init)
+        return NULL;
+
+#ifndef SINGLE_THREADED
+    if (wc_LockMutex(&pool->lock) != 0)
+        return NULL;
+#endif
+    if (pool->head[i] != NULL) {
+        buf = pool->head[i];
+        XMEMCPY(&pool->head[i], buf, sizeof(byte*));
+        pool->count[i]--;
+    }
+#ifndef SINGLE_THREADED
+    wc_UnLockMutex(&pool->lock);
+#endif
+
+    if (buf == NULL) {
+        buf = (byte*)XMALLOC(bufferPoolClassSz[i], ctx->heap,
+            DYNAMIC_TYPE_IN_BUFFER);
+        if (buf == NULL)
+            return NULL;
+    }
+    *poolClass = (byte)(i + 1);
+    return buf;
+}
+
+/* Return a buffer taken with BufferPoolGet(), freeing it when the class
+ * already holds WOLFSSL_BUFFER_POOL_DEPTH buffers. */
+static void BufferPoolPut(WOLFSSL_CTX* ctx, byte* buf, byte poolClass)
+{
+    BufferPool* pool = &ctx->bufferPool;
+    int i = poolClass - 1;
+
+#ifndef SINGLE_THREADED
+    if (wc_LockMutex(&pool->lock) == 0)
+#endif
+    {
+        if (pool->count[i] < WOLFSSL_BUFFER_POOL_DEPTH) {
+            XMEMCPY(buf, &pool->head[i], sizeof(byte*));
+            pool->head[i] = buf;
+            pool->count[i]++;
+            buf = NULL;
+        }
+    #ifndef SINGLE_THREADED
+        wc_UnLockMutex(&pool->lock);
+    #endif
+    }
+
+    XFREE(buf, ctx->heap, DYNAMIC_TYPE_IN_BUFFER);
+}
+#endif /* WOLFSSL_IO_BUFFER_POOL */
+
+/* Allocate memory for a dynamic input or output buffer. With
+ * SSL_MODE_RELEASE_BUFFERS set it comes from the CTX buffer pool. */
+static byte* AllocIOBuffer(WOLFSSL* ssl, word32 sz, byte* poolClass, int type)
+{
+    *poolClass = 0;
+#ifdef WOLFSSL_IO_BUFFER_POOL
+    if (ssl->options.releaseBuffers && ssl->ctx != NULL) {
+        byte* buf = BufferPoolGet(ssl->ctx, sz, poolClass);
+        if (buf != NULL)
+            return buf;
+    }
+#endif
+    return (byte*)XMALLOC(sz, ssl->heap, type);
+}
+
+/* Free the dynamic memory of an input or output buffer. */
+static void FreeIOBuffer(WOLFSSL* ssl, bufferStatic* buf, int type)
+{
+#ifdef WOLFSSL_IO_BUFFER_POOL
+    if (buf->poolClass != 0 && ssl->ctx != NULL) {
+        /* The buffer is handed to another connection next. */
+        ForceZero(buf->buffer, buf->bufferSize);
+        BufferPoolPut(ssl->ctx, buf->buffer - buf->offset, buf->poolClass);
+        buf->poolClass = 0;
+        return;
+    }
+#endif
+    XFREE(buf->buffer - buf->offset, ssl->heap, type);
+    (void)type;
+}
+
 /* Switch dynamic output buffer back to static, discarding pending output.
  * Safe on a static buffer. */
 void ShrinkOutputBuffer(WOLFSSL* ssl)
@@ -12116,9 +12836,7 @@ void ShrinkOutputBuffer(WOLFSSL* ssl)
         ForceZero(ssl->buffers.outputBuffer.buffer,
                   ssl->buffers.outputBuffer.idx +
                       ssl->buffers.outputBuffer.length);
-        XFREE(ssl->buffers.outputBuffer.buffer -
-                  ssl->buffers.outputBuffer.offset,
-              ssl->heap, DYNAMIC_TYPE_OUT_BUFFER);
+        FreeIOBuffer(ssl, &ssl->buffers.outputBuffer, DYNAMIC_TYPE_OUT_BUFFER);
     }
     ssl->buffers.outputBuffer.buffer = ssl->buffers.outputBuffer.staticBuffer;
     ssl->buffers.outputBuffer.bufferSize  = STATIC_BUFFER_LEN;
@@ -12150,8 +12868,9 @@ void ShrinkInputBuffer(WOLFSSL* ssl, int forcedFree)
      * configured window rather than shrinking all the way back to the static
      * buffer, so the speculative over-read is a bounded, mostly one-time
      * allocation instead of per-record churn. A forced free during connection
-     * teardown still reclaims everything. */
-    if (!forcedFree && ssl->readAhead) {
+     * teardown still reclaims everything, and SSL_MODE_RELEASE_BUFFERS drops
+     * the window once drained. */
+    if (!forcedFree && ssl->readAhead && !ssl->options.releaseBuffers) {
         /* Already within the window: keep the buffer as-is. */
         if (ssl->buffers.inputBuffer.bufferSize <= ssl->readAheadSz)
             return;
@@ -12190,8 +12909,7 @@ void ShrinkInputBuffer(WOLFSSL* ssl, int forcedFree)
 
     ForceZero(ssl->buffers.inputBuffer.buffer,
         ssl->buffers.inputBuffer.bufferSize);
-    XFREE(ssl->buffers.inputBuffer.buffer - ssl->buffers.inputBuffer.offset,
-          ssl->heap, DYNAMIC_TYPE_IN_BUFFER);
+    FreeIOBuffer(ssl, &ssl->buffers.inputBuffer, DYNAMIC_TYPE_IN_BUFFER);
     ssl->buffers.inputBuffer.buffer = ssl->buffers.inputBuffer.staticBuffer;
     ssl->buffers.inputBuffer.bufferSize  = STATIC_BUFFER_LEN;
     ssl->buffers.inputBuffer.dynamicFlag = 0;
@@ -12227,6 +12945,12 @@ int SendBuffered(WOLFSSL* ssl)
         return wolfSSL_quic_send(ssl);
     }
 #endif
+#ifdef WOLFSSL_KTLS
+    if (WOLFSSL_IS_KTLS(ssl, 1)) {
+        /* Plaintext records are encrypted by the kernel. */
+        return wolfSSL_ktls_send(ssl);
+    }
+#endif
 
     while (ssl->buffers.outputBuffer.length > 0) {
         int sent = 0;
@@ -12387,6 +13111,7 @@ static WC_INLINE int GrowOutputBuffer(WOLFSSL* ssl, int size)
     const byte align = WOLFSSL_GENERAL_ALIGNMENT;
 #endif
     word32 newSz = 0;
+    byte   poolClass;
 
 #if WOLFSSL_GENERAL_ALIGNMENT > 0
     /* the encrypted data will be offset from the front of the buffer by
@@ -12406,7 +13131,7 @@ static WC_INLINE int GrowOutputBuffer(WOLFSSL* ssl, int size)
     if (! WC_SAFE_SUM_WORD32(newSz, align, newSz))
         return BUFFER_E;
 #endif
-    tmp = (byte*)XMALLOC(newSz, ssl->heap, DYNAMIC_TYPE_OUT_BUFFER);
+    tmp = AllocIOBuffer(ssl, newSz, &poolClass, DYNAMIC_TYPE_OUT_BUFFER);
     newSz -= align;
     WOLFSSL_MSG("growing output buffer");
 
@@ -12432,11 +13157,12 @@ static WC_INLINE int GrowOutputBuffer(WOLFSSL* ssl, int size)
                ssl->buffers.outputBuffer.length);
 
     if (ssl->buffers.outputBuffer.dynamicFlag) {
-        XFREE(ssl->buffers.outputBuffer.buffer -
-              ssl->buffers.outputBuffer.offset, ssl->heap,
-              DYNAMIC_TYPE_OUT_BUFFER);
+        FreeIOBuffer(ssl, &ssl->buffers.outputBuffer, DYNAMIC_TYPE_OUT_BUFFER);
     }
     ssl->buffers.outputBuffer.dynamicFlag = 1;
+#ifdef WOLFSSL_IO_BUFFER_POOL
+    ssl->buffers.outputBuffer.poolClass = poolClass;
+#endif
 
 #if WOLFSSL_GENERAL_ALIGNMENT > 0
     ssl->buffers.outputBuffer.offset = align - hdrSz;
@@ -12454,6 +13180,7 @@ static WC_INLINE int GrowOutputBuffer(WOLFSSL* ssl, int size)
 int GrowInputBuffer(WOLFSSL* ssl, int size, int usedLength)
 {
     byte* tmp;
+    byte  poolClass;
 #if defined(WOLFSSL_DTLS) || WOLFSSL_GENERAL_ALIGNMENT > 0
     byte  align = ssl->options.dtls ? WOLFSSL_GENERAL_ALIGNMENT : 0;
     byte  hdrSz = DTLS_RECORD_HEADER_SZ;
@@ -12478,8 +13205,8 @@ int GrowInputBuffer(WOLFSSL* ssl, int size, int usedLength)
         return BAD_FUNC_ARG;
     }
 
-    tmp = (byte*)XMALLOC((size_t)(size + usedLength + align),
-                             ssl->heap, DYNAMIC_TYPE_IN_BUFFER);
+    tmp = AllocIOBuffer(ssl, (word32)(size + usedLength + align), &poolClass,
+                        DYNAMIC_TYPE_IN_BUFFER);
     WOLFSSL_MSG("growing input buffer");
 
     if (tmp == NULL)
@@ -12509,11 +13236,13 @@ int GrowInputBuffer(WOLFSSL* ssl, int size, int usedLength)
             ForceZero(ssl->buffers.inputBuffer.buffer,
                 ssl->buffers.inputBuffer.length);
         }
-        XFREE(ssl->buffers.inputBuffer.buffer - ssl->buffers.inputBuffer.offset,
-              ssl->heap, DYNAMIC_TYPE_IN_BUFFER);
+        FreeIOBuffer(ssl, &ssl->buffers.inputBuffer, DYNAMIC_TYPE_IN_BUFFER);
     }
 
     ssl->buffers.inputBuffer.dynamicFlag = 1;
+#ifdef WOLFSSL_IO_BUFFER_POOL
+    ssl->buffers.inputBuffer.poolClass = poolClass;
+#endif
 #if defined(WOLFSSL_DTLS) || WOLFSSL_GENERAL_ALIGNMENT > 0
     if (align)
         ssl->buffers.inputBuffer.offset = align - hdrSz;
@@ -12591,6 +13320,11 @@ int MsgCheckEncryption(WOLFSSL* ssl, byte type, byte encrypted)
     /* QUIC protects messages outside of the TLS scope */
     if (WOLFSSL_IS_QUIC(ssl) && IsAtLeastTLSv1_3(ssl->version))
         return 0;
+#endif
+#ifdef WOLFSSL_KTLS
+    /* Kernel only hands over records that it has decrypted. */
+    if (WOLFSSL_IS_KTLS(ssl, 0))
+        encrypted = 1;
 #endif
     /* Verify which messages always have to be encrypted */
     if (IsAtLeastTLSv1_3(ssl->version)) {
@@ -13502,7 +14236,10 @@ static int BuildFinished(WOLFSSL* ssl, Hashes* hashes, const byte* sender)
     }
 #ifndef NO_OLD_TLS
     if (!ssl->options.tls) {
-        ret = BuildMD5(ssl, hashes, sender);
+        ret = StartHandshakeHashes(ssl, HS_HASH_MD5 | HS_HASH_SHA);
+        if (ret == 0) {
+            ret = BuildMD5(ssl, hashes, sender);
+        }
         if (ret == 0) {
             ret = BuildSHA(ssl, hashes, sender);
         }
@@ -16018,6 +16755,12 @@ int DoVerifyCallback(WOLFSSL_CERT_MANAGER* cm, WOLFSSL* ssl, int cert_err,
     if (cert_err == 0) {
         verify_ok = 1;
     }
+#ifdef WOLFSSL_CHAIN_CACHE
+    else {
+        /* Error may be overridden by callback - don't cache the chain. */
+        args->chainCacheSkip = 1;
+    }
+#endif
 
     /* Determine if verify callback should be used */
     if (cert_err != 0) {
@@ -16522,6 +17265,12 @@ PRAGMA_GCC_DIAG_POP
     /* get certificate buffer */
     cert = &args->certs[args->certIdx];
 
+#ifdef WOLFSSL_CHAIN_CACHE
+    /* Chain verified before - signatures are known to be good. */
+    if (args->chainCacheHit && (verify == VERIFY)) {
+        verify = VERIFY_NAME;
+    }
+#endif
 #ifdef WOLFSSL_SMALL_CERT_VERIFY
     if (verify == VERIFY) {
         /* for small cert verify, release decoded cert during signature check to
@@ -17715,6 +18464,94 @@ static int RpkIsTrusted(WOLFSSL* ssl, const byte* spki, word32 spkiSz)
 }
 #endif /* HAVE_RPK */
 
+#ifdef WOLFSSL_CHAIN_CACHE
+/* Calculate the digest of the peer's certificate chain.
+ *
+ * Each certificate is prefixed with its length so that chains that
+ * concatenate to the same bytes don't collide.
+ *
+ * @param [in]  ssl     SSL/TLS object.
+ * @param [in]  args    Peer certificate processing arguments.
+ * @param [out] digest  Buffer to hold SHA-256 digest.
+ * @return  0 on success.
+ * @return  Other value on hashing failure.
+ */
+static int ProcessPeerCertsChainDigest(WOLFSSL* ssl, ProcPeerCertArgs* args,
+    byte* digest)
+{
+    int ret;
+    int i;
+    wc_Sha256 sha;
+
+    ret = wc_InitSha256_ex(&sha, ssl->heap, ssl->devId);
+    for (i = 0; (ret == 0) && (i < args->totalCerts); i++) {
+        byte len[OPAQUE32_LEN];
+
+        c32toa(args->certs[i].length, len);
+        ret = wc_Sha256Update(&sha, len, OPAQUE32_LEN);
+        if (ret == 0) {
+            ret = wc_Sha256Update(&sha, args->certs[i].buffer,
+                args->certs[i].length);
+        }
+    }
+    if (ret == 0) {
+        ret = wc_Sha256Final(&sha, digest);
+    }
+    wc_Sha256Free(&sha);
+
+    return ret;
+}
+
+/* Look up the peer's certificate chain in the certificate manager's cache of
+ * verified chains.
+ *
+ * On a hit, the certificates are parsed and checked as usual except for their
+ * signatures.
+ *
+ * @param [in]      ssl   SSL/TLS object.
+ * @param [in, out] args  Peer certificate processing arguments.
+ * @return  0 on success.
+ * @return  Other value on hashing failure.
+ */
+static int ProcessPeerCertsChainCacheLookup(WOLFSSL* ssl,
+    ProcPeerCertArgs* args)
+{
+    int ret = 0;
+    byte digest[WC_SHA256_DIGEST_SIZE];
+
+    /* Don't calculate the digest when caching isn't enabled. Lookup checks
+     * the cache again under lock. */
+    if ((SSL_CM(ssl) != NULL) && (SSL_CM(ssl)->chainCache != NULL)) {
+        ret = ProcessPeerCertsChainDigest(ssl, args, digest);
+        if (ret == 0) {
+            args->chainCacheHit = (word16)CM_ChainCacheLookup(SSL_CM(ssl),
+                digest, &args->chainCacheGen);
+            if (args->chainCacheHit) {
+                WOLFSSL_MSG("Peer chain verified before, skipping signatures");
+            }
+        }
+    }
+
+    return ret;
+}
+
+/* Add the verified peer's certificate chain to the certificate manager's
+ * cache.
+ *
+ * @param [in] ssl   SSL/TLS object.
+ * @param [in] args  Peer certificate processing arguments.
+ */
+static void ProcessPeerCertsChainCacheAdd(WOLFSSL* ssl, ProcPeerCertArgs* args)
+{
+    byte digest[WC_SHA256_DIGEST_SIZE];
+
+    if ((args->chainCacheGen != 0) &&
+            (ProcessPeerCertsChainDigest(ssl, args, digest) == 0)) {
+        CM_ChainCacheAdd(SSL_CM(ssl), digest, args->chainCacheGen);
+    }
+}
+#endif /* WOLFSSL_CHAIN_CACHE */
+
 int ProcessPeerCerts(WOLFSSL* ssl, byte* input, word32* inOutIdx,
                      word32 totalSz)
 {
@@ -17986,6 +18823,15 @@ int ProcessPeerCerts(WOLFSSL* ssl, byte* input, word32* inOutIdx,
             XMEMSET(args->dCert, 0, sizeof(DecodedCert));
         #endif
 
+        #ifdef WOLFSSL_CHAIN_CACHE
+            if ((args->count > 0) && !ssl->options.verifyNone) {
+                ret = ProcessPeerCertsChainCacheLookup(ssl, args);
+                if (ret != 0) {
+                    goto exit_ppc;
+                }
+            }
+        #endif
+
             /* Advance state and proceed */
             ssl->options.asyncState = TLS_ASYNC_BUILD;
         } /* case TLS_ASYNC_BEGIN */
@@ -18953,6 +19799,19 @@ int ProcessPeerCerts(WOLFSSL* ssl, byte* input, word32* inOutIdx,
             if (ret == 0 || ret != args->leafVerifyErr)
                 ret = DoVerifyCallback(SSL_CM(ssl), ssl, ret, args);
 
+        #ifdef WOLFSSL_CHAIN_CACHE
+            if ((ret == 0) && !args->chainCacheHit && !args->chainCacheSkip
+            #ifdef WOLFSSL_TRUST_PEER_CERT
+                && !args->haveTrustPeer
+            #endif
+            #ifdef WOLFSSL_ALT_CERT_CHAINS
+                && !ssl->options.usingAltCertChain
+            #endif
+                ) {
+                ProcessPeerCertsChainCacheAdd(ssl, args);
+            }
+        #endif
+
             if (ssl->options.verifyNone &&
                               (ret == WC_NO_ERR_TRACE(CRL_MISSING) ||
                                ret == WC_NO_ERR_TRACE(CRL_CERT_REVOKED) ||
@@ -20287,6 +21146,8 @@ int DoHandShakeMsgType(WOLFSSL* ssl, byte* input, word32* inOutIdx,
             AddLateName("ServerHelloDone", &ssl->timeoutInfo);
     #endif
         ssl->options.serverState = SERVER_HELLODONE_COMPLETE;
+        /* Whether a CertificateVerify is sent, and its hash, now known. */
+        ret = SelectHandshakeHashes(ssl);
         break;
 
     case finished:
@@ -26170,45 +27031,70 @@ static int BuildSHA_CertVerify(const WOLFSSL* ssl, byte* digest)
 int BuildCertHashes(const WOLFSSL* ssl, Hashes* hashes)
 {
     int ret = 0;
+    word16 hsHashes = HS_HASH_ALL;
 
     (void)hashes;
 
+#ifdef WOLFSSL_LAZY_HS_HASHES
+    /* TLS v1.3 only has the hash of the cipher suite. Otherwise use the
+     * hashes chosen for the CertificateVerify signature. */
+    if (IsAtLeastTLSv1_3(ssl->version))
+        hsHashes = HandshakeHashForMac(ssl->specs.mac_algorithm);
+    else if (ssl->hsHashes->selected)
+        hsHashes = ssl->hsHashes->started;
+#endif
+    ret = StartHandshakeHashes(ssl, hsHashes);
+    if (ret != 0)
+        return ret;
+
     if (ssl->options.tls) {
     #if !defined(NO_MD5) && !defined(NO_OLD_TLS)
-        ret = wc_Md5GetHash(&ssl->hsHashes->hashMd5, hashes->md5);
-        if (ret != 0)
-            return ret;
+        if ((hsHashes & HS_HASH_MD5) != 0) {
+            ret = wc_Md5GetHash(&ssl->hsHashes->hashMd5, hashes->md5);
+            if (ret != 0)
+                return ret;
+        }
     #endif
     #if !defined(NO_SHA) && (!defined(NO_OLD_TLS) || \
                               defined(WOLFSSL_ALLOW_TLS_SHA1))
-        ret = wc_ShaGetHash(&ssl->hsHashes->hashSha, hashes->sha);
-        if (ret != 0)
-            return ret;
+        if ((hsHashes & HS_HASH_SHA) != 0) {
+            ret = wc_ShaGetHash(&ssl->hsHashes->hashSha, hashes->sha);
+            if (ret != 0)
+                return ret;
+        }
     #endif
         if (IsAtLeastTLSv1_2(ssl)) {
             #ifndef NO_SHA256
+            if ((hsHashes & HS_HASH_SHA256) != 0) {
                 ret = wc_Sha256GetHash(&ssl->hsHashes->hashSha256,
                                        hashes->sha256);
                 if (ret != 0)
                     return ret;
+            }
             #endif
             #ifdef WOLFSSL_SHA384
+            if ((hsHashes & HS_HASH_SHA384) != 0) {
                 ret = wc_Sha384GetHash(&ssl->hsHashes->hashSha384,
                                        hashes->sha384);
                 if (ret != 0)
                     return ret;
+            }
             #endif
             #ifdef WOLFSSL_SHA512
+            if ((hsHashes & HS_HASH_SHA512) != 0) {
                 ret = wc_Sha512GetHash(&ssl->hsHashes->hashSha512,
                                        hashes->sha512);
                 if (ret != 0)
                     return ret;
+            }
             #endif
             #ifdef WOLFSSL_SM3
+            if ((hsHashes & HS_HASH_SM3) != 0) {
                 ret = wc_Sm3GetHash(&ssl->hsHashes->hashSm3,
                                        hashes->sm3);
                 if (ret != 0)
                     return ret;
+            }
             #endif
         }
     }
@@ -28584,6 +29470,55 @@ static int ssl_in_handshake(WOLFSSL *ssl, int sending_data)
     return 0;
 }
 
+#ifdef WOLFSSL_HAVE_IOV
+/* Get the plaintext of the next record to send from the send segments.
+ *
+ * A record that lies within one segment is built straight from it. A record
+ * that spans segments is gathered into the gather buffer first.
+ *
+ * @param [in] ssl  SSL/TLS object.
+ * @param [in] off  Offset of record's plaintext in the segments.
+ * @param [in] sz   Length of record's plaintext in bytes.
+ * @return  Pointer to the plaintext.
+ * @return  NULL when the segments or gather buffer are too short.
+ */
+static byte* SendIovFragment(WOLFSSL* ssl, word32 off, word32 sz)
+{
+    const struct iovec* iov = ssl->buffers.sendIov;
+    int cnt = ssl->buffers.sendIovCnt;
+    int i = 0;
+    word32 idx = 0;
+
+    /* Skip segments already sent. */
+    while ((i < cnt) && ((size_t)off >= iov[i].iov_len)) {
+        off -= (word32)iov[i].iov_len;
+        i++;
+    }
+    if (i == cnt) {
+        return NULL;
+    }
+    if (iov[i].iov_len - off >= sz) {
+        return (byte*)iov[i].iov_base + off;
+    }
+    if (sz > ssl->buffers.sendIovGatherSz) {
+        return NULL;
+    }
+
+    for (; (i < cnt) && (idx < sz); i++) {
+        word32 len = (word32)min(sz - idx, (word32)(iov[i].iov_len - off));
+
+        XMEMCPY(ssl->buffers.sendIovGather + idx,
+            (const byte*)iov[i].iov_base + off, len);
+        idx += len;
+        off = 0;
+    }
+    if (idx != sz) {
+        return NULL;
+    }
+    return ssl->buffers.sendIovGather;
+}
+#endif /* WOLFSSL_HAVE_IOV */
+
 int SendData(WOLFSSL* ssl, const void* data, size_t sz)
 {
     word32 sent = 0; /* plainText size */
@@ -28718,6 +29653,14 @@ int SendData(WOLFSSL* ssl, const void* data, size_t sz)
         return WOLFSSL_FATAL_ERROR;
     }
 
+#ifdef WOLFSSL_KTLS
+    if (WOLFSSL_IS_KTLS(ssl, 1)) {
+        /* Kernel builds the records straight from the caller's data. */
+        return wolfSSL_ktls_send_data(ssl, (const byte*)data, (int)sz,
+                                      (int)sent);
+    }
+#endif
+
 #ifdef WOLFSSL_THREADED_CRYPT
     ret = SendAsyncData(ssl);
     if (ret != 0) {
@@ -28733,7 +29676,7 @@ int SendData(WOLFSSL* ssl, const void* data, size_t sz)
 
     for (;;) {
         byte* out;
-        byte* sendBuffer = (byte*)data + sent;  /* may switch on comp */
+        byte* sendBuffer;                       /* may switch on comp */
         int   buffSz;                           /* may switch on comp */
         int   outputSz;
 #ifdef HAVE_LIBZ
@@ -28860,6 +29803,20 @@ int SendData(WOLFSSL* ssl, const void* data, size_t sz)
         out = encrypt->buffer.buffer;
 #endif
 
+#ifdef WOLFSSL_HAVE_IOV
+        if (ssl->buffers.sendIov != NULL) {
+            sendBuffer = SendIovFragment(ssl, sent, (word32)buffSz);
+            if (sendBuffer == NULL) {
+                ssl->error = BUFFER_E;
+                return WOLFSSL_FATAL_ERROR;
+            }
+        }
+        else
+#endif
+        {
+            sendBuffer = (byte*)data + sent;
+        }
+
 #ifdef HAVE_LIBZ
         if (ssl->options.usingCompression) {
             buffSz = myCompress(ssl, sendBuffer, buffSz, comp, sizeof(comp));
@@ -28984,6 +29941,28 @@ int SendData(WOLFSSL* ssl, const void* data, size_t sz)
     return sent;
 }
 
+#ifdef WOLFSSL_HAVE_IOV
+/* Copy received application data into the receive segments.
+ *
+ * @param [in] ssl  SSL/TLS object.
+ * @param [in] in   Application data.
+ * @param [in] sz   Length of application data in bytes. Must fit.
+ */
+static void RecvIovScatter(WOLFSSL* ssl, const byte* in, word32 sz)
+{
+    const struct iovec* iov = ssl->buffers.recvIov;
+    int i;
+
+    for (i = 0; (i < ssl->buffers.recvIovCnt) && (sz > 0); i++) {
+        word32 len = (word32)min(sz, (word32)iov[i].iov_len);
+
+        XMEMCPY(iov[i].iov_base, in, len);
+        in += len;
+        sz -= len;
+    }
+}
+#endif /* WOLFSSL_HAVE_IOV */
+
 /* process input data */
 int ReceiveData(WOLFSSL* ssl, byte* output, size_t sz, int peek)
 {
@@ -29064,6 +30043,32 @@ startScr:
     }
 #endif
 
+#ifdef WOLFSSL_KTLS
+    if (WOLFSSL_IS_KTLS(ssl, 0) && !peek && output != NULL &&
+            ssl->buffers.clearOutputBuffer.length == 0 &&
+            ssl->options.processReply == doProcessInit) {
+        /* Application data is received straight into the caller's buffer.
+         * Other records are left for ProcessReply(). */
+        size = wolfSSL_ktls_receive_data(ssl, output, (int)sz);
+        if (size < 0) {
+            if (size == WC_NO_ERR_TRACE(SOCKET_ERROR_E) &&
+                    (ssl->options.connReset || ssl->options.isClosed)) {
+                WOLFSSL_MSG("Peer reset or closed, connection done");
+                ssl->error = SOCKET_PEER_CLOSED_E;
+                WOLFSSL_ERROR(ssl->error);
+                return 0; /* peer reset or closed */
+            }
+            ssl->error = size;
+            WOLFSSL_ERROR(size);
+            return size;
+        }
+        if (size > 0) {
+            WOLFSSL_LEAVE("ReceiveData()", size);
+            return size;
+        }
+    }
+#endif
+
     while (ssl->buffers.clearOutputBuffer.length == 0) {
         if ( (error = ProcessReply(ssl)) < 0) {
             if (error == WC_NO_ERR_TRACE(ZERO_RETURN)) {
@@ -29149,7 +30154,16 @@ startScr:
     size = (sz < (size_t)ssl->buffers.clearOutputBuffer.length) ?
         (int)sz : (int)ssl->buffers.clearOutputBuffer.length;
 
-    XMEMCPY(output, ssl->buffers.clearOutputBuffer.buffer, (size_t)(size));
+#ifdef WOLFSSL_HAVE_IOV
+    if (ssl->buffers.recvIov != NULL) {
+        RecvIovScatter(ssl, ssl->buffers.clearOutputBuffer.buffer,
+            (word32)size);
+    }
+    else
+#endif
+    {
+        XMEMCPY(output, ssl->buffers.clearOutputBuffer.buffer, (size_t)(size));
+    }
 
     if (peek == 0) {
         ssl->buffers.clearOutputBuffer.length -= (word32)size;
@@ -30097,6 +31111,9 @@ const char* wolfSSL_ERR_reason_error_string(unsigned long e)
 
     case RPK_UNTRUSTED_E:
         return "RFC 7250 Raw Public Key not trusted";
+
+    case KTLS_UNAVAILABLE_E:
+        return "Kernel TLS offload not available";
     }
 
     return "unknown error number";
@@ -34567,6 +35584,11 @@ static void MakePSKPreMasterSecret(Arrays* arrays, byte use_psk_key)
 
         ssl->options.serverState = SERVER_HELLO_COMPLETE;
 
+        /* Version and cipher suite now known. */
+        ret = SelectHandshakeHashes(ssl);
+        if (ret != 0)
+            return ret;
+
 #ifdef HAVE_SECRET_CALLBACK
         if (ssl->sessionSecretCb != NULL
 #ifdef HAVE_SESSION_TICKET
@@ -38426,6 +39448,10 @@ static int AddPSKtoPreMasterSecret(WOLFSSL* ssl)
 
         ssl->options.serverState = SERVER_HELLO_COMPLETE;
 
+        ret = SelectHandshakeHashes(ssl);
+        if (ret != 0)
+            return ret;
+
         if (ssl->options.groupMessages)
             ret = 0;
         else
@@ -40352,6 +41378,11 @@ static int AddPSKtoPreMasterSecret(WOLFSSL* ssl)
 #endif
 
         /* manually hash input since different format */
+#ifdef WOLFSSL_LAZY_HS_HASHES
+        ret = HashRaw(ssl, input + idx, sz);
+        if (ret != 0)
+            return ret;
+#else
 #ifndef NO_OLD_TLS
 #ifndef NO_MD5
         wc_Md5Update(&ssl->hsHashes->hashMd5, input + idx, sz);
@@ -40368,6 +41399,7 @@ static int AddPSKtoPreMasterSecret(WOLFSSL* ssl)
                 return shaRet;
         }
 #endif
+#endif /* WOLFSSL_LAZY_HS_HASHES */
 
         /* does this value mean client_hello? */
         idx++;
@@ -3676,6 +3676,11 @@ int SetKeysSide(WOLFSSL* ssl, enum encrypt_side side)
         ret = wolfSSL_quic_keys_active(ssl, side);
     }
 #endif /* WOLFSSL_QUIC */
+#ifdef WOLFSSL_KTLS
+    if (ret == 0 && (ssl->options.ktlsTx || ssl->options.ktlsRx)) {
+        ret = wolfSSL_ktls_keys_active(ssl, side);
+    }
+#endif /* WOLFSSL_KTLS */
 
 #ifdef HAVE_SECURE_RENEGOTIATION
 #ifdef WOLFSSL_DTLS
@@ -0,0 +1,780 @@
+/* ktls.c
+ *
+ * Copyright (C) 2006-2026 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+/* Linux kernel TLS (kTLS) offload of the record layer.
+ *
+ * Once the handshake is complete, the traffic keys and sequence numbers are
+ * handed to the socket with setsockopt(TLS_TX/TLS_RX). Application data is
+ * then written and read with plain send()/recv() on the socket, and
+ * sendfile() can be used on it.
+ *
+ * All other records (alerts, post-handshake messages) are still built and
+ * processed by wolfSSL but, like QUIC, without record protection:
+ *  - outgoing records are passed to the kernel with their content type in a
+ *    control message,
+ *  - incoming records are read with their content type from a control
+ *    message and given a plaintext record header for ProcessReply().
+ *
+ * TLS v1.3 KeyUpdate installs the new keys into the kernel when they become
+ * active. Kernels that don't support rekeying fail the key update.
+ */
+
+#include <wolfssl/wolfcrypt/libwolfssl_sources.h>
+
+#ifdef NO_INLINE
+    #include <wolfssl/wolfcrypt/misc.h>
+#else
+    #define WOLFSSL_MISC_INCLUDED
+    #include <wolfcrypt/src/misc.c>
+#endif
+
+#ifndef WOLFCRYPT_ONLY
+#ifdef WOLFSSL_KTLS
+
+#include <wolfssl/error-ssl.h>
+#include <wolfssl/ssl.h>
+#include <wolfssl/internal.h>
+
+#ifndef USE_WOLFSSL_IO
+    #error Kernel TLS requires the wolfSSL socket I/O
+#endif
+
+#include <errno.h>
+#include <netinet/tcp.h>
+#include <sys/sendfile.h>
+#include <linux/tls.h>
+
+#ifndef SOL_TLS
+    #define SOL_TLS     282
+#endif
+#ifndef TCP_ULP
+    #define TCP_ULP     31
+#endif
+
+/* Size of buffer holding a received non-application record. */
+#define KTLS_RX_BUF_SZ  (RECORD_HEADER_SZ + MAX_PLAINTEXT_SZ)
+
+/* Crypto information for the cipher suites the kernel supports. */
+typedef union KtlsCryptoInfo {
+    struct tls_crypto_info info;
+    struct tls12_crypto_info_aes_gcm_128 aesGcm128;
+    struct tls12_crypto_info_aes_gcm_256 aesGcm256;
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+    struct tls12_crypto_info_chacha20_poly1305 chacha;
+#endif
+} KtlsCryptoInfo;
+
+/* Fill in the kernel's crypto information for one direction.
+ *
+ * TLS v1.2 AES-GCM: the salt is the implicit IV and the explicit nonce starts
+ * at the sequence number (RFC 5288). TLS v1.3 AES-GCM: the salt and IV make up
+ * the static IV. ChaCha20-Poly1305: the IV is the static IV.
+ *
+ * @param [in]  ssl   SSL/TLS object.
+ * @param [in]  tx    1 for transmit keys, 0 for receive keys.
+ * @param [out] ci    Crypto information.
+ * @param [out] ciSz  Length of crypto information in bytes.
+ * @return  0 on success.
+ * @return  KTLS_UNAVAILABLE_E when the cipher suite can't be offloaded.
+ */
+static int ktls_crypto_info(WOLFSSL* ssl, int tx, KtlsCryptoInfo* ci,
+    socklen_t* ciSz)
+{
+    int ret = 0;
+    const byte* key;
+    const byte* iv;
+    byte seq[SEQ_SZ];
+    int tls13 = IsAtLeastTLSv1_3(ssl->version);
+    int clientKeys = (ssl->options.side == WOLFSSL_CLIENT_END) == (tx != 0);
+
+    key = clientKeys ? ssl->keys.client_write_key : ssl->keys.server_write_key;
+    iv  = clientKeys ? ssl->keys.client_write_IV  : ssl->keys.server_write_IV;
+    if (tx) {
+        c32toa(ssl->keys.sequence_number_hi, seq);
+        c32toa(ssl->keys.sequence_number_lo, seq + OPAQUE32_LEN);
+    }
+    else {
+        c32toa(ssl->keys.peer_sequence_number_hi, seq);
+        c32toa(ssl->keys.peer_sequence_number_lo, seq + OPAQUE32_LEN);
+    }
+
+    XMEMSET(ci, 0, sizeof(*ci));
+    ci->info.version = tls13 ? TLS_1_3_VERSION : TLS_1_2_VERSION;
+
+    if (ssl->specs.cipher_type != aead ||
+            ssl->specs.aead_mac_size != AES_GCM_AUTH_SZ) {
+        ret = KTLS_UNAVAILABLE_E;
+    }
+    else if (ssl->specs.bulk_cipher_algorithm == wolfssl_aes_gcm &&
+            ssl->specs.key_size == TLS_CIPHER_AES_GCM_128_KEY_SIZE) {
+        struct tls12_crypto_info_aes_gcm_128* gcm = &ci->aesGcm128;
+
+        ci->info.cipher_type = TLS_CIPHER_AES_GCM_128;
+        XMEMCPY(gcm->key, key, TLS_CIPHER_AES_GCM_128_KEY_SIZE);
+        XMEMCPY(gcm->salt, iv, TLS_CIPHER_AES_GCM_128_SALT_SIZE);
+        XMEMCPY(gcm->iv, tls13 ? iv + TLS_CIPHER_AES_GCM_128_SALT_SIZE : seq,
+            TLS_CIPHER_AES_GCM_128_IV_SIZE);
+        XMEMCPY(gcm->rec_seq, seq, TLS_CIPHER_AES_GCM_128_REC_SEQ_SIZE);
+        *ciSz = (socklen_t)sizeof(*gcm);
+    }
+    else if (ssl->specs.bulk_cipher_algorithm == wolfssl_aes_gcm &&
+            ssl->specs.key_size == TLS_CIPHER_AES_GCM_256_KEY_SIZE) {
+        struct tls12_crypto_info_aes_gcm_256* gcm = &ci->aesGcm256;
+
+        ci->info.cipher_type = TLS_CIPHER_AES_GCM_256;
+        XMEMCPY(gcm->key, key, TLS_CIPHER_AES_GCM_256_KEY_SIZE);
+        XMEMCPY(gcm->salt, iv, TLS_CIPHER_AES_GCM_256_SALT_SIZE);
+        XMEMCPY(gcm->iv, tls13 ? iv + TLS_CIPHER_AES_GCM_256_SALT_SIZE : seq,
+            TLS_CIPHER_AES_GCM_256_IV_SIZE);
+        XMEMCPY(gcm->rec_seq, seq, TLS_CIPHER_AES_GCM_256_REC_SEQ_SIZE);
+        *ciSz = (socklen_t)sizeof(*gcm);
+    }
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+    else if (ssl->specs.bulk_cipher_algorithm == wolfssl_chacha &&
+            !ssl->options.oldPoly) {
+        struct tls12_crypto_info_chacha20_poly1305* chacha = &ci->chacha;
+
+        ci->info.cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+        XMEMCPY(chacha->key, key, TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE);
+        XMEMCPY(chacha->iv, iv, TLS_CIPHER_CHACHA20_POLY1305_IV_SIZE);
+        XMEMCPY(chacha->rec_seq, seq,
+            TLS_CIPHER_CHACHA20_POLY1305_REC_SEQ_SIZE);
+        *ciSz = (socklen_t)sizeof(*chacha);
+    }
+#endif
+    else {
+        ret = KTLS_UNAVAILABLE_E;
+    }
+
+    if (ret != 0) {
+        WOLFSSL_MSG("Cipher suite not supported by kernel TLS");
+    }
+    return ret;
+}
+
+/* Install the current keys of one direction into the socket.
+ *
+ * @param [in] ssl  SSL/TLS object.
+ * @param [in] tx   1 for transmit keys, 0 for receive keys.
+ * @return  0 on success.
+ * @return  KTLS_UNAVAILABLE_E when the kernel rejects the keys.
+ */
+static int ktls_set_keys(WOLFSSL* ssl, int tx)
+{
+    int ret;
+    KtlsCryptoInfo ci;
+    socklen_t ciSz = 0;
+
+    ret = ktls_crypto_info(ssl, tx, &ci, &ciSz);
+    if ((ret == 0) && (setsockopt(tx ? ssl->wfd : ssl->rfd, SOL_TLS,
+            tx ? TLS_TX : TLS_RX, &ci, ciSz) != 0)) {
+        WOLFSSL_MSG_EX("Kernel rejected TLS %s keys, errno: %d",
+            tx ? "TX" : "RX", errno);
+        ret = KTLS_UNAVAILABLE_E;
+    }
+
+    ForceZero(&ci, sizeof(ci));
+    return ret;
+}
+
+/* Attach the TLS upper layer protocol to the socket.
+ *
+ * @param [in] fd  Socket.
+ * @return  0 on success.
+ * @return  KTLS_UNAVAILABLE_E when the kernel has no TLS support.
+ */
+static int ktls_attach(SOCKET_T fd)
+{
+    static const char ulp[] = "tls";
+
+    if ((setsockopt(fd, SOL_TCP, TCP_ULP, ulp, sizeof(ulp)) != 0) &&
+            (errno != EEXIST)) {
+        WOLFSSL_MSG_EX("Kernel TLS not available, errno: %d", errno);
+        return KTLS_UNAVAILABLE_E;
+    }
+    return 0;
+}
+
+/* Convert a WOLFSSL_CBIO_ERR_* value into a wolfSSL error.
+ *
+ * @param [in, out] ssl     SSL/TLS object.
+ * @param [in]      err     WOLFSSL_CBIO_ERR_* value.
+ * @param [in]      isSend  1 when sending, 0 when receiving.
+ * @return  WANT_READ or WANT_WRITE when the socket would block.
+ * @return  SOCKET_ERROR_E otherwise.
+ */
+static int ktls_io_error(WOLFSSL* ssl, int err, int isSend)
+{
+    switch (err) {
+        case WC_NO_ERR_TRACE(WOLFSSL_CBIO_ERR_WANT_READ):
+            /* Same value as WOLFSSL_CBIO_ERR_WANT_WRITE. */
+            return isSend ? WC_NO_ERR_TRACE(WANT_WRITE) :
+                            WC_NO_ERR_TRACE(WANT_READ);
+        case WC_NO_ERR_TRACE(WOLFSSL_CBIO_ERR_CONN_RST):
+            ssl->options.connReset = 1;
+            break;
+        case WC_NO_ERR_TRACE(WOLFSSL_CBIO_ERR_CONN_CLOSE):
+            if (isSend)
+                ssl->options.connReset = 1;
+            else
+                ssl->options.isClosed = 1;
+            break;
+        default:
+            break;
+    }
+    return SOCKET_ERROR_E;
+}
+
+/* Make the receive buffer hold the record content in it with a plaintext
+ * record header.
+ *
+ * @param [in, out] ssl   SSL/TLS object.
+ * @param [in]      type  Record content type.
+ * @param [in]      sz    Length of record content in bytes.
+ */
+static void ktls_rx_set_header(WOLFSSL* ssl, byte type, int sz)
+{
+    RecordLayerHeader* rl = (RecordLayerHeader*)ssl->ktls.rxBuf;
+
+    rl->type = type;
+    rl->pvMajor = ssl->version.major;
+    rl->pvMinor = IsAtLeastTLSv1_3(ssl->version) ? TLSv1_2_MINOR :
+                                                   ssl->version.minor;
+    c16toa((word16)sz, rl->length);
+    ssl->ktls.rxLen = RECORD_HEADER_SZ + (word32)sz;
+    ssl->ktls.rxIdx = 0;
+}
+
+/* Allocate the receive buffer when not already.
+ *
+ * @param [in, out] ssl  SSL/TLS object.
+ * @return  0 on success.
+ * @return  MEMORY_E on dynamic memory allocation failure.
+ */
+static int ktls_rx_alloc(WOLFSSL* ssl)
+{
+    if (ssl->ktls.rxBuf == NULL) {
+        ssl->ktls.rxBuf = (byte*)XMALLOC(KTLS_RX_BUF_SZ, ssl->heap,
+            DYNAMIC_TYPE_IN_BUFFER);
+        if (ssl->ktls.rxBuf == NULL)
+            return MEMORY_E;
+    }
+    return 0;
+}
+
+/* Read the next record from the kernel into the receive buffer.
+ *
+ * @param [in, out] ssl  SSL/TLS object.
+ * @return  0 on success.
+ * @return  WANT_READ when the socket would block.
+ * @return  Other negative value on error.
+ */
+static int ktls_rx_read(WOLFSSL* ssl)
+{
+    int ret;
+    byte type = 0;
+
+    ret = ktls_rx_alloc(ssl);
+    if (ret != 0)
+        return ret;
+
+    do {
+        ret = wolfIO_RecvRecord(ssl->rfd, &type,
+            ssl->ktls.rxBuf + RECORD_HEADER_SZ, MAX_PLAINTEXT_SZ, ssl->rflags);
+    }
+    while (ret == WC_NO_ERR_TRACE(WOLFSSL_CBIO_ERR_ISR));
+    if (ret < 0)
+        return ktls_io_error(ssl, ret, 0);
+    if (ret == 0) {
+        ssl->options.isClosed = 1;
+        return SOCKET_ERROR_E;
+    }
+
+    ktls_rx_set_header(ssl, type, ret);
+    return 0;
+}
+
+/* Receive record data for the record layer.
+ *
+ * Called by wolfSSLReceive() when the kernel decrypts records.
+ *
+ * @param [in, out] ssl  SSL/TLS object.
+ * @param [out]     buf  Buffer to place data into.
+ * @param [in]      sz   Number of bytes to place.
+ * @return  Number of bytes placed on success.
+ * @return  WANT_READ when the socket would block.
+ * @return  Other negative value on error.
+ */
+int wolfSSL_ktls_receive(WOLFSSL* ssl, byte* buf, word32 sz)
+{
+    int ret;
+    word32 len;
+
+    WOLFSSL_ENTER("wolfSSL_ktls_receive");
+
+    if (ssl->ktls.rxIdx == ssl->ktls.rxLen) {
+        ret = ktls_rx_read(ssl);
+        if (ret != 0) {
+            WOLFSSL_LEAVE("wolfSSL_ktls_receive", ret);
+            return ret;
+        }
+    }
+
+    len = min(sz, ssl->ktls.rxLen - ssl->ktls.rxIdx);
+    XMEMCPY(buf, ssl->ktls.rxBuf + ssl->ktls.rxIdx, len);
+    ssl->ktls.rxIdx += len;
+
+    WOLFSSL_LEAVE("wolfSSL_ktls_receive", (int)len);
+    return (int)len;
+}
+
+/* Receive application data straight into the caller's buffer.
+ *
+ * A non-application record is kept for ProcessReply() instead.
+ *
+ * @param [in, out] ssl     SSL/TLS object.
+ * @param [out]     output  Buffer to hold application data.
+ * @param [in]      sz      Size of buffer in bytes.
+ * @return  Number of bytes of application data received.
+ * @return  0 when the record layer must process a record.
+ * @return  Negative value on error.
+ */
+int wolfSSL_ktls_receive_data(WOLFSSL* ssl, byte* output, int sz)
+{
+    int ret;
+    byte type = 0;
+
+    /* Don't read ahead of a record the record layer has started on. */
+    if ((sz <= 0) || (ssl->ktls.rxIdx != ssl->ktls.rxLen) ||
+            (ssl->buffers.inputBuffer.idx !=
+             ssl->buffers.inputBuffer.length)) {
+        return 0;
+    }
+
+    do {
+        ret = wolfIO_RecvRecord(ssl->rfd, &type, output, sz, ssl->rflags);
+    }
+    while (ret == WC_NO_ERR_TRACE(WOLFSSL_CBIO_ERR_ISR));
+    if (ret < 0)
+        return ktls_io_error(ssl, ret, 0);
+    if (ret == 0) {
+        ssl->options.isClosed = 1;
+        return SOCKET_ERROR_E;
+    }
+    if (type == application_data)
+        return ret;
+
+    /* Any remaining content of the record is read by the record layer. */
+    WOLFSSL_MSG("kTLS received non-application record");
+    if (ktls_rx_alloc(ssl) != 0)
+        return MEMORY_E;
+    XMEMCPY(ssl->ktls.rxBuf + RECORD_HEADER_SZ, output, (size_t)ret);
+    ForceZero(output, (word32)ret);
+    ktls_rx_set_header(ssl, type, ret);
+    return 0;
+}
+
+/* Send the records in the output buffer.
+ *
+ * Called by SendBuffered() when the kernel encrypts records. The records have
+ * plaintext headers and are passed to the kernel with their content type.
+ *
+ * @param [in, out] ssl  SSL/TLS object.
+ * @return  0 on success.
+ * @return  WANT_WRITE when the socket would block.
+ * @return  Other negative value on error.
+ */
+int wolfSSL_ktls_send(WOLFSSL* ssl)
+{
+    int ret = 0;
+
+    WOLFSSL_ENTER("wolfSSL_ktls_send");
+
+    while (ssl->buffers.outputBuffer.length > 0) {
+        RecordLayerHeader rl;
+        word16 len;
+        int sent;
+        byte* rec = ssl->buffers.outputBuffer.buffer +
+                    ssl->buffers.outputBuffer.idx;
+
+        if (ssl->buffers.outputBuffer.length < RECORD_HEADER_SZ) {
+            ret = BUFFER_ERROR;
+            break;
+        }
+        XMEMCPY(&rl, rec, RECORD_HEADER_SZ);
+        ato16(rl.length, &len);
+        if ((word32)RECORD_HEADER_SZ + len >
+                ssl->buffers.outputBuffer.length) {
+            ret = BUFFER_ERROR;
+            break;
+        }
+
+        sent = wolfIO_SendRecord(ssl->wfd, rl.type, rec + RECORD_HEADER_SZ,
+            len, ssl->wflags);
+        if (sent == WC_NO_ERR_TRACE(WOLFSSL_CBIO_ERR_ISR))
+            continue;
+        if (sent < 0) {
+            ret = ktls_io_error(ssl, sent, 1);
+            break;
+        }
+        if (sent > len) {
+            ret = SEND_OOB_READ_E;
+            break;
+        }
+
+        /* Header of a record with the rest of the content goes over bytes
+         * already sent. */
+        ssl->buffers.outputBuffer.idx += (word32)sent;
+        ssl->buffers.outputBuffer.length -= (word32)sent;
+        if (sent == len) {
+            ssl->buffers.outputBuffer.idx += RECORD_HEADER_SZ;
+            ssl->buffers.outputBuffer.length -= RECORD_HEADER_SZ;
+        }
+        else {
+            c16toa((word16)(len - sent), rl.length);
+            XMEMCPY(ssl->buffers.outputBuffer.buffer +
+                ssl->buffers.outputBuffer.idx, &rl, RECORD_HEADER_SZ);
+        }
+    }
+
+    if (ret == 0) {
+        ssl->buffers.outputBuffer.idx = 0;
+        if (ssl->buffers.outputBuffer.dynamicFlag)
+            ShrinkOutputBuffer(ssl);
+    }
+#ifdef WOLFSSL_TLS13
+    if ((ret == 0) && ssl->ktls.txKeyUpdate) {
+        /* KeyUpdate has all been sent under the old keys. */
+        ssl->ktls.txKeyUpdate = 0;
+        ret = Tls13KeyUpdateSendKeys(ssl);
+    }
+#endif
+
+    WOLFSSL_LEAVE("wolfSSL_ktls_send", ret);
+    return ret;
+}
+
+#ifdef WOLFSSL_HAVE_IOV
+/* Find the rest of the send segment that holds an offset.
+ *
+ * @param [in]  ssl  SSL/TLS object.
+ * @param [in]  off  Offset into the send segments.
+ * @param [out] len  Number of bytes from offset to end of segment.
+ * @return  Pointer to the data at the offset.
+ * @return  NULL when the offset is past the end of the segments.
+ */
+static const byte* ktls_iov_segment(WOLFSSL* ssl, word32 off, int* len)
+{
+    const struct iovec* iov = ssl->buffers.sendIov;
+    int i;
+
+    for (i = 0; i < ssl->buffers.sendIovCnt; i++) {
+        if ((size_t)off < iov[i].iov_len) {
+            *len = (int)(iov[i].iov_len - off);
+            return (const byte*)iov[i].iov_base + off;
+        }
+        off -= (word32)iov[i].iov_len;
+    }
+    return NULL;
+}
+#endif
+
+/* Send application data straight from the caller's buffer.
+ *
+ * With send segments set, data is NULL and the segments are sent instead.
+ *
+ * @param [in, out] ssl   SSL/TLS object.
+ * @param [in]      data  Application data.
+ * @param [in]      sz    Length of application data in bytes.
+ * @param [in]      sent  Number of bytes already sent.
+ * @return  Number of bytes sent on success.
+ * @return  0 when peer closed or reset the connection.
+ * @return  Negative value on error.
+ */
+int wolfSSL_ktls_send_data(WOLFSSL* ssl, const byte* data, int sz, int sent)
+{
+    int ret;
+
+    WOLFSSL_ENTER("wolfSSL_ktls_send_data");
+
+    /* Continue from where a WANT_WRITE stopped the last call. */
+    if (sent == 0)
+        sent = (int)ssl->buffers.prevSent;
+    ssl->buffers.prevSent = 0;
+    ssl->buffers.plainSz = 0;
+    if (sent > sz) {
+        WOLFSSL_MSG("error: write() after WANT_WRITE with short size");
+        return (ssl->error = BAD_FUNC_ARG);
+    }
+
+    while (sent < sz) {
+        const byte* buf = data + sent;
+        int len = sz - sent;
+        int flags = ssl->wflags;
+
+    #ifdef WOLFSSL_HAVE_IOV
+        if (ssl->buffers.sendIov != NULL) {
+            /* A segment at a time. MSG_MORE lets the kernel fill records
+             * across segments. */
+            buf = ktls_iov_segment(ssl, (word32)sent, &len);
+            if (buf == NULL)
+                return (ssl->error = BUFFER_E);
+            if (sent + len < sz)
+                flags |= MSG_MORE;
+        }
+    #endif
+        ret = wolfIO_Send(ssl->wfd, (char*)buf, len, flags);
+        if (ret == WC_NO_ERR_TRACE(WOLFSSL_CBIO_ERR_ISR))
+            continue;
+        if (ret < 0) {
+            ret = ktls_io_error(ssl, ret, 1);
+            ssl->error = ret;
+            WOLFSSL_ERROR(ret);
+            if (ret == WC_NO_ERR_TRACE(WANT_WRITE)) {
+                ssl->buffers.prevSent = (word32)sent;
+            }
+            else if (ssl->options.connReset || ssl->options.isClosed) {
+                ssl->error = SOCKET_PEER_CLOSED_E;
+                WOLFSSL_ERROR(ssl->error);
+                return 0;  /* peer reset or closed */
+            }
+            return ret;
+        }
+        sent += ret;
+
+        /* only one write per attempt */
+        if (ssl->options.partialWrite == 1) {
+            WOLFSSL_MSG("Partial Write on, only sending once");
+            break;
+        }
+    }
+    ssl->error = 0;
+
+    WOLFSSL_LEAVE("wolfSSL_ktls_send_data", sent);
+    return sent;
+}
+
+/* Install keys that have just become active into the kernel.
+ *
+ * Called by SetKeysSide(). Only a TLS v1.3 KeyUpdate changes keys once the
+ * kernel is protecting records.
+ *
+ * @param [in, out] ssl   SSL/TLS object.
+ * @param [in]      side  Side(s) that have new keys.
+ * @return  0 on success.
+ * @return  KTLS_UNAVAILABLE_E when the kernel can't change keys.
+ * @return  BAD_STATE_E when a record for the old keys hasn't been sent.
+ */
+int wolfSSL_ktls_keys_active(WOLFSSL* ssl, enum encrypt_side side)
+{
+    int ret = 0;
+    int tx = ssl->options.ktlsTx && (side == ENCRYPT_AND_DECRYPT_SIDE ||
+                                     side == ENCRYPT_SIDE_ONLY);
+    int rx = ssl->options.ktlsRx && (side == ENCRYPT_AND_DECRYPT_SIDE ||
+                                     side == DECRYPT_SIDE_ONLY);
+
+    WOLFSSL_ENTER("wolfSSL_ktls_keys_active");
+
+    if ((tx || rx) && !IsAtLeastTLSv1_3(ssl->version)) {
+        WOLFSSL_MSG("Kernel TLS doesn't support renegotiation");
+        ret = KTLS_UNAVAILABLE_E;
+    }
+    if ((ret == 0) && tx && (ssl->buffers.outputBuffer.length > 0)) {
+        /* The KeyUpdate must reach the kernel before the keys change. */
+        WOLFSSL_MSG("KeyUpdate not sent before changing kTLS keys");
+        ret = BAD_STATE_E;
+    }
+    if ((ret == 0) && tx)
+        ret = ktls_set_keys(ssl, 1);
+    if ((ret == 0) && rx)
+        ret = ktls_set_keys(ssl, 0);
+
+    WOLFSSL_LEAVE("wolfSSL_ktls_keys_active", ret);
+    return ret;
+}
+
+/* Dispose of kernel TLS state.
+ *
+ * @param [in, out] ssl  SSL/TLS object.
+ */
+void wolfSSL_ktls_free(WOLFSSL* ssl)
+{
+    if (ssl->ktls.rxBuf != NULL) {
+        ForceZero(ssl->ktls.rxBuf, KTLS_RX_BUF_SZ);
+        XFREE(ssl->ktls.rxBuf, ssl->heap, DYNAMIC_TYPE_IN_BUFFER);
+        ssl->ktls.rxBuf = NULL;
+    }
+    ssl->ktls.rxLen = 0;
+    ssl->ktls.rxIdx = 0;
+}
+
+/* Hand record protection over to the kernel.
+ *
+ * Call after the handshake has completed. The socket must be set with
+ * wolfSSL_set_fd() or wolfSSL_set_read_fd()/wolfSSL_set_write_fd(). When the
+ * kernel can't take over a direction, that direction stays with wolfSSL and
+ * the connection can still be used.
+ *
+ * Supported cipher suites: AES-128-GCM, AES-256-GCM and ChaCha20-Poly1305
+ * with TLS v1.2 and TLS v1.3. Renegotiation is not supported.
+ *
+ * @param [in, out] ssl  SSL/TLS object.
+ * @param [in]      dir  WOLFSSL_KTLS_TX and/or WOLFSSL_KTLS_RX.
+ * @return  WOLFSSL_SUCCESS on success.
+ * @return  BAD_FUNC_ARG when ssl is NULL or dir is invalid.
+ * @return  BAD_STATE_E when the handshake isn't done, or received records
+ *          are still buffered.
+ * @return  KTLS_UNAVAILABLE_E when the kernel, socket or cipher suite doesn't
+ *          support kernel TLS.
+ * @return  Other negative value when sending buffered records fails.
+ */
+int wolfSSL_UseKTLS(WOLFSSL* ssl, int dir)
+{
+    int ret = 0;
+
+    WOLFSSL_ENTER("wolfSSL_UseKTLS");
+
+    if ((ssl == NULL) || (dir == 0) ||
+            ((dir & ~(WOLFSSL_KTLS_TX | WOLFSSL_KTLS_RX)) != 0)) {
+        return BAD_FUNC_ARG;
+    }
+    if (!ssl->options.handShakeDone || ssl->options.dtls ||
+            WOLFSSL_IS_QUIC(ssl) || !IsAtLeastTLSv1_2(ssl)) {
+        WOLFSSL_MSG("Kernel TLS needs a completed TLS v1.2+ handshake");
+        return BAD_STATE_E;
+    }
+
+    if ((dir & WOLFSSL_KTLS_RX) && !ssl->options.ktlsRx &&
+            ((ssl->buffers.inputBuffer.idx !=
+              ssl->buffers.inputBuffer.length) ||
+             (ssl->buffers.clearOutputBuffer.length > 0))) {
+        /* Kernel can't decrypt records already read from the socket. */
+        WOLFSSL_MSG("Received records buffered, read them first");
+        return BAD_STATE_E;
+    }
+
+    if ((dir & WOLFSSL_KTLS_TX) && !ssl->options.ktlsTx) {
+        /* Records already protected by wolfSSL go out first. */
+        if (ssl->buffers.outputBuffer.length > 0)
+            ret = SendBuffered(ssl);
+        if (ret == 0)
+            ret = ktls_attach(ssl->wfd);
+        if (ret == 0)
+            ret = ktls_set_keys(ssl, 1);
+        if (ret == 0) {
+            ssl->options.ktlsTx = 1;
+            ssl->buffers.prevSent = 0;
+            ssl->buffers.plainSz = 0;
+        }
+    }
+
+    if ((ret == 0) && (dir & WOLFSSL_KTLS_RX) && !ssl->options.ktlsRx) {
+        ret = ktls_attach(ssl->rfd);
+        if (ret == 0)
+            ret = ktls_set_keys(ssl, 0);
+        if (ret == 0)
+            ssl->options.ktlsRx = 1;
+    }
+
+    if (ret == WC_NO_ERR_TRACE(KTLS_UNAVAILABLE_E)) {
+        WOLFSSL_MSG_EX("Kernel TLS not used, wolfSSL protects records: "
+            "TX %s, RX %s", ssl->options.ktlsTx ? "kernel" : "wolfSSL",
+            ssl->options.ktlsRx ? "kernel" : "wolfSSL");
+    }
+    if (ret == 0)
+        ret = WOLFSSL_SUCCESS;
+
+    WOLFSSL_LEAVE("wolfSSL_UseKTLS", ret);
+    return ret;
+}
+
+/* Get the directions that the kernel protects records for.
+ *
+ * @param [in] ssl  SSL/TLS object.
+ * @return  WOLFSSL_KTLS_TX and/or WOLFSSL_KTLS_RX.
+ * @return  0 when ssl is NULL or kernel TLS is not in use.
+ */
+int wolfSSL_GetKTLS(const WOLFSSL* ssl)
+{
+    int dir = 0;
+
+    if (ssl != NULL) {
+        if (ssl->options.ktlsTx)
+            dir |= WOLFSSL_KTLS_TX;
+        if (ssl->options.ktlsRx)
+            dir |= WOLFSSL_KTLS_RX;
+    }
+    return dir;
+}
+
+/* Send the contents of a file as application data.
+ *
+ * The kernel encrypts the file data without copying it through user space.
+ * Kernel TLS must be in use for transmit.
+ *
+ * @param [in, out] ssl     SSL/TLS object.
+ * @param [in]      fd      File descriptor of file to send.
+ * @param [in]      offset  Offset into file to start sending from.
+ * @param [in]      sz      Number of bytes to send.
+ * @return  Number of bytes sent on success.
+ * @return  WOLFSSL_FATAL_ERROR on failure. Use wolfSSL_get_error() for the
+ *          reason.
+ * @return  BAD_FUNC_ARG when ssl is NULL, or fd, offset or sz is invalid.
+ */
+int wolfSSL_sendfile(WOLFSSL* ssl, int fd, long offset, int sz)
+{
+    int ret;
+    off_t off = (off_t)offset;
+
+    WOLFSSL_ENTER("wolfSSL_sendfile");
+
+    if ((ssl == NULL) || (fd < 0) || (offset < 0) || (sz < 0))
+        return BAD_FUNC_ARG;
+    if (!ssl->options.ktlsTx) {
+        WOLFSSL_MSG("Kernel TLS not in use for transmit");
+        ssl->error = BAD_STATE_E;
+        return WOLFSSL_FATAL_ERROR;
+    }
+
+    /* Records must go out in order. */
+    ret = SendBuffered(ssl);
+    if (ret == 0) {
+        do {
+            ret = (int)sendfile(ssl->wfd, fd, &off, (size_t)sz);
+        }
+        while ((ret < 0) && (errno == EINTR));
+        if (ret < 0) {
+            ret = ((errno == EAGAIN) || (errno == EWOULDBLOCK)) ?
+                WC_NO_ERR_TRACE(WANT_WRITE) : SOCKET_ERROR_E;
+        }
+    }
+    if (ret < 0) {
+        ssl->error = ret;
+        WOLFSSL_ERROR(ret);
+        ret = WOLFSSL_FATAL_ERROR;
+    }
+
+    WOLFSSL_LEAVE("wolfSSL_sendfile", ret);
+    return ret;
+}
+
+#endif /* WOLFSSL_KTLS */
+#endif /* !WOLFCRYPT_ONLY */
@@ -166,6 +166,10 @@ void FreeOCSP(WOLFSSL_OCSP* ocsp, int dynamic)
 
     WOLFSSL_ENTER("FreeOCSP");
 
+#ifdef WOLFSSL_OCSP_STAPLE_CACHE
+    OcspStapleCacheFree(ocsp);
+#endif
+
     for (entry = ocsp->ocspList; entry; entry = next) {
         next = entry->next;
         FreeOcspEntry(entry, heap);
@@ -476,22 +480,884 @@ end:
     return ret;
 }
 
-/* 0 on success */
 /* allow user to override the maximum request size at build-time */
 #ifndef OCSP_MAX_REQUEST_SZ
 #define OCSP_MAX_REQUEST_SZ 2048
 #endif
+
+/* Encode the request and send it to the responder.
+ *
+ * Whatever the IO callback hands back is returned in response, even on
+ * failure, and the caller passes it to ocspRespFreeCb.
+ *
+ * ocsp        Context object for OCSP status.
+ * ocspRequest Request to send.
+ * ioCtx       Context for the IO callback.
+ * response    Response message data from the IO callback.
+ * responseSz  Length of response message data.
+ * returns 0 when a response was received, OCSP_NEED_URL or OCSP_NO_URL when
+ * there is no responder to ask, OCSP_WANT_READ or HTTP_TIMEOUT from the IO
+ * callback, MEMORY_ERROR and OCSP_INVALID_STATUS otherwise.
+ */
+static int OcspRequestIO(WOLFSSL_OCSP* ocsp, OcspRequest* ocspRequest,
+                         void* ioCtx, byte** response, int* responseSz)
+{
+    byte*       request        = NULL;
+    int         requestSz      = OCSP_MAX_REQUEST_SZ;
+    const char* url            = NULL;
+    int         urlSz          = 0;
+    int         ret            = WC_NO_ERR_TRACE(OCSP_INVALID_STATUS);
+
+    *response = NULL;
+    *responseSz = 0;
+
+    if (ocsp->cm->ocspUseOverrideURL) {
+        url = ocsp->cm->ocspOverrideURL;
+        if (url != NULL && url[0] != '\0')
+            urlSz = (int)XSTRLEN(url);
+        else
+            return OCSP_NEED_URL;
+    }
+    else if (ocspRequest->urlSz != 0 && ocspRequest->url != NULL) {
+        url = (const char *)ocspRequest->url;
+        urlSz = ocspRequest->urlSz;
+    }
+    else {
+        /* Cert advertises no OCSP responder and no override URL is set, so
+         * OCSP has no opinion on this cert. Report that distinctly from a
+         * failed lookup; the caller owns the policy decision. Callers wanting
+         * the historical soft-fail run this through OcspNoUrlPolicy(). */
+        WOLFSSL_MSG("Cert has no OCSP URL");
+        return OCSP_NO_URL;
+    }
+
+    request = (byte*)XMALLOC((size_t)requestSz, ocsp->cm->heap, DYNAMIC_TYPE_OCSP);
+    if (request == NULL) {
+        return MEMORY_ERROR;
+    }
+
+    requestSz = EncodeOcspRequest(ocspRequest, request, (word32)requestSz);
+    if (requestSz > 0 && ocsp->cm->ocspIOCb) {
+        *responseSz = ocsp->cm->ocspIOCb(ioCtx, url, urlSz,
+                                         request, requestSz, response);
+    }
+    if (*responseSz == WC_NO_ERR_TRACE(WOLFSSL_CBIO_ERR_WANT_READ)) {
+        ret = OCSP_WANT_READ;
+    }
+    else if (*responseSz == WC_NO_ERR_TRACE(WOLFSSL_CBIO_ERR_TIMEOUT)){
+        ret = HTTP_TIMEOUT;
+    }
+    else if (*responseSz >= 0 && *response != NULL) {
+        ret = 0;
+    }
+
+    XFREE(request, ocsp->cm->heap, DYNAMIC_TYPE_OCSP);
+
+    return ret;
+}
+
+#ifdef WOLFSSL_OCSP_STAPLE_CACHE
+
+#if !defined(SINGLE_THREADED) && !defined(WOLFSSL_ATOMIC_OPS)
+    #error The OCSP staple cache requires atomic operations
+#endif
+
+#if !defined(SINGLE_THREADED) && defined(WOLFSSL_PTHREADS)
+    #define OCSP_STAPLE_REFRESH_THREAD
+    #include <errno.h>
+    #include <time.h>
+#endif
+
+/* Fetch a new response this many seconds before the cached one's nextUpdate.
+ * A background refresh interval shorter than this keeps responses current. */
+#ifndef OCSP_STAPLE_REFRESH_MARGIN
+    #define OCSP_STAPLE_REFRESH_MARGIN      3600
+#endif
+/* Most certificates a single cache can track. */
+#ifndef OCSP_STAPLE_CACHE_MAX_ENTRIES
+    #define OCSP_STAPLE_CACHE_MAX_ENTRIES   1024
+#endif
+
+#define OCSP_STAPLE_CACHE_VERSION       1
+#define OCSP_STAPLE_CACHE_HDR_SZ        (3 * OPAQUE32_LEN)
+
+/* A validated response, ready to staple. */
+typedef struct OcspStaple {
+    byte*  resp;
+    word32 respSz;
+    int    status;
+    byte   thisDate[MAX_DATE_SIZE];
+    byte   nextDate[MAX_DATE_SIZE];
+    byte   thisDateFormat;
+    byte   nextDateFormat;
+} OcspStaple;
+
+/* A certificate the cache keeps a response for.
+ *
+ * Handshakes read the published slot without a lock. A refresh fills the other
+ * slot and then publishes it, so a reader only ever sees a complete response.
+ * Readers count themselves into a slot before using it and a refresh only
+ * reuses a slot with nobody counted in.
+ */
+typedef struct OcspStapleEntry {
+    OcspRequest        req;         /* Built without a nonce. */
+    OcspStaple         slot[2];
+    wolfSSL_Atomic_Int cur;         /* Published slot, -1 for none. */
+    wolfSSL_Atomic_Int readers[2];
+} OcspStapleEntry;
+
+struct OcspStapleCache {
+    OcspStapleEntry*   entries;
+    int                cap;
+    wolfSSL_Atomic_Int count;       /* Entries visible to readers. */
+    wolfSSL_Mutex      lock;        /* Serializes writers only. */
+#ifdef OCSP_STAPLE_REFRESH_THREAD
+    pthread_mutex_t    thrLock;
+    pthread_cond_t     thrCond;
+    THREAD_TYPE        thread;
+    word32             interval;
+    byte               running;
+    byte               stop;
+#endif
+};
+
+/* Add to a reader count with full ordering so that the check of the published
+ * slot that follows can't be moved ahead of it. */
+static void staple_readers_add(wolfSSL_Atomic_Int* cnt, int n)
+{
+    int cur = WOLFSSL_ATOMIC_LOAD(*cnt);
+
+    while (!wolfSSL_Atomic_Int_CompareExchange(cnt, &cur, cur + n)) {
+        /* cur now holds the latest value. */
+    }
+}
+
+static OcspStapleEntry* staple_cache_find(OcspStapleCache* cache,
+    const byte* issuerHash, const byte* issuerKeyHash, const byte* serial,
+    int serialSz)
+{
+    int n = WOLFSSL_ATOMIC_LOAD(cache->count);
+    int i;
+
+    for (i = 0; i < n; i++) {
+        OcspStapleEntry* e = &cache->entries[i];
+
+        if (e->req.serialSz == serialSz &&
+                XMEMCMP(e->req.serial, serial, (size_t)serialSz) == 0 &&
+                XMEMCMP(e->req.issuerHash, issuerHash, OCSP_DIGEST_SIZE) == 0 &&
+                XMEMCMP(e->req.issuerKeyHash, issuerKeyHash,
+                        OCSP_DIGEST_SIZE) == 0) {
+            return e;
+        }
+    }
+
+    return NULL;
+}
+
+/* Whether the response's validity window covers the current time. */
+static int staple_current(const OcspStaple* staple)
+{
+#ifndef NO_ASN_TIME
+    if (!XVALIDATE_DATE(staple->thisDate, staple->thisDateFormat, ASN_BEFORE,
+                        MAX_DATE_SIZE)) {
+        return 0;
+    }
+    if (staple->nextDate[0] != 0 &&
+            !XVALIDATE_DATE(staple->nextDate, staple->nextDateFormat,
+                            ASN_AFTER, MAX_DATE_SIZE)) {
+        return 0;
+    }
+#else
+    (void)staple;
+#endif
+    return 1;
+}
+
+/* Copy the cached response for the request into responseBuffer.
+ *
+ * Takes no lock.
+ *
+ * returns the certificate's OCSP status, MEMORY_E on allocation failure and
+ * OCSP_INVALID_STATUS when there is no current response to staple.
+ */
+static int OcspStapleCacheGet(OcspStapleCache* cache, OcspRequest* req,
+                              buffer* responseBuffer, void* heap)
+{
+    int ret = WC_NO_ERR_TRACE(OCSP_INVALID_STATUS);
+    OcspStapleEntry* e;
+    int i;
+    int expected;
+
+    (void)heap;
+
+    e = staple_cache_find(cache, req->issuerHash, req->issuerKeyHash,
+                          req->serial, req->serialSz);
+    if (e == NULL)
+        return ret;
+
+    i = WOLFSSL_ATOMIC_LOAD(e->cur);
+    if (i < 0)
+        return ret;
+
+    staple_readers_add(&e->readers[i], 1);
+    /* The slot may have been retired before this reader was counted in, in
+     * which case a refresh could be rewriting it - use it only when still
+     * published. */
+    expected = i;
+    if (wolfSSL_Atomic_Int_CompareExchange(&e->cur, &expected, i)) {
+        OcspStaple* staple = &e->slot[i];
+
+        if (staple_current(staple)) {
+            responseBuffer->buffer = (byte*)XMALLOC(staple->respSz, heap,
+                                                    DYNAMIC_TYPE_TMP_BUFFER);
+            if (responseBuffer->buffer == NULL) {
+                ret = MEMORY_E;
+            }
+            else {
+                XMEMCPY(responseBuffer->buffer, staple->resp, staple->respSz);
+                responseBuffer->length = staple->respSz;
+                ret = xstat2err(staple->status);
+            }
+        }
+    }
+    staple_readers_add(&e->readers[i], -1);
+
+    return ret;
+}
+
+/* Decode and verify a response for the entry's certificate.
+ *
+ * Fills in status and dates of staple on success.
+ *
+ * returns 0 on success and OCSP_LOOKUP_FAIL when the response is unusable.
+ */
+static int staple_validate(WOLFSSL_OCSP* ocsp, OcspStapleEntry* e,
+                           OcspStaple* staple)
+{
+#ifdef WOLFSSL_SMALL_STACK
+    CertStatus*   newStatus;
+    OcspEntry*    newSingle;
+    OcspResponse* ocspResponse;
+#else
+    CertStatus    newStatus[1];
+    OcspEntry     newSingle[1];
+    OcspResponse  ocspResponse[1];
+#endif
+    int ret;
+
+#ifdef WOLFSSL_SMALL_STACK
+    newStatus = (CertStatus*)XMALLOC(sizeof(CertStatus), NULL,
+                                                       DYNAMIC_TYPE_OCSP_STATUS);
+    newSingle = (OcspEntry*)XMALLOC(sizeof(OcspEntry), NULL,
+                                                       DYNAMIC_TYPE_OCSP_ENTRY);
+    ocspResponse = (OcspResponse*)XMALLOC(sizeof(OcspResponse), NULL,
+                                                     DYNAMIC_TYPE_OCSP_REQUEST);
+
+    if (newStatus == NULL || newSingle == NULL || ocspResponse == NULL) {
+        XFREE(newStatus, NULL, DYNAMIC_TYPE_OCSP_STATUS);
+        XFREE(newSingle, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
+        XFREE(ocspResponse, NULL, DYNAMIC_TYPE_OCSP_REQUEST);
+        return MEMORY_E;
+    }
+#endif
+    InitOcspResponse(ocspResponse, newSingle, newStatus, staple->resp,
+                     staple->respSz, ocsp->cm->heap);
+    ret = OcspResponseDecode(ocspResponse, ocsp->cm, ocsp->cm->heap, 0, 0);
+    if (ret == 0 && ocspResponse->responseStatus != OCSP_SUCCESSFUL) {
+        WOLFSSL_MSG("OcspResponse status bad");
+        ret = OCSP_LOOKUP_FAIL;
+    }
+    if (ret == 0) {
+        ret = CompareOcspReqResp(&e->req, ocspResponse);
+    }
+    if (ret == 0) {
+        CertStatus* cs = ocspResponse->single->status;
+
+        staple->status = cs->status;
+        XMEMCPY(staple->thisDate, cs->thisDate, MAX_DATE_SIZE);
+        XMEMCPY(staple->nextDate, cs->nextDate, MAX_DATE_SIZE);
+        staple->thisDateFormat = cs->thisDateFormat;
+        staple->nextDateFormat = cs->nextDateFormat;
+    }
+    else {
+        ret = OCSP_LOOKUP_FAIL;
+    }
+
+    FreeOcspResponse(ocspResponse);
+    WC_FREE_VAR_EX(newStatus, NULL, DYNAMIC_TYPE_OCSP_STATUS);
+    WC_FREE_VAR_EX(newSingle, NULL, DYNAMIC_TYPE_OCSP_ENTRY);
+    WC_FREE_VAR_EX(ocspResponse, NULL, DYNAMIC_TYPE_OCSP_REQUEST);
+    return ret;
+}
+
+/* Validate a response and publish it for the entry.
+ *
+ * Must hold cache->lock.
+ *
+ * returns 0 on success.
+ */
+static int staple_set(WOLFSSL_OCSP* ocsp, OcspStapleEntry* e,
+                      const byte* resp, word32 respSz)
+{
+    void* heap = ocsp->cm->heap;
+    OcspStaple staple;
+    int ret;
+    int cur;
+    int next;
+    int zero;
+
+    XMEMSET(&staple, 0, sizeof(staple));
+    staple.resp = (byte*)XMALLOC(respSz, heap, DYNAMIC_TYPE_OCSP_STATUS);
+    if (staple.resp == NULL)
+        return MEMORY_E;
+    XMEMCPY(staple.resp, resp, respSz);
+    staple.respSz = respSz;
+
+    ret = staple_validate(ocsp, e, &staple);
+    if (ret != 0) {
+        XFREE(staple.resp, heap, DYNAMIC_TYPE_OCSP_STATUS);
+        return ret;
+    }
+
+    cur = WOLFSSL_ATOMIC_LOAD(e->cur);
+    next = (cur == 0) ? 1 : 0;
+    /* A reader that picked up this slot before it was retired may not have
+     * noticed yet. Wait for it to back off. */
+    do {
+        zero = 0;
+    } while (!wolfSSL_Atomic_Int_CompareExchange(&e->readers[next], &zero, 0));
+
+    XFREE(e->slot[next].resp, heap, DYNAMIC_TYPE_OCSP_STATUS);
+    XMEMCPY(&e->slot[next], &staple, sizeof(staple));
+    (void)wolfSSL_Atomic_Int_Exchange(&e->cur, next);
+
+    return 0;
+}
+
+/* Whether the entry has no response or one close to its nextUpdate.
+ *
+ * Must hold cache->lock.
+ */
+static int staple_needs_refresh(OcspStapleEntry* e)
+{
+    int i = WOLFSSL_ATOMIC_LOAD(e->cur);
+    OcspStaple* staple;
+
+    if (i < 0)
+        return 1;
+    staple = &e->slot[i];
+    /* No nextUpdate means newer status is always available. */
+    if (staple->nextDate[0] == 0)
+        return 1;
+#ifndef NO_ASN_TIME
+    return !wc_ValidateDateWithTime(staple->nextDate, staple->nextDateFormat,
+                ASN_AFTER, wc_Time(0) + OCSP_STAPLE_REFRESH_MARGIN,
+                MAX_DATE_SIZE);
+#else
+    return 0;
+#endif
+}
+
+/* Allocate the staple cache for this OCSP object.
+ *
+ * Does nothing when there already is one.
+ *
+ * returns 0 on success.
+ */
+int OcspStapleCacheEnable(WOLFSSL_OCSP* ocsp, int maxEntries)
+{
+    OcspStapleCache* cache;
+    void* heap;
+    int i;
+
+    if (ocsp == NULL || maxEntries <= 0 ||
+            maxEntries > OCSP_STAPLE_CACHE_MAX_ENTRIES) {
+        return BAD_FUNC_ARG;
+    }
+    if (ocsp->stapleCache != NULL)
+        return 0;
+
+    heap = ocsp->cm->heap;
+    cache = (OcspStapleCache*)XMALLOC(sizeof(OcspStapleCache) +
+        (size_t)maxEntries * sizeof(OcspStapleEntry), heap, DYNAMIC_TYPE_OCSP);
+    if (cache == NULL)
+        return MEMORY_E;
+    XMEMSET(cache, 0, sizeof(OcspStapleCache) +
+        (size_t)maxEntries * sizeof(OcspStapleEntry));
+
+    if (wc_InitMutex(&cache->lock) != 0) {
+        XFREE(cache, heap, DYNAMIC_TYPE_OCSP);
+        return BAD_MUTEX_E;
+    }
+#ifdef OCSP_STAPLE_REFRESH_THREAD
+    if (pthread_mutex_init(&cache->thrLock, NULL) != 0) {
+        wc_FreeMutex(&cache->lock);
+        XFREE(cache, heap, DYNAMIC_TYPE_OCSP);
+        return BAD_MUTEX_E;
+    }
+    if (pthread_cond_init(&cache->thrCond, NULL) != 0) {
+        pthread_mutex_destroy(&cache->thrLock);
+        wc_FreeMutex(&cache->lock);
+        XFREE(cache, heap, DYNAMIC_TYPE_OCSP);
+        return BAD_COND_E;
+    }
+#endif
+
+    cache->entries = (OcspStapleEntry*)(cache + 1);
+    cache->cap = maxEntries;
+    wolfSSL_Atomic_Int_Init(&cache->count, 0);
+    for (i = 0; i < maxEntries; i++) {
+        wolfSSL_Atomic_Int_Init(&cache->entries[i].cur, -1);
+        wolfSSL_Atomic_Int_Init(&cache->entries[i].readers[0], 0);
+        wolfSSL_Atomic_Int_Init(&cache->entries[i].readers[1], 0);
+    }
+
+    ocsp->stapleCache = cache;
+
+    return 0;
+}
+
+/* Stop the background refresh and dispose of the staple cache. */
+void OcspStapleCacheFree(WOLFSSL_OCSP* ocsp)
+{
+    OcspStapleCache* cache;
+    void* heap;
+    int n;
+    int i;
+
+    if (ocsp == NULL || ocsp->stapleCache == NULL)
+        return;
+
+    (void)OcspStapleCacheStopRefresh(ocsp);
+
+    cache = ocsp->stapleCache;
+    heap = ocsp->cm->heap;
+    n = WOLFSSL_ATOMIC_LOAD(cache->count);
+    for (i = 0; i < n; i++) {
+        FreeOcspRequest(&cache->entries[i].req);
+        XFREE(cache->entries[i].slot[0].resp, heap, DYNAMIC_TYPE_OCSP_STATUS);
+        XFREE(cache->entries[i].slot[1].resp, heap, DYNAMIC_TYPE_OCSP_STATUS);
+    }
+#ifdef OCSP_STAPLE_REFRESH_THREAD
+    pthread_cond_destroy(&cache->thrCond);
+    pthread_mutex_destroy(&cache->thrLock);
+#endif
+    wc_FreeMutex(&cache->lock);
+    XFREE(cache, heap, DYNAMIC_TYPE_OCSP);
+    ocsp->stapleCache = NULL;
+}
+
+/* Track a certificate in the staple cache.
+ *
+ * The certificate's issuer must be loaded to build the request. A certificate
+ * already tracked is not added again.
+ *
+ * returns 0 on success and BUFFER_E when the cache is full.
+ */
+int OcspStapleCacheAdd(WOLFSSL_OCSP* ocsp, const byte* der, word32 derSz)
+{
+    OcspStapleCache* cache;
+    int ret = 0;
+    WC_DECLARE_VAR(cert, DecodedCert, 1, 0);
+    WC_DECLARE_VAR(req, OcspRequest, 1, 0);
+
+    if (ocsp == NULL || ocsp->stapleCache == NULL || der == NULL)
+        return BAD_FUNC_ARG;
+    cache = ocsp->stapleCache;
+
+    WC_ALLOC_VAR_EX(cert, DecodedCert, 1, ocsp->cm->heap, DYNAMIC_TYPE_DCERT,
+        ret = MEMORY_E);
+    if (ret == 0) {
+        WC_ALLOC_VAR_EX(req, OcspRequest, 1, ocsp->cm->heap,
+            DYNAMIC_TYPE_OCSP_REQUEST, ret = MEMORY_E);
+    }
+
+    if (ret == 0) {
+        InitDecodedCert(cert, der, derSz, ocsp->cm->heap);
+        ret = ParseCertRelative(cert, CERT_TYPE, NO_VERIFY, ocsp->cm, NULL);
+        if (ret == 0) {
+            ret = InitOcspRequest(req, cert, 0, ocsp->cm->heap);
+        }
+        FreeDecodedCert(cert);
+    }
+
+    if (ret == 0) {
+        if (wc_LockMutex(&cache->lock) != 0) {
+            ret = BAD_MUTEX_E;
+        }
+        else {
+            int n = WOLFSSL_ATOMIC_LOAD(cache->count);
+
+            if (staple_cache_find(cache, req->issuerHash, req->issuerKeyHash,
+                                  req->serial, req->serialSz) != NULL) {
+                FreeOcspRequest(req);
+            }
+            else if (n >= cache->cap) {
+                WOLFSSL_MSG("OCSP staple cache full");
+                FreeOcspRequest(req);
+                ret = BUFFER_E;
+            }
+            else {
+                /* The entry owns the request from here on. Publish it only once
+                 * it is filled in. */
+                XMEMCPY(&cache->entries[n].req, req, sizeof(OcspRequest));
+                WOLFSSL_ATOMIC_STORE(cache->count, n + 1);
+            }
+            wc_UnLockMutex(&cache->lock);
+        }
+    }
+
+    WC_FREE_VAR_EX(req, ocsp->cm->heap, DYNAMIC_TYPE_OCSP_REQUEST);
+    WC_FREE_VAR_EX(cert, ocsp->cm->heap, DYNAMIC_TYPE_DCERT);
+    return ret;
+}
+
+/* Fetch new responses for the tracked certificates.
+ *
+ * Only fetches for certificates with no response or with one due to expire
+ * within OCSP_STAPLE_REFRESH_MARGIN seconds, unless force is set. A failed
+ * fetch leaves the previous response in place.
+ *
+ * returns the number of certificates with a current response on success.
+ */
+int OcspStapleCacheRefresh(WOLFSSL_OCSP* ocsp, int force)
+{
+    OcspStapleCache* cache;
+    int ready = 0;
+    int n;
+    int i;
+
+    if (ocsp == NULL || ocsp->stapleCache == NULL)
+        return BAD_FUNC_ARG;
+    cache = ocsp->stapleCache;
+
+    if (wc_LockMutex(&cache->lock) != 0)
+        return BAD_MUTEX_E;
+
+    n = WOLFSSL_ATOMIC_LOAD(cache->count);
+    for (i = 0; i < n; i++) {
+        OcspStapleEntry* e = &cache->entries[i];
+        int cur;
+
+        if (force || staple_needs_refresh(e)) {
+            byte* response = NULL;
+            int   responseSz = 0;
+            int   ret;
+
+            ret = OcspRequestIO(ocsp, &e->req, ocsp->cm->ocspIOCtx, &response,
+                                &responseSz);
+            if (ret == 0) {
+                ret = staple_set(ocsp, e, response, (word32)responseSz);
+            }
+            if (ret != 0) {
+                WOLFSSL_MSG_EX("OCSP staple refresh failed: %d", ret);
+            }
+            if (response != NULL && ocsp->cm->ocspRespFreeCb)
+                ocsp->cm->ocspRespFreeCb(ocsp->cm->ocspIOCtx, response);
+        }
+
+        cur = WOLFSSL_ATOMIC_LOAD(e->cur);
+        if (cur >= 0 && staple_current(&e->slot[cur]))
+            ready++;
+    }
+
+    wc_UnLockMutex(&cache->lock);
+
+    return ready;
+}
+
+#ifdef OCSP_STAPLE_REFRESH_THREAD
+static THREAD_RETURN WOLFSSL_THREAD staple_refresh_thread(void* arg)
+{
+    WOLFSSL_OCSP*    ocsp = (WOLFSSL_OCSP*)arg;
+    OcspStapleCache* cache = ocsp->stapleCache;
+    struct timespec  ts;
+
+    pthread_mutex_lock(&cache->thrLock);
+    while (!cache->stop) {
+        pthread_mutex_unlock(&cache->thrLock);
+        (void)OcspStapleCacheRefresh(ocsp, 0);
+        pthread_mutex_lock(&cache->thrLock);
+
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += (time_t)cache->interval;
+        while (!cache->stop) {
+            if (pthread_cond_timedwait(&cache->thrCond, &cache->thrLock,
+                                       &ts) == ETIMEDOUT) {
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&cache->thrLock);
+
+    WOLFSSL_RETURN_FROM_THREAD(0);
+}
+#endif
+
+/* Start a thread that refreshes the cache every interval seconds.
+ *
+ * Changes the interval when the thread is already running.
+ *
+ * returns 0 on success and NOT_COMPILED_IN without POSIX threads.
+ */
+int OcspStapleCacheStartRefresh(WOLFSSL_OCSP* ocsp, word32 interval)
+{
+#ifdef OCSP_STAPLE_REFRESH_THREAD
+    OcspStapleCache* cache;
+    int ret = 0;
+
+    if (ocsp == NULL || ocsp->stapleCache == NULL || interval == 0)
+        return BAD_FUNC_ARG;
+    cache = ocsp->stapleCache;
+
+    if (pthread_mutex_lock(&cache->thrLock) != 0)
+        return BAD_MUTEX_E;
+    cache->interval = interval;
+    if (!cache->running) {
+        cache->stop = 0;
+        ret = wolfSSL_NewThread(&cache->thread, staple_refresh_thread, ocsp);
+        if (ret == 0)
+            cache->running = 1;
+    }
+    pthread_mutex_unlock(&cache->thrLock);
+
+    return ret;
+#else
+    (void)ocsp;
+    (void)interval;
+    return NOT_COMPILED_IN;
+#endif
+}
+
+/* Stop the background refresh thread and wait for it to exit.
+ *
+ * returns 0 on success, including when no thread is running.
+ */
+int OcspStapleCacheStopRefresh(WOLFSSL_OCSP* ocsp)
+{
+#ifdef OCSP_STAPLE_REFRESH_THREAD
+    OcspStapleCache* cache;
+    int running;
+
+    if (ocsp == NULL || ocsp->stapleCache == NULL)
+        return BAD_FUNC_ARG;
+    cache = ocsp->stapleCache;
+
+    if (pthread_mutex_lock(&cache->thrLock) != 0)
+        return BAD_MUTEX_E;
+    running = cache->running;
+    cache->stop = 1;
+    pthread_cond_signal(&cache->thrCond);
+    pthread_mutex_unlock(&cache->thrLock);
+
+    if (running) {
+        (void)wolfSSL_JoinThread(cache->thread);
+        cache->running = 0;
+    }
+
+    return 0;
+#else
+    if (ocsp == NULL || ocsp->stapleCache == NULL)
+        return BAD_FUNC_ARG;
+    return 0;
+#endif
+}
+
+/* Size of the cache when persisted. Must hold cache->lock. */
+static int staple_cache_mem_size(OcspStapleCache* cache)
+{
+    int n = WOLFSSL_ATOMIC_LOAD(cache->count);
+    int sz = OCSP_STAPLE_CACHE_HDR_SZ;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        OcspStapleEntry* e = &cache->entries[i];
+        int cur = WOLFSSL_ATOMIC_LOAD(e->cur);
+
+        if (cur >= 0) {
+            sz += 2 * OCSP_DIGEST_SIZE + OPAQUE8_LEN + e->req.serialSz +
+                  OPAQUE32_LEN + (int)e->slot[cur].respSz;
+        }
+    }
+
+    return sz;
+}
+
+/* Calculate size of the staple cache when persisted to memory.
+ *
+ * returns number of bytes on success.
+ */
+int OcspStapleCacheGetMemSize(WOLFSSL_OCSP* ocsp)
+{
+    int ret;
+
+    if (ocsp == NULL || ocsp->stapleCache == NULL)
+        return BAD_FUNC_ARG;
+
+    if (wc_LockMutex(&ocsp->stapleCache->lock) != 0)
+        return BAD_MUTEX_E;
+    ret = staple_cache_mem_size(ocsp->stapleCache);
+    wc_UnLockMutex(&ocsp->stapleCache->lock);
+
+    return ret;
+}
+
+/* Persist the cached responses to memory.
+ *
+ * Each certificate is stored by its CertID, so a restore matches responses to
+ * certificates however the cache was filled.
+ *
+ * returns WOLFSSL_SUCCESS on success and BUFFER_E when memory is too small.
+ */
+int OcspStapleCacheMemSave(WOLFSSL_OCSP* ocsp, void* mem, int sz, int* used)
+{
+    OcspStapleCache* cache;
+    byte* out = (byte*)mem;
+    int   ret = WOLFSSL_SUCCESS;
+    int   realSz;
+    int   n;
+    int   i;
+    word32 cnt = 0;
+
+    if (ocsp == NULL || ocsp->stapleCache == NULL || mem == NULL || used == NULL)
+        return BAD_FUNC_ARG;
+    cache = ocsp->stapleCache;
+
+    if (wc_LockMutex(&cache->lock) != 0)
+        return BAD_MUTEX_E;
+
+    realSz = staple_cache_mem_size(cache);
+    if (realSz > sz) {
+        WOLFSSL_MSG("Mem output buffer too small");
+        ret = BUFFER_E;
+    }
+    if (ret == WOLFSSL_SUCCESS) {
+        int idx = OCSP_STAPLE_CACHE_HDR_SZ;
+
+        n = WOLFSSL_ATOMIC_LOAD(cache->count);
+        for (i = 0; i < n; i++) {
+            OcspStapleEntry* e = &cache->entries[i];
+            int cur = WOLFSSL_ATOMIC_LOAD(e->cur);
+
+            if (cur < 0)
+                continue;
+            XMEMCPY(out + idx, e->req.issuerHash, OCSP_DIGEST_SIZE);
+            idx += OCSP_DIGEST_SIZE;
+            XMEMCPY(out + idx, e->req.issuerKeyHash, OCSP_DIGEST_SIZE);
+            idx += OCSP_DIGEST_SIZE;
+            out[idx++] = (byte)e->req.serialSz;
+            XMEMCPY(out + idx, e->req.serial, (size_t)e->req.serialSz);
+            idx += e->req.serialSz;
+            c32toa(e->slot[cur].respSz, out + idx);
+            idx += OPAQUE32_LEN;
+            XMEMCPY(out + idx, e->slot[cur].resp, e->slot[cur].respSz);
+            idx += (int)e->slot[cur].respSz;
+            cnt++;
+        }
+
+        c32toa(OCSP_STAPLE_CACHE_VERSION, out);
+        c32toa(OCSP_DIGEST_SIZE, out + OPAQUE32_LEN);
+        c32toa(cnt, out + 2 * OPAQUE32_LEN);
+        *used = idx;
+    }
+
+    wc_UnLockMutex(&cache->lock);
+
+    return ret;
+}
+
+/* Restore cached responses from memory.
+ *
+ * Responses are verified again as if just fetched. Those for certificates not
+ * tracked by this cache, and those that fail to verify or have expired, are
+ * skipped.
+ *
+ * returns WOLFSSL_SUCCESS on success, BUFFER_E when the data is truncated and
+ * CACHE_MATCH_ERROR when it was saved by an incompatible build.
+ */
+int OcspStapleCacheMemRestore(WOLFSSL_OCSP* ocsp, const void* mem, int sz)
+{
+    OcspStapleCache* cache;
+    const byte* in = (const byte*)mem;
+    int    ret = WOLFSSL_SUCCESS;
+    word32 version;
+    word32 digestSz;
+    word32 cnt;
+    word32 i;
+    int    idx = OCSP_STAPLE_CACHE_HDR_SZ;
+
+    if (ocsp == NULL || ocsp->stapleCache == NULL || mem == NULL || sz <= 0)
+        return BAD_FUNC_ARG;
+    cache = ocsp->stapleCache;
+
+    if (sz < OCSP_STAPLE_CACHE_HDR_SZ) {
+        WOLFSSL_MSG("OCSP staple cache memory buffer too small");
+        return BUFFER_E;
+    }
+    ato32(in, &version);
+    ato32(in + OPAQUE32_LEN, &digestSz);
+    ato32(in + 2 * OPAQUE32_LEN, &cnt);
+    if (version != OCSP_STAPLE_CACHE_VERSION || digestSz != OCSP_DIGEST_SIZE) {
+        WOLFSSL_MSG("OCSP staple cache memory header mismatch");
+        return CACHE_MATCH_ERROR;
+    }
+
+    if (wc_LockMutex(&cache->lock) != 0)
+        return BAD_MUTEX_E;
+
+    for (i = 0; i < cnt; i++) {
+        const byte* issuerHash;
+        const byte* issuerKeyHash;
+        const byte* serial;
+        int    serialSz;
+        word32 respSz;
+        OcspStapleEntry* e;
+
+        if (idx + 2 * OCSP_DIGEST_SIZE + OPAQUE8_LEN > sz) {
+            ret = BUFFER_E;
+            break;
+        }
+        issuerHash = in + idx;
+        idx += OCSP_DIGEST_SIZE;
+        issuerKeyHash = in + idx;
+        idx += OCSP_DIGEST_SIZE;
+        serialSz = in[idx++];
+        if (idx + serialSz + OPAQUE32_LEN > sz) {
+            ret = BUFFER_E;
+            break;
+        }
+        serial = in + idx;
+        idx += serialSz;
+        ato32(in + idx, &respSz);
+        idx += OPAQUE32_LEN;
+        if (respSz > (word32)(sz - idx)) {
+            ret = BUFFER_E;
+            break;
+        }
+
+        e = staple_cache_find(cache, issuerHash, issuerKeyHash, serial,
+                              serialSz);
+        if (e != NULL && staple_set(ocsp, e, in + idx, respSz) != 0) {
+            WOLFSSL_MSG("Skipping OCSP staple that failed to verify");
+        }
+        idx += (int)respSz;
+    }
+
+    wc_UnLockMutex(&cache->lock);
+
+    return ret;
+}
+
+#endif /* WOLFSSL_OCSP_STAPLE_CACHE */
+
+/* 0 on success */
 int CheckOcspRequest(WOLFSSL_OCSP* ocsp, OcspRequest* ocspRequest,
                      buffer* responseBuffer, WOLFSSL* ssl)
 {
     OcspEntry*  entry          = NULL;
     CertStatus* status         = NULL;
-    byte*       request        = NULL;
-    int         requestSz      = OCSP_MAX_REQUEST_SZ;
     int         responseSz     = 0;
     byte*       response       = NULL;
-    const char* url            = NULL;
-    int         urlSz          = 0;
     int         ret            = -1;
     void*       ioCtx;
     /* Hint for responseBuffer only, which the caller frees against the same
@@ -509,6 +1375,17 @@ int CheckOcspRequest(WOLFSSL_OCSP* ocsp, OcspRequest* ocspRequest,
         responseBuffer->length = 0;
     }
 
+#ifdef WOLFSSL_OCSP_STAPLE_CACHE
+    /* Stapling a prefetched response needs no lock and no round trip. Fall
+     * back to fetching on demand when the cache has nothing current. */
+    if (responseBuffer != NULL && ocsp->stapleCache != NULL) {
+        ret = OcspStapleCacheGet(ocsp->stapleCache, ocspRequest,
+                                 responseBuffer, heap);
+        if (ret != WC_NO_ERR_TRACE(OCSP_INVALID_STATUS))
+            return ret;
+    }
+#endif
+
     ret = GetOcspEntry(ocsp, ocspRequest, &entry);
     if (ret != 0)
         return ret;
@@ -527,47 +1404,17 @@ int CheckOcspRequest(WOLFSSL_OCSP* ocsp, OcspRequest* ocspRequest,
     ioCtx = (ssl && ssl->ocspIOCtx != NULL) ?
                                         ssl->ocspIOCtx : ocsp->cm->ocspIOCtx;
 
-    if (ocsp->cm->ocspUseOverrideURL) {
-        url = ocsp->cm->ocspOverrideURL;
-        if (url != NULL && url[0] != '\0')
-            urlSz = (int)XSTRLEN(url);
-        else
-            return OCSP_NEED_URL;
-    }
-    else if (ocspRequest->urlSz != 0 && ocspRequest->url != NULL) {
-        url = (const char *)ocspRequest->url;
-        urlSz = ocspRequest->urlSz;
-    }
-    else {
-        /* Cert advertises no OCSP responder and no override URL is set, so
-         * OCSP has no opinion on this cert. Report that distinctly from a
-         * failed lookup; the caller owns the policy decision. Callers wanting
-         * the historical soft-fail run this through OcspNoUrlPolicy(). */
-        WOLFSSL_MSG("Cert has no OCSP URL");
-        return OCSP_NO_URL;
+    ret = OcspRequestIO(ocsp, ocspRequest, ioCtx, &response, &responseSz);
+    if (ret == WC_NO_ERR_TRACE(OCSP_NEED_URL) ||
+            ret == WC_NO_ERR_TRACE(OCSP_NO_URL)) {
+        return ret;
     }
-
-    request = (byte*)XMALLOC((size_t)requestSz, ocsp->cm->heap, DYNAMIC_TYPE_OCSP);
-    if (request == NULL) {
+    if (ret == WC_NO_ERR_TRACE(MEMORY_ERROR)) {
         WOLFSSL_LEAVE("CheckOcspRequest", MEMORY_ERROR);
         return MEMORY_ERROR;
     }
 
-    requestSz = EncodeOcspRequest(ocspRequest, request, (word32)requestSz);
-    if (requestSz > 0 && ocsp->cm->ocspIOCb) {
-        responseSz = ocsp->cm->ocspIOCb(ioCtx, url, urlSz,
-                                        request, requestSz, &response);
-    }
-    if (responseSz == WC_NO_ERR_TRACE(WOLFSSL_CBIO_ERR_WANT_READ)) {
-        ret = OCSP_WANT_READ;
-    }
-    else if (responseSz == WC_NO_ERR_TRACE(WOLFSSL_CBIO_ERR_TIMEOUT)){
-        ret = HTTP_TIMEOUT;
-    }
-
-    XFREE(request, ocsp->cm->heap, DYNAMIC_TYPE_OCSP);
-
-    if (responseSz >= 0 && response) {
+    if (ret == 0) {
         ret = CheckOcspResponse(ocsp, response, responseSz, responseBuffer, status,
                             entry, ocspRequest, heap, ssl);
     }
@@ -378,6 +378,9 @@ static const char* const msgTable[] =
 
     /* 99 */
     "Invalid or missing keylog file",
+
+    /* 100 */
+    "Sniffer pipeline thread error",
 };
 
 
@@ -485,6 +488,11 @@ typedef struct FinCapture {
 } FinCapture;
 
 
+#ifdef WOLFSSL_LAZY_HS_HASHES
+/* Messages are kept in a transcript, as the WOLFSSL objects keep them, and
+ * handed over for hashing with the hashes the session needs. */
+typedef HS_Hashes HsHashes;
+#else
 typedef struct HsHashes {
 #ifndef NO_OLD_TLS
 #ifndef NO_SHA
@@ -501,6 +509,21 @@ typedef struct HsHashes {
     wc_Sha384 hashSha384;
 #endif
 } HsHashes;
+#endif /* WOLFSSL_LAZY_HS_HASHES */
+
+#ifdef HAVE_EXTENDED_MASTER
+static void HashFree(HsHashes* hash)
+{
+#ifdef WOLFSSL_LAZY_HS_HASHES
+    Free_HS_Hashes(hash, NULL);
+#else
+    if (hash != NULL) {
+        XMEMSET(hash, 0, sizeof(HsHashes));
+        XFREE(hash, NULL, DYNAMIC_TYPE_HASHES);
+    }
+#endif
+}
+#endif
 
 typedef struct KeyShareInfo {
     word16      named_group;
@@ -607,6 +630,16 @@ static WC_THREADSHARED void*     ConnectionCbCtx = NULL;
 /* Sessions Statistics */
 static WC_THREADSHARED SSLStats SnifferStats;
 static WC_THREADSHARED wolfSSL_Mutex StatsMutex WOLFSSL_MUTEX_INITIALIZER_CLAUSE(StatsMutex);
+#ifdef WOLFSSL_SNIFFER_PIPELINE
+/* A pipeline shard thread counts into its own statistics, they are merged
+ * with SnifferStats when read. Running pipelines are listed under
+ * StatsMutex. */
+static THREAD_LS_T SSLStats* ShardStats = NULL;
+#ifndef HAVE_C___ATOMIC
+static THREAD_LS_T wolfSSL_Mutex* ShardStatsMutex = NULL;
+#endif
+static WC_THREADSHARED SSLSnifferPipeline* StatsPipelines = NULL;
+#endif
 #endif
 
 #ifdef WOLFSSL_SNIFFER_KEY_CALLBACK
@@ -636,15 +669,25 @@ static void UpdateMissedDataSessions(void)
 #endif
 
 #ifdef WOLFSSL_SNIFFER_STATS
+    /* statistics the calling thread counts into */
+    #ifdef WOLFSSL_SNIFFER_PIPELINE
+        #define CUR_STATS() (ShardStats != NULL ? ShardStats : &SnifferStats)
+        #define CUR_STATS_MUTEX() \
+            (ShardStatsMutex != NULL ? ShardStatsMutex : &StatsMutex)
+    #else
+        #define CUR_STATS() (&SnifferStats)
+        #define CUR_STATS_MUTEX() (&StatsMutex)
+    #endif
     #ifdef HAVE_C___ATOMIC
         #define LOCK_STAT() WC_DO_NOTHING
         #define UNLOCK_STAT() WC_DO_NOTHING
         #define NOLOCK_ADD_TO_STAT(x,y) ({ TraceStat(#x, y); \
-            __atomic_fetch_add(&x, y, __ATOMIC_RELAXED); })
+            __atomic_fetch_add(&CUR_STATS()->x, y, __ATOMIC_RELAXED); })
     #else
-        #define LOCK_STAT() wc_LockMutex(&StatsMutex)
-        #define UNLOCK_STAT() wc_UnLockMutex(&StatsMutex)
-        #define NOLOCK_ADD_TO_STAT(x,y) ({ TraceStat(#x, y); x += y; })
+        #define LOCK_STAT() wc_LockMutex(CUR_STATS_MUTEX())
+        #define UNLOCK_STAT() wc_UnLockMutex(CUR_STATS_MUTEX())
+        #define NOLOCK_ADD_TO_STAT(x,y) ({ TraceStat(#x, y); \
+            CUR_STATS()->x += y; })
     #endif
     #define NOLOCK_INC_STAT(x) NOLOCK_ADD_TO_STAT(x,1)
     #define ADD_TO_STAT(x,y) do { LOCK_STAT(); \
@@ -859,7 +902,7 @@ static void FreeSnifferSession(SnifferSession* session)
 
         XFREE(session->ticketID, NULL, DYNAMIC_TYPE_SNIFFER_TICKET_ID);
 #ifdef HAVE_EXTENDED_MASTER
-        XFREE(session->hash, NULL, DYNAMIC_TYPE_HASHES);
+        HashFree(session->hash);
 #endif
 #ifdef WOLFSSL_TLS13
         XFREE(session->cliKeyShare, NULL, DYNAMIC_TYPE_TMP_BUFFER);
@@ -873,8 +916,8 @@ static void FreeSnifferSession(SnifferSession* session)
 }
 
 
-/* Free overall Sniffer */
-void ssl_FreeSniffer(void)
+/* Free the calling thread's session and server tables */
+static void FreeSnifferTables(void)
 {
     SnifferServer*  srv;
     SnifferServer*  removeServer;
@@ -914,8 +957,14 @@ void ssl_FreeSniffer(void)
 #if defined(WOLFSSL_SNIFFER_KEYLOGFILE)
     freeSecretList();
 #endif /* WOLFSSL_SNIFFER_KEYLOGFILE */
+}
 
 
+/* Free overall Sniffer */
+void ssl_FreeSniffer(void)
+{
+    FreeSnifferTables();
+
 #ifndef WOLFSSL_MUTEX_INITIALIZER
 #ifndef WOLFSSL_SNIFFER_NO_RECOVERY
     wc_FreeMutex(&RecoveryMutex);
@@ -956,6 +1005,7 @@ static int HashInit(HsHashes* hash)
 
     XMEMSET(hash, 0, sizeof(HsHashes));
 
+#ifndef WOLFSSL_LAZY_HS_HASHES
 #ifndef NO_OLD_TLS
 #ifndef NO_SHA
     if (ret == 0)
@@ -974,6 +1024,7 @@ static int HashInit(HsHashes* hash)
     if (ret == 0)
         ret = wc_InitSha384(&hash->hashSha384);
 #endif
+#endif /* !WOLFSSL_LAZY_HS_HASHES */
 
     return ret;
 }
@@ -985,6 +1036,9 @@ static int HashUpdate(HsHashes* hash, const byte* input, int sz)
     input -= HANDSHAKE_HEADER_SZ;
     sz += HANDSHAKE_HEADER_SZ;
 
+#ifdef WOLFSSL_LAZY_HS_HASHES
+    ret = HashTranscriptAdd(hash, NULL, input, (word32)sz);
+#else
 #ifndef NO_OLD_TLS
 #ifndef NO_SHA
     if (ret == 0)
@@ -1003,12 +1057,19 @@ static int HashUpdate(HsHashes* hash, const byte* input, int sz)
     if (ret == 0)
         ret = wc_Sha384Update(&hash->hashSha384, input, sz);
 #endif
+#endif /* WOLFSSL_LAZY_HS_HASHES */
 
     return ret;
 }
 
-static int HashCopy(HS_Hashes* d, HsHashes* s)
+static int HashCopy(WOLFSSL* ssl, HsHashes* s)
 {
+#ifdef WOLFSSL_LAZY_HS_HASHES
+    /* Hashes the session needs are started from the transcript on use. */
+    return InitHandshakeHashesAndCopy(ssl, s, &ssl->hsHashes);
+#else
+    HS_Hashes* d = ssl->hsHashes;
+
 #ifndef NO_OLD_TLS
 #ifndef NO_SHA
     XMEMCPY(&d->hashSha, &s->hashSha, sizeof(wc_Sha));
@@ -1025,6 +1086,7 @@ static int HashCopy(HS_Hashes* d, HsHashes* s)
 #endif
 
     return 0;
+#endif /* WOLFSSL_LAZY_HS_HASHES */
 }
 
 #endif
@@ -3304,7 +3366,7 @@ exit_sk:
 
 #ifdef WOLFSSL_SNIFFER_STATS
     if (ret < 0)
-        INC_STAT(SnifferStats.sslKeyFails);
+        INC_STAT(sslKeyFails);
 #endif
 
     /* Final cleanup */
@@ -3583,7 +3645,7 @@ static int ProcessSessionTicket(const byte* input, int* sslBytes,
                 SetupSession(session->sslServer);
                 AddSession(session->sslServer); /* don't re add */
             #ifdef WOLFSSL_SNIFFER_STATS
-                INC_STAT(SnifferStats.sslResumptionInserts);
+                INC_STAT(sslResumptionInserts);
             #endif
             }
     #ifdef SNIFFER_SINGLE_SESSION_CACHE
@@ -3639,7 +3701,7 @@ static int DoResume(SnifferSession* session, char* error)
                                     session->sslServer->arrays->masterSecret, 0);
         if (resume == NULL) {
         #ifdef WOLFSSL_SNIFFER_STATS
-            INC_STAT(SnifferStats.sslResumeMisses);
+            INC_STAT(sslResumeMisses);
         #endif
             SetError(BAD_SESSION_RESUME_STR, error, session, FATAL_ERROR_STATE);
             return WOLFSSL_FATAL_ERROR;
@@ -3662,7 +3724,7 @@ static int DoResume(SnifferSession* session, char* error)
 
     Trace(SERVER_DID_RESUMPTION_STR);
 #ifdef WOLFSSL_SNIFFER_STATS
-    INC_STAT(SnifferStats.sslResumedConns);
+    INC_STAT(sslResumedConns);
 #endif
     if (SetCipherSpecs(session->sslServer) != 0) {
         SetError(BAD_CIPHER_SPEC_STR, error, session, FATAL_ERROR_STATE);
@@ -3808,7 +3870,7 @@ static int ProcessServerHello(int msgSz, const byte* input, int* sslBytes,
             suitesSz--;
         }
         if (!match)
-            INC_STAT(SnifferStats.sslCiphersUnsupported);
+            INC_STAT(sslCiphersUnsupported);
     }
 #endif /* WOLFSSL_SNIFFER_STATS */
 
@@ -3972,7 +4034,7 @@ static int ProcessServerHello(int msgSz, const byte* input, int* sslBytes,
 
 #ifdef HAVE_EXTENDED_MASTER
     if (!session->flags.expectEms) {
-        XFREE(session->hash, NULL, DYNAMIC_TYPE_HASHES);
+        HashFree(session->hash);
         session->hash = NULL;
     }
 #endif
@@ -4039,7 +4101,7 @@ static int ProcessServerHello(int msgSz, const byte* input, int* sslBytes,
     }
     else {
 #ifdef WOLFSSL_SNIFFER_STATS
-        INC_STAT(SnifferStats.sslStandardConns);
+        INC_STAT(sslStandardConns);
 #endif
     }
 
@@ -4474,14 +4536,14 @@ static int KeyWatchCall(SnifferSession* session, const byte* data, int dataSz,
             data, dataSz, WatchCbCtx, error);
     if (ret != 0) {
 #ifdef WOLFSSL_SNIFFER_STATS
-        INC_STAT(SnifferStats.sslKeysUnmatched);
+        INC_STAT(sslKeysUnmatched);
 #endif
         SetError(WATCH_FAIL_STR, error, session, FATAL_ERROR_STATE);
         ret = WOLFSSL_FATAL_ERROR;
     }
     else {
 #ifdef WOLFSSL_SNIFFER_STATS
-        INC_STAT(SnifferStats.sslKeyMatches);
+        INC_STAT(sslKeyMatches);
 #endif
     }
     return ret;
@@ -4582,7 +4644,7 @@ static int ProcessFinished(const byte* input, int size, int* sslBytes,
                 SetupSession(session->sslServer);
                 AddSession(session->sslServer); /* don't re add */
             #ifdef WOLFSSL_SNIFFER_STATS
-                INC_STAT(SnifferStats.sslResumptionInserts);
+                INC_STAT(sslResumptionInserts);
             #endif
             }
             #ifdef SNIFFER_SINGLE_SESSION_CACHE
@@ -4806,7 +4868,7 @@ static int DoHandShake(const byte* input, int* sslBytes,
                 ret = WOLFSSL_FATAL_ERROR;
 
 #if defined(WOLFSSL_SNIFFER_STATS)
-                INC_STAT(SnifferStats.sslEphemeralMisses);
+                INC_STAT(sslEphemeralMisses);
 #endif /* WOLFSSL_SNIFFER_STATS */
             }
             break;
@@ -4818,7 +4880,7 @@ static int DoHandShake(const byte* input, int* sslBytes,
             Trace(GOT_CERT_STR);
             if (session->flags.side == WOLFSSL_SERVER_END) {
 #ifdef WOLFSSL_SNIFFER_STATS
-                INC_STAT(SnifferStats.sslClientAuthConns);
+                INC_STAT(sslClientAuthConns);
 #endif
             }
 #ifdef WOLFSSL_SNIFFER_WATCH
@@ -4843,10 +4905,8 @@ static int DoHandShake(const byte* input, int* sslBytes,
                 /* on async reentry the session->hash is already copied
                  * and free'd */
                 if (session->hash != NULL) {
-                    if (HashCopy(session->sslServer->hsHashes,
-                                session->hash) == 0 &&
-                        HashCopy(session->sslClient->hsHashes,
-                                session->hash) == 0) {
+                    if (HashCopy(session->sslServer, session->hash) == 0 &&
+                        HashCopy(session->sslClient, session->hash) == 0) {
 
                         session->sslServer->options.haveEMS = 1;
                         session->sslClient->options.haveEMS = 1;
@@ -4856,8 +4916,7 @@ static int DoHandShake(const byte* input, int* sslBytes,
                                 session, FATAL_ERROR_STATE);
                         ret = WOLFSSL_FATAL_ERROR;
                     }
-                    XMEMSET(session->hash, 0, sizeof(HsHashes));
-                    XFREE(session->hash, NULL, DYNAMIC_TYPE_HASHES);
+                    HashFree(session->hash);
                     session->hash = NULL;
                 }
             }
@@ -5350,7 +5409,7 @@ static SnifferSession* CreateSession(IpInfo* ipInfo, TcpInfo* tcpInfo,
         }
         if (HashInit(newHash) != 0) {
             SetError(EXTENDED_MASTER_HASH_STR, error, NULL, 0);
-            XFREE(newHash, NULL, DYNAMIC_TYPE_HASHES);
+            HashFree(newHash);
             XFREE(session, NULL, DYNAMIC_TYPE_SNIFFER_SESSION);
             return NULL;
         }
@@ -5635,7 +5694,7 @@ static int CheckSession(IpInfo* ipInfo, TcpInfo* tcpInfo, int sslBytes,
 
         TraceClientSyn(tcpInfo->sequence);
 #ifdef WOLFSSL_SNIFFER_STATS
-        INC_STAT(SnifferStats.sslEncryptedConns);
+        INC_STAT(sslEncryptedConns);
 #endif
         *session = CreateSession(ipInfo, tcpInfo, error);
         if (*session == NULL) {
@@ -5662,8 +5721,8 @@ static int CheckSession(IpInfo* ipInfo, TcpInfo* tcpInfo, int sslBytes,
 
 #ifdef WOLFSSL_SNIFFER_STATS
             LOCK_STAT();
-            NOLOCK_INC_STAT(SnifferStats.sslDecryptedPackets);
-            NOLOCK_ADD_TO_STAT(SnifferStats.sslDecryptedBytes, sslBytes);
+            NOLOCK_INC_STAT(sslDecryptedPackets);
+            NOLOCK_ADD_TO_STAT(sslDecryptedBytes, sslBytes);
             UNLOCK_STAT();
 #endif
 
@@ -6078,7 +6137,7 @@ static int FindNextRecordInAssembly(SnifferSession* session,
 
         Trace(DROPPING_LOST_FRAG_STR);
 #ifdef WOLFSSL_SNIFFER_STATS
-        INC_STAT(SnifferStats.sslDecodeFails);
+        INC_STAT(sslDecodeFails);
 #endif
         prev = curr;
         curr = curr->next;
@@ -6484,12 +6543,12 @@ doMessage:
 
 #ifdef WOLFSSL_SNIFFER_STATS
         if (errCode != 0) {
-            INC_STAT(SnifferStats.sslKeyFails);
+            INC_STAT(sslKeyFails);
         }
         else {
             LOCK_STAT();
-            NOLOCK_INC_STAT(SnifferStats.sslDecryptedPackets);
-            NOLOCK_ADD_TO_STAT(SnifferStats.sslDecryptedBytes, sslBytes);
+            NOLOCK_INC_STAT(sslDecryptedPackets);
+            NOLOCK_ADD_TO_STAT(sslDecryptedBytes, sslBytes);
             UNLOCK_STAT();
         }
 #endif
@@ -6663,7 +6722,7 @@ doPart:
         case alert:
             Trace(GOT_ALERT_STR);
 #ifdef WOLFSSL_SNIFFER_STATS
-            INC_STAT(SnifferStats.sslAlerts);
+            INC_STAT(sslAlerts);
 #endif
             sslFrame += rhSize;
             sslBytes -= rhSize;
@@ -6862,12 +6921,12 @@ static int ssl_DecodePacketInternal(const byte* packet, int length, int isChain,
 #ifdef WOLFSSL_SNIFFER_STATS
         if (sslBytes > 0) {
             LOCK_STAT();
-            NOLOCK_INC_STAT(SnifferStats.sslEncryptedPackets);
-            NOLOCK_ADD_TO_STAT(SnifferStats.sslEncryptedBytes, sslBytes);
+            NOLOCK_INC_STAT(sslEncryptedPackets);
+            NOLOCK_ADD_TO_STAT(sslEncryptedBytes, sslBytes);
             UNLOCK_STAT();
         }
         else {
-            INC_STAT(SnifferStats.sslDecryptedPackets);
+            INC_STAT(sslDecryptedPackets);
         }
 #endif
         ret = 0;
@@ -6889,7 +6948,7 @@ static int ssl_DecodePacketInternal(const byte* packet, int length, int isChain,
     }
     else if (ret ==  1) {
 #ifdef WOLFSSL_SNIFFER_STATS
-        INC_STAT(SnifferStats.sslDecryptedPackets);
+        INC_STAT(sslDecryptedPackets);
 #endif
         ret = 0;
         goto exit_decode; /* done for now */
@@ -6910,7 +6969,7 @@ static int ssl_DecodePacketInternal(const byte* packet, int length, int isChain,
     }
     else if (ret ==  1) {
 #ifdef WOLFSSL_SNIFFER_STATS
-        INC_STAT(SnifferStats.sslDecryptedPackets);
+        INC_STAT(sslDecryptedPackets);
 #endif
         ret = 0;
         goto exit_decode; /* done for now */
@@ -6933,12 +6992,12 @@ static int ssl_DecodePacketInternal(const byte* packet, int length, int isChain,
     {
         if (sslBytes > 0) {
             LOCK_STAT();
-            NOLOCK_INC_STAT(SnifferStats.sslEncryptedPackets);
-            NOLOCK_ADD_TO_STAT(SnifferStats.sslEncryptedBytes, sslBytes);
+            NOLOCK_INC_STAT(sslEncryptedPackets);
+            NOLOCK_ADD_TO_STAT(sslEncryptedBytes, sslBytes);
             UNLOCK_STAT();
         }
         else {
-            INC_STAT(SnifferStats.sslDecryptedPackets);
+            INC_STAT(sslDecryptedPackets);
         }
     }
 #endif
@@ -7053,6 +7112,443 @@ int ssl_DecodePacketWithChainSessionInfoStoreData(void* vChain, word32 chainSz,
 #endif
 
 
+#ifdef WOLFSSL_SNIFFER_STATS
+/* Add the counters of stats to total and zero them when reset. */
+static void SnifferStatsAdd(SSLStats* total, SSLStats* stats, int reset)
+{
+    unsigned long int* t = (unsigned long int*)total;
+    unsigned long int* c = (unsigned long int*)stats;
+    size_t i;
+
+    for (i = 0; i < sizeof(SSLStats) / sizeof(*c); i++) {
+    #ifdef HAVE_C___ATOMIC
+        if (reset)
+            t[i] += __atomic_exchange_n(&c[i], 0, __ATOMIC_RELAXED);
+        else
+            t[i] += __atomic_load_n(&c[i], __ATOMIC_RELAXED);
+    #else
+        t[i] += c[i];
+        if (reset)
+            c[i] = 0;
+    #endif
+    }
+}
+#endif /* WOLFSSL_SNIFFER_STATS */
+
+
+#ifdef WOLFSSL_SNIFFER_PIPELINE
+
+/* THREAD_LS_T is a real qualifier with the pipeline: each shard thread owns
+ * its own server and session tables, loads its own keys, counts its own
+ * statistics and frees its tables on exit. */
+typedef struct SnifferShard {
+    SSLSnifferPipeline* pipeline;
+    THREAD_TYPE         tid;
+    COND_TYPE           cond;      /* work queued or stop requested */
+    int*                idx;       /* batch packets for this shard, in order */
+    int                 idxCnt;
+    int                 idxSz;
+    int                 id;
+    byte                busy;
+    byte                stop;
+    byte                condInit;
+#ifdef WOLFSSL_SNIFFER_STATS
+    SSLStats            stats;
+#ifndef HAVE_C___ATOMIC
+    wolfSSL_Mutex       statsMutex;
+    byte                statsMutexInit;
+#endif
+#endif
+} SnifferShard;
+
+struct SSLSnifferPipeline {
+    SnifferShard*     shards;
+    int               shardCnt;    /* shards with a running thread */
+    int               shardMax;
+    SSLSnifferPacket* packets;     /* batch being decoded */
+    COND_TYPE         done;        /* a shard finished its work */
+    int               pending;     /* shards still working */
+    int               initRet;     /* first shard init failure */
+    char              initError[MAX_ERROR_LEN];
+    SSLShardInitCb    initCb;
+    void*             initCtx;
+#ifdef WOLFSSL_SNIFFER_STATS
+    SSLSnifferPipeline* statsNext; /* next in StatsPipelines */
+    byte              statsListed;
+#endif
+    byte              doneInit;
+};
+
+
+/* Report a shard finished starting up or decoding its part of a batch */
+static void SnifferShardDone(SSLSnifferPipeline* pipeline, int ret,
+                             const char* error)
+{
+    if (wolfSSL_CondStart(&pipeline->done) != 0)
+        return;
+    if (ret != 0 && pipeline->initRet == 0) {
+        pipeline->initRet = ret;
+        XSTRNCPY(pipeline->initError, error, MAX_ERROR_LEN - 1);
+    }
+    pipeline->pending--;
+    (void)wolfSSL_CondSignal(&pipeline->done);
+    (void)wolfSSL_CondEnd(&pipeline->done);
+}
+
+
+/* Wait for all shards to report done */
+/* returns 0 on success */
+static int SnifferPipelineWait(SSLSnifferPipeline* pipeline)
+{
+    int ret;
+
+    ret = wolfSSL_CondStart(&pipeline->done);
+    if (ret != 0)
+        return ret;
+    while (ret == 0 && pipeline->pending > 0) {
+        ret = wolfSSL_CondWait(&pipeline->done);
+    }
+    (void)wolfSSL_CondEnd(&pipeline->done);
+
+    return ret;
+}
+
+
+static THREAD_RETURN WOLFSSL_THREAD SnifferShardWorker(void* arg)
+{
+    SnifferShard*       shard = (SnifferShard*)arg;
+    SSLSnifferPipeline* pipeline = shard->pipeline;
+    char                error[MAX_ERROR_LEN];
+    int                 ret = 0;
+    int                 i;
+
+    error[0] = '\0';
+#ifdef WOLFSSL_SNIFFER_STATS
+    ShardStats = &shard->stats;
+#ifndef HAVE_C___ATOMIC
+    ShardStatsMutex = &shard->statsMutex;
+#endif
+#endif
+    if (pipeline->initCb != NULL)
+        ret = pipeline->initCb(shard->id, pipeline->initCtx, error);
+    SnifferShardDone(pipeline, ret, error);
+
+    for (;;) {
+        if (wolfSSL_CondStart(&shard->cond) != 0)
+            break;
+        while (!shard->busy && !shard->stop) {
+            if (wolfSSL_CondWait(&shard->cond) != 0) {
+                shard->stop = 1;
+            }
+        }
+        (void)wolfSSL_CondEnd(&shard->cond);
+        if (!shard->busy)
+            break;
+
+        for (i = 0; i < shard->idxCnt; i++) {
+            SSLSnifferPacket* pkt = &pipeline->packets[shard->idx[i]];
+
+            pkt->ret = ssl_DecodePacketInternal(pkt->packet, pkt->length, 0,
+                    &pkt->data, pkt->sslInfo, NULL,
+                    pkt->error != NULL ? pkt->error : error, 0);
+        }
+        shard->busy = 0;
+        SnifferShardDone(pipeline, 0, NULL);
+    }
+
+    FreeSnifferTables();
+#ifdef WOLFSSL_SNIFFER_STATS
+    ShardStats = NULL;
+#ifndef HAVE_C___ATOMIC
+    ShardStatsMutex = NULL;
+#endif
+#endif
+
+    WOLFSSL_RETURN_FROM_THREAD(0);
+}
+
+
+/* Start a decode pipeline of shards worker threads, initCb is run on each
+ * shard thread before this returns */
+/* returns 0 on success, WOLFSSL_SNIFFER_ERROR on error */
+int ssl_NewSnifferPipeline(SSLSnifferPipeline** pipeline, int shards,
+        SSLShardInitCb initCb, void* ctx, char* error)
+{
+    SSLSnifferPipeline* pipe;
+    int                 ret = 0;
+    int                 i;
+
+    if (pipeline == NULL || shards <= 0) {
+        SetError(BAD_INPUT_STR, error, NULL, 0);
+        return WOLFSSL_SNIFFER_ERROR;
+    }
+    *pipeline = NULL;
+
+    pipe = (SSLSnifferPipeline*)XMALLOC(sizeof(SSLSnifferPipeline), NULL,
+                                        DYNAMIC_TYPE_SNIFFER_PIPELINE);
+    if (pipe == NULL) {
+        SetError(MEMORY_STR, error, NULL, 0);
+        return WOLFSSL_SNIFFER_ERROR;
+    }
+    XMEMSET(pipe, 0, sizeof(SSLSnifferPipeline));
+    pipe->initCb  = initCb;
+    pipe->initCtx = ctx;
+
+    pipe->shards = (SnifferShard*)XMALLOC(sizeof(SnifferShard) * shards, NULL,
+                                          DYNAMIC_TYPE_SNIFFER_PIPELINE);
+    if (pipe->shards == NULL) {
+        XFREE(pipe, NULL, DYNAMIC_TYPE_SNIFFER_PIPELINE);
+        SetError(MEMORY_STR, error, NULL, 0);
+        return WOLFSSL_SNIFFER_ERROR;
+    }
+    XMEMSET(pipe->shards, 0, sizeof(SnifferShard) * shards);
+    pipe->shardMax = shards;
+
+    if (wolfSSL_CondInit(&pipe->done) != 0)
+        ret = WOLFSSL_SNIFFER_ERROR;
+    else
+        pipe->doneInit = 1;
+
+    for (i = 0; ret == 0 && i < shards; i++) {
+        SnifferShard* shard = &pipe->shards[i];
+
+        shard->pipeline = pipe;
+        shard->id       = i;
+        if (wolfSSL_CondInit(&shard->cond) != 0) {
+            ret = WOLFSSL_SNIFFER_ERROR;
+            break;
+        }
+        shard->condInit = 1;
+    #if defined(WOLFSSL_SNIFFER_STATS) && !defined(HAVE_C___ATOMIC)
+        if (wc_InitMutex(&shard->statsMutex) != 0) {
+            ret = WOLFSSL_SNIFFER_ERROR;
+            break;
+        }
+        shard->statsMutexInit = 1;
+    #endif
+
+        /* count the shard before it runs, it reports back after init */
+        if (wolfSSL_CondStart(&pipe->done) != 0) {
+            ret = WOLFSSL_SNIFFER_ERROR;
+            break;
+        }
+        pipe->pending++;
+        (void)wolfSSL_CondEnd(&pipe->done);
+
+        if (wolfSSL_NewThread(&shard->tid, SnifferShardWorker, shard) != 0) {
+            if (wolfSSL_CondStart(&pipe->done) == 0) {
+                pipe->pending--;
+                (void)wolfSSL_CondEnd(&pipe->done);
+            }
+            ret = WOLFSSL_SNIFFER_ERROR;
+            break;
+        }
+        pipe->shardCnt++;
+    }
+
+    /* wait for the started shards even on failure, before freeing them */
+    if (pipe->doneInit && SnifferPipelineWait(pipe) != 0)
+        ret = WOLFSSL_SNIFFER_ERROR;
+
+    if (ret == 0 && pipe->initRet != 0) {
+        if (error != NULL) {
+            XSTRNCPY(error, pipe->initError, MAX_ERROR_LEN - 1);
+            error[MAX_ERROR_LEN - 1] = '\0';
+        }
+        ssl_FreeSnifferPipeline(pipe);
+        return WOLFSSL_SNIFFER_ERROR;
+    }
+    if (ret != 0) {
+        SetError(PIPELINE_THREAD_STR, error, NULL, 0);
+        ssl_FreeSnifferPipeline(pipe);
+        return WOLFSSL_SNIFFER_ERROR;
+    }
+
+#ifdef WOLFSSL_SNIFFER_STATS
+    /* list it so its shards' statistics are read */
+    if (wc_LockMutex(&StatsMutex) == 0) {
+        pipe->statsNext = StatsPipelines;
+        StatsPipelines = pipe;
+        pipe->statsListed = 1;
+        wc_UnLockMutex(&StatsMutex);
+    }
+#endif
+
+    *pipeline = pipe;
+    return 0;
+}
+
+
+/* Decode a batch of packets. Packets are routed to a shard by connection, so
+ * all packets of a connection are decoded by the same thread and in batch
+ * order. Each packet's result is returned in its ret and data members. */
+/* returns 0 on success, WOLFSSL_SNIFFER_ERROR on error */
+int ssl_DecodePacketBatch(SSLSnifferPipeline* pipeline,
+        SSLSnifferPacket* packets, int count, char* error)
+{
+    TcpInfo     tcpInfo;
+    IpInfo      ipInfo;
+    const byte* sslFrame;
+    int         sslBytes;
+    char        routeError[MAX_ERROR_LEN];
+    int         ret = 0;
+    int         i;
+
+    if (pipeline == NULL || count < 0 || (packets == NULL && count > 0)) {
+        SetError(BAD_INPUT_STR, error, NULL, 0);
+        return WOLFSSL_SNIFFER_ERROR;
+    }
+    if (count == 0)
+        return 0;
+
+    for (i = 0; i < pipeline->shardCnt; i++) {
+        SnifferShard* shard = &pipeline->shards[i];
+
+        shard->idxCnt = 0;
+        if (shard->idxSz < count) {
+            XFREE(shard->idx, NULL, DYNAMIC_TYPE_SNIFFER_PIPELINE);
+            shard->idxSz = 0;
+            shard->idx = (int*)XMALLOC(sizeof(int) * count, NULL,
+                                       DYNAMIC_TYPE_SNIFFER_PIPELINE);
+            if (shard->idx == NULL) {
+                SetError(MEMORY_STR, error, NULL, 0);
+                return WOLFSSL_SNIFFER_ERROR;
+            }
+            shard->idxSz = count;
+        }
+    }
+
+    /* route by connection, packets without valid headers go to shard 0 where
+     * the decode reports the error */
+    for (i = 0; i < count; i++) {
+        SSLSnifferPacket* pkt = &packets[i];
+        SnifferShard*     shard;
+        word32            row = 0;
+
+        pkt->data = NULL;
+        pkt->ret  = 0;
+        if (pkt->packet == NULL) {
+            SetError(BAD_INPUT_STR, pkt->error, NULL, 0);
+            pkt->ret = WOLFSSL_SNIFFER_ERROR;
+            continue;
+        }
+
+        XMEMSET(&tcpInfo, 0, sizeof(tcpInfo));
+        XMEMSET(&ipInfo, 0, sizeof(ipInfo));
+        if (CheckHeaders(&ipInfo, &tcpInfo, pkt->packet, pkt->length,
+                &sslFrame, &sslBytes, routeError, 0, 0) == 0) {
+            row = SessionHash(&ipInfo, &tcpInfo);
+        }
+        shard = &pipeline->shards[row % (word32)pipeline->shardCnt];
+        shard->idx[shard->idxCnt++] = i;
+    }
+
+    pipeline->packets = packets;
+    if (wolfSSL_CondStart(&pipeline->done) != 0) {
+        SetError(PIPELINE_THREAD_STR, error, NULL, 0);
+        return WOLFSSL_SNIFFER_ERROR;
+    }
+    for (i = 0; i < pipeline->shardCnt; i++) {
+        if (pipeline->shards[i].idxCnt > 0)
+            pipeline->pending++;
+    }
+    (void)wolfSSL_CondEnd(&pipeline->done);
+
+    for (i = 0; i < pipeline->shardCnt; i++) {
+        SnifferShard* shard = &pipeline->shards[i];
+
+        if (shard->idxCnt == 0)
+            continue;
+        if (wolfSSL_CondStart(&shard->cond) != 0) {
+            ret = WOLFSSL_SNIFFER_ERROR;
+            break;
+        }
+        shard->busy = 1;
+        (void)wolfSSL_CondSignal(&shard->cond);
+        (void)wolfSSL_CondEnd(&shard->cond);
+    }
+    if (ret != 0) {
+        /* shards not started will not report back */
+        if (wolfSSL_CondStart(&pipeline->done) == 0) {
+            for (; i < pipeline->shardCnt; i++) {
+                if (pipeline->shards[i].idxCnt > 0)
+                    pipeline->pending--;
+            }
+            (void)wolfSSL_CondEnd(&pipeline->done);
+        }
+    }
+
+    if (SnifferPipelineWait(pipeline) != 0)
+        ret = WOLFSSL_SNIFFER_ERROR;
+    pipeline->packets = NULL;
+
+    if (ret != 0) {
+        SetError(PIPELINE_THREAD_STR, error, NULL, 0);
+        return WOLFSSL_SNIFFER_ERROR;
+    }
+
+    return 0;
+}
+
+
+/* Stop the pipeline's shard threads and free it */
+void ssl_FreeSnifferPipeline(SSLSnifferPipeline* pipeline)
+{
+    int i;
+
+    if (pipeline == NULL)
+        return;
+
+    for (i = 0; i < pipeline->shardCnt; i++) {
+        SnifferShard* shard = &pipeline->shards[i];
+
+        if (wolfSSL_CondStart(&shard->cond) == 0) {
+            shard->stop = 1;
+            (void)wolfSSL_CondSignal(&shard->cond);
+            (void)wolfSSL_CondEnd(&shard->cond);
+        }
+        (void)wolfSSL_JoinThread(shard->tid);
+    }
+
+#ifdef WOLFSSL_SNIFFER_STATS
+    /* keep what the shards counted in the process statistics */
+    if (wc_LockMutex(&StatsMutex) == 0) {
+        SSLSnifferPipeline** prev = &StatsPipelines;
+
+        while (pipeline->statsListed && *prev != NULL) {
+            if (*prev == pipeline) {
+                *prev = pipeline->statsNext;
+                break;
+            }
+            prev = &(*prev)->statsNext;
+        }
+        for (i = 0; i < pipeline->shardMax; i++)
+            SnifferStatsAdd(&SnifferStats, &pipeline->shards[i].stats, 0);
+        wc_UnLockMutex(&StatsMutex);
+    }
+#endif
+
+    for (i = 0; i < pipeline->shardMax; i++) {
+        SnifferShard* shard = &pipeline->shards[i];
+
+        if (shard->condInit)
+            (void)wolfSSL_CondFree(&shard->cond);
+    #if defined(WOLFSSL_SNIFFER_STATS) && !defined(HAVE_C___ATOMIC)
+        if (shard->statsMutexInit)
+            (void)wc_FreeMutex(&shard->statsMutex);
+    #endif
+        XFREE(shard->idx, NULL, DYNAMIC_TYPE_SNIFFER_PIPELINE);
+    }
+    if (pipeline->doneInit)
+        (void)wolfSSL_CondFree(&pipeline->done);
+
+    XFREE(pipeline->shards, NULL, DYNAMIC_TYPE_SNIFFER_PIPELINE);
+    XFREE(pipeline, NULL, DYNAMIC_TYPE_SNIFFER_PIPELINE);
+}
+
+#endif /* WOLFSSL_SNIFFER_PIPELINE */
+
+
 /* Deallocator for the decoded data buffer. */
 /* returns 0 on success, -1 on error */
 int ssl_FreeDecodeBuffer(byte** data, char* error)
@@ -7190,16 +7686,52 @@ int ssl_SetConnectionCtx(void* ctx)
 
 #ifdef WOLFSSL_SNIFFER_STATS
 
-/* Resets the statistics tracking global structure.
+/* Sum the process statistics and those of every pipeline shard into stats,
+ * when not NULL, and zero them when reset.
  * returns 0 on success, -1 on error */
-int ssl_ResetStatistics(void)
+static int SnifferStatsCollect(SSLStats* stats, int reset)
 {
-    wc_LockMutex(&StatsMutex);
-    XMEMSET(&SnifferStats, 0, sizeof(SSLStats));
+    SSLStats total;
+#ifdef WOLFSSL_SNIFFER_PIPELINE
+    SSLSnifferPipeline* pipeline;
+    int i;
+#endif
+
+    XMEMSET(&total, 0, sizeof(total));
+    if (wc_LockMutex(&StatsMutex) != 0)
+        return WOLFSSL_FATAL_ERROR;
+    SnifferStatsAdd(&total, &SnifferStats, reset);
+#ifdef WOLFSSL_SNIFFER_PIPELINE
+    for (pipeline = StatsPipelines; pipeline != NULL;
+            pipeline = pipeline->statsNext) {
+        for (i = 0; i < pipeline->shardCnt; i++) {
+            SnifferShard* shard = &pipeline->shards[i];
+
+        #ifndef HAVE_C___ATOMIC
+            if (wc_LockMutex(&shard->statsMutex) != 0)
+                continue;
+        #endif
+            SnifferStatsAdd(&total, &shard->stats, reset);
+        #ifndef HAVE_C___ATOMIC
+            wc_UnLockMutex(&shard->statsMutex);
+        #endif
+        }
+    }
+#endif
     wc_UnLockMutex(&StatsMutex);
+
+    if (stats != NULL)
+        XMEMCPY(stats, &total, sizeof(SSLStats));
     return 0;
 }
 
+/* Resets the statistics tracking global structure.
+ * returns 0 on success, -1 on error */
+int ssl_ResetStatistics(void)
+{
+    return SnifferStatsCollect(NULL, 1);
+}
+
 
 /* Copies the SSL statistics into the provided stats record.
  * returns 0 on success, -1 on error */
@@ -7208,10 +7740,7 @@ int ssl_ReadStatistics(SSLStats* stats)
     if (stats == NULL)
         return WOLFSSL_FATAL_ERROR;
 
-    LOCK_STAT();
-    XMEMCPY(stats, &SnifferStats, sizeof(SSLStats));
-    UNLOCK_STAT();
-    return 0;
+    return SnifferStatsCollect(stats, 0);
 }
 
 /* Copies the SSL statistics into the provided stats record then
@@ -7222,11 +7751,7 @@ int ssl_ReadResetStatistics(SSLStats* stats)
     if (stats == NULL)
         return WOLFSSL_FATAL_ERROR;
 
-    LOCK_STAT();
-    XMEMCPY(stats, &SnifferStats, sizeof(SSLStats));
-    XMEMSET(&SnifferStats, 0, sizeof(SSLStats));
-    UNLOCK_STAT();
-    return 0;
+    return SnifferStatsCollect(stats, 1);
 }
 
 #endif /* WOLFSSL_SNIFFER_STATS */
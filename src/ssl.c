@@ -1381,6 +1381,21 @@ WC_RNG* wolfSSL_GetRNG(WOLFSSL* ssl)
     return NULL;
 }
 
+#ifdef WOLFSSL_TLS_RNG_BANK
+/* Choose whether WOLFSSL objects created from ctx generate from the shared
+ * TLS RNG bank (the default) or instantiate their own DRBG.
+ * Returns WOLFSSL_SUCCESS or BAD_FUNC_ARG. */
+int wolfSSL_CTX_UseRngBank(WOLFSSL_CTX* ctx, int enable)
+{
+    if (ctx == NULL)
+        return BAD_FUNC_ARG;
+
+    ctx->noRngBank = (enable == 0);
+
+    return WOLFSSL_SUCCESS;
+}
+#endif /* WOLFSSL_TLS_RNG_BANK */
+
 
 #ifndef WOLFSSL_LEANPSK
 /* object size based on build */
@@ -2395,9 +2410,6 @@ WOLFSSL_ABI
 int wolfSSL_Init(void)
 {
     int ret = WOLFSSL_SUCCESS;
-#if !defined(NO_SESSION_CACHE) && defined(ENABLE_SESSION_CACHE_ROW_LOCK)
-    int i;
-#endif
 
     WOLFSSL_ENTER("wolfSSL_Init");
 
@@ -2498,31 +2510,19 @@ int wolfSSL_Init(void)
         }
 #endif
 
-#ifndef NO_SESSION_CACHE
-    #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
-        for (i = 0; i < SESSION_ROWS; ++i) {
-            SessionCache[i].lock_valid = 0;
-        }
-        for (i = 0; (ret == WOLFSSL_SUCCESS) && (i < SESSION_ROWS); ++i) {
-            if (wc_InitRwLock(&SessionCache[i].row_lock) != 0) {
-                WOLFSSL_MSG("Bad Init Mutex session");
-                ret = BAD_MUTEX_E;
-            }
-            else {
-                SessionCache[i].lock_valid = 1;
-            }
+#ifdef WOLFSSL_TLS_RNG_BANK
+        if (ret == WOLFSSL_SUCCESS) {
+            /* on failure connections seed their own RNGs */
+            (void)InitTlsRngBank();
         }
-    #else
+#endif
+
+#ifndef NO_SESSION_CACHE
         if (ret == WOLFSSL_SUCCESS) {
-            if (wc_InitRwLock(&session_lock) != 0) {
-                WOLFSSL_MSG("Bad Init Mutex session");
+            if (SessionCacheLocksInit() != 0) {
                 ret = BAD_MUTEX_E;
             }
-            else {
-                session_lock_valid = 1;
-            }
         }
-    #endif
     #ifndef NO_CLIENT_CACHE
         #ifndef WOLFSSL_MUTEX_INITIALIZER
         if (ret == WOLFSSL_SUCCESS) {
@@ -3667,23 +3667,10 @@ int wolfSSL_Cleanup(void)
 #endif
 
 #ifndef NO_SESSION_CACHE
-    #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
-    for (i = 0; i < SESSION_ROWS; ++i) {
-        if ((SessionCache[i].lock_valid == 1) &&
-            (wc_FreeRwLock(&SessionCache[i].row_lock) != 0)) {
-            if (ret == WOLFSSL_SUCCESS)
-                ret = BAD_MUTEX_E;
-        }
-        SessionCache[i].lock_valid = 0;
-    }
-    #else
-    if ((session_lock_valid == 1) && (wc_FreeRwLock(&session_lock) != 0)) {
-        if (ret == WOLFSSL_SUCCESS)
-            ret = BAD_MUTEX_E;
-    }
-    session_lock_valid = 0;
-    #endif
-    for (i = 0; i < SESSION_ROWS; i++) {
+    if ((SessionCacheLocksFree() != 0) && (ret == WOLFSSL_SUCCESS))
+        ret = BAD_MUTEX_E;
+    /* sessions in a shared segment stay for the other processes */
+    for (i = 0; i < (int)SessionCacheRows && !SESSION_CACHE_IS_SHARED(); i++) {
         for (j = 0; j < SESSIONS_PER_ROW; j++) {
     #ifdef SESSION_CACHE_DYNAMIC_MEM
             if (SessionCache[i].Sessions[j]) {
@@ -3696,7 +3683,18 @@ int wolfSSL_Cleanup(void)
             EvictSessionFromCache(&SessionCache[i].Sessions[j]);
     #endif
         }
+        SessionCache[i].totalCount = 0;
+        SessionCache[i].nextIdx = 0;
+    }
+    #ifdef SESSION_CACHE_DYNAMIC_MEM
+    /* drop a table allocated by wolfSSL_set_session_cache_size() */
+    if (SessionCache != SessionCacheDefault) {
+        XFREE(SessionCache, NULL, DYNAMIC_TYPE_SESSION);
+        SessionCache = SessionCacheDefault;
+        SessionCacheRows = SESSION_ROWS;
     }
+    #endif
+    SessionCacheCols = SESSIONS_PER_ROW;
     #ifndef NO_CLIENT_CACHE
     #ifndef WOLFSSL_MUTEX_INITIALIZER
     if ((clisession_mutex_valid == 1) &&
@@ -3723,6 +3721,11 @@ int wolfSSL_Cleanup(void)
     wolfSSL_RAND_Cleanup();
 #endif
 
+#ifdef WOLFSSL_TLS_RNG_BANK
+    /* leaked, not freed, if a WOLFSSL still references it */
+    (void)FreeTlsRngBank();
+#endif
+
     if (wolfCrypt_Cleanup() != 0) {
         WOLFSSL_MSG("Error with wolfCrypt_Cleanup call");
         if (ret == WOLFSSL_SUCCESS)
@@ -5875,26 +5878,36 @@ size_t wolfSSL_get_client_random(const WOLFSSL* ssl, unsigned char* out,
         return WOLFSSL_SUCCESS;
     }
 
+/* Before modes were bits WOLFSSL_MODE_AUTO_RETRY was 3 and
+ * WOLFSSL_MODE_RELEASE_BUFFERS was -1. Binaries built against those headers
+ * still pass them, so map them to the current bit instead of reading 3 as
+ * ENABLE_PARTIAL_WRITE or -1 as every mode. */
+#define WOLFSSL_MODE_AUTO_RETRY_LEGACY      3
+#define WOLFSSL_MODE_RELEASE_BUFFERS_LEGACY (-1)
+#define WOLFSSL_MODE_FROM_LEGACY(m)                                         \
+    (((m) == WOLFSSL_MODE_AUTO_RETRY_LEGACY) ?                              \
+        (long)WOLFSSL_MODE_AUTO_RETRY :                                     \
+     ((m) == WOLFSSL_MODE_RELEASE_BUFFERS_LEGACY) ?                         \
+        (long)WOLFSSL_MODE_RELEASE_BUFFERS : (m))
+
 #if defined(OPENSSL_EXTRA) || defined(HAVE_WEBSERVER) || defined(HAVE_MEMCACHED)
     long wolfSSL_CTX_set_mode(WOLFSSL_CTX* ctx, long mode)
     {
         /* WOLFSSL_MODE_ACCEPT_MOVING_WRITE_BUFFER is wolfSSL default mode */
+        long bits = WOLFSSL_MODE_FROM_LEGACY(mode);
 
         WOLFSSL_ENTER("wolfSSL_CTX_set_mode");
-        switch(mode) {
-            case WOLFSSL_MODE_ENABLE_PARTIAL_WRITE:
-                ctx->partialWrite = 1;
-                break;
-            #if defined(OPENSSL_ALL) || defined(WOLFSSL_QT)
-            case SSL_MODE_RELEASE_BUFFERS:
-                WOLFSSL_MSG("SSL_MODE_RELEASE_BUFFERS not implemented.");
-                break;
-            #endif
-            case WOLFSSL_MODE_AUTO_RETRY:
-                ctx->autoRetry = 1;
-                break;
-            default:
-                WOLFSSL_MSG("Mode Not Implemented");
+        if (bits & WOLFSSL_MODE_ENABLE_PARTIAL_WRITE)
+            ctx->partialWrite = 1;
+        if (bits & WOLFSSL_MODE_RELEASE_BUFFERS)
+            ctx->releaseBuffers = 1;
+        if (bits & WOLFSSL_MODE_AUTO_RETRY)
+            ctx->autoRetry = 1;
+        if (bits & ~(long)(WOLFSSL_MODE_ENABLE_PARTIAL_WRITE |
+                           WOLFSSL_MODE_RELEASE_BUFFERS |
+                           WOLFSSL_MODE_AUTO_RETRY |
+                           WOLFSSL_MODE_ACCEPT_MOVING_WRITE_BUFFER)) {
+            WOLFSSL_MSG("Mode Not Implemented");
         }
 
         /* WOLFSSL_MODE_AUTO_RETRY
@@ -5906,22 +5919,20 @@ size_t wolfSSL_get_client_random(const WOLFSSL* ssl, unsigned char* out,
     long wolfSSL_CTX_clear_mode(WOLFSSL_CTX* ctx, long mode)
     {
         /* WOLFSSL_MODE_ACCEPT_MOVING_WRITE_BUFFER is wolfSSL default mode */
+        long bits = WOLFSSL_MODE_FROM_LEGACY(mode);
 
         WOLFSSL_ENTER("wolfSSL_CTX_clear_mode");
-        switch(mode) {
-            case WOLFSSL_MODE_ENABLE_PARTIAL_WRITE:
-                ctx->partialWrite = 0;
-                break;
-            #if defined(OPENSSL_ALL) || defined(WOLFSSL_QT)
-            case SSL_MODE_RELEASE_BUFFERS:
-                WOLFSSL_MSG("SSL_MODE_RELEASE_BUFFERS not implemented.");
-                break;
-            #endif
-            case WOLFSSL_MODE_AUTO_RETRY:
-                ctx->autoRetry = 0;
-                break;
-            default:
-                WOLFSSL_MSG("Mode Not Implemented");
+        if (bits & WOLFSSL_MODE_ENABLE_PARTIAL_WRITE)
+            ctx->partialWrite = 0;
+        if (bits & WOLFSSL_MODE_RELEASE_BUFFERS)
+            ctx->releaseBuffers = 0;
+        if (bits & WOLFSSL_MODE_AUTO_RETRY)
+            ctx->autoRetry = 0;
+        if (bits & ~(long)(WOLFSSL_MODE_ENABLE_PARTIAL_WRITE |
+                           WOLFSSL_MODE_RELEASE_BUFFERS |
+                           WOLFSSL_MODE_AUTO_RETRY |
+                           WOLFSSL_MODE_ACCEPT_MOVING_WRITE_BUFFER)) {
+            WOLFSSL_MSG("Mode Not Implemented");
         }
 
         /* WOLFSSL_MODE_AUTO_RETRY
@@ -8380,6 +8391,22 @@ long wolfSSL_ctrl(WOLFSSL* ssl, int cmd, long opt, void* pt)
             return wolfSSL_set_tlsext_host_name(ssl, (const char*) pt);
         #endif /* HAVE_SNI */
         #endif /* WOLFSSL_NGINX || WOLFSSL_QT || OPENSSL_ALL */
+        case SSL_CTRL_MODE:
+            opt = WOLFSSL_MODE_FROM_LEGACY(opt);
+            if (opt & WOLFSSL_MODE_ENABLE_PARTIAL_WRITE)
+                ssl->options.partialWrite = 1;
+            if (opt & WOLFSSL_MODE_RELEASE_BUFFERS)
+                ssl->options.releaseBuffers = 1;
+            if (opt & ~(long)(WOLFSSL_MODE_ENABLE_PARTIAL_WRITE |
+                              WOLFSSL_MODE_RELEASE_BUFFERS |
+                              WOLFSSL_MODE_ACCEPT_MOVING_WRITE_BUFFER)) {
+                WOLFSSL_MSG("Mode Not Implemented");
+            }
+            if (opt & (WOLFSSL_MODE_ENABLE_PARTIAL_WRITE |
+                       WOLFSSL_MODE_RELEASE_BUFFERS)) {
+                return opt;
+            }
+            break;
         default:
             WOLFSSL_MSG("Case not implemented.");
     }
@@ -773,6 +773,338 @@ int wolfSSL_CTX_DisableOCSPMustStaple(WOLFSSL_CTX* ctx)
 
     return ret;
 }
+
+#ifdef WOLFSSL_OCSP_STAPLE_CACHE
+/* Keep OCSP responses for the context's certificates ready to staple.
+ *
+ * Tracks the certificate and chain loaded into the context, so call after
+ * loading them and before serving connections. Calling again adds any
+ * certificates loaded since. OCSP stapling must be enabled first. Responses
+ * are fetched with wolfSSL_CTX_OCSPStapleCacheRefresh() or by the background
+ * refresh.
+ *
+ * @param [in, out] ctx       SSL/TLS context.
+ * @param [in]      maxCerts  Most certificates the cache will track.
+ * @return  WOLFSSL_SUCCESS on success.
+ * @return  BAD_FUNC_ARG when ctx is NULL or maxCerts is out of range.
+ * @return  BAD_STATE_E when OCSP stapling is not enabled.
+ * @return  BUFFER_E when there are more certificates than maxCerts.
+ * @return  Other negative value on failure.
+ */
+int wolfSSL_CTX_EnableOCSPStapleCache(WOLFSSL_CTX* ctx, int maxCerts)
+{
+    int ret;
+    WOLFSSL_OCSP* ocsp = NULL;
+
+    WOLFSSL_ENTER("wolfSSL_CTX_EnableOCSPStapleCache");
+
+    if (ctx == NULL || ctx->cm == NULL) {
+        ret = BAD_FUNC_ARG;
+    }
+    else if ((ocsp = ctx->cm->ocsp_stapling) == NULL) {
+        WOLFSSL_MSG("OCSP stapling not enabled");
+        ret = BAD_STATE_E;
+    }
+    else {
+        ret = OcspStapleCacheEnable(ocsp, maxCerts);
+    }
+
+    if (ret == 0 && ctx->certificate != NULL &&
+            ctx->certificate->buffer != NULL) {
+        ret = OcspStapleCacheAdd(ocsp, ctx->certificate->buffer,
+                                 ctx->certificate->length);
+    }
+    if (ret == 0 && ctx->certChain != NULL && ctx->certChain->buffer != NULL) {
+        DerBuffer* chain = ctx->certChain;
+        word32 idx = 0;
+        word32 len;
+
+        while (ret == 0 && idx + OPAQUE24_LEN < chain->length) {
+            c24to32(chain->buffer + idx, &len);
+            idx += OPAQUE24_LEN;
+            if (len > chain->length - idx)
+                break;
+            ret = OcspStapleCacheAdd(ocsp, chain->buffer + idx, len);
+            idx += len;
+        }
+    }
+
+    if (ret == 0) {
+        ret = WOLFSSL_SUCCESS;
+    }
+
+    WOLFSSL_LEAVE("wolfSSL_CTX_EnableOCSPStapleCache", ret);
+    return ret;
+}
+
+/* Fetch OCSP responses for the context's cached certificates.
+ *
+ * Only certificates with no response, or with one close to its nextUpdate,
+ * are fetched for unless force is set. A failed fetch keeps the previous
+ * response.
+ *
+ * @param [in, out] ctx    SSL/TLS context.
+ * @param [in]      force  Fetch for every certificate when non-zero.
+ * @return  Number of certificates with a response ready to staple.
+ * @return  BAD_FUNC_ARG when ctx is NULL or the cache is not enabled.
+ * @return  BAD_MUTEX_E when locking fails.
+ */
+int wolfSSL_CTX_OCSPStapleCacheRefresh(WOLFSSL_CTX* ctx, int force)
+{
+    int ret;
+
+    WOLFSSL_ENTER("wolfSSL_CTX_OCSPStapleCacheRefresh");
+
+    if (ctx == NULL || ctx->cm == NULL) {
+        ret = BAD_FUNC_ARG;
+    }
+    else {
+        ret = OcspStapleCacheRefresh(ctx->cm->ocsp_stapling, force);
+    }
+
+    return ret;
+}
+
+/* Refresh the context's OCSP staple cache on a background thread.
+ *
+ * The first refresh happens straight away, then every interval seconds. The
+ * interval should be shorter than OCSP_STAPLE_REFRESH_MARGIN so responses are
+ * replaced before they expire. Calling again changes the interval.
+ *
+ * @param [in, out] ctx          SSL/TLS context.
+ * @param [in]      intervalSec  Seconds between refreshes.
+ * @return  WOLFSSL_SUCCESS on success.
+ * @return  BAD_FUNC_ARG when ctx is NULL, the cache is not enabled or
+ *          intervalSec is 0.
+ * @return  NOT_COMPILED_IN when built without POSIX threads.
+ * @return  Other negative value on failure.
+ */
+int wolfSSL_CTX_StartOCSPStapleRefresh(WOLFSSL_CTX* ctx,
+                                       unsigned int intervalSec)
+{
+    int ret;
+
+    WOLFSSL_ENTER("wolfSSL_CTX_StartOCSPStapleRefresh");
+
+    if (ctx == NULL || ctx->cm == NULL) {
+        ret = BAD_FUNC_ARG;
+    }
+    else {
+        ret = OcspStapleCacheStartRefresh(ctx->cm->ocsp_stapling,
+                                          (word32)intervalSec);
+    }
+    if (ret == 0) {
+        ret = WOLFSSL_SUCCESS;
+    }
+
+    return ret;
+}
+
+/* Stop the background refresh of the context's OCSP staple cache.
+ *
+ * Waits for a refresh in progress to finish. The cached responses are kept.
+ *
+ * @param [in, out] ctx  SSL/TLS context.
+ * @return  WOLFSSL_SUCCESS on success, including when not running.
+ * @return  BAD_FUNC_ARG when ctx is NULL or the cache is not enabled.
+ */
+int wolfSSL_CTX_StopOCSPStapleRefresh(WOLFSSL_CTX* ctx)
+{
+    int ret;
+
+    WOLFSSL_ENTER("wolfSSL_CTX_StopOCSPStapleRefresh");
+
+    if (ctx == NULL || ctx->cm == NULL) {
+        ret = BAD_FUNC_ARG;
+    }
+    else {
+        ret = OcspStapleCacheStopRefresh(ctx->cm->ocsp_stapling);
+    }
+    if (ret == 0) {
+        ret = WOLFSSL_SUCCESS;
+    }
+
+    return ret;
+}
+
+#if !defined(NO_FILESYSTEM)
+
+/* Persist the context's OCSP staple cache to file.
+ *
+ * @param [in] ctx    SSL/TLS context.
+ * @param [in] fname  Filename to store the cache to.
+ * @return  WOLFSSL_SUCCESS on success.
+ * @return  BAD_FUNC_ARG when ctx or fname is NULL.
+ * @return  WOLFSSL_BAD_FILE when opening file fails.
+ * @return  FWRITE_ERROR when writing to file fails.
+ * @return  Other negative value on failure.
+ */
+int wolfSSL_CTX_save_ocsp_staple_cache(WOLFSSL_CTX* ctx, const char* fname)
+{
+    int   ret;
+    int   memSz = 0;
+    int   used = 0;
+    byte* mem = NULL;
+    XFILE file = XBADFILE;
+
+    WOLFSSL_ENTER("wolfSSL_CTX_save_ocsp_staple_cache");
+
+    if (ctx == NULL || ctx->cm == NULL || fname == NULL) {
+        return BAD_FUNC_ARG;
+    }
+
+    ret = memSz = OcspStapleCacheGetMemSize(ctx->cm->ocsp_stapling);
+    if (ret > 0) {
+        mem = (byte*)XMALLOC((size_t)memSz, ctx->heap,
+                             DYNAMIC_TYPE_TMP_BUFFER);
+        ret = (mem == NULL) ? MEMORY_E :
+            OcspStapleCacheMemSave(ctx->cm->ocsp_stapling, mem, memSz, &used);
+    }
+    if (ret == WOLFSSL_SUCCESS) {
+        file = XFOPEN(fname, "w+b");
+        if (file == XBADFILE) {
+            WOLFSSL_MSG("Couldn't open OCSP staple cache save file");
+            ret = WOLFSSL_BAD_FILE;
+        }
+    }
+    if (ret == WOLFSSL_SUCCESS &&
+            (int)XFWRITE(mem, (size_t)used, 1, file) != 1) {
+        WOLFSSL_MSG("OCSP staple cache file write failed");
+        ret = FWRITE_ERROR;
+    }
+
+    if (file != XBADFILE) {
+        XFCLOSE(file);
+    }
+    XFREE(mem, ctx->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    return ret;
+}
+
+/* Restore the context's OCSP staple cache from file.
+ *
+ * @param [in] ctx    SSL/TLS context.
+ * @param [in] fname  Filename to load the cache from.
+ * @return  WOLFSSL_SUCCESS on success.
+ * @return  BAD_FUNC_ARG when ctx or fname is NULL.
+ * @return  WOLFSSL_BAD_FILE when opening or reading file fails.
+ * @return  Other negative value on failure.
+ */
+int wolfSSL_CTX_restore_ocsp_staple_cache(WOLFSSL_CTX* ctx, const char* fname)
+{
+    int   ret = WOLFSSL_SUCCESS;
+    int   memSz = 0;
+    byte* mem = NULL;
+    XFILE file;
+
+    WOLFSSL_ENTER("wolfSSL_CTX_restore_ocsp_staple_cache");
+
+    if (ctx == NULL || ctx->cm == NULL || fname == NULL) {
+        return BAD_FUNC_ARG;
+    }
+
+    file = XFOPEN(fname, "rb");
+    if (file == XBADFILE) {
+        WOLFSSL_MSG("Couldn't open OCSP staple cache save file");
+        ret = WOLFSSL_BAD_FILE;
+    }
+    if (ret == WOLFSSL_SUCCESS &&
+            wolfssl_read_file(file, (char**)&mem, &memSz) != 0) {
+        ret = WOLFSSL_BAD_FILE;
+    }
+    if (ret == WOLFSSL_SUCCESS) {
+        ret = OcspStapleCacheMemRestore(ctx->cm->ocsp_stapling, mem, memSz);
+    }
+
+    /* wolfssl_read_file() allocates without a heap hint. */
+    XFREE(mem, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    if (file != XBADFILE) {
+        XFCLOSE(file);
+    }
+    return ret;
+}
+
+#endif /* !NO_FILESYSTEM */
+
+/* Persist the context's OCSP staple cache to memory.
+ *
+ * @param [in]  ctx   SSL/TLS context.
+ * @param [in]  mem   Memory to fill with the cache.
+ * @param [in]  sz    Size of memory in bytes.
+ * @param [out] used  The number of bytes of memory used.
+ * @return  WOLFSSL_SUCCESS on success.
+ * @return  BAD_FUNC_ARG when ctx, mem or used is NULL or sz is not positive.
+ * @return  BUFFER_E when memory is too small.
+ */
+int wolfSSL_CTX_memsave_ocsp_staple_cache(WOLFSSL_CTX* ctx, void* mem, int sz,
+                                          int* used)
+{
+    int ret;
+
+    WOLFSSL_ENTER("wolfSSL_CTX_memsave_ocsp_staple_cache");
+
+    if (ctx == NULL || ctx->cm == NULL || mem == NULL || used == NULL ||
+            sz <= 0) {
+        ret = BAD_FUNC_ARG;
+    }
+    else {
+        ret = OcspStapleCacheMemSave(ctx->cm->ocsp_stapling, mem, sz, used);
+    }
+
+    return ret;
+}
+
+/* Restore the context's OCSP staple cache from memory.
+ *
+ * Every response is verified again. Ones that fail, have expired or are for
+ * certificates the cache doesn't track are skipped.
+ *
+ * @param [in] ctx  SSL/TLS context.
+ * @param [in] mem  Memory holding a saved cache.
+ * @param [in] sz   Size of the saved cache in bytes.
+ * @return  WOLFSSL_SUCCESS on success.
+ * @return  BAD_FUNC_ARG when ctx or mem is NULL or sz is not positive.
+ * @return  BUFFER_E when the data is truncated.
+ * @return  CACHE_MATCH_ERROR when saved by an incompatible build.
+ */
+int wolfSSL_CTX_memrestore_ocsp_staple_cache(WOLFSSL_CTX* ctx, const void* mem,
+                                             int sz)
+{
+    int ret;
+
+    WOLFSSL_ENTER("wolfSSL_CTX_memrestore_ocsp_staple_cache");
+
+    if (ctx == NULL || ctx->cm == NULL || mem == NULL || sz <= 0) {
+        ret = BAD_FUNC_ARG;
+    }
+    else {
+        ret = OcspStapleCacheMemRestore(ctx->cm->ocsp_stapling, mem, sz);
+    }
+
+    return ret;
+}
+
+/* Get size of the context's OCSP staple cache when persisted.
+ *
+ * @param [in] ctx  SSL/TLS context.
+ * @return  Size of the cache when persisted in bytes.
+ * @return  BAD_FUNC_ARG when ctx is NULL or the cache is not enabled.
+ */
+int wolfSSL_CTX_get_ocsp_staple_cache_memsize(WOLFSSL_CTX* ctx)
+{
+    int ret;
+
+    WOLFSSL_ENTER("wolfSSL_CTX_get_ocsp_staple_cache_memsize");
+
+    if (ctx == NULL || ctx->cm == NULL) {
+        ret = BAD_FUNC_ARG;
+    }
+    else {
+        ret = OcspStapleCacheGetMemSize(ctx->cm->ocsp_stapling);
+    }
+
+    return ret;
+}
+#endif /* WOLFSSL_OCSP_STAPLE_CACHE */
 #endif /* HAVE_CERTIFICATE_STATUS_REQUEST || \
         * HAVE_CERTIFICATE_STATUS_REQUEST_V2 */
 
@@ -297,8 +297,13 @@ static int wolfSSL_write_internal(WOLFSSL* ssl, const void* data, size_t sz)
     WOLFSSL_ENTER("wolfSSL_write_internal");
 
     /* Validate parameters. Nothing on the way to the send reports zero, so ret
-     * doubles as the "keep going" flag. */
-    if ((ssl == NULL) || (data == NULL)) {
+     * doubles as the "keep going" flag. Data is NULL when wolfSSL_writev() has
+     * set the segments to send from. */
+    if ((ssl == NULL) || ((data == NULL)
+    #ifdef WOLFSSL_HAVE_IOV
+            && (ssl->buffers.sendIov == NULL)
+    #endif
+            )) {
         ret = BAD_FUNC_ARG;
     }
 
@@ -511,8 +516,13 @@ static int wolfSSL_read_internal(WOLFSSL* ssl, void* data, size_t sz, int peek)
 
     WOLFSSL_ENTER("wolfSSL_read_internal");
 
-    /* Validate parameters. */
-    if ((ssl == NULL) || (data == NULL)) {
+    /* Validate parameters. Data is NULL when wolfSSL_readv() has set the
+     * segments to receive into. */
+    if ((ssl == NULL) || ((data == NULL)
+    #ifdef WOLFSSL_HAVE_IOV
+            && (ssl->buffers.recvIov == NULL)
+    #endif
+            )) {
         ret = BAD_FUNC_ARG;
         done = 1;
     }
@@ -1150,14 +1160,41 @@ int wolfSSL_has_pending(const WOLFSSL* ssl)
     return ret;
 }
 
-#ifndef USE_WINDOWS_API
-#if !defined(NO_WRITEV) && !defined(NO_TLS)
+#ifdef WOLFSSL_HAVE_IOV
+
+/* Total up the length of an array of iovecs.
+ *
+ * @param [in]  iov     Array of buffers.
+ * @param [in]  iovcnt  Number of entries in iov.
+ * @param [out] total   Total length in bytes.
+ * @return  0 on success.
+ * @return  BAD_FUNC_ARG when iovcnt is negative, or iov is NULL with a
+ *          non-zero iovcnt.
+ * @return  BUFFER_E when the total length overflows.
+ */
+static int wolfssl_iov_len(const struct iovec* iov, int iovcnt, size_t* total)
+{
+    int ret = 0;
+    int i;
+
+    *total = 0;
+    if (((iov == NULL) && (iovcnt != 0)) || (iovcnt < 0)) {
+        ret = BAD_FUNC_ARG;
+    }
+    for (i = 0; (ret == 0) && (i < iovcnt); i++) {
+        if (!WC_SAFE_SUM_UNSIGNED(size_t, *total, iov[i].iov_len, *total)) {
+            ret = BUFFER_E;
+        }
+    }
+
+    return ret;
+}
 
 /* Write the data described by an array of iovecs to the peer.
  *
- * Simulates writev semantics, doesn't actually do block at a time though
- * because of SSL_write behavior and because front adds may be small. The
- * segments are gathered into one buffer and written as a single call.
+ * Records are built straight from the segments. Only a record that spans
+ * segments has its plaintext gathered, into a buffer no bigger than a record,
+ * before it is encrypted.
  *
  * @param [in, out] ssl     SSL/TLS object.
  * @param [in]      iov     Array of buffers to write.
@@ -1177,72 +1214,129 @@ int wolfSSL_writev(WOLFSSL* ssl, const struct iovec* iov, int iovcnt)
     #else
     byte   staticBuffer[FILE_BUFFER_SIZE];
     #endif
-    byte*  myBuffer = staticBuffer;
-    int    dynamic  = 0;
+    byte*  gather   = NULL;
+    word32 gatherSz = 0;
     size_t sending  = 0;
-    size_t idx      = 0;
-    int    i;
     int    ret      = 0;
 
     WOLFSSL_ENTER("wolfSSL_writev");
 
     /* Validate parameters before anything is read from the object. */
-    if ((ssl == NULL) || ((iov == NULL) && (iovcnt != 0)) || (iovcnt < 0)) {
+    if (ssl == NULL) {
         ret = BAD_FUNC_ARG;
     }
-
-    /* Total up the length being sent, checking for overflow. */
-    for (i = 0; (ret == 0) && (i < iovcnt); i++) {
-        if (!WC_SAFE_SUM_UNSIGNED(size_t, sending, iov[i].iov_len, sending)) {
-            ret = BUFFER_E;
-        }
+    if (ret == 0) {
+        ret = wolfssl_iov_len(iov, iovcnt, &sending);
     }
 
-    /* Gather into the stack buffer, or the heap when it doesn't fit. Small
-     * stack builds have a one byte buffer, so always take the heap. */
-    if ((ret == 0) && (sending > sizeof(staticBuffer))) {
-        myBuffer = (byte*)XMALLOC(sending, ssl->heap, DYNAMIC_TYPE_WRITEV);
-        if (myBuffer == NULL) {
-            ret = MEMORY_ERROR;
-        }
-        else {
-            dynamic = 1;
+    /* A single segment never needs gathering. A record spanning segments is
+     * gathered into the stack buffer, or the heap when a record doesn't fit.
+     * Small stack builds have a one byte buffer, so always take the heap. */
+    if ((ret == 0) && (iovcnt > 1)) {
+        gatherSz = (sending < MAX_RECORD_SIZE) ? (word32)sending :
+                                                 MAX_RECORD_SIZE;
+        gather = staticBuffer;
+        if (gatherSz > sizeof(staticBuffer)) {
+            gather = (byte*)XMALLOC(gatherSz, ssl->heap, DYNAMIC_TYPE_WRITEV);
+            if (gather == NULL) {
+                ret = MEMORY_ERROR;
+            }
         }
     }
 
     if (ret == 0) {
-        /* The loop below writes exactly the span that is read, but the
-         * compiler cannot see that. When wolfSSL_write_internal() is inlined
-         * here, the warning is reported against the SendData() call inside
-         * it rather than against the call below, and a diagnostic pragma
-         * only applies at the line the warning is reported on - so the one
-         * below cannot reach it. A definite store does. Do not remove: it is
-         * what keeps -Wmaybe-uninitialized quiet on builds that inline this,
-         * such as a powerpc64 cross build at -O2. */
-        myBuffer[0] = 0;
-
-        for (i = 0; i < iovcnt; i++) {
-            XMEMCPY(&myBuffer[idx], iov[i].iov_base, iov[i].iov_len);
-            idx += iov[i].iov_len;
-        }
-
-        /* Covers the warning when it is reported against the call itself
-         * instead, which is where it lands when there is no inlining. */
+        /* The segments are read through ssl->buffers.sendIov, but the
+         * compiler only sees staticBuffer being passed on uninitialized.
+         * When wolfSSL_write_internal() is inlined here, the warning is
+         * reported against the SendData() call inside it rather than against
+         * the call below, and a diagnostic pragma only applies at the line
+         * the warning is reported on - so the one below cannot reach it. A
+         * definite store does. Do not remove: it is what keeps
+         * -Wmaybe-uninitialized quiet on builds that inline this, such as a
+         * powerpc64 cross build at -O2. */
+        staticBuffer[0] = 0;
+
+        ssl->buffers.sendIov = iov;
+        ssl->buffers.sendIovCnt = iovcnt;
+        ssl->buffers.sendIovGather = gather;
+        ssl->buffers.sendIovGatherSz = gatherSz;
+
+        /* Segments may be NULL when empty, so pass a buffer instead. Covers
+         * the warning when it is reported against the call itself instead,
+         * which is where it lands when there is no inlining. */
         PRAGMA_GCC_DIAG_PUSH
         PRAGMA_GCC("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
-        ret = wolfSSL_write_internal(ssl, myBuffer, sending);
+        ret = wolfSSL_write_internal(ssl, (sending == 0) ? staticBuffer : NULL,
+            sending);
         PRAGMA_GCC_DIAG_POP
+
+        ssl->buffers.sendIov = NULL;
+        ssl->buffers.sendIovCnt = 0;
+        ssl->buffers.sendIovGather = NULL;
+        ssl->buffers.sendIovGatherSz = 0;
     }
 
-    /* Only set when the allocation above succeeded, so ssl is not NULL. */
-    if (dynamic) {
-        XFREE(myBuffer, ssl->heap, DYNAMIC_TYPE_WRITEV);
+    /* Gather buffer held plaintext. Only set when ssl is not NULL. */
+    if (gather != NULL) {
+        ForceZero(gather, gatherSz);
+        if (gather != staticBuffer) {
+            XFREE(gather, ssl->heap, DYNAMIC_TYPE_WRITEV);
+        }
     }
 
     return ret;
 }
-#endif
-#endif
+
+/* Read application data from the peer into an array of iovecs.
+ *
+ * Like wolfSSL_read(), at most one record's data is returned. The data is
+ * copied from the decrypted record straight into the segments, in order.
+ *
+ * @param [in, out] ssl     SSL/TLS object.
+ * @param [in]      iov     Array of buffers to fill.
+ * @param [in]      iovcnt  Number of entries in iov.
+ * @return  Number of bytes read on success.
+ * @return  0 when the peer has closed the connection.
+ * @return  BAD_FUNC_ARG when ssl is NULL, iovcnt is negative, or iov is
+ *          NULL with a non-zero iovcnt.
+ * @return  BUFFER_E when the total length of the segments overflows.
+ * @return  WOLFSSL_FATAL_ERROR when the read fails. Call wolfSSL_get_error()
+ *          for the reason.
+ */
+int wolfSSL_readv(WOLFSSL* ssl, const struct iovec* iov, int iovcnt)
+{
+    byte   empty[1];
+    size_t reading = 0;
+    int    ret     = 0;
+
+    WOLFSSL_ENTER("wolfSSL_readv");
+
+    /* Validate parameters before anything is read from the object. */
+    if (ssl == NULL) {
+        ret = BAD_FUNC_ARG;
+    }
+    if (ret == 0) {
+        ret = wolfssl_iov_len(iov, iovcnt, &reading);
+    }
+    if ((ret == 0) && (reading > INT_MAX)) {
+        ret = BAD_FUNC_ARG;
+    }
+
+    if (ret == 0) {
+        ssl->buffers.recvIov = iov;
+        ssl->buffers.recvIovCnt = iovcnt;
+
+        /* Segments may be NULL when empty, so pass a buffer instead. */
+        ret = wolfSSL_read_internal(ssl, (reading == 0) ? empty : NULL,
+            reading, FALSE);
+
+        ssl->buffers.recvIov = NULL;
+        ssl->buffers.recvIovCnt = 0;
+    }
+
+    return ret;
+}
+#endif /* WOLFSSL_HAVE_IOV */
 
 #ifdef OPENSSL_EXTRA
 /* Get the I/O operation the SSL/TLS object is waiting on.
@@ -78,6 +78,463 @@ static WC_INLINE WOLFSSL_METHOD* cm_pick_method(void* heap)
     #endif
 }
 
+#ifdef WOLFSSL_CA_INDEX
+/* Resizable index over the CA table.
+ *
+ * The caTable rows stay the owners of the signers. The index only holds
+ * borrowed pointers in open addressed tables, one keyed on the signer's
+ * subject key id hash (as the rows are) and one keyed on the subject name
+ * hash, so lookups don't walk CA_TABLE_SIZE long chains when tens of
+ * thousands of CAs are loaded.
+ *
+ * Writers hold caLock and publish changes under the write side of caIdxLock.
+ * Readers only take the read side of caIdxLock. When there is no index, for
+ * instance after an allocation failure, readers fall back to walking the rows
+ * under caLock.
+ */
+struct CA_Index {
+    Signer** keyTbl;    /* keyed on the same hash as the caTable rows */
+#ifndef NO_SKID
+    Signer** nameTbl;   /* keyed on the subject name hash */
+#endif
+    word32   mask;      /* number of slots - 1, slots is a power of 2 */
+    word32   count;     /* number of signers indexed */
+};
+
+/* Smallest number of slots in an index table. */
+#define CA_INDEX_MIN_SLOTS  64
+/* Largest number of signers indexed. */
+#define CA_INDEX_MAX_COUNT  0x1000000
+
+/* Get the hash a signer is stored under in the caTable rows. */
+static WC_INLINE const byte* ca_index_key(const Signer* s)
+{
+#ifndef NO_SKID
+    return s->subjectKeyIdHash;
+#else
+    return s->subjectNameHash;
+#endif
+}
+
+/* Get the caTable row a signer is stored in. */
+static WC_INLINE word32 ca_index_row(const Signer* s)
+{
+    return MakeWordFromHash(ca_index_key(s)) % CA_TABLE_SIZE;
+}
+
+/* Put a signer into a table so that a lookup returns the same signer as a
+ * walk of the caTable rows.
+ *
+ * A signer already in the table with the same hash is kept unless s was
+ * just added to the head of its row and a row walk now finds s first: rows
+ * are newest first and by name walks go through the rows in order.
+ *
+ * @param [in] tbl     Table of signers.
+ * @param [in] mask    Number of slots - 1.
+ * @param [in] hash    Hash of s the table is keyed on.
+ * @param [in] byName  Whether the table is keyed on the subject name hash.
+ * @param [in] s       Signer to put.
+ * @param [in] newest  Whether s is the newest signer in its row.
+ */
+static void ca_index_put(Signer** tbl, word32 mask, const byte* hash,
+    int byName, Signer* s, int newest)
+{
+    word32 i = MakeWordFromHash(hash) & mask;
+    Signer* cur;
+
+    while ((cur = tbl[i]) != NULL) {
+        const byte* curHash = byName ? cur->subjectNameHash :
+                                       ca_index_key(cur);
+
+        if (XMEMCMP(hash, curHash, SIGNER_DIGEST_SIZE) == 0) {
+            if (newest && (!byName || ca_index_row(s) <= ca_index_row(cur))) {
+                tbl[i] = s;
+            }
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    tbl[i] = s;
+}
+
+/* Add a signer to the index. There must be a free slot in each table.
+ *
+ * @param [in] idx     Index.
+ * @param [in] s       Signer to add.
+ * @param [in] newest  Whether s was just put at the head of its row. When
+ *                     building from the rows, signers are added in row order
+ *                     and the first one with a hash is kept.
+ */
+static void ca_index_add(CA_Index* idx, Signer* s, int newest)
+{
+    ca_index_put(idx->keyTbl, idx->mask, ca_index_key(s), 0, s, newest);
+#ifndef NO_SKID
+    ca_index_put(idx->nameTbl, idx->mask, s->subjectNameHash, 1, s, newest);
+#endif
+    idx->count++;
+}
+
+/* Find the signer with the hash in a table.
+ *
+ * @param [in] tbl     Table of signers.
+ * @param [in] mask    Number of slots - 1.
+ * @param [in] hash    Hash to find.
+ * @param [in] byName  Whether the table is keyed on the subject name hash.
+ * @return  Signer on success.
+ * @return  NULL when not in the table.
+ */
+static Signer* ca_index_find(Signer** tbl, word32 mask, const byte* hash,
+    int byName)
+{
+    word32 i = MakeWordFromHash(hash) & mask;
+    Signer* s;
+
+    while ((s = tbl[i]) != NULL) {
+        const byte* sHash = byName ? s->subjectNameHash : ca_index_key(s);
+
+        if (XMEMCMP(hash, sHash, SIGNER_DIGEST_SIZE) == 0) {
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+
+    return s;
+}
+
+/* Build an index of all signers in the CA table.
+ *
+ * The tables are sized so that at least as many signers again can be added
+ * before the index has to be rebuilt.
+ *
+ * Caller must hold caLock.
+ *
+ * @param [in] cm  Certificate manager.
+ * @return  Index on success.
+ * @return  NULL when the table is empty or on allocation failure.
+ */
+static CA_Index* ca_index_build(WOLFSSL_CERT_MANAGER* cm)
+{
+    CA_Index* idx = NULL;
+    Signer* s;
+    word32 count = 0;
+    word32 slots = CA_INDEX_MIN_SLOTS;
+    word32 tbls = 1;
+    int row;
+
+    for (row = 0; row < CA_TABLE_SIZE; row++) {
+        for (s = cm->caTable[row]; s != NULL; s = s->next) {
+            count++;
+        }
+    }
+
+    if ((count > 0) && (count <= CA_INDEX_MAX_COUNT)) {
+        /* Keep the load at a quarter so probe runs stay short. */
+        while (slots < 4 * count) {
+            slots <<= 1;
+        }
+    #ifndef NO_SKID
+        tbls = 2;
+    #endif
+        idx = (CA_Index*)XMALLOC(sizeof(CA_Index) +
+            tbls * slots * sizeof(Signer*), cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+    }
+    if (idx != NULL) {
+        XMEMSET(idx, 0, sizeof(CA_Index) + tbls * slots * sizeof(Signer*));
+        idx->keyTbl = (Signer**)(idx + 1);
+    #ifndef NO_SKID
+        idx->nameTbl = idx->keyTbl + slots;
+    #endif
+        idx->mask = slots - 1;
+
+        for (row = 0; row < CA_TABLE_SIZE; row++) {
+            for (s = cm->caTable[row]; s != NULL; s = s->next) {
+                ca_index_add(idx, s, 0);
+            }
+        }
+    }
+    (void)tbls;
+
+    return idx;
+}
+
+/* Publish a new index, or none, and dispose of the old one.
+ *
+ * Caller must hold caLock.
+ *
+ * @param [in] cm   Certificate manager.
+ * @param [in] idx  New index. May be NULL.
+ * @return  0 on success.
+ * @return  BAD_MUTEX_E when locking fails. idx is disposed of.
+ */
+static int ca_index_swap(WOLFSSL_CERT_MANAGER* cm, CA_Index* idx)
+{
+    CA_Index* old;
+
+    if (wc_LockRwLock_Wr(&cm->caIdxLock) != 0) {
+        WOLFSSL_MSG("wc_LockRwLock_Wr on caIdxLock failed");
+        XFREE(idx, cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+        return BAD_MUTEX_E;
+    }
+    old = cm->caIdx;
+    cm->caIdx = idx;
+    wc_UnLockRwLock(&cm->caIdxLock);
+
+    /* No reader can see the old index any more. */
+    XFREE(old, cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+    return 0;
+}
+
+/* Rebuild the index from the CA table.
+ *
+ * The index is built before taking caIdxLock so readers are only held up
+ * for the pointer swap. When the build fails, the index is dropped and
+ * readers fall back to the rows.
+ *
+ * Caller must hold caLock.
+ *
+ * @param [in] cm  Certificate manager.
+ */
+static void ca_index_rebuild(WOLFSSL_CERT_MANAGER* cm)
+{
+    if (cm->caIdxLockInit) {
+        (void)ca_index_swap(cm, ca_index_build(cm));
+    }
+}
+
+/* Drop the index before signers are removed from the CA table.
+ *
+ * Caller must hold caLock.
+ *
+ * @param [in] cm  Certificate manager.
+ * @return  0 on success.
+ * @return  BAD_MUTEX_E when locking fails. Signers must not be freed.
+ */
+static int ca_index_clear(WOLFSSL_CERT_MANAGER* cm)
+{
+    if (!cm->caIdxLockInit) {
+        return 0;
+    }
+    return ca_index_swap(cm, NULL);
+}
+
+/* Index a signer just added to the CA table.
+ *
+ * Grows the index when it is half full.
+ *
+ * Caller must hold caLock.
+ *
+ * @param [in] cm  Certificate manager.
+ * @param [in] s   Signer added to the CA table.
+ */
+static void ca_index_insert(WOLFSSL_CERT_MANAGER* cm, Signer* s)
+{
+    int added = 0;
+
+    if (!cm->caIdxLockInit) {
+        return;
+    }
+    if (wc_LockRwLock_Wr(&cm->caIdxLock) == 0) {
+        if ((cm->caIdx != NULL) &&
+                (2 * (cm->caIdx->count + 1) <= cm->caIdx->mask + 1)) {
+            ca_index_add(cm->caIdx, s, 1);
+            added = 1;
+        }
+        wc_UnLockRwLock(&cm->caIdxLock);
+    }
+    if (!added) {
+        ca_index_rebuild(cm);
+    }
+}
+
+/* Look up a signer in the index.
+ *
+ * @param [in]  cm      Certificate manager.
+ * @param [in]  hash    Hash to find.
+ * @param [in]  byName  Whether hash is the subject name hash.
+ * @param [out] found   Signer found or NULL.
+ * @return  1 when the index answered the lookup.
+ * @return  0 when the caller needs to walk the CA table rows.
+ */
+static int ca_index_lookup(WOLFSSL_CERT_MANAGER* cm, const byte* hash,
+    int byName, Signer** found)
+{
+    int used = 0;
+
+    if (!cm->caIdxLockInit || (wc_LockRwLock_Rd(&cm->caIdxLock) != 0)) {
+        return 0;
+    }
+    if (cm->caIdx != NULL) {
+    #ifndef NO_SKID
+        Signer** tbl = byName ? cm->caIdx->nameTbl : cm->caIdx->keyTbl;
+    #else
+        Signer** tbl = cm->caIdx->keyTbl;
+    #endif
+        *found = ca_index_find(tbl, cm->caIdx->mask, hash, byName);
+        used = 1;
+    }
+    wc_UnLockRwLock(&cm->caIdxLock);
+
+    return used;
+}
+#endif /* WOLFSSL_CA_INDEX */
+
+#ifdef WOLFSSL_CHAIN_CACHE
+/* Cache of peer certificate chains that have been verified.
+ *
+ * Entries are keyed on a SHA-256 digest of the chain's DER encodings. When a
+ * peer sends a chain whose digest is found, the signatures in it are not
+ * checked again. Everything else - signer lookup, dates, name constraints,
+ * path length, CRL and OCSP - is still done on each certificate.
+ *
+ * Each entry is stamped with the generation of the cache it was added in.
+ * Changing the CA table or reloading a CRL bumps the generation so that all
+ * existing entries are stale. An entry is only added when the generation is
+ * the same as when the chain was looked up.
+ */
+typedef struct ChainCacheEntry {
+    byte   digest[WC_SHA256_DIGEST_SIZE]; /* digest of the chain */
+    word32 gen;                           /* generation added in, 0 unused */
+} ChainCacheEntry;
+
+struct ChainCache {
+    ChainCacheEntry* entries; /* table of entries */
+    word32           sz;      /* number of entries in table */
+    word32           gen;     /* current generation, never 0 */
+    word32           hits;    /* lookups that found the chain */
+    word32           misses;  /* lookups that didn't find the chain */
+};
+
+/* Largest number of entries in a chain cache. */
+#define CHAIN_CACHE_MAX_ENTRIES  65536
+/* Number of entries checked from the digest's slot. */
+#define CHAIN_CACHE_PROBES       4
+
+/* Find the entry for a digest in the current generation.
+ *
+ * Call with chainCacheLock held.
+ *
+ * @param [in] cache   Chain cache.
+ * @param [in] digest  Digest of chain.
+ * @return  Entry on success.
+ * @return  NULL when not found.
+ */
+static ChainCacheEntry* chain_cache_find(ChainCache* cache, const byte* digest)
+{
+    word32 i = MakeWordFromHash(digest) % cache->sz;
+    int n;
+
+    for (n = 0; n < CHAIN_CACHE_PROBES; n++) {
+        ChainCacheEntry* e = &cache->entries[i];
+        if ((e->gen == cache->gen) &&
+                (XMEMCMP(e->digest, digest, WC_SHA256_DIGEST_SIZE) == 0)) {
+            return e;
+        }
+        if (++i == cache->sz) {
+            i = 0;
+        }
+    }
+
+    return NULL;
+}
+
+/* Look up a chain in the certificate manager's chain cache.
+ *
+ * @param [in]  cm      Certificate manager.
+ * @param [in]  digest  SHA-256 digest of chain.
+ * @param [out] gen     Generation of cache to pass to CM_ChainCacheAdd().
+ *                      0 when there is no cache.
+ * @return  1 when chain was verified before.
+ * @return  0 otherwise.
+ */
+int CM_ChainCacheLookup(WOLFSSL_CERT_MANAGER* cm, const byte* digest,
+    word32* gen)
+{
+    int found = 0;
+
+    *gen = 0;
+    if (!cm->chainCacheLockInit || (wc_LockMutex(&cm->chainCacheLock) != 0)) {
+        return 0;
+    }
+    if (cm->chainCache != NULL) {
+        found = (chain_cache_find(cm->chainCache, digest) != NULL);
+        if (found) {
+            cm->chainCache->hits++;
+        }
+        else {
+            cm->chainCache->misses++;
+        }
+        *gen = cm->chainCache->gen;
+    }
+    wc_UnLockMutex(&cm->chainCacheLock);
+
+    return found;
+}
+
+/* Add a verified chain to the certificate manager's chain cache.
+ *
+ * Chain is not added when the cache has been invalidated since the lookup.
+ *
+ * @param [in] cm      Certificate manager.
+ * @param [in] digest  SHA-256 digest of chain.
+ * @param [in] gen     Generation returned by CM_ChainCacheLookup().
+ */
+void CM_ChainCacheAdd(WOLFSSL_CERT_MANAGER* cm, const byte* digest, word32 gen)
+{
+    ChainCache* cache;
+
+    if ((gen == 0) || !cm->chainCacheLockInit ||
+            (wc_LockMutex(&cm->chainCacheLock) != 0)) {
+        return;
+    }
+    cache = cm->chainCache;
+    if ((cache != NULL) && (cache->gen == gen) &&
+            (chain_cache_find(cache, digest) == NULL)) {
+        word32 start = MakeWordFromHash(digest) % cache->sz;
+        word32 i = start;
+        int n;
+
+        /* Use first stale entry, otherwise replace the digest's own slot. */
+        for (n = 0; n < CHAIN_CACHE_PROBES; n++) {
+            if (cache->entries[i].gen != gen) {
+                start = i;
+                break;
+            }
+            if (++i == cache->sz) {
+                i = 0;
+            }
+        }
+        XMEMCPY(cache->entries[start].digest, digest, WC_SHA256_DIGEST_SIZE);
+        cache->entries[start].gen = gen;
+    }
+    wc_UnLockMutex(&cm->chainCacheLock);
+}
+
+/* Make all chains in the certificate manager's chain cache stale.
+ *
+ * Called when the CA table changes or a CRL is loaded. May be called with
+ * caLock held.
+ *
+ * @param [in] cm  Certificate manager.
+ */
+void CM_ChainCacheInvalidate(WOLFSSL_CERT_MANAGER* cm)
+{
+    if ((cm == NULL) || !cm->chainCacheLockInit ||
+            (wc_LockMutex(&cm->chainCacheLock) != 0)) {
+        return;
+    }
+    if (cm->chainCache != NULL) {
+        ChainCache* cache = cm->chainCache;
+
+        if (++cache->gen == 0) {
+            /* Wrapped - entries from old generations could match again. */
+            XMEMSET(cache->entries, 0, cache->sz * sizeof(ChainCacheEntry));
+            cache->gen = 1;
+        }
+    }
+    wc_UnLockMutex(&cm->chainCacheLock);
+}
+#endif /* WOLFSSL_CHAIN_CACHE */
+
 static void DoCertManagerFree(WOLFSSL_CERT_MANAGER* cm);
 
 /* Create a new certificate manager with a heap hint.
@@ -125,6 +582,30 @@ WOLFSSL_CERT_MANAGER* wolfSSL_CertManagerNew_ex(void* heap)
             cm->caLockInit = 1;
         }
     }
+#ifdef WOLFSSL_CA_INDEX
+    if (!err) {
+        /* Create a lock for readers of the CA index. */
+        if (wc_InitRwLock(&cm->caIdxLock) != 0) {
+            WOLFSSL_MSG("Bad rwlock init");
+            err = 1;
+        }
+        else {
+            cm->caIdxLockInit = 1;
+        }
+    }
+#endif
+#ifdef WOLFSSL_CHAIN_CACHE
+    if (!err) {
+        /* Create a mutex for use when accessing the chain cache. */
+        if (wc_InitMutex(&cm->chainCacheLock) != 0) {
+            WOLFSSL_MSG("Bad mutex init");
+            err = 1;
+        }
+        else {
+            cm->chainCacheLockInit = 1;
+        }
+    }
+#endif
     if (!err) {
         /* Initialize reference count. */
         wolfSSL_RefInit(&cm->ref, &err);
@@ -222,7 +703,21 @@ static void DoCertManagerFree(WOLFSSL_CERT_MANAGER* cm)
 #endif
 #endif /* HAVE_OCSP */
 
+#ifdef WOLFSSL_CHAIN_CACHE
+    /* Dispose of chain cache and mutex. */
+    XFREE(cm->chainCache, cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+    if (cm->chainCacheLockInit) {
+        wc_FreeMutex(&cm->chainCacheLock);
+    }
+#endif
+
     /* Dispose of CA table and mutex. */
+#ifdef WOLFSSL_CA_INDEX
+    XFREE(cm->caIdx, cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+    if (cm->caIdxLockInit) {
+        wc_FreeRwLock(&cm->caIdxLock);
+    }
+#endif
     FreeSignerTable(cm->caTable, CA_TABLE_SIZE, cm->heap);
     if (cm->caLockInit) {
         wc_FreeMutex(&cm->caLock);
@@ -481,8 +976,20 @@ int wolfSSL_CertManagerUnloadCAs(WOLFSSL_CERT_MANAGER* cm)
         ret = BAD_MUTEX_E;
     }
     if (ret == WOLFSSL_SUCCESS) {
-        /* Dispose of CA table. */
-        FreeSignerTable(cm->caTable, CA_TABLE_SIZE, cm->heap);
+    #ifdef WOLFSSL_CA_INDEX
+        /* Stop readers using the index before the signers go. */
+        ret = ca_index_clear(cm);
+        if (ret == 0)
+    #endif
+        {
+            /* Dispose of CA table. */
+            FreeSignerTable(cm->caTable, CA_TABLE_SIZE, cm->heap);
+        #ifdef WOLFSSL_CHAIN_CACHE
+            /* Chains verified with the old CAs can't be trusted now. */
+            CM_ChainCacheInvalidate(cm);
+        #endif
+            ret = WOLFSSL_SUCCESS;
+        }
 
         /* Unlock CA table. */
         wc_UnLockMutex(&cm->caLock);
@@ -507,9 +1014,25 @@ int wolfSSL_CertManagerUnloadTypeCerts(
         ret = BAD_MUTEX_E;
     }
     if (ret == WOLFSSL_SUCCESS) {
-        /* Dispose of CA table. */
-        FreeSignerTableType(cm->caTable, CA_TABLE_SIZE, type,
-                cm->heap);
+    #ifdef WOLFSSL_CA_INDEX
+        /* Stop readers using the index before the signers go. */
+        ret = ca_index_clear(cm);
+        if (ret == 0)
+    #endif
+        {
+            /* Dispose of CA table. */
+            FreeSignerTableType(cm->caTable, CA_TABLE_SIZE, type,
+                    cm->heap);
+        #ifdef WOLFSSL_CHAIN_CACHE
+            /* Chains may have been verified with the removed CAs. */
+            CM_ChainCacheInvalidate(cm);
+        #endif
+        #ifdef WOLFSSL_CA_INDEX
+            /* Index the signers that remain. */
+            ca_index_rebuild(cm);
+        #endif
+            ret = WOLFSSL_SUCCESS;
+        }
 
         /* Unlock CA table. */
         wc_UnLockMutex(&cm->caLock);
@@ -568,6 +1091,141 @@ int wolfSSL_CertManagerUnload_trust_peers(WOLFSSL_CERT_MANAGER* cm)
 }
 #endif /* WOLFSSL_TRUST_PEER_CERT */
 
+#ifdef WOLFSSL_CHAIN_CACHE
+/* Enable caching of verified peer certificate chains.
+ *
+ * Replaces any existing cache, dropping its entries and statistics.
+ *
+ * @param [in] cm       Certificate manager.
+ * @param [in] entries  Number of chains to cache. Capped at 65536.
+ * @return  WOLFSSL_SUCCESS on success.
+ * @return  BAD_FUNC_ARG when cm is NULL or entries is not positive.
+ * @return  MEMORY_E when dynamic memory allocation fails.
+ * @return  BAD_MUTEX_E when locking fails.
+ */
+int wolfSSL_CertManagerEnableChainCache(WOLFSSL_CERT_MANAGER* cm, int entries)
+{
+    int ret = WOLFSSL_SUCCESS;
+    ChainCache* cache = NULL;
+    ChainCache* old = NULL;
+
+    WOLFSSL_ENTER("wolfSSL_CertManagerEnableChainCache");
+
+    /* Validate parameters. */
+    if ((cm == NULL) || (entries <= 0)) {
+        ret = BAD_FUNC_ARG;
+    }
+    if (ret == WOLFSSL_SUCCESS) {
+        word32 sz = (word32)entries;
+
+        if (sz > CHAIN_CACHE_MAX_ENTRIES) {
+            sz = CHAIN_CACHE_MAX_ENTRIES;
+        }
+        /* Allocate cache and entries in one block. */
+        cache = (ChainCache*)XMALLOC(sizeof(ChainCache) +
+            sz * sizeof(ChainCacheEntry), cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+        if (cache == NULL) {
+            ret = MEMORY_E;
+        }
+        else {
+            XMEMSET(cache, 0, sizeof(ChainCache) +
+                sz * sizeof(ChainCacheEntry));
+            cache->entries = (ChainCacheEntry*)(cache + 1);
+            cache->sz = sz;
+            cache->gen = 1;
+        }
+    }
+    if ((ret == WOLFSSL_SUCCESS) && (wc_LockMutex(&cm->chainCacheLock) != 0)) {
+        ret = BAD_MUTEX_E;
+    }
+    if (ret == WOLFSSL_SUCCESS) {
+        old = cm->chainCache;
+        cm->chainCache = cache;
+        cache = NULL;
+        wc_UnLockMutex(&cm->chainCacheLock);
+    }
+
+    if (cm != NULL) {
+        XFREE(cache, cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+        XFREE(old, cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+    }
+    return ret;
+}
+
+/* Disable caching of verified peer certificate chains.
+ *
+ * @param [in] cm  Certificate manager.
+ * @return  WOLFSSL_SUCCESS on success.
+ * @return  BAD_FUNC_ARG when cm is NULL.
+ * @return  BAD_MUTEX_E when locking fails.
+ */
+int wolfSSL_CertManagerDisableChainCache(WOLFSSL_CERT_MANAGER* cm)
+{
+    int ret = WOLFSSL_SUCCESS;
+    ChainCache* old = NULL;
+
+    WOLFSSL_ENTER("wolfSSL_CertManagerDisableChainCache");
+
+    /* Validate parameter. */
+    if (cm == NULL) {
+        ret = BAD_FUNC_ARG;
+    }
+    if ((ret == WOLFSSL_SUCCESS) && (wc_LockMutex(&cm->chainCacheLock) != 0)) {
+        ret = BAD_MUTEX_E;
+    }
+    if (ret == WOLFSSL_SUCCESS) {
+        old = cm->chainCache;
+        cm->chainCache = NULL;
+        wc_UnLockMutex(&cm->chainCacheLock);
+        XFREE(old, cm->heap, DYNAMIC_TYPE_CERT_MANAGER);
+    }
+
+    return ret;
+}
+
+/* Get the number of chain cache lookups that hit and missed.
+ *
+ * @param [in]  cm      Certificate manager.
+ * @param [out] hits    Number of chains found in cache. May be NULL.
+ * @param [out] misses  Number of chains not found in cache. May be NULL.
+ * @return  WOLFSSL_SUCCESS on success.
+ * @return  BAD_FUNC_ARG when cm is NULL.
+ * @return  BAD_MUTEX_E when locking fails.
+ * @return  WOLFSSL_FATAL_ERROR when chain cache is not enabled.
+ */
+int wolfSSL_CertManagerGetChainCacheStats(WOLFSSL_CERT_MANAGER* cm,
+    word32* hits, word32* misses)
+{
+    int ret = WOLFSSL_SUCCESS;
+
+    WOLFSSL_ENTER("wolfSSL_CertManagerGetChainCacheStats");
+
+    /* Validate parameter. */
+    if (cm == NULL) {
+        ret = BAD_FUNC_ARG;
+    }
+    if ((ret == WOLFSSL_SUCCESS) && (wc_LockMutex(&cm->chainCacheLock) != 0)) {
+        ret = BAD_MUTEX_E;
+    }
+    if (ret == WOLFSSL_SUCCESS) {
+        if (cm->chainCache == NULL) {
+            ret = WOLFSSL_FATAL_ERROR;
+        }
+        else {
+            if (hits != NULL) {
+                *hits = cm->chainCache->hits;
+            }
+            if (misses != NULL) {
+                *misses = cm->chainCache->misses;
+            }
+        }
+        wc_UnLockMutex(&cm->chainCacheLock);
+    }
+
+    return ret;
+}
+#endif /* WOLFSSL_CHAIN_CACHE */
+
 /* Load certificate/s from buffer with flags and type.
  *
  * @param [in] cm         Certificate manager.
@@ -1677,6 +2335,18 @@ int CM_MemRestoreCertCache(WOLFSSL_CERT_MANAGER* cm, const void* mem, int sz)
         ret = BAD_MUTEX_E;
     }
 
+#ifdef WOLFSSL_CA_INDEX
+    if (ret == WOLFSSL_SUCCESS) {
+        /* Stop readers using the index before the signers go. */
+        ret = ca_index_clear(cm);
+        if (ret != 0) {
+            wc_UnLockMutex(&cm->caLock);
+        }
+        else {
+            ret = WOLFSSL_SUCCESS;
+        }
+    }
+#endif
     if (ret == WOLFSSL_SUCCESS) {
         /* Dispose of current CA certificate table. */
         FreeSignerTable(cm->caTable, CA_TABLE_SIZE, cm->heap);
@@ -1695,6 +2365,14 @@ int CM_MemRestoreCertCache(WOLFSSL_CERT_MANAGER* cm, const void* mem, int sz)
             /* Update pointer to data of next row. */
             current += added;
         }
+    #ifdef WOLFSSL_CA_INDEX
+        /* Index the restored signers. */
+        ca_index_rebuild(cm);
+    #endif
+    #ifdef WOLFSSL_CHAIN_CACHE
+        /* CA table replaced - chains need verifying against new CAs. */
+        CM_ChainCacheInvalidate(cm);
+    #endif
 
         /* Unlock CA table. */
         wc_UnLockMutex(&cm->caLock);
@@ -2177,6 +2855,11 @@ int wolfSSL_CertManagerLoadCRLFile(WOLFSSL_CERT_MANAGER* cm, const char* file,
 
     if (ret == WOLFSSL_SUCCESS) {
         /* Load CRL file into CRL object of certificate manager. */
+    #ifdef HAVE_CRL_MMAP
+        if (type == WOLFSSL_FILETYPE_ASN1)
+            ret = LoadMappedCRL(cm->crl, file);
+        else
+    #endif
         ret = ProcessFile(NULL, file, type, CRL_TYPE, NULL, 0, cm->crl, VERIFY);
     }
 
@@ -2701,6 +3384,12 @@ int AlreadySigner(WOLFSSL_CERT_MANAGER* cm, byte* hash)
         return ret;
     }
 
+#ifdef WOLFSSL_CA_INDEX
+    if (ca_index_lookup(cm, hash, 0, &signers)) {
+        return signers != NULL;
+    }
+#endif
+
     row = HashSigner(hash);
 
     if (wc_LockMutex(&cm->caLock) != 0) {
@@ -2849,6 +3538,11 @@ Signer* GetCA(void* vp, byte* hash)
     if (cm == NULL || hash == NULL)
         return NULL;
 
+#ifdef WOLFSSL_CA_INDEX
+    if (ca_index_lookup(cm, hash, 0, &ret))
+        return ret;
+#endif
+
     row = HashSigner(hash);
 
     if (wc_LockMutex(&cm->caLock) != 0)
@@ -2962,6 +3656,11 @@ Signer* GetCAByName(void* vp, byte* hash)
     if (cm == NULL)
         return NULL;
 
+#ifdef WOLFSSL_CA_INDEX
+    if (hash != NULL && ca_index_lookup(cm, hash, 1, &ret))
+        return ret;
+#endif
+
     if (wc_LockMutex(&cm->caLock) != 0)
         return ret;
 
@@ -3122,6 +3821,9 @@ int AddSigner(WOLFSSL_CERT_MANAGER* cm, Signer *s)
     signers = cm->caTable[row];
     s->next = signers;
     cm->caTable[row] = s;
+#ifdef WOLFSSL_CA_INDEX
+    ca_index_insert(cm, s);
+#endif
 
     wc_UnLockMutex(&cm->caLock);
     return 0;
@@ -3380,6 +4082,9 @@ int AddCA(WOLFSSL_CERT_MANAGER* cm, DerBuffer** pDer, int type, int verify)
         if (ret == 0 && wc_LockMutex(&cm->caLock) == 0) {
             signer->next = cm->caTable[row];
             cm->caTable[row] = signer;   /* takes ownership */
+        #ifdef WOLFSSL_CA_INDEX
+            ca_index_insert(cm, signer);
+        #endif
             wc_UnLockMutex(&cm->caLock);
             if (cm->caCacheCallback)
                 cm->caCacheCallback(der->buffer, (int)der->length, type);
@@ -3437,8 +4142,21 @@ int RemoveCA(WOLFSSL_CERT_MANAGER* cm, byte* hash, int type)
 
         if ((current->type == type) &&
             (XMEMCMP(hash, subjectHash, SIGNER_DIGEST_SIZE) == 0)) {
+        #ifdef WOLFSSL_CA_INDEX
+            /* Stop readers using the index before the signer goes. */
+            if (ca_index_clear(cm) != 0) {
+                ret = BAD_MUTEX_E;
+                break;
+            }
+        #endif
             *prev = current->next;
             FreeSigner(current, cm->heap);
+        #ifdef WOLFSSL_CA_INDEX
+            ca_index_rebuild(cm);
+        #endif
+        #ifdef WOLFSSL_CHAIN_CACHE
+            CM_ChainCacheInvalidate(cm);
+        #endif
             ret = WOLFSSL_SUCCESS;
             break;
         }
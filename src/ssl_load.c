@@ -610,6 +610,13 @@ static int ProcessBufferTryDecodeEcc(WOLFSSL_CTX* ctx, WOLFSSL* ssl,
                 WOLFSSL_MSG("ECC private key too small");
                 ret = ECC_KEY_SIZE_E;
             }
+        #ifdef FP_ECC_SHARED
+            /* Pin the key's fixed point tables once so that all threads
+             * handshaking with it share them. Failure only costs speed. */
+            if ((ret == 0) && (devId == INVALID_DEVID)) {
+                (void)wc_ecc_fp_share_key(key);
+            }
+        #endif
             /* Static ECC key possible. */
             if (ssl) {
                 ssl->options.haveStaticECC = 1;
@@ -268,7 +268,8 @@ static int wolfssl_file_len(XFILE fp, long* fileSz)
 }
 #endif
 
-#if (defined(OPENSSL_EXTRA) || defined(PERSIST_CERT_CACHE)) && \
+#if (defined(OPENSSL_EXTRA) || defined(PERSIST_CERT_CACHE) || \
+     defined(WOLFSSL_OCSP_STAPLE_CACHE)) && \
     !defined(WOLFCRYPT_ONLY) && !defined(NO_FILESYSTEM)
 /* Read all the data from a file.
  *
@@ -306,8 +307,8 @@ static int wolfssl_read_file(XFILE fp, char** data, int* dataSz)
     XFREE(mem, NULL, DYNAMIC_TYPE_TMP_BUFFER);
     return ret;
 }
-#endif /* (OPENSSL_EXTRA || PERSIST_CERT_CACHE) && !WOLFCRYPT_ONLY &&
-        * !NO_FILESYSTEM */
+#endif /* (OPENSSL_EXTRA || PERSIST_CERT_CACHE ||
+        *  WOLFSSL_OCSP_STAPLE_CACHE) && !WOLFCRYPT_ONLY && !NO_FILESYSTEM */
 
 #if !defined(WOLFCRYPT_ONLY) && !defined(NO_CERTS)
 
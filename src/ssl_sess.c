@@ -37,7 +37,8 @@
        levels of traffic.
 
        ENABLE_SESSION_CACHE_ROW_LOCK: Allows row level locking for increased
-       performance with large session caches
+       performance with large session caches. Without it the rows share one
+       lock unless wolfSSL_SetSessionCacheLocks() asks for more.
 
        HUGE_SESSION_CACHE yields 65,791 sessions, for servers under heavy load,
        allows over 13,000 new sessions per minute or over 200 new sessions per
@@ -99,33 +100,263 @@
 #else
         WOLFSSL_SESSION Sessions[SESSIONS_PER_ROW];
 #endif
-
-    #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
         /* not included in import/export */
-        wolfSSL_RwLock row_lock;
-        int lock_valid;
-    #endif
+        wolfSSL_Atomic_Uint lastUsed[SESSIONS_PER_ROW]; /* LRU tick of entry */
     } SessionRow;
     #define SIZEOF_SESSION_ROW (sizeof(WOLFSSL_SESSION) + (sizeof(int) * 2))
 
-    static WC_THREADSHARED SessionRow SessionCache[SESSION_ROWS];
+    /* Each row is filled from column 0 up. A new session goes in the first
+     * empty column, else replaces the entry that expires first if it has
+     * timed out, else the least recently used entry. So totalCount is also
+     * the number of columns in use.
+     *
+     * Replacement is within the row a session ID hashes to. There is no
+     * cache-wide LRU or expiry order: a session can be replaced while other
+     * rows hold entries that were used less recently.
+     *
+     * wolfSSL_set_session_cache_size() changes the capacity at runtime. With
+     * SESSION_CACHE_DYNAMIC_MEM the rows only hold pointers and the table is
+     * reallocated to the requested size. Otherwise the compiled table is
+     * never reallocated and can only be shrunk by using fewer columns of each
+     * row.
+     */
+    #ifdef SESSION_CACHE_DYNAMIC_MEM
+        /* ClientSession keeps a word16 row */
+        #define SESSION_CACHE_MAX_ROWS 65535
+        static WC_THREADSHARED SessionRow SessionCacheDefault[SESSION_ROWS];
+        static WC_THREADSHARED SessionRow* SessionCache = SessionCacheDefault;
+        static WC_THREADSHARED word32 SessionCacheRows = SESSION_ROWS;
+    #elif defined(SESSION_CACHE_SHARED_MEM)
+        static WC_THREADSHARED SessionRow SessionCacheDefault[SESSION_ROWS];
+        /* points into the shared segment when one is in use */
+        static WC_THREADSHARED SessionRow* SessionCache = SessionCacheDefault;
+        #define SessionCacheRows ((word32)SESSION_ROWS)
+    #else
+        static WC_THREADSHARED SessionRow SessionCache[SESSION_ROWS];
+        #define SessionCacheRows ((word32)SESSION_ROWS)
+    #endif
+    static WC_THREADSHARED int SessionCacheCols = SESSIONS_PER_ROW;
 
     #if defined(WOLFSSL_SESSION_STATS) && defined(WOLFSSL_PEAK_SESSIONS)
         static WC_THREADSHARED word32 PeakSessions;
     #endif
 
+    /* The SessionCache rows are striped over a table of read/write locks.
+     * Row i is guarded by lock (i % SessionLocksCount), so one lock gives the
+     * old single cache lock and SESSION_ROWS locks give one lock per row. The
+     * number of locks in use is set at runtime with
+     * wolfSSL_SetSessionCacheLocks() before wolfSSL_Init().
+     *
+     * SESSION_CACHE_LOCKS_MAX: size of the lock table, defaults to one lock
+     * per row with ENABLE_SESSION_CACHE_ROW_LOCK and to at most 64 otherwise.
+     */
+    #ifndef SESSION_CACHE_LOCKS_MAX
+        #if defined(ENABLE_SESSION_CACHE_ROW_LOCK) || (SESSION_ROWS <= 64)
+            #define SESSION_CACHE_LOCKS_MAX SESSION_ROWS
+        #else
+            #define SESSION_CACHE_LOCKS_MAX 64
+        #endif
+    #endif
+    #if SESSION_CACHE_LOCKS_MAX > SESSION_ROWS
+        #error SESSION_CACHE_LOCKS_MAX must not be more than SESSION_ROWS
+    #endif
+
     #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
-    #define SESSION_ROW_RD_LOCK(row)   wc_LockRwLock_Rd(&(row)->row_lock)
-    #define SESSION_ROW_WR_LOCK(row)   wc_LockRwLock_Wr(&(row)->row_lock)
-    #define SESSION_ROW_UNLOCK(row)    wc_UnLockRwLock(&(row)->row_lock);
+        #define SESSION_CACHE_LOCKS_DEFAULT SESSION_CACHE_LOCKS_MAX
     #else
-    static WC_THREADSHARED wolfSSL_RwLock session_lock; /* SessionCache lock */
-    static WC_THREADSHARED int session_lock_valid = 0;
-    #define SESSION_ROW_RD_LOCK(row)   wc_LockRwLock_Rd(&session_lock)
-    #define SESSION_ROW_WR_LOCK(row)   wc_LockRwLock_Wr(&session_lock)
-    #define SESSION_ROW_UNLOCK(row)    wc_UnLockRwLock(&session_lock);
+        #define SESSION_CACHE_LOCKS_DEFAULT 1
     #endif
 
+#ifdef SESSION_CACHE_SHARED_MEM
+    #ifndef WC_HAVE_SHARED_MUTEX
+        #error SESSION_CACHE_SHARED_MEM needs process shared locks
+    #endif
+
+    /* Rows shared between processes are guarded by robust mutexes: a process
+     * that dies holding one doesn't leave the others blocked. Readers of a
+     * row serialize. */
+    typedef wolfSSL_Mutex SessionLock;
+    #define SESSION_LOCK_INIT(m)  wc_InitMutex(m)
+    #define SESSION_LOCK_FREE(m)  wc_FreeMutex(m)
+    #define SESSION_LOCK_RD(m)    SessionCacheLock(m)
+    #define SESSION_LOCK_WR(m)    SessionCacheLock(m)
+    #define SESSION_UNLOCK(m)     wc_UnLockMutex(m)
+
+    static WC_THREADSHARED SessionLock
+        SessionLocksDefault[SESSION_CACHE_LOCKS_MAX];
+    static WC_THREADSHARED SessionLock* SessionLocks = SessionLocksDefault;
+#else
+    typedef wolfSSL_RwLock SessionLock;
+    #define SESSION_LOCK_INIT(m)  wc_InitRwLock(m)
+    #define SESSION_LOCK_FREE(m)  wc_FreeRwLock(m)
+    #define SESSION_LOCK_RD(m)    wc_LockRwLock_Rd(m)
+    #define SESSION_LOCK_WR(m)    wc_LockRwLock_Wr(m)
+    #define SESSION_UNLOCK(m)     wc_UnLockRwLock(m)
+
+    static WC_THREADSHARED SessionLock SessionLocks[SESSION_CACHE_LOCKS_MAX];
+#endif
+    /* number of initialized locks, 0 when not initialized */
+    static WC_THREADSHARED int SessionLocksCount = 0;
+    /* number of locks to initialize at next wolfSSL_Init() */
+    static WC_THREADSHARED int SessionLocksConfig = SESSION_CACHE_LOCKS_DEFAULT;
+
+#ifdef SESSION_CACHE_SHARED_MEM
+    /* Layout of the memory given to wolfSSL_set_session_cache_shared(). The
+     * rows and their locks live in the segment so every process that maps it
+     * uses the same cache. Sessions in it point into the segment (the static
+     * ticket buffers) so it has to be mapped at the same address everywhere,
+     * as it is in processes forked after setting it up. */
+    #define SESSION_CACHE_SHARED_MAGIC   0x77536373 /* "wScs" */
+    #define SESSION_CACHE_SHARED_VERSION 3
+
+    typedef struct SessionCacheShm {
+        word32 magic;      /* set last, once the segment is set up */
+        int    version;    /* layout version */
+        int    rows;       /* session rows */
+        int    columns;    /* session columns */
+        int    sessionSz;  /* sizeof WOLFSSL_SESSION */
+        int    locks;      /* number of locks in use */
+        void*  base;       /* address the segment was set up at */
+        wolfSSL_Atomic_Uint tick; /* recency counter of all processes */
+        SessionLock    lock[SESSION_CACHE_LOCKS_MAX];
+        SessionRow     row[SESSION_ROWS];
+    } SessionCacheShm;
+
+    /* segment in use, NULL when the cache is local to this process */
+    static WC_THREADSHARED SessionCacheShm* SessionShm = NULL;
+    #define SESSION_CACHE_IS_SHARED() (SessionShm != NULL)
+
+    /* Lock m. When the process holding it died, the rows it guards may be
+     * half written: they are emptied before anyone looks at them. */
+    static int SessionCacheLock(SessionLock* m)
+    {
+        int ownerDied = 0;
+        word32 i;
+
+        if (wc_LockMutexShared(m, &ownerDied) != 0)
+            return BAD_MUTEX_E;
+        if (ownerDied) {
+            WOLFSSL_MSG("Session cache lock owner died, emptying its rows");
+            for (i = (word32)(m - SessionLocks); i < SessionCacheRows;
+                    i += (word32)SessionLocksCount) {
+                XMEMSET(&SessionCache[i], 0, sizeof(SessionRow));
+            }
+        }
+
+        return 0;
+    }
+#else
+    #define SESSION_CACHE_IS_SHARED() 0
+#endif
+
+    /* Recency of cache entries is a counter taken on every add and hit
+     * rather than a time, so entries added or used in the same second are
+     * still ordered. The counter wraps, compare with SESSION_TICK_BEFORE(). */
+    static WC_THREADSHARED wolfSSL_Atomic_Uint SessionCacheTick;
+    #define SESSION_TICK_BEFORE(a, b) \
+        ((int)((word32)(a) - (word32)(b)) < 0)
+
+    static word32 SessionCacheNextTick(void)
+    {
+        wolfSSL_Atomic_Uint* tick = &SessionCacheTick;
+
+    #ifdef SESSION_CACHE_SHARED_MEM
+        if (SESSION_CACHE_IS_SHARED())
+            tick = &SessionShm->tick;
+    #endif
+    #ifdef WOLFSSL_ATOMIC_OPS
+        return (word32)wolfSSL_Atomic_Uint_AddFetch(tick, 1);
+    #else
+        /* A lost update only leaves two entries unordered. */
+        return (word32)++(*tick);
+    #endif
+    }
+
+    /* Row and column counts only change with every lock held for writing,
+     * so a row index must be checked against SessionCacheRows after locking
+     * it. */
+    #define SESSION_ROW_LOCK(row) \
+        (&SessionLocks[(word32)(row) % (word32)SessionLocksCount])
+    #define SESSION_ROW_RD_LOCK(row)                                         \
+        ((SessionLocksCount > 0) ? SESSION_LOCK_RD(SESSION_ROW_LOCK(row)) :  \
+                                   BAD_MUTEX_E)
+    #define SESSION_ROW_WR_LOCK(row)                                         \
+        ((SessionLocksCount > 0) ? SESSION_LOCK_WR(SESSION_ROW_LOCK(row)) :  \
+                                   BAD_MUTEX_E)
+    #define SESSION_ROW_UNLOCK(row)    SESSION_UNLOCK(SESSION_ROW_LOCK(row));
+
+    /* Lock the row that id hashes to and return its index in row. */
+    static int SessionCacheLockId(const byte* id, byte readOnly, word32* row)
+    {
+        int    error = 0;
+        word32 hash = HashObject(id, ID_LEN, &error);
+
+        if (error != 0)
+            return error;
+
+        for (;;) {
+            *row = hash % SessionCacheRows;
+            if (readOnly)
+                error = SESSION_ROW_RD_LOCK(*row);
+            else
+                error = SESSION_ROW_WR_LOCK(*row);
+            if (error != 0)
+                return BAD_MUTEX_E;
+            /* cache resized before the lock was taken */
+            if (*row == hash % SessionCacheRows)
+                break;
+            SESSION_ROW_UNLOCK(*row);
+        }
+
+        return 0;
+    }
+
+    /* Initialize SessionLocksConfig locks. Called from wolfSSL_Init(). */
+    static int SessionCacheLocksInit(void)
+    {
+        int ret = 0;
+        int i;
+
+    #ifdef SESSION_CACHE_SHARED_MEM
+        /* locks were set up with the segment */
+        if (SESSION_CACHE_IS_SHARED()) {
+            SessionLocksCount = SessionShm->locks;
+            return 0;
+        }
+    #endif
+        for (i = 0; i < SessionLocksConfig; ++i) {
+            if (SESSION_LOCK_INIT(&SessionLocks[i]) != 0) {
+                WOLFSSL_MSG("Bad Init Mutex session");
+                ret = BAD_MUTEX_E;
+                break;
+            }
+        }
+        if (ret != 0) {
+            while (--i >= 0)
+                SESSION_LOCK_FREE(&SessionLocks[i]);
+            i = 0;
+        }
+        SessionLocksCount = i;
+
+        return ret;
+    }
+
+    /* Free the session cache locks. Called from wolfSSL_Cleanup(). */
+    static int SessionCacheLocksFree(void)
+    {
+        int ret = 0;
+        int i;
+
+        /* other processes may still use the locks of a shared segment */
+        for (i = 0; i < SessionLocksCount && !SESSION_CACHE_IS_SHARED(); ++i) {
+            if (SESSION_LOCK_FREE(&SessionLocks[i]) != 0)
+                ret = BAD_MUTEX_E;
+        }
+        SessionLocksCount = 0;
+
+        return ret;
+    }
+
     #if !defined(NO_SESSION_CACHE_REF) && defined(NO_CLIENT_CACHE)
     #error ClientCache is required when not using NO_SESSION_CACHE_REF
     #endif
@@ -160,6 +391,9 @@
             word16 serverIdx;            /* SessionCache Idx (column) */
             word32 sessionIDHash;
         };
+        /* serverRow and serverIdx of an entry whose session was evicted when
+         * the cache was resized - no row can have this index */
+        #define CLIENT_SESSION_EVICTED 0xFFFF
     #ifndef WOLFSSL_CLIENT_SESSION_DEFINED
         typedef struct ClientSession ClientSession;
         #define WOLFSSL_CLIENT_SESSION_DEFINED
@@ -417,7 +651,8 @@ typedef struct {
 /* get how big the the session cache save buffer needs to be */
 int wolfSSL_get_session_cache_memsize(void)
 {
-    int sz  = (int)(sizeof(SessionCache) + sizeof(cache_header_t));
+    int sz  = (int)((sizeof(SessionRow) * SESSION_ROWS) +
+                    sizeof(cache_header_t));
 #ifndef NO_CLIENT_CACHE
     sz += (int)(sizeof(ClientCache));
 #endif
@@ -451,28 +686,15 @@ int wolfSSL_memsave_session_cache(void* mem, int sz)
     cache_header.sessionSz = (int)sizeof(WOLFSSL_SESSION);
     XMEMCPY(mem, &cache_header, sizeof(cache_header));
 
-#ifndef ENABLE_SESSION_CACHE_ROW_LOCK
-    if (SESSION_ROW_RD_LOCK(row) != 0) {
-        WOLFSSL_MSG("Session cache mutex lock failed");
-        return BAD_MUTEX_E;
-    }
-#endif
     for (i = 0; i < cache_header.rows; ++i) {
-    #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
-        if (SESSION_ROW_RD_LOCK(&SessionCache[i]) != 0) {
+        if (SESSION_ROW_RD_LOCK(i) != 0) {
             WOLFSSL_MSG("Session row cache mutex lock failed");
             return BAD_MUTEX_E;
         }
-    #endif
 
         XMEMCPY(row++, &SessionCache[i], SIZEOF_SESSION_ROW);
-    #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
-        SESSION_ROW_UNLOCK(&SessionCache[i]);
-    #endif
+        SESSION_ROW_UNLOCK(i);
     }
-#ifndef ENABLE_SESSION_CACHE_ROW_LOCK
-    SESSION_ROW_UNLOCK(row);
-#endif
 
 #ifndef NO_CLIENT_CACHE
     if (wc_LockMutex(&clisession_mutex) != 0) {
@@ -551,19 +773,11 @@ int wolfSSL_memrestore_session_cache(const void* mem, int sz)
         return CACHE_MATCH_ERROR;
     }
 
-#ifndef ENABLE_SESSION_CACHE_ROW_LOCK
-    if (SESSION_ROW_WR_LOCK(&SessionCache[0]) != 0) {
-        WOLFSSL_MSG("Session cache mutex lock failed");
-        return BAD_MUTEX_E;
-    }
-#endif
     for (i = 0; i < cache_header.rows; ++i) {
-    #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
-        if (SESSION_ROW_WR_LOCK(&SessionCache[i]) != 0) {
+        if (SESSION_ROW_WR_LOCK(i) != 0) {
             WOLFSSL_MSG("Session row cache mutex lock failed");
             return BAD_MUTEX_E;
         }
-    #endif
 
         XMEMCPY(&SessionCache[i], row++, SIZEOF_SESSION_ROW);
     #if !defined(SESSION_CACHE_DYNAMIC_MEM) && \
@@ -571,13 +785,8 @@ int wolfSSL_memrestore_session_cache(const void* mem, int sz)
         (defined(SESSION_CERTS) && defined(OPENSSL_EXTRA)))
         SessionSanityPointerSet(&SessionCache[i]);
     #endif
-    #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
-        SESSION_ROW_UNLOCK(&SessionCache[i]);
-    #endif
+        SESSION_ROW_UNLOCK(i);
     }
-#ifndef ENABLE_SESSION_CACHE_ROW_LOCK
-    SESSION_ROW_UNLOCK(&SessionCache[0]);
-#endif
 
 #ifndef NO_CLIENT_CACHE
     if (wc_LockMutex(&clisession_mutex) != 0) {
@@ -625,36 +834,22 @@ int wolfSSL_save_session_cache(const char *fname)
         return FWRITE_ERROR;
     }
 
-#ifndef ENABLE_SESSION_CACHE_ROW_LOCK
-    if (SESSION_ROW_RD_LOCK(&SessionCache[0]) != 0) {
-        WOLFSSL_MSG("Session cache mutex lock failed");
-        XFCLOSE(file);
-        return BAD_MUTEX_E;
-    }
-#endif
     /* session cache */
     for (i = 0; i < cache_header.rows; ++i) {
-    #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
-        if (SESSION_ROW_RD_LOCK(&SessionCache[i]) != 0) {
+        if (SESSION_ROW_RD_LOCK(i) != 0) {
             WOLFSSL_MSG("Session row cache mutex lock failed");
             XFCLOSE(file);
             return BAD_MUTEX_E;
         }
-    #endif
 
         ret = (int)XFWRITE(&SessionCache[i], SIZEOF_SESSION_ROW, 1, file);
-    #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
-        SESSION_ROW_UNLOCK(&SessionCache[i]);
-    #endif
+        SESSION_ROW_UNLOCK(i);
         if (ret != 1) {
             WOLFSSL_MSG("Session cache member file write failed");
             rc = FWRITE_ERROR;
             break;
         }
     }
-#ifndef ENABLE_SESSION_CACHE_ROW_LOCK
-    SESSION_ROW_UNLOCK(&SessionCache[0]);
-#endif
 
 #ifndef NO_CLIENT_CACHE
     /* client cache */
@@ -712,22 +907,13 @@ int wolfSSL_restore_session_cache(const char *fname)
         return CACHE_MATCH_ERROR;
     }
 
-#ifndef ENABLE_SESSION_CACHE_ROW_LOCK
-    if (SESSION_ROW_WR_LOCK(&SessionCache[0]) != 0) {
-        WOLFSSL_MSG("Session cache mutex lock failed");
-        XFCLOSE(file);
-        return BAD_MUTEX_E;
-    }
-#endif
     /* session cache */
     for (i = 0; i < cache_header.rows; ++i) {
-    #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
-        if (SESSION_ROW_WR_LOCK(&SessionCache[i]) != 0) {
+        if (SESSION_ROW_WR_LOCK(i) != 0) {
             WOLFSSL_MSG("Session row cache mutex lock failed");
             XFCLOSE(file);
             return BAD_MUTEX_E;
         }
-    #endif
 
         ret = (int)XFREAD(&SessionCache[i], SIZEOF_SESSION_ROW, 1, file);
     #if !defined(SESSION_CACHE_DYNAMIC_MEM) && \
@@ -735,19 +921,14 @@ int wolfSSL_restore_session_cache(const char *fname)
         (defined(SESSION_CERTS) && defined(OPENSSL_EXTRA)))
         SessionSanityPointerSet(&SessionCache[i]);
     #endif
-    #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
-        SESSION_ROW_UNLOCK(&SessionCache[i]);
-    #endif
+        SESSION_ROW_UNLOCK(i);
         if (ret != 1) {
             WOLFSSL_MSG("Session cache member file read failed");
-            XMEMSET(SessionCache, 0, sizeof SessionCache);
+            XMEMSET(SessionCache, 0, sizeof(SessionRow) * SESSION_ROWS);
             rc = FREAD_ERROR;
             break;
         }
     }
-#ifndef ENABLE_SESSION_CACHE_ROW_LOCK
-    SESSION_ROW_UNLOCK(&SessionCache[0]);
-#endif
 
 #ifndef NO_CLIENT_CACHE
     /* client cache */
@@ -871,15 +1052,20 @@ void wolfSSL_flush_sessions(WOLFSSL_CTX* ctx, long tm)
 
 void wolfSSL_CTX_flush_sessions(WOLFSSL_CTX* ctx, long tm)
 {
-    int i, j;
+    word32 i;
+    int j;
 
     (void)ctx;
     WOLFSSL_ENTER("wolfSSL_flush_sessions");
-    for (i = 0; i < SESSION_ROWS; ++i) {
-        if (SESSION_ROW_WR_LOCK(&SessionCache[i]) != 0) {
+    for (i = 0; i < SessionCacheRows; ++i) {
+        if (SESSION_ROW_WR_LOCK(i) != 0) {
             WOLFSSL_MSG("Session cache mutex lock failed");
             return;
         }
+        if (i >= SessionCacheRows) {
+            SESSION_ROW_UNLOCK(i);
+            break;
+        }
         for (j = 0; j < SESSIONS_PER_ROW; j++) {
 #ifdef SESSION_CACHE_DYNAMIC_MEM
             WOLFSSL_SESSION* s = SessionCache[i].Sessions[j];
@@ -901,10 +1087,435 @@ void wolfSSL_CTX_flush_sessions(WOLFSSL_CTX* ctx, long tm)
 #endif
             }
         }
-        SESSION_ROW_UNLOCK(&SessionCache[i]);
+        SESSION_ROW_UNLOCK(i);
+    }
+}
+
+
+/* Set the number of locks the server session cache rows are striped over.
+ * Must be called before wolfSSL_Init() or after the final wolfSSL_Cleanup().
+ * More locks let threads resuming different sessions proceed in parallel.
+ *
+ * locks  Number of locks. Values above wolfSSL_GetSessionCacheLocksMax()
+ *        are clamped to it.
+ * returns WOLFSSL_SUCCESS, BAD_FUNC_ARG when locks is not positive or
+ *         BAD_STATE_E when the library is initialized.
+ */
+int wolfSSL_SetSessionCacheLocks(int locks)
+{
+    WOLFSSL_ENTER("wolfSSL_SetSessionCacheLocks");
+
+    if (locks <= 0)
+        return BAD_FUNC_ARG;
+    if (SessionLocksCount != 0) {
+        WOLFSSL_MSG("Session cache locks already initialized");
+        return BAD_STATE_E;
+    }
+
+    SessionLocksConfig = min(locks, SESSION_CACHE_LOCKS_MAX);
+
+    return WOLFSSL_SUCCESS;
+}
+
+/* Get the number of locks the server session cache rows are striped over.
+ * Returns the configured count when the library is not initialized. */
+int wolfSSL_GetSessionCacheLocks(void)
+{
+    if (SessionLocksCount != 0)
+        return SessionLocksCount;
+    return SessionLocksConfig;
+}
+
+/* Get the maximum number of session cache locks for this build. */
+int wolfSSL_GetSessionCacheLocksMax(void)
+{
+    return SESSION_CACHE_LOCKS_MAX;
+}
+
+/* Write lock every session cache lock, in order. Nothing to lock before
+ * wolfSSL_Init(). */
+static int SessionCacheLockAll(void)
+{
+    int i;
+
+    for (i = 0; i < SessionLocksCount; i++) {
+        if (SESSION_LOCK_WR(&SessionLocks[i]) != 0) {
+            while (--i >= 0)
+                SESSION_UNLOCK(&SessionLocks[i]);
+            return BAD_MUTEX_E;
+        }
+    }
+
+    return 0;
+}
+
+static void SessionCacheUnlockAll(void)
+{
+    int i;
+
+    for (i = SessionLocksCount - 1; i >= 0; i--)
+        SESSION_UNLOCK(&SessionLocks[i]);
+}
+
+/* Evict the sessions in columns cols and up of every row. */
+static void SessionCacheTrimColumns(int cols)
+{
+    word32 i;
+    int j;
+
+    for (i = 0; i < SessionCacheRows; i++) {
+        SessionRow* row = &SessionCache[i];
+
+        for (j = cols; j < row->totalCount; j++) {
+#ifdef SESSION_CACHE_DYNAMIC_MEM
+            if (row->Sessions[j] != NULL) {
+                EvictSessionFromCache(row->Sessions[j]);
+                XFREE(row->Sessions[j], row->heap, DYNAMIC_TYPE_SESSION);
+                row->Sessions[j] = NULL;
+            }
+#else
+            EvictSessionFromCache(&row->Sessions[j]);
+#endif
+        }
+        if (row->totalCount > cols)
+            row->totalCount = cols;
+        if (row->nextIdx >= cols)
+            row->nextIdx = 0;
+    }
+}
+
+#ifdef SESSION_CACHE_DYNAMIC_MEM
+/* Put s into the first cols columns of row. When they are all used, s
+ * replaces the least recently used entry of the row if s was used later.
+ * Returns the session that didn't fit or NULL. */
+static WOLFSSL_SESSION* SessionRowPlace(SessionRow* row, word32 rowIdx,
+    int cols, WOLFSSL_SESSION* s, word32 used)
+{
+    WOLFSSL_SESSION* out;
+    int lru = 0;
+    int i;
+
+    if (row->totalCount < cols) {
+        lru = row->totalCount++;
+        out = NULL;
+    }
+    else {
+        for (i = 1; i < cols; i++) {
+            if (SESSION_TICK_BEFORE(WOLFSSL_ATOMIC_LOAD(row->lastUsed[i]),
+                    WOLFSSL_ATOMIC_LOAD(row->lastUsed[lru]))) {
+                lru = i;
+            }
+        }
+        if (!SESSION_TICK_BEFORE(WOLFSSL_ATOMIC_LOAD(row->lastUsed[lru]),
+                used)) {
+            return s;
+        }
+        out = row->Sessions[lru];
+    }
+
+    row->Sessions[lru] = s;
+    WOLFSSL_ATOMIC_STORE(row->lastUsed[lru], used);
+    s->cacheRow = (int)rowIdx;
+
+    return out;
+}
+
+#ifndef NO_CLIENT_CACHE
+/* Point the client cache entries at where their sessions are in table.
+ * Entries of sessions that were evicted are cleared. Called with the client
+ * cache and every session row locked, before SessionCache is switched. */
+static void SessionCacheMoveClients(SessionRow* table)
+{
+    int i;
+    int j;
+    int k;
+
+    for (i = 0; i < CLIENT_SESSION_ROWS; i++) {
+        ClientRow* row = &ClientCache[i];
+        int count = (int)min((word32)row->totalCount, CLIENT_SESSIONS_PER_ROW);
+
+        for (j = 0; j < count; j++) {
+            ClientSession* cl = &row->Clients[j];
+            WOLFSSL_SESSION* s = NULL;
+
+            if (cl->serverRow < SessionCacheRows &&
+                    cl->serverIdx < SESSIONS_PER_ROW) {
+                s = SessionCache[cl->serverRow].Sessions[cl->serverIdx];
+            }
+            cl->serverRow = CLIENT_SESSION_EVICTED;
+            cl->serverIdx = CLIENT_SESSION_EVICTED;
+            if (s == NULL || s->cacheRow == INVALID_SESSION_ROW)
+                continue;
+            for (k = 0; k < SESSIONS_PER_ROW; k++) {
+                if (table[s->cacheRow].Sessions[k] == s) {
+                    cl->serverRow = (word16)s->cacheRow;
+                    cl->serverIdx = (word16)k;
+                    break;
+                }
+            }
+        }
+    }
+}
+#endif
+
+/* Rehash every live session of the current table into table. Expired
+ * sessions and ones that don't fit are evicted. Called with every session row
+ * locked and, unless NO_CLIENT_CACHE, the client cache. */
+static void SessionCacheMoveTo(SessionRow* table, word32 rows, int cols)
+{
+    word32 now = LowResTimer();
+    word32 i;
+    int j;
+
+    /* Place the sessions, marking the ones that don't fit as out of the
+     * cache. They stay in the current table until the client cache has been
+     * updated. */
+    for (i = 0; i < SessionCacheRows; i++) {
+        SessionRow* from = &SessionCache[i];
+
+        for (j = 0; j < SESSIONS_PER_ROW; j++) {
+            WOLFSSL_SESSION* s = from->Sessions[j];
+            int error = 0;
+            word32 r;
+
+            if (s == NULL)
+                continue;
+            if (s->sessionIDSz == ID_LEN && now < s->bornOn + s->timeout) {
+                r = HashObject(s->sessionID, ID_LEN, &error) % rows;
+                if (error == 0) {
+                    s = SessionRowPlace(&table[r], r, cols, s,
+                        WOLFSSL_ATOMIC_COERCE_UINT(
+                            WOLFSSL_ATOMIC_LOAD(from->lastUsed[j])));
+                }
+            }
+            if (s != NULL)
+                s->cacheRow = INVALID_SESSION_ROW;
+        }
+    }
+
+#ifndef NO_CLIENT_CACHE
+    SessionCacheMoveClients(table);
+#endif
+
+    for (i = 0; i < SessionCacheRows; i++) {
+        SessionRow* from = &SessionCache[i];
+
+        for (j = 0; j < SESSIONS_PER_ROW; j++) {
+            WOLFSSL_SESSION* s = from->Sessions[j];
+
+            from->Sessions[j] = NULL;
+            if (s != NULL && s->cacheRow == INVALID_SESSION_ROW) {
+                EvictSessionFromCache(s);
+                XFREE(s, from->heap, DYNAMIC_TYPE_SESSION);
+            }
+        }
+        from->totalCount = 0;
+        from->nextIdx = 0;
+    }
+}
+#endif /* SESSION_CACHE_DYNAMIC_MEM */
+
+/* Set the capacity of the server session cache to about sz sessions. Can be
+ * called while the cache is in use. Sessions that no longer fit are evicted.
+ *
+ * With SESSION_CACHE_DYNAMIC_MEM the row table is reallocated for sz
+ * sessions, up to SESSION_CACHE_MAX_ROWS rows, and the live sessions are
+ * rehashed into it. Otherwise the compiled table is never reallocated: sz is
+ * clamped to its size and only sets how many columns of each row are used.
+ * wolfSSL_Cleanup() restores the compiled size.
+ *
+ * sz  Number of sessions to cache.
+ * returns WOLFSSL_SUCCESS, BAD_FUNC_ARG when sz is not positive, BAD_STATE_E
+ *         when the cache is in shared memory, MEMORY_E or BAD_MUTEX_E.
+ */
+int wolfSSL_set_session_cache_size(long sz)
+{
+    int ret = WOLFSSL_SUCCESS;
+    int cols;
+#ifdef SESSION_CACHE_DYNAMIC_MEM
+    SessionRow* table = NULL;
+    SessionRow* oldTable = NULL;
+    word32 rows;
+#ifndef NO_CLIENT_CACHE
+    int clientLocked = 0;
+#endif
+#endif
+
+    WOLFSSL_ENTER("wolfSSL_set_session_cache_size");
+
+    if (sz <= 0)
+        return BAD_FUNC_ARG;
+    if (SESSION_CACHE_IS_SHARED()) {
+        WOLFSSL_MSG("Shared session cache size is set by the segment");
+        return BAD_STATE_E;
+    }
+
+#ifdef SESSION_CACHE_DYNAMIC_MEM
+    cols = (sz < SESSIONS_PER_ROW) ? (int)sz : SESSIONS_PER_ROW;
+    if (sz / cols >= SESSION_CACHE_MAX_ROWS)
+        rows = SESSION_CACHE_MAX_ROWS;
+    else
+        rows = (word32)((sz + cols - 1) / cols);
+
+    if (rows != SessionCacheRows) {
+        table = (SessionRow*)XMALLOC(sizeof(SessionRow) * rows, NULL,
+            DYNAMIC_TYPE_SESSION);
+        if (table == NULL)
+            return MEMORY_E;
+        XMEMSET(table, 0, sizeof(SessionRow) * rows);
+    }
+#else
+    if (sz >= (long)SESSIONS_PER_ROW * SESSION_ROWS) {
+        cols = SESSIONS_PER_ROW;
+    }
+    else {
+        cols = (int)((sz + SESSION_ROWS - 1) / SESSION_ROWS);
+    }
+#endif
+
+#if defined(SESSION_CACHE_DYNAMIC_MEM) && !defined(NO_CLIENT_CACHE)
+    /* Taken before the rows, as when looking up a client session. */
+    if (table != NULL) {
+        if (wc_LockMutex(&clisession_mutex) != 0) {
+            WOLFSSL_MSG("Client cache mutex lock failed");
+            XFREE(table, NULL, DYNAMIC_TYPE_SESSION);
+            return BAD_MUTEX_E;
+        }
+        clientLocked = 1;
+    }
+#endif
+    if (SessionCacheLockAll() != 0) {
+        WOLFSSL_MSG("Session cache lock failed");
+        ret = BAD_MUTEX_E;
     }
+    else {
+    #ifdef SESSION_CACHE_DYNAMIC_MEM
+        if (table != NULL) {
+            SessionCacheMoveTo(table, rows, cols);
+            if (SessionCache != SessionCacheDefault)
+                oldTable = SessionCache;
+            SessionCache = table;
+            SessionCacheRows = rows;
+            table = NULL;
+        }
+        else
+    #endif
+        {
+            SessionCacheTrimColumns(cols);
+        }
+        SessionCacheCols = cols;
+        SessionCacheUnlockAll();
+    }
+#if defined(SESSION_CACHE_DYNAMIC_MEM) && !defined(NO_CLIENT_CACHE)
+    if (clientLocked)
+        wc_UnLockMutex(&clisession_mutex);
+#endif
+
+#ifdef SESSION_CACHE_DYNAMIC_MEM
+    XFREE(table, NULL, DYNAMIC_TYPE_SESSION);
+    XFREE(oldTable, NULL, DYNAMIC_TYPE_SESSION);
+#endif
+
+    WOLFSSL_LEAVE("wolfSSL_set_session_cache_size", ret);
+
+    return ret;
+}
+
+/* Get the number of sessions the server session cache can hold. */
+long wolfSSL_get_session_cache_size(void)
+{
+    return (long)SessionCacheRows * SessionCacheCols;
+}
+
+#ifdef SESSION_CACHE_SHARED_MEM
+/* Get the size of the memory wolfSSL_set_session_cache_shared() needs. */
+int wolfSSL_get_session_cache_shared_memsize(void)
+{
+    return (int)sizeof(SessionCacheShm);
 }
 
+/* Keep the server session cache in mem, for example a MAP_SHARED mapping,
+ * so that processes forked afterwards all resume from one cache. Segment
+ * memory that is all zero is set up here. A segment already set up by another
+ * process is attached to. Must be called before wolfSSL_Init().
+ *
+ * The segment must stay mapped at the same address in every process using it.
+ * It holds the master secrets of the cached sessions. Its locks are robust
+ * mutexes where the platform has them (WC_HAVE_ROBUST_MUTEX): when a process
+ * dies holding one, the next process to lock it empties the rows it guards
+ * and carries on. Elsewhere the other processes would block on it. Sessions with a ticket
+ * or nonce too big for the static buffers are not cached and ex_data stays
+ * with each process' own session objects.
+ *
+ * mem  Shared memory or NULL to go back to the process local cache.
+ * sz   Size of mem in bytes.
+ * returns WOLFSSL_SUCCESS, BAD_STATE_E after wolfSSL_Init(), BUFFER_E when sz
+ *         is too small, CACHE_MATCH_ERROR when the segment was set up by a
+ *         different build or at a different address, or BAD_MUTEX_E.
+ */
+int wolfSSL_set_session_cache_shared(void* mem, int sz)
+{
+    SessionCacheShm* shm = (SessionCacheShm*)mem;
+    int i;
+
+    WOLFSSL_ENTER("wolfSSL_set_session_cache_shared");
+
+    if (SessionLocksCount > 0) {
+        WOLFSSL_MSG("Session cache already in use");
+        return BAD_STATE_E;
+    }
+
+    if (shm == NULL) {
+        SessionShm = NULL;
+        SessionCache = SessionCacheDefault;
+        SessionLocks = SessionLocksDefault;
+        return WOLFSSL_SUCCESS;
+    }
+    if (sz < (int)sizeof(SessionCacheShm)) {
+        WOLFSSL_MSG("Shared session cache memory too small");
+        return BUFFER_E;
+    }
+
+    if (shm->magic == 0) {
+        XMEMSET(shm->row, 0, sizeof(shm->row));
+        for (i = 0; i < SessionLocksConfig; i++) {
+            if (wc_InitMutexShared(&shm->lock[i]) != 0) {
+                WOLFSSL_MSG("Bad Init Mutex shared session");
+                while (--i >= 0)
+                    wc_FreeMutex(&shm->lock[i]);
+                return BAD_MUTEX_E;
+            }
+        }
+        shm->version   = SESSION_CACHE_SHARED_VERSION;
+        shm->rows      = SESSION_ROWS;
+        shm->columns   = SESSIONS_PER_ROW;
+        shm->sessionSz = (int)sizeof(WOLFSSL_SESSION);
+        shm->locks     = SessionLocksConfig;
+        shm->base      = mem;
+        shm->magic     = SESSION_CACHE_SHARED_MAGIC;
+    }
+    else if (shm->magic     != SESSION_CACHE_SHARED_MAGIC ||
+             shm->version   != SESSION_CACHE_SHARED_VERSION ||
+             shm->rows      != SESSION_ROWS ||
+             shm->columns   != SESSIONS_PER_ROW ||
+             shm->sessionSz != (int)sizeof(WOLFSSL_SESSION) ||
+             shm->locks     <= 0 ||
+             shm->locks     >  SESSION_CACHE_LOCKS_MAX ||
+             shm->base      != mem) {
+        WOLFSSL_MSG("Shared session cache header match failed");
+        return CACHE_MATCH_ERROR;
+    }
+
+    SessionShm = shm;
+    SessionCache = shm->row;
+    SessionLocks = shm->lock;
+    SessionCacheCols = SESSIONS_PER_ROW;
+
+    WOLFSSL_LEAVE("wolfSSL_set_session_cache_shared", WOLFSSL_SUCCESS);
+
+    return WOLFSSL_SUCCESS;
+}
+#endif /* SESSION_CACHE_SHARED_MEM */
 
 /* set ssl session timeout in seconds */
 WOLFSSL_ABI
@@ -1034,18 +1645,26 @@ WOLFSSL_SESSION* wolfSSL_GetSessionClient(WOLFSSL* ssl, const byte* id, int len)
     for (; count > 0; --count) {
         WOLFSSL_SESSION* current;
         SessionRow* sessRow;
-
-        if (clSess[idx].serverRow >= SESSION_ROWS) {
-            WOLFSSL_MSG("Client cache serverRow invalid");
-            break;
-        }
+        word32 serverRow = clSess[idx].serverRow;
 
         /* lock row */
-        sessRow = &SessionCache[clSess[idx].serverRow];
-        if (SESSION_ROW_RD_LOCK(sessRow) != 0) {
+        if (SESSION_ROW_RD_LOCK(serverRow) != 0) {
             WOLFSSL_MSG("Session cache row lock failure");
             break;
         }
+        if (serverRow == CLIENT_SESSION_EVICTED) {
+            WOLFSSL_MSG("Client cache entry cleared");
+            SESSION_ROW_UNLOCK(serverRow);
+            idx = idx > 0 ? idx - 1 : CLIENT_SESSIONS_PER_ROW - 1;
+            continue;
+        }
+        if (serverRow >= SessionCacheRows ||
+                clSess[idx].serverIdx >= SESSIONS_PER_ROW) {
+            WOLFSSL_MSG("Client cache serverRow invalid");
+            SESSION_ROW_UNLOCK(serverRow);
+            break;
+        }
+        sessRow = &SessionCache[serverRow];
 
 #ifdef SESSION_CACHE_DYNAMIC_MEM
         current = sessRow->Sessions[clSess[idx].serverIdx];
@@ -1058,7 +1677,7 @@ WOLFSSL_SESSION* wolfSSL_GetSessionClient(WOLFSSL* ssl, const byte* id, int len)
             if (LowResTimer() < (current->bornOn + current->timeout)) {
                 WOLFSSL_MSG("Session valid");
                 ret = current;
-                SESSION_ROW_UNLOCK(sessRow);
+                SESSION_ROW_UNLOCK(serverRow);
                 break;
             } else {
                 WOLFSSL_MSG("Session timed out");  /* could have more for id */
@@ -1066,7 +1685,7 @@ WOLFSSL_SESSION* wolfSSL_GetSessionClient(WOLFSSL* ssl, const byte* id, int len)
         } else {
             WOLFSSL_MSG("ServerID not a match from client table");
         }
-        SESSION_ROW_UNLOCK(sessRow);
+        SESSION_ROW_UNLOCK(serverRow);
 
         idx = idx > 0 ? idx - 1 : CLIENT_SESSIONS_PER_ROW - 1;
     }
@@ -1126,11 +1745,7 @@ static int wolfSSL_DupSessionEx(const WOLFSSL_SESSION* input,
 
 void TlsSessionCacheUnlockRow(word32 row)
 {
-    SessionRow* sessRow;
-
-    sessRow = &SessionCache[row];
-    (void)sessRow;
-    SESSION_ROW_UNLOCK(sessRow);
+    SESSION_ROW_UNLOCK(row);
 }
 
 /* Don't use this function directly. Use TlsSessionCacheGetAndRdLock and
@@ -1141,29 +1756,16 @@ static int TlsSessionCacheGetAndLock(const byte *id,
     SessionRow *sessRow;
     const WOLFSSL_SESSION *s;
     word32 row;
-    int count;
     int error;
     int idx;
 
     *sess = NULL;
-    row = HashObject(id, ID_LEN, &error) % SESSION_ROWS;
+    error = SessionCacheLockId(id, readOnly, &row);
     if (error != 0)
         return error;
     sessRow = &SessionCache[row];
-    if (readOnly)
-        error = SESSION_ROW_RD_LOCK(sessRow);
-    else
-        error = SESSION_ROW_WR_LOCK(sessRow);
-    if (error != 0)
-        return FATAL_ERROR;
 
-    /* start from most recently used */
-    count = (int)min((word32)sessRow->totalCount, SESSIONS_PER_ROW);
-    idx = sessRow->nextIdx - 1;
-    if (idx < 0 || idx >= SESSIONS_PER_ROW) {
-        idx = SESSIONS_PER_ROW - 1; /* if back to front, the previous was end */
-    }
-    for (; count > 0; --count) {
+    for (idx = 0; idx < sessRow->totalCount; idx++) {
 #ifdef SESSION_CACHE_DYNAMIC_MEM
         s = sessRow->Sessions[idx];
 #else
@@ -1172,13 +1774,16 @@ static int TlsSessionCacheGetAndLock(const byte *id,
         /* match session ID value and length */
         if (s && s->sessionIDSz == ID_LEN && s->side == side &&
                 XMEMCMP(s->sessionID, id, ID_LEN) == 0) {
+            /* may only hold the read lock - a racing reader's tick is as
+             * recent */
+            WOLFSSL_ATOMIC_STORE(sessRow->lastUsed[idx],
+                SessionCacheNextTick());
             *sess = s;
             break;
         }
-        idx = idx > 0 ? idx - 1 : SESSIONS_PER_ROW - 1;
     }
     if (*sess == NULL) {
-        SESSION_ROW_UNLOCK(sessRow);
+        SESSION_ROW_UNLOCK(row);
     }
     else {
         *lockedRow = row;
@@ -1518,7 +2123,7 @@ WOLFSSL_SESSION* wolfSSL_GetSession(WOLFSSL* ssl, byte* masterSecret,
 
 int wolfSSL_SetSession(WOLFSSL* ssl, WOLFSSL_SESSION* session)
 {
-    SessionRow* sessRow = NULL;
+    int lockedRow = INVALID_SESSION_ROW;
     int ret = WOLFSSL_SUCCESS;
 
     session = ClientSessionToSession(session);
@@ -1530,9 +2135,9 @@ int wolfSSL_SetSession(WOLFSSL* ssl, WOLFSSL_SESSION* session)
 
     /* We need to lock the session as the first step if its in the cache */
     if (session->type == WOLFSSL_SESSION_TYPE_CACHE) {
-        if (session->cacheRow < SESSION_ROWS) {
-            sessRow = &SessionCache[session->cacheRow];
-            if (SESSION_ROW_RD_LOCK(sessRow) != 0) {
+        if (session->cacheRow >= 0) {
+            lockedRow = session->cacheRow;
+            if (SESSION_ROW_RD_LOCK(lockedRow) != 0) {
                 WOLFSSL_MSG("Session row lock failed");
                 return WOLFSSL_FAILURE;
             }
@@ -1571,9 +2176,9 @@ int wolfSSL_SetSession(WOLFSSL* ssl, WOLFSSL_SESSION* session)
         XMEMCPY(ssl->session->altSessionID, session->altSessionID, ID_LEN);
     }
 
-    if (sessRow != NULL) {
-        SESSION_ROW_UNLOCK(sessRow);
-        sessRow = NULL;
+    if (lockedRow != INVALID_SESSION_ROW) {
+        SESSION_ROW_UNLOCK(lockedRow);
+        lockedRow = INVALID_SESSION_ROW;
     }
 
     /* Note: the `session` variable cannot be used below, since the row is
@@ -1759,22 +2364,22 @@ WOLFSSL_SESSION* ClientSessionToSession(const WOLFSSL_SESSION* session)
             WOLFSSL_MSG("Client cache mutex lock failed");
             return NULL;
         }
-        if (clientSession->serverRow >= SESSION_ROWS ||
+        /* Lock row */
+        error = SESSION_ROW_RD_LOCK(clientSession->serverRow);
+        if (error != 0) {
+            WOLFSSL_MSG("Session cache row lock failure");
+        }
+        else if (clientSession->serverRow >= SessionCacheRows ||
                 clientSession->serverIdx >= SESSIONS_PER_ROW) {
             WOLFSSL_MSG("Client cache serverRow or serverIdx invalid");
+            SESSION_ROW_UNLOCK(clientSession->serverRow);
             error = WOLFSSL_FATAL_ERROR;
         }
-        if (error == 0) {
-            /* Lock row */
+        else {
             sessRow = &SessionCache[clientSession->serverRow];
             /* Prevent memory access before clientSession->serverRow and
              * clientSession->serverIdx are sanitized. */
             XFENCE();
-            error = SESSION_ROW_RD_LOCK(sessRow);
-            if (error != 0) {
-                WOLFSSL_MSG("Session cache row lock failure");
-                sessRow = NULL;
-            }
         }
         if (error == 0) {
 #ifdef SESSION_CACHE_DYNAMIC_MEM
@@ -1807,7 +2412,7 @@ WOLFSSL_SESSION* ClientSessionToSession(const WOLFSSL_SESSION* session)
             WOLFSSL_MSG("Found session cache matching client session object");
         }
         if (sessRow != NULL) {
-            SESSION_ROW_UNLOCK(sessRow);
+            SESSION_ROW_UNLOCK(clientSession->serverRow);
         }
         wc_UnLockMutex(&clisession_mutex);
         return (WOLFSSL_SESSION*)session;
@@ -1822,6 +2427,179 @@ WOLFSSL_SESSION* ClientSessionToSession(const WOLFSSL_SESSION* session)
 #endif
 }
 
+/* Pick the column of a write locked row for a new session: the first empty
+ * column, else the entry that expired first, else the least recently used
+ * entry. Only the entries of this row are considered, see SessionRow. */
+static word32 SessionRowReplaceColumn(SessionRow* sessRow)
+{
+    word32 now = LowResTimer();
+    word32 best = 0;
+    word32 idx = 0;
+    byte   expired = 0;
+    int    i;
+
+    for (i = 0; i < sessRow->totalCount && i < SessionCacheCols; i++) {
+#ifdef SESSION_CACHE_DYNAMIC_MEM
+        WOLFSSL_SESSION* s = sessRow->Sessions[i];
+#else
+        WOLFSSL_SESSION* s = &sessRow->Sessions[i];
+#endif
+        word32 t;
+
+        if (s == NULL || s->sessionIDSz == 0)
+            return (word32)i;
+
+        t = s->bornOn + s->timeout;
+        if (now >= t) {
+            if (!expired || t < best) {
+                expired = 1;
+                best = t;
+                idx = (word32)i;
+            }
+        }
+        else if (!expired) {
+            t = WOLFSSL_ATOMIC_COERCE_UINT(
+                WOLFSSL_ATOMIC_LOAD(sessRow->lastUsed[i]));
+            if (i == 0 || SESSION_TICK_BEFORE(t, best)) {
+                best = t;
+                idx = (word32)i;
+            }
+        }
+    }
+    if (i < SessionCacheCols)
+        return (word32)i; /* unused column */
+
+    return idx;
+}
+
+#ifdef OPENSSL_EXTRA
+/* Evict the session with id from the cache if it is still there. */
+static void SessionCacheEvictId(const byte* id, byte side)
+{
+    WOLFSSL_SESSION* sess = NULL;
+    word32 row = 0;
+
+    if (TlsSessionCacheGetAndWrLock(id, &sess, &row, side) != 0 ||
+            sess == NULL) {
+        return;
+    }
+    EvictSessionFromCache(sess);
+#ifdef SESSION_CACHE_DYNAMIC_MEM
+    {
+        int idx;
+        for (idx = 0; idx < SESSIONS_PER_ROW; idx++) {
+            if (sess == SessionCache[row].Sessions[idx]) {
+                XFREE(sess, sess->heap, DYNAMIC_TYPE_SESSION);
+                SessionCache[row].Sessions[idx] = NULL;
+                break;
+            }
+        }
+    }
+#endif
+    TlsSessionCacheUnlockRow(row);
+}
+
+/* Most sessions ctx may have in the cache - no more than the cache holds. */
+static word32 SessionCacheCtxLimit(const WOLFSSL_CTX* ctx)
+{
+    long cacheSz = wolfSSL_get_session_cache_size();
+
+    if (ctx->sessCacheSize <= 0 || ctx->sessCacheSize > cacheSz)
+        return (word32)cacheSz;
+    return (word32)ctx->sessCacheSize;
+}
+
+/* Evict the sessions ctx added first until it has no more than its limit.
+ * Sessions are evicted one at a time without the ctx lock held. */
+static void SessionCacheCtxTrim(WOLFSSL_CTX* ctx)
+{
+    byte id[ID_LEN];
+
+    for (;;) {
+        int evict = 0;
+
+    #ifndef SINGLE_THREADED
+        if (wc_LockMutex(&ctx->sessCacheLock) != 0) {
+            WOLFSSL_MSG("Session cache ctx lock failed");
+            return;
+        }
+    #endif
+        if (ctx->sessCacheIdsCnt > SessionCacheCtxLimit(ctx)) {
+            XMEMCPY(id, ctx->sessCacheIds + ctx->sessCacheIdsIdx * ID_LEN,
+                ID_LEN);
+            ctx->sessCacheIdsIdx = (ctx->sessCacheIdsIdx + 1) %
+                                   ctx->sessCacheIdsMax;
+            ctx->sessCacheIdsCnt--;
+            evict = 1;
+        }
+    #ifndef SINGLE_THREADED
+        wc_UnLockMutex(&ctx->sessCacheLock);
+    #endif
+        if (!evict)
+            break;
+        SessionCacheEvictId(id, ctx->method->side);
+    }
+}
+
+/* Remember that ctx added the session with id to the cache so that the ones
+ * it added first can be evicted when it goes over its limit.
+ * wolfSSL_CTX_sess_set_cache_size() */
+static void SessionCacheCtxAdded(WOLFSSL_CTX* ctx, const byte* id)
+{
+    word32 limit;
+
+#ifndef SINGLE_THREADED
+    if (wc_LockMutex(&ctx->sessCacheLock) != 0) {
+        WOLFSSL_MSG("Session cache ctx lock failed");
+        return;
+    }
+#endif
+    limit = SessionCacheCtxLimit(ctx);
+    if (ctx->sessCacheIdsCnt == ctx->sessCacheIdsMax &&
+            ctx->sessCacheIdsMax < limit) {
+        /* Grow ring as IDs are added, up to one more than the limit. */
+        word32 max = ctx->sessCacheIdsMax * 2;
+        byte*  ids;
+        word32 i;
+
+        if (max < 8)
+            max = 8;
+        if (max > limit + 1)
+            max = limit + 1;
+        ids = (byte*)XMALLOC((size_t)max * ID_LEN, ctx->heap,
+            DYNAMIC_TYPE_SESSION);
+        if (ids != NULL) {
+            for (i = 0; i < ctx->sessCacheIdsCnt; i++) {
+                XMEMCPY(ids + i * ID_LEN, ctx->sessCacheIds +
+                    ((ctx->sessCacheIdsIdx + i) % ctx->sessCacheIdsMax) *
+                    ID_LEN, ID_LEN);
+            }
+            XFREE(ctx->sessCacheIds, ctx->heap, DYNAMIC_TYPE_SESSION);
+            ctx->sessCacheIds = ids;
+            ctx->sessCacheIdsMax = max;
+            ctx->sessCacheIdsIdx = 0;
+        }
+    }
+    if (ctx->sessCacheIdsMax > 0) {
+        if (ctx->sessCacheIdsCnt == ctx->sessCacheIdsMax) {
+            /* No memory to grow: forget the oldest ID, its session is
+             * evicted when this one is too. */
+            ctx->sessCacheIdsIdx = (ctx->sessCacheIdsIdx + 1) %
+                                   ctx->sessCacheIdsMax;
+            ctx->sessCacheIdsCnt--;
+        }
+        XMEMCPY(ctx->sessCacheIds + ((ctx->sessCacheIdsIdx +
+            ctx->sessCacheIdsCnt) % ctx->sessCacheIdsMax) * ID_LEN, id, ID_LEN);
+        ctx->sessCacheIdsCnt++;
+    }
+#ifndef SINGLE_THREADED
+    wc_UnLockMutex(&ctx->sessCacheLock);
+#endif
+
+    SessionCacheCtxTrim(ctx);
+}
+#endif /* OPENSSL_EXTRA */
+
 int AddSessionToCache(WOLFSSL_CTX* ctx, WOLFSSL_SESSION* addSession,
         const byte* id, byte idSz, int* sessionIndex, int side,
         word16 useTicket, ClientSession** clientCacheEntry)
@@ -1848,6 +2626,7 @@ int AddSessionToCache(WOLFSSL_CTX* ctx, WOLFSSL_SESSION* addSession,
 #endif /* HAVE_SESSION_TICKET */
     int ret = 0;
     int row;
+    word32 lockedRow = 0;
     int i;
     int overwrite = 0;
     (void)ctx;
@@ -1870,6 +2649,19 @@ int AddSessionToCache(WOLFSSL_CTX* ctx, WOLFSSL_SESSION* addSession,
 
 #ifdef HAVE_SESSION_TICKET
     ticLen = addSession->ticketLen;
+#ifdef SESSION_CACHE_SHARED_MEM
+    /* other processes can't follow a pointer into this process' heap */
+    if (SESSION_CACHE_IS_SHARED() && (ticLen > SESSION_TICKET_LEN
+    #if defined(WOLFSSL_TLS13) && defined(WOLFSSL_TICKET_NONCE_MALLOC) &&      \
+    (!defined(HAVE_FIPS) || (defined(FIPS_VERSION_GE) && FIPS_VERSION_GE(5,3)))
+            || addSession->ticketNonce.data !=
+               addSession->ticketNonce.dataStatic
+    #endif
+            )) {
+        WOLFSSL_MSG("Session ticket too big for shared session cache");
+        return BUFFER_E;
+    }
+#endif
     /* Alloc Memory here to avoid syscalls during lock */
     if (ticLen > SESSION_TICKET_LEN) {
         ticBuff = (byte*)XMALLOC((size_t)ticLen, NULL,
@@ -1897,9 +2689,9 @@ int AddSessionToCache(WOLFSSL_CTX* ctx, WOLFSSL_SESSION* addSession,
 
     /* Find a position for the new session in cache and use that */
     /* Use the session object in the cache for external cache if required */
-    row = (int)(HashObject(id, ID_LEN, &ret) % SESSION_ROWS);
+    ret = SessionCacheLockId(id, 0, &lockedRow);
     if (ret != 0) {
-        WOLFSSL_MSG("Hash session failed");
+        WOLFSSL_MSG("Session row lock failed");
     #ifdef HAVE_SESSION_TICKET
         XFREE(ticBuff, NULL, DYNAMIC_TYPE_SESSION_TICK);
     #if defined(WOLFSSL_TLS13) && defined(WOLFSSL_TICKET_NONCE_MALLOC) &&      \
@@ -1909,20 +2701,8 @@ int AddSessionToCache(WOLFSSL_CTX* ctx, WOLFSSL_SESSION* addSession,
     #endif
         return ret;
     }
-
+    row = (int)lockedRow;
     sessRow = &SessionCache[row];
-    if (SESSION_ROW_WR_LOCK(sessRow) != 0) {
-    #ifdef HAVE_SESSION_TICKET
-        XFREE(ticBuff, NULL, DYNAMIC_TYPE_SESSION_TICK);
-    #if defined(WOLFSSL_TLS13) && defined(WOLFSSL_TICKET_NONCE_MALLOC) && \
-        (!defined(HAVE_FIPS) || (defined(FIPS_VERSION_GE) && \
-                                 FIPS_VERSION_GE(5,3)))
-        XFREE(preallocNonce, addSession->heap, DYNAMIC_TYPE_SESSION_TICK);
-    #endif
-    #endif
-        WOLFSSL_MSG("Session row lock failed");
-        return BAD_MUTEX_E;
-    }
 
     for (i = 0; i < SESSIONS_PER_ROW && i < sessRow->totalCount; i++) {
 #ifdef SESSION_CACHE_DYNAMIC_MEM
@@ -1941,7 +2721,7 @@ int AddSessionToCache(WOLFSSL_CTX* ctx, WOLFSSL_SESSION* addSession,
     }
 
     if (!overwrite)
-        idx = (word32)sessRow->nextIdx;
+        idx = SessionRowReplaceColumn(sessRow);
 #ifdef SESSION_INDEX
     if (sessionIndex != NULL)
         *sessionIndex = (row << SESSIDX_ROW_SHIFT) | idx;
@@ -1961,7 +2741,7 @@ int AddSessionToCache(WOLFSSL_CTX* ctx, WOLFSSL_SESSION* addSession,
             XFREE(preallocNonce, addSession->heap, DYNAMIC_TYPE_SESSION_TICK);
         #endif
         #endif
-            SESSION_ROW_UNLOCK(sessRow);
+            SESSION_ROW_UNLOCK(lockedRow);
             return MEMORY_E;
         }
         XMEMSET(cacheSession, 0, sizeof(WOLFSSL_SESSION));
@@ -2060,11 +2840,12 @@ int AddSessionToCache(WOLFSSL_CTX* ctx, WOLFSSL_SESSION* addSession,
 
     if (ret == 0) {
         if (!overwrite) {
-            /* Increment the totalCount and the nextIdx */
-            if (sessRow->totalCount < SESSIONS_PER_ROW)
+            /* A new column extends the used part of the row */
+            if ((int)idx == sessRow->totalCount)
                 sessRow->totalCount++;
-            sessRow->nextIdx = (sessRow->nextIdx + 1) % SESSIONS_PER_ROW;
+            sessRow->nextIdx = (int)((idx + 1) % SESSIONS_PER_ROW);
         }
+        WOLFSSL_ATOMIC_STORE(sessRow->lastUsed[idx], SessionCacheNextTick());
         if (id != addSession->sessionID) {
             /* ssl->session->sessionID may contain the bogus ID or we want the
              * ID from the arrays object */
@@ -2076,9 +2857,16 @@ int AddSessionToCache(WOLFSSL_CTX* ctx, WOLFSSL_SESSION* addSession,
             cacheSession->rem_sess_cb = ctx->rem_sess_cb;
 #endif
 #ifdef HAVE_EX_DATA
-        /* The session in cache now owns the ex_data */
-        addSession->ownExData = 0;
-        cacheSession->ownExData = 1;
+        if (SESSION_CACHE_IS_SHARED()) {
+            /* ex_data pointers only mean something in this process */
+            XMEMSET(&cacheSession->ex_data, 0, sizeof(WOLFSSL_CRYPTO_EX_DATA));
+            cacheSession->ownExData = 0;
+        }
+        else {
+            /* The session in cache now owns the ex_data */
+            addSession->ownExData = 0;
+            cacheSession->ownExData = 1;
+        }
 #endif
 #if defined(HAVE_SESSION_TICKET) && defined(WOLFSSL_TLS13) &&                  \
     defined(WOLFSSL_TICKET_NONCE_MALLOC) &&                                    \
@@ -2100,9 +2888,14 @@ int AddSessionToCache(WOLFSSL_CTX* ctx, WOLFSSL_SESSION* addSession,
         cacheSession->ticketLen = 0;
     }
 #endif
-    SESSION_ROW_UNLOCK(sessRow);
+    SESSION_ROW_UNLOCK(lockedRow);
     cacheSession = NULL; /* Can't access after unlocked */
 
+#ifdef OPENSSL_EXTRA
+    if (ret == 0 && !overwrite && ctx != NULL && ctx->sessCacheSize > 0)
+        SessionCacheCtxAdded(ctx, id);
+#endif
+
 #ifndef NO_CLIENT_CACHE
     if (ret == 0 && clientCacheEntry != NULL) {
         ClientSession* clientCache = AddSessionToClientCache(side, row,
@@ -2269,15 +3062,18 @@ int wolfSSL_GetSessionAtIndex(int idx, WOLFSSL_SESSION* session)
     row = idx >> SESSIDX_ROW_SHIFT;
     col = idx & SESSIDX_IDX_MASK;
 
-    if (session == NULL ||
-            row < 0 || row >= SESSION_ROWS || col >= SESSIONS_PER_ROW) {
+    if (session == NULL || row < 0 || col >= SESSIONS_PER_ROW) {
         return WOLFSSL_FAILURE;
     }
 
-    sessRow = &SessionCache[row];
-    if (SESSION_ROW_RD_LOCK(sessRow) != 0) {
+    if (SESSION_ROW_RD_LOCK(row) != 0) {
         return BAD_MUTEX_E;
     }
+    if ((word32)row >= SessionCacheRows) {
+        SESSION_ROW_UNLOCK(row);
+        return WOLFSSL_FAILURE;
+    }
+    sessRow = &SessionCache[row];
 
 #ifdef SESSION_CACHE_DYNAMIC_MEM
     cacheSession = sessRow->Sessions[col];
@@ -2295,7 +3091,7 @@ int wolfSSL_GetSessionAtIndex(int idx, WOLFSSL_SESSION* session)
         result = WOLFSSL_FAILURE;
     }
 
-    SESSION_ROW_UNLOCK(sessRow);
+    SESSION_ROW_UNLOCK(row);
 
     WOLFSSL_LEAVE("wolfSSL_GetSessionAtIndex", result);
     return result;
@@ -2356,8 +3152,7 @@ WOLFSSL_X509* wolfSSL_SESSION_get0_peer(WOLFSSL_SESSION* session)
 static int get_locked_session_stats(word32* active, word32* total, word32* peak)
 {
     int result = WOLFSSL_SUCCESS;
-    int i;
-    int count;
+    word32 i;
     int idx;
     word32 now   = 0;
     word32 seen  = 0;
@@ -2365,32 +3160,26 @@ static int get_locked_session_stats(word32* active, word32* total, word32* peak)
 
     WOLFSSL_ENTER("get_locked_session_stats");
 
-#ifndef ENABLE_SESSION_CACHE_ROW_LOCK
-    SESSION_ROW_RD_LOCK(&SessionCache[0]);
-#endif
-    for (i = 0; i < SESSION_ROWS; i++) {
-        SessionRow* row = &SessionCache[i];
-    #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
-        if (SESSION_ROW_RD_LOCK(row) != 0) {
+    for (i = 0; i < SessionCacheRows; i++) {
+        SessionRow* row;
+        if (SESSION_ROW_RD_LOCK(i) != 0) {
             WOLFSSL_MSG("Session row cache mutex lock failed");
             return BAD_MUTEX_E;
         }
-    #endif
+        if (i >= SessionCacheRows) {
+            SESSION_ROW_UNLOCK(i);
+            break;
+        }
+        row = &SessionCache[i];
 
         seen += row->totalCount;
 
         if (active == NULL) {
-            SESSION_ROW_UNLOCK(row);
+            SESSION_ROW_UNLOCK(i);
             continue;
         }
 
-        count = min((word32)row->totalCount, SESSIONS_PER_ROW);
-        idx   = row->nextIdx - 1;
-        if (idx < 0 || idx >= SESSIONS_PER_ROW) {
-            idx = SESSIONS_PER_ROW - 1; /* if back to front previous was end */
-        }
-
-        for (; count > 0; --count) {
+        for (idx = 0; idx < row->totalCount; idx++) {
             /* if not expired then good */
 #ifdef SESSION_CACHE_DYNAMIC_MEM
             if (row->Sessions[idx] &&
@@ -2403,17 +3192,10 @@ static int get_locked_session_stats(word32* active, word32* total, word32* peak)
             {
                 now++;
             }
-
-            idx = idx > 0 ? idx - 1 : SESSIONS_PER_ROW - 1;
         }
 
-    #ifdef ENABLE_SESSION_CACHE_ROW_LOCK
-        SESSION_ROW_UNLOCK(row);
-    #endif
+        SESSION_ROW_UNLOCK(i);
     }
-#ifndef ENABLE_SESSION_CACHE_ROW_LOCK
-    SESSION_ROW_UNLOCK(&SessionCache[0]);
-#endif
 
     if (active) {
         *active = now;
@@ -2445,7 +3227,7 @@ int wolfSSL_get_session_stats(word32* active, word32* total, word32* peak,
     WOLFSSL_ENTER("wolfSSL_get_session_stats");
 
     if (maxSessions) {
-        *maxSessions = SESSIONS_PER_ROW * SESSION_ROWS;
+        *maxSessions = (word32)wolfSSL_get_session_cache_size();
 
         if (active == NULL && total == NULL && peak == NULL)
             return result;  /* we're done */
@@ -2491,9 +3273,9 @@ int wolfSSL_get_session_stats(word32* active, word32* total, word32* peak,
 #endif
         printf("Max   Sessions      = %u\n", maxSessions);
 
-        E = (double)totalSessionsSeen / SESSION_ROWS;
+        E = (double)totalSessionsSeen / SessionCacheRows;
 
-        for (i = 0; i < SESSION_ROWS; i++) {
+        for (i = 0; i < (int)SessionCacheRows; i++) {
             double diff = SessionCache[i].totalCount - E;
             diff *= diff;                /* square    */
             diff /= E;                   /* normalize */
@@ -2501,7 +3283,9 @@ int wolfSSL_get_session_stats(word32* active, word32* total, word32* peak,
             chiSquare += diff;
         }
         printf("  chi-square = %5.1f, d.f. = %d\n", chiSquare,
-                                                     SESSION_ROWS - 1);
+                                                (int)SessionCacheRows - 1);
+        /* p values are for the compiled number of rows */
+        if (SessionCacheRows == SESSION_ROWS) {
         #if (SESSION_ROWS == 11)
             printf(" .05 p value =  18.3, chi-square should be less\n");
         #elif (SESSION_ROWS == 211)
@@ -2513,6 +3297,7 @@ int wolfSSL_get_session_stats(word32* active, word32* total, word32* peak,
         #elif (SESSION_ROWS == 2861)
             printf(".05 p value  = 2985.5, chi-square should be less\n");
         #endif
+        }
         printf("\n");
 
         return ret;
@@ -2542,28 +3327,58 @@ WOLFSSL_SESSION* wolfSSL_GetSession(WOLFSSL* ssl, byte* masterSecret,
 
 #ifdef OPENSSL_EXTRA
 
-   /* returns previous set cache size which stays constant */
+    /* Limit the number of sessions ctx keeps in the session cache.
+     *
+     * The session cache is shared by all contexts and sized with
+     * wolfSSL_set_session_cache_size(). When ctx has sz sessions in it, the
+     * session ctx added first is evicted for a new one. 0 removes the limit,
+     * as in OpenSSL, leaving only the size of the cache.
+     *
+     * returns previous limit, see wolfSSL_CTX_sess_get_cache_size(), or 0 when
+     *         ctx is NULL or sz is negative. */
     long wolfSSL_CTX_sess_set_cache_size(WOLFSSL_CTX* ctx, long sz)
     {
-        /* cache size fixed at compile time in wolfSSL */
-        (void)ctx;
-        (void)sz;
-        WOLFSSL_MSG("session cache is set at compile time");
         #ifndef NO_SESSION_CACHE
-            return (long)(SESSIONS_PER_ROW * SESSION_ROWS);
-        #else
+        long prev;
+
+        if (ctx == NULL || sz < 0)
             return 0;
+
+        #ifndef SINGLE_THREADED
+        if (!ctx->sessCacheLockInit) {
+            if (wc_InitMutex(&ctx->sessCacheLock) != 0) {
+                WOLFSSL_MSG("Session cache ctx lock init failed");
+                return 0;
+            }
+            ctx->sessCacheLockInit = 1;
+        }
+        #endif
+
+        prev = wolfSSL_CTX_sess_get_cache_size(ctx);
+        ctx->sessCacheSize = sz;
+        /* Sessions added while there is no limit aren't remembered. */
+        SessionCacheCtxTrim(ctx);
+
+        return prev;
+        #else
+        (void)ctx;
+        (void)sz;
+        return 0;
         #endif
     }
 
 
+    /* returns the limit on sessions ctx keeps in the session cache, the size
+     * of the cache when ctx has no limit of its own. */
     long wolfSSL_CTX_sess_get_cache_size(WOLFSSL_CTX* ctx)
     {
-        (void)ctx;
         #ifndef NO_SESSION_CACHE
-            return (long)(SESSIONS_PER_ROW * SESSION_ROWS);
+        if (ctx != NULL && ctx->sessCacheSize > 0)
+            return ctx->sessCacheSize;
+        return wolfSSL_get_session_cache_size();
         #else
-            return 0;
+        (void)ctx;
+        return 0;
         #endif
     }
 
@@ -3251,7 +4066,7 @@ long wolfSSL_SESSION_set_time(WOLFSSL_SESSION *ses, long t)
 static void SESSION_ex_data_cache_update(WOLFSSL_SESSION* session, int idx,
         void* data, byte get, void** getRet, int* setRet)
 {
-    int row;
+    word32 row;
     int i;
     int error = 0;
     SessionRow* sessRow = NULL;
@@ -3271,21 +4086,12 @@ static void SESSION_ex_data_cache_update(WOLFSSL_SESSION* session, int idx,
         return;
     }
 
-    row = (int)(HashObject(id, ID_LEN, &error) % SESSION_ROWS);
-    if (error != 0) {
-        WOLFSSL_MSG("Hash session failed");
-        return;
-    }
-
-    sessRow = &SessionCache[row];
-    if (get)
-        error = SESSION_ROW_RD_LOCK(sessRow);
-    else
-        error = SESSION_ROW_WR_LOCK(sessRow);
+    error = SessionCacheLockId(id, get, &row);
     if (error != 0) {
         WOLFSSL_MSG("Session row lock failed");
         return;
     }
+    sessRow = &SessionCache[row];
 
     for (i = 0; i < SESSIONS_PER_ROW && i < sessRow->totalCount; i++) {
         WOLFSSL_SESSION* cacheSession;
@@ -3316,7 +4122,7 @@ static void SESSION_ex_data_cache_update(WOLFSSL_SESSION* session, int idx,
             break;
         }
     }
-    SESSION_ROW_UNLOCK(sessRow);
+    SESSION_ROW_UNLOCK(row);
     /* If we don't have a session in cache then clear the ex_data and
      * own it */
     if (!foundCache) {
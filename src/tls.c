@@ -215,10 +215,21 @@ int BuildTlsHandshakeHash(WOLFSSL* ssl, byte* hash, word32* hashLen)
     if (ssl == NULL || hash == NULL || hashLen == NULL || *hashLen < HSHASH_SZ)
         return BAD_FUNC_ARG;
 
+    if (IsAtLeastTLSv1_2(ssl))
+        ret = StartHandshakeHashes(ssl,
+            HandshakeHashForMac(ssl->specs.mac_algorithm));
+    else
+        ret = StartHandshakeHashes(ssl, HS_HASH_MD5 | HS_HASH_SHA);
+    if (ret != 0)
+        return ret;
+
     /* for constant timing perform these even if error */
 #ifndef NO_OLD_TLS
-    ret |= wc_Md5GetHash(&ssl->hsHashes->hashMd5, hash);
-    ret |= wc_ShaGetHash(&ssl->hsHashes->hashSha, &hash[WC_MD5_DIGEST_SIZE]);
+    if (HS_HASH_RUNNING(ssl->hsHashes, HS_HASH_MD5 | HS_HASH_SHA)) {
+        ret |= wc_Md5GetHash(&ssl->hsHashes->hashMd5, hash);
+        ret |= wc_ShaGetHash(&ssl->hsHashes->hashSha,
+            &hash[WC_MD5_DIGEST_SIZE]);
+    }
 #endif
 
     if (IsAtLeastTLSv1_2(ssl)) {
@@ -8566,69 +8577,77 @@ static int TLSX_KeyShare_GenX448Key(WOLFSSL *ssl, KeyShareEntry* kse)
     return ret;
 }
 
-/* Create a key share entry using named elliptic curve parameters group.
- * Generates a key pair.
+#if defined(HAVE_ECC) && defined(HAVE_ECC_KEY_EXPORT)
+/* Translate a named ECC group to a curve id.
  *
- * ssl   The SSL/TLS object.
- * kse   The key share entry object.
- * returns 0 on success, otherwise failure.
+ * group  The named group.
+ * returns the curve id or ECC_CURVE_INVALID when not supported.
  */
-static int TLSX_KeyShare_GenEccKey(WOLFSSL *ssl, KeyShareEntry* kse)
+static int TLSX_KeyShare_EccCurveId(int group)
 {
-    int ret = 0;
-#if defined(HAVE_ECC) && defined(HAVE_ECC_KEY_EXPORT)
-    word32 keySize = 0;
-    word16 curveId = (word16) ECC_CURVE_INVALID;
-    ecc_key* eccKey = (ecc_key*)kse->key;
-
-    /* Translate named group to a curve id. */
-    switch (kse->group) {
+    switch (group) {
     #if (!defined(NO_ECC256)  || defined(HAVE_ALL_CURVES)) && ECC_MIN_KEY_SZ <= 256
         #ifndef NO_ECC_SECP
         case WOLFSSL_ECC_SECP256R1:
-            curveId = ECC_SECP256R1;
-            break;
+            return ECC_SECP256R1;
         #endif /* !NO_ECC_SECP */
         #ifdef WOLFSSL_SM2
         case WOLFSSL_ECC_SM2P256V1:
-            curveId = ECC_SM2P256V1;
-            break;
+            return ECC_SM2P256V1;
         #endif /* !WOLFSSL_SM2 */
         #ifdef HAVE_ECC_BRAINPOOL
         case WOLFSSL_ECC_BRAINPOOLP256R1TLS13:
-            curveId = ECC_BRAINPOOLP256R1;
-            break;
+            return ECC_BRAINPOOLP256R1;
         #endif /* HAVE_ECC_BRAINPOOL */
     #endif
     #if (defined(HAVE_ECC384) || defined(HAVE_ALL_CURVES)) && ECC_MIN_KEY_SZ <= 384
         #ifndef NO_ECC_SECP
         case WOLFSSL_ECC_SECP384R1:
-            curveId = ECC_SECP384R1;
-            break;
+            return ECC_SECP384R1;
         #endif /* !NO_ECC_SECP */
         #ifdef HAVE_ECC_BRAINPOOL
         case WOLFSSL_ECC_BRAINPOOLP384R1TLS13:
-            curveId = ECC_BRAINPOOLP384R1;
-            break;
+            return ECC_BRAINPOOLP384R1;
         #endif /* HAVE_ECC_BRAINPOOL */
     #endif
     #if (defined(HAVE_ECC512) || defined(HAVE_ALL_CURVES)) && ECC_MIN_KEY_SZ <= 512
         #ifdef HAVE_ECC_BRAINPOOL
         case WOLFSSL_ECC_BRAINPOOLP512R1TLS13:
-            curveId = ECC_BRAINPOOLP512R1;
-            break;
+            return ECC_BRAINPOOLP512R1;
         #endif /* HAVE_ECC_BRAINPOOL */
     #endif
     #if (defined(HAVE_ECC521) || defined(HAVE_ALL_CURVES)) && ECC_MIN_KEY_SZ <= 521
         #ifndef NO_ECC_SECP
         case WOLFSSL_ECC_SECP521R1:
-            curveId = ECC_SECP521R1;
-            break;
+            return ECC_SECP521R1;
         #endif /* !NO_ECC_SECP */
     #endif
         default:
-            WOLFSSL_ERROR_VERBOSE(BAD_FUNC_ARG);
-            return BAD_FUNC_ARG;
+            return ECC_CURVE_INVALID;
+    }
+}
+#endif /* HAVE_ECC && HAVE_ECC_KEY_EXPORT */
+
+/* Create a key share entry using named elliptic curve parameters group.
+ * Generates a key pair.
+ *
+ * ssl   The SSL/TLS object.
+ * kse   The key share entry object.
+ * returns 0 on success, otherwise failure.
+ */
+static int TLSX_KeyShare_GenEccKey(WOLFSSL *ssl, KeyShareEntry* kse)
+{
+    int ret = 0;
+#if defined(HAVE_ECC) && defined(HAVE_ECC_KEY_EXPORT)
+    word32 keySize = 0;
+    word16 curveId = (word16) ECC_CURVE_INVALID;
+    ecc_key* eccKey = (ecc_key*)kse->key;
+
+    /* Translate named group to a curve id. */
+    curveId = (word16)TLSX_KeyShare_EccCurveId(kse->group);
+    if (curveId == (word16)ECC_CURVE_INVALID) {
+        WOLFSSL_ERROR_VERBOSE(BAD_FUNC_ARG);
+        return BAD_FUNC_ARG;
     }
 
     {
@@ -8929,14 +8948,16 @@ static void findEccPqc(int *ecc, int *pqc, int *pqc_first, int group)
 
 #if !defined(WOLFSSL_MLKEM_NO_MAKE_KEY) && \
     !defined(WOLFSSL_MLKEM_NO_DECAPSULATE)
-/* Create a key share entry using pqc parameters group on the client side.
- * Generates a key pair.
+/* Generate an ML-KEM key pair into a key share entry.
  *
- * ssl   The SSL/TLS object.
- * kse   The key share entry object.
+ * heap   The heap to allocate the key data with.
+ * devId  The device to make the key with.
+ * rng    The random number generator.
+ * kse    The key share entry object.
  * returns 0 on success, otherwise failure.
  */
-static int TLSX_KeyShare_GenPqcKeyClient(WOLFSSL *ssl, KeyShareEntry* kse)
+static int TLSX_KeyShare_MakePqcKey(void* heap, int devId, WC_RNG* rng,
+    KeyShareEntry* kse)
 {
     int ret = 0;
     int type = 0;
@@ -8966,7 +8987,7 @@ static int TLSX_KeyShare_GenPqcKeyClient(WOLFSSL *ssl, KeyShareEntry* kse)
 
     #ifdef WOLFSSL_SMALL_STACK
     if (ret == 0) {
-        kem = (MlKemKey *)XMALLOC(sizeof(*kem), ssl->heap,
+        kem = (MlKemKey *)XMALLOC(sizeof(*kem), heap,
                                   DYNAMIC_TYPE_PRIVATE_KEY);
         if (kem == NULL) {
             WOLFSSL_MSG("KEM memory allocation failure");
@@ -8976,7 +8997,7 @@ static int TLSX_KeyShare_GenPqcKeyClient(WOLFSSL *ssl, KeyShareEntry* kse)
     #endif /* WOLFSSL_SMALL_STACK */
 
     if (ret == 0) {
-        ret = wc_MlKemKey_Init(kem, type, ssl->heap, ssl->devId);
+        ret = wc_MlKemKey_Init(kem, type, heap, devId);
         if (ret != 0) {
             WOLFSSL_MSG("Failed to initialize ML-KEM Key.");
         }
@@ -8990,7 +9011,7 @@ static int TLSX_KeyShare_GenPqcKeyClient(WOLFSSL *ssl, KeyShareEntry* kse)
     }
 
     if (ret == 0) {
-        privKey = (byte*)XMALLOC(privSz, ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+        privKey = (byte*)XMALLOC(privSz, heap, DYNAMIC_TYPE_PRIVATE_KEY);
         if (privKey == NULL) {
             WOLFSSL_MSG("privkey memory allocation failure");
             ret = MEMORY_ERROR;
@@ -8999,7 +9020,7 @@ static int TLSX_KeyShare_GenPqcKeyClient(WOLFSSL *ssl, KeyShareEntry* kse)
 #else
     if (ret == 0) {
         /* Allocate an ML-KEM key to hold private key. */
-        kem = (MlKemKey*)XMALLOC(sizeof(MlKemKey), ssl->heap,
+        kem = (MlKemKey*)XMALLOC(sizeof(MlKemKey), heap,
                                  DYNAMIC_TYPE_PRIVATE_KEY);
         if (kem == NULL) {
             WOLFSSL_MSG("KEM memory allocation failure");
@@ -9007,7 +9028,7 @@ static int TLSX_KeyShare_GenPqcKeyClient(WOLFSSL *ssl, KeyShareEntry* kse)
         }
     }
     if (ret == 0) {
-        ret = wc_MlKemKey_Init(kem, type, ssl->heap, ssl->devId);
+        ret = wc_MlKemKey_Init(kem, type, heap, devId);
         if (ret != 0) {
             WOLFSSL_MSG("Failed to initialize ML-KEM Key.");
         }
@@ -9018,7 +9039,7 @@ static int TLSX_KeyShare_GenPqcKeyClient(WOLFSSL *ssl, KeyShareEntry* kse)
 #endif
 
     if (ret == 0) {
-        kse->pubKey = (byte*)XMALLOC(kse->pubKeyLen, ssl->heap,
+        kse->pubKey = (byte*)XMALLOC(kse->pubKeyLen, heap,
                                      DYNAMIC_TYPE_PUBLIC_KEY);
         if (kse->pubKey == NULL) {
             WOLFSSL_MSG("pubkey memory allocation failure");
@@ -9027,7 +9048,7 @@ static int TLSX_KeyShare_GenPqcKeyClient(WOLFSSL *ssl, KeyShareEntry* kse)
     }
 
     if (ret == 0) {
-        ret = wc_MlKemKey_MakeKey(kem, ssl->rng);
+        ret = wc_MlKemKey_MakeKey(kem, rng);
         if (ret != 0) {
             WOLFSSL_MSG("ML-KEM keygen failure");
         }
@@ -9053,16 +9074,16 @@ static int TLSX_KeyShare_GenPqcKeyClient(WOLFSSL *ssl, KeyShareEntry* kse)
     if (ret != 0) {
         /* Data owned by key share entry otherwise. */
         wc_MlKemKey_Free(kem);
-        XFREE(kse->pubKey, ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
+        XFREE(kse->pubKey, heap, DYNAMIC_TYPE_PUBLIC_KEY);
         kse->pubKey = NULL;
     #ifndef WOLFSSL_TLSX_PQC_MLKEM_STORE_OBJ
         if (privKey) {
             ForceZero(privKey, privSz);
-            XFREE(privKey, ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+            XFREE(privKey, heap, DYNAMIC_TYPE_PRIVATE_KEY);
             privKey = NULL;
         }
     #else
-        XFREE(kem, ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+        XFREE(kem, heap, DYNAMIC_TYPE_PRIVATE_KEY);
         kse->key = NULL;
     #endif
     }
@@ -9078,12 +9099,88 @@ static int TLSX_KeyShare_GenPqcKeyClient(WOLFSSL *ssl, KeyShareEntry* kse)
 
     #if !defined(WOLFSSL_TLSX_PQC_MLKEM_STORE_OBJ) && \
         defined(WOLFSSL_SMALL_STACK)
-    XFREE(kem, ssl->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+    XFREE(kem, heap, DYNAMIC_TYPE_PRIVATE_KEY);
     #endif
 
     return ret;
 }
 
+/* Create a key share entry using pqc parameters group on the client side.
+ * Generates a key pair.
+ *
+ * ssl   The SSL/TLS object.
+ * kse   The key share entry object.
+ * returns 0 on success, otherwise failure.
+ */
+static int TLSX_KeyShare_GenPqcKeyClient(WOLFSSL *ssl, KeyShareEntry* kse)
+{
+    return TLSX_KeyShare_MakePqcKey(ssl->heap, ssl->devId, ssl->rng, kse);
+}
+
+/* Move the ECC and ML-KEM halves of a hybrid key share into kse. The public
+ * keys are concatenated in the order pqc_first gives. ecc_kse and pqc_kse
+ * keep only what is left to free.
+ *
+ * heap     The heap to allocate the combined public key with.
+ * kse      The hybrid key share entry object.
+ * ecc_kse  The key share entry with the ECC key pair.
+ * pqc_kse  The key share entry with the ML-KEM key pair.
+ * returns 0 on success, otherwise failure.
+ */
+static int TLSX_KeyShare_JoinHybrid(void* heap, KeyShareEntry* kse,
+    KeyShareEntry* ecc_kse, KeyShareEntry* pqc_kse, int pqc_first)
+{
+    int ret = 0;
+
+    /* Allocate memory for combined public key */
+    kse->pubKey = (byte*)XMALLOC(ecc_kse->pubKeyLen + pqc_kse->pubKeyLen,
+                                 heap, DYNAMIC_TYPE_PUBLIC_KEY);
+    if (kse->pubKey == NULL) {
+        WOLFSSL_MSG("pubkey memory allocation failure");
+        ret = MEMORY_ERROR;
+    }
+
+    /* Create combined public key. The order of classic/pqc key material is
+     * indicated by the pqc_first variable. */
+    if (ret == 0) {
+        if (pqc_first) {
+            XMEMCPY(kse->pubKey, pqc_kse->pubKey, pqc_kse->pubKeyLen);
+            XMEMCPY(kse->pubKey + pqc_kse->pubKeyLen, ecc_kse->pubKey,
+                    ecc_kse->pubKeyLen);
+        }
+        else {
+            XMEMCPY(kse->pubKey, ecc_kse->pubKey, ecc_kse->pubKeyLen);
+            XMEMCPY(kse->pubKey + ecc_kse->pubKeyLen, pqc_kse->pubKey,
+                    pqc_kse->pubKeyLen);
+        }
+        kse->pubKeyLen = ecc_kse->pubKeyLen + pqc_kse->pubKeyLen;
+    }
+
+    /* Store the private keys.
+     * Note we are saving the PQC private key and ECC private key
+     * separately. That's because the ECC private key is not simply a
+     * buffer. Its is an ecc_key struct. */
+    if (ret == 0) {
+    #ifndef WOLFSSL_TLSX_PQC_MLKEM_STORE_OBJ
+        /* PQC private key is an encoded byte array */
+        kse->privKey = pqc_kse->privKey;
+        kse->privKeyLen = pqc_kse->privKeyLen;
+        pqc_kse->privKey = NULL;
+    #else
+        /* PQC private key is a pointer to MlKemKey object */
+        kse->privKey = (byte*)pqc_kse->key;
+        kse->privKeyLen = 0;
+        pqc_kse->key = NULL;
+    #endif
+        /* ECC private key is a pointer to ecc_key object */
+        kse->key = ecc_kse->key;
+        kse->keyLen = ecc_kse->keyLen;
+        ecc_kse->key = NULL;
+    }
+
+    return ret;
+}
+
 /* Create a key share entry using both ecdhe and pqc parameters groups.
  * Generates two key pairs on the client side.
  *
@@ -9190,66 +9287,633 @@ static int TLSX_KeyShare_GenPqcHybridKeyClient(WOLFSSL *ssl, KeyShareEntry* kse)
         /* No error message, TLSX_KeyShare_GenPqcKeyClient will do it. */
     }
 
-    /* Allocate memory for combined public key */
     if (ret == 0) {
-        kse->pubKey = (byte*)XMALLOC(ecc_kse->pubKeyLen + pqc_kse->pubKeyLen,
-                                     ssl->heap, DYNAMIC_TYPE_PUBLIC_KEY);
-        if (kse->pubKey == NULL) {
-            WOLFSSL_MSG("pubkey memory allocation failure");
-            ret = MEMORY_ERROR;
+        ret = TLSX_KeyShare_JoinHybrid(ssl->heap, kse, ecc_kse, pqc_kse,
+                                       pqc_first);
+    }
+
+#ifdef WOLFSSL_DEBUG_TLS
+    WOLFSSL_MSG("Public ML-KEM Key");
+    WOLFSSL_BUFFER(kse->pubKey, kse->pubKeyLen );
+#endif
+
+    TLSX_KeyShare_FreeAll(ecc_kse, ssl->heap);
+    TLSX_KeyShare_FreeAll(pqc_kse, ssl->heap);
+
+    return ret;
+}
+#endif /* !WOLFSSL_MLKEM_NO_MAKE_KEY && !WOLFSSL_MLKEM_NO_DECAPSULATE */
+#endif /* WOLFSSL_HAVE_MLKEM */
+
+#ifdef WOLFSSL_KEY_SHARE_POOL
+
+#if !defined(SINGLE_THREADED) && defined(WOLFSSL_PTHREADS)
+    #define KEY_SHARE_POOL_THREAD
+#endif
+/* POSIX threads imply getpid() even when the build didn't check for it. */
+#if !defined(WOLFSSL_NO_GETPID) && \
+    (defined(HAVE_GETPID) || defined(KEY_SHARE_POOL_THREAD))
+    #define KEY_SHARE_POOL_PID
+#endif
+
+/* Pre-generated ephemeral key shares for a CTX.
+ *
+ * Each configured group has a list of ready entries, linked through next,
+ * holding a key pair made with the pool's own RNG. A handshake unlinks one
+ * under the lock and keeps it. Key generation happens outside the lock, on the
+ * background thread or in wolfSSL_CTX_KeySharePoolRefill().
+ *
+ * The keys belong to the process that made the pool. A child made by fork()
+ * holds a copy of them but not the thread, so it treats the pool as dropped
+ * and generates its key shares inline.
+ */
+struct KeySharePool {
+    KeyShareEntry* ready[WOLFSSL_KEY_SHARE_POOL_MAX_GROUPS];
+    int            count[WOLFSSL_KEY_SHARE_POOL_MAX_GROUPS];
+    word16         groups[WOLFSSL_KEY_SHARE_POOL_MAX_GROUPS];
+    int            groupCnt;
+    int            depth;
+    void*          heap;
+    WC_RNG         rng;
+    wolfSSL_Mutex  lock;        /* Ready lists and counts. */
+    wolfSSL_Mutex  genLock;     /* Serializes refills, which share rng. */
+#ifdef KEY_SHARE_POOL_PID
+    pid_t          pid;         /* Process that made the pool. */
+#endif
+#ifdef KEY_SHARE_POOL_THREAD
+    pthread_mutex_t thrLock;
+    pthread_cond_t  thrCond;
+    THREAD_TYPE     thread;
+    byte            running;
+    byte            stop;
+    byte            wake;
+#endif
+};
+
+/* Whether a pool can make key shares for the named group. */
+static int KeySharePool_GroupSupported(word16 group)
+{
+#if defined(WOLFSSL_HAVE_MLKEM) && !defined(WOLFSSL_MLKEM_NO_MAKE_KEY) && \
+    !defined(WOLFSSL_MLKEM_NO_DECAPSULATE)
+    int type;
+    int ecc_group = 0;
+    int pqc_group = 0;
+
+    if (WOLFSSL_NAMED_GROUP_IS_PQC(group))
+        return mlkem_id2type(group, &type) == 0;
+    if (WOLFSSL_NAMED_GROUP_IS_PQC_HYBRID(group)) {
+        findEccPqc(&ecc_group, &pqc_group, NULL, group);
+        if (ecc_group == 0 || pqc_group == 0 ||
+                mlkem_id2type(pqc_group, &type) != 0) {
+            return 0;
         }
+        group = (word16)ecc_group;
     }
+#endif
+#ifdef HAVE_CURVE25519
+    if (group == WOLFSSL_ECC_X25519)
+        return 1;
+#endif
+#if defined(HAVE_ECC) && defined(HAVE_ECC_KEY_EXPORT)
+    if (TLSX_KeyShare_EccCurveId(group) != ECC_CURVE_INVALID)
+        return 1;
+#endif
+    return 0;
+}
 
-    /* Create combined public key. The order of classic/pqc key material is
-     * indicated by the pqc_first variable. */
+/* Make an X25519 or ECC key pair into kse for the group it names.
+ *
+ * Pooled keys never use a device, a PK callback or a static key.
+ */
+static int KeySharePool_MakeEcKey(KeySharePool* pool, KeyShareEntry* kse)
+{
+    int ret = BAD_FUNC_ARG;
+
+#ifdef HAVE_CURVE25519
+    if (kse->group == WOLFSSL_ECC_X25519) {
+        curve25519_key* key;
+
+        key = (curve25519_key*)XMALLOC(sizeof(curve25519_key), pool->heap,
+                                       DYNAMIC_TYPE_PRIVATE_KEY);
+        if (key == NULL)
+            return MEMORY_E;
+        ret = wc_curve25519_init_ex(key, pool->heap, INVALID_DEVID);
+        if (ret != 0) {
+            XFREE(key, pool->heap, DYNAMIC_TYPE_PRIVATE_KEY);
+            return ret;
+        }
+        kse->key = key;
+        kse->keyLen = CURVE25519_KEYSIZE;
+
+        ret = wc_curve25519_make_key(&pool->rng, CURVE25519_KEYSIZE, key);
+        if (ret == 0) {
+            kse->pubKey = (byte*)XMALLOC(CURVE25519_KEYSIZE, pool->heap,
+                                         DYNAMIC_TYPE_PUBLIC_KEY);
+            if (kse->pubKey == NULL)
+                ret = MEMORY_E;
+        }
+        if (ret == 0) {
+            kse->pubKeyLen = CURVE25519_KEYSIZE;
+            if (wc_curve25519_export_public_ex(key, kse->pubKey,
+                    &kse->pubKeyLen, EC25519_LITTLE_ENDIAN) != 0) {
+                ret = ECC_EXPORT_ERROR;
+            }
+        }
+        return ret;
+    }
+#endif
+#if defined(HAVE_ECC) && defined(HAVE_ECC_KEY_EXPORT)
+    {
+        int curveId = TLSX_KeyShare_EccCurveId(kse->group);
+        int keySz;
+        ecc_key* key;
+
+        if (curveId == ECC_CURVE_INVALID)
+            return BAD_FUNC_ARG;
+        keySz = wc_ecc_get_curve_size_from_id(curveId);
+        if (keySz < 0)
+            return keySz;
+
+        key = (ecc_key*)XMALLOC(sizeof(ecc_key), pool->heap, DYNAMIC_TYPE_ECC);
+        if (key == NULL)
+            return MEMORY_E;
+        ret = wc_ecc_init_ex(key, pool->heap, INVALID_DEVID);
+        if (ret != 0) {
+            XFREE(key, pool->heap, DYNAMIC_TYPE_ECC);
+            return ret;
+        }
+        kse->key = key;
+        kse->keyLen = (word32)keySz;
+        kse->pubKeyLen = (word32)keySz * 2 + 1;
+
+        ret = wc_ecc_make_key_ex(&pool->rng, keySz, key, curveId);
+        if (ret == 0) {
+            kse->pubKey = (byte*)XMALLOC(kse->pubKeyLen, pool->heap,
+                                         DYNAMIC_TYPE_PUBLIC_KEY);
+            if (kse->pubKey == NULL)
+                ret = MEMORY_E;
+        }
+        if (ret == 0) {
+            PRIVATE_KEY_UNLOCK();
+            if (wc_ecc_export_x963(key, kse->pubKey, &kse->pubKeyLen) != 0)
+                ret = ECC_EXPORT_ERROR;
+            PRIVATE_KEY_LOCK();
+        }
+    }
+#endif
+
+    return ret;
+}
+
+#if defined(WOLFSSL_HAVE_MLKEM) && !defined(WOLFSSL_MLKEM_NO_MAKE_KEY) && \
+    !defined(WOLFSSL_MLKEM_NO_DECAPSULATE)
+/* Make both halves of a hybrid key share and join them into kse. */
+static int KeySharePool_MakeHybridKey(KeySharePool* pool, KeyShareEntry* kse)
+{
+    int ret = 0;
+    KeyShareEntry* ecc_kse;
+    KeyShareEntry* pqc_kse;
+    int ecc_group = 0;
+    int pqc_group = 0;
+    int pqc_first = 0;
+
+    findEccPqc(&ecc_group, &pqc_group, &pqc_first, kse->group);
+
+    ecc_kse = (KeyShareEntry*)XMALLOC(sizeof(*ecc_kse), pool->heap,
+                                      DYNAMIC_TYPE_TLSX);
+    pqc_kse = (KeyShareEntry*)XMALLOC(sizeof(*pqc_kse), pool->heap,
+                                      DYNAMIC_TYPE_TLSX);
+    if (ecc_kse == NULL || pqc_kse == NULL) {
+        XFREE(ecc_kse, pool->heap, DYNAMIC_TYPE_TLSX);
+        XFREE(pqc_kse, pool->heap, DYNAMIC_TYPE_TLSX);
+        return MEMORY_E;
+    }
+    XMEMSET(ecc_kse, 0, sizeof(*ecc_kse));
+    XMEMSET(pqc_kse, 0, sizeof(*pqc_kse));
+    ecc_kse->group = (word16)ecc_group;
+    pqc_kse->group = (word16)pqc_group;
+
+    ret = KeySharePool_MakeEcKey(pool, ecc_kse);
     if (ret == 0) {
-        if (pqc_first) {
-            XMEMCPY(kse->pubKey, pqc_kse->pubKey, pqc_kse->pubKeyLen);
-            XMEMCPY(kse->pubKey + pqc_kse->pubKeyLen, ecc_kse->pubKey,
-                    ecc_kse->pubKeyLen);
+        ret = TLSX_KeyShare_MakePqcKey(pool->heap, INVALID_DEVID, &pool->rng,
+                                       pqc_kse);
+    }
+    if (ret == 0) {
+        ret = TLSX_KeyShare_JoinHybrid(pool->heap, kse, ecc_kse, pqc_kse,
+                                       pqc_first);
+    }
+
+    TLSX_KeyShare_FreeAll(ecc_kse, pool->heap);
+    TLSX_KeyShare_FreeAll(pqc_kse, pool->heap);
+
+    return ret;
+}
+#endif
+
+/* Make a ready key share entry for group. */
+static int KeySharePool_Make(KeySharePool* pool, word16 group,
+    KeyShareEntry** out)
+{
+    int ret;
+    KeyShareEntry* kse;
+
+    kse = (KeyShareEntry*)XMALLOC(sizeof(KeyShareEntry), pool->heap,
+                                  DYNAMIC_TYPE_TLSX);
+    if (kse == NULL)
+        return MEMORY_E;
+    XMEMSET(kse, 0, sizeof(KeyShareEntry));
+    kse->group = group;
+
+#if defined(WOLFSSL_HAVE_MLKEM) && !defined(WOLFSSL_MLKEM_NO_MAKE_KEY) && \
+    !defined(WOLFSSL_MLKEM_NO_DECAPSULATE)
+    if (WOLFSSL_NAMED_GROUP_IS_PQC(group)) {
+        ret = TLSX_KeyShare_MakePqcKey(pool->heap, INVALID_DEVID, &pool->rng,
+                                       kse);
+    }
+    else if (WOLFSSL_NAMED_GROUP_IS_PQC_HYBRID(group)) {
+        ret = KeySharePool_MakeHybridKey(pool, kse);
+    }
+    else
+#endif
+    {
+        ret = KeySharePool_MakeEcKey(pool, kse);
+    }
+
+    if (ret != 0) {
+        TLSX_KeyShare_FreeAll(kse, pool->heap);
+        kse = NULL;
+    }
+    *out = kse;
+
+    return ret;
+}
+
+/* Whether the pool was made by another process, the parent of a fork().
+ * Its locks may have been held by a thread that doesn't exist here, so they
+ * must not be taken. */
+static int KeySharePool_Forked(const KeySharePool* pool)
+{
+#ifdef KEY_SHARE_POOL_PID
+    return pool->pid != getpid();
+#else
+    (void)pool;
+    return 0;
+#endif
+}
+
+/* Bring every group in the pool up to its depth.
+ *
+ * returns the number of key shares made or a negative error.
+ */
+int TLSX_KeySharePool_Refill(KeySharePool* pool)
+{
+    int ret = 0;
+    int made = 0;
+    int i;
+
+    if (pool == NULL)
+        return BAD_FUNC_ARG;
+    if (KeySharePool_Forked(pool)) {
+        WOLFSSL_MSG("Key share pool was made by the parent process");
+        return BAD_STATE_E;
+    }
+    if (wc_LockMutex(&pool->genLock) != 0)
+        return BAD_MUTEX_E;
+
+    for (i = 0; ret == 0 && i < pool->groupCnt; i++) {
+        for (;;) {
+            KeyShareEntry* kse = NULL;
+            int cnt;
+
+            if (wc_LockMutex(&pool->lock) != 0) {
+                ret = BAD_MUTEX_E;
+                break;
+            }
+            cnt = pool->count[i];
+            wc_UnLockMutex(&pool->lock);
+            if (cnt >= pool->depth)
+                break;
+
+            ret = KeySharePool_Make(pool, pool->groups[i], &kse);
+            if (ret != 0)
+                break;
+
+            if (wc_LockMutex(&pool->lock) != 0) {
+                TLSX_KeyShare_FreeAll(kse, pool->heap);
+                ret = BAD_MUTEX_E;
+                break;
+            }
+            kse->next = pool->ready[i];
+            pool->ready[i] = kse;
+            pool->count[i]++;
+            wc_UnLockMutex(&pool->lock);
+            made++;
         }
-        else {
-            XMEMCPY(kse->pubKey, ecc_kse->pubKey, ecc_kse->pubKeyLen);
-            XMEMCPY(kse->pubKey + ecc_kse->pubKeyLen, pqc_kse->pubKey,
-                    pqc_kse->pubKeyLen);
+    }
+
+    wc_UnLockMutex(&pool->genLock);
+
+    return (ret != 0) ? ret : made;
+}
+
+/* Number of ready key shares for group, or BAD_FUNC_ARG when the pool doesn't
+ * hold the group. */
+int TLSX_KeySharePool_Count(KeySharePool* pool, word16 group)
+{
+    int ret = BAD_FUNC_ARG;
+    int i;
+
+    if (pool == NULL)
+        return BAD_FUNC_ARG;
+
+    for (i = 0; i < pool->groupCnt; i++) {
+        if (pool->groups[i] == group) {
+            /* Dropped in a forked child. */
+            if (KeySharePool_Forked(pool))
+                return 0;
+            if (wc_LockMutex(&pool->lock) != 0)
+                return BAD_MUTEX_E;
+            ret = pool->count[i];
+            wc_UnLockMutex(&pool->lock);
+            break;
         }
-        kse->pubKeyLen = ecc_kse->pubKeyLen + pqc_kse->pubKeyLen;
     }
 
-    /* Store the private keys.
-     * Note we are saving the PQC private key and ECC private key
-     * separately. That's because the ECC private key is not simply a
-     * buffer. Its is an ecc_key struct. */
+    return ret;
+}
+
+#ifdef KEY_SHARE_POOL_THREAD
+static THREAD_RETURN WOLFSSL_THREAD key_share_pool_thread(void* arg)
+{
+    KeySharePool* pool = (KeySharePool*)arg;
+
+    /* The pool starts full, so wait to be woken before the first refill. */
+    pthread_mutex_lock(&pool->thrLock);
+    for (;;) {
+        while (!pool->stop && !pool->wake)
+            pthread_cond_wait(&pool->thrCond, &pool->thrLock);
+        if (pool->stop)
+            break;
+        pool->wake = 0;
+        pthread_mutex_unlock(&pool->thrLock);
+        (void)TLSX_KeySharePool_Refill(pool);
+        pthread_mutex_lock(&pool->thrLock);
+    }
+    pthread_mutex_unlock(&pool->thrLock);
+
+    WOLFSSL_RETURN_FROM_THREAD(0);
+}
+#endif
+
+/* Ask the background thread to top the pool up. */
+static void KeySharePool_Wake(KeySharePool* pool)
+{
+#ifdef KEY_SHARE_POOL_THREAD
+    if (pthread_mutex_lock(&pool->thrLock) == 0) {
+        pool->wake = 1;
+        pthread_cond_signal(&pool->thrCond);
+        pthread_mutex_unlock(&pool->thrLock);
+    }
+#else
+    (void)pool;
+#endif
+}
+
+/* Dispose of a pool, stopping its thread first.
+ *
+ * In a forked child the thread doesn't exist and the locks may be held, so
+ * only the memory is released.
+ */
+static void KeySharePool_Dispose(KeySharePool* pool)
+{
+    int forked = KeySharePool_Forked(pool);
+    int i;
+
+#ifdef KEY_SHARE_POOL_THREAD
+    if (!forked) {
+        pthread_mutex_lock(&pool->thrLock);
+        pool->stop = 1;
+        pthread_cond_signal(&pool->thrCond);
+        pthread_mutex_unlock(&pool->thrLock);
+        if (pool->running) {
+            (void)wolfSSL_JoinThread(pool->thread);
+            pool->running = 0;
+        }
+        pthread_cond_destroy(&pool->thrCond);
+        pthread_mutex_destroy(&pool->thrLock);
+    }
+#endif
+
+    for (i = 0; i < pool->groupCnt; i++)
+        TLSX_KeyShare_FreeAll(pool->ready[i], pool->heap);
+    wc_FreeRng(&pool->rng);
+    if (!forked) {
+        wc_FreeMutex(&pool->genLock);
+        wc_FreeMutex(&pool->lock);
+    }
+    XFREE(pool, pool->heap, DYNAMIC_TYPE_TLSX);
+}
+
+/* Replace the CTX's key share pool with one holding depth ready key shares
+ * for each of groups. The pool is filled before returning and then topped up
+ * by a background thread when POSIX threads are available.
+ *
+ * returns 0 on success, BAD_FUNC_ARG for an unsupported group or out of range
+ * count or depth.
+ */
+int TLSX_KeySharePool_New(WOLFSSL_CTX* ctx, const word16* groups, int count,
+    int depth)
+{
+    KeySharePool* pool;
+    int ret = 0;
+    int i;
+    int j;
+
+    if (ctx == NULL || groups == NULL || count <= 0 ||
+            count > WOLFSSL_KEY_SHARE_POOL_MAX_GROUPS || depth <= 0 ||
+            depth > WOLFSSL_KEY_SHARE_POOL_MAX_DEPTH) {
+        return BAD_FUNC_ARG;
+    }
+    for (i = 0; i < count; i++) {
+        if (!KeySharePool_GroupSupported(groups[i]))
+            return BAD_FUNC_ARG;
+        for (j = 0; j < i; j++) {
+            if (groups[j] == groups[i])
+                return BAD_FUNC_ARG;
+        }
+    }
+
+    pool = (KeySharePool*)XMALLOC(sizeof(KeySharePool), ctx->heap,
+                                  DYNAMIC_TYPE_TLSX);
+    if (pool == NULL)
+        return MEMORY_E;
+    XMEMSET(pool, 0, sizeof(KeySharePool));
+    pool->heap = ctx->heap;
+    pool->depth = depth;
+    pool->groupCnt = count;
+#ifdef KEY_SHARE_POOL_PID
+    pool->pid = getpid();
+#endif
+    XMEMCPY(pool->groups, groups, sizeof(word16) * (size_t)count);
+
+    if (wc_InitMutex(&pool->lock) != 0) {
+        XFREE(pool, ctx->heap, DYNAMIC_TYPE_TLSX);
+        return BAD_MUTEX_E;
+    }
+    if (wc_InitMutex(&pool->genLock) != 0) {
+        wc_FreeMutex(&pool->lock);
+        XFREE(pool, ctx->heap, DYNAMIC_TYPE_TLSX);
+        return BAD_MUTEX_E;
+    }
+#ifdef KEY_SHARE_POOL_THREAD
+    if (pthread_mutex_init(&pool->thrLock, NULL) != 0) {
+        wc_FreeMutex(&pool->genLock);
+        wc_FreeMutex(&pool->lock);
+        XFREE(pool, ctx->heap, DYNAMIC_TYPE_TLSX);
+        return BAD_MUTEX_E;
+    }
+    if (pthread_cond_init(&pool->thrCond, NULL) != 0) {
+        pthread_mutex_destroy(&pool->thrLock);
+        wc_FreeMutex(&pool->genLock);
+        wc_FreeMutex(&pool->lock);
+        XFREE(pool, ctx->heap, DYNAMIC_TYPE_TLSX);
+        return BAD_COND_E;
+    }
+#endif
+    ret = wc_InitRng_ex(&pool->rng, pool->heap, INVALID_DEVID);
     if (ret == 0) {
-    #ifndef WOLFSSL_TLSX_PQC_MLKEM_STORE_OBJ
-        /* PQC private key is an encoded byte array */
-        kse->privKey = pqc_kse->privKey;
-        kse->privKeyLen = pqc_kse->privKeyLen;
-        pqc_kse->privKey = NULL;
-    #else
-        /* PQC private key is a pointer to MlKemKey object */
-        kse->privKey = (byte*)pqc_kse->key;
-        kse->privKeyLen = 0;
-        pqc_kse->key = NULL;
+        ret = TLSX_KeySharePool_Refill(pool);
+        if (ret > 0)
+            ret = 0;
+    }
+#ifdef KEY_SHARE_POOL_THREAD
+    if (ret == 0) {
+        ret = wolfSSL_NewThread(&pool->thread, key_share_pool_thread, pool);
+        if (ret == 0)
+            pool->running = 1;
+    }
+#endif
+    if (ret != 0) {
+        KeySharePool_Dispose(pool);
+        return ret;
+    }
+
+    TLSX_KeySharePool_Free(ctx);
+    ctx->keySharePool = pool;
+
+    return 0;
+}
+
+/* Stop the CTX's key share pool thread and free the pool. */
+void TLSX_KeySharePool_Free(WOLFSSL_CTX* ctx)
+{
+    if (ctx == NULL || ctx->keySharePool == NULL)
+        return;
+
+    KeySharePool_Dispose(ctx->keySharePool);
+    ctx->keySharePool = NULL;
+}
+
+/* Take a pooled key pair for kse's group into kse.
+ *
+ * Only used when the connection would generate the key the same way the pool
+ * does: in software, from the CTX heap and without a static ephemeral key or
+ * PK callback.
+ *
+ * returns 1 when kse now holds a key pair and 0 otherwise.
+ */
+static int KeySharePool_Take(WOLFSSL* ssl, KeyShareEntry* kse)
+{
+    KeySharePool* pool = ssl->ctx->keySharePool;
+    KeyShareEntry* ready = NULL;
+    int low = 0;
+    int i;
+
+    if (kse->key != NULL || kse->pubKey != NULL ||
+            ssl->devId != INVALID_DEVID || ssl->heap != pool->heap) {
+        return 0;
+    }
+#if !defined(NO_DH) || defined(WOLFSSL_HAVE_MLKEM)
+    if (kse->privKey != NULL)
+        return 0;
+#endif
+#ifdef HAVE_PK_CALLBACKS
+    if (ssl->ctx->EccKeyGenCb != NULL)
+        return 0;
+#endif
+#ifdef WOLFSSL_STATIC_EPHEMERAL
+    #ifdef HAVE_ECC
+    if (ssl->staticKE.ecKey != NULL)
+        return 0;
     #endif
-        /* ECC private key is a pointer to ecc_key object */
-        kse->key = ecc_kse->key;
-        kse->keyLen = ecc_kse->keyLen;
-        ecc_kse->key = NULL;
+    #ifdef HAVE_CURVE25519
+    if (ssl->staticKE.x25519Key != NULL)
+        return 0;
+    #endif
+#endif
+
+    /* A forked child must not send the parent's key shares. */
+    if (KeySharePool_Forked(pool))
+        return 0;
+
+    for (i = 0; i < pool->groupCnt; i++) {
+        if (pool->groups[i] == kse->group)
+            break;
     }
+    if (i == pool->groupCnt)
+        return 0;
 
-#ifdef WOLFSSL_DEBUG_TLS
-    WOLFSSL_MSG("Public ML-KEM Key");
-    WOLFSSL_BUFFER(kse->pubKey, kse->pubKeyLen );
+    if (wc_LockMutex(&pool->lock) != 0)
+        return 0;
+    ready = pool->ready[i];
+    if (ready != NULL) {
+        pool->ready[i] = ready->next;
+        pool->count[i]--;
+    }
+    low = (pool->count[i] <= pool->depth / 2);
+    wc_UnLockMutex(&pool->lock);
+
+    if (low)
+        KeySharePool_Wake(pool);
+    if (ready == NULL)
+        return 0;
+
+    kse->key = ready->key;
+    kse->keyLen = ready->keyLen;
+    kse->pubKey = ready->pubKey;
+    kse->pubKeyLen = ready->pubKeyLen;
+    ready->key = NULL;
+    ready->pubKey = NULL;
+#if !defined(NO_DH) || defined(WOLFSSL_HAVE_MLKEM)
+    kse->privKey = ready->privKey;
+    kse->privKeyLen = ready->privKeyLen;
+    ready->privKey = NULL;
 #endif
+    ready->next = NULL;
+    TLSX_KeyShare_FreeAll(ready, pool->heap);
 
-    TLSX_KeyShare_FreeAll(ecc_kse, ssl->heap);
-    TLSX_KeyShare_FreeAll(pqc_kse, ssl->heap);
+#ifdef HAVE_ECC
+    {
+        int ecc_group = kse->group;
 
-    return ret;
+    #ifdef WOLFSSL_HAVE_MLKEM
+        if (WOLFSSL_NAMED_GROUP_IS_PQC_HYBRID(kse->group))
+            findEccPqc(&ecc_group, NULL, NULL, kse->group);
+    #endif
+        if (!WOLFSSL_NAMED_GROUP_IS_PQC(kse->group) &&
+                ecc_group != WOLFSSL_ECC_X25519) {
+            /* As EccMakeKey() does for a generated key. */
+            ssl->ecdhCurveOID = ((ecc_key*)kse->key)->dp->oidSum;
+        #if defined(WOLFSSL_TLS13) || defined(HAVE_FFDHE)
+            ssl->namedGroup = 0;
+        #endif
+        }
+    }
+#endif
+
+    return 1;
 }
-#endif /* !WOLFSSL_MLKEM_NO_MAKE_KEY && !WOLFSSL_MLKEM_NO_DECAPSULATE */
-#endif /* WOLFSSL_HAVE_MLKEM */
+#endif /* WOLFSSL_KEY_SHARE_POOL */
 
 /* Generate a secret/key using the key share entry.
  *
@@ -9259,6 +9923,15 @@ static int TLSX_KeyShare_GenPqcHybridKeyClient(WOLFSSL *ssl, KeyShareEntry* kse)
 int TLSX_KeyShare_GenKey(WOLFSSL *ssl, KeyShareEntry *kse)
 {
     int ret;
+#ifdef WOLFSSL_KEY_SHARE_POOL
+    if (ssl->ctx != NULL && ssl->ctx->keySharePool != NULL &&
+            KeySharePool_Take(ssl, kse)) {
+    #ifdef WOLFSSL_ASYNC_CRYPT
+        kse->lastRet = 0;
+    #endif
+        return 0;
+    }
+#endif
     /* Named FFDHE groups have a bit set to identify them. */
     if (WOLFSSL_NAMED_GROUP_IS_FFDHE(kse->group))
         ret = TLSX_KeyShare_GenDhKey(ssl, kse);
@@ -431,6 +431,12 @@ int Tls13DeriveKey(WOLFSSL* ssl, byte* output, int outputLen,
     int         digestAlg = 0;
 
 
+    if (includeMsgs) {
+        ret = StartHandshakeHashes(ssl, HandshakeHashForMac((byte)hashAlgo));
+        if (ret != 0)
+            return ret;
+    }
+
     switch (hashAlgo) {
     #ifndef NO_SHA256
         case sha256_mac:
@@ -1427,6 +1433,11 @@ static int BuildTls13HandshakeHmac(WOLFSSL* ssl, byte* key, byte* hash,
         return BAD_FUNC_ARG;
     }
 
+    ret = StartHandshakeHashes(ssl,
+        HandshakeHashForMac(ssl->specs.mac_algorithm));
+    if (ret != 0)
+        return ret;
+
     /* Get the hash of the previous handshake messages. */
     switch (ssl->specs.mac_algorithm) {
     #ifndef NO_SHA256
@@ -3402,6 +3413,15 @@ int BuildTls13Message(WOLFSSL* ssl, byte* output, int outSz, const byte* input,
                 ret = (int)args->headerSz + inSz;
                 goto exit_buildmsg;
             }
+#endif
+#ifdef WOLFSSL_KTLS
+            if (WOLFSSL_IS_KTLS(ssl, 1)) {
+                /* Kernel encrypts the record, only the content and the
+                 * real content type are passed on. */
+                AddTls13RecordHeader(output, (word32)inSz, (byte)type, ssl);
+                ret = (int)args->headerSz + inSz;
+                goto exit_buildmsg;
+            }
 #endif
         #ifdef ATOMIC_USER
             if (ssl->ctx->MacEncryptCb) {
@@ -6024,6 +6044,8 @@ int DoTls13ServerHello(WOLFSSL* ssl, const byte* input, word32* inOutIdx,
         ssl->keys.encryptionOn = 1;
         ssl->options.serverState = SERVER_HELLO_COMPLETE;
 
+        /* Cipher suite now known - only its hash is needed. */
+        ret = SelectHandshakeHashes(ssl);
     }
     else {
         /* https://datatracker.ietf.org/doc/html/rfc8446#section-4.1.4
@@ -8417,9 +8439,14 @@ int SendTls13ServerHello(WOLFSSL* ssl, byte extMsgType)
     }
     #endif
 
-    if (extMsgType == server_hello)
+    if (extMsgType == server_hello) {
         ssl->options.serverState = SERVER_HELLO_COMPLETE;
 
+        ret = SelectHandshakeHashes(ssl);
+        if (ret != 0)
+            return ret;
+    }
+
     ssl->options.buildingMsg = 0;
 #ifdef WOLFSSL_DTLS13
     if (ssl->options.dtls) {
@@ -9243,7 +9270,13 @@ static WC_INLINE int DecodeTls13HybridSigAlg(byte* input, byte* hashAlg,
  */
 static WC_INLINE int GetMsgHash(WOLFSSL* ssl, byte* hash)
 {
-    int ret = 0;
+    int ret;
+
+    ret = StartHandshakeHashes(ssl,
+        HandshakeHashForMac(ssl->specs.mac_algorithm));
+    if (ret != 0)
+        return ret;
+
     switch (ssl->specs.mac_algorithm) {
     #ifndef NO_SHA256
         case sha256_mac:
@@ -13123,6 +13156,27 @@ static int SendTls13Finished(WOLFSSL* ssl)
 }
 #endif /* !NO_WOLFSSL_CLIENT || !NO_WOLFSSL_SERVER */
 
+/* Change to the next encryption keys after sending a KeyUpdate.
+ *
+ * ssl  The SSL/TLS object.
+ * returns 0 on success, otherwise failure.
+ */
+int Tls13KeyUpdateSendKeys(WOLFSSL* ssl)
+{
+    int ret;
+
+    /* Future traffic uses new encryption keys. */
+    ret = DeriveTls13Keys(ssl, update_traffic_key, ENCRYPT_SIDE_ONLY, 1);
+    if (ret == 0)
+        ret = SetKeysSide(ssl, ENCRYPT_SIDE_ONLY);
+    if (ret == 0) {
+        /* Count this key update against the RFC 9846 sender limit. */
+        w64Increment(&ssl->keys.keyUpdateCount);
+    }
+
+    return ret;
+}
+
 /* handle generation TLS v1.3 key_update (24) */
 /* Send the TLS v1.3 KeyUpdate message.
  *
@@ -13141,6 +13195,15 @@ int SendTls13KeyUpdate(WOLFSSL* ssl)
     WOLFSSL_START(WC_FUNC_KEY_UPDATE_SEND);
     WOLFSSL_ENTER("SendTls13KeyUpdate");
 
+#ifdef WOLFSSL_KTLS
+    if (ssl->ktls.txKeyUpdate) {
+        /* Last KeyUpdate is still being sent and will answer any request.
+         * Keys change once it has all gone - see wolfSSL_ktls_send(). */
+        ssl->keys.keyUpdateRespond = 0;
+        return SendBuffered(ssl);
+    }
+#endif /* WOLFSSL_KTLS */
+
 #ifdef WOLFSSL_DTLS13
     if (ssl->options.dtls) {
         /* RFC 9147 Section 4.2.1: do not send a KeyUpdate that would advance
@@ -13226,21 +13289,20 @@ int SendTls13KeyUpdate(WOLFSSL* ssl)
 
         if (ret != 0 && ret != WC_NO_ERR_TRACE(WANT_WRITE))
             return ret;
+    #ifdef WOLFSSL_KTLS
+        if (ret == WC_NO_ERR_TRACE(WANT_WRITE) && WOLFSSL_IS_KTLS(ssl, 1)) {
+            /* Kernel encrypts the KeyUpdate as it is sent so the keys can't
+             * change until it has all gone. */
+            ssl->ktls.txKeyUpdate = 1;
+            return ret;
+        }
+    #endif /* WOLFSSL_KTLS */
     }
 
     /* In DTLS we must wait for the ack before setting up the new keys */
     if (!ssl->options.dtls) {
-
-        /* Future traffic uses new encryption keys. */
-        if ((ret = DeriveTls13Keys(
-                       ssl, update_traffic_key, ENCRYPT_SIDE_ONLY, 1))
-            != 0)
+        if ((ret = Tls13KeyUpdateSendKeys(ssl)) != 0)
             return ret;
-        if ((ret = SetKeysSide(ssl, ENCRYPT_SIDE_ONLY)) != 0)
-            return ret;
-
-        /* Count this key update against the RFC 9846 sender limit. */
-        w64Increment(&ssl->keys.keyUpdateCount);
     }
 
 
@@ -13661,6 +13723,11 @@ static int ExpectedResumptionSecret(WOLFSSL* ssl)
 
     XMEMSET(&digest, 0, sizeof(Digest));
 
+    ret = StartHandshakeHashes(ssl,
+        HandshakeHashForMac(ssl->specs.mac_algorithm));
+    if (ret != 0)
+        return ret;
+
     /* Copy the running hash so we can restore it after. */
     switch (ssl->specs.mac_algorithm) {
     #ifndef NO_SHA256
@@ -15800,6 +15867,71 @@ int wolfSSL_NoKeyShares(WOLFSSL* ssl)
 #endif /* NO_TLS */
     return WOLFSSL_SUCCESS;
 }
+
+#ifdef WOLFSSL_KEY_SHARE_POOL
+/* Keep depth pre-generated key shares ready for each of groups. Handshakes on
+ * WOLFSSL objects made from ctx take a key pair from the pool instead of
+ * generating one. With POSIX threads a background thread tops the pool up,
+ * otherwise call wolfSSL_CTX_KeySharePoolRefill() when idle.
+ *
+ * Replaces any existing pool. Passing no groups removes the pool. Must not be
+ * called while connections made from ctx are handshaking.
+ *
+ * A process forked after this call doesn't use the pool, its key shares are
+ * generated per handshake. Call again in the child to give it its own pool.
+ *
+ * ctx     The SSL/TLS CTX object.
+ * groups  The named groups to pool key shares for.
+ * count   The number of groups.
+ * depth   The number of key shares to keep ready per group.
+ * returns WOLFSSL_SUCCESS on success, otherwise failure.
+ */
+int wolfSSL_CTX_UseKeySharePool(WOLFSSL_CTX* ctx, const word16* groups,
+                                int count, int depth)
+{
+    int ret;
+
+    if (ctx == NULL || count < 0)
+        return BAD_FUNC_ARG;
+
+    if (groups == NULL || count == 0) {
+        TLSX_KeySharePool_Free(ctx);
+        return WOLFSSL_SUCCESS;
+    }
+
+    ret = TLSX_KeySharePool_New(ctx, groups, count, depth);
+    if (ret != 0)
+        return ret;
+    return WOLFSSL_SUCCESS;
+}
+
+/* Bring the key share pool of ctx up to depth in the calling thread.
+ *
+ * ctx  The SSL/TLS CTX object.
+ * returns the number of key shares generated, otherwise failure.
+ */
+int wolfSSL_CTX_KeySharePoolRefill(WOLFSSL_CTX* ctx)
+{
+    if (ctx == NULL || ctx->keySharePool == NULL)
+        return BAD_FUNC_ARG;
+
+    return TLSX_KeySharePool_Refill(ctx->keySharePool);
+}
+
+/* Number of ready key shares for group in the key share pool of ctx.
+ *
+ * ctx    The SSL/TLS CTX object.
+ * group  The named group.
+ * returns the number of ready key shares, otherwise failure.
+ */
+int wolfSSL_CTX_KeySharePoolCount(WOLFSSL_CTX* ctx, word16 group)
+{
+    if (ctx == NULL || ctx->keySharePool == NULL)
+        return BAD_FUNC_ARG;
+
+    return TLSX_KeySharePool_Count(ctx->keySharePool, group);
+}
+#endif /* WOLFSSL_KEY_SHARE_POOL */
 #endif
 
 #ifdef WOLFSSL_DUAL_ALG_CERTS
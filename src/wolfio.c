@@ -42,6 +42,13 @@
 #include <wolfssl/wolfio.h>
 #include <wolfssl/wolfcrypt/logging.h>
 
+#ifdef WOLFSSL_KTLS
+    #include <linux/tls.h>
+    #ifndef SOL_TLS
+        #define SOL_TLS 282
+    #endif
+#endif
+
 
 #ifdef NUCLEUS_PLUS_2_3
 /* Holds last Nucleus networking error number */
@@ -1278,6 +1285,113 @@ int wolfIO_Send(SOCKET_T sd, char *buf, int sz, int wrFlags)
     return sent;
 }
 
+#ifdef WOLFSSL_KTLS
+
+/* Send the content of one record on a kernel TLS socket.
+ *
+ * The kernel builds and encrypts the record. The content type is passed in a
+ * TLS_SET_RECORD_TYPE control message.
+ *
+ * @param [in] sd       Socket with kernel TLS transmit keys installed.
+ * @param [in] type     Record content type.
+ * @param [in] buf      Record content.
+ * @param [in] sz       Length of record content in bytes.
+ * @param [in] wrFlags  Flags to pass to sendmsg().
+ * @return  Number of bytes sent on success.
+ * @return  WOLFSSL_CBIO_ERR_* value on failure.
+ */
+int wolfIO_SendRecord(SOCKET_T sd, byte type, const byte* buf, int sz,
+    int wrFlags)
+{
+    int sent;
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr* cmsg;
+    union {
+        struct cmsghdr align;
+        byte buf[CMSG_SPACE(sizeof(byte))];
+    } ctrl;
+
+    if (sz < 0)
+        return WOLFSSL_CBIO_ERR_GENERAL;
+
+    XMEMSET(&msg, 0, sizeof(msg));
+    XMEMSET(&ctrl, 0, sizeof(ctrl));
+    iov.iov_base = (void*)buf;
+    iov.iov_len = (size_t)sz;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl.buf;
+    msg.msg_controllen = sizeof(ctrl.buf);
+
+    cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_TLS;
+    cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(byte));
+    *CMSG_DATA(cmsg) = type;
+
+    sent = (int)sendmsg(sd, &msg, wrFlags);
+    sent = TranslateIoReturnCode(sent, sd, SOCKET_SENDING);
+
+    return sent;
+}
+
+/* Receive decrypted record content from a kernel TLS socket.
+ *
+ * Each call only returns the content of records of one type. The content type
+ * is taken from the TLS_GET_RECORD_TYPE control message and is
+ * application_data when the kernel does not supply one.
+ *
+ * @param [in]  sd       Socket with kernel TLS receive keys installed.
+ * @param [out] type     Record content type.
+ * @param [out] buf      Buffer to hold record content.
+ * @param [in]  sz       Size of buffer in bytes.
+ * @param [in]  rdFlags  Flags to pass to recvmsg().
+ * @return  Number of bytes received on success.
+ * @return  WOLFSSL_CBIO_ERR_* value on failure.
+ */
+int wolfIO_RecvRecord(SOCKET_T sd, byte* type, byte* buf, int sz,
+    int rdFlags)
+{
+    int recvd;
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr* cmsg;
+    union {
+        struct cmsghdr align;
+        byte buf[CMSG_SPACE(sizeof(byte))];
+    } ctrl;
+
+    if (sz < 0)
+        return WOLFSSL_CBIO_ERR_GENERAL;
+
+    XMEMSET(&msg, 0, sizeof(msg));
+    iov.iov_base = buf;
+    iov.iov_len = (size_t)sz;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl.buf;
+    msg.msg_controllen = sizeof(ctrl.buf);
+
+    recvd = (int)recvmsg(sd, &msg, rdFlags);
+    recvd = TranslateIoReturnCode(recvd, sd, SOCKET_RECEIVING);
+    if (recvd < 0)
+        return recvd;
+
+    *type = application_data;
+    for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+            cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_TLS &&
+                cmsg->cmsg_type == TLS_GET_RECORD_TYPE) {
+            *type = *CMSG_DATA(cmsg);
+        }
+    }
+
+    return recvd;
+}
+
+#endif /* WOLFSSL_KTLS */
+
 #if defined(WOLFSSL_HAVE_BIO_ADDR) && defined(WOLFSSL_DTLS) && defined(OPENSSL_EXTRA)
 
 int wolfIO_RecvFrom(SOCKET_T sd, WOLFSSL_BIO_ADDR *addr, char *buf, int sz, int rdFlags)
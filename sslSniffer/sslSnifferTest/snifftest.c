@@ -81,6 +81,12 @@ int main(void)
 
 #include <wolfssl/sniffer.h>
 
+/* -bench replays a capture through the multi-threaded decode pipeline */
+#if defined(WOLFSSL_SNIFFER_PIPELINE) && !defined(THREADED_SNIFFTEST) && \
+    !defined(_WIN32)
+    #define SNIFFTEST_BENCH
+    #include <time.h>          /* clock_gettime */
+#endif
 
 #ifndef _WIN32
     #include <sys/socket.h>    /* AF_INET */
@@ -273,7 +279,8 @@ static const char* ip6tos(const struct in6_addr* addr)
 }
 
 
-#if defined(WOLFSSL_SNIFFER_STORE_DATA_CB) || defined(WOLFSSL_SNIFFER_CHAIN_INPUT)
+#if defined(WOLFSSL_SNIFFER_STORE_DATA_CB) || \
+    defined(WOLFSSL_SNIFFER_CHAIN_INPUT) || defined(SNIFFTEST_BENCH)
 static inline unsigned int min(unsigned int a, unsigned int b)
 {
     return a > b ? b : a;
@@ -839,6 +846,149 @@ static int DecodePacket(byte* packet, int length, int packetNumber, char err[])
     return hadBadPacket;
 }
 
+#ifdef SNIFFTEST_BENCH
+
+#ifndef BENCH_BATCH_SZ
+    #define BENCH_BATCH_SZ 256
+#endif
+
+typedef struct BenchKeyInfo {
+    const char* server;
+    int         port;
+    const char* keyFiles;
+    const char* passwd;
+} BenchKeyInfo;
+
+/* load the server keys into each pipeline shard's tables */
+static int BenchShardInit(int shard, void* ctx, char* error)
+{
+    BenchKeyInfo* info = (BenchKeyInfo*)ctx;
+    char          keyFiles[MAX_FILENAME_SZ];
+
+    (void)shard;
+
+    /* load_key() tokenizes the list in place */
+    XSTRNCPY(keyFiles, info->keyFiles, sizeof(keyFiles) - 1);
+    keyFiles[sizeof(keyFiles) - 1] = '\0';
+
+    return load_key(NULL, info->server, info->port, keyFiles, info->passwd,
+                    error);
+}
+
+static double BenchNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000.0;
+}
+
+/* Replay the whole capture from memory through the decode pipeline once for
+ * each shard count in the comma separated list, report packets per second */
+static int RunPipelineBench(pcap_t* p, int frame, char* shardList,
+    BenchKeyInfo* keyInfo, char err[])
+{
+    struct pcap_pkthdr* header;
+    const unsigned char* packet;
+    SSLSnifferPacket*   pkts = NULL;
+    SSLSnifferPipeline* pipeline;
+    int                 pktCnt = 0;
+    int                 pktMax = 0;
+    int                 hadBadPacket = 0;
+    int                 i, j, n, shards, errors;
+    double              start, elapsed;
+    char*               shardStr;
+    char*               ptr = NULL;
+
+    /* load the capture so the timed runs do not include file reads */
+    while (pcap_next_ex(p, &header, &packet) >= 0) {
+        byte* copy;
+        int   len;
+
+        if (packet == NULL || header->caplen <= 40) /* min ip + min tcp */
+            continue;
+        packet += frame;
+        len = (int)header->caplen - frame;
+        if (pcap_datalink(p) == DLT_LINUX_SLL) {
+            packet += 2;
+            len -= 2;
+        }
+
+        if (pktCnt == pktMax) {
+            SSLSnifferPacket* tmp;
+
+            pktMax = (pktMax == 0) ? 1024 : pktMax * 2;
+            tmp = (SSLSnifferPacket*)XREALLOC(pkts,
+                    sizeof(SSLSnifferPacket) * pktMax, NULL,
+                    DYNAMIC_TYPE_TMP_BUFFER);
+            if (tmp == NULL) {
+                hadBadPacket = 1;
+                break;
+            }
+            pkts = tmp;
+        }
+        copy = (byte*)XMALLOC(len, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        if (copy == NULL) {
+            hadBadPacket = 1;
+            break;
+        }
+        XMEMCPY(copy, packet, len);
+        XMEMSET(&pkts[pktCnt], 0, sizeof(SSLSnifferPacket));
+        pkts[pktCnt].packet = copy;
+        pkts[pktCnt].length = len;
+        pktCnt++;
+    }
+    printf("Loaded %d packets, batch size %d\n", pktCnt, BENCH_BATCH_SZ);
+
+    shardStr = XSTRTOK(shardList, ",", &ptr);
+    while (hadBadPacket == 0 && shardStr != NULL) {
+        shards = XATOI(shardStr);
+        shardStr = XSTRTOK(NULL, ",", &ptr);
+        if (shards <= 0)
+            continue;
+
+        if (ssl_NewSnifferPipeline(&pipeline, shards, BenchShardInit,
+                                   keyInfo, err) != 0) {
+            printf("ssl_NewSnifferPipeline failed: %s\n", err);
+            hadBadPacket = 1;
+            break;
+        }
+
+        errors = 0;
+        start = BenchNow();
+        for (i = 0; i < pktCnt; i += n) {
+            n = (int)min(BENCH_BATCH_SZ, (unsigned int)(pktCnt - i));
+            if (ssl_DecodePacketBatch(pipeline, &pkts[i], n, err) != 0) {
+                printf("ssl_DecodePacketBatch failed: %s\n", err);
+                hadBadPacket = 1;
+                break;
+            }
+            for (j = i; j < i + n; j++) {
+                if (pkts[j].ret < 0)
+                    errors++;
+                if (pkts[j].data != NULL)
+                    ssl_FreeZeroDecodeBuffer(&pkts[j].data, pkts[j].ret, err);
+            }
+        }
+        elapsed = BenchNow() - start;
+
+        /* shard threads free their sessions on exit */
+        ssl_FreeSnifferPipeline(pipeline);
+
+        printf("%3d shard(s): %d packets in %.3f sec, %.0f packets/sec, "
+               "%d errors\n", shards, pktCnt, elapsed,
+               elapsed > 0 ? pktCnt / elapsed : 0.0, errors);
+    }
+
+    for (i = 0; i < pktCnt; i++)
+        XFREE((byte*)pkts[i].packet, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(pkts, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+    return hadBadPacket;
+}
+
+#endif /* SNIFFTEST_BENCH */
+
 #ifdef THREADED_SNIFFTEST
 static void* snifferWorker(void* arg)
 {
@@ -974,6 +1124,10 @@ int main(int argc, char** argv)
 #ifdef THREADED_SNIFFTEST
     int workerThreadCount;
 #endif
+#ifdef SNIFFTEST_BENCH
+    char        *benchShards = NULL;
+    char         benchKeys[MAX_FILENAME_SZ];
+#endif
 
 #ifdef DEBUG_WOLFSSL
     wolfSSL_Debugging_ON();
@@ -1015,6 +1169,11 @@ int main(int argc, char** argv)
             workerThreadCount = XATOI(argv[++i]);
         }
 #endif /* THREADED_SNIFFTEST */
+#ifdef SNIFFTEST_BENCH
+        else if (strcmp(argv[i], "-bench") == 0 && i + 1 < argc) {
+            benchShards = argv[++i];
+        }
+#endif /* SNIFFTEST_BENCH */
         else {
             fprintf(stderr, "Error parsing: %s\n", argv[i]);
             fprintf(stderr, "Usage: %s -pcap pcap_arg -key key_arg"
@@ -1028,11 +1187,26 @@ int main(int argc, char** argv)
 #if defined(THREADED_SNIFFTEST)
                     " [-threads threads_arg]"
 #endif /* THREADED_SNIFFTEST */
+#ifdef SNIFFTEST_BENCH
+                    " [-bench shards_arg]"
+#endif /* SNIFFTEST_BENCH */
                     "\n", argv[0]);
             exit(EXIT_FAILURE);
         }
     }
 
+#ifdef SNIFFTEST_BENCH
+    if (benchShards != NULL) {
+        if (pcapFile == NULL || keyFilesSrc == NULL) {
+            fprintf(stderr, "Error: -bench needs -pcap and -key\n");
+            exit(EXIT_FAILURE);
+        }
+        /* keep the key list, loading the key below tokenizes it */
+        XSTRNCPY(benchKeys, keyFilesSrc, sizeof(benchKeys) - 1);
+        benchKeys[sizeof(benchKeys) - 1] = '\0';
+    }
+#endif
+
 #ifndef THREADED_SNIFFTEST
     #ifndef _WIN32
     ssl_InitSniffer();   /* dll load on Windows */
@@ -1263,6 +1437,21 @@ int main(int argc, char** argv)
     if (pcap_datalink(pcap) == DLT_NULL)
         frame = NULL_IF_FRAME_LEN;
 
+#ifdef SNIFFTEST_BENCH
+    if (benchShards != NULL) {
+        BenchKeyInfo keyInfo;
+
+        keyInfo.server   = server;
+        keyInfo.port     = port;
+        keyInfo.keyFiles = benchKeys;
+        keyInfo.passwd   = passwd;
+        hadBadPacket = RunPipelineBench(pcap, frame, benchShards, &keyInfo,
+                                        err);
+        FreeAll();
+        return hadBadPacket ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+#endif
+
 #ifdef THREADED_SNIFFTEST
     SnifferWorker workers[workerThreadCount];
     int           used[workerThreadCount];
@@ -168,9 +168,11 @@
     #include "wolfssl/internal.h"
 #endif
 
-#if defined(WOLFSSL_SNIFFER) && defined(WOLFSSL_SNIFFER_CHAIN_INPUT)
+#ifdef WOLFSSL_SNIFFER
     #include <wolfssl/sniffer.h>
     #include <wolfssl/sniffer_error.h>
+#endif
+#if defined(WOLFSSL_SNIFFER) && defined(WOLFSSL_SNIFFER_CHAIN_INPUT)
     #include <sys/uio.h>
 #endif
 
@@ -308,6 +310,7 @@
 #include <tests/api/test_evp_pkey.h>
 #include <tests/api/test_certman.h>
 #include <tests/api/test_tls13.h>
+#include <tests/api/test_ktls.h>
 #if !defined(NO_CERTS) && defined(WOLFSSL_ASN_TEMPLATE) && defined(HAVE_ECC)
 #include <tests/api/test_x500_unique_id_certs.h>
 #endif
@@ -22663,6 +22666,91 @@ static int test_wolfSSL_CTX_ctrl(void)
     return EXPECT_RESULT();
 }
 
+/* Modes are bits, every bit of an OR'd mask is applied. */
+static int test_wolfSSL_set_mode(void)
+{
+    EXPECT_DECLS;
+#if defined(OPENSSL_ALL) && !defined(NO_TLS) && !defined(NO_WOLFSSL_CLIENT)
+    SSL_CTX* ctx = NULL;
+    SSL* ssl = NULL;
+
+    ExpectNotNull(ctx = SSL_CTX_new(wolfSSLv23_client_method()));
+    /* Start from no modes, AUTO_RETRY may be on by default. */
+    ExpectIntEQ(SSL_CTX_clear_mode(ctx, SSL_MODE_ENABLE_PARTIAL_WRITE |
+        SSL_MODE_AUTO_RETRY | SSL_MODE_RELEASE_BUFFERS), 0);
+    if (ctx != NULL) {
+        ExpectIntEQ(ctx->partialWrite, 0);
+        ExpectIntEQ(ctx->autoRetry, 0);
+        ExpectIntEQ(ctx->releaseBuffers, 0);
+    }
+
+    ExpectIntEQ(SSL_CTX_set_mode(ctx, SSL_MODE_ENABLE_PARTIAL_WRITE),
+        SSL_MODE_ENABLE_PARTIAL_WRITE);
+    if (ctx != NULL) {
+        ExpectIntEQ(ctx->partialWrite, 1);
+        ExpectIntEQ(ctx->autoRetry, 0);
+        ExpectIntEQ(ctx->releaseBuffers, 0);
+    }
+    ExpectIntEQ(SSL_CTX_set_mode(ctx, SSL_MODE_RELEASE_BUFFERS |
+        SSL_MODE_AUTO_RETRY), SSL_MODE_RELEASE_BUFFERS | SSL_MODE_AUTO_RETRY);
+    if (ctx != NULL) {
+        ExpectIntEQ(ctx->autoRetry, 1);
+        ExpectIntEQ(ctx->releaseBuffers, 1);
+    }
+    ExpectIntEQ(SSL_CTX_clear_mode(ctx, SSL_MODE_ENABLE_PARTIAL_WRITE |
+        SSL_MODE_RELEASE_BUFFERS), 0);
+    if (ctx != NULL) {
+        ExpectIntEQ(ctx->partialWrite, 0);
+        ExpectIntEQ(ctx->autoRetry, 1);
+        ExpectIntEQ(ctx->releaseBuffers, 0);
+    }
+
+    /* Values of AUTO_RETRY (3) and RELEASE_BUFFERS (-1) from older headers
+     * only change their own mode. */
+    ExpectIntEQ(SSL_CTX_clear_mode(ctx, 3), 0);
+    ExpectIntEQ(SSL_CTX_set_mode(ctx, 3), 3);
+    if (ctx != NULL) {
+        ExpectIntEQ(ctx->partialWrite, 0);
+        ExpectIntEQ(ctx->autoRetry, 1);
+        ExpectIntEQ(ctx->releaseBuffers, 0);
+    }
+    ExpectIntEQ(SSL_CTX_set_mode(ctx, -1), -1);
+    if (ctx != NULL) {
+        ExpectIntEQ(ctx->partialWrite, 0);
+        ExpectIntEQ(ctx->releaseBuffers, 1);
+    }
+    ExpectIntEQ(SSL_CTX_clear_mode(ctx, -1), 0);
+    if (ctx != NULL) {
+        ExpectIntEQ(ctx->partialWrite, 0);
+        ExpectIntEQ(ctx->autoRetry, 1);
+        ExpectIntEQ(ctx->releaseBuffers, 0);
+    }
+
+    ExpectNotNull(ssl = SSL_new(ctx));
+    if (ssl != NULL) {
+        ExpectIntEQ(ssl->options.partialWrite, 0);
+        ExpectIntEQ(ssl->options.releaseBuffers, 0);
+    }
+    ExpectIntEQ(SSL_set_mode(ssl, -1), SSL_MODE_RELEASE_BUFFERS);
+    if (ssl != NULL) {
+        ExpectIntEQ(ssl->options.partialWrite, 0);
+        ExpectIntEQ(ssl->options.releaseBuffers, 1);
+    }
+    ExpectIntEQ(SSL_set_mode(ssl, SSL_MODE_ENABLE_PARTIAL_WRITE |
+        SSL_MODE_RELEASE_BUFFERS | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER),
+        SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_RELEASE_BUFFERS |
+        SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+    if (ssl != NULL) {
+        ExpectIntEQ(ssl->options.partialWrite, 1);
+        ExpectIntEQ(ssl->options.releaseBuffers, 1);
+    }
+
+    SSL_free(ssl);
+    SSL_CTX_free(ctx);
+#endif
+    return EXPECT_RESULT();
+}
+
 #if !defined(NO_BIO)
 static word32 TXT_DB_hash(const WOLFSSL_STRING *s)
 {
@@ -37743,6 +37831,257 @@ static int test_sniffer_chain_input_overflow(void)
 }
 #endif /* WOLFSSL_SNIFFER && WOLFSSL_SNIFFER_CHAIN_INPUT */
 
+#if defined(WOLFSSL_SNIFFER) && defined(WOLFSSL_SNIFFER_PIPELINE)
+static int test_sniffer_pipeline_init_cb(int shard, void* ctx, char* error)
+{
+    int* seen = (int*)ctx;
+
+    (void)error;
+    if (shard >= 0 && shard < 4)
+        seen[shard] = 1;
+    return 0;
+}
+
+static int test_sniffer_pipeline_fail_cb(int shard, void* ctx, char* error)
+{
+    (void)shard;
+    (void)ctx;
+    XSTRNCPY(error, "shard init failed", WOLFSSL_MAX_ERROR_SZ - 1);
+    return -1;
+}
+
+static int test_sniffer_pipeline(void)
+{
+    EXPECT_DECLS;
+    SSLSnifferPipeline* pipeline = NULL;
+    SSLSnifferPacket pkts[4];
+    char error[WOLFSSL_MAX_ERROR_SZ];
+    char pktError[2][WOLFSSL_MAX_ERROR_SZ];
+    int seen[4] = { 0, 0, 0, 0 };
+    /* IPv4/TCP 127.0.0.1:12345 -> 127.0.0.1:443, no payload, no server */
+    static const byte tcpPkt[40] = {
+        0x45, 0x00, 0x00, 0x28, 0x00, 0x01, 0x40, 0x00,
+        0x40, 0x06, 0x00, 0x00, 0x7f, 0x00, 0x00, 0x01,
+        0x7f, 0x00, 0x00, 0x01,
+        0x30, 0x39, 0x01, 0xbb, 0x00, 0x00, 0x00, 0x01,
+        0x00, 0x00, 0x00, 0x00, 0x50, 0x02, 0xff, 0xff,
+        0x00, 0x00, 0x00, 0x00
+    };
+    static const byte shortPkt[4] = { 0x45, 0x00, 0x00, 0x04 };
+
+    ssl_InitSniffer();
+
+    ExpectIntEQ(ssl_NewSnifferPipeline(NULL, 2, NULL, NULL, error),
+        WOLFSSL_SNIFFER_ERROR);
+    ExpectIntEQ(ssl_NewSnifferPipeline(&pipeline, 0, NULL, NULL, error),
+        WOLFSSL_SNIFFER_ERROR);
+    ExpectNull(pipeline);
+
+    /* failed shard init is reported with the callback's error */
+    XMEMSET(error, 0, sizeof(error));
+    ExpectIntEQ(ssl_NewSnifferPipeline(&pipeline, 2,
+        test_sniffer_pipeline_fail_cb, NULL, error), WOLFSSL_SNIFFER_ERROR);
+    ExpectNull(pipeline);
+    ExpectStrEQ(error, "shard init failed");
+
+    ExpectIntEQ(ssl_NewSnifferPipeline(&pipeline, 4,
+        test_sniffer_pipeline_init_cb, seen, error), 0);
+    ExpectNotNull(pipeline);
+    ExpectIntEQ(seen[0], 1);
+
+    ExpectIntEQ(ssl_DecodePacketBatch(NULL, pkts, 1, error),
+        WOLFSSL_SNIFFER_ERROR);
+    ExpectIntEQ(ssl_DecodePacketBatch(pipeline, NULL, 1, error),
+        WOLFSSL_SNIFFER_ERROR);
+    ExpectIntEQ(ssl_DecodePacketBatch(pipeline, pkts, 0, error), 0);
+
+    /* every packet gets its own result, bad ones do not stop the batch */
+    XMEMSET(pkts, 0, sizeof(pkts));
+    XMEMSET(pktError, 0, sizeof(pktError));
+    pkts[0].packet = tcpPkt;
+    pkts[0].length = (int)sizeof(tcpPkt);
+    pkts[0].error  = pktError[0];
+    pkts[1].packet = shortPkt;
+    pkts[1].length = (int)sizeof(shortPkt);
+    pkts[1].error  = pktError[1];
+    pkts[2].packet = NULL;
+    pkts[3].packet = tcpPkt;
+    pkts[3].length = (int)sizeof(tcpPkt);
+    pkts[3].ret    = 1;
+    ExpectIntEQ(ssl_DecodePacketBatch(pipeline, pkts, 4, error), 0);
+    ExpectIntEQ(pkts[0].ret, WOLFSSL_SNIFFER_ERROR);
+    ExpectIntNE(pktError[0][0], 0);
+    ExpectIntEQ(pkts[1].ret, WOLFSSL_SNIFFER_ERROR);
+    ExpectIntNE(pktError[1][0], 0);
+    ExpectIntEQ(pkts[2].ret, WOLFSSL_SNIFFER_ERROR);
+    ExpectIntEQ(pkts[3].ret, WOLFSSL_SNIFFER_ERROR);
+    ExpectNull(pkts[0].data);
+
+    /* pipeline is reusable */
+    ExpectIntEQ(ssl_DecodePacketBatch(pipeline, pkts, 2, error), 0);
+    ExpectIntEQ(pkts[1].ret, WOLFSSL_SNIFFER_ERROR);
+
+    ssl_FreeSnifferPipeline(pipeline);
+    ssl_FreeSnifferPipeline(NULL);
+    ssl_FreeSniffer();
+
+    return EXPECT_RESULT();
+}
+#endif /* WOLFSSL_SNIFFER && WOLFSSL_SNIFFER_PIPELINE */
+
+#if defined(WOLFSSL_SNIFFER) && defined(WOLFSSL_SNIFFER_PIPELINE) && \
+    defined(WOLFSSL_STATIC_EPHEMERAL) && defined(HAVE_ECC) && \
+    defined(WOLFSSL_TLS13) && !defined(NO_FILESYSTEM)
+#define TEST_SNIFFER_PCAP      "./scripts/sniffer-tls13-ecc.pcap"
+#define TEST_SNIFFER_PCAP_KEY  "./certs/statickeys/ecc-secp256r1.pem"
+#define TEST_SNIFFER_PCAP_MAX  128
+#define TEST_SNIFFER_BATCH     8
+
+static int test_sniffer_pipeline_key_cb(int shard, void* ctx, char* error)
+{
+    (void)shard;
+    (void)ctx;
+    return ssl_SetEphemeralKey("127.0.0.1", 11111, TEST_SNIFFER_PCAP_KEY,
+        FILETYPE_PEM, NULL, error);
+}
+
+/* Point pkts at the IP packets of the Ethernet frames in pcap file buf.
+ * Returns the number of packets or -1 on a format error. */
+static int test_sniffer_pipeline_pcap(const byte* buf, word32 sz,
+    SSLSnifferPacket* pkts, int max)
+{
+    word32 idx = 24;
+    int cnt = 0;
+
+    /* little endian, microsecond, Ethernet link layer */
+    if (sz < idx || buf[0] != 0xd4 || buf[1] != 0xc3 || buf[2] != 0xb2 ||
+            buf[3] != 0xa1 || buf[20] != 1) {
+        return -1;
+    }
+    while (idx + 16 <= sz && cnt < max) {
+        word32 len = (word32)buf[idx + 8] | ((word32)buf[idx + 9] << 8) |
+                     ((word32)buf[idx + 10] << 16) |
+                     ((word32)buf[idx + 11] << 24);
+
+        idx += 16;
+        if (len < 14 || len > sz - idx)
+            return -1;
+        pkts[cnt].packet = buf + idx + 14;
+        pkts[cnt].length = (int)len - 14;
+        cnt++;
+        idx += len;
+    }
+
+    return (idx == sz) ? cnt : -1;
+}
+
+/* Real TLS 1.3 connections decode the same over a pipeline as serially. */
+static int test_sniffer_pipeline_decode(void)
+{
+    EXPECT_DECLS;
+    SSLSnifferPipeline* pipeline = NULL;
+    SSLSnifferPacket* pkts = NULL;
+    byte* serial[TEST_SNIFFER_PCAP_MAX];
+    int serialRet[TEST_SNIFFER_PCAP_MAX];
+    char error[WOLFSSL_MAX_ERROR_SZ];
+    byte* buf = NULL;
+    XFILE f = XBADFILE;
+    long sz = 0;
+    int cnt = 0;
+    int decoded = 0;
+    int shards;
+    int i;
+#ifdef WOLFSSL_SNIFFER_STATS
+    SSLStats serialStats;
+    SSLStats stats;
+#endif
+
+    XMEMSET(serial, 0, sizeof(serial));
+    XMEMSET(serialRet, 0, sizeof(serialRet));
+    ExpectTrue((f = XFOPEN(TEST_SNIFFER_PCAP, "rb")) != XBADFILE);
+    ExpectTrue(XFSEEK(f, 0, XSEEK_END) == 0);
+    ExpectIntGT(sz = XFTELL(f), 0);
+    ExpectTrue(XFSEEK(f, 0, XSEEK_SET) == 0);
+    ExpectNotNull(buf = (byte*)XMALLOC((size_t)sz, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER));
+    ExpectIntEQ(XFREAD(buf, 1, (size_t)sz, f), sz);
+    if (f != XBADFILE)
+        XFCLOSE(f);
+    ExpectNotNull(pkts = (SSLSnifferPacket*)XMALLOC(
+        sizeof(SSLSnifferPacket) * TEST_SNIFFER_PCAP_MAX, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER));
+    if (pkts != NULL)
+        XMEMSET(pkts, 0, sizeof(SSLSnifferPacket) * TEST_SNIFFER_PCAP_MAX);
+    if (buf != NULL && pkts != NULL) {
+        ExpectIntGT(cnt = test_sniffer_pipeline_pcap(buf, (word32)sz, pkts,
+            TEST_SNIFFER_PCAP_MAX), 0);
+    }
+
+    ssl_InitSniffer();
+
+    /* reference: decoded one packet at a time on this thread */
+    ExpectIntEQ(test_sniffer_pipeline_key_cb(0, NULL, error), 0);
+    for (i = 0; EXPECT_SUCCESS() && i < cnt; i++) {
+        serialRet[i] = ssl_DecodePacket(pkts[i].packet, pkts[i].length,
+            &serial[i], error);
+        ExpectIntGE(serialRet[i], 0);
+        if (serialRet[i] > 0)
+            decoded += serialRet[i];
+    }
+    /* the capture has application data in it */
+    ExpectIntGT(decoded, 0);
+#ifdef WOLFSSL_SNIFFER_STATS
+    ExpectIntEQ(ssl_ReadResetStatistics(&serialStats), 0);
+    ExpectIntGT(serialStats.sslEncryptedConns, 1);
+#endif
+
+    /* the connections are spread over the shards, a batch at a time */
+    for (shards = 2; EXPECT_SUCCESS() && shards <= 4; shards += 2) {
+        ExpectIntEQ(ssl_NewSnifferPipeline(&pipeline, shards,
+            test_sniffer_pipeline_key_cb, NULL, error), 0);
+        for (i = 0; EXPECT_SUCCESS() && i < cnt; i += TEST_SNIFFER_BATCH) {
+            ExpectIntEQ(ssl_DecodePacketBatch(pipeline, pkts + i,
+                min(TEST_SNIFFER_BATCH, cnt - i), error), 0);
+        }
+        for (i = 0; i < cnt; i++) {
+            ExpectIntEQ(pkts[i].ret, serialRet[i]);
+            if (EXPECT_SUCCESS() && serialRet[i] > 0) {
+                ExpectBufEQ(pkts[i].data, serial[i], serialRet[i]);
+            }
+            if (pkts[i].data != NULL) {
+                ssl_FreeZeroDecodeBuffer(&pkts[i].data, pkts[i].ret,
+                    error);
+            }
+        }
+    #ifdef WOLFSSL_SNIFFER_STATS
+        /* counted per shard, merged on read and kept after the free */
+        ExpectIntEQ(ssl_ReadStatistics(&stats), 0);
+        ExpectIntEQ(stats.sslEncryptedConns, serialStats.sslEncryptedConns);
+        ExpectIntEQ(stats.sslDecryptedBytes, serialStats.sslDecryptedBytes);
+        ExpectIntEQ(stats.sslDecryptedPackets,
+            serialStats.sslDecryptedPackets);
+        ssl_FreeSnifferPipeline(pipeline);
+        pipeline = NULL;
+        ExpectIntEQ(ssl_ReadResetStatistics(&stats), 0);
+        ExpectIntEQ(stats.sslEncryptedConns, serialStats.sslEncryptedConns);
+        ExpectIntEQ(stats.sslDecryptedBytes, serialStats.sslDecryptedBytes);
+    #endif
+        ssl_FreeSnifferPipeline(pipeline);
+        pipeline = NULL;
+    }
+
+    for (i = 0; i < cnt; i++) {
+        if (serial[i] != NULL)
+            ssl_FreeZeroDecodeBuffer(&serial[i], serialRet[i], error);
+    }
+    ssl_FreeSniffer();
+    XFREE(pkts, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(buf, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+    return EXPECT_RESULT();
+}
+#endif
+
 /* Test: wc_DhAgree must reject p-1 as peer public key.
  * ffdhe2048 p ends with ...FFFFFFFFFFFFFFFF so p-1 ends ...FFFFFFFFFFFFFFFE */
 static int test_DhAgree_rejects_p_minus_1(void)
@@ -39247,6 +39586,7 @@ TEST_CASE testCases[] = {
     TEST_DECL(test_wolfSSL_get_ciphers_compat_empty),
 
     TEST_DECL(test_wolfSSL_CTX_ctrl),
+    TEST_DECL(test_wolfSSL_set_mode),
 #endif /* OPENSSL_ALL */
 #if (defined(OPENSSL_ALL) || defined(WOLFSSL_ASIO)) && !defined(NO_RSA)
     TEST_DECL(test_wolfSSL_CTX_use_certificate_ASN1),
@@ -39299,6 +39639,7 @@ TEST_CASE testCases[] = {
     TEST_DECL(test_wolfSSL_set_options),
 
     TEST_TLS13_DECLS,
+    TEST_KTLS_DECLS,
 
     TEST_DECL(test_wolfSSL_tmp_dh),
     TEST_DECL(test_wolfSSL_tmp_dh_regression),
@@ -39693,6 +40034,7 @@ TEST_CASE testCases[] = {
     TEST_DECL(test_ocsp_no_url_policy),
     TEST_DECL(test_tls13_nonblock_ocsp_low_mfl),
     TEST_DECL(test_ocsp_ctx_request_cache),
+    TEST_DECL(test_ocsp_staple_cache),
     TEST_DECL(test_ocsp_responder),
     TEST_DECL(test_wolfIO_DecodeUrl_crlf_reject),
     TEST_TLS_DECLS,
@@ -39714,6 +40056,14 @@ TEST_CASE testCases[] = {
 #if defined(WOLFSSL_SNIFFER) && defined(WOLFSSL_SNIFFER_CHAIN_INPUT)
     TEST_DECL(test_sniffer_chain_input_overflow),
 #endif
+#if defined(WOLFSSL_SNIFFER) && defined(WOLFSSL_SNIFFER_PIPELINE)
+    TEST_DECL(test_sniffer_pipeline),
+#endif
+#if defined(WOLFSSL_SNIFFER) && defined(WOLFSSL_SNIFFER_PIPELINE) && \
+    defined(WOLFSSL_STATIC_EPHEMERAL) && defined(HAVE_ECC) && \
+    defined(WOLFSSL_TLS13) && !defined(NO_FILESYSTEM)
+    TEST_DECL(test_sniffer_pipeline_decode),
+#endif
 
     /* This test needs to stay at the end to clean up any caches allocated. */
     TEST_DECL(test_wolfSSL_Cleanup)
@@ -626,6 +626,302 @@ int test_wolfSSL_CertManagerLoadCABufferType(void)
     return EXPECT_RESULT();
 }
 
+#if defined(WOLFSSL_CERT_GEN) && defined(WOLFSSL_CERT_EXT) && \
+    defined(HAVE_ECC) && !defined(NO_SKID) && !defined(NO_SHA256) && \
+    !defined(NO_CERTS) && !defined(NO_TLS) && \
+    ((!defined(NO_WOLFSSL_CLIENT) || !defined(WOLFSSL_NO_CLIENT_AUTH)) || \
+     defined(OPENSSL_EXTRA))
+#define TEST_CA_TABLE_CAS       150
+#define TEST_CA_TABLE_DER_SZ    1024
+/* Key identifier of a second CA named like CA 0. */
+#define TEST_CA_TABLE_KID2      1001
+
+/* Make CA number n, self signed, or a leaf issued by CA number n when ca is
+ * set. The key identifier is made from kidN. The leaf only names its issuer
+ * by subject when withAkid is 0. */
+static int test_ca_table_make(int n, int kidN, const byte* ca, int caSz,
+    int withAkid, ecc_key* key, WC_RNG* rng, byte* der)
+{
+    Cert cert;
+    int ret;
+    int i;
+
+    ret = wc_InitCert(&cert);
+    if (ret == 0) {
+        XSTRNCPY(cert.subject.country, "US", CTC_NAME_SIZE);
+        XSTRNCPY(cert.subject.org, "wolfSSL", CTC_NAME_SIZE);
+        cert.sigType = CTC_SHA256wECDSA;
+        if (ca == NULL) {
+            (void)XSNPRINTF(cert.subject.commonName, CTC_NAME_SIZE,
+                "Table CA %d", n);
+            cert.selfSigned = 1;
+            cert.isCA = 1;
+        }
+        else {
+            XSTRNCPY(cert.subject.commonName, "www.wolfssl.com",
+                CTC_NAME_SIZE);
+            ret = wc_SetIssuerBuffer(&cert, ca, caSz);
+        }
+    }
+    if (ret == 0) {
+        /* Same key for all CAs. Give each its own key identifier. */
+        byte* kid = (ca == NULL) ? cert.skid : cert.akid;
+
+        for (i = 0; i < 20; i++)
+            kid[i] = (byte)(kidN * 31 + i * 7);
+        if (ca == NULL)
+            cert.skidSz = 20;
+        else if (withAkid)
+            cert.akidSz = 20;
+        ret = wc_MakeCert(&cert, der, TEST_CA_TABLE_DER_SZ, NULL, key, rng);
+    }
+    if (ret > 0) {
+        ret = wc_SignCert(cert.bodySz, cert.sigType, der,
+            TEST_CA_TABLE_DER_SZ, NULL, key, rng);
+    }
+    return ret;
+}
+
+/* Verify a leaf issued by CA number n. */
+static int test_ca_table_verify(WOLFSSL_CERT_MANAGER* cm, byte* cas,
+    int* casSz, int n, int withAkid, ecc_key* key, WC_RNG* rng)
+{
+    byte leaf[TEST_CA_TABLE_DER_SZ];
+    int leafSz;
+
+    leafSz = test_ca_table_make(n, n, cas + n * TEST_CA_TABLE_DER_SZ,
+        casSz[n], withAkid, key, rng, leaf);
+    if (leafSz <= 0)
+        return leafSz;
+    return wolfSSL_CertManagerVerifyBuffer(cm, leaf, leafSz,
+        WOLFSSL_FILETYPE_ASN1);
+}
+#endif
+
+int test_wolfSSL_CertManager_large_ca_table(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_CERT_GEN) && defined(WOLFSSL_CERT_EXT) && \
+    defined(HAVE_ECC) && !defined(NO_SKID) && !defined(NO_SHA256) && \
+    !defined(NO_CERTS) && !defined(NO_TLS) && \
+    ((!defined(NO_WOLFSSL_CLIENT) || !defined(WOLFSSL_NO_CLIENT_AUTH)) || \
+     defined(OPENSSL_EXTRA))
+    WOLFSSL_CERT_MANAGER* cm = NULL;
+    byte* cas = NULL;
+    int casSz[TEST_CA_TABLE_CAS];
+    ecc_key key;
+    ecc_key key2;
+    WC_RNG rng;
+    int half = TEST_CA_TABLE_CAS / 2;
+    int last = TEST_CA_TABLE_CAS - 1;
+    int found1 = 0;
+    int found2 = 0;
+    int i;
+
+    XMEMSET(&key, 0, sizeof(key));
+    XMEMSET(&key2, 0, sizeof(key2));
+    XMEMSET(&rng, 0, sizeof(rng));
+    XMEMSET(casSz, 0, sizeof(casSz));
+    ExpectIntEQ(wc_InitRng(&rng), 0);
+    ExpectIntEQ(wc_ecc_init(&key), 0);
+    ExpectIntEQ(wc_ecc_make_key(&rng, 32, &key), 0);
+    ExpectNotNull(cas = (byte*)XMALLOC(TEST_CA_TABLE_CAS *
+        TEST_CA_TABLE_DER_SZ, NULL, DYNAMIC_TYPE_TMP_BUFFER));
+    ExpectNotNull(cm = wolfSSL_CertManagerNew());
+
+    /* Enough CAs to grow a CA index a few times. The second half are
+     * temporary CAs. */
+    for (i = 0; EXPECT_SUCCESS() && i < TEST_CA_TABLE_CAS; i++) {
+        ExpectIntGT(casSz[i] = test_ca_table_make(i, i, NULL, 0, 0, &key,
+            &rng, cas + i * TEST_CA_TABLE_DER_SZ), 0);
+        ExpectIntEQ(wolfSSL_CertManagerLoadCABufferType(cm,
+            cas + i * TEST_CA_TABLE_DER_SZ, casSz[i], WOLFSSL_FILETYPE_ASN1,
+            0, WOLFSSL_LOAD_VERIFY_DEFAULT_FLAGS,
+            (i < half) ? WOLFSSL_USER_CA : WOLFSSL_TEMP_CA), WOLFSSL_SUCCESS);
+    }
+    /* Loading a CA again is not an error. */
+    ExpectIntEQ(wolfSSL_CertManagerLoadCABuffer(cm, cas, casSz[0],
+        WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
+
+    /* Issuer found by key identifier and by subject name. */
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, 0, 1, &key, &rng),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, half, 1, &key, &rng),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, last, 1, &key, &rng),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, 1, 0, &key, &rng),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, last, 0, &key, &rng),
+        WOLFSSL_SUCCESS);
+
+    /* Removing the temporary CAs leaves the rest found. */
+    ExpectIntEQ(wolfSSL_CertManagerUnloadTypeCerts(cm, WOLFSSL_TEMP_CA),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, last, 1, &key, &rng),
+        WC_NO_ERR_TRACE(ASN_NO_SIGNER_E));
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, half, 0, &key, &rng),
+        WC_NO_ERR_TRACE(ASN_NO_SIGNER_E));
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, half - 1, 1, &key,
+        &rng), WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, 2, 0, &key, &rng),
+        WOLFSSL_SUCCESS);
+
+    /* Nothing found once all are unloaded, and found again once reloaded. */
+    ExpectIntEQ(wolfSSL_CertManagerUnloadCAs(cm), WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, 0, 1, &key, &rng),
+        WC_NO_ERR_TRACE(ASN_NO_SIGNER_E));
+    ExpectIntEQ(wolfSSL_CertManagerLoadCABuffer(cm,
+        cas + last * TEST_CA_TABLE_DER_SZ, casSz[last],
+        WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, last, 1, &key, &rng),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, 0, 1, &key, &rng),
+        WC_NO_ERR_TRACE(ASN_NO_SIGNER_E));
+
+    /* Two CAs with the same name, the newer one with its own key. Looked up
+     * by name, the index finds the same CA as the rows before and after a
+     * rebuild. CA 1 is replaced by one named CA 0. */
+    ExpectIntEQ(wolfSSL_CertManagerUnloadCAs(cm), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wc_ecc_init(&key2), 0);
+    ExpectIntEQ(wc_ecc_make_key(&rng, 32, &key2), 0);
+    ExpectIntGT(casSz[1] = test_ca_table_make(0, TEST_CA_TABLE_KID2, NULL, 0,
+        0, &key2, &rng, cas + TEST_CA_TABLE_DER_SZ), 0);
+    ExpectIntEQ(wolfSSL_CertManagerLoadCABuffer(cm, cas, casSz[0],
+        WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerLoadCABuffer(cm, cas + TEST_CA_TABLE_DER_SZ,
+        casSz[1], WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerLoadCABufferType(cm,
+        cas + 2 * TEST_CA_TABLE_DER_SZ, casSz[2], WOLFSSL_FILETYPE_ASN1, 0,
+        WOLFSSL_LOAD_VERIFY_DEFAULT_FLAGS, WOLFSSL_TEMP_CA), WOLFSSL_SUCCESS);
+    found1 = test_ca_table_verify(cm, cas, casSz, 0, 0, &key, &rng) ==
+        WOLFSSL_SUCCESS;
+    found2 = test_ca_table_verify(cm, cas, casSz, 1, 0, &key2, &rng) ==
+        WOLFSSL_SUCCESS;
+    ExpectIntNE(found1, found2);
+    /* Unloading rebuilds the index from the rows. */
+    ExpectIntEQ(wolfSSL_CertManagerUnloadTypeCerts(cm, WOLFSSL_TEMP_CA),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, 0, 0, &key, &rng) ==
+        WOLFSSL_SUCCESS, found1);
+    ExpectIntEQ(test_ca_table_verify(cm, cas, casSz, 1, 0, &key2, &rng) ==
+        WOLFSSL_SUCCESS, found2);
+
+    wolfSSL_CertManagerFree(cm);
+    XFREE(cas, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    wc_ecc_free(&key2);
+    wc_ecc_free(&key);
+    wc_FreeRng(&rng);
+#endif
+    return EXPECT_RESULT();
+}
+
+#if defined(WOLFSSL_CHAIN_CACHE) && defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES)
+static int test_chain_cache_accept_cb(int preverify,
+    WOLFSSL_X509_STORE_CTX* store)
+{
+    (void)preverify;
+    (void)store;
+    return 1;
+}
+
+/* Connect to the server with a new pair of SSL objects. */
+static int test_chain_cache_connect(WOLFSSL_CTX* ctx_c, WOLFSSL_CTX* ctx_s,
+    VerifyCallback cb, int expectOk)
+{
+    EXPECT_DECLS;
+    WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+    struct test_memio_ctx test_ctx;
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    ExpectIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+        NULL, NULL), 0);
+    if (cb != NULL)
+        wolfSSL_set_verify(ssl_c, WOLFSSL_VERIFY_PEER, cb);
+    if (expectOk) {
+        ExpectIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    }
+    else {
+        ExpectIntNE(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    }
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    return EXPECT_RESULT();
+}
+#endif
+
+int test_wolfSSL_CertManager_chain_cache(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_CHAIN_CACHE) && defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES)
+    WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+    WOLFSSL_CERT_MANAGER* cm = NULL;
+    struct test_memio_ctx test_ctx;
+    word32 hits = 0;
+    word32 misses = 0;
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    ExpectIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, NULL, NULL,
+        wolfTLS_client_method, wolfTLS_server_method), 0);
+    /* The cache is only used when the peer's chain is verified, which isn't
+     * the default with OPENSSL_COMPATIBLE_DEFAULTS. */
+    wolfSSL_CTX_set_verify(ctx_c, WOLFSSL_VERIFY_PEER, NULL);
+    ExpectNotNull(cm = wolfSSL_CTX_GetCertManager(ctx_c));
+
+    ExpectIntEQ(wolfSSL_CertManagerEnableChainCache(NULL, 8),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_CertManagerEnableChainCache(cm, 0),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_CertManagerGetChainCacheStats(NULL, &hits, &misses),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_CertManagerGetChainCacheStats(cm, &hits, &misses),
+        WC_NO_ERR_TRACE(WOLFSSL_FATAL_ERROR));
+    ExpectIntEQ(wolfSSL_CertManagerDisableChainCache(NULL),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_CertManagerEnableChainCache(cm, 8), WOLFSSL_SUCCESS);
+
+    /* First connection verifies and caches the chain, second finds it. */
+    ExpectIntEQ(test_chain_cache_connect(ctx_c, ctx_s, NULL, 1), TEST_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerGetChainCacheStats(cm, &hits, &misses),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(hits, 0);
+    ExpectIntEQ(misses, 1);
+    ExpectIntEQ(test_chain_cache_connect(ctx_c, ctx_s, NULL, 1), TEST_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerGetChainCacheStats(cm, &hits, &misses),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(hits, 1);
+    ExpectIntEQ(misses, 1);
+
+    /* Unloading the CAs drops cached chains. */
+    ExpectIntEQ(wolfSSL_CertManagerUnloadCAs(cm), WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_chain_cache_connect(ctx_c, ctx_s, NULL, 0), TEST_SUCCESS);
+    /* Chain accepted by the verify callback isn't cached. */
+    ExpectIntEQ(test_chain_cache_connect(ctx_c, ctx_s,
+        test_chain_cache_accept_cb, 1), TEST_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerLoadCA(cm, caCertFile, NULL),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_chain_cache_connect(ctx_c, ctx_s, NULL, 1), TEST_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerGetChainCacheStats(cm, &hits, &misses),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(hits, 1);
+    ExpectIntEQ(misses, 4);
+    ExpectIntEQ(test_chain_cache_connect(ctx_c, ctx_s, NULL, 1), TEST_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerGetChainCacheStats(cm, &hits, &misses),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(hits, 2);
+
+    ExpectIntEQ(wolfSSL_CertManagerDisableChainCache(cm), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerGetChainCacheStats(cm, &hits, &misses),
+        WC_NO_ERR_TRACE(WOLFSSL_FATAL_ERROR));
+    ExpectIntEQ(test_chain_cache_connect(ctx_c, ctx_s, NULL, 1), TEST_SUCCESS);
+
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+#endif
+    return EXPECT_RESULT();
+}
+
 int test_wolfSSL_CertManagerGetCerts(void)
 {
     EXPECT_DECLS;
@@ -2602,6 +2898,289 @@ int test_wolfSSL_CRL_static_revoked_list(void)
     return EXPECT_RESULT();
 }
 
+#if defined(CRL_REVOKED_INDEX) && defined(HAVE_CRL) && \
+    defined(WOLFSSL_CERT_GEN) && !defined(NO_RSA) && !defined(NO_CERTS)
+/* Get the header size of the DER element at idx and its total size. */
+static word32 test_crl_index_der_hdr(const byte* der, word32 sz, word32 idx,
+    word32* elemSz)
+{
+    word32 len = 0;
+    word32 hdr = 2;
+
+    *elemSz = 0;
+    if (idx + 2 > sz)
+        return 0;
+    if (der[idx + 1] < 0x80) {
+        len = der[idx + 1];
+    }
+    else {
+        word32 n = der[idx + 1] & 0x7F;
+        word32 i;
+
+        if (n > 3 || idx + 2 + n > sz)
+            return 0;
+        for (i = 0; i < n; i++)
+            len = (len << 8) | der[idx + 2 + i];
+        hdr += n;
+    }
+    if (idx + hdr + len > sz)
+        return 0;
+    *elemSz = hdr + len;
+    return hdr;
+}
+
+/* Make a CRL from certs/ca-cert.pem listing count synthetic serials and,
+ * when revokeServer is set, serial 01 of server-cert.pem, then load it. When
+ * file is set the CRL is written there and loaded from the file. */
+static int test_crl_index_load(WOLFSSL_CERT_MANAGER* cm, int count,
+    int revokeServer, const char* file)
+{
+    EXPECT_DECLS;
+    static const byte thisUpdate[] = "260101000000Z";
+    static const byte nextUpdate[] = "491231235959Z";
+    static const byte revDate[] = "250101000000Z";
+    RevokedCert* rc = NULL;
+    RsaKey key;
+    WC_RNG rng;
+    const byte* issuer = NULL;
+    word32 issuerSz = 0;
+    byte* crl = NULL;
+    int crlSz = 0;
+    int tbsSz = 0;
+    word32 idx = 0;
+    word32 elemSz = 0;
+    int i;
+    int n = count + 1;
+
+    /* Walk Certificate -> tbsCertificate -> issuer. ca-cert.pem is self
+     * signed so the issuer is also the CRL issuer. */
+    idx = test_crl_index_der_hdr(ca_cert_der_2048, sizeof_ca_cert_der_2048,
+        0, &elemSz);
+    idx += test_crl_index_der_hdr(ca_cert_der_2048, sizeof_ca_cert_der_2048,
+        idx, &elemSz);
+    if (ca_cert_der_2048[idx] == (ASN_CONTEXT_SPECIFIC | ASN_CONSTRUCTED)) {
+        (void)test_crl_index_der_hdr(ca_cert_der_2048,
+            sizeof_ca_cert_der_2048, idx, &elemSz);
+        idx += elemSz;
+    }
+    /* serialNumber and signature */
+    for (i = 0; i < 2; i++) {
+        (void)test_crl_index_der_hdr(ca_cert_der_2048,
+            sizeof_ca_cert_der_2048, idx, &elemSz);
+        idx += elemSz;
+    }
+    if (test_crl_index_der_hdr(ca_cert_der_2048, sizeof_ca_cert_der_2048,
+            idx, &elemSz) != 0) {
+        issuer = ca_cert_der_2048 + idx;
+        issuerSz = elemSz;
+    }
+    ExpectNotNull(issuer);
+
+    ExpectNotNull(rc = (RevokedCert*)XMALLOC(sizeof(RevokedCert) * (size_t)n,
+        NULL, DYNAMIC_TYPE_TMP_BUFFER));
+    if (rc != NULL) {
+        XMEMSET(rc, 0, sizeof(RevokedCert) * (size_t)n);
+        for (i = 0; i < n; i++) {
+            if (i == 0) {
+                rc[i].serialNumber[0] = revokeServer ? 0x01 : 0x7F;
+                rc[i].serialSz = 1;
+            }
+            else {
+                rc[i].serialNumber[0] = 0x10;
+                rc[i].serialNumber[1] = (byte)(i >> 8);
+                rc[i].serialNumber[2] = (byte)i;
+                rc[i].serialSz = 3;
+            }
+            XMEMCPY(rc[i].revDate, revDate, sizeof(revDate) - 1);
+            rc[i].revDateFormat = ASN_UTC_TIME;
+            rc[i].reasonCode = -1;
+            rc[i].next = (i + 1 < n) ? &rc[i + 1] : NULL;
+        }
+    }
+
+    ExpectIntEQ(wc_InitRng(&rng), 0);
+    ExpectIntEQ(wc_InitRsaKey(&key, NULL), 0);
+    idx = 0;
+    ExpectIntEQ(wc_RsaPrivateKeyDecode(ca_key_der_2048, &idx, &key,
+        sizeof_ca_key_der_2048), 0);
+
+    ExpectIntGT(tbsSz = wc_MakeCRL_ex(issuer, issuerSz, thisUpdate,
+        ASN_UTC_TIME, nextUpdate, ASN_UTC_TIME, rc, NULL, 0, CTC_SHA256wRSA,
+        2, NULL, 0), 0);
+    ExpectNotNull(crl = (byte*)XMALLOC((size_t)tbsSz + 512, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER));
+    ExpectIntEQ(wc_MakeCRL_ex(issuer, issuerSz, thisUpdate, ASN_UTC_TIME,
+        nextUpdate, ASN_UTC_TIME, rc, NULL, 0, CTC_SHA256wRSA, 2, crl,
+        (word32)tbsSz + 512), tbsSz);
+    ExpectIntGT(crlSz = wc_SignCRL_ex(crl, tbsSz, CTC_SHA256wRSA, crl,
+        (word32)tbsSz + 512, &key, NULL, &rng), 0);
+
+    if (file == NULL) {
+        ExpectIntEQ(wolfSSL_CertManagerLoadCRLBuffer(cm, crl, crlSz,
+            WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
+    }
+#ifndef NO_FILESYSTEM
+    else {
+        XFILE f = XBADFILE;
+
+        ExpectTrue((f = XFOPEN(file, "wb")) != XBADFILE);
+        if (f != XBADFILE) {
+            ExpectIntEQ((int)XFWRITE(crl, 1, (size_t)crlSz, f), crlSz);
+            XFCLOSE(f);
+        }
+        ExpectIntEQ(wolfSSL_CertManagerLoadCRLFile(cm, file,
+            WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
+        (void)remove(file);
+    }
+#endif
+
+    wc_FreeRsaKey(&key);
+    wc_FreeRng(&rng);
+    XFREE(crl, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(rc, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    return EXPECT_RESULT();
+}
+#endif
+
+int test_wolfSSL_CRL_revoked_index(void)
+{
+    EXPECT_DECLS;
+#if defined(CRL_REVOKED_INDEX) && defined(HAVE_CRL) && \
+    defined(WOLFSSL_CERT_GEN) && !defined(NO_RSA) && !defined(NO_CERTS)
+    WOLFSSL_CERT_MANAGER* cm = NULL;
+
+    /* Above the default CRL_REVOKED_INDEX_MIN so the CRL is indexed.
+     * server-cert.pem is encoded first so it is the last cert on the parsed
+     * list. */
+    ExpectNotNull(cm = wolfSSL_CertManagerNew());
+    ExpectIntEQ(wolfSSL_CertManagerLoadCABuffer(cm, ca_cert_der_2048,
+        sizeof_ca_cert_der_2048, WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerEnableCRL(cm, WOLFSSL_CRL_CHECKALL),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_crl_index_load(cm, 64, 1, NULL), TEST_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerCheckCRL(cm, server_cert_der_2048,
+        sizeof_server_cert_der_2048), WC_NO_ERR_TRACE(CRL_CERT_REVOKED));
+    wolfSSL_CertManagerFree(cm);
+    cm = NULL;
+
+    /* Same size CRL without the server cert. */
+    ExpectNotNull(cm = wolfSSL_CertManagerNew());
+    ExpectIntEQ(wolfSSL_CertManagerLoadCABuffer(cm, ca_cert_der_2048,
+        sizeof_ca_cert_der_2048, WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerEnableCRL(cm, WOLFSSL_CRL_CHECKALL),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_crl_index_load(cm, 64, 0, NULL), TEST_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerCheckCRL(cm, server_cert_der_2048,
+        sizeof_server_cert_der_2048), WOLFSSL_SUCCESS);
+    wolfSSL_CertManagerFree(cm);
+#endif
+    return EXPECT_RESULT();
+}
+
+int test_wolfSSL_CRL_mapped(void)
+{
+    EXPECT_DECLS;
+#if defined(HAVE_CRL_MMAP) && defined(WOLFSSL_CERT_GEN) && \
+    !defined(NO_RSA) && !defined(NO_CERTS)
+    WOLFSSL_CERT_MANAGER* cm = NULL;
+    const char* crlFile = "./certs/crl/crl.der";
+    const char* tmpFile = "./test-crl-mapped.der";
+    byte* crlBuf = NULL;
+    size_t crlSz = 0;
+    XFILE f = XBADFILE;
+
+    /* crl.der revokes serial 02, server-revoked-cert.pem. */
+    ExpectNotNull(cm = wolfSSL_CertManagerNew());
+    ExpectIntEQ(wolfSSL_CertManagerLoadCA(cm, "./certs/ca-cert.pem", NULL),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerEnableCRL(cm, WOLFSSL_CRL_CHECKALL),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerLoadCRLFile(cm, crlFile,
+        WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerVerify(cm,
+        "./certs/server-revoked-cert.pem", WOLFSSL_FILETYPE_PEM),
+        WC_NO_ERR_TRACE(CRL_CERT_REVOKED));
+    ExpectIntEQ(wolfSSL_CertManagerVerify(cm, "./certs/server-cert.pem",
+        WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+    /* Same CRL number again is rejected and its mapping released. */
+    ExpectIntEQ(wolfSSL_CertManagerLoadCRLFile(cm, crlFile,
+        WOLFSSL_FILETYPE_ASN1), WC_NO_ERR_TRACE(DUPE_ENTRY_E));
+    ExpectIntEQ(wolfSSL_CertManagerVerify(cm,
+        "./certs/server-revoked-cert.pem", WOLFSSL_FILETYPE_PEM),
+        WC_NO_ERR_TRACE(CRL_CERT_REVOKED));
+    wolfSSL_CertManagerFree(cm);
+    cm = NULL;
+
+    /* Rewriting the file in place after loading doesn't affect lookups. */
+    ExpectIntEQ(load_file(crlFile, &crlBuf, &crlSz), 0);
+    ExpectTrue((f = XFOPEN(tmpFile, "wb")) != XBADFILE);
+    if (f != XBADFILE) {
+        ExpectIntEQ((int)XFWRITE(crlBuf, 1, crlSz, f), (int)crlSz);
+        XFCLOSE(f);
+        f = XBADFILE;
+    }
+    ExpectNotNull(cm = wolfSSL_CertManagerNew());
+    ExpectIntEQ(wolfSSL_CertManagerLoadCA(cm, "./certs/ca-cert.pem", NULL),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerEnableCRL(cm, WOLFSSL_CRL_CHECKALL),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerLoadCRLFile(cm, tmpFile,
+        WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
+    /* Truncate and zero the file, a mapping still in use would fault. */
+    ExpectTrue((f = XFOPEN(tmpFile, "wb")) != XBADFILE);
+    if (f != XBADFILE) {
+        XMEMSET(crlBuf, 0, crlSz);
+        ExpectIntEQ((int)XFWRITE(crlBuf, 1, crlSz / 2, f), (int)(crlSz / 2));
+        XFCLOSE(f);
+        f = XBADFILE;
+    }
+    ExpectIntEQ(wolfSSL_CertManagerVerify(cm,
+        "./certs/server-revoked-cert.pem", WOLFSSL_FILETYPE_PEM),
+        WC_NO_ERR_TRACE(CRL_CERT_REVOKED));
+    ExpectIntEQ(wolfSSL_CertManagerVerify(cm, "./certs/server-cert.pem",
+        WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+    wolfSSL_CertManagerFree(cm);
+    cm = NULL;
+    (void)remove(tmpFile);
+    XFREE(crlBuf, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+
+    /* Directory load maps the DER CRLs too. */
+    ExpectNotNull(cm = wolfSSL_CertManagerNew());
+    ExpectIntEQ(wolfSSL_CertManagerLoadCA(cm, "./certs/ca-cert.pem", NULL),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerLoadCRL(cm, "./certs/crl",
+        WOLFSSL_FILETYPE_ASN1, 0), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerVerify(cm,
+        "./certs/server-revoked-cert.pem", WOLFSSL_FILETYPE_PEM),
+        WC_NO_ERR_TRACE(CRL_CERT_REVOKED));
+    wolfSSL_CertManagerFree(cm);
+    cm = NULL;
+
+    /* Many entries, looked up by serial and by serial hash. */
+    ExpectNotNull(cm = wolfSSL_CertManagerNew());
+    ExpectIntEQ(wolfSSL_CertManagerLoadCABuffer(cm, ca_cert_der_2048,
+        sizeof_ca_cert_der_2048, WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerEnableCRL(cm, WOLFSSL_CRL_CHECKALL),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_crl_index_load(cm, 300, 1, tmpFile), TEST_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerCheckCRL(cm, server_cert_der_2048,
+        sizeof_server_cert_der_2048), WC_NO_ERR_TRACE(CRL_CERT_REVOKED));
+    wolfSSL_CertManagerFree(cm);
+    cm = NULL;
+
+    ExpectNotNull(cm = wolfSSL_CertManagerNew());
+    ExpectIntEQ(wolfSSL_CertManagerLoadCABuffer(cm, ca_cert_der_2048,
+        sizeof_ca_cert_der_2048, WOLFSSL_FILETYPE_ASN1), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerEnableCRL(cm, WOLFSSL_CRL_CHECKALL),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_crl_index_load(cm, 300, 0, tmpFile), TEST_SUCCESS);
+    ExpectIntEQ(wolfSSL_CertManagerCheckCRL(cm, server_cert_der_2048,
+        sizeof_server_cert_der_2048), WOLFSSL_SUCCESS);
+    wolfSSL_CertManagerFree(cm);
+#endif
+    return EXPECT_RESULT();
+}
+
 int test_wolfSSL_CRL_duplicate_extensions(void)
 {
     EXPECT_DECLS;
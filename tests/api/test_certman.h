@@ -28,6 +28,8 @@ int test_wolfSSL_CertManagerAPI(void);
 int test_wolfSSL_CertManagerLoadCABuffer(void);
 int test_wolfSSL_CertManagerLoadCABuffer_ex(void);
 int test_wolfSSL_CertManagerLoadCABufferType(void);
+int test_wolfSSL_CertManager_large_ca_table(void);
+int test_wolfSSL_CertManager_chain_cache(void);
 int test_wolfSSL_CertManagerGetCerts(void);
 int test_wolfSSL_CertManagerSetVerify(void);
 int test_wolfSSL_CertManagerNameConstraint(void);
@@ -44,6 +46,8 @@ int test_wolfSSL_X509_check_host_URI_SAN_not_DNS_match(void);
 int test_wolfSSL_CertManagerCRL(void);
 int test_wolfSSL_CRL_reason_extensions_cleanup(void);
 int test_wolfSSL_CRL_static_revoked_list(void);
+int test_wolfSSL_CRL_revoked_index(void);
+int test_wolfSSL_CRL_mapped(void);
 int test_wolfSSL_CRL_duplicate_extensions(void);
 int test_wolfSSL_CRL_critical_idp(void);
 int test_wolfSSL_CRL_unknown_critical_ext(void);
@@ -64,6 +68,8 @@ int test_wolfSSL_CertManagerNameConstraint_skid_disambiguates(void);
     TEST_DECL_GROUP("certman", test_wolfSSL_CertManagerLoadCABuffer),       \
     TEST_DECL_GROUP("certman", test_wolfSSL_CertManagerLoadCABuffer_ex),    \
     TEST_DECL_GROUP("certman", test_wolfSSL_CertManagerLoadCABufferType),   \
+    TEST_DECL_GROUP("certman", test_wolfSSL_CertManager_large_ca_table),    \
+    TEST_DECL_GROUP("certman", test_wolfSSL_CertManager_chain_cache),       \
     TEST_DECL_GROUP("certman", test_wolfSSL_CertManagerGetCerts),           \
     TEST_DECL_GROUP("certman", test_wolfSSL_CertManagerSetVerify),          \
     TEST_DECL_GROUP("certman", test_wolfSSL_CertManagerNameConstraint),     \
@@ -82,6 +88,8 @@ int test_wolfSSL_CertManagerNameConstraint_skid_disambiguates(void);
     TEST_DECL_GROUP("certman", test_wolfSSL_CertManagerCRL),                \
     TEST_DECL_GROUP("certman", test_wolfSSL_CRL_reason_extensions_cleanup), \
     TEST_DECL_GROUP("certman", test_wolfSSL_CRL_static_revoked_list),      \
+    TEST_DECL_GROUP("certman", test_wolfSSL_CRL_revoked_index),            \
+    TEST_DECL_GROUP("certman", test_wolfSSL_CRL_mapped),                   \
     TEST_DECL_GROUP("certman", test_wolfSSL_CRL_duplicate_extensions),      \
     TEST_DECL_GROUP("certman", test_wolfSSL_CRL_critical_idp),             \
     TEST_DECL_GROUP("certman", test_wolfSSL_CRL_unknown_critical_ext),     \
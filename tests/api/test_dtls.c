@@ -7188,3 +7188,235 @@ int test_wolfSSL_set_secret(void)
     return EXPECT_RESULT();
 }
 
+
+#if defined(WOLFSSL_DTLS_DISPATCH) && defined(WOLFSSL_DTLS13) && \
+    defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES)
+#define TEST_DTLS_DISPATCH_PEERS 3
+
+static int test_dtls_dispatch_new_peer(WOLFSSL* ssl, void* arg)
+{
+    WOLFSSL** peers = (WOLFSSL**)arg;
+    int i;
+
+    for (i = 0; i < TEST_DTLS_DISPATCH_PEERS; i++) {
+        if (peers[i] == NULL) {
+            peers[i] = ssl;
+            return 0;
+        }
+    }
+    /* Reject any more peers. */
+    return -1;
+}
+
+/* Serve one batch of datagrams: progress handshakes and echo data. */
+static int test_dtls_dispatch_serve(WOLFSSL_DTLS_DISPATCHER* d)
+{
+    WOLFSSL* ready[TEST_DTLS_DISPATCH_PEERS];
+    char buf[64];
+    int n;
+    int i;
+    int ret;
+
+    n = wolfDTLS_DispatchRecv(d, ready, TEST_DTLS_DISPATCH_PEERS);
+    for (i = 0; i < n; i++) {
+        if (!wolfSSL_is_init_finished(ready[i]) &&
+                wolfSSL_accept(ready[i]) != WOLFSSL_SUCCESS) {
+            continue;
+        }
+        while ((ret = wolfSSL_read(ready[i], buf, sizeof(buf))) > 0) {
+            if (wolfSSL_write(ready[i], buf, ret) != ret)
+                return -1;
+        }
+    }
+    if (n >= 0 && wolfDTLS_DispatchFlush(d) != WOLFSSL_SUCCESS)
+        return -1;
+    return n;
+}
+
+static int test_dtls_dispatch_echo(WOLFSSL_DTLS_DISPATCHER* d, WOLFSSL* ssl,
+    const char* msg)
+{
+    char buf[64];
+    int len = (int)XSTRLEN(msg);
+    int ret = -1;
+    int i;
+
+    if (wolfSSL_write(ssl, msg, len) != len)
+        return -1;
+    for (i = 0; i < 20 && ret <= 0; i++) {
+        if (test_dtls_dispatch_serve(d) < 0)
+            return -1;
+        ret = wolfSSL_read(ssl, buf, sizeof(buf));
+    }
+    if (ret != len || XMEMCMP(buf, msg, len) != 0)
+        return -1;
+    return 0;
+}
+
+static int test_dtls_dispatch_client_fd(SOCKADDR_IN* addr)
+{
+    int fd = (int)socket(AF_INET, SOCK_DGRAM, 0);
+
+    if (fd == -1)
+        return -1;
+    if (connect(fd, (SOCKADDR*)addr, sizeof(*addr)) != 0 ||
+            fcntl(fd, F_SETFL, O_NONBLOCK) == -1) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+#endif
+
+int test_dtls_dispatch(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_DTLS_DISPATCH) && defined(WOLFSSL_DTLS13) && \
+    defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES)
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_s = NULL;
+    WOLFSSL* ssl_c[TEST_DTLS_DISPATCH_PEERS];
+    WOLFSSL* ssl_s[TEST_DTLS_DISPATCH_PEERS];
+    int fd_c[TEST_DTLS_DISPATCH_PEERS];
+    WOLFSSL_DTLS_DISPATCHER* d = NULL;
+    SOCKADDR_IN addr;
+    XSOCKLENT addrSz = (XSOCKLENT)sizeof(addr);
+    char msg[16];
+    int sfd = -1;
+    int cidSz = 0;
+    int done = 0;
+    int i;
+    int j;
+#ifdef WOLFSSL_DTLS_CID
+    SOCKADDR_IN peer;
+    unsigned int peerSz = (unsigned int)sizeof(peer);
+    SOCKADDR_IN local;
+    XSOCKLENT localSz = (XSOCKLENT)sizeof(local);
+    int fd_m = -1;
+
+    cidSz = 8;
+#endif
+
+    for (i = 0; i < TEST_DTLS_DISPATCH_PEERS; i++) {
+        ssl_c[i] = NULL;
+        ssl_s[i] = NULL;
+        fd_c[i] = -1;
+    }
+
+    XMEMSET(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ExpectIntNE(sfd = (int)socket(AF_INET, SOCK_DGRAM, 0), -1);
+    ExpectIntEQ(bind(sfd, (SOCKADDR*)&addr, sizeof(addr)), 0);
+    ExpectIntEQ(getsockname(sfd, (SOCKADDR*)&addr, &addrSz), 0);
+    ExpectIntNE(fcntl(sfd, F_SETFL, O_NONBLOCK), -1);
+
+    ExpectNotNull(ctx_c = wolfSSL_CTX_new(wolfDTLSv1_3_client_method()));
+    ExpectIntEQ(wolfSSL_CTX_load_verify_locations(ctx_c, caCertFile, 0),
+        WOLFSSL_SUCCESS);
+    ExpectNotNull(ctx_s = wolfSSL_CTX_new(wolfDTLSv1_3_server_method()));
+    ExpectIntEQ(wolfSSL_CTX_use_PrivateKey_file(ctx_s, svrKeyFile,
+        WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_use_certificate_file(ctx_s, svrCertFile,
+        WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+
+    /* Bad arguments. */
+    ExpectNull(wolfDTLS_DispatchNew(NULL, sfd, cidSz));
+    ExpectNull(wolfDTLS_DispatchNew(ctx_c, sfd, cidSz));
+    ExpectNull(wolfDTLS_DispatchNew(ctx_s, -1, cidSz));
+    ExpectNull(wolfDTLS_DispatchNew(ctx_s, sfd, -1));
+    ExpectIntEQ(wolfDTLS_DispatchRecv(NULL, ssl_s, 1),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfDTLS_DispatchFlush(NULL), WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfDTLS_DispatchSetNewPeerCb(NULL, NULL, NULL),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    wolfDTLS_DispatchFree(NULL);
+
+    ExpectNotNull(d = wolfDTLS_DispatchNew(ctx_s, sfd, cidSz));
+    ExpectIntEQ(wolfDTLS_DispatchSetNewPeerCb(d, test_dtls_dispatch_new_peer,
+        ssl_s), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfDTLS_DispatchRecv(d, NULL, 1),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    /* Nothing received yet. */
+    ExpectIntEQ(wolfDTLS_DispatchRecv(d, ssl_s, 1), 0);
+
+    for (i = 0; i < TEST_DTLS_DISPATCH_PEERS; i++) {
+        ExpectIntNE(fd_c[i] = test_dtls_dispatch_client_fd(&addr), -1);
+        ExpectNotNull(ssl_c[i] = wolfSSL_new(ctx_c));
+        ExpectIntEQ(wolfSSL_set_dtls_fd_connected(ssl_c[i], fd_c[i]),
+            WOLFSSL_SUCCESS);
+        wolfSSL_dtls_set_using_nonblock(ssl_c[i], 1);
+    #ifdef WOLFSSL_DTLS_CID
+        ExpectIntEQ(wolfSSL_dtls_cid_use(ssl_c[i]), WOLFSSL_SUCCESS);
+    #endif
+    }
+
+    /* All handshakes progress together over the one server socket. */
+    for (j = 0; EXPECT_SUCCESS() && j < 50 && done < TEST_DTLS_DISPATCH_PEERS;
+            j++) {
+        done = 0;
+        for (i = 0; i < TEST_DTLS_DISPATCH_PEERS; i++) {
+            if (wolfSSL_connect(ssl_c[i]) == WOLFSSL_SUCCESS)
+                done++;
+            else
+                ExpectIntEQ(wolfSSL_get_error(ssl_c[i], -1),
+                    WOLFSSL_ERROR_WANT_READ);
+        }
+        ExpectIntGE(test_dtls_dispatch_serve(d), 0);
+    }
+    ExpectIntEQ(done, TEST_DTLS_DISPATCH_PEERS);
+    for (i = 0; i < TEST_DTLS_DISPATCH_PEERS; i++)
+        ExpectNotNull(ssl_s[i]);
+
+    for (i = 0; i < TEST_DTLS_DISPATCH_PEERS; i++) {
+        XSNPRINTF(msg, sizeof(msg), "peer %d", i);
+        ExpectIntEQ(test_dtls_dispatch_echo(d, ssl_c[i], msg), 0);
+    }
+
+#ifdef WOLFSSL_DTLS_CID
+    /* Client 0 moves to a new port: records are routed on its CID and the
+     * server answers at the new address once a record has authenticated. */
+    ExpectIntNE(fd_m = test_dtls_dispatch_client_fd(&addr), -1);
+    ExpectIntEQ(getsockname(fd_m, (SOCKADDR*)&local, &localSz), 0);
+    ExpectIntEQ(wolfSSL_set_dtls_fd_connected(ssl_c[0], fd_m),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_dtls_dispatch_echo(d, ssl_c[0], "moved"), 0);
+    for (i = 0; i < TEST_DTLS_DISPATCH_PEERS; i++) {
+        peerSz = (unsigned int)sizeof(peer);
+        if (ssl_s[i] != NULL &&
+                wolfSSL_dtls_get_peer(ssl_s[i], &peer, &peerSz) ==
+                WOLFSSL_SUCCESS && peer.sin_port == local.sin_port) {
+            break;
+        }
+    }
+    ExpectIntLT(i, TEST_DTLS_DISPATCH_PEERS);
+    for (i = 1; i < TEST_DTLS_DISPATCH_PEERS; i++) {
+        XSNPRINTF(msg, sizeof(msg), "again %d", i);
+        ExpectIntEQ(test_dtls_dispatch_echo(d, ssl_c[i], msg), 0);
+    }
+#endif
+
+    /* Only the dispatcher's own connections can be removed. */
+    ExpectIntEQ(wolfDTLS_DispatchRemove(d, ssl_c[0]),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfDTLS_DispatchRemove(NULL, ssl_s[0]),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfDTLS_DispatchRemove(d, ssl_s[0]), WOLFSSL_SUCCESS);
+
+    wolfDTLS_DispatchFree(d);
+    for (i = 0; i < TEST_DTLS_DISPATCH_PEERS; i++) {
+        wolfSSL_free(ssl_c[i]);
+        if (fd_c[i] != -1)
+            close(fd_c[i]);
+    }
+#ifdef WOLFSSL_DTLS_CID
+    if (fd_m != -1)
+        close(fd_m);
+#endif
+    if (sfd != -1)
+        close(sfd);
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+#endif
+    return EXPECT_RESULT();
+}
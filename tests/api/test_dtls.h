@@ -74,6 +74,7 @@ int test_wolfSSL_mcast_read(void);
 int test_wolfSSL_dtls_got_timeout(void);
 int test_wolfSSL_DTLS_SetCookieSecret(void);
 int test_wolfSSL_set_secret(void);
+int test_dtls_dispatch(void);
 
 /* DTLS tests moved out of tests/api.c. */
 int test_dtls_msg_from_other_peer(void);
@@ -198,5 +199,6 @@ int test_WOLFSSL_dtls_version_alert(void);
         TEST_DECL_GROUP("dtls", test_wolfSSL_mcast_read),                      \
         TEST_DECL_GROUP("dtls", test_wolfSSL_dtls_got_timeout),                \
         TEST_DECL_GROUP("dtls", test_wolfSSL_DTLS_SetCookieSecret),            \
-        TEST_DECL_GROUP("dtls", test_wolfSSL_set_secret)
+        TEST_DECL_GROUP("dtls", test_wolfSSL_set_secret),                      \
+        TEST_DECL_GROUP("dtls", test_dtls_dispatch)
 #endif /* TESTS_API_DTLS_H */
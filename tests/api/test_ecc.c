@@ -2421,6 +2421,129 @@ int test_wc_ecc_mulmod(void)
     return EXPECT_RESULT();
 } /* END test_wc_ecc_mulmod */
 
+/*
+ * Testing wc_ecc_fp_share_key(), wc_ecc_fp_export_shared() and
+ * wc_ecc_fp_import_shared()
+ */
+int test_wc_ecc_fp_shared(void)
+{
+    EXPECT_DECLS;
+#if defined(HAVE_ECC) && defined(FP_ECC_SHARED) && !defined(WC_NO_RNG) && \
+    !defined(WOLFSSL_VALIDATE_ECC_IMPORT) && !defined(HAVE_SELFTEST) && \
+    !defined(HAVE_FIPS)
+    ecc_key     key;
+    ecc_key     base;
+    ecc_key     mod;
+    WC_RNG      rng;
+    ecc_point*  r1 = NULL;
+    ecc_point*  r2 = NULL;
+    byte*       tables = NULL;
+    word32      tablesSz = 0;
+    int         ret;
+
+    XMEMSET(&key, 0, sizeof(ecc_key));
+    XMEMSET(&base, 0, sizeof(ecc_key));
+    XMEMSET(&mod, 0, sizeof(ecc_key));
+    XMEMSET(&rng, 0, sizeof(WC_RNG));
+
+    ExpectIntEQ(wc_ecc_init(&key), 0);
+    ExpectIntEQ(wc_ecc_init(&base), 0);
+    ExpectIntEQ(wc_ecc_init(&mod), 0);
+    ExpectIntEQ(wc_InitRng(&rng), 0);
+    ret = wc_ecc_make_key(&rng, KEY32, &key);
+#if defined(WOLFSSL_ASYNC_CRYPT)
+    ret = wc_AsyncWait(ret, &key.asyncDev, WC_ASYNC_FLAG_NONE);
+#endif
+    ExpectIntEQ(ret, 0);
+    DoExpectIntEQ(wc_FreeRng(&rng), 0);
+
+    /* Base point with curve parameter a and the prime as private values. */
+    ExpectIntEQ(wc_ecc_import_raw_ex(&base, key.dp->Gx, key.dp->Gy,
+        key.dp->Af, ECC_SECP256R1), 0);
+    ExpectIntEQ(wc_ecc_import_raw_ex(&mod, key.dp->Gx, key.dp->Gy,
+        key.dp->prime, ECC_SECP256R1), 0);
+    ExpectNotNull(r1 = wc_ecc_new_point());
+    ExpectNotNull(r2 = wc_ecc_new_point());
+
+    /* Result without pinned tables. */
+    ExpectIntEQ(wc_ecc_mulmod(wc_ecc_key_get_priv(&key), &base.pubkey, r1,
+        wc_ecc_key_get_priv(&base), wc_ecc_key_get_priv(&mod), 1), 0);
+
+    /* Pin base point and public key, twice to check pinned ones are kept. */
+    ExpectIntEQ(wc_ecc_fp_share_key(&key), 0);
+    ExpectIntEQ(wc_ecc_fp_share_key(&key), 0);
+    ExpectIntEQ(wc_ecc_mulmod(wc_ecc_key_get_priv(&key), &base.pubkey, r2,
+        wc_ecc_key_get_priv(&base), wc_ecc_key_get_priv(&mod), 1), 0);
+    ExpectIntEQ(wc_ecc_cmp_point(r1, r2), MP_EQ);
+
+    /* Export, free and import pinned tables. */
+    ExpectIntEQ(wc_ecc_fp_export_shared(NULL, &tablesSz),
+        WC_NO_ERR_TRACE(LENGTH_ONLY_E));
+    ExpectIntGT(tablesSz, 0);
+    ExpectNotNull(tables = (byte*)XMALLOC(tablesSz, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER));
+    tablesSz--;
+    ExpectIntEQ(wc_ecc_fp_export_shared(tables, &tablesSz),
+        WC_NO_ERR_TRACE(BUFFER_E));
+    tablesSz++;
+    ExpectIntEQ(wc_ecc_fp_export_shared(tables, &tablesSz), 0);
+    wc_ecc_fp_free_shared();
+
+    ExpectIntEQ(wc_ecc_fp_import_shared(tables, tablesSz), 0);
+    ExpectIntEQ(wc_ecc_mulmod(wc_ecc_key_get_priv(&key), &base.pubkey, r2,
+        wc_ecc_key_get_priv(&base), wc_ecc_key_get_priv(&mod), 1), 0);
+    ExpectIntEQ(wc_ecc_cmp_point(r1, r2), MP_EQ);
+    wc_ecc_fp_free_shared();
+
+    /* Truncated and corrupted tables are rejected. */
+    ExpectIntEQ(wc_ecc_fp_import_shared(tables, tablesSz - 1),
+        WC_NO_ERR_TRACE(BUFFER_E));
+    if (tables != NULL) {
+        tables[tablesSz - 1] ^= 0x01;
+    }
+    ExpectIntNE(wc_ecc_fp_import_shared(tables, tablesSz), 0);
+    if (tables != NULL) {
+        tables[tablesSz - 1] ^= 0x01;
+    }
+    /* Points on the curve that are not the right multiples are rejected:
+     * swap LUT entries 2 and 3 of the first P-256 table. */
+    if (tables != NULL && tablesSz >= 4 + 2 + 4 * 32 + 3 * 64) {
+        byte  tmp[64];
+        byte* lut2 = tables + 4 + 2 + 4 * 32 + 64;
+
+        XMEMCPY(tmp, lut2, sizeof(tmp));
+        XMEMCPY(lut2, lut2 + 64, sizeof(tmp));
+        XMEMCPY(lut2 + 64, tmp, sizeof(tmp));
+    }
+    ExpectIntEQ(wc_ecc_fp_import_shared(tables, tablesSz),
+        WC_NO_ERR_TRACE(IS_POINT_E));
+    tablesSz = 0;
+    ExpectIntEQ(wc_ecc_fp_export_shared(NULL, &tablesSz),
+        WC_NO_ERR_TRACE(LENGTH_ONLY_E));
+
+    /* Test bad args. */
+    ExpectIntEQ(wc_ecc_fp_share_key(NULL), WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_ecc_fp_share_point(ECC_SECP256R1, NULL),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_ecc_fp_share_point(-5, &base.pubkey),
+        WC_NO_ERR_TRACE(ECC_BAD_ARG_E));
+    ExpectIntEQ(wc_ecc_fp_export_shared(NULL, NULL),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_ecc_fp_import_shared(NULL, 0),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+
+    XFREE(tables, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    wc_ecc_del_point(r2);
+    wc_ecc_del_point(r1);
+    wc_ecc_free(&mod);
+    wc_ecc_free(&base);
+    wc_ecc_free(&key);
+    wc_ecc_fp_free_shared();
+    wc_ecc_fp_free();
+#endif
+    return EXPECT_RESULT();
+} /* END test_wc_ecc_fp_shared */
+
 /*
  * Testing wc_ecc_is_valid_idx()
  */
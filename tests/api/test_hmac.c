@@ -713,6 +713,98 @@ int test_wc_Sha384HmacFinal(void)
     return EXPECT_RESULT();
 } /* END test_wc_Sha384HmacFinal */
 
+#if !defined(NO_HMAC) && defined(WOLFSSL_SHA2_BATCH)
+/* Check a batch HMAC against HMAC of each message on its own.
+ *
+ * @param [in] type    Hash type.
+ * @param [in] macSz   Size of MAC.
+ * @param [in] batch   Batch HMAC function.
+ * @param [in] key     Key.
+ * @param [in] keySz   Size of key.
+ */
+static int test_hmac_batch_check(int type, word32 macSz,
+    int (*batch)(const byte*, word32, const byte* const*, const word32*,
+        byte* const*, word32), const byte* key, word32 keySz)
+{
+    EXPECT_DECLS;
+    static const word32 lens[] = {
+        0, 1, 20, 55, 56, 64, 100, 111, 112, 128, 129, 250, 256, 300, 7, 64,
+        65, 0, 33, 400
+    };
+    const word32 cnt = (word32)(sizeof(lens) / sizeof(*lens));
+    byte msg[400];
+    byte out[sizeof(lens) / sizeof(*lens)][WC_MAX_DIGEST_SIZE];
+    byte expected[WC_MAX_DIGEST_SIZE];
+    const byte* data[sizeof(lens) / sizeof(*lens)];
+    byte* mac[sizeof(lens) / sizeof(*lens)];
+    Hmac hmac;
+    word32 i;
+
+    for (i = 0; i < (word32)sizeof(msg); i++) {
+        msg[i] = (byte)(i ^ 0x5a);
+    }
+    for (i = 0; i < cnt; i++) {
+        data[i] = msg;
+        mac[i] = out[i];
+    }
+
+    XMEMSET(out, 0, sizeof(out));
+    ExpectIntEQ(batch(key, keySz, data, lens, mac, cnt), 0);
+    for (i = 0; i < cnt; i++) {
+        ExpectIntEQ(wc_HmacInit(&hmac, NULL, INVALID_DEVID), 0);
+        ExpectIntEQ(wc_HmacSetKey(&hmac, type, key, keySz), 0);
+        ExpectIntEQ(wc_HmacUpdate(&hmac, data[i], lens[i]), 0);
+        ExpectIntEQ(wc_HmacFinal(&hmac, expected), 0);
+        wc_HmacFree(&hmac);
+        ExpectBufEQ(out[i], expected, macSz);
+    }
+
+    /* Bad parameters. */
+    ExpectIntEQ(batch(NULL, keySz, data, lens, mac, cnt),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(batch(key, keySz, NULL, lens, mac, cnt),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(batch(key, keySz, data, NULL, mac, cnt),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(batch(key, keySz, data, lens, NULL, cnt),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(batch(key, keySz, NULL, NULL, NULL, 0), 0);
+
+    return EXPECT_RESULT();
+}
+#endif
+
+/*
+ * Testing wc_HmacSha256Batch() and wc_HmacSha512Batch()
+ */
+int test_wc_HmacBatch(void)
+{
+    EXPECT_DECLS;
+#if !defined(NO_HMAC) && defined(WOLFSSL_SHA2_BATCH)
+    byte key[200];
+    word32 i;
+
+    for (i = 0; i < (word32)sizeof(key); i++) {
+        key[i] = (byte)(i + 0x0b);
+    }
+
+#ifndef NO_SHA256
+    ExpectIntEQ(test_hmac_batch_check(WC_SHA256, WC_SHA256_DIGEST_SIZE,
+        wc_HmacSha256Batch, key, 20), TEST_SUCCESS);
+    /* Key longer than a block is hashed first. */
+    ExpectIntEQ(test_hmac_batch_check(WC_SHA256, WC_SHA256_DIGEST_SIZE,
+        wc_HmacSha256Batch, key, (word32)sizeof(key)), TEST_SUCCESS);
+#endif
+#if defined(WOLFSSL_SHA512) && !defined(WOLF_CRYPTO_CB_ONLY_SHA512)
+    ExpectIntEQ(test_hmac_batch_check(WC_SHA512, WC_SHA512_DIGEST_SIZE,
+        wc_HmacSha512Batch, key, 20), TEST_SUCCESS);
+    ExpectIntEQ(test_hmac_batch_check(WC_SHA512, WC_SHA512_DIGEST_SIZE,
+        wc_HmacSha512Batch, key, (word32)sizeof(key)), TEST_SUCCESS);
+#endif
+#endif
+    return EXPECT_RESULT();
+} /* END test_wc_HmacBatch */
+
 /* Test for integer overflow in TLS_hmac size calculation (ZD #21240).
  *
  * TLS_hmac() computes sz + hashSz + padSz + 1 and passes the result to
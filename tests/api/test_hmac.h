@@ -39,6 +39,7 @@ int test_wc_Sha256HmacFinal(void);
 int test_wc_Sha384HmacSetKey(void);
 int test_wc_Sha384HmacUpdate(void);
 int test_wc_Sha384HmacFinal(void);
+int test_wc_HmacBatch(void);
 int test_tls_hmac_size_overflow(void);
 int test_tls_timing_pad_verify_hmac_len(void);
 int test_wc_HmacSizeByType(void);
@@ -65,6 +66,7 @@ int test_wc_Tls13_HKDF_Extract_ZeroLenIkm(void);
     TEST_DECL_GROUP("hmac", test_wc_Sha384HmacSetKey),  \
     TEST_DECL_GROUP("hmac", test_wc_Sha384HmacUpdate),  \
     TEST_DECL_GROUP("hmac", test_wc_Sha384HmacFinal),   \
+    TEST_DECL_GROUP("hmac", test_wc_HmacBatch),         \
     TEST_DECL_GROUP("hmac", test_tls_hmac_size_overflow), \
     TEST_DECL_GROUP("hmac", test_tls_timing_pad_verify_hmac_len), \
     TEST_DECL_GROUP("hmac", test_wc_HmacSizeByType),    \
@@ -0,0 +1,198 @@
+/* test_ktls.c
+ *
+ * Copyright (C) 2006-2026 wolfSSL Inc.
+ *
+ * This file is part of wolfSSL.
+ *
+ * wolfSSL is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfSSL is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335, USA
+ */
+
+#include <tests/unit.h>
+
+#ifdef NO_INLINE
+    #include <wolfssl/wolfcrypt/misc.h>
+#else
+    #define WOLFSSL_MISC_INCLUDED
+    #include <wolfcrypt/src/misc.c>
+#endif
+
+#include <wolfssl/ssl.h>
+#include <wolfssl/internal.h>
+#include <wolfssl/error-ssl.h>
+#include <tests/api/api.h>
+#include <tests/utils.h>
+#include <tests/api/test_ktls.h>
+
+int test_wolfSSL_UseKTLS_args(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_KTLS) && !defined(NO_WOLFSSL_CLIENT)
+    WOLFSSL_CTX* ctx = NULL;
+    WOLFSSL* ssl = NULL;
+
+    ExpectIntEQ(wolfSSL_UseKTLS(NULL, WOLFSSL_KTLS_TX), BAD_FUNC_ARG);
+    ExpectIntEQ(wolfSSL_GetKTLS(NULL), 0);
+    ExpectIntEQ(wolfSSL_sendfile(NULL, 0, 0, 1), BAD_FUNC_ARG);
+
+    ExpectNotNull(ctx = wolfSSL_CTX_new(wolfSSLv23_client_method()));
+    ExpectNotNull(ssl = wolfSSL_new(ctx));
+
+    ExpectIntEQ(wolfSSL_UseKTLS(ssl, 0), BAD_FUNC_ARG);
+    ExpectIntEQ(wolfSSL_UseKTLS(ssl, 0x04), BAD_FUNC_ARG);
+    /* Handshake not done. */
+    ExpectIntEQ(wolfSSL_UseKTLS(ssl, WOLFSSL_KTLS_TX | WOLFSSL_KTLS_RX),
+        BAD_STATE_E);
+    ExpectIntEQ(wolfSSL_GetKTLS(ssl), 0);
+    /* kTLS TX not in use. */
+    ExpectIntEQ(wolfSSL_sendfile(ssl, 0, 0, 1), WOLFSSL_FATAL_ERROR);
+    ExpectIntEQ(wolfSSL_get_error(ssl, WOLFSSL_FATAL_ERROR), BAD_STATE_E);
+
+    wolfSSL_free(ssl);
+    wolfSSL_CTX_free(ctx);
+#endif
+    return EXPECT_RESULT();
+}
+
+#if defined(WOLFSSL_KTLS) && defined(HAVE_IO_TESTS_DEPENDENCIES)
+static const char ktlsPing[] = "kTLS ping";
+static const char ktlsPong[] = "kTLS pong";
+static const char ktlsFile[] = "kTLS file";
+
+/* Turn on kTLS when available - the connection must work either way. */
+static void test_ktls_use(WOLFSSL* ssl)
+{
+    int ret = wolfSSL_UseKTLS(ssl, WOLFSSL_KTLS_TX | WOLFSSL_KTLS_RX);
+
+    if (ret == WOLFSSL_SUCCESS) {
+        AssertIntEQ(wolfSSL_GetKTLS(ssl), WOLFSSL_KTLS_TX | WOLFSSL_KTLS_RX);
+    }
+    else {
+        AssertIntEQ(ret, KTLS_UNAVAILABLE_E);
+        AssertIntEQ(wolfSSL_GetKTLS(ssl), 0);
+    }
+}
+
+static void test_ktls_ping(WOLFSSL* ssl)
+{
+    char buf[sizeof(ktlsPong)];
+
+    AssertIntEQ(wolfSSL_write(ssl, ktlsPing, (int)sizeof(ktlsPing)),
+        (int)sizeof(ktlsPing));
+    AssertIntEQ(wolfSSL_read(ssl, buf, (int)sizeof(buf)), (int)sizeof(buf));
+    AssertIntEQ(XMEMCMP(buf, ktlsPong, sizeof(ktlsPong)), 0);
+}
+
+/* Send file data with sendfile() when the kernel encrypts, otherwise check
+ * that sendfile() is refused and write the data instead. */
+static void test_ktls_sendfile(WOLFSSL* ssl)
+{
+    char buf[sizeof(ktlsPong)];
+    FILE* f;
+
+    f = tmpfile();
+    AssertNotNull(f);
+    AssertIntEQ((int)fwrite(ktlsFile, 1, sizeof(ktlsFile), f),
+        (int)sizeof(ktlsFile));
+    AssertIntEQ(fflush(f), 0);
+
+    if (wolfSSL_GetKTLS(ssl) & WOLFSSL_KTLS_TX) {
+        AssertIntEQ(wolfSSL_sendfile(ssl, fileno(f), 0, (int)sizeof(ktlsFile)),
+            (int)sizeof(ktlsFile));
+    }
+    else {
+        AssertIntEQ(wolfSSL_sendfile(ssl, fileno(f), 0, (int)sizeof(ktlsFile)),
+            WOLFSSL_FATAL_ERROR);
+        AssertIntEQ(wolfSSL_get_error(ssl, WOLFSSL_FATAL_ERROR), BAD_STATE_E);
+        AssertIntEQ(wolfSSL_write(ssl, ktlsFile, (int)sizeof(ktlsFile)),
+            (int)sizeof(ktlsFile));
+    }
+    fclose(f);
+
+    AssertIntEQ(wolfSSL_read(ssl, buf, (int)sizeof(buf)), (int)sizeof(buf));
+    AssertIntEQ(XMEMCMP(buf, ktlsPong, sizeof(ktlsPong)), 0);
+}
+
+static void test_ktls_client_result(WOLFSSL* ssl)
+{
+    test_ktls_use(ssl);
+    test_ktls_ping(ssl);
+    test_ktls_sendfile(ssl);
+#ifdef WOLFSSL_TLS13
+    if (IsAtLeastTLSv1_3(ssl->version)) {
+        /* New keys both ways: the server answers the update request. */
+        AssertIntEQ(wolfSSL_update_keys(ssl), WOLFSSL_SUCCESS);
+        test_ktls_ping(ssl);
+        test_ktls_ping(ssl);
+    }
+#endif
+    /* close_notify alert goes through the kernel as a control record. */
+    AssertIntEQ(wolfSSL_shutdown(ssl), WOLFSSL_SHUTDOWN_NOT_DONE);
+}
+
+/* Answer every ping or file with a pong until the client closes. */
+static void test_ktls_server_result(WOLFSSL* ssl)
+{
+    char buf[sizeof(ktlsPing)];
+    int ret;
+
+    test_ktls_use(ssl);
+    while ((ret = wolfSSL_read(ssl, buf, (int)sizeof(buf))) > 0) {
+        AssertIntEQ(ret, (int)sizeof(buf));
+        AssertTrue((XMEMCMP(buf, ktlsPing, sizeof(ktlsPing)) == 0) ||
+                   (XMEMCMP(buf, ktlsFile, sizeof(ktlsFile)) == 0));
+        AssertIntEQ(wolfSSL_write(ssl, ktlsPong, (int)sizeof(ktlsPong)),
+            (int)sizeof(ktlsPong));
+    }
+    AssertIntEQ(ret, 0);
+    AssertIntEQ(wolfSSL_get_error(ssl, ret), WOLFSSL_ERROR_ZERO_RETURN);
+}
+
+static int test_ktls_connection(method_provider client_meth,
+    method_provider server_meth)
+{
+    EXPECT_DECLS;
+    callback_functions client_cbf;
+    callback_functions server_cbf;
+
+    XMEMSET(&client_cbf, 0, sizeof(client_cbf));
+    XMEMSET(&server_cbf, 0, sizeof(server_cbf));
+    client_cbf.method = client_meth;
+    server_cbf.method = server_meth;
+    client_cbf.on_result = test_ktls_client_result;
+    server_cbf.on_result = test_ktls_server_result;
+
+    test_wolfSSL_client_server_nofail(&client_cbf, &server_cbf);
+    ExpectIntEQ(client_cbf.return_code, TEST_SUCCESS);
+    ExpectIntEQ(server_cbf.return_code, TEST_SUCCESS);
+
+    return EXPECT_RESULT();
+}
+#endif
+
+int test_wolfSSL_UseKTLS_connection(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_KTLS) && defined(HAVE_IO_TESTS_DEPENDENCIES)
+#ifdef WOLFSSL_TLS13
+    ExpectIntEQ(test_ktls_connection(wolfTLSv1_3_client_method,
+        wolfTLSv1_3_server_method), TEST_SUCCESS);
+#endif
+#ifndef WOLFSSL_NO_TLS12
+    ExpectIntEQ(test_ktls_connection(wolfTLSv1_2_client_method,
+        wolfTLSv1_2_server_method), TEST_SUCCESS);
+#endif
+#endif
+    return EXPECT_RESULT();
+}
@@ -456,8 +456,8 @@ int test_wc_LmsKey_reload_devid(void)
 }
 
 #if defined(WOLFSSL_HAVE_XMSS) && !defined(WOLFSSL_XMSS_VERIFY_ONLY) && \
-    defined(WOLF_CRYPTO_CB) && !defined(NO_FILESYSTEM) && \
-    defined(TEST_XMSS_H10_AVAILABLE)
+    (defined(WOLF_CRYPTO_CB) || defined(WOLFSSL_LMS_XMSS_THREADS)) && \
+    !defined(NO_FILESYSTEM) && defined(TEST_XMSS_H10_AVAILABLE)
 /* Per-process temp file so parallel unit.test runs sharing /tmp do not
  * clobber each other's stateful XMSS private key. */
 static const char* xmss_devid_priv_key_file(void)
@@ -590,6 +590,206 @@ int test_wc_XmssKey_reload_devid(void)
     return EXPECT_RESULT();
 }
 
+#if defined(WOLFSSL_HAVE_LMS) && !defined(WOLFSSL_LMS_VERIFY_ONLY) && \
+    defined(WOLFSSL_LMS_XMSS_THREADS)
+/* Helper: init an LMS key with callbacks and the given params */
+static int test_lms_threads_init_key(LmsKey* key, int levels, int height,
+    int winternitz)
+{
+    int ret = wc_LmsKey_Init(key, NULL, INVALID_DEVID);
+    if (ret == 0)
+        ret = wc_LmsKey_SetParameters(key, levels, height, winternitz);
+    if (ret == 0)
+        ret = wc_LmsKey_SetWriteCb(key, test_lms_write_key);
+    if (ret == 0)
+        ret = wc_LmsKey_SetReadCb(key, test_lms_read_key);
+    if (ret == 0)
+        ret = wc_LmsKey_SetContext(key, (void*)LMS_TEST_PRIV_KEY_FILE);
+    return ret;
+}
+
+/* Helper: make a key on threads, then reload the same private key on one
+ * thread and on threads - the signatures must be identical and verify. */
+static int test_lms_threads_one(int levels, int height, int winternitz)
+{
+    EXPECT_DECLS;
+    LmsKey  key;
+    LmsKey  vkey;
+    WC_RNG  rng;
+    byte    msg[] = "test message for LMS signing";
+    byte*   sig = NULL;
+    byte*   sigThr = NULL;
+    word32  sigLen = 0;
+    word32  sigSz = 0;
+    word32  sigThrSz = 0;
+    byte    pub[64];
+    word32  pubSz = sizeof(pub);
+    byte    priv[256];
+    word32  privSz = 0;
+
+    XMEMSET(&key, 0, sizeof(key));
+    XMEMSET(&vkey, 0, sizeof(vkey));
+    XMEMSET(&rng, 0, sizeof(rng));
+
+    ExpectIntEQ(wc_InitRng(&rng), 0);
+
+    /* Make key using multiple threads. */
+    (void)remove(LMS_TEST_PRIV_KEY_FILE);
+    ExpectIntEQ(test_lms_threads_init_key(&key, levels, height, winternitz),
+        0);
+    ExpectIntEQ(wc_LmsKey_GetSigLen(&key, &sigLen), 0);
+    ExpectNotNull(sig = (byte*)XMALLOC(sigLen, NULL, DYNAMIC_TYPE_TMP_BUFFER));
+    ExpectNotNull(sigThr = (byte*)XMALLOC(sigLen, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER));
+    ExpectIntEQ(wc_LmsKey_SetThreads(&key, 4), 0);
+    ExpectIntEQ(wc_LmsKey_MakeKey(&key, &rng), 0);
+    ExpectIntEQ(wc_LmsKey_SetThreads(&key, 2), WC_NO_ERR_TRACE(BAD_STATE_E));
+    ExpectIntEQ(wc_LmsKey_ExportPubRaw(&key, pub, &pubSz), 0);
+    sigSz = sigLen;
+    ExpectIntEQ(wc_LmsKey_Sign(&key, sig, &sigSz, msg, sizeof(msg)), 0);
+    ExpectIntEQ(wc_LmsKey_Verify(&key, sig, sigSz, msg, sizeof(msg)), 0);
+    ExpectIntEQ(wc_LmsKey_GetPrivLen(&key, &privSz), 0);
+    ExpectIntLE(privSz, sizeof(priv));
+    wc_LmsKey_Free(&key);
+
+    /* Keep the stored private key to reload it a second time. */
+    ExpectIntEQ(test_lms_read_key(priv, privSz,
+        (void*)LMS_TEST_PRIV_KEY_FILE), WC_LMS_RC_READ_TO_MEMORY);
+
+    /* Reload and sign on one thread. */
+    ExpectIntEQ(test_lms_threads_init_key(&key, levels, height, winternitz),
+        0);
+    ExpectIntEQ(wc_LmsKey_Reload(&key), 0);
+    sigSz = sigLen;
+    ExpectIntEQ(wc_LmsKey_Sign(&key, sig, &sigSz, msg, sizeof(msg)), 0);
+    wc_LmsKey_Free(&key);
+
+    /* Reload the same private key and sign on multiple threads. */
+    ExpectIntEQ(test_lms_write_key(priv, privSz,
+        (void*)LMS_TEST_PRIV_KEY_FILE), WC_LMS_RC_SAVED_TO_NV_MEMORY);
+    ExpectIntEQ(test_lms_threads_init_key(&key, levels, height, winternitz),
+        0);
+    ExpectIntEQ(wc_LmsKey_SetThreads(&key, 4), 0);
+    ExpectIntEQ(wc_LmsKey_Reload(&key), 0);
+    sigThrSz = sigLen;
+    ExpectIntEQ(wc_LmsKey_Sign(&key, sigThr, &sigThrSz, msg, sizeof(msg)), 0);
+    ExpectIntEQ(sigThrSz, sigSz);
+    ExpectBufEQ(sigThr, sig, sigSz);
+    wc_LmsKey_Free(&key);
+
+    /* Signature verifies against public key from threaded key generation. */
+    ExpectIntEQ(wc_LmsKey_Init(&vkey, NULL, INVALID_DEVID), 0);
+    ExpectIntEQ(wc_LmsKey_SetParameters(&vkey, levels, height, winternitz),
+        0);
+    ExpectIntEQ(wc_LmsKey_ImportPubRaw(&vkey, pub, pubSz), 0);
+    ExpectIntEQ(wc_LmsKey_Verify(&vkey, sigThr, sigThrSz, msg, sizeof(msg)),
+        0);
+    wc_LmsKey_Free(&vkey);
+
+    XFREE(sigThr, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(sig, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    wc_FreeRng(&rng);
+    (void)remove(LMS_TEST_PRIV_KEY_FILE);
+    return EXPECT_RESULT();
+}
+#endif
+
+/*
+ * Test computing LMS tree leaves on multiple threads.
+ *
+ * Keys made and reloaded with threads give the same signatures as on one
+ * thread.
+ */
+int test_wc_LmsKey_threads(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_HAVE_LMS) && !defined(WOLFSSL_LMS_VERIFY_ONLY) && \
+    defined(WOLFSSL_LMS_XMSS_THREADS)
+    LmsKey key;
+
+    XMEMSET(&key, 0, sizeof(key));
+
+    /* Bad parameters. */
+    ExpectIntEQ(wc_LmsKey_SetThreads(NULL, 1), WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_LmsKey_Init(&key, NULL, INVALID_DEVID), 0);
+    ExpectIntEQ(wc_LmsKey_SetThreads(&key, 0), WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_LmsKey_SetThreads(&key, WC_LMS_MAX_THREADS + 1),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_LmsKey_SetThreads(&key, 1), 0);
+    ExpectIntEQ(wc_LmsKey_SetThreads(&key, WC_LMS_MAX_THREADS), 0);
+    wc_LmsKey_Free(&key);
+
+#if !defined(WOLFSSL_LMS_MAX_HEIGHT) || (WOLFSSL_LMS_MAX_HEIGHT >= 10)
+    ExpectIntEQ(test_lms_threads_one(1, 10, 2), TEST_SUCCESS);
+#else
+    ExpectIntEQ(test_lms_threads_one(1, 5, 2), TEST_SUCCESS);
+#endif
+#if !defined(WOLFSSL_LMS_MAX_LEVELS) || (WOLFSSL_LMS_MAX_LEVELS >= 2)
+    /* Reload of multiple levels computes next subtree. */
+    ExpectIntEQ(test_lms_threads_one(2, 5, 2), TEST_SUCCESS);
+#endif
+#endif
+    return EXPECT_RESULT();
+}
+
+/*
+ * Test making an XMSS key with tree leaves computed on multiple threads.
+ */
+int test_wc_XmssKey_threads(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_HAVE_XMSS) && !defined(WOLFSSL_XMSS_VERIFY_ONLY) && \
+    defined(WOLFSSL_LMS_XMSS_THREADS) && !defined(NO_FILESYSTEM) && \
+    defined(TEST_XMSS_H10_AVAILABLE)
+    XmssKey key;
+    XmssKey vkey;
+    WC_RNG  rng;
+    byte    msg[] = "test message for XMSS signing";
+    byte    sig[4096];
+    word32  sigSz;
+    byte    pub[128];
+    word32  pubSz = sizeof(pub);
+    int     i;
+
+    XMEMSET(&key, 0, sizeof(key));
+    XMEMSET(&vkey, 0, sizeof(vkey));
+    XMEMSET(&rng, 0, sizeof(rng));
+
+    ExpectIntEQ(wc_InitRng(&rng), 0);
+
+    /* Bad parameters. */
+    ExpectIntEQ(wc_XmssKey_SetThreads(NULL, 1), WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+
+    (void)remove(XMSS_DEVID_TEST_PRIV_KEY_FILE);
+    ExpectIntEQ(test_xmss_init_key_ex(&key, INVALID_DEVID), 0);
+    ExpectIntEQ(wc_XmssKey_SetThreads(&key, 0), WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_XmssKey_SetThreads(&key, WC_XMSS_MAX_THREADS + 1),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_XmssKey_SetThreads(&key, 4), 0);
+    ExpectIntEQ(wc_XmssKey_MakeKey(&key, &rng), 0);
+    ExpectIntEQ(wc_XmssKey_SetThreads(&key, 2), WC_NO_ERR_TRACE(BAD_STATE_E));
+    ExpectIntEQ(wc_XmssKey_ExportPubRaw(&key, pub, &pubSz), 0);
+
+    ExpectIntEQ(wc_XmssKey_Init(&vkey, NULL, INVALID_DEVID), 0);
+    ExpectIntEQ(wc_XmssKey_SetParamStr(&vkey, "XMSS-SHA2_10_256"), 0);
+    ExpectIntEQ(wc_XmssKey_ImportPubRaw(&vkey, pub, pubSz), 0);
+
+    /* Authentication paths come from the tree computed on threads. */
+    for (i = 0; i < 5; i++) {
+        sigSz = sizeof(sig);
+        ExpectIntEQ(wc_XmssKey_Sign(&key, sig, &sigSz, msg, sizeof(msg)), 0);
+        ExpectIntEQ(wc_XmssKey_Verify(&vkey, sig, sigSz, msg, sizeof(msg)),
+            0);
+    }
+
+    wc_XmssKey_Free(&vkey);
+    wc_XmssKey_Free(&key);
+    wc_FreeRng(&rng);
+    (void)remove(XMSS_DEVID_TEST_PRIV_KEY_FILE);
+#endif
+    return EXPECT_RESULT();
+}
+
 /*----------------------------------------------------------------------------*/
 /* RFC 9802 (HSS/LMS and XMSS/XMSS^MT in X.509) tests                         */
 /*----------------------------------------------------------------------------*/
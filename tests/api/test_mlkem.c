@@ -4648,3 +4648,150 @@ int test_wc_mlkem_encode_key_len_decision(void)
 #endif
     return EXPECT_RESULT();
 } /* END test_wc_mlkem_encode_key_len_decision */
+
+/* Batched encapsulation and decapsulation must give the same cipher texts
+ * and shared secrets as one key at a time, across batch boundaries. */
+int test_wc_mlkem_batch(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_MLKEM_BATCH) && !defined(WOLFSSL_MLKEM_NO_MAKE_KEY) && \
+    !defined(WOLFSSL_MLKEM_NO_ENCAPSULATE) && \
+    !defined(WOLFSSL_MLKEM_NO_DECAPSULATE)
+    /* More than WC_ML_KEM_BATCH_SZ so the keys are split. */
+    #define MLKEM_BATCH_TEST_CNT    (WC_ML_KEM_BATCH_SZ + 5)
+    static const int types[] = {
+    #ifndef WOLFSSL_NO_ML_KEM_512
+        WC_ML_KEM_512,
+    #endif
+    #ifndef WOLFSSL_NO_ML_KEM_768
+        WC_ML_KEM_768,
+    #endif
+    #ifndef WOLFSSL_NO_ML_KEM_1024
+        WC_ML_KEM_1024,
+    #endif
+    };
+    MlKemKey* keys = NULL;
+    MlKemKey* key[MLKEM_BATCH_TEST_CNT];
+    WC_RNG rng;
+    byte* buf = NULL;
+    byte* ct[MLKEM_BATCH_TEST_CNT];
+    byte* ss[MLKEM_BATCH_TEST_CNT];
+    byte* ssDec[MLKEM_BATCH_TEST_CNT];
+    const byte* ctIn[MLKEM_BATCH_TEST_CNT];
+    const byte* rand[MLKEM_BATCH_TEST_CNT];
+    word32 len[MLKEM_BATCH_TEST_CNT];
+    byte m[MLKEM_BATCH_TEST_CNT][WC_ML_KEM_ENC_RAND_SZ];
+    byte ctOne[WC_ML_KEM_MAX_CIPHER_TEXT_SIZE];
+    byte ssOne[WC_ML_KEM_SS_SZ];
+    word32 ctLen = 0;
+    size_t t;
+    int i;
+    int inited = 0;
+
+    XMEMSET(&rng, 0, sizeof(rng));
+    ExpectIntEQ(wc_InitRng(&rng), 0);
+    ExpectNotNull(keys = (MlKemKey*)XMALLOC(sizeof(MlKemKey) *
+        MLKEM_BATCH_TEST_CNT, NULL, DYNAMIC_TYPE_TMP_BUFFER));
+    ExpectNotNull(buf = (byte*)XMALLOC(MLKEM_BATCH_TEST_CNT *
+        (WC_ML_KEM_MAX_CIPHER_TEXT_SIZE + 2 * WC_ML_KEM_SS_SZ), NULL,
+        DYNAMIC_TYPE_TMP_BUFFER));
+
+    for (i = 0; (buf != NULL) && (i < MLKEM_BATCH_TEST_CNT); i++) {
+        key[i] = &keys[i];
+        ct[i] = buf + i * WC_ML_KEM_MAX_CIPHER_TEXT_SIZE;
+        ss[i] = buf + MLKEM_BATCH_TEST_CNT * WC_ML_KEM_MAX_CIPHER_TEXT_SIZE +
+            i * WC_ML_KEM_SS_SZ;
+        ssDec[i] = ss[i] + MLKEM_BATCH_TEST_CNT * WC_ML_KEM_SS_SZ;
+        ctIn[i] = ct[i];
+        XMEMSET(m[i], (byte)(0x11 * (i + 1)), sizeof(m[i]));
+        rand[i] = m[i];
+    }
+
+    for (t = 0; EXPECT_SUCCESS() && (t < sizeof(types) / sizeof(*types));
+            t++) {
+        for (i = 0; EXPECT_SUCCESS() && (i < MLKEM_BATCH_TEST_CNT); i++) {
+            /* Last key of a different type ends the run early. */
+            int type = ((i == MLKEM_BATCH_TEST_CNT - 2) &&
+                (sizeof(types) > sizeof(*types))) ?
+                types[(t + 1) % (sizeof(types) / sizeof(*types))] : types[t];
+            ExpectIntEQ(wc_MlKemKey_Init(key[i], type, NULL, INVALID_DEVID),
+                0);
+            inited = i + 1;
+            ExpectIntEQ(wc_MlKemKey_MakeKey(key[i], &rng), 0);
+            ExpectIntEQ(wc_MlKemKey_CipherTextSize(key[i], &len[i]), 0);
+        }
+
+        /* Same cipher texts and secrets as one key at a time. */
+        ExpectIntEQ(wc_MlKemKey_EncapsulateBatchWithRandom(key, ct, ss, rand,
+            MLKEM_BATCH_TEST_CNT), 0);
+        for (i = 0; EXPECT_SUCCESS() && (i < MLKEM_BATCH_TEST_CNT); i++) {
+            ExpectIntEQ(wc_MlKemKey_EncapsulateWithRandom(key[i], ctOne, ssOne,
+                m[i], WC_ML_KEM_ENC_RAND_SZ), 0);
+            ExpectBufEQ(ct[i], ctOne, len[i]);
+            ExpectBufEQ(ss[i], ssOne, WC_ML_KEM_SS_SZ);
+        }
+
+        /* Decapsulating the batch recovers the secrets. */
+        PRIVATE_KEY_UNLOCK();
+        ExpectIntEQ(wc_MlKemKey_DecapsulateBatch(key, ssDec, ctIn, len,
+            MLKEM_BATCH_TEST_CNT), 0);
+        PRIVATE_KEY_LOCK();
+        for (i = 0; EXPECT_SUCCESS() && (i < MLKEM_BATCH_TEST_CNT); i++) {
+            ExpectBufEQ(ssDec[i], ss[i], WC_ML_KEM_SS_SZ);
+        }
+
+        /* A tampered cipher text is implicitly rejected as it is alone. */
+        ct[1][32] ^= 0x01;
+        PRIVATE_KEY_UNLOCK();
+        ExpectIntEQ(wc_MlKemKey_DecapsulateBatch(key, ssDec, ctIn, len,
+            MLKEM_BATCH_TEST_CNT), 0);
+        ExpectIntEQ(wc_MlKemKey_Decapsulate(key[1], ssOne, ct[1], len[1]), 0);
+        PRIVATE_KEY_LOCK();
+        ExpectBufNE(ssDec[1], ss[1], WC_ML_KEM_SS_SZ);
+        ExpectBufEQ(ssDec[1], ssOne, WC_ML_KEM_SS_SZ);
+        ExpectBufEQ(ssDec[0], ss[0], WC_ML_KEM_SS_SZ);
+        ExpectBufEQ(ssDec[2], ss[2], WC_ML_KEM_SS_SZ);
+
+        /* Random batch round trips. */
+        ExpectIntEQ(wc_MlKemKey_EncapsulateBatch(key, ct, ss, &rng,
+            MLKEM_BATCH_TEST_CNT), 0);
+        PRIVATE_KEY_UNLOCK();
+        for (i = 0; EXPECT_SUCCESS() && (i < MLKEM_BATCH_TEST_CNT); i++) {
+            ExpectIntEQ(wc_MlKemKey_Decapsulate(key[i], ssOne, ct[i], len[i]),
+                0);
+            ExpectBufEQ(ssOne, ss[i], WC_ML_KEM_SS_SZ);
+        }
+        PRIVATE_KEY_LOCK();
+
+        /* Bad arguments. */
+        ExpectIntEQ(wc_MlKemKey_EncapsulateBatch(NULL, ct, ss, &rng, 1),
+            WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+        ExpectIntEQ(wc_MlKemKey_EncapsulateBatch(key, ct, ss, NULL, 1),
+            WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+        ExpectIntEQ(wc_MlKemKey_EncapsulateBatchWithRandom(key, ct, ss, rand,
+            -1), WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+        ExpectIntEQ(wc_MlKemKey_DecapsulateBatch(key, ssDec, NULL, len, 1),
+            WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+        ExpectIntEQ(wc_MlKemKey_EncapsulateBatch(key, ct, ss, &rng, 0), 0);
+        len[0]--;
+        PRIVATE_KEY_UNLOCK();
+        ExpectIntEQ(wc_MlKemKey_DecapsulateBatch(key, ssDec, ctIn, len, 2),
+            WC_NO_ERR_TRACE(BUFFER_E));
+        PRIVATE_KEY_LOCK();
+
+        for (i = 0; i < inited; i++) {
+            wc_MlKemKey_Free(key[i]);
+        }
+        inited = 0;
+    }
+
+    for (i = 0; i < inited; i++) {
+        wc_MlKemKey_Free(key[i]);
+    }
+    XFREE(buf, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(keys, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    DoExpectIntEQ(wc_FreeRng(&rng), 0);
+    #undef MLKEM_BATCH_TEST_CNT
+#endif
+    return EXPECT_RESULT();
+} /* END test_wc_mlkem_batch */
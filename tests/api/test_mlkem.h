@@ -36,6 +36,7 @@ int test_wc_mlkem_init_id_decision(void);
 int test_wc_mlkem_init_label_decision(void);
 int test_wc_mlkem_encapsulate_pubkey_unset_decision(void);
 int test_wc_mlkem_encode_key_len_decision(void);
+int test_wc_mlkem_batch(void);
 
 #define TEST_MLKEM_DECLS                                                \
     TEST_DECL_GROUP("mlkem", test_wc_mlkem_make_key_kats),              \
@@ -49,6 +50,7 @@ int test_wc_mlkem_encode_key_len_decision(void);
     TEST_DECL_GROUP("mlkem", test_wc_mlkem_init_id_decision),           \
     TEST_DECL_GROUP("mlkem", test_wc_mlkem_init_label_decision),        \
     TEST_DECL_GROUP("mlkem", test_wc_mlkem_encapsulate_pubkey_unset_decision), \
-    TEST_DECL_GROUP("mlkem", test_wc_mlkem_encode_key_len_decision)
+    TEST_DECL_GROUP("mlkem", test_wc_mlkem_encode_key_len_decision),   \
+    TEST_DECL_GROUP("mlkem", test_wc_mlkem_batch)
 
 #endif /* WOLFCRYPT_TEST_MLKEM_H */
@@ -2044,6 +2044,204 @@ int test_ocsp_ctx_request_cache(void)
 }
 #endif
 
+#if defined(WOLFSSL_OCSP_STAPLE_CACHE) && \
+    defined(HAVE_CERTIFICATE_STATUS_REQUEST) && \
+    defined(HAVE_TLS_EXTENSIONS) && !defined(NO_WOLFSSL_SERVER) &&    \
+    defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES) &&                  \
+    !defined(WOLFSSL_NO_TLS12) && !defined(WOLFSSL_COPY_CERT) &&      \
+    !defined(NO_FILESYSTEM) && !defined(NO_RSA) && !defined(NO_SHA)
+
+/* Number of times the responder was asked. Atomic as the background refresh
+ * calls in from its own thread. */
+static wolfSSL_Atomic_Int test_ocsp_staple_cache_cb_cnt;
+
+/* Stands in for the responder, answering every request with the canned good
+ * response for server1. */
+static int test_ocsp_staple_cache_io_cb(void* ioCtx, const char* url,
+    int urlSz, unsigned char* req, int reqSz, unsigned char** respBuf)
+{
+    (void)ioCtx;
+    (void)url;
+    (void)urlSz;
+    (void)req;
+    (void)reqSz;
+
+    (void)wolfSSL_Atomic_Int_FetchAdd(&test_ocsp_staple_cache_cb_cnt, 1);
+
+    *respBuf = (unsigned char*)resp_server1_cert;
+    return (int)sizeof(resp_server1_cert);
+}
+
+static int test_ocsp_staple_cache_server_ctx(WOLFSSL_CTX* ctx_s)
+{
+    EXPECT_DECLS;
+
+    ExpectIntEQ(wolfSSL_CTX_use_certificate_chain_file(ctx_s,
+        "./certs/ocsp/server1-chain-noroot.pem"), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_use_PrivateKey_file(ctx_s,
+        "./certs/ocsp/server1-key.pem", WOLFSSL_FILETYPE_PEM),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_load_verify_locations(ctx_s,
+        "./certs/ocsp/root-ca-cert.pem", NULL), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_load_verify_locations(ctx_s,
+        "./certs/ocsp/intermediate1-ca-cert.pem", NULL), WOLFSSL_SUCCESS);
+
+    /* Cache can't be enabled before stapling is. */
+    ExpectIntEQ(wolfSSL_CTX_EnableOCSPStapleCache(ctx_s, 4),
+        WC_NO_ERR_TRACE(BAD_STATE_E));
+
+    ExpectIntEQ(wolfSSL_CTX_EnableOCSPStapling(ctx_s), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_SetOCSP_OverrideURL(ctx_s, "http://dummy.test"),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_EnableOCSP(ctx_s,
+        WOLFSSL_OCSP_NO_NONCE | WOLFSSL_OCSP_URL_OVERRIDE), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_SetOCSP_Cb(ctx_s,
+        test_ocsp_staple_cache_io_cb, NULL, NULL), WOLFSSL_SUCCESS);
+
+    /* Tracks server1 and its intermediate. */
+    ExpectIntEQ(wolfSSL_CTX_EnableOCSPStapleCache(ctx_s, 4), WOLFSSL_SUCCESS);
+
+    return EXPECT_RESULT();
+}
+
+/* Runs a handshake that only completes when the server staples a good
+ * response. */
+static int test_ocsp_staple_cache_handshake(WOLFSSL_CTX* ctx_c,
+    WOLFSSL_CTX* ctx_s)
+{
+    EXPECT_DECLS;
+    WOLFSSL* ssl_c = NULL;
+    WOLFSSL* ssl_s = NULL;
+    struct test_memio_ctx test_ctx;
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    ExpectIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+        wolfTLSv1_2_client_method, wolfTLSv1_2_server_method), 0);
+    ExpectIntEQ(wolfSSL_UseOCSPStapling(ssl_c, WOLFSSL_CSR_OCSP, 0),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+
+    return EXPECT_RESULT();
+}
+
+/* Responses prefetched into the staple cache are stapled without the
+ * handshake going to the responder, and survive a save and restore into a new
+ * server context.
+ */
+int test_ocsp_staple_cache(void)
+{
+    EXPECT_DECLS;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_s = NULL;
+    WOLFSSL_CTX* ctx_s2 = NULL;
+    byte*        mem = NULL;
+    int          memSz = 0;
+    int          used = 0;
+    int          i;
+    struct test_memio_ctx test_ctx;
+
+    wolfSSL_Atomic_Int_Init(&test_ocsp_staple_cache_cb_cnt, 0);
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    ExpectIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, NULL, NULL,
+        wolfTLSv1_2_client_method, wolfTLSv1_2_server_method), 0);
+    ExpectIntEQ(wolfSSL_CTX_load_verify_locations(ctx_c,
+        "./certs/ocsp/root-ca-cert.pem", NULL), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_load_verify_locations(ctx_c,
+        "./certs/ocsp/intermediate1-ca-cert.pem", NULL), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_EnableOCSPStapling(ctx_c), WOLFSSL_SUCCESS);
+    /* Fail the handshake when nothing is stapled. */
+    ExpectIntEQ(wolfSSL_CTX_EnableOCSPMustStaple(ctx_c), WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_ocsp_staple_cache_server_ctx(ctx_s), TEST_SUCCESS);
+
+    ExpectIntEQ(wolfSSL_CTX_EnableOCSPStapleCache(NULL, 4),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_CTX_OCSPStapleCacheRefresh(NULL, 0),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+
+    /* Nothing fetched yet, so nothing to save beyond the header. */
+    ExpectIntGT(memSz = wolfSSL_CTX_get_ocsp_staple_cache_memsize(ctx_s), 0);
+
+    /* One fetch per certificate. Only server1's response matches, the
+     * intermediate's request gets server1's response and is rejected. */
+    ExpectIntEQ(wolfSSL_CTX_OCSPStapleCacheRefresh(ctx_s, 0), 1);
+    ExpectIntEQ(WOLFSSL_ATOMIC_LOAD(test_ocsp_staple_cache_cb_cnt), 2);
+
+    /* The responder is not asked during handshakes. */
+    for (i = 0; i < 2 && EXPECT_SUCCESS(); i++) {
+        ExpectIntEQ(test_ocsp_staple_cache_handshake(ctx_c, ctx_s),
+            TEST_SUCCESS);
+    }
+    ExpectIntEQ(WOLFSSL_ATOMIC_LOAD(test_ocsp_staple_cache_cb_cnt), 2);
+
+    /* A forced refresh fetches again. */
+    ExpectIntEQ(wolfSSL_CTX_OCSPStapleCacheRefresh(ctx_s, 1), 1);
+    ExpectIntEQ(WOLFSSL_ATOMIC_LOAD(test_ocsp_staple_cache_cb_cnt), 4);
+
+    /* Save only holds what was fetched. */
+    ExpectIntGT(memSz = wolfSSL_CTX_get_ocsp_staple_cache_memsize(ctx_s),
+        (int)sizeof(resp_server1_cert));
+    ExpectNotNull(mem = (byte*)XMALLOC((size_t)memSz, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER));
+    ExpectIntEQ(wolfSSL_CTX_memsave_ocsp_staple_cache(ctx_s, mem, memSz - 1,
+        &used), WC_NO_ERR_TRACE(BUFFER_E));
+    ExpectIntEQ(wolfSSL_CTX_memsave_ocsp_staple_cache(ctx_s, mem, memSz,
+        &used), WOLFSSL_SUCCESS);
+    ExpectIntEQ(used, memSz);
+
+    /* A new server restores the responses and staples them straight away. */
+    ExpectIntEQ(test_memio_setup(&test_ctx, NULL, &ctx_s2, NULL, NULL,
+        wolfTLSv1_2_client_method, wolfTLSv1_2_server_method), 0);
+    ExpectIntEQ(test_ocsp_staple_cache_server_ctx(ctx_s2), TEST_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_memrestore_ocsp_staple_cache(ctx_s2, mem,
+        used - 1), WC_NO_ERR_TRACE(BUFFER_E));
+    ExpectIntEQ(wolfSSL_CTX_memrestore_ocsp_staple_cache(ctx_s2, mem, used),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_get_ocsp_staple_cache_memsize(ctx_s2), used);
+    wolfSSL_Atomic_Int_Init(&test_ocsp_staple_cache_cb_cnt, 0);
+    ExpectIntEQ(test_ocsp_staple_cache_handshake(ctx_c, ctx_s2),
+        TEST_SUCCESS);
+    ExpectIntEQ(WOLFSSL_ATOMIC_LOAD(test_ocsp_staple_cache_cb_cnt), 0);
+
+#if defined(WOLFSSL_PTHREADS) && !defined(SINGLE_THREADED)
+    /* The background refresh fetches straight away on starting. */
+    ExpectIntEQ(wolfSSL_CTX_StartOCSPStapleRefresh(ctx_s2, 0),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_CTX_StartOCSPStapleRefresh(ctx_s2, 3600),
+        WOLFSSL_SUCCESS);
+    for (i = 0; i < 500 &&
+            WOLFSSL_ATOMIC_LOAD(test_ocsp_staple_cache_cb_cnt) < 2; i++) {
+        XSLEEP_MS(10);
+    }
+    ExpectIntEQ(wolfSSL_CTX_StopOCSPStapleRefresh(ctx_s2), WOLFSSL_SUCCESS);
+    ExpectIntEQ(WOLFSSL_ATOMIC_LOAD(test_ocsp_staple_cache_cb_cnt), 2);
+    /* Stopping twice is harmless. */
+    ExpectIntEQ(wolfSSL_CTX_StopOCSPStapleRefresh(ctx_s2), WOLFSSL_SUCCESS);
+    ExpectIntEQ(test_ocsp_staple_cache_handshake(ctx_c, ctx_s2),
+        TEST_SUCCESS);
+    ExpectIntEQ(WOLFSSL_ATOMIC_LOAD(test_ocsp_staple_cache_cb_cnt), 2);
+    /* Left running - freeing the context stops it. */
+    ExpectIntEQ(wolfSSL_CTX_StartOCSPStapleRefresh(ctx_s2, 3600),
+        WOLFSSL_SUCCESS);
+#endif
+
+    XFREE(mem, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+    wolfSSL_CTX_free(ctx_s2);
+
+    return EXPECT_RESULT();
+}
+#else
+int test_ocsp_staple_cache(void)
+{
+    return TEST_SKIPPED;
+}
+#endif
+
 #if defined(HAVE_OCSP_RESPONDER) && defined(WOLFSSL_ASN_TEMPLATE) && \
     !defined(NO_SHA) && !defined(NO_RSA)
 /* Structure to hold test configuration */
@@ -36,6 +36,7 @@ int test_ocsp_cert_unknown_crl_fallback_nonleaf(void);
 int test_ocsp_no_url_policy(void);
 int test_tls13_nonblock_ocsp_low_mfl(void);
 int test_ocsp_ctx_request_cache(void);
+int test_ocsp_staple_cache(void);
 int test_ocsp_responder(void);
 int test_ocsp_ancestor_responder_rejected(void);
 int test_wolfIO_DecodeUrl_crlf_reject(void);
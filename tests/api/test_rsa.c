@@ -381,6 +381,120 @@ int test_wc_MakeRsaKey(void)
     return EXPECT_RESULT();
 } /* END test_wc_MakeRsaKey */
 
+/*
+ * Testing wc_MakeRsaKeyMultiPrime() and use of multi-prime keys
+ */
+int test_wc_MakeRsaKeyMultiPrime(void)
+{
+    EXPECT_DECLS;
+#if !defined(NO_RSA) && defined(WOLFSSL_KEY_GEN) && \
+    defined(WOLFSSL_RSA_MULTI_PRIME)
+    RsaKey key;
+    RsaKey decKey;
+    WC_RNG rng;
+    const byte msg[] = "Multi-prime RSA";
+    byte   sig[2048 / 8];
+    byte   plain[2048 / 8];
+    int    sigSz = 0;
+#if defined(WOLFSSL_KEY_TO_DER) && defined(WOLFSSL_ASN_TEMPLATE)
+    byte*  der = NULL;
+    byte*  der2 = NULL;
+    int    derSz = 0;
+    word32 idx = 0;
+#endif
+
+    XMEMSET(&key, 0, sizeof(RsaKey));
+    XMEMSET(&decKey, 0, sizeof(RsaKey));
+    XMEMSET(&rng, 0, sizeof(WC_RNG));
+
+    ExpectIntEQ(wc_InitRng(&rng), 0);
+    ExpectIntEQ(wc_InitRsaKey(&key, HEAP_HINT), 0);
+    ExpectIntEQ(wc_InitRsaKey(&decKey, HEAP_HINT), 0);
+
+    /* Test bad args. */
+    ExpectIntEQ(wc_MakeRsaKeyMultiPrime(NULL, 2048, WC_RSA_EXPONENT, 3, &rng),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_MakeRsaKeyMultiPrime(&key, 2048, WC_RSA_EXPONENT, 3, NULL),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_MakeRsaKeyMultiPrime(&key, 2048, WC_RSA_EXPONENT, 1, &rng),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_MakeRsaKeyMultiPrime(&key, 2048, 6, 3, &rng),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    /* Too many primes for the modulus size. */
+    ExpectIntEQ(wc_MakeRsaKeyMultiPrime(&key, 2048, WC_RSA_EXPONENT, 4, &rng),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+
+    ExpectIntEQ(wc_MakeRsaKeyMultiPrime(&key, 2048, WC_RSA_EXPONENT, 3, &rng),
+        0);
+    ExpectIntEQ(key.otherCnt, 1);
+    ExpectIntEQ(wc_RsaEncryptSize(&key), 2048 / 8);
+#ifdef WOLFSSL_RSA_KEY_CHECK
+    ExpectIntEQ(wc_CheckRsaKey(&key), 0);
+#endif
+#ifdef WC_RSA_BLINDING
+    ExpectIntEQ(wc_RsaSetRNG(&key, &rng), 0);
+#endif
+
+    /* Sign with the CRT over three primes and verify with the public key. */
+    ExpectIntGT(sigSz = wc_RsaSSL_Sign(msg, (word32)sizeof(msg), sig,
+        (word32)sizeof(sig), &key, &rng), 0);
+    ExpectIntEQ(wc_RsaSSL_Verify(sig, (word32)sigSz, plain,
+        (word32)sizeof(plain), &key), (int)sizeof(msg));
+    ExpectIntEQ(XMEMCMP(plain, msg, sizeof(msg)), 0);
+
+    /* Encrypt with the public key and decrypt with the CRT. */
+    ExpectIntEQ(wc_RsaPublicEncrypt(msg, (word32)sizeof(msg), sig,
+        (word32)sizeof(sig), &key, &rng), (int)sizeof(sig));
+    ExpectIntEQ(wc_RsaPrivateDecrypt(sig, (word32)sizeof(sig), plain,
+        (word32)sizeof(plain), &key), (int)sizeof(msg));
+    ExpectIntEQ(XMEMCMP(plain, msg, sizeof(msg)), 0);
+
+#if defined(WOLFSSL_KEY_TO_DER) && defined(WOLFSSL_ASN_TEMPLATE)
+    /* Version 1 RSAPrivateKey with OtherPrimeInfos round trips. */
+    ExpectIntGT(derSz = wc_RsaKeyToDer(&key, NULL, 0), 0);
+    ExpectNotNull(der = (byte*)XMALLOC((size_t)derSz, HEAP_HINT,
+        DYNAMIC_TYPE_TMP_BUFFER));
+    ExpectNotNull(der2 = (byte*)XMALLOC((size_t)derSz, HEAP_HINT,
+        DYNAMIC_TYPE_TMP_BUFFER));
+    ExpectIntEQ(wc_RsaKeyToDer(&key, der, (word32)derSz), derSz);
+    ExpectIntEQ(wc_RsaPrivateKeyDecode(der, &idx, &decKey, (word32)derSz), 0);
+    ExpectIntEQ(idx, (word32)derSz);
+    ExpectIntEQ(decKey.otherCnt, 1);
+    ExpectIntEQ(wc_RsaKeyToDer(&decKey, der2, (word32)derSz), derSz);
+    if ((der != NULL) && (der2 != NULL)) {
+        ExpectIntEQ(XMEMCMP(der, der2, (size_t)derSz), 0);
+    }
+#ifdef WC_RSA_BLINDING
+    ExpectIntEQ(wc_RsaSetRNG(&decKey, &rng), 0);
+#endif
+    ExpectIntEQ(wc_RsaPrivateDecrypt(sig, (word32)sizeof(sig), plain,
+        (word32)sizeof(plain), &decKey), (int)sizeof(msg));
+    ExpectIntEQ(XMEMCMP(plain, msg, sizeof(msg)), 0);
+
+    /* Version 0 must not have other primes. */
+    DoExpectIntEQ(wc_FreeRsaKey(&decKey), 0);
+    ExpectIntEQ(wc_InitRsaKey(&decKey, HEAP_HINT), 0);
+    if (der != NULL) {
+        /* SEQUENCE header is 4 bytes for a 2048-bit key, then INTEGER 1. */
+        ExpectIntEQ(der[4], ASN_INTEGER);
+        ExpectIntEQ(der[6], PKCS1v1);
+        der[6] = PKCS1v0;
+    }
+    idx = 0;
+    ExpectIntEQ(wc_RsaPrivateKeyDecode(der, &idx, &decKey, (word32)derSz),
+        WC_NO_ERR_TRACE(ASN_PARSE_E));
+
+    XFREE(der2, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(der, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+
+    DoExpectIntEQ(wc_FreeRsaKey(&decKey), 0);
+    DoExpectIntEQ(wc_FreeRsaKey(&key), 0);
+    DoExpectIntEQ(wc_FreeRng(&rng), 0);
+#endif
+    return EXPECT_RESULT();
+} /* END test_wc_MakeRsaKeyMultiPrime */
+
 /*
  * Testing wc_CheckProbablePrime()
  */
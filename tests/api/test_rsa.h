@@ -30,6 +30,7 @@ int test_wc_RsaPublicKeyDecode(void);
 int test_wc_RsaPublicKeyDecodeRaw(void);
 int test_wc_RsaPrivateKeyDecodeRaw(void);
 int test_wc_MakeRsaKey(void);
+int test_wc_MakeRsaKeyMultiPrime(void);
 int test_wc_CheckProbablePrime(void);
 int test_wc_RsaPSS_Verify(void);
 int test_wc_RsaPSS_BadTerminator(void);
@@ -57,6 +58,7 @@ int test_wc_CryptoCb_RsaPssVerifyRecover(void);
     TEST_DECL_GROUP("rsa", test_wc_RsaPublicKeyDecodeRaw),      \
     TEST_DECL_GROUP("rsa", test_wc_RsaPrivateKeyDecodeRaw),     \
     TEST_DECL_GROUP("rsa", test_wc_MakeRsaKey),                 \
+    TEST_DECL_GROUP("rsa", test_wc_MakeRsaKeyMultiPrime),       \
     TEST_DECL_GROUP("rsa", test_wc_CheckProbablePrime),         \
     TEST_DECL_GROUP("rsa", test_wc_RsaPSS_Verify),              \
     TEST_DECL_GROUP("rsa", test_wc_RsaPSS_BadTerminator),       \
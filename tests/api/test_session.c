@@ -21,6 +21,14 @@
 
 #include <tests/unit.h>
 
+#if !defined(NO_SESSION_CACHE) && defined(SESSION_CACHE_SHARED_MEM) && \
+    (defined(__linux__) || defined(__FreeBSD__))
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#endif
+
 #ifdef NO_INLINE
     #include <wolfssl/wolfcrypt/misc.h>
 #else
@@ -1739,3 +1747,425 @@ int test_wolfSSL_GetSessionAtIndex(void)
 
 #endif /* SESSION_INDEX && HAVE_SESSION_TICKET && !NO_SESSION_CACHE &&
         * !NO_WOLFSSL_CLIENT && !NO_TLS */
+
+/*----------------------------------------------------------------------------*/
+/* Session cache lock striping                                                */
+/*----------------------------------------------------------------------------*/
+
+int test_wolfSSL_SetSessionCacheLocks(void)
+{
+    EXPECT_DECLS;
+#ifndef NO_SESSION_CACHE
+    int locks = wolfSSL_GetSessionCacheLocks();
+
+    ExpectIntGE(locks, 1);
+    ExpectIntLE(locks, wolfSSL_GetSessionCacheLocksMax());
+
+    ExpectIntEQ(wolfSSL_SetSessionCacheLocks(0), WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_SetSessionCacheLocks(-1),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    /* Library is initialized - lock count can't change under the cache. */
+    ExpectIntEQ(wolfSSL_SetSessionCacheLocks(1), WC_NO_ERR_TRACE(BAD_STATE_E));
+    ExpectIntEQ(wolfSSL_GetSessionCacheLocks(), locks);
+
+    /* Walks every row taking its lock. */
+    wolfSSL_CTX_flush_sessions(NULL, 0);
+#endif
+    return EXPECT_RESULT();
+}
+
+int test_wolfSSL_set_session_cache_size(void)
+{
+    EXPECT_DECLS;
+#ifndef NO_SESSION_CACHE
+    long size = wolfSSL_get_session_cache_size();
+    long rows = 0;
+
+    ExpectIntGE(size, 1);
+    ExpectIntEQ(wolfSSL_set_session_cache_size(0),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_set_session_cache_size(-1),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_get_session_cache_size(), size);
+
+    /* One session per row at most. */
+    ExpectIntEQ(wolfSSL_set_session_cache_size(1), WOLFSSL_SUCCESS);
+    ExpectIntGE(rows = wolfSSL_get_session_cache_size(), 1);
+    ExpectIntLE(rows, size);
+
+#if !defined(NO_WOLFSSL_CLIENT) && !defined(NO_TLS)
+    {
+        WOLFSSL_CTX* ctx = NULL;
+        WOLFSSL_SESSION* sess = NULL;
+        byte id[ID_LEN];
+        int idx;
+        long i;
+
+        ExpectNotNull(ctx = wolfSSL_CTX_new(wolfSSLv23_client_method()));
+        ExpectNotNull(sess = wolfSSL_SESSION_new());
+        if (sess != NULL) {
+            sess->sessionIDSz = ID_LEN;
+            sess->side = WOLFSSL_CLIENT_END;
+            sess->isSetup = 1;
+        }
+        /* More sessions than rows - every one lands in the first column. */
+        for (i = 0; EXPECT_SUCCESS() && i <= rows; i++) {
+            XMEMSET(id, 0x30 + (int)i, sizeof(id));
+            XMEMCPY(sess->sessionID, id, ID_LEN);
+            idx = -1;
+            ExpectIntEQ(AddSessionToCache(ctx, sess, id, ID_LEN, &idx,
+                WOLFSSL_CLIENT_END, 1, NULL), 0);
+        #ifdef SESSION_INDEX
+            ExpectIntEQ(idx & SESSIDX_IDX_MASK, 0);
+        #endif
+        }
+        wolfSSL_SESSION_free(sess);
+        wolfSSL_CTX_free(ctx);
+    }
+#endif
+
+#if !defined(NO_WOLFSSL_CLIENT) && !defined(NO_TLS) && \
+    !defined(NO_CLIENT_CACHE)
+    {
+        WOLFSSL_CTX* ctx = NULL;
+        WOLFSSL* ssl = NULL;
+        WOLFSSL_SESSION* sess = NULL;
+        ClientSession* clSess = NULL;
+        static const byte serverId[] = "cache_size";
+        byte id[ID_LEN];
+
+        /* Client cache entry still finds the session once it has moved. */
+        ExpectNotNull(ctx = wolfSSL_CTX_new(wolfSSLv23_client_method()));
+        ExpectNotNull(sess = wolfSSL_SESSION_new());
+        if (sess != NULL) {
+            XMEMSET(id, 0x5a, sizeof(id));
+            XMEMCPY(sess->sessionID, id, ID_LEN);
+            sess->sessionIDSz = ID_LEN;
+            sess->side = WOLFSSL_CLIENT_END;
+            sess->isSetup = 1;
+            sess->bornOn = (word32)time(NULL);
+            sess->timeout = 500;
+            sess->idLen = (word16)sizeof(serverId);
+            XMEMCPY(sess->serverID, serverId, sizeof(serverId));
+        }
+        ExpectIntEQ(AddSessionToCache(ctx, sess, id, ID_LEN, NULL,
+            WOLFSSL_CLIENT_END, 1, &clSess), 0);
+        ExpectNotNull(clSess);
+        ExpectIntEQ(wolfSSL_set_session_cache_size(size), WOLFSSL_SUCCESS);
+        ExpectNotNull(ssl = wolfSSL_new(ctx));
+        ExpectIntEQ(wolfSSL_SetServerID(ssl, serverId, sizeof(serverId), 0),
+            WOLFSSL_SUCCESS);
+        if (ssl != NULL)
+            ExpectBufEQ(ssl->session->sessionID, id, ID_LEN);
+        wolfSSL_free(ssl);
+        wolfSSL_SESSION_free(sess);
+        wolfSSL_CTX_free(ctx);
+    }
+#endif
+
+    /* Grows back. Sessions that fit are kept. */
+    ExpectIntEQ(wolfSSL_set_session_cache_size(size), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_get_session_cache_size(), size);
+#ifdef OPENSSL_EXTRA
+    ExpectIntEQ(wolfSSL_CTX_sess_get_cache_size(NULL), size);
+    ExpectIntEQ(wolfSSL_CTX_sess_set_cache_size(NULL, size), 0);
+#endif
+#endif
+    return EXPECT_RESULT();
+}
+
+#if defined(OPENSSL_EXTRA) && !defined(NO_SESSION_CACHE) && \
+    !defined(NO_WOLFSSL_CLIENT) && !defined(NO_TLS)
+/* Add a client session with an ID made from id to the cache.
+ * Returns the session index it went into, 0 without SESSION_INDEX, or -1. */
+static int test_sess_cache_add(WOLFSSL_CTX* ctx, WOLFSSL_SESSION* sess,
+    word32 id)
+{
+    int idx = 0;
+
+    XMEMSET(sess->sessionID, 0, ID_LEN);
+    sess->sessionID[0] = (byte)id;
+    sess->sessionID[1] = (byte)(id >> 8);
+    if (AddSessionToCache(ctx, sess, sess->sessionID, ID_LEN, &idx,
+            WOLFSSL_CLIENT_END, 1, NULL) != 0) {
+        return -1;
+    }
+    return idx;
+}
+
+/* Returns 1 when a session with an ID made from id was in the cache. */
+static int test_sess_cache_remove(WOLFSSL_CTX* ctx, WOLFSSL_SESSION* sess,
+    word32 id)
+{
+    XMEMSET(sess->sessionID, 0, ID_LEN);
+    sess->sessionID[0] = (byte)id;
+    sess->sessionID[1] = (byte)(id >> 8);
+    return wolfSSL_SSL_CTX_remove_session(ctx, sess);
+}
+#endif
+
+int test_wolfSSL_CTX_sess_set_cache_size(void)
+{
+    EXPECT_DECLS;
+#if defined(OPENSSL_EXTRA) && !defined(NO_SESSION_CACHE) && \
+    !defined(NO_WOLFSSL_CLIENT) && !defined(NO_TLS)
+    WOLFSSL_CTX* ctx = NULL;
+    WOLFSSL_CTX* ctx2 = NULL;
+    WOLFSSL_SESSION* sess = NULL;
+    long size = wolfSSL_get_session_cache_size();
+    long now = (long)time(NULL);
+#ifdef SESSION_INDEX
+    word32 ids[32];
+    word32 used = 0;
+    int row = -1;
+    int cnt = 0;
+    int cols = 0;
+    int idx = -1;
+    int i;
+#endif
+
+    ExpectNotNull(ctx = wolfSSL_CTX_new(wolfSSLv23_client_method()));
+    ExpectNotNull(ctx2 = wolfSSL_CTX_new(wolfSSLv23_client_method()));
+    ExpectNotNull(sess = wolfSSL_SESSION_new());
+    if (sess != NULL) {
+        sess->sessionIDSz = ID_LEN;
+        sess->side = WOLFSSL_CLIENT_END;
+        sess->isSetup = 1;
+    }
+    /* Not expired - an expired entry is replaced before any other. */
+    ExpectIntEQ(wolfSSL_SESSION_set_time(sess, now), now);
+    ExpectIntEQ(wolfSSL_SSL_SESSION_set_timeout(sess, 500), SSL_SUCCESS);
+
+#ifdef SESSION_INDEX
+    /* Find IDs for the same row. */
+    for (i = 1; EXPECT_SUCCESS() && i < 0x10000 &&
+            cnt < (int)(sizeof(ids) / sizeof(*ids)); i++) {
+        ExpectIntGE(idx = test_sess_cache_add(ctx2, sess, (word32)i), 0);
+        ExpectIntEQ(test_sess_cache_remove(ctx2, sess, (word32)i), 1);
+        if (cnt == 0)
+            row = idx >> SESSIDX_ROW_SHIFT;
+        if ((idx >> SESSIDX_ROW_SHIFT) == row)
+            ids[cnt++] = (word32)i;
+    }
+    ExpectIntEQ(cnt, (int)(sizeof(ids) / sizeof(*ids)));
+
+    /* Columns in a row - the first one to be used again is the LRU. */
+    for (cols = 0; EXPECT_SUCCESS() && cols < cnt; cols++) {
+        ExpectIntGE(idx = test_sess_cache_add(ctx2, sess, ids[cols]), 0);
+        idx &= SESSIDX_IDX_MASK;
+        if ((used & ((word32)1 << idx)) != 0)
+            break;
+        used |= (word32)1 << idx;
+    }
+    ExpectIntLT(cols, cnt);
+    for (i = 0; EXPECT_SUCCESS() && i <= cols; i++)
+        ExpectIntEQ(test_sess_cache_remove(ctx2, sess, ids[i]), i != 0);
+
+    /* Least recently used entry of the row is replaced - not the oldest. */
+    for (i = 0; EXPECT_SUCCESS() && i < cols; i++) {
+        ExpectIntEQ(test_sess_cache_add(ctx2, sess, ids[i]) >>
+            SESSIDX_ROW_SHIFT, row);
+    }
+    ExpectIntGE(test_sess_cache_add(ctx2, sess, ids[0]), 0);
+    ExpectIntGE(test_sess_cache_add(ctx2, sess, ids[cols]), 0);
+    ExpectIntEQ(test_sess_cache_remove(ctx2, sess, ids[0]), cols > 1);
+    if (cols > 1)
+        ExpectIntEQ(test_sess_cache_remove(ctx2, sess, ids[1]), 0);
+    for (i = 2; EXPECT_SUCCESS() && i <= cols; i++)
+        ExpectIntEQ(test_sess_cache_remove(ctx2, sess, ids[i]), 1);
+    if (cols == 1)
+        ExpectIntEQ(test_sess_cache_remove(ctx2, sess, ids[1]), 1);
+#endif
+
+    /* No limit on a CTX by default - the cache size is reported. */
+    ExpectIntEQ(wolfSSL_CTX_sess_get_cache_size(ctx), size);
+    ExpectIntEQ(wolfSSL_CTX_sess_set_cache_size(ctx, -1), 0);
+    ExpectIntEQ(wolfSSL_CTX_sess_set_cache_size(NULL, 2), 0);
+    ExpectIntEQ(wolfSSL_CTX_sess_set_cache_size(ctx, 2), size);
+    ExpectIntEQ(wolfSSL_CTX_sess_get_cache_size(ctx), 2);
+    ExpectIntEQ(wolfSSL_CTX_sess_get_cache_size(ctx2), size);
+
+    /* Sessions ctx added first are evicted. Others' are left alone. */
+    ExpectIntGE(test_sess_cache_add(ctx2, sess, 0x10A0), 0);
+    ExpectIntGE(test_sess_cache_add(ctx, sess, 0x10A1), 0);
+    ExpectIntGE(test_sess_cache_add(ctx, sess, 0x10A2), 0);
+    ExpectIntGE(test_sess_cache_add(ctx, sess, 0x10A3), 0);
+    ExpectIntEQ(test_sess_cache_remove(ctx, sess, 0x10A1), 0);
+
+    /* Lowering the limit evicts straight away. */
+    ExpectIntEQ(wolfSSL_CTX_sess_set_cache_size(ctx, 1), 2);
+    ExpectIntEQ(test_sess_cache_remove(ctx, sess, 0x10A2), 0);
+    ExpectIntEQ(test_sess_cache_remove(ctx, sess, 0x10A3), 1);
+    ExpectIntEQ(test_sess_cache_remove(ctx2, sess, 0x10A0), 1);
+
+    /* 0 is no limit, as in OpenSSL. */
+    ExpectIntEQ(wolfSSL_CTX_sess_set_cache_size(ctx, 0), 1);
+    ExpectIntEQ(wolfSSL_CTX_sess_get_cache_size(ctx), size);
+    ExpectIntGE(test_sess_cache_add(ctx, sess, 0x10A4), 0);
+    ExpectIntGE(test_sess_cache_add(ctx, sess, 0x10A5), 0);
+    ExpectIntEQ(test_sess_cache_remove(ctx, sess, 0x10A4), 1);
+    ExpectIntEQ(test_sess_cache_remove(ctx, sess, 0x10A5), 1);
+    ExpectIntEQ(wolfSSL_get_session_cache_size(), size);
+
+    wolfSSL_SESSION_free(sess);
+    wolfSSL_CTX_free(ctx2);
+    wolfSSL_CTX_free(ctx);
+#endif
+    return EXPECT_RESULT();
+}
+
+int test_wolfSSL_set_session_cache_shared(void)
+{
+    EXPECT_DECLS;
+#if !defined(NO_SESSION_CACHE) && defined(SESSION_CACHE_SHARED_MEM)
+    byte* mem = NULL;
+    int sz = wolfSSL_get_session_cache_shared_memsize();
+
+    ExpectIntGT(sz, 0);
+    ExpectNotNull(mem = (byte*)XMALLOC((size_t)sz, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER));
+    if (mem != NULL)
+        XMEMSET(mem, 0, (size_t)sz);
+
+    /* Library is initialized - the cache can't move under the sessions. */
+    ExpectIntEQ(wolfSSL_set_session_cache_shared(mem, sz),
+        WC_NO_ERR_TRACE(BAD_STATE_E));
+    ExpectIntEQ(wolfSSL_set_session_cache_shared(NULL, 0),
+        WC_NO_ERR_TRACE(BAD_STATE_E));
+    /* Nothing was set up in the segment. */
+    ExpectIntEQ(mem != NULL ? mem[0] : 1, 0);
+
+    XFREE(mem, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#endif
+    return EXPECT_RESULT();
+}
+
+#if !defined(NO_SESSION_CACHE) && defined(SESSION_CACHE_SHARED_MEM) && \
+    (defined(__linux__) || defined(__FreeBSD__)) && \
+    !defined(WOLFSSL_NO_TLS12) && !defined(NO_WOLFSSL_CLIENT) && \
+    !defined(NO_WOLFSSL_SERVER) && !defined(NO_FILESYSTEM) && !defined(NO_RSA)
+/* Server process on the shared session cache in mem: accept one connection on
+ * fd. Returns 0 when the handshake resumed a session exactly when resume. */
+static int test_sess_shared_server(int fd, void* mem, int sz, int resume)
+{
+    WOLFSSL_CTX* ctx = NULL;
+    WOLFSSL* ssl = NULL;
+    int ret = 1;
+    int i;
+
+    /* Drop the copy of the library forked from the parent. */
+    for (i = 0; i < 16 && wolfSSL_set_session_cache_shared(mem, sz) ==
+            WC_NO_ERR_TRACE(BAD_STATE_E); i++) {
+        wolfSSL_Cleanup();
+    }
+    if (wolfSSL_Init() != WOLFSSL_SUCCESS)
+        return 1;
+
+    if ((ctx = wolfSSL_CTX_new(wolfTLSv1_2_server_method())) != NULL &&
+            wolfSSL_CTX_use_certificate_file(ctx, svrCertFile,
+                WOLFSSL_FILETYPE_PEM) == WOLFSSL_SUCCESS &&
+            wolfSSL_CTX_use_PrivateKey_file(ctx, svrKeyFile,
+                WOLFSSL_FILETYPE_PEM) == WOLFSSL_SUCCESS &&
+            (ssl = wolfSSL_new(ctx)) != NULL &&
+            wolfSSL_set_fd(ssl, fd) == WOLFSSL_SUCCESS &&
+            wolfSSL_accept(ssl) == WOLFSSL_SUCCESS &&
+            wolfSSL_session_reused(ssl) == resume) {
+        ret = 0;
+    }
+    if (ssl != NULL)
+        wolfSSL_shutdown(ssl);
+    wolfSSL_free(ssl);
+    wolfSSL_CTX_free(ctx);
+    wolfSSL_Cleanup();
+
+    return ret;
+}
+#endif
+
+int test_wolfSSL_session_cache_shared_fork(void)
+{
+    EXPECT_DECLS;
+#if !defined(NO_SESSION_CACHE) && defined(SESSION_CACHE_SHARED_MEM) && \
+    (defined(__linux__) || defined(__FreeBSD__)) && \
+    !defined(WOLFSSL_NO_TLS12) && !defined(NO_WOLFSSL_CLIENT) && \
+    !defined(NO_WOLFSSL_SERVER) && !defined(NO_FILESYSTEM) && !defined(NO_RSA)
+    WOLFSSL_CTX* ctx = NULL;
+    WOLFSSL* ssl = NULL;
+    WOLFSSL_SESSION* sess = NULL;
+    void* mem = MAP_FAILED;
+    int sz = wolfSSL_get_session_cache_shared_memsize();
+    int fds[2] = { -1, -1 };
+    int status = -1;
+    pid_t pid = -1;
+    int i;
+#ifdef WC_HAVE_ROBUST_MUTEX
+    wolfSSL_Mutex* m = NULL;
+    int ownerDied = 0;
+#endif
+
+    ExpectTrue((mem = mmap(NULL, (size_t)sz, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_ANONYMOUS, -1, 0)) != MAP_FAILED);
+    ExpectNotNull(ctx = wolfSSL_CTX_new(wolfTLSv1_2_client_method()));
+    wolfSSL_CTX_set_verify(ctx, WOLFSSL_VERIFY_NONE, NULL);
+
+    /* The first server process sets the segment up and caches the session,
+     * the second attaches to it and resumes the session. */
+    for (i = 0; EXPECT_SUCCESS() && i < 2; i++) {
+        ExpectIntEQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+        ExpectIntGE(pid = fork(), 0);
+        if (pid == 0) {
+            close(fds[0]);
+            exit(test_sess_shared_server(fds[1], mem, sz, i));
+        }
+        close(fds[1]);
+
+        ExpectNotNull(ssl = wolfSSL_new(ctx));
+        ExpectIntEQ(wolfSSL_set_fd(ssl, fds[0]), WOLFSSL_SUCCESS);
+        if (sess != NULL)
+            ExpectIntEQ(wolfSSL_set_session(ssl, sess), WOLFSSL_SUCCESS);
+        ExpectIntEQ(wolfSSL_connect(ssl), WOLFSSL_SUCCESS);
+        ExpectIntEQ(wolfSSL_session_reused(ssl), i);
+        if (sess == NULL)
+            ExpectNotNull(sess = wolfSSL_get1_session(ssl));
+        /* Wait for the server's close_notify before closing the socket. */
+        if (ssl != NULL && wolfSSL_shutdown(ssl) ==
+                WC_NO_ERR_TRACE(WOLFSSL_SHUTDOWN_NOT_DONE)) {
+            ExpectIntEQ(wolfSSL_shutdown(ssl), WOLFSSL_SUCCESS);
+        }
+        wolfSSL_free(ssl);
+        ssl = NULL;
+        close(fds[0]);
+
+        if (pid > 0)
+            ExpectIntEQ(waitpid(pid, &status, 0), pid);
+        ExpectTrue(WIFEXITED(status));
+        ExpectIntEQ(WEXITSTATUS(status), 0);
+    }
+
+#ifdef WC_HAVE_ROBUST_MUTEX
+    /* A lock held by a process that died is taken over. */
+    m = (wolfSSL_Mutex*)mem;
+    if (EXPECT_SUCCESS())
+        ExpectIntEQ(wc_InitMutexShared(m), 0);
+    ExpectIntGE(pid = fork(), 0);
+    if (pid == 0)
+        exit(wc_LockMutexShared(m, &ownerDied) == 0 ? 0 : 1);
+    if (pid > 0)
+        ExpectIntEQ(waitpid(pid, &status, 0), pid);
+    ExpectIntEQ(WEXITSTATUS(status), 0);
+    ExpectIntEQ(wc_LockMutexShared(m, &ownerDied), 0);
+    ExpectIntEQ(ownerDied, 1);
+    ExpectIntEQ(wc_UnLockMutex(m), 0);
+    ExpectIntEQ(wc_LockMutexShared(m, &ownerDied), 0);
+    ExpectIntEQ(ownerDied, 0);
+    ExpectIntEQ(wc_UnLockMutex(m), 0);
+    ExpectIntEQ(wc_FreeMutex(m), 0);
+#endif
+
+    wolfSSL_SESSION_free(sess);
+    wolfSSL_CTX_free(ctx);
+    if (mem != MAP_FAILED)
+        munmap(mem, (size_t)sz);
+#endif
+    return EXPECT_RESULT();
+}
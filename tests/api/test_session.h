@@ -37,6 +37,11 @@ int test_wolfSSL_CTX_sess_set_remove_cb(void);
 int test_wolfSSL_ticket_keys(void);
 int test_wolfSSL_SESSION_get_ex_new_index(void);
 int test_wolfSSL_GetSessionAtIndex(void);
+int test_wolfSSL_SetSessionCacheLocks(void);
+int test_wolfSSL_set_session_cache_size(void);
+int test_wolfSSL_CTX_sess_set_cache_size(void);
+int test_wolfSSL_set_session_cache_shared(void);
+int test_wolfSSL_session_cache_shared_fork(void);
 
 #define TEST_SESSION_DECLS                                                     \
     TEST_DECL_GROUP("session", test_wolfSSL_CTX_add_session),                  \
@@ -51,6 +56,11 @@ int test_wolfSSL_GetSessionAtIndex(void);
     TEST_DECL_GROUP("session", test_wolfSSL_CTX_sess_set_remove_cb),           \
     TEST_DECL_GROUP("session", test_wolfSSL_ticket_keys),                      \
     TEST_DECL_GROUP("session", test_wolfSSL_SESSION_get_ex_new_index),         \
-    TEST_DECL_GROUP("session", test_wolfSSL_GetSessionAtIndex)
+    TEST_DECL_GROUP("session", test_wolfSSL_GetSessionAtIndex),                \
+    TEST_DECL_GROUP("session", test_wolfSSL_SetSessionCacheLocks),             \
+    TEST_DECL_GROUP("session", test_wolfSSL_set_session_cache_size),           \
+    TEST_DECL_GROUP("session", test_wolfSSL_CTX_sess_set_cache_size),          \
+    TEST_DECL_GROUP("session", test_wolfSSL_set_session_cache_shared),         \
+    TEST_DECL_GROUP("session", test_wolfSSL_session_cache_shared_fork)
 
 #endif /* WOLFCRYPT_TEST_SESSION_H */
@@ -224,6 +224,74 @@ int test_wc_Sha256_Flags(void)
     return EXPECT_RESULT();
 }
 
+/* Batch of messages hashed in lanes matches hashing one at a time. */
+int test_wc_Sha256HashBatch(void)
+{
+    EXPECT_DECLS;
+#if !defined(NO_SHA256) && defined(WOLFSSL_SHA2_BATCH)
+    /* Lengths around the padding and block boundaries, more messages than
+     * lanes and a last chunk that leaves lanes unused. */
+    static const word32 lens[] = {
+        0, 1, 3, 55, 56, 63, 64, 65, 119, 120, 127, 128, 129, 200, 1000, 31,
+        32, 54, 57, 0, 300, 64, 192, 511, 2
+    };
+    const word32 cnt = (word32)(sizeof(lens) / sizeof(*lens));
+    byte msg[1000];
+    byte out[sizeof(lens) / sizeof(*lens)][WC_SHA256_DIGEST_SIZE];
+    byte expected[WC_SHA256_DIGEST_SIZE];
+    const byte* data[sizeof(lens) / sizeof(*lens)];
+    byte* hash[sizeof(lens) / sizeof(*lens)];
+    wc_Sha256 sha256;
+    word32 i;
+
+    for (i = 0; i < (word32)sizeof(msg); i++) {
+        msg[i] = (byte)(i * 7 + 3);
+    }
+    for (i = 0; i < cnt; i++) {
+        /* Different contents for messages of the same length. */
+        data[i] = msg + (i % 3) * (lens[i] < 990 ? 1 : 0);
+        hash[i] = out[i];
+    }
+    data[0] = NULL;
+
+    /* Bad parameters. */
+    ExpectIntEQ(wc_Sha256HashBatch(NULL, lens, hash, 1),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_Sha256HashBatch(data, NULL, hash, 1),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_Sha256HashBatch(data, lens, NULL, 1),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    /* Only an empty message may be NULL. */
+    data[19] = NULL;
+    ExpectIntEQ(wc_Sha256HashBatch(data + 19, lens + 19, hash, 1), 0);
+    data[20] = NULL;
+    ExpectIntEQ(wc_Sha256HashBatch(data + 19, lens + 19, hash, 2),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    data[20] = msg;
+    ExpectIntEQ(wc_Sha256HashBatch(NULL, NULL, NULL, 0), 0);
+
+    XMEMSET(out, 0, sizeof(out));
+    ExpectIntEQ(wc_Sha256HashBatch(data, lens, hash, cnt), 0);
+    for (i = 0; i < cnt; i++) {
+        ExpectIntEQ(wc_InitSha256(&sha256), 0);
+        ExpectIntEQ(wc_Sha256Update(&sha256, data[i], lens[i]), 0);
+        ExpectIntEQ(wc_Sha256Final(&sha256, expected), 0);
+        wc_Sha256Free(&sha256);
+        ExpectBufEQ(out[i], expected, WC_SHA256_DIGEST_SIZE);
+    }
+
+    /* Single message. */
+    XMEMSET(out, 0, sizeof(out));
+    ExpectIntEQ(wc_Sha256HashBatch(data + 14, lens + 14, hash, 1), 0);
+    ExpectIntEQ(wc_InitSha256(&sha256), 0);
+    ExpectIntEQ(wc_Sha256Update(&sha256, data[14], lens[14]), 0);
+    ExpectIntEQ(wc_Sha256Final(&sha256, expected), 0);
+    wc_Sha256Free(&sha256);
+    ExpectBufEQ(out[0], expected, WC_SHA256_DIGEST_SIZE);
+#endif
+    return EXPECT_RESULT();
+}
+
 /*******************************************************************************
  * SHA-224
  ******************************************************************************/
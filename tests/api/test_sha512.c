@@ -287,6 +287,62 @@ int test_wc_Sha512_Flags(void)
     return EXPECT_RESULT();
 }
 
+/* Batch of messages hashed in lanes matches hashing one at a time. */
+int test_wc_Sha512HashBatch(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_SHA512) && defined(WOLFSSL_SHA2_BATCH)
+    /* Lengths around the padding and block boundaries, more messages than
+     * lanes and a last chunk that leaves lanes unused. */
+    static const word32 lens[] = {
+        0, 1, 3, 111, 112, 127, 128, 129, 239, 240, 255, 256, 257, 1000, 63,
+        64, 0, 500
+    };
+    const word32 cnt = (word32)(sizeof(lens) / sizeof(*lens));
+    byte msg[1000];
+    byte out[sizeof(lens) / sizeof(*lens)][WC_SHA512_DIGEST_SIZE];
+    byte expected[WC_SHA512_DIGEST_SIZE];
+    const byte* data[sizeof(lens) / sizeof(*lens)];
+    byte* hash[sizeof(lens) / sizeof(*lens)];
+    wc_Sha512 sha512;
+    word32 i;
+
+    for (i = 0; i < (word32)sizeof(msg); i++) {
+        msg[i] = (byte)(i * 5 + 1);
+    }
+    for (i = 0; i < cnt; i++) {
+        data[i] = msg + (i % 3) * (lens[i] < 990 ? 1 : 0);
+        hash[i] = out[i];
+    }
+
+    /* Bad parameters. */
+    ExpectIntEQ(wc_Sha512HashBatch(NULL, lens, hash, 1),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_Sha512HashBatch(data, NULL, hash, 1),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wc_Sha512HashBatch(data, lens, NULL, 1),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    data[1] = NULL;
+    ExpectIntEQ(wc_Sha512HashBatch(data, lens, hash, 2),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    data[1] = msg;
+    ExpectIntEQ(wc_Sha512HashBatch(NULL, NULL, NULL, 0), 0);
+
+    /* Only an empty message may be NULL. */
+    data[16] = NULL;
+    XMEMSET(out, 0, sizeof(out));
+    ExpectIntEQ(wc_Sha512HashBatch(data, lens, hash, cnt), 0);
+    for (i = 0; i < cnt; i++) {
+        ExpectIntEQ(wc_InitSha512(&sha512), 0);
+        ExpectIntEQ(wc_Sha512Update(&sha512, data[i], lens[i]), 0);
+        ExpectIntEQ(wc_Sha512Final(&sha512, expected), 0);
+        wc_Sha512Free(&sha512);
+        ExpectBufEQ(out[i], expected, WC_SHA512_DIGEST_SIZE);
+    }
+#endif
+    return EXPECT_RESULT();
+}
+
 /*******************************************************************************
  * SHA-512-224
  ******************************************************************************/
@@ -34,6 +34,7 @@ int test_wc_Sha512Copy(void);
 int test_wc_Sha512GetHash(void);
 int test_wc_Sha512Transform(void);
 int test_wc_Sha512_Flags(void);
+int test_wc_Sha512HashBatch(void);
 
 int test_wc_InitSha512_224(void);
 int test_wc_Sha512_224Update(void);
@@ -81,6 +82,7 @@ int test_wc_sha512_cryptocb_free(void);
     TEST_DECL_GROUP("sha512", test_wc_Sha512GetHash),   \
     TEST_DECL_GROUP("sha512", test_wc_Sha512Transform), \
     TEST_DECL_GROUP("sha512", test_wc_Sha512_Flags),    \
+    TEST_DECL_GROUP("sha512", test_wc_Sha512HashBatch), \
     TEST_DECL_GROUP("sha512", test_wc_sha512_cryptocb_fallback),       \
     TEST_DECL_GROUP("sha512", test_wc_sha512_variants_default_devid),  \
     TEST_DECL_GROUP("sha512", test_wc_sha512_cryptocb_free)
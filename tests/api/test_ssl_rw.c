@@ -135,9 +135,9 @@ int test_wolfSSL_send(void)
 
 /* Test wolfSSL_writev().
  *
- * Covers the length overflow check, the stack/static gather buffer path, the
- * heap gather buffer path taken when the total exceeds FILE_BUFFER_SIZE, and
- * an empty vector.
+ * Covers the length overflow check, the stack gather buffer path, the heap
+ * gather buffer path taken when a record exceeds FILE_BUFFER_SIZE, and an
+ * empty vector.
  *
  * @return  TEST_SUCCESS on success.
  */
@@ -189,7 +189,7 @@ int test_wolfSSL_writev(void)
     ExpectIntEQ(wolfSSL_writev(ssl_c, iov, 0), 0);
     ExpectIntEQ(wolfSSL_writev(ssl_c, NULL, 0), 0);
 
-    /* Segments totalling less than FILE_BUFFER_SIZE use the static buffer. */
+    /* Segments totalling less than FILE_BUFFER_SIZE use the stack buffer. */
     small_sz = 96;
     iov[0].iov_base = msg;
     iov[0].iov_len  = 32;
@@ -221,6 +221,203 @@ int test_wolfSSL_writev(void)
     return EXPECT_RESULT();
 }
 
+#if defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES) && !defined(NO_TLS) \
+    && !defined(USE_WINDOWS_API) && !defined(_WIN32) && !defined(NO_WRITEV)
+/* Write a payload of several records with wolfSSL_writev() and read it back
+ * with wolfSSL_readv().
+ *
+ * The segment boundaries don't line up with the record boundaries, so some
+ * records are built straight from a segment and others span segments.
+ *
+ * @param [in] client_meth  Client method.
+ * @param [in] server_meth  Server method.
+ * @return  TEST_SUCCESS on success.
+ */
+static int test_ssl_rw_iov_records(method_provider client_meth,
+    method_provider server_meth)
+{
+    EXPECT_DECLS;
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_s = NULL;
+    WOLFSSL* ssl_c = NULL;
+    WOLFSSL* ssl_s = NULL;
+    struct test_memio_ctx test_ctx;
+    /* Segment lengths of the write and read vectors. */
+    static const size_t wr_len[] = { 9, 16384, 1, 20000, 5606 };
+    static const size_t rd_len[] = { 100, 0, 7000, 10000 };
+    struct iovec wr_iov[sizeof(wr_len) / sizeof(*wr_len)];
+    struct iovec rd_iov[sizeof(rd_len) / sizeof(*rd_len)];
+    byte* msg = NULL;
+    byte* reply = NULL;
+    int   total = 0;
+    int   got = 0;
+    int   rd;
+    int   i;
+    size_t off;
+
+    for (i = 0; i < (int)(sizeof(wr_len) / sizeof(*wr_len)); i++) {
+        total += (int)wr_len[i];
+    }
+    ExpectNotNull(msg = (byte*)XMALLOC((size_t)total, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER));
+    ExpectNotNull(reply = (byte*)XMALLOC((size_t)total, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER));
+
+    if (EXPECT_SUCCESS()) {
+        for (i = 0; i < total; i++) {
+            msg[i] = (byte)(i * 31 + 7);
+        }
+        XMEMSET(reply, 0, (size_t)total);
+        off = 0;
+        for (i = 0; i < (int)(sizeof(wr_len) / sizeof(*wr_len)); i++) {
+            wr_iov[i].iov_base = msg + off;
+            wr_iov[i].iov_len  = wr_len[i];
+            off += wr_len[i];
+        }
+    }
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    ExpectIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+        client_meth, server_meth), 0);
+    ExpectIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+
+    ExpectIntEQ(wolfSSL_writev(ssl_c,
+        wr_iov, (int)(sizeof(wr_iov) / sizeof(*wr_iov))), total);
+
+    /* Each read fills the segments from the start with up to a record. */
+    while (EXPECT_SUCCESS() && (got < total)) {
+        byte*  p = reply + got;
+        size_t left = (size_t)(total - got);
+
+        for (i = 0; i < (int)(sizeof(rd_len) / sizeof(*rd_len)); i++) {
+            size_t len = (rd_len[i] < left) ? rd_len[i] : left;
+
+            rd_iov[i].iov_base = p;
+            rd_iov[i].iov_len  = len;
+            p += len;
+            left -= len;
+        }
+        rd = wolfSSL_readv(ssl_s, rd_iov,
+            (int)(sizeof(rd_iov) / sizeof(*rd_iov)));
+        ExpectIntGT(rd, 0);
+        if (rd > 0) {
+            got += rd;
+        }
+    }
+    ExpectIntEQ(got, total);
+    if (EXPECT_SUCCESS()) {
+        ExpectBufEQ(reply, msg, total);
+    }
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+    XFREE(reply, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(msg, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    return EXPECT_RESULT();
+}
+#endif
+
+/* Test wolfSSL_writev() and wolfSSL_readv() with payloads of many records.
+ *
+ * @return  TEST_SUCCESS on success.
+ */
+int test_wolfSSL_writev_readv_records(void)
+{
+    EXPECT_DECLS;
+#if defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES) && !defined(NO_TLS) \
+    && !defined(USE_WINDOWS_API) && !defined(_WIN32) && !defined(NO_WRITEV)
+#ifndef WOLFSSL_NO_TLS12
+    ExpectIntEQ(test_ssl_rw_iov_records(wolfTLSv1_2_client_method,
+        wolfTLSv1_2_server_method), TEST_SUCCESS);
+#endif
+#ifdef WOLFSSL_TLS13
+    ExpectIntEQ(test_ssl_rw_iov_records(wolfTLSv1_3_client_method,
+        wolfTLSv1_3_server_method), TEST_SUCCESS);
+#endif
+#endif
+    return EXPECT_RESULT();
+}
+
+/* Test wolfSSL_readv() arguments.
+ *
+ * @return  TEST_SUCCESS on success.
+ */
+int test_wolfSSL_readv(void)
+{
+    EXPECT_DECLS;
+#if defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES) && !defined(NO_TLS) \
+    && !defined(USE_WINDOWS_API) && !defined(_WIN32) && !defined(NO_WRITEV) \
+    && !defined(WOLFSSL_NO_TLS12)
+    WOLFSSL_CTX* ctx_c = NULL;
+    WOLFSSL_CTX* ctx_s = NULL;
+    WOLFSSL* ssl_c = NULL;
+    WOLFSSL* ssl_s = NULL;
+    struct test_memio_ctx test_ctx;
+    byte  msg[64];
+    byte  reply[64];
+    struct iovec iov[3];
+    int   i;
+
+    for (i = 0; i < (int)sizeof(msg); i++) {
+        msg[i] = (byte)(i * 5 + 3);
+    }
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    ExpectIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+        wolfTLSv1_2_client_method, wolfTLSv1_2_server_method), 0);
+    ExpectIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+
+    /* Arguments are validated before anything is read from the object. */
+    iov[0].iov_base = reply;
+    iov[0].iov_len  = (size_t)-1;
+    iov[1].iov_base = reply;
+    iov[1].iov_len  = 2;
+    ExpectIntEQ(wolfSSL_readv(ssl_s, iov, 2), WC_NO_ERR_TRACE(BUFFER_E));
+    ExpectIntEQ(wolfSSL_readv(NULL, iov, 1), WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_readv(ssl_s, NULL, 1), WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_readv(ssl_s, iov, -1), WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+
+    /* Nothing to read yet. */
+    iov[0].iov_len  = sizeof(reply);
+    ExpectIntEQ(wolfSSL_readv(ssl_s, iov, 1), WOLFSSL_FATAL_ERROR);
+    ExpectIntEQ(wolfSSL_get_error(ssl_s, WOLFSSL_FATAL_ERROR),
+        WOLFSSL_ERROR_WANT_READ);
+
+    /* Record data is scattered over the segments in order. */
+    ExpectIntEQ(wolfSSL_write(ssl_c, msg, (int)sizeof(msg)), (int)sizeof(msg));
+    XMEMSET(reply, 0, sizeof(reply));
+    iov[0].iov_base = reply;
+    iov[0].iov_len  = 10;
+    iov[1].iov_base = reply + 10;
+    iov[1].iov_len  = 0;
+    iov[2].iov_base = reply + 10;
+    iov[2].iov_len  = sizeof(reply) - 10;
+    ExpectIntEQ(wolfSSL_readv(ssl_s, iov, 3), (int)sizeof(msg));
+    ExpectBufEQ(reply, msg, sizeof(msg));
+
+    /* Segments shorter than the record leave the rest for the next read. */
+    ExpectIntEQ(wolfSSL_write(ssl_c, msg, (int)sizeof(msg)), (int)sizeof(msg));
+    XMEMSET(reply, 0, sizeof(reply));
+    iov[0].iov_base = reply;
+    iov[0].iov_len  = 16;
+    iov[1].iov_base = reply + 16;
+    iov[1].iov_len  = 16;
+    ExpectIntEQ(wolfSSL_readv(ssl_s, iov, 2), 32);
+    iov[0].iov_base = reply + 32;
+    iov[0].iov_len  = sizeof(reply) - 32;
+    ExpectIntEQ(wolfSSL_readv(ssl_s, iov, 1), (int)sizeof(reply) - 32);
+    ExpectBufEQ(reply, msg, sizeof(msg));
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+#endif
+    return EXPECT_RESULT();
+}
+
 /* Test wolfSSL_get_shutdown().
  *
  * Covers the NULL object case and each stage of a bidirectional shutdown:
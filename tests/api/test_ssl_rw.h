@@ -26,6 +26,8 @@
 
 int test_wolfSSL_send(void);
 int test_wolfSSL_writev(void);
+int test_wolfSSL_writev_readv_records(void);
+int test_wolfSSL_readv(void);
 int test_wolfSSL_get_shutdown(void);
 int test_wolfSSL_want(void);
 int test_wolfSSL_pending_api(void);
@@ -43,6 +45,8 @@ int test_wolfSSL_write_dup_err(void);
 #define TEST_SSL_RW_DECLS                                                      \
         TEST_DECL_GROUP("ssl_rw", test_wolfSSL_send),                          \
         TEST_DECL_GROUP("ssl_rw", test_wolfSSL_writev),                        \
+        TEST_DECL_GROUP("ssl_rw", test_wolfSSL_writev_readv_records),          \
+        TEST_DECL_GROUP("ssl_rw", test_wolfSSL_readv),                         \
         TEST_DECL_GROUP("ssl_rw", test_wolfSSL_get_shutdown),                  \
         TEST_DECL_GROUP("ssl_rw", test_wolfSSL_want),                          \
         TEST_DECL_GROUP("ssl_rw", test_wolfSSL_pending_api),                   \
@@ -3378,3 +3378,286 @@ int test_record_size_cache_invalidated_on_renegotiation(void)
 #endif
     return EXPECT_RESULT();
 }
+
+#if defined(WOLFSSL_LAZY_HS_HASHES) && \
+    defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES)
+/* Run the server to its first flight and check the handshake hashes have been
+ * chosen, then finish the handshake.
+ *
+ * Without client authentication only the hash of the cipher suite runs. With
+ * it a TLS v1.2 server also runs the hashes of its CertificateRequest and the
+ * client the hash it signs with.
+ */
+static int test_tls_lazy_hs_hashes_run(method_provider method_c,
+    method_provider method_s, int hrr, int clientAuth)
+{
+    EXPECT_DECLS;
+    WOLFSSL_CTX *ctx_c = NULL;
+    WOLFSSL_CTX *ctx_s = NULL;
+    WOLFSSL *ssl_c = NULL;
+    WOLFSSL *ssl_s = NULL;
+    struct test_memio_ctx test_ctx;
+    word16 prf = 0;
+    word16 sigHash = 0;
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    ExpectIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                    method_c, method_s), 0);
+#ifdef WOLFSSL_TLS13
+    if (hrr) {
+        /* No key share sent so server has to ask for one. */
+        ExpectIntEQ(wolfSSL_NoKeyShares(ssl_c), WOLFSSL_SUCCESS);
+    }
+#else
+    (void)hrr;
+#endif
+    if (clientAuth) {
+        ExpectIntEQ(wolfSSL_use_certificate_file(ssl_c, cliCertFile,
+            WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+        ExpectIntEQ(wolfSSL_use_PrivateKey_file(ssl_c, cliKeyFile,
+            WOLFSSL_FILETYPE_PEM), WOLFSSL_SUCCESS);
+        ExpectIntEQ(wolfSSL_CTX_load_verify_locations(ctx_s, cliCertFile,
+            NULL), WOLFSSL_SUCCESS);
+        wolfSSL_set_verify(ssl_s, WOLFSSL_VERIFY_PEER, NULL);
+    }
+
+    /* Nothing hashed until the cipher suite is known. */
+    ExpectNotNull(ssl_c->hsHashes);
+    ExpectIntEQ(ssl_c->hsHashes->started, 0);
+
+    ExpectIntEQ(wolfSSL_connect(ssl_c), WOLFSSL_FATAL_ERROR);
+    ExpectIntEQ(wolfSSL_get_error(ssl_c, WOLFSSL_FATAL_ERROR),
+        WOLFSSL_ERROR_WANT_READ);
+    ExpectIntEQ(ssl_c->hsHashes->started, 0);
+    ExpectNotNull(ssl_c->hsHashes->transcript);
+
+    if (hrr) {
+        /* HelloRetryRequest doesn't settle the hashes. */
+        ExpectIntEQ(wolfSSL_accept(ssl_s), WOLFSSL_FATAL_ERROR);
+        ExpectIntEQ(wolfSSL_get_error(ssl_s, WOLFSSL_FATAL_ERROR),
+            WOLFSSL_ERROR_WANT_READ);
+        ExpectIntEQ(ssl_s->hsHashes->selected, 0);
+        ExpectIntEQ(wolfSSL_connect(ssl_c), WOLFSSL_FATAL_ERROR);
+        ExpectIntEQ(wolfSSL_get_error(ssl_c, WOLFSSL_FATAL_ERROR),
+            WOLFSSL_ERROR_WANT_READ);
+        ExpectIntEQ(ssl_c->hsHashes->selected, 0);
+    }
+
+    ExpectIntEQ(wolfSSL_accept(ssl_s), WOLFSSL_FATAL_ERROR);
+    ExpectIntEQ(wolfSSL_get_error(ssl_s, WOLFSSL_FATAL_ERROR),
+        WOLFSSL_ERROR_WANT_READ);
+    ExpectNotNull(ssl_s->hsHashes);
+    if (EXPECT_SUCCESS()) {
+        prf = HandshakeHashForMac(ssl_s->specs.mac_algorithm);
+        ExpectIntEQ(ssl_s->hsHashes->selected, 1);
+        ExpectNull(ssl_s->hsHashes->transcript);
+        if (clientAuth && !IsAtLeastTLSv1_3(ssl_s->version)) {
+            ExpectIntEQ(ssl_s->hsHashes->started & prf, prf);
+            ExpectIntNE(ssl_s->hsHashes->started, prf);
+            ExpectIntEQ(ssl_s->hsHashes->started & HS_HASH_MD5, 0);
+        }
+        else {
+            ExpectIntEQ(ssl_s->hsHashes->started, prf);
+        }
+    }
+
+    if (EXPECT_SUCCESS() && !IsAtLeastTLSv1_3(ssl_c->version)) {
+        /* The TLS v1.2 client chooses once ServerHelloDone is processed. */
+        ExpectIntEQ(ssl_c->hsHashes->selected, 0);
+        ExpectIntEQ(wolfSSL_connect(ssl_c), WOLFSSL_FATAL_ERROR);
+        ExpectIntEQ(wolfSSL_get_error(ssl_c, WOLFSSL_FATAL_ERROR),
+            WOLFSSL_ERROR_WANT_READ);
+        if (clientAuth) {
+            switch (ssl_c->options.hashAlgo) {
+                case sha256_mac:
+                    sigHash = HS_HASH_SHA256;
+                    break;
+                case sha384_mac:
+                    sigHash = HS_HASH_SHA384;
+                    break;
+                case sha512_mac:
+                    sigHash = HS_HASH_SHA512;
+                    break;
+                default:
+                    sigHash = HS_HASH_SHA;
+                    break;
+            }
+        }
+        ExpectIntEQ(ssl_c->hsHashes->selected, 1);
+        ExpectNull(ssl_c->hsHashes->transcript);
+        ExpectIntEQ(ssl_c->hsHashes->started, prf | sigHash);
+    }
+
+    ExpectIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+
+    return EXPECT_RESULT();
+}
+#endif
+
+/* With lazy handshake hashes, messages are kept until the cipher suite is
+ * known. Only the hashes the handshake can use then run: the cipher suite's
+ * and, for TLS v1.2 client authentication, those of the CertificateVerify.
+ */
+int test_tls_lazy_hs_hashes(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_LAZY_HS_HASHES) && \
+    defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES)
+#ifdef WOLFSSL_TLS13
+    ExpectIntEQ(test_tls_lazy_hs_hashes_run(wolfTLSv1_3_client_method,
+        wolfTLSv1_3_server_method, 0, 0), TEST_SUCCESS);
+    ExpectIntEQ(test_tls_lazy_hs_hashes_run(wolfTLSv1_3_client_method,
+        wolfTLSv1_3_server_method, 1, 0), TEST_SUCCESS);
+#endif
+#if !defined(WOLFSSL_NO_TLS12) && !defined(NO_SHA256)
+    ExpectIntEQ(test_tls_lazy_hs_hashes_run(wolfTLSv1_2_client_method,
+        wolfTLSv1_2_server_method, 0, 0), TEST_SUCCESS);
+#if !defined(WOLFSSL_NO_CLIENT_AUTH) && !defined(NO_RSA) && \
+    !defined(NO_FILESYSTEM)
+    ExpectIntEQ(test_tls_lazy_hs_hashes_run(wolfTLSv1_2_client_method,
+        wolfTLSv1_2_server_method, 0, 1), TEST_SUCCESS);
+#endif
+#endif
+#endif
+    return EXPECT_RESULT();
+}
+
+/* SSL_MODE_RELEASE_BUFFERS: a drained connection holds no dynamic I/O buffers
+ * and the next record is read into a buffer taken back from the CTX pool.
+ */
+int test_tls_release_buffers(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_IO_BUFFER_POOL) && \
+    defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES) && \
+    (defined(OPENSSL_EXTRA) || defined(HAVE_WEBSERVER) || \
+     defined(HAVE_MEMCACHED))
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+    WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+    byte msg[4000];
+    byte reply[sizeof(msg)];
+    byte* pooled[WOLFSSL_BUFFER_POOL_CLASSES];
+    word32 cnt = 0;
+    int i;
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    XMEMSET(msg, 0x5a, sizeof(msg));
+    ExpectIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, NULL, NULL,
+        wolfSSLv23_client_method, wolfSSLv23_server_method), 0);
+    ExpectIntEQ(wolfSSL_CTX_set_mode(ctx_s, WOLFSSL_MODE_RELEASE_BUFFERS),
+        WOLFSSL_MODE_RELEASE_BUFFERS);
+    ExpectIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+        wolfSSLv23_client_method, wolfSSLv23_server_method), 0);
+    ExpectIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+
+    ExpectIntEQ(ssl_s->buffers.inputBuffer.dynamicFlag, 0);
+    ExpectIntEQ(ssl_s->buffers.outputBuffer.dynamicFlag, 0);
+    if (EXPECT_SUCCESS()) {
+        for (i = 0; i < WOLFSSL_BUFFER_POOL_CLASSES; i++)
+            cnt += ctx_s->bufferPool.count[i];
+    }
+    ExpectIntGT(cnt, 0);
+
+    /* Echo a record: both server buffers go back once drained. */
+    ExpectIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+    ExpectIntEQ(wolfSSL_read(ssl_s, reply, sizeof(reply)), sizeof(msg));
+    ExpectIntEQ(ssl_s->buffers.inputBuffer.dynamicFlag, 0);
+    ExpectIntEQ(wolfSSL_write(ssl_s, reply, sizeof(reply)), sizeof(reply));
+    ExpectIntEQ(ssl_s->buffers.outputBuffer.dynamicFlag, 0);
+    ExpectIntEQ(wolfSSL_read(ssl_c, reply, sizeof(reply)), sizeof(msg));
+    ExpectBufEQ(reply, msg, sizeof(msg));
+
+    /* The same record size now comes out of the pool. Reading part of it
+     * keeps the buffer until the rest is consumed. */
+    if (EXPECT_SUCCESS()) {
+        XMEMCPY(pooled, ctx_s->bufferPool.head, sizeof(pooled));
+    }
+    ExpectIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+    ExpectIntEQ(wolfSSL_read(ssl_s, reply, 1), 1);
+    ExpectIntEQ(ssl_s->buffers.inputBuffer.dynamicFlag, 1);
+    ExpectIntNE(ssl_s->buffers.inputBuffer.poolClass, 0);
+    if (EXPECT_SUCCESS()) {
+        ExpectPtrEq(ssl_s->buffers.inputBuffer.buffer -
+                        ssl_s->buffers.inputBuffer.offset,
+                    pooled[ssl_s->buffers.inputBuffer.poolClass - 1]);
+    }
+    ExpectIntEQ(wolfSSL_read(ssl_s, reply + 1, sizeof(reply) - 1),
+        sizeof(msg) - 1);
+    ExpectBufEQ(reply, msg, sizeof(msg));
+    ExpectIntEQ(ssl_s->buffers.inputBuffer.dynamicFlag, 0);
+
+    /* Clearing the mode leaves new connections on plain allocations. */
+    ExpectIntEQ(wolfSSL_CTX_clear_mode(ctx_s, WOLFSSL_MODE_RELEASE_BUFFERS), 0);
+    ExpectIntEQ(ctx_s->releaseBuffers, 0);
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+#endif
+    return EXPECT_RESULT();
+}
+
+/* Connections reference the shared TLS RNG bank instead of seeding a DRBG each,
+ * unless the CTX opts out. */
+int test_tls_rng_bank(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_TLS_RNG_BANK) && \
+    defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES)
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+    WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+    WOLFSSL *ssl_own = NULL;
+    byte rand1[32];
+    byte rand2[sizeof(rand1)];
+    const char msg[] = "rng bank";
+    char reply[sizeof(msg)];
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    ExpectIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+        wolfSSLv23_client_method, wolfSSLv23_server_method), 0);
+
+    /* Devices generate from their own RNG. */
+    if (EXPECT_SUCCESS() && ssl_c->devId == INVALID_DEVID &&
+            ssl_s->devId == INVALID_DEVID) {
+        ExpectNotNull(wolfSSL_GetRNG(ssl_c));
+        ExpectNotNull(wolfSSL_GetRNG(ssl_s));
+        ExpectIntEQ(ssl_c->rng->status, WC_DRBG_BANKREF);
+        ExpectIntEQ(ssl_s->rng->status, WC_DRBG_BANKREF);
+        ExpectNotNull(ssl_c->rng->bankref);
+        ExpectPtrEq(ssl_c->rng->bankref, ssl_s->rng->bankref);
+        ExpectIntEQ(wc_RNG_GenerateBlock(ssl_c->rng, rand1, sizeof(rand1)), 0);
+        ExpectIntEQ(wc_RNG_GenerateBlock(ssl_s->rng, rand2, sizeof(rand2)), 0);
+        ExpectIntNE(XMEMCMP(rand1, rand2, sizeof(rand1)), 0);
+    }
+
+    ExpectIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    ExpectIntEQ(wolfSSL_write(ssl_c, msg, sizeof(msg)), sizeof(msg));
+    ExpectIntEQ(wolfSSL_read(ssl_s, reply, sizeof(reply)), sizeof(msg));
+    ExpectStrEQ(reply, msg);
+
+    /* Opting out gives new connections a DRBG of their own. */
+    ExpectIntEQ(wolfSSL_CTX_UseRngBank(NULL, 0), WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_CTX_UseRngBank(ctx_c, 0), WOLFSSL_SUCCESS);
+    ExpectNotNull(ssl_own = wolfSSL_new(ctx_c));
+    ExpectNotNull(wolfSSL_GetRNG(ssl_own));
+    if (EXPECT_SUCCESS()) {
+        ExpectIntEQ(ssl_own->rng->status, WC_DRBG_OK);
+    }
+    ExpectIntEQ(wolfSSL_CTX_UseRngBank(ctx_c, 1), WOLFSSL_SUCCESS);
+
+    wolfSSL_free(ssl_own);
+    wolfSSL_free(ssl_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+#endif
+    return EXPECT_RESULT();
+}
@@ -66,6 +66,9 @@ int test_record_size_matches_build_message(void);
 int test_record_size_preserves_build_msg_state(void);
 int test_record_size_cache_invalidated_on_renegotiation(void);
 int test_wolfSSL_get_shared_ciphers(void);
+int test_tls_lazy_hs_hashes(void);
+int test_tls_release_buffers(void);
+int test_tls_rng_bank(void);
 
 #define TEST_TLS_DECLS                                                         \
         TEST_DECL_GROUP("tls", test_utils_memio_move_message),                 \
@@ -114,6 +117,9 @@ int test_wolfSSL_get_shared_ciphers(void);
             test_record_size_preserves_build_msg_state),                       \
         TEST_DECL_GROUP("tls",                                                 \
             test_record_size_cache_invalidated_on_renegotiation),              \
-        TEST_DECL_GROUP("tls", test_wolfSSL_get_shared_ciphers)
+        TEST_DECL_GROUP("tls", test_wolfSSL_get_shared_ciphers),               \
+        TEST_DECL_GROUP("tls", test_tls_lazy_hs_hashes),                       \
+        TEST_DECL_GROUP("tls", test_tls_release_buffers),                      \
+        TEST_DECL_GROUP("tls", test_tls_rng_bank)
 
 #endif /* TESTS_API_TEST_TLS_H */
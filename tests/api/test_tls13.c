@@ -33,6 +33,14 @@
 #include <tests/api/api.h>
 #include <tests/utils.h>
 #include <tests/api/test_tls13.h>
+#ifdef WOLFSSL_ASYNC_THREADPOOL
+    #include <poll.h>
+#endif
+#if defined(WOLFSSL_KEY_SHARE_POOL) && !defined(WOLFSSL_NO_GETPID) && \
+    (defined(__linux__) || defined(__FreeBSD__))
+    #include <unistd.h>
+    #include <sys/wait.h>
+#endif
 
 #if defined(WOLFSSL_SEND_HRR_COOKIE) && !defined(NO_WOLFSSL_SERVER)
 #ifdef WC_SHA384_DIGEST_SIZE
@@ -7156,6 +7164,282 @@ int test_tls13_pqc_hybrid_async_server(void)
     return EXPECT_RESULT();
 }
 
+/* Drive a server handshake the way an event loop would: the server's public
+ * key operations run on the async worker pool and the loop sleeps on the
+ * pool's descriptor instead of inside wolfSSL_accept(). The client does its
+ * crypto inline and stands in for the peer. */
+int test_tls13_async_threadpool(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_TLS13) && defined(WOLFSSL_ASYNC_THREADPOOL) && \
+    defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES)
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+    WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+    int devId = INVALID_DEVID;
+    int fd = -1;
+    int cliDone = 0, srvDone = 0, poolWaits = 0;
+    int i, ret, err;
+    struct pollfd pfd;
+
+    ExpectIntEQ(wolfAsync_DevOpen(&devId), 0);
+    ExpectIntGE(devId, 0);
+    ExpectIntGE(fd = wolfAsync_ThreadPoolGetFd(), 0);
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    ExpectIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+                    wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+    ExpectIntEQ(wolfSSL_SetDevId(ssl_s, devId), WOLFSSL_SUCCESS);
+
+    for (i = 0; EXPECT_SUCCESS() && i < 100 && !(cliDone && srvDone); i++) {
+        if (!cliDone) {
+            ret = wolfSSL_connect(ssl_c);
+            if (ret == WOLFSSL_SUCCESS)
+                cliDone = 1;
+            else
+                ExpectIntEQ(wolfSSL_get_error(ssl_c, ret),
+                    WOLFSSL_ERROR_WANT_READ);
+        }
+        if (srvDone)
+            continue;
+        ret = wolfSSL_accept(ssl_s);
+        if (ret == WOLFSSL_SUCCESS) {
+            srvDone = 1;
+            continue;
+        }
+        err = wolfSSL_get_error(ssl_s, ret);
+        if (err != WC_NO_ERR_TRACE(WC_PENDING_E)) {
+            ExpectIntEQ(err, WOLFSSL_ERROR_WANT_READ);
+            continue;
+        }
+        /* Symmetric ops complete on the poll; public key ops are still on a
+         * worker, so wait for the descriptor. */
+        ret = wolfSSL_AsyncPoll(ssl_s, WOLF_POLL_FLAG_CHECK_HW);
+        if (ret == 0) {
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            ExpectIntEQ(poll(&pfd, 1, 10000), 1);
+            wolfAsync_ThreadPoolClearFd();
+            ret = wolfSSL_AsyncPoll(ssl_s, WOLF_POLL_FLAG_CHECK_HW);
+            poolWaits++;
+        }
+        ExpectIntEQ(ret, 1);
+    }
+    ExpectIntEQ(cliDone, 1);
+    ExpectIntEQ(srvDone, 1);
+    /* At least the signature and the key exchange went to the pool. */
+    ExpectIntGE(poolWaits, 2);
+
+    wolfSSL_free(ssl_c);
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_free(ssl_s);
+    wolfSSL_CTX_free(ctx_s);
+    wolfAsync_DevClose(&devId);
+    /* Last reference closed: the pool is stopped. */
+    ExpectIntEQ(wolfAsync_ThreadPoolGetFd(), -1);
+#endif
+    return EXPECT_RESULT();
+}
+
+int test_tls13_key_share_pool(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_KEY_SHARE_POOL) && \
+    defined(HAVE_MANUAL_MEMIO_TESTS_DEPENDENCIES) && \
+    (defined(HAVE_CURVE25519) || defined(HAVE_ECC))
+    struct test_memio_ctx test_ctx;
+    WOLFSSL_CTX *ctx_c = NULL, *ctx_s = NULL;
+    WOLFSSL *ssl_c = NULL, *ssl_s = NULL;
+#ifdef HAVE_CURVE25519
+    word16 group = WOLFSSL_ECC_X25519;
+#else
+    word16 group = WOLFSSL_ECC_SECP256R1;
+#endif
+    word16 dup[2];
+    word16 ffdhe = WOLFSSL_FFDHE_2048;
+
+    dup[0] = group;
+    dup[1] = group;
+
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    ExpectIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+        wolfTLSv1_3_client_method, wolfTLSv1_3_server_method), 0);
+
+    ExpectIntEQ(wolfSSL_CTX_UseKeySharePool(NULL, &group, 1, 4),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_c, &group, 1, 0),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_c, &group, 1,
+        WOLFSSL_KEY_SHARE_POOL_MAX_DEPTH + 1), WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_c, &ffdhe, 1, 4),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_c, dup, 2, 4),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolRefill(ctx_c),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolCount(ctx_c, group),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+
+    /* Pools are full when set. */
+    ExpectIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_c, &group, 1, 4),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_s, &group, 1, 4),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolCount(ctx_c, group), 4);
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolCount(ctx_s, group), 4);
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolCount(ctx_c, ffdhe),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+
+    /* Both sides take their key share from the pool. Above half depth no
+     * refill is asked for, so the counts stay put. */
+    ExpectIntEQ(wolfSSL_UseKeyShare(ssl_c, group), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolCount(ctx_c, group), 3);
+    ExpectIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolCount(ctx_c, group), 3);
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolCount(ctx_s, group), 3);
+
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolRefill(ctx_c), 1);
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolCount(ctx_c, group), 4);
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolRefill(ctx_c), 0);
+
+    wolfSSL_free(ssl_c);
+    ssl_c = NULL;
+    wolfSSL_free(ssl_s);
+    ssl_s = NULL;
+
+#if defined(WOLFSSL_HAVE_MLKEM) && !defined(WOLFSSL_NO_ML_KEM) && \
+    !defined(WOLFSSL_NO_ML_KEM_768) && !defined(WOLFSSL_MLKEM_NO_MAKE_KEY) && \
+    !defined(WOLFSSL_MLKEM_NO_DECAPSULATE) && \
+    !defined(WOLFSSL_MLKEM_NO_ENCAPSULATE) && defined(HAVE_CURVE25519) && \
+    defined(WOLFSSL_PQC_HYBRIDS)
+    /* Hybrid key shares are pooled whole. */
+    group = WOLFSSL_X25519MLKEM768;
+    ExpectIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_c, &group, 1, 4),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolCount(ctx_c, group), 4);
+    XMEMSET(&test_ctx, 0, sizeof(test_ctx));
+    ExpectIntEQ(test_memio_setup(&test_ctx, &ctx_c, &ctx_s, &ssl_c, &ssl_s,
+        NULL, NULL), 0);
+    ExpectIntEQ(wolfSSL_UseKeyShare(ssl_c, group), WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolCount(ctx_c, group), 3);
+    ExpectIntEQ(test_memio_do_handshake(ssl_c, ssl_s, 10, NULL), 0);
+    wolfSSL_free(ssl_c);
+    ssl_c = NULL;
+    wolfSSL_free(ssl_s);
+    ssl_s = NULL;
+#endif
+
+    /* No groups removes the pool. */
+    ExpectIntEQ(wolfSSL_CTX_UseKeySharePool(ctx_c, NULL, 0, 0),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolCount(ctx_c, group),
+        WC_NO_ERR_TRACE(BAD_FUNC_ARG));
+
+    wolfSSL_CTX_free(ctx_c);
+    wolfSSL_CTX_free(ctx_s);
+#endif
+    return EXPECT_RESULT();
+}
+
+#if defined(WOLFSSL_KEY_SHARE_POOL) && !defined(WOLFSSL_NO_GETPID) && \
+    (defined(HAVE_GETPID) || \
+     (!defined(SINGLE_THREADED) && defined(WOLFSSL_PTHREADS))) && \
+    (defined(__linux__) || defined(__FreeBSD__)) && !defined(NO_WOLFSSL_CLIENT) && \
+    (defined(HAVE_CURVE25519) || defined(HAVE_ECC))
+/* Public key of the key share ssl generated or took for group. */
+static int test_key_share_pool_pub(WOLFSSL* ssl, word16 group, byte* pub,
+    word32* pubSz)
+{
+    TLSX* ext;
+    KeyShareEntry* kse;
+
+    if (wolfSSL_UseKeyShare(ssl, group) != WOLFSSL_SUCCESS)
+        return -1;
+    ext = TLSX_Find(ssl->extensions, TLSX_KEY_SHARE);
+    if (ext == NULL || ext->data == NULL)
+        return -1;
+    kse = (KeyShareEntry*)ext->data;
+    if (kse->pubKey == NULL || kse->pubKeyLen > *pubSz)
+        return -1;
+    XMEMCPY(pub, kse->pubKey, kse->pubKeyLen);
+    *pubSz = kse->pubKeyLen;
+    return 0;
+}
+#endif
+
+int test_tls13_key_share_pool_fork(void)
+{
+    EXPECT_DECLS;
+#if defined(WOLFSSL_KEY_SHARE_POOL) && !defined(WOLFSSL_NO_GETPID) && \
+    (defined(HAVE_GETPID) || \
+     (!defined(SINGLE_THREADED) && defined(WOLFSSL_PTHREADS))) && \
+    (defined(__linux__) || defined(__FreeBSD__)) && !defined(NO_WOLFSSL_CLIENT) && \
+    (defined(HAVE_CURVE25519) || defined(HAVE_ECC))
+    WOLFSSL_CTX* ctx = NULL;
+    WOLFSSL* ssl = NULL;
+#ifdef HAVE_CURVE25519
+    word16 group = WOLFSSL_ECC_X25519;
+#else
+    word16 group = WOLFSSL_ECC_SECP256R1;
+#endif
+    byte pub[2][MAX_ECC_BYTES * 2 + 1];
+    word32 pubSz[2] = { sizeof(pub[0]), sizeof(pub[1]) };
+    int fds[2] = { -1, -1 };
+    int status = -1;
+    pid_t pid = -1;
+
+    ExpectNotNull(ctx = wolfSSL_CTX_new(wolfTLSv1_3_client_method()));
+    ExpectIntEQ(wolfSSL_CTX_UseKeySharePool(ctx, &group, 1, 4),
+        WOLFSSL_SUCCESS);
+    ExpectIntEQ(pipe(fds), 0);
+
+    /* The child of a prefork server must not send the key share the parent
+     * takes next from the pool. */
+    ExpectIntGE(pid = fork(), 0);
+    if (pid == 0) {
+        int ret = 1;
+
+        close(fds[0]);
+        ssl = wolfSSL_new(ctx);
+        if (ssl != NULL &&
+                test_key_share_pool_pub(ssl, group, pub[0], &pubSz[0]) == 0 &&
+                wolfSSL_CTX_KeySharePoolCount(ctx, group) == 0 &&
+                wolfSSL_CTX_KeySharePoolRefill(ctx) ==
+                    WC_NO_ERR_TRACE(BAD_STATE_E) &&
+                write(fds[1], pub[0], pubSz[0]) == (ssize_t)pubSz[0]) {
+            ret = 0;
+        }
+        close(fds[1]);
+        exit(ret);
+    }
+    if (fds[1] >= 0)
+        close(fds[1]);
+    if (pid > 0) {
+        ExpectIntEQ(waitpid(pid, &status, 0), pid);
+        ExpectTrue(WIFEXITED(status));
+        ExpectIntEQ(WEXITSTATUS(status), 0);
+    }
+    if (EXPECT_SUCCESS()) {
+        ssize_t n = read(fds[0], pub[0], sizeof(pub[0]));
+        ExpectIntGT(n, 0);
+        pubSz[0] = (word32)n;
+    }
+    if (fds[0] >= 0)
+        close(fds[0]);
+
+    ExpectNotNull(ssl = wolfSSL_new(ctx));
+    ExpectIntEQ(test_key_share_pool_pub(ssl, group, pub[1], &pubSz[1]), 0);
+    ExpectIntEQ(wolfSSL_CTX_KeySharePoolCount(ctx, group), 3);
+    ExpectIntEQ(pubSz[0], pubSz[1]);
+    ExpectIntNE(XMEMCMP(pub[0], pub[1], pubSz[1]), 0);
+
+    wolfSSL_free(ssl);
+    wolfSSL_CTX_free(ctx);
+#endif
+    return EXPECT_RESULT();
+}
+
 /* Test that a TLS 1.3 NewSessionTicket with a ticket shorter than ID_LEN
  * (32 bytes) does not cause an unsigned integer underflow / OOB read in
  * SetTicket. Uses a full memio handshake, then injects a crafted
@@ -106,6 +106,9 @@ int test_tls13_AEAD_limit_KU_aes128_ccm_sha256(void);
 int test_tls13_AEAD_limit_KU_aes128_ccm_8_sha256(void);
 int test_tls13_KeyUpdate_sender_limit(void);
 int test_tls13_pqc_hybrid_async_server(void);
+int test_tls13_async_threadpool(void);
+int test_tls13_key_share_pool(void);
+int test_tls13_key_share_pool_fork(void);
 int test_tls13_pha_status_request(void);
 
 #define TEST_TLS13_DECLS                                        \
@@ -191,6 +194,9 @@ int test_tls13_pha_status_request(void);
     TEST_DECL_GROUP("tls13", test_tls13_AEAD_limit_KU_aes128_ccm_8_sha256), \
     TEST_DECL_GROUP("tls13", test_tls13_KeyUpdate_sender_limit), \
     TEST_DECL_GROUP("tls13", test_tls13_pqc_hybrid_async_server), \
+    TEST_DECL_GROUP("tls13", test_tls13_async_threadpool), \
+    TEST_DECL_GROUP("tls13", test_tls13_key_share_pool), \
+    TEST_DECL_GROUP("tls13", test_tls13_key_share_pool_fork), \
     TEST_DECL_GROUP("tls13", test_tls13_pha_status_request)
 
 #endif /* WOLFCRYPT_TEST_TLS13_H */
@@ -868,6 +868,8 @@ static WC_INLINE void bench_append_memory_info(char* buffer, size_t size,
 #define BENCH_CSHAKE128          0x00100000
 #define BENCH_CSHAKE256          0x00200000
 #define BENCH_CSHAKE             (BENCH_CSHAKE128 | BENCH_CSHAKE256)
+#define BENCH_SHA256_BATCH       0x00400000
+#define BENCH_SHA512_BATCH       0x00800000
 
 /* MAC algorithms. */
 #define BENCH_CMAC               0x00000001
@@ -880,6 +882,7 @@ static WC_INLINE void bench_append_memory_info(char* buffer, size_t size,
 #define BENCH_HMAC_SHA3_256      0x00000400
 #define BENCH_HMAC_SHA3_384      0x00000800
 #define BENCH_HMAC_SHA3_512      0x00001000
+#define BENCH_HMAC_SHA256_BATCH  0x00002000
 #define BENCH_HMAC               (BENCH_HMAC_MD5    | BENCH_HMAC_SHA    | \
                                   BENCH_HMAC_SHA224 | BENCH_HMAC_SHA256 | \
                                   BENCH_HMAC_SHA384 | BENCH_HMAC_SHA512 | \
@@ -896,6 +899,7 @@ static WC_INLINE void bench_append_memory_info(char* buffer, size_t size,
 #define BENCH_RSA_KEYGEN         0x00000001
 #define BENCH_RSA                0x00000002
 #define BENCH_RSA_SZ             0x00000004
+#define BENCH_RSA_MULTI          0x00000008
 #define BENCH_DH                 0x00000010
 #define BENCH_ECC_MAKEKEY        0x00001000
 #define BENCH_ECC                0x00002000
@@ -933,6 +937,7 @@ static WC_INLINE void bench_append_memory_info(char* buffer, size_t size,
 #define BENCH_ML_KEM_1024               0x00000080
 #define BENCH_ML_KEM                    (BENCH_ML_KEM_512 | BENCH_ML_KEM_768 | \
                                          BENCH_ML_KEM_1024)
+#define BENCH_ML_KEM_BATCH              0x00000800
 #define BENCH_FRODOKEM_640              0x00000100
 #define BENCH_FRODOKEM_976              0x00000200
 #define BENCH_FRODOKEM_1344             0x00000400
@@ -1156,6 +1161,14 @@ static const bench_alg bench_digest_opt[] = {
 #ifdef WOLFSSL_SHA512
     { "-sha512",             BENCH_SHA512            },
 #endif
+#ifdef WOLFSSL_SHA2_BATCH
+    #ifndef NO_SHA256
+    { "-sha256-batch",       BENCH_SHA256_BATCH      },
+    #endif
+    #ifdef WOLFSSL_SHA512
+    { "-sha512-batch",       BENCH_SHA512_BATCH      },
+    #endif
+#endif
 #ifdef WOLFSSL_SHA3
     { "-sha3",               BENCH_SHA3              },
     #ifndef WOLFSSL_NOSHA3_224
@@ -1233,6 +1246,9 @@ static const bench_alg bench_mac_opt[] = {
     #ifdef WOLFSSL_SHA512
     { "-hmac-sha512",        BENCH_HMAC_SHA512       },
     #endif
+    #if defined(WOLFSSL_SHA2_BATCH) && !defined(NO_SHA256)
+    { "-hmac-batch",         BENCH_HMAC_SHA256_BATCH },
+    #endif
     #ifdef WOLFSSL_SHA3
     #ifndef WOLFSSL_NOSHA3_256
     { "-hmac-sha3-256",      BENCH_HMAC_SHA3_256     },
@@ -1277,6 +1293,9 @@ static const bench_alg bench_asym_opt[] = {
     #ifdef WOLFSSL_KEY_GEN
     { "-rsa-sz",             BENCH_RSA_SZ            },
     #endif
+    #if defined(WOLFSSL_KEY_GEN) && defined(WOLFSSL_RSA_MULTI_PRIME)
+    { "-rsa-mp",             BENCH_RSA_MULTI         },
+    #endif
 #endif
 #ifndef NO_DH
     { "-dh",                 BENCH_DH                },
@@ -1431,6 +1450,9 @@ static const bench_pq_alg bench_pq_asym_opt[] = {
     { "-ml-kem-512",        BENCH_ML_KEM_512        },
     { "-ml-kem-768",        BENCH_ML_KEM_768        },
     { "-ml-kem-1024",       BENCH_ML_KEM_1024       },
+#ifdef WOLFSSL_MLKEM_BATCH
+    { "-ml-kem-batch",      BENCH_ML_KEM_BATCH      },
+#endif
 #endif
 #ifdef WOLFSSL_HAVE_FRODOKEM
     { "-frodokem",          BENCH_FRODOKEM          },
@@ -4260,6 +4282,23 @@ static void* benchmarks_do(void* args)
     }
 #endif /* WOLFSSL_NOSHA512_256 */
 #endif /* WOLFSSL_SHA512 */
+#ifdef WOLFSSL_SHA2_BATCH
+    /* Only run when asked for: compares per-message and batched hashing. */
+    #ifndef NO_SHA256
+    if (bench_digest_algs & BENCH_SHA256_BATCH) {
+    #ifndef NO_SW_BENCH
+        bench_sha256_batch();
+    #endif
+    }
+    #endif
+    #if defined(WOLFSSL_SHA512) && !defined(WOLF_CRYPTO_CB_ONLY_SHA512)
+    if (bench_digest_algs & BENCH_SHA512_BATCH) {
+    #ifndef NO_SW_BENCH
+        bench_sha512_batch();
+    #endif
+    }
+    #endif
+#endif /* WOLFSSL_SHA2_BATCH */
 
 #ifdef WOLFSSL_SHA3
     #ifndef WOLFSSL_NOSHA3_224
@@ -4430,6 +4469,14 @@ static void* benchmarks_do(void* args)
         #endif
         }
     #endif
+    #if defined(WOLFSSL_SHA2_BATCH) && !defined(NO_SHA256)
+        /* Only run when asked for: compares per-message and batched MACs. */
+        if (bench_mac_algs & BENCH_HMAC_SHA256_BATCH) {
+        #ifndef NO_SW_BENCH
+            bench_hmac_sha256_batch();
+        #endif
+        }
+    #endif
     #ifdef WOLFSSL_SHA3
     #ifndef WOLFSSL_NOSHA3_256
         if (bench_all || (bench_mac_algs & BENCH_HMAC_SHA3_256)) {
@@ -4529,6 +4576,16 @@ static void* benchmarks_do(void* args)
     #endif
     }
     #endif
+    #if defined(WOLFSSL_KEY_GEN) && defined(WOLFSSL_RSA_MULTI_PRIME)
+    if (bench_all || (bench_asym_algs & BENCH_RSA_MULTI)) {
+    #ifndef NO_SW_BENCH
+        bench_rsa_multi(0);
+    #endif
+    #ifdef BENCH_DEVID
+        bench_rsa_multi(1);
+    #endif
+    }
+    #endif
 #endif
 #endif /* !NO_RSA && !WC_NO_RNG */
 
@@ -4580,6 +4637,12 @@ static void* benchmarks_do(void* args)
     #endif
 #endif
     }
+#ifdef WOLFSSL_MLKEM_BATCH
+    /* Only run when asked for: compares batch sizes. */
+    if (bench_pq_asym_algs & BENCH_ML_KEM_BATCH) {
+        bench_mlkem_batch();
+    }
+#endif
 #endif
 
 #ifdef WOLFSSL_HAVE_FRODOKEM
@@ -8910,6 +8973,202 @@ exit:
 #endif /* WOLFSSL_SHA512 */
 
 
+#ifdef WOLFSSL_SHA2_BATCH
+/* Number of messages hashed per batch call. */
+#define BENCH_SHA2_BATCH_MSGS     32
+#define BENCH_SHA2_BATCH_MAX_SZ   1024
+
+/* Algorithms the batch benchmark compares. */
+#define BENCH_SHA2_BATCH_SHA256   0
+#define BENCH_SHA2_BATCH_SHA512   1
+#define BENCH_SHA2_BATCH_HMAC     2
+
+/* Message sizes to benchmark with descriptions for single and batch calls of
+ * each algorithm. */
+static const struct {
+    word32 sz;
+    const char* desc[3][2];
+} bench_sha2_batch_sz[] = {
+    {   64, { { "SHA-256 64B",       "SHA-256 64B x32"       },
+              { "SHA-512 64B",       "SHA-512 64B x32"       },
+              { "HMAC-SHA256 64B",   "HMAC-SHA256 64B x32"   } } },
+    {  256, { { "SHA-256 256B",      "SHA-256 256B x32"      },
+              { "SHA-512 256B",      "SHA-512 256B x32"      },
+              { "HMAC-SHA256 256B",  "HMAC-SHA256 256B x32"  } } },
+    { BENCH_SHA2_BATCH_MAX_SZ,
+            { { "SHA-256 1024B",     "SHA-256 1024B x32"     },
+              { "SHA-512 1024B",     "SHA-512 1024B x32"     },
+              { "HMAC-SHA256 1024B", "HMAC-SHA256 1024B x32" } } },
+};
+
+/* Hash or MAC all the messages, one call at a time or in one batch call. */
+static int bench_sha2_batch_op(int alg, int batch, const byte* const* data,
+    const word32* len, byte* const* hash, void* hmac)
+{
+    int ret = 0;
+    int i;
+
+    (void)hmac;
+
+    switch (alg) {
+    #ifndef NO_SHA256
+        case BENCH_SHA2_BATCH_SHA256:
+            if (batch) {
+                ret = wc_Sha256HashBatch(data, len, hash,
+                    BENCH_SHA2_BATCH_MSGS);
+            }
+            for (i = 0; (!batch) && (ret == 0) &&
+                        (i < BENCH_SHA2_BATCH_MSGS); i++) {
+                ret = wc_Sha256Hash(data[i], len[i], hash[i]);
+            }
+            break;
+    #endif
+    #if defined(WOLFSSL_SHA512) && !defined(WOLF_CRYPTO_CB_ONLY_SHA512)
+        case BENCH_SHA2_BATCH_SHA512:
+            if (batch) {
+                ret = wc_Sha512HashBatch(data, len, hash,
+                    BENCH_SHA2_BATCH_MSGS);
+            }
+            for (i = 0; (!batch) && (ret == 0) &&
+                        (i < BENCH_SHA2_BATCH_MSGS); i++) {
+                ret = wc_Sha512Hash(data[i], len[i], hash[i]);
+            }
+            break;
+    #endif
+    #if !defined(NO_HMAC) && !defined(NO_SHA256)
+        case BENCH_SHA2_BATCH_HMAC:
+            if (batch) {
+                ret = wc_HmacSha256Batch(bench_key, 32, data, len, hash,
+                    BENCH_SHA2_BATCH_MSGS);
+            }
+            /* Key was set once - each final leaves HMAC ready for next. */
+            for (i = 0; (!batch) && (ret == 0) &&
+                        (i < BENCH_SHA2_BATCH_MSGS); i++) {
+                ret = wc_HmacUpdate((Hmac*)hmac, data[i], len[i]);
+                if (ret == 0)
+                    ret = wc_HmacFinal((Hmac*)hmac, hash[i]);
+            }
+            break;
+    #endif
+        default:
+            ret = NOT_COMPILED_IN;
+            break;
+    }
+
+    return ret;
+}
+
+/* Hash small messages one call at a time and in batches. */
+static void bench_sha2_batch(int alg)
+{
+    int ret = 0, i, times, count = 0, batch;
+    word32 s;
+    double start;
+    byte* in = NULL;
+    byte* out = NULL;
+    const byte* data[BENCH_SHA2_BATCH_MSGS];
+    word32 len[BENCH_SHA2_BATCH_MSGS];
+    byte* hash[BENCH_SHA2_BATCH_MSGS];
+#if !defined(NO_HMAC) && !defined(NO_SHA256)
+    Hmac hmac;
+#endif
+    void* hmacPtr = NULL;
+    DECLARE_MULTI_VALUE_STATS_VARS()
+
+    in = (byte*)XMALLOC(BENCH_SHA2_BATCH_MAX_SZ * BENCH_SHA2_BATCH_MSGS,
+        HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    out = (byte*)XMALLOC(WC_MAX_DIGEST_SIZE * BENCH_SHA2_BATCH_MSGS,
+        HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    if (in == NULL || out == NULL) {
+        printf("bench_sha2_batch malloc failed\n");
+        goto exit;
+    }
+    XMEMSET(in, 0, BENCH_SHA2_BATCH_MAX_SZ * BENCH_SHA2_BATCH_MSGS);
+
+#if !defined(NO_HMAC) && !defined(NO_SHA256)
+    if (alg == BENCH_SHA2_BATCH_HMAC) {
+        if ((ret = wc_HmacInit(&hmac, HEAP_HINT, INVALID_DEVID)) != 0) {
+            printf("wc_HmacInit failed, ret = %d\n", ret);
+            goto exit;
+        }
+        hmacPtr = &hmac;
+        if ((ret = wc_HmacSetKey(&hmac, WC_SHA256, bench_key, 32)) != 0) {
+            printf("wc_HmacSetKey failed, ret = %d\n", ret);
+            goto exit;
+        }
+    }
+#endif
+
+    for (s = 0; s < sizeof(bench_sha2_batch_sz) /
+                    sizeof(bench_sha2_batch_sz[0]); s++) {
+        word32 msgSz = bench_sha2_batch_sz[s].sz;
+
+        for (i = 0; i < BENCH_SHA2_BATCH_MSGS; i++) {
+            data[i] = in + (word32)i * msgSz;
+            len[i]  = msgSz;
+            hash[i] = out + i * WC_MAX_DIGEST_SIZE;
+        }
+
+        for (batch = 0; batch <= 1; batch++) {
+            bench_stats_prepare();
+            bench_stats_start(&count, &start);
+            do {
+                for (times = 0; times < numBlocks; times++) {
+                    ret = bench_sha2_batch_op(alg, batch, data, len, hash,
+                        hmacPtr);
+                    if (ret != 0) {
+                        printf("SHA-2 batch failed, ret = %d\n", ret);
+                        goto exit;
+                    }
+                    RECORD_MULTI_VALUE_STATS();
+                }
+                count += times;
+            } while (bench_stats_check(start)
+#ifdef MULTI_VALUE_STATISTICS
+                   || runs < minimum_runs
+#endif
+                   );
+
+            bench_stats_sym_finish(bench_sha2_batch_sz[s].desc[alg][batch], 0,
+                count, (int)(msgSz * BENCH_SHA2_BATCH_MSGS), start, ret);
+#ifdef MULTI_VALUE_STATISTICS
+            bench_multi_value_stats(max, min, sum, squareSum, runs);
+#endif
+        }
+    }
+
+exit:
+#if !defined(NO_HMAC) && !defined(NO_SHA256)
+    if (hmacPtr != NULL)
+        wc_HmacFree(&hmac);
+#endif
+    XFREE(out, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(in, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+}
+
+#ifndef NO_SHA256
+void bench_sha256_batch(void)
+{
+    bench_sha2_batch(BENCH_SHA2_BATCH_SHA256);
+}
+#endif
+
+#if defined(WOLFSSL_SHA512) && !defined(WOLF_CRYPTO_CB_ONLY_SHA512)
+void bench_sha512_batch(void)
+{
+    bench_sha2_batch(BENCH_SHA2_BATCH_SHA512);
+}
+#endif
+
+#if !defined(NO_HMAC) && !defined(NO_SHA256)
+void bench_hmac_sha256_batch(void)
+{
+    bench_sha2_batch(BENCH_SHA2_BATCH_HMAC);
+}
+#endif
+#endif /* WOLFSSL_SHA2_BATCH */
+
+
 #ifdef WOLFSSL_SHA3
 #ifndef WOLFSSL_NOSHA3_224
 void bench_sha3_224(int useDeviceID)
@@ -11062,7 +11321,7 @@ static void bench_rsa_helper(int useDeviceID,
                                           RsaKey,
                                           BENCH_MAX_PENDING,
                                           sizeof(RsaKey)),
-                             word32 rsaKeySz)
+                             word32 rsaKeySz, const char* algo)
 {
     int         ret = 0, i, times, count = 0, pending = 0;
     word32      idx = 0;
@@ -11145,7 +11404,7 @@ static void bench_rsa_helper(int useDeviceID,
            );
 
 exit_rsa_verify:
-        bench_stats_asym_finish("RSA", (int)rsaKeySz, desc[0],
+        bench_stats_asym_finish(algo, (int)rsaKeySz, desc[0],
                                 useDeviceID, count, start, ret);
     #ifdef MULTI_VALUE_STATISTICS
         bench_multi_value_stats(max, min, sum, squareSum, runs);
@@ -11192,7 +11451,7 @@ exit_rsa_verify:
            );
 
 exit_rsa_pub:
-        bench_stats_asym_finish("RSA", (int)rsaKeySz, desc[1],
+        bench_stats_asym_finish(algo, (int)rsaKeySz, desc[1],
                                 useDeviceID, count, start, ret);
     #ifdef MULTI_VALUE_STATISTICS
         bench_multi_value_stats(max, min, sum, squareSum, runs);
@@ -11231,7 +11490,7 @@ exit_rsa_pub:
            );
 
 exit_rsa_sign:
-        bench_stats_asym_finish("RSA", (int)rsaKeySz, desc[4], useDeviceID,
+        bench_stats_asym_finish(algo, (int)rsaKeySz, desc[4], useDeviceID,
                                 count, start, ret);
     #ifdef MULTI_VALUE_STATISTICS
         bench_multi_value_stats(max, min, sum, squareSum, runs);
@@ -11298,7 +11557,7 @@ exit_rsa_sign:
            );
 
 exit_rsa_verifyinline:
-        bench_stats_asym_finish("RSA", (int)rsaKeySz, desc[5],
+        bench_stats_asym_finish(algo, (int)rsaKeySz, desc[5],
                                  useDeviceID, count,  start, ret);
     #ifdef MULTI_VALUE_STATISTICS
         bench_multi_value_stats(max, min, sum, squareSum, runs);
@@ -11408,7 +11667,7 @@ void bench_rsa(int useDeviceID)
     }
 
     if (rsaKeySz > 0) {
-        bench_rsa_helper(useDeviceID, rsaKey, rsaKeySz);
+        bench_rsa_helper(useDeviceID, rsaKey, rsaKeySz, "RSA");
     }
 
     (void)bytes;
@@ -11473,7 +11732,7 @@ void bench_rsa_key(int useDeviceID, word32 rsaKeySz)
         } /* for i */
     } while (pending > 0);
 
-    bench_rsa_helper(useDeviceID, rsaKey, rsaKeySz);
+    bench_rsa_helper(useDeviceID, rsaKey, rsaKeySz, "RSA");
 exit:
 
     /* cleanup */
@@ -11484,6 +11743,61 @@ exit:
         WC_FREE_ARRAY(rsaKey, BENCH_MAX_PENDING, HEAP_HINT);
     }
 }
+
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+/* bench 3-prime RSA keys at the sizes where they are allowed */
+void bench_rsa_multi(int useDeviceID)
+{
+    int     ret = 0, i, k;
+    WC_DECLARE_ARRAY(rsaKey, RsaKey, BENCH_MAX_PENDING,
+                     sizeof(RsaKey), HEAP_HINT);
+    long    exp = 65537L;
+#if RSA_MAX_SIZE >= 4096
+    static const word32 keySizes[2] = { 3072, 4096 };
+#else
+    static const word32 keySizes[1] = { 3072 };
+#endif
+
+    WC_CALLOC_ARRAY(rsaKey, RsaKey, BENCH_MAX_PENDING,
+                     sizeof(RsaKey), HEAP_HINT);
+
+    for (k = 0; k < (int)(sizeof(keySizes)/sizeof(keySizes[0])); k++) {
+        for (i = 0; i < BENCH_MAX_PENDING; i++) {
+            if (wc_InitRsaKey_ex(rsaKey[i], HEAP_HINT,
+                    useDeviceID ? devId : INVALID_DEVID) < 0) {
+                goto exit;
+            }
+        #ifdef WC_RSA_BLINDING
+            ret = wc_RsaSetRNG(rsaKey[i], &gRng);
+            if (ret != 0)
+                goto exit;
+        #endif
+            /* create the 3-prime RSA key */
+            ret = wc_MakeRsaKeyMultiPrime(rsaKey[i], (int)keySizes[k], exp, 3,
+                &gRng);
+            if (ret != 0) {
+                printf("wc_MakeRsaKeyMultiPrime failed! %d\n", ret);
+                goto exit;
+            }
+        }
+
+        bench_rsa_helper(useDeviceID, rsaKey, keySizes[k], "RSA-3P");
+
+        for (i = 0; i < BENCH_MAX_PENDING; i++) {
+            wc_FreeRsaKey(rsaKey[i]);
+        }
+    }
+
+exit:
+    /* cleanup */
+    if (WC_ARRAY_OK(rsaKey)) {
+        for (i = 0; i < BENCH_MAX_PENDING; i++) {
+            wc_FreeRsaKey(rsaKey[i]);
+        }
+        WC_FREE_ARRAY(rsaKey, BENCH_MAX_PENDING, HEAP_HINT);
+    }
+}
+#endif /* WOLFSSL_RSA_MULTI_PRIME */
 #endif /* WOLFSSL_KEY_GEN */
 #endif /* !NO_RSA && !WC_NO_RNG */
 
@@ -12023,6 +12337,138 @@ void bench_mlkem(int type)
     WC_FREE_VAR_EX(key1, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
     WC_FREE_VAR_EX(key2, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
 }
+#ifdef WOLFSSL_MLKEM_BATCH
+/* Keys encapsulated/decapsulated per batch call. */
+static const int bench_mlkem_batch_sz[] = { 1, 2, 4, 8 };
+#define BENCH_MLKEM_BATCH_MAX   8
+
+/* Encapsulate and decapsulate with one, two, four and eight keys per batch
+ * call. Operations per second count keys, so the sizes compare directly. */
+static void bench_mlkem_batch_type(int type, const char* name, int keySize)
+{
+    int ret = 0, i, times, count = 0, pending = 0;
+    size_t s;
+    double start;
+    const char**desc = bench_desc_words[lng_index];
+    char label[32];
+    MlKemKey* keys = NULL;
+    byte* buf = NULL;
+    MlKemKey* key[BENCH_MLKEM_BATCH_MAX];
+    byte* ct[BENCH_MLKEM_BATCH_MAX];
+    byte* ss[BENCH_MLKEM_BATCH_MAX];
+    const byte* ctIn[BENCH_MLKEM_BATCH_MAX];
+    word32 len[BENCH_MLKEM_BATCH_MAX];
+    int inited = 0;
+    DECLARE_MULTI_VALUE_STATS_VARS()
+
+    keys = (MlKemKey*)XMALLOC(sizeof(MlKemKey) * BENCH_MLKEM_BATCH_MAX,
+        HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    buf = (byte*)XMALLOC((WC_ML_KEM_MAX_CIPHER_TEXT_SIZE + WC_ML_KEM_SS_SZ) *
+        BENCH_MLKEM_BATCH_MAX, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    if ((keys == NULL) || (buf == NULL)) {
+        ret = MEMORY_E;
+        goto exit;
+    }
+
+    for (i = 0; i < BENCH_MLKEM_BATCH_MAX; i++) {
+        key[i] = &keys[i];
+        ct[i] = buf + i * WC_ML_KEM_MAX_CIPHER_TEXT_SIZE;
+        ss[i] = buf + BENCH_MLKEM_BATCH_MAX * WC_ML_KEM_MAX_CIPHER_TEXT_SIZE +
+            i * WC_ML_KEM_SS_SZ;
+        ctIn[i] = ct[i];
+        ret = wc_MlKemKey_Init(key[i], type, HEAP_HINT, INVALID_DEVID);
+        if (ret != 0) {
+            goto exit;
+        }
+        inited++;
+        ret = wc_MlKemKey_MakeKey(key[i], &gRng);
+        if (ret == 0) {
+            ret = wc_MlKemKey_CipherTextSize(key[i], &len[i]);
+        }
+        if (ret != 0) {
+            goto exit;
+        }
+    }
+
+    for (s = 0; s < sizeof(bench_mlkem_batch_sz) /
+                    sizeof(bench_mlkem_batch_sz[0]); s++) {
+        int n = bench_mlkem_batch_sz[s];
+
+        (void)XSNPRINTF(label, sizeof(label), "%s x%d", name, n);
+
+        bench_stats_prepare();
+        bench_stats_start(&count, &start);
+        do {
+            for (times = 0; times < agreeTimes || pending > 0; times += n) {
+                ret = wc_MlKemKey_EncapsulateBatch(key, ct, ss, &gRng, n);
+                if (ret != 0)
+                    goto exit;
+                RECORD_MULTI_VALUE_STATS();
+            }
+            count += times;
+        } while (bench_stats_check(start)
+#ifdef MULTI_VALUE_STATISTICS
+           || runs < minimum_runs
+#endif
+           );
+        bench_stats_asym_finish(label, keySize, desc[9], 0, count, start, ret);
+#ifdef MULTI_VALUE_STATISTICS
+        bench_multi_value_stats(max, min, sum, squareSum, runs);
+#endif
+
+        RESET_MULTI_VALUE_STATS_VARS();
+
+        PRIVATE_KEY_UNLOCK();
+        bench_stats_start(&count, &start);
+        do {
+            for (times = 0; times < agreeTimes || pending > 0; times += n) {
+                ret = wc_MlKemKey_DecapsulateBatch(key, ss, ctIn, len, n);
+                if (ret != 0)
+                    break;
+                RECORD_MULTI_VALUE_STATS();
+            }
+            count += times;
+        } while ((ret == 0) && (bench_stats_check(start)
+#ifdef MULTI_VALUE_STATISTICS
+           || runs < minimum_runs
+#endif
+           ));
+        PRIVATE_KEY_LOCK();
+        bench_stats_asym_finish(label, keySize, desc[13], 0, count, start,
+            ret);
+#ifdef MULTI_VALUE_STATISTICS
+        bench_multi_value_stats(max, min, sum, squareSum, runs);
+#endif
+        if (ret != 0)
+            goto exit;
+
+        RESET_MULTI_VALUE_STATS_VARS();
+    }
+
+exit:
+    for (i = 0; i < inited; i++) {
+        wc_MlKemKey_Free(key[i]);
+    }
+    XFREE(buf, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+    XFREE(keys, HEAP_HINT, DYNAMIC_TYPE_TMP_BUFFER);
+
+    if (ret != 0)
+        printf("error: bench_mlkem_batch() failed with code %d.\n", ret);
+}
+
+void bench_mlkem_batch(void)
+{
+#ifdef WOLFSSL_WC_ML_KEM_512
+    bench_mlkem_batch_type(WC_ML_KEM_512, "ML-KEM 512 ", 128);
+#endif
+#ifdef WOLFSSL_WC_ML_KEM_768
+    bench_mlkem_batch_type(WC_ML_KEM_768, "ML-KEM 768 ", 192);
+#endif
+#ifdef WOLFSSL_WC_ML_KEM_1024
+    bench_mlkem_batch_type(WC_ML_KEM_1024, "ML-KEM 1024", 256);
+#endif
+}
+#endif /* WOLFSSL_MLKEM_BATCH */
 #endif
 
 #ifdef WOLFSSL_HAVE_FRODOKEM
@@ -80,6 +80,8 @@ void bench_sha512_224(int useDeviceID);
    (!defined(HAVE_FIPS) || FIPS_VERSION_GE(5, 3)) && !defined(HAVE_SELFTEST)
 void bench_sha512_256(int useDeviceID);
 #endif
+void bench_sha256_batch(void);
+void bench_sha512_batch(void);
 void bench_sha3_224(int useDeviceID);
 void bench_sha3_256(int useDeviceID);
 void bench_sha3_384(int useDeviceID);
@@ -98,6 +100,7 @@ void bench_hmac_sha224(int useDeviceID);
 void bench_hmac_sha256(int useDeviceID);
 void bench_hmac_sha384(int useDeviceID);
 void bench_hmac_sha512(int useDeviceID);
+void bench_hmac_sha256_batch(void);
 void bench_hmac_sha3_256(int useDeviceID);
 void bench_hmac_sha3_384(int useDeviceID);
 void bench_hmac_sha3_512(int useDeviceID);
@@ -107,8 +110,10 @@ void bench_rsaKeyGen(int useDeviceID);
 void bench_rsaKeyGen_size(int useDeviceID, word32 keySz);
 void bench_rsa(int useDeviceID);
 void bench_rsa_key(int useDeviceID, word32 keySz);
+void bench_rsa_multi(int useDeviceID);
 void bench_dh(int useDeviceID);
 void bench_mlkem(int type);
+void bench_mlkem_batch(void);
 void bench_frodokem(int type);
 void bench_lms(void);
 void bench_xmss(int hash);
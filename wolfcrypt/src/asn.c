@@ -8786,6 +8786,9 @@ static const ASNItem rsaKeyASN[] = {
 /*  U   */        { 1, ASN_INTEGER, 0, 0, 0 },
                 /* otherPrimeInfos  OtherPrimeInfos OPTIONAL
                  * v2 - multiprime */
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+/*  OTHER */      { 1, ASN_SEQUENCE, 1, 0, 1 },
+#endif
 #endif
 };
 enum {
@@ -8802,12 +8805,120 @@ enum {
     RSAKEYASN_IDX_DP,
     RSAKEYASN_IDX_DQ,
     RSAKEYASN_IDX_U,
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    RSAKEYASN_IDX_OTHER,
+#endif
 #endif
     WOLF_ENUM_DUMMY_LAST_ELEMENT(RSAKEYASN_IDX)
 };
 
 /* Number of items in ASN.1 template for an RSA private key. */
 #define rsaKeyASN_Length (sizeof(rsaKeyASN) / sizeof(ASNItem))
+
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+/* ASN.1 template for an additional prime of a multi-prime RSA private key.
+ * PKCS #1: RFC 8017, A.1.2 - OtherPrimeInfo
+ */
+static const ASNItem rsaOtherPrimeASN[] = {
+/*  SEQ */    { 0, ASN_SEQUENCE, 1, 1, 0 },
+/*  R   */        { 1, ASN_INTEGER, 0, 0, 0 },
+/*  D   */        { 1, ASN_INTEGER, 0, 0, 0 },
+/*  T   */        { 1, ASN_INTEGER, 0, 0, 0 },
+};
+enum {
+    RSAOTHERPRIMEASN_IDX_SEQ = 0,
+    RSAOTHERPRIMEASN_IDX_R,
+    RSAOTHERPRIMEASN_IDX_D,
+    RSAOTHERPRIMEASN_IDX_T
+};
+
+/* Number of items in ASN.1 template for an OtherPrimeInfo. */
+#define rsaOtherPrimeASN_Length (sizeof(rsaOtherPrimeASN) / sizeof(ASNItem))
+
+/* Decode the additional primes of a multi-prime RSA private key.
+ *
+ * PKCS #1: RFC 8017, A.1.2 - OtherPrimeInfos
+ *
+ * @param [in]      input  Contents of the OtherPrimeInfos SEQUENCE.
+ * @param [in]      sz     Number of bytes in input.
+ * @param [in, out] key    RSA key object.
+ * @return  0 on success.
+ * @return  ASN_PARSE_E when there are no or too many OtherPrimeInfo items or
+ *          BER encoded data does not match ASN.1 items.
+ */
+static int DecodeRsaOtherPrimes(const byte* input, word32 sz, RsaKey* key)
+{
+    word32 idx = 0;
+    int ret = 0;
+    int cnt = 0;
+
+    while ((ret == 0) && (idx < sz)) {
+        ASNGetData dataASN[rsaOtherPrimeASN_Length];
+
+        if (cnt == WC_RSA_MAX_PRIMES - 2) {
+            WOLFSSL_MSG("Too many primes in RSA key");
+            ret = ASN_PARSE_E;
+            break;
+        }
+        XMEMSET(dataASN, 0, sizeof(dataASN));
+        GetASN_MP(&dataASN[RSAOTHERPRIMEASN_IDX_R], &key->other[cnt].r);
+        GetASN_MP(&dataASN[RSAOTHERPRIMEASN_IDX_D], &key->other[cnt].d);
+        GetASN_MP(&dataASN[RSAOTHERPRIMEASN_IDX_T], &key->other[cnt].t);
+        ret = GetASN_Items(rsaOtherPrimeASN, dataASN, rsaOtherPrimeASN_Length,
+            1, input, &idx, sz);
+        if (ret == 0) {
+            cnt++;
+        }
+    }
+    /* OtherPrimeInfos is SIZE(1..MAX). */
+    if ((ret == 0) && (cnt == 0)) {
+        ret = ASN_PARSE_E;
+    }
+    if (ret == 0) {
+        key->otherCnt = cnt;
+    }
+
+    return ret;
+}
+
+#ifdef WOLFSSL_KEY_TO_DER
+/* Encode the additional primes of a multi-prime RSA private key.
+ *
+ * PKCS #1: RFC 8017, A.1.2 - OtherPrimeInfos
+ *
+ * @param [in]  key     RSA key object.
+ * @param [out] output  Buffer to put encoded data in. May be NULL.
+ * @param [out] outSz   Size of encoding in bytes.
+ * @return  0 on success.
+ */
+static int EncodeRsaOtherPrimes(RsaKey* key, byte* output, word32* outSz)
+{
+    word32 total = 0;
+    int ret = 0;
+    int i;
+
+    for (i = 0; (ret == 0) && (i < key->otherCnt); i++) {
+        ASNSetData dataASN[rsaOtherPrimeASN_Length];
+        word32 sz = 0;
+
+        XMEMSET(dataASN, 0, sizeof(dataASN));
+        SetASN_MP(&dataASN[RSAOTHERPRIMEASN_IDX_R], &key->other[i].r);
+        SetASN_MP(&dataASN[RSAOTHERPRIMEASN_IDX_D], &key->other[i].d);
+        SetASN_MP(&dataASN[RSAOTHERPRIMEASN_IDX_T], &key->other[i].t);
+        ret = SizeASN_Items(rsaOtherPrimeASN, dataASN, rsaOtherPrimeASN_Length,
+            &sz);
+        if ((ret == 0) && (output != NULL)) {
+            SetASN_Items(rsaOtherPrimeASN, dataASN, rsaOtherPrimeASN_Length,
+                output + total);
+        }
+        total += sz;
+    }
+    *outSz = total;
+
+    return ret;
+}
+#endif /* WOLFSSL_KEY_TO_DER */
+#endif /* WOLFSSL_RSA_MULTI_PRIME */
 #endif
 
 /* Decode RSA private key.
@@ -8895,11 +9006,24 @@ static int _RsaPrivateKeyDecode(const byte* input, word32* inOutIdx,
     }
     /* Check version: 0 - two prime, 1 - multi-prime
      * Multi-prime has optional sequence after coefficient for extra primes.
-     * If extra primes, parsing will fail as not all the buffer was used.
+     * If extra primes and not supported, parsing will fail as not all the
+     * buffer was used.
      */
     if ((ret == 0) && (version > PKCS1v1)) {
         ret = ASN_PARSE_E;
     }
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    /* Only version 1 has, and must have, other primes. */
+    if ((ret == 0) && ((version == PKCS1v1) !=
+            (dataASN[RSAKEYASN_IDX_OTHER].tag != 0))) {
+        ret = ASN_PARSE_E;
+    }
+    if ((ret == 0) && (key != NULL) && (version == PKCS1v1)) {
+        ret = DecodeRsaOtherPrimes(
+            dataASN[RSAKEYASN_IDX_OTHER].data.ref.data,
+            dataASN[RSAKEYASN_IDX_OTHER].data.ref.length, key);
+    }
+#endif
     if ((ret == 0) && (key != NULL)) {
     #if !defined(WOLFSSL_RSA_PUBLIC_ONLY)
         /* RSA key object has all private key values. */
@@ -27194,6 +27318,10 @@ int wc_RsaKeyToDer(RsaKey* key, byte* output, word32 outLen)
     int i;
     word32 sz = 0;
     int ret = 0;
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    byte* other = NULL;
+    word32 otherSz = 0;
+#endif
 
     if ((key == NULL) || (key->type != RSA_PRIVATE)) {
         ret = BAD_FUNC_ARG;
@@ -27202,9 +27330,37 @@ int wc_RsaKeyToDer(RsaKey* key, byte* output, word32 outLen)
     if (ret == 0)
         CALLOC_ASNSETDATA(dataASN, rsaKeyASN_Length, ret, key->heap);
 
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    if ((ret == 0) && (key->otherCnt > 0)) {
+        /* Encode the other primes to put in the OtherPrimeInfos. */
+        ret = EncodeRsaOtherPrimes(key, NULL, &otherSz);
+        if (ret == 0) {
+            other = (byte*)XMALLOC(otherSz, key->heap,
+                DYNAMIC_TYPE_TMP_BUFFER);
+            if (other == NULL) {
+                ret = MEMORY_E;
+            }
+        }
+        if (ret == 0) {
+            ret = EncodeRsaOtherPrimes(key, other, &otherSz);
+        }
+    }
+#endif
+
     if (ret == 0) {
         /* Set the version. */
+    #ifdef WOLFSSL_RSA_MULTI_PRIME
+        SetASN_Int8Bit(&dataASN[RSAKEYASN_IDX_VER],
+            (key->otherCnt > 0) ? PKCS1v1 : PKCS1v0);
+        if (key->otherCnt > 0) {
+            SetASN_Buffer(&dataASN[RSAKEYASN_IDX_OTHER], other, otherSz);
+        }
+        else {
+            dataASN[RSAKEYASN_IDX_OTHER].noOut = 1;
+        }
+    #else
         SetASN_Int8Bit(&dataASN[RSAKEYASN_IDX_VER], 0);
+    #endif
         /* Set all the mp_ints in private key. */
         for (i = 0; i < RSA_INTS; i++) {
             SetASN_MP(&dataASN[(byte)RSAKEYASN_IDX_N + i], GetRsaInt(key, i));
@@ -27227,6 +27383,12 @@ int wc_RsaKeyToDer(RsaKey* key, byte* output, word32 outLen)
         ret = (int)sz;
     }
 
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    if (other != NULL) {
+        ForceZero(other, otherSz);
+        XFREE(other, key->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    }
+#endif
     FREE_ASNSETDATA(dataASN, key != NULL ? key->heap : NULL);
     return ret;
 }
@@ -37135,6 +37297,9 @@ static int GetRevoked(RevokedCert* rcert, const byte* buff, word32* idx,
     word32 serialSz = EXTERNAL_SERIAL_SIZE;
     word32 revDateSz = MAX_DATE_SIZE;
     RevokedCert* rc;
+#ifdef HAVE_CRL_MMAP
+    RevokedCert  cbCert;
+#endif
 #ifdef CRL_STATIC_REVOKED_LIST
     int totalCerts = dcrl->totalCerts;
 
@@ -37145,15 +37310,25 @@ static int GetRevoked(RevokedCert* rcert, const byte* buff, word32* idx,
     rc = &rcert[totalCerts];
 
 #else
-    /* Allocate a new revoked certificate object. */
-    rc = (RevokedCert*)XMALLOC(sizeof(RevokedCert), dcrl->heap,
-            DYNAMIC_TYPE_CRL);
-    if (rc == NULL) {
-        ret = MEMORY_E;
-    }
-    if (ret == 0) {
+#ifdef HAVE_CRL_MMAP
+    if (dcrl->revokedCallback != NULL) {
+        /* Cert is handed to the callback, decode into a scratch object. */
+        rc = &cbCert;
         XMEMSET(rc, 0, sizeof(RevokedCert));
     }
+    else
+#endif
+    {
+        /* Allocate a new revoked certificate object. */
+        rc = (RevokedCert*)XMALLOC(sizeof(RevokedCert), dcrl->heap,
+                DYNAMIC_TYPE_CRL);
+        if (rc == NULL) {
+            ret = MEMORY_E;
+        }
+        if (ret == 0) {
+            XMEMSET(rc, 0, sizeof(RevokedCert));
+        }
+    }
 #endif /* CRL_STATIC_REVOKED_LIST */
 
     CALLOC_ASNGETDATA(dataASN, revokedASN_Length, ret, dcrl->heap);
@@ -37201,8 +37376,13 @@ static int GetRevoked(RevokedCert* rcert, const byte* buff, word32* idx,
 
 #if defined(OPENSSL_EXTRA)
                 /* Store raw DER of extension contents for OpenSSL compat. */
-                rc->extensions = (byte*)XMALLOC((size_t)extLen, dcrl->heap,
-                                                DYNAMIC_TYPE_REVOKED);
+            #ifdef HAVE_CRL_MMAP
+                if (dcrl->revokedCallback == NULL)
+            #endif
+                {
+                    rc->extensions = (byte*)XMALLOC((size_t)extLen,
+                            dcrl->heap, DYNAMIC_TYPE_REVOKED);
+                }
                 if (rc->extensions != NULL) {
                     XMEMCPY(rc->extensions, buff + extOff, (size_t)extLen);
                     rc->extensionsSz = (word32)extLen;
@@ -37214,6 +37394,22 @@ static int GetRevoked(RevokedCert* rcert, const byte* buff, word32* idx,
             }
         }
 
+    #ifdef HAVE_CRL_MMAP
+        if ((ret == 0) && (dcrl->revokedCallback != NULL)) {
+            /* The serial number content ends where the revocation date
+             * starts. Pass the callback the serial in the source buffer. */
+            word32 dateIdx = (dataASN[REVOKEDASN_IDX_TIME_UTC].tag != 0)
+                    ? dataASN[REVOKEDASN_IDX_TIME_UTC].offset
+                    : dataASN[REVOKEDASN_IDX_TIME_GT].offset;
+
+            ret = dcrl->revokedCallback(dcrl->revokedCallbackCtx,
+                    buff + dateIdx - serialSz, (int)serialSz);
+            if (ret == 0) {
+                dcrl->totalCerts++;
+            }
+        }
+        else
+    #endif
         if (ret == 0) {
             /* Add revoked certificate to chain. */
 #ifndef CRL_STATIC_REVOKED_LIST
@@ -37232,7 +37428,12 @@ static int GetRevoked(RevokedCert* rcert, const byte* buff, word32* idx,
         rc->extensionsSz = 0;
 #endif
 #ifndef CRL_STATIC_REVOKED_LIST
-        XFREE(rc, dcrl->heap, DYNAMIC_TYPE_CRL);
+    #ifdef HAVE_CRL_MMAP
+        if (rc != &cbCert)
+    #endif
+        {
+            XFREE(rc, dcrl->heap, DYNAMIC_TYPE_CRL);
+        }
 #endif
     }
 #ifndef CRL_STATIC_REVOKED_LIST
@@ -248,6 +248,34 @@ static int _RsaPrivateKeyDecode(const byte* input, word32* inOutIdx,
          }
    #endif
 
+    #ifdef WOLFSSL_RSA_MULTI_PRIME
+        /* Version 1 keys have OtherPrimeInfos after the coefficient. */
+        if (version == PKCS1v1) {
+            word32 end;
+
+            if (GetSequence(input, inOutIdx, &length, inSz) < 0)
+                return ASN_PARSE_E;
+            end = *inOutIdx + (word32)length;
+            key->otherCnt = 0;
+            while (*inOutIdx < end) {
+                RsaOtherPrime* o;
+
+                if (key->otherCnt == WC_RSA_MAX_PRIMES - 2)
+                    return ASN_PARSE_E;
+                o = &key->other[key->otherCnt];
+                if ((GetSequence(input, inOutIdx, &length, end) < 0) ||
+                        (GetInt(&o->r, input, inOutIdx, end) < 0) ||
+                        (GetInt(&o->d, input, inOutIdx, end) < 0) ||
+                        (GetInt(&o->t, input, inOutIdx, end) < 0)) {
+                    return ASN_RSA_KEY_E;
+                }
+                key->otherCnt++;
+            }
+            if (key->otherCnt == 0)
+                return ASN_PARSE_E;
+        }
+    #endif
+
     #if defined(WOLFSSL_XILINX_CRYPT) || defined(WOLFSSL_CRYPTOCELL)
         if (wc_InitRsaHw(key) != 0) {
             return BAD_STATE_E;
@@ -4904,6 +4932,12 @@ int wc_RsaKeyToDer(RsaKey* key, byte* output, word32 inLen)
     if (key->type != RSA_PRIVATE)
         return BAD_FUNC_ARG;
 
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    /* OtherPrimeInfos only encoded with the ASN.1 template code. */
+    if (key->otherCnt > 0)
+        return BAD_FUNC_ARG;
+#endif
+
 #ifndef WOLFSSL_NO_MALLOC
     for (i = 0; i < RSA_INTS; i++)
         tmps[i] = NULL;
@@ -331,6 +331,397 @@ int wc_AsyncSwInit(WC_ASYNC_DEV* dev, int type)
     return 0;
 }
 
+#ifdef WOLFSSL_ASYNC_THREADPOOL
+
+#ifdef __linux__
+    #include <sys/eventfd.h>
+#else
+    #include <fcntl.h>
+#endif
+
+/* WC_ASYNC_DEV.poolState */
+enum {
+    ASYNC_POOL_NONE = 0,    /* op not handed to the pool */
+    ASYNC_POOL_QUEUED,      /* waiting for a worker */
+    ASYNC_POOL_RUNNING,     /* a worker is running the op */
+    ASYNC_POOL_DONE         /* poolRet holds the result */
+};
+
+typedef struct WC_ASYNC_POOL {
+    pthread_cond_t  workCond;   /* signaled when an op is queued */
+    pthread_cond_t  doneCond;   /* broadcast when an op completes */
+    pthread_t       thread[WC_ASYNC_POOL_MAX_THREADS];
+    int             threadCnt;
+    WC_ASYNC_DEV*   job[WC_ASYNC_POOL_MAX_JOBS];
+    int             jobHead;
+    int             jobCnt;
+    int             refCnt;
+    int             stop;
+    int             notifyFd[2]; /* read end, write end (same for eventfd) */
+} WC_ASYNC_POOL;
+
+static WC_ASYNC_POOL wolfAsyncPool;
+/* guards the pool state and the poolState of every device */
+static pthread_mutex_t wolfAsyncPoolLock = PTHREAD_MUTEX_INITIALIZER;
+/* serializes starting and stopping the pool */
+static pthread_mutex_t wolfAsyncPoolInitLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Only the public key operations are worth a thread hand off. */
+static int wolfAsync_PoolType(int type)
+{
+    switch (type) {
+#ifdef HAVE_ECC
+        case ASYNC_SW_ECC_MAKE:
+    #ifdef HAVE_ECC_SIGN
+        case ASYNC_SW_ECC_SIGN:
+    #endif
+    #ifdef HAVE_ECC_VERIFY
+        case ASYNC_SW_ECC_VERIFY:
+    #endif
+    #ifdef HAVE_ECC_DHE
+        case ASYNC_SW_ECC_SHARED_SEC:
+    #endif
+#endif /* HAVE_ECC */
+#ifndef NO_RSA
+    #ifdef WOLFSSL_KEY_GEN
+        case ASYNC_SW_RSA_MAKE:
+    #endif
+        case ASYNC_SW_RSA_FUNC:
+#endif /* !NO_RSA */
+#ifndef NO_DH
+        case ASYNC_SW_DH_AGREE:
+        case ASYNC_SW_DH_GEN:
+#endif /* !NO_DH */
+#ifdef HAVE_CURVE25519
+        case ASYNC_SW_X25519_MAKE:
+        case ASYNC_SW_X25519_SHARED_SEC:
+#endif /* HAVE_CURVE25519 */
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static void wolfAsync_PoolNotify(WC_ASYNC_POOL* pool)
+{
+#ifdef __linux__
+    word64 cnt = 1;
+#else
+    byte cnt = 1;
+#endif
+    /* A full counter or pipe already has the reader woken up. */
+    ssize_t sz = write(pool->notifyFd[1], &cnt, sizeof(cnt));
+    (void)sz;
+}
+
+static void* wolfAsync_PoolWorker(void* arg)
+{
+    WC_ASYNC_POOL* pool = (WC_ASYNC_POOL*)arg;
+    WC_ASYNC_DEV* dev;
+    int ret;
+
+    pthread_mutex_lock(&wolfAsyncPoolLock);
+    for (;;) {
+        while (pool->jobCnt == 0 && !pool->stop) {
+            pthread_cond_wait(&pool->workCond, &wolfAsyncPoolLock);
+        }
+        /* queued ops are finished before stopping */
+        if (pool->jobCnt == 0) {
+            break;
+        }
+        dev = pool->job[pool->jobHead];
+        pool->jobHead = (pool->jobHead + 1) % WC_ASYNC_POOL_MAX_JOBS;
+        pool->jobCnt--;
+        dev->poolState = ASYNC_POOL_RUNNING;
+        pthread_mutex_unlock(&wolfAsyncPoolLock);
+
+        /* non-blocking math yields - no one to yield to here */
+        do {
+            ret = wolfAsync_DoSw(dev);
+        } while (ret == WC_NO_ERR_TRACE(WC_PENDING_E));
+
+        pthread_mutex_lock(&wolfAsyncPoolLock);
+        dev->poolRet = ret;
+        dev->poolState = ASYNC_POOL_DONE;
+        pthread_cond_broadcast(&pool->doneCond);
+        wolfAsync_PoolNotify(pool);
+    }
+    pthread_mutex_unlock(&wolfAsyncPoolLock);
+
+    return NULL;
+}
+
+/* Queue the op set up by wc_AsyncSwInit. Caller holds the pool lock.
+ * Returns 1 when the pool has (or will have) the op and 0 when it is to be
+ * run inline. */
+static int wolfAsync_PoolQueue(WC_ASYNC_POOL* pool, WC_ASYNC_DEV* dev)
+{
+    if (pool->threadCnt == 0 || pool->stop ||
+            !wolfAsync_PoolType(dev->sw.type)) {
+        return 0;
+    }
+    /* When full, the op stays pending and is queued on a later poll. */
+    if (pool->jobCnt < WC_ASYNC_POOL_MAX_JOBS) {
+        pool->job[(pool->jobHead + pool->jobCnt) % WC_ASYNC_POOL_MAX_JOBS] =
+            dev;
+        pool->jobCnt++;
+        dev->poolState = ASYNC_POOL_QUEUED;
+        pthread_cond_signal(&pool->workCond);
+    }
+    return 1;
+}
+
+/* Start the op of a newly pushed event so it runs before the first poll. */
+static void wolfAsync_PoolStart(WC_ASYNC_DEV* dev)
+{
+    if (dev == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&wolfAsyncPoolLock);
+    if (dev->poolState == ASYNC_POOL_NONE) {
+        (void)wolfAsync_PoolQueue(&wolfAsyncPool, dev);
+    }
+    pthread_mutex_unlock(&wolfAsyncPoolLock);
+}
+
+/* Returns WC_PENDING_E while the pool has the op, the op's result once it is
+ * done and WC_NO_PENDING_E when the op is to be run inline. */
+static int wolfAsync_PoolCheck(WC_ASYNC_DEV* dev)
+{
+    int ret = WC_NO_PENDING_E;
+
+    pthread_mutex_lock(&wolfAsyncPoolLock);
+    switch (dev->poolState) {
+        case ASYNC_POOL_NONE:
+            if (wolfAsync_PoolQueue(&wolfAsyncPool, dev)) {
+                ret = WC_PENDING_E;
+            }
+            break;
+        case ASYNC_POOL_QUEUED:
+        case ASYNC_POOL_RUNNING:
+            ret = WC_PENDING_E;
+            break;
+        case ASYNC_POOL_DONE:
+        default:
+            ret = dev->poolRet;
+            dev->poolState = ASYNC_POOL_NONE;
+            break;
+    }
+    pthread_mutex_unlock(&wolfAsyncPoolLock);
+
+    return ret;
+}
+
+/* Block until the pool completes the op, or any op when the queue is full. */
+static void wolfAsync_PoolWait(WC_ASYNC_DEV* dev)
+{
+    WC_ASYNC_POOL* pool = &wolfAsyncPool;
+
+    pthread_mutex_lock(&wolfAsyncPoolLock);
+    if (dev->poolState == ASYNC_POOL_NONE &&
+            pool->jobCnt == WC_ASYNC_POOL_MAX_JOBS) {
+        pthread_cond_wait(&pool->doneCond, &wolfAsyncPoolLock);
+    }
+    while (dev->poolState == ASYNC_POOL_QUEUED ||
+           dev->poolState == ASYNC_POOL_RUNNING) {
+        pthread_cond_wait(&pool->doneCond, &wolfAsyncPoolLock);
+    }
+    pthread_mutex_unlock(&wolfAsyncPoolLock);
+}
+
+/* The device is going away: drop its queued op or wait for the running one
+ * so no worker touches freed memory. */
+static void wolfAsync_PoolCancel(WC_ASYNC_DEV* dev)
+{
+    WC_ASYNC_POOL* pool = &wolfAsyncPool;
+    int i, idx;
+
+    pthread_mutex_lock(&wolfAsyncPoolLock);
+    if (dev->poolState == ASYNC_POOL_QUEUED) {
+        for (i = 0; i < pool->jobCnt; i++) {
+            idx = (pool->jobHead + i) % WC_ASYNC_POOL_MAX_JOBS;
+            if (pool->job[idx] == dev) {
+                break;
+            }
+        }
+        if (i < pool->jobCnt) {
+            for (; i < pool->jobCnt - 1; i++) {
+                idx = (pool->jobHead + i) % WC_ASYNC_POOL_MAX_JOBS;
+                pool->job[idx] =
+                    pool->job[(idx + 1) % WC_ASYNC_POOL_MAX_JOBS];
+            }
+            pool->jobCnt--;
+        }
+    }
+    while (dev->poolState == ASYNC_POOL_RUNNING) {
+        pthread_cond_wait(&pool->doneCond, &wolfAsyncPoolLock);
+    }
+    dev->poolState = ASYNC_POOL_NONE;
+    pthread_mutex_unlock(&wolfAsyncPoolLock);
+}
+
+/* Stop and join the workers. Caller holds the init lock only. */
+static void wolfAsync_PoolStop(WC_ASYNC_POOL* pool)
+{
+    int i;
+
+    pthread_mutex_lock(&wolfAsyncPoolLock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->workCond);
+    pthread_mutex_unlock(&wolfAsyncPoolLock);
+
+    for (i = 0; i < pool->threadCnt; i++) {
+        (void)wc_AsyncThreadJoin(&pool->thread[i]);
+    }
+
+    pthread_mutex_lock(&wolfAsyncPoolLock);
+    pool->threadCnt = 0;
+    pool->refCnt = 0;
+    pthread_mutex_unlock(&wolfAsyncPoolLock);
+
+    pthread_cond_destroy(&pool->workCond);
+    pthread_cond_destroy(&pool->doneCond);
+    if (pool->notifyFd[1] != pool->notifyFd[0]) {
+        close(pool->notifyFd[1]);
+    }
+    close(pool->notifyFd[0]);
+    pool->notifyFd[0] = pool->notifyFd[1] = -1;
+}
+
+/* Start the worker pool. threads <= 0 uses one worker per online CPU.
+ * Calls nest: only the first starts the pool. */
+int wolfAsync_ThreadPoolInit(int threads)
+{
+    WC_ASYNC_POOL* pool = &wolfAsyncPool;
+    int ret = 0;
+    int i;
+
+    pthread_mutex_lock(&wolfAsyncPoolInitLock);
+    if (pool->refCnt > 0) {
+        pool->refCnt++;
+        pthread_mutex_unlock(&wolfAsyncPoolInitLock);
+        return 0;
+    }
+
+    if (threads <= 0) {
+        threads = wc_AsyncGetNumberOfCpus();
+        if (threads <= 0) {
+            threads = 1;
+        }
+    }
+    if (threads > WC_ASYNC_POOL_MAX_THREADS) {
+        threads = WC_ASYNC_POOL_MAX_THREADS;
+    }
+
+    XMEMSET(pool, 0, sizeof(*pool));
+#ifdef __linux__
+    pool->notifyFd[0] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    pool->notifyFd[1] = pool->notifyFd[0];
+    if (pool->notifyFd[0] < 0) {
+        ret = ASYNC_INIT_E;
+    }
+#else
+    if (pipe(pool->notifyFd) != 0) {
+        ret = ASYNC_INIT_E;
+    }
+    else {
+        (void)fcntl(pool->notifyFd[0], F_SETFL, O_NONBLOCK);
+        (void)fcntl(pool->notifyFd[1], F_SETFL, O_NONBLOCK);
+    }
+#endif
+    if (ret == 0 && pthread_cond_init(&pool->workCond, NULL) != 0) {
+        ret = ASYNC_INIT_E;
+    }
+    if (ret == 0 && pthread_cond_init(&pool->doneCond, NULL) != 0) {
+        pthread_cond_destroy(&pool->workCond);
+        ret = ASYNC_INIT_E;
+    }
+    if (ret != 0) {
+        if (pool->notifyFd[0] >= 0) {
+            if (pool->notifyFd[1] != pool->notifyFd[0]) {
+                close(pool->notifyFd[1]);
+            }
+            close(pool->notifyFd[0]);
+        }
+        pthread_mutex_unlock(&wolfAsyncPoolInitLock);
+        return ret;
+    }
+
+    pthread_mutex_lock(&wolfAsyncPoolLock);
+    for (i = 0; i < threads; i++) {
+        if (wc_AsyncThreadCreate(&pool->thread[i], wolfAsync_PoolWorker,
+                pool) != 0) {
+            break;
+        }
+        pool->threadCnt++;
+    }
+    pool->refCnt = 1;
+    pthread_mutex_unlock(&wolfAsyncPoolLock);
+
+    if (pool->threadCnt != threads) {
+        wolfAsync_PoolStop(pool);
+        ret = ASYNC_INIT_E;
+    }
+
+    pthread_mutex_unlock(&wolfAsyncPoolInitLock);
+
+    return ret;
+}
+
+/* Drop a reference and stop the pool after the last. Ops already queued are
+ * completed first. */
+void wolfAsync_ThreadPoolFree(void)
+{
+    WC_ASYNC_POOL* pool = &wolfAsyncPool;
+
+    pthread_mutex_lock(&wolfAsyncPoolInitLock);
+    if (pool->refCnt > 0 && --pool->refCnt == 0) {
+        wolfAsync_PoolStop(pool);
+    }
+    pthread_mutex_unlock(&wolfAsyncPoolInitLock);
+}
+
+/* Descriptor for an event loop to wait on, or -1 when the pool isn't
+ * running. */
+int wolfAsync_ThreadPoolGetFd(void)
+{
+    int fd = -1;
+
+    pthread_mutex_lock(&wolfAsyncPoolLock);
+    if (wolfAsyncPool.threadCnt > 0) {
+        fd = wolfAsyncPool.notifyFd[0];
+    }
+    pthread_mutex_unlock(&wolfAsyncPoolLock);
+
+    return fd;
+}
+
+/* Reset the descriptor to not readable. Call before polling the events. */
+void wolfAsync_ThreadPoolClearFd(void)
+{
+    int fd = wolfAsync_ThreadPoolGetFd();
+    byte buf[64];
+
+    if (fd >= 0) {
+        while (read(fd, buf, sizeof(buf)) > 0) {
+        }
+    }
+}
+
+#endif /* WOLFSSL_ASYNC_THREADPOOL */
+
+/* Run the software op of an event, or check on it when the pool has it. */
+static int wolfAsync_DoSwPoll(WC_ASYNC_DEV* asyncDev)
+{
+#ifdef WOLFSSL_ASYNC_THREADPOOL
+    int ret = wolfAsync_PoolCheck(asyncDev);
+    if (ret != WC_NO_ERR_TRACE(WC_NO_PENDING_E)) {
+        return ret;
+    }
+#endif
+    return wolfAsync_DoSw(asyncDev);
+}
+
 #endif /* WOLFSSL_ASYNC_CRYPT_SW */
 
 int wolfAsync_DevOpenThread(int *pDevId, void* threadId)
@@ -354,6 +745,11 @@ int wolfAsync_DevOpenThread(int *pDevId, void* threadId)
     if (!wolfAsyncSwDisabled) {
         /* For SW use any value 0 or greater */
         devId = 0;
+    #ifdef WOLFSSL_ASYNC_THREADPOOL
+        ret = wolfAsync_ThreadPoolInit(0);
+        if (ret != 0)
+            devId = INVALID_DEVID;
+    #endif
     }
 #endif
 
@@ -400,6 +796,8 @@ void wolfAsync_DevClose(int *devId)
         NitroxCloseDevice(*devId);
     #elif defined(HAVE_INTEL_QA)
         IntelQaDeInit(*devId);
+    #elif defined(WOLFSSL_ASYNC_THREADPOOL)
+        wolfAsync_ThreadPoolFree();
     #endif
         *devId = INVALID_DEVID;
     }
@@ -439,6 +837,8 @@ void wolfAsync_DevCtxFree(WC_ASYNC_DEV* asyncDev, word32 marker)
         NitroxFreeContext(asyncDev);
     #elif defined(HAVE_INTEL_QA)
         IntelQaClose(asyncDev);
+    #elif defined(WOLFSSL_ASYNC_THREADPOOL)
+        wolfAsync_PoolCancel(asyncDev);
     #endif
         asyncDev->marker = WOLFSSL_ASYNC_MARKER_INVALID;
     }
@@ -495,13 +895,21 @@ int wolfAsync_EventPop(WOLF_EVENT* event, enum WOLF_EVENT_TYPE event_type)
 
 int wolfAsync_EventQueuePush(WOLF_EVENT_QUEUE* queue, WOLF_EVENT* event)
 {
+    int ret;
+
     if (queue == NULL) {
         return BAD_FUNC_ARG;
     }
 
     /* Setup event and push to event queue */
     event->dev.async = wolfAsync_GetDev(event);
-    return wolfEventQueue_Push(queue, event);
+    ret = wolfEventQueue_Push(queue, event);
+#ifdef WOLFSSL_ASYNC_THREADPOOL
+    if (ret == 0) {
+        wolfAsync_PoolStart(event->dev.async);
+    }
+#endif
+    return ret;
 }
 
 #ifdef HAVE_CAVIUM
@@ -560,7 +968,7 @@ int wolfAsync_EventPoll(WOLF_EVENT* event, WOLF_EVENT_FLAG flags)
         /* poll QAT hardware, callback returns data, IntelQaPoll sets event */
         ret = IntelQaPoll(asyncDev);
     #elif defined(WOLFSSL_ASYNC_CRYPT_SW)
-        event->ret = wolfAsync_DoSw(asyncDev);
+        event->ret = wolfAsync_DoSwPoll(asyncDev);
     #endif
 
         /* If not pending then mark as done */
@@ -717,7 +1125,7 @@ int wolfAsync_EventQueuePoll(WOLF_EVENT_QUEUE* queue, void* context_filter,
                         if (count % WOLF_ASYNC_SW_SKIP_MOD)
                     #endif
                         {
-                            event->ret = wolfAsync_DoSw(asyncDev);
+                            event->ret = wolfAsync_DoSwPoll(asyncDev);
                         }
                 #elif defined(WOLF_CRYPTO_CB) || defined(HAVE_PK_CALLBACKS)
                     /* Crypto/PK callbacks manage their own retry state.
@@ -828,6 +1236,11 @@ int wolfAsync_EventWait(WOLF_EVENT* event)
     /* wait for completion */
     while (ret == 0 && event->ret == WC_NO_ERR_TRACE(WC_PENDING_E)) {
         ret = wolfAsync_EventPoll(event, WOLF_POLL_FLAG_CHECK_HW);
+    #ifdef WOLFSSL_ASYNC_THREADPOOL
+        if (ret == 0 && event->ret == WC_NO_ERR_TRACE(WC_PENDING_E)) {
+            wolfAsync_PoolWait(event->dev.async);
+        }
+    #endif
     }
 
     return ret;
@@ -850,6 +1263,11 @@ int wc_AsyncHandle(WC_ASYNC_DEV* asyncDev, WOLF_EVENT_QUEUE* queue,
     if (ret == 0) {
         ret = wolfEventQueue_Push(queue, event);
     }
+#ifdef WOLFSSL_ASYNC_THREADPOOL
+    if (ret == 0) {
+        wolfAsync_PoolStart(asyncDev);
+    }
+#endif
 
     /* check for error (helps with debugging) */
     if (ret != 0) {
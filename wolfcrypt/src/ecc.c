@@ -153,6 +153,10 @@ Possible ECC enable options:
  *                      values use more memory but faster verify.
  * FP_ECC_CONTROL:      Auto-selects cached FP ECC verify with  default: on
  *                      SP when WOLFSSL_HAVE_SP_ECC is available.
+ * FP_ECC_SHARED:       Process wide store of pinned FP tables  default: off
+ *                      shared by all threads. Tables are pinned with
+ *                      wc_ecc_fp_share_key() and can be exported and
+ *                      imported. Not used with WOLFSSL_SP_MATH.
  *
  * SP Math ECC options:
  * WOLFSSL_HAVE_SP_ECC: Enables SP math optimizations for ECC   default: on
@@ -13097,6 +13101,103 @@ static THREAD_LS_T fp_cache_t fp_cache[FP_ENTRIES];
 #endif
 #endif /* HAVE_THREAD_LS */
 
+#ifdef FP_ECC_SHARED
+/* Pinned fixed point table, shared by all threads.
+ * Entries are fully built before being added to the store and are never
+ * modified afterwards. Each user holds a reference so that an entry removed by
+ * wc_ecc_fp_free_shared() is only freed once the last user releases it. */
+typedef struct fp_shared_t {
+   fp_cache_t          fp;       /* base point, LUT and montgomery constant */
+   mp_int              prime;    /* modulus of the curve the LUT is for */
+   int                 curve_id; /* curve identifier, used on export */
+   wolfSSL_Ref         ref;      /* store and users of the entry */
+   struct fp_shared_t* next;
+} fp_shared_t;
+
+/* number of hash buckets of the pinned table store */
+#ifndef FP_SHARED_BUCKETS
+   #define FP_SHARED_BUCKETS 64
+#endif
+
+static fp_shared_t* fp_shared[FP_SHARED_BUCKETS];
+static wolfSSL_RwLock fp_shared_lock;
+/* set and cleared only by wolfCrypt_Init() and wolfCrypt_Cleanup() */
+static int fp_shared_lock_init = 0;
+
+/* bucket of a base point on the curve with the modulus */
+static word32 fp_shared_hash(ecc_point* g, mp_int* modulus)
+{
+   word32 h;
+
+   h = (word32)mp_get_digit(modulus, 0);
+   h = h * 31 + (word32)mp_get_digit(g->x, 0);
+   h = h * 31 + (word32)mp_get_digit(g->y, 0);
+   return h % FP_SHARED_BUCKETS;
+}
+
+/* check whether the entry is for the base point on the curve */
+static int fp_shared_match(fp_shared_t* e, ecc_point* g, mp_int* modulus)
+{
+   return mp_cmp(e->fp.g->x, g->x) == MP_EQ &&
+          mp_cmp(e->fp.g->y, g->y) == MP_EQ &&
+          mp_cmp(e->fp.g->z, g->z) == MP_EQ &&
+          mp_cmp(&e->prime, modulus) == MP_EQ;
+}
+
+/* free a pinned table entry */
+static void fp_shared_free_entry(fp_shared_t* e)
+{
+   unsigned x;
+
+   for (x = 0; x < (1U<<FP_LUT); x++) {
+      wc_ecc_del_point(e->fp.LUT[x]);
+   }
+   wc_ecc_del_point(e->fp.g);
+   mp_clear(&e->fp.mu);
+   mp_clear(&e->prime);
+   wolfSSL_RefFree(&e->ref);
+   XFREE(e, NULL, DYNAMIC_TYPE_ECC);
+}
+
+/* release a reference to a pinned table, freed when it was the last one */
+static void fp_shared_release(fp_shared_t* e)
+{
+   int isZero = 0;
+   int err;
+
+   if (e != NULL) {
+      wolfSSL_RefDec(&e->ref, &isZero, &err);
+      if (err == 0 && isZero) {
+         fp_shared_free_entry(e);
+      }
+   }
+}
+
+/* find a pinned table for the base point on the curve with the modulus and
+ * take a reference to it, returns NULL when not pinned */
+static fp_shared_t* fp_shared_find(ecc_point* g, mp_int* modulus)
+{
+   int err;
+   fp_shared_t* e;
+
+   if (fp_shared_lock_init == 0 || wc_LockRwLock_Rd(&fp_shared_lock) != 0) {
+      return NULL;
+   }
+   for (e = fp_shared[fp_shared_hash(g, modulus)]; e != NULL; e = e->next) {
+      if (fp_shared_match(e, g, modulus)) {
+         wolfSSL_RefInc(&e->ref, &err);
+         if (err != 0) {
+            e = NULL;
+         }
+         break;
+      }
+   }
+   wc_UnLockRwLock(&fp_shared_lock);
+
+   return e;
+}
+#endif /* FP_ECC_SHARED */
+
 /* simple table to help direct the generation of the LUT */
 static const struct {
    int ham, terma, termb;
@@ -13684,41 +13785,41 @@ static int find_base(ecc_point* g)
 }
 
 /* add a new base to the cache */
-static int add_entry(int idx, ecc_point *g)
+static int add_entry(fp_cache_t* fp, ecc_point *g)
 {
    unsigned x, y;
 
    /* allocate base and LUT */
-   fp_cache[idx].g = wc_ecc_new_point();
-   if (fp_cache[idx].g == NULL) {
+   fp->g = wc_ecc_new_point();
+   if (fp->g == NULL) {
       return MP_MEM;
    }
 
    /* copy x and y */
-   if ((mp_copy(g->x, fp_cache[idx].g->x) != MP_OKAY) ||
-       (mp_copy(g->y, fp_cache[idx].g->y) != MP_OKAY) ||
-       (mp_copy(g->z, fp_cache[idx].g->z) != MP_OKAY)) {
-      wc_ecc_del_point(fp_cache[idx].g);
-      fp_cache[idx].g = NULL;
+   if ((mp_copy(g->x, fp->g->x) != MP_OKAY) ||
+       (mp_copy(g->y, fp->g->y) != MP_OKAY) ||
+       (mp_copy(g->z, fp->g->z) != MP_OKAY)) {
+      wc_ecc_del_point(fp->g);
+      fp->g = NULL;
       return MP_MEM;
    }
 
    for (x = 0; x < (1U<<FP_LUT); x++) {
-      fp_cache[idx].LUT[x] = wc_ecc_new_point();
-      if (fp_cache[idx].LUT[x] == NULL) {
+      fp->LUT[x] = wc_ecc_new_point();
+      if (fp->LUT[x] == NULL) {
          for (y = 0; y < x; y++) {
-            wc_ecc_del_point(fp_cache[idx].LUT[y]);
-            fp_cache[idx].LUT[y] = NULL;
+            wc_ecc_del_point(fp->LUT[y]);
+            fp->LUT[y] = NULL;
          }
-         wc_ecc_del_point(fp_cache[idx].g);
-         fp_cache[idx].g         = NULL;
-         fp_cache[idx].lru_count = 0;
+         wc_ecc_del_point(fp->g);
+         fp->g         = NULL;
+         fp->lru_count = 0;
          return MP_MEM;
       }
    }
 
-   fp_cache[idx].LUT_set   = 0;
-   fp_cache[idx].lru_count = 0;
+   fp->LUT_set   = 0;
+   fp->lru_count = 0;
 
    return MP_OKAY;
 }
@@ -13730,7 +13831,7 @@ static int add_entry(int idx, ecc_point *g)
  * The algorithm builds patterns in increasing bit order by first making all
  * single bit input patterns, then all two bit input patterns and so on
  */
-static int build_lut(int idx, mp_int* a, mp_int* modulus, mp_digit mp,
+static int build_lut(fp_cache_t* fp, mp_int* a, mp_int* modulus, mp_digit mp,
     mp_int* mu)
 {
    int err;
@@ -13765,29 +13866,29 @@ static int build_lut(int idx, mp_int* a, mp_int* modulus, mp_digit mp,
    lut_gap = bitlen / FP_LUT;
 
    /* init the mu */
-   err = mp_init_copy(&fp_cache[idx].mu, mu);
+   err = mp_init_copy(&fp->mu, mu);
    if (err != MP_OKAY)
        goto errout;
 
    /* copy base */
-   if ((mp_mulmod(fp_cache[idx].g->x, mu, modulus,
-                  fp_cache[idx].LUT[1]->x) != MP_OKAY) ||
-       (mp_mulmod(fp_cache[idx].g->y, mu, modulus,
-                  fp_cache[idx].LUT[1]->y) != MP_OKAY) ||
-       (mp_mulmod(fp_cache[idx].g->z, mu, modulus,
-                  fp_cache[idx].LUT[1]->z) != MP_OKAY)) {
+   if ((mp_mulmod(fp->g->x, mu, modulus,
+                  fp->LUT[1]->x) != MP_OKAY) ||
+       (mp_mulmod(fp->g->y, mu, modulus,
+                  fp->LUT[1]->y) != MP_OKAY) ||
+       (mp_mulmod(fp->g->z, mu, modulus,
+                  fp->LUT[1]->z) != MP_OKAY)) {
        err = MP_MULMOD_E;
        goto errout;
    }
 
    /* make all single bit entries */
    for (x = 1; x < FP_LUT; x++) {
-      if ((mp_copy(fp_cache[idx].LUT[(unsigned int)(1 << (x-1))]->x,
-                   fp_cache[idx].LUT[(unsigned int)(1 <<  x   )]->x) != MP_OKAY) ||
-          (mp_copy(fp_cache[idx].LUT[(unsigned int)(1 << (x-1))]->y,
-                   fp_cache[idx].LUT[(unsigned int)(1 <<  x   )]->y) != MP_OKAY) ||
-          (mp_copy(fp_cache[idx].LUT[(unsigned int)(1 << (x-1))]->z,
-                   fp_cache[idx].LUT[(unsigned int)(1 <<  x   )]->z) != MP_OKAY)) {
+      if ((mp_copy(fp->LUT[(unsigned int)(1 << (x-1))]->x,
+                   fp->LUT[(unsigned int)(1 <<  x   )]->x) != MP_OKAY) ||
+          (mp_copy(fp->LUT[(unsigned int)(1 << (x-1))]->y,
+                   fp->LUT[(unsigned int)(1 <<  x   )]->y) != MP_OKAY) ||
+          (mp_copy(fp->LUT[(unsigned int)(1 << (x-1))]->z,
+                   fp->LUT[(unsigned int)(1 <<  x   )]->z) != MP_OKAY)) {
           err = MP_INIT_E;
           goto errout;
       } else {
@@ -13795,8 +13896,8 @@ static int build_lut(int idx, mp_int* a, mp_int* modulus, mp_digit mp,
          /* now double it bitlen/FP_LUT times */
          for (y = 0; y < lut_gap; y++) {
              if ((err = ecc_projective_dbl_point_safe(
-                                      fp_cache[idx].LUT[(unsigned int)(1<<x)],
-                                      fp_cache[idx].LUT[(unsigned int)(1<<x)],
+                                      fp->LUT[(unsigned int)(1<<x)],
+                                      fp->LUT[(unsigned int)(1<<x)],
                                       a, modulus, mp)) != MP_OKAY) {
                  goto errout;
              }
@@ -13813,9 +13914,9 @@ static int build_lut(int idx, mp_int* a, mp_int* modulus, mp_digit mp,
 
            /* perform the add */
            if ((err = ecc_projective_add_point_safe(
-                           fp_cache[idx].LUT[lut_orders[y].terma],
-                           fp_cache[idx].LUT[lut_orders[y].termb],
-                           fp_cache[idx].LUT[y], a, modulus, mp,
+                           fp->LUT[lut_orders[y].terma],
+                           fp->LUT[lut_orders[y].termb],
+                           fp->LUT[y], a, modulus, mp,
                            &infinity)) != MP_OKAY) {
                goto errout;
            }
@@ -13828,34 +13929,34 @@ static int build_lut(int idx, mp_int* a, mp_int* modulus, mp_digit mp,
            break;
 
        /* convert z to normal from montgomery */
-       err = mp_montgomery_reduce(fp_cache[idx].LUT[x]->z, modulus, mp);
+       err = mp_montgomery_reduce(fp->LUT[x]->z, modulus, mp);
 
        /* invert it */
        if (err == MP_OKAY)
-         err = mp_invmod(fp_cache[idx].LUT[x]->z, modulus,
-                         fp_cache[idx].LUT[x]->z);
+         err = mp_invmod(fp->LUT[x]->z, modulus,
+                         fp->LUT[x]->z);
 
        if (err == MP_OKAY)
          /* now square it */
-         err = mp_sqrmod(fp_cache[idx].LUT[x]->z, modulus, tmp);
+         err = mp_sqrmod(fp->LUT[x]->z, modulus, tmp);
 
        if (err == MP_OKAY)
          /* fix x */
-         err = mp_mulmod(fp_cache[idx].LUT[x]->x, tmp, modulus,
-                         fp_cache[idx].LUT[x]->x);
+         err = mp_mulmod(fp->LUT[x]->x, tmp, modulus,
+                         fp->LUT[x]->x);
 
        if (err == MP_OKAY)
          /* get 1/z^3 */
-         err = mp_mulmod(tmp, fp_cache[idx].LUT[x]->z, modulus, tmp);
+         err = mp_mulmod(tmp, fp->LUT[x]->z, modulus, tmp);
 
        if (err == MP_OKAY)
          /* fix y */
-         err = mp_mulmod(fp_cache[idx].LUT[x]->y, tmp, modulus,
-                         fp_cache[idx].LUT[x]->y);
+         err = mp_mulmod(fp->LUT[x]->y, tmp, modulus,
+                         fp->LUT[x]->y);
 
        if (err == MP_OKAY)
          /* free z */
-         mp_clear(fp_cache[idx].LUT[x]->z);
+         mp_clear(fp->LUT[x]->z);
    }
 
   errout:
@@ -13864,27 +13965,27 @@ static int build_lut(int idx, mp_int* a, mp_int* modulus, mp_digit mp,
    WC_FREE_VAR_EX(tmp, NULL, DYNAMIC_TYPE_ECC_BUFFER);
 
    if (err == MP_OKAY) {
-       fp_cache[idx].LUT_set = 1;
+       fp->LUT_set = 1;
        return MP_OKAY;
    }
 
    /* err cleanup */
    for (y = 0; y < (1U<<FP_LUT); y++) {
-      wc_ecc_del_point(fp_cache[idx].LUT[y]);
-      fp_cache[idx].LUT[y] = NULL;
+      wc_ecc_del_point(fp->LUT[y]);
+      fp->LUT[y] = NULL;
    }
-   wc_ecc_del_point(fp_cache[idx].g);
-   fp_cache[idx].g         = NULL;
-   fp_cache[idx].LUT_set   = 0;
-   fp_cache[idx].lru_count = 0;
-   mp_clear(&fp_cache[idx].mu);
+   wc_ecc_del_point(fp->g);
+   fp->g         = NULL;
+   fp->LUT_set   = 0;
+   fp->lru_count = 0;
+   mp_clear(&fp->mu);
 
    return err;
 }
 
 /* perform a fixed point ECC mulmod */
-static int accel_fp_mul(int idx, const mp_int* k, ecc_point *R, mp_int* a,
-                        mp_int* modulus, mp_digit mp, int map)
+static int accel_fp_mul(fp_cache_t* fp, const mp_int* k, ecc_point *R,
+                        mp_int* a, mp_int* modulus, mp_digit mp, int map)
 {
 #ifdef WOLFCRYPT_HAVE_SAKKE
     #define KB_SIZE 256
@@ -14013,14 +14114,14 @@ static int accel_fp_mul(int idx, const mp_int* k, ecc_point *R, mp_int* a,
 
           /* add if not first, otherwise copy */
           if (!first && z) {
-             if ((err = ecc_projective_add_point_safe(R, fp_cache[idx].LUT[z],
+             if ((err = ecc_projective_add_point_safe(R, fp->LUT[z],
                                        R, a, modulus, mp, &first)) != MP_OKAY) {
                 break;
              }
           } else if (z) {
-             if ((mp_copy(fp_cache[idx].LUT[z]->x, R->x) != MP_OKAY) ||
-                 (mp_copy(fp_cache[idx].LUT[z]->y, R->y) != MP_OKAY) ||
-                 (mp_copy(&fp_cache[idx].mu,       R->z) != MP_OKAY)) {
+             if ((mp_copy(fp->LUT[z]->x, R->x) != MP_OKAY) ||
+                 (mp_copy(fp->LUT[z]->y, R->y) != MP_OKAY) ||
+                 (mp_copy(&fp->mu,       R->z) != MP_OKAY)) {
                  err = MP_MEM;
                  break;
              }
@@ -14067,7 +14168,7 @@ done:
 #ifdef ECC_SHAMIR
 #if !defined(WOLFSSL_SP_MATH)
 /* perform a fixed point ECC mulmod */
-static int accel_fp_mul2add(int idx1, int idx2,
+static int accel_fp_mul2add(fp_cache_t* fp1, fp_cache_t* fp2,
                             mp_int* kA, mp_int* kB,
                             ecc_point *R, mp_int* a,
                             mp_int* modulus, mp_digit mp)
@@ -14267,7 +14368,7 @@ static int accel_fp_mul2add(int idx1, int idx2,
              /* add if not first, otherwise copy */
              if (zA) {
                 if ((err = ecc_projective_add_point_safe(R,
-                                             fp_cache[idx1].LUT[zA], R, a,
+                                             fp1->LUT[zA], R, a,
                                              modulus, mp, &first)) != MP_OKAY) {
                    break;
                 }
@@ -14275,16 +14376,16 @@ static int accel_fp_mul2add(int idx1, int idx2,
 
              if (zB) {
                 if ((err = ecc_projective_add_point_safe(R,
-                                             fp_cache[idx2].LUT[zB], R, a,
+                                             fp2->LUT[zB], R, a,
                                              modulus, mp, &first)) != MP_OKAY) {
                    break;
                 }
              }
           } else {
              if (zA) {
-                 if ((mp_copy(fp_cache[idx1].LUT[zA]->x, R->x) != MP_OKAY) ||
-                     (mp_copy(fp_cache[idx1].LUT[zA]->y, R->y) != MP_OKAY) ||
-                     (mp_copy(&fp_cache[idx1].mu,        R->z) != MP_OKAY)) {
+                 if ((mp_copy(fp1->LUT[zA]->x, R->x) != MP_OKAY) ||
+                     (mp_copy(fp1->LUT[zA]->y, R->y) != MP_OKAY) ||
+                     (mp_copy(&fp1->mu,        R->z) != MP_OKAY)) {
                      err = MP_MEM;
                      break;
                  }
@@ -14292,14 +14393,14 @@ static int accel_fp_mul2add(int idx1, int idx2,
              }
              if (zB && first == 0) {
                 if ((err = ecc_projective_add_point_safe(R,
-                                        fp_cache[idx2].LUT[zB], R, a,
+                                        fp2->LUT[zB], R, a,
                                         modulus, mp, &first)) != MP_OKAY){
                    break;
                 }
              } else if (zB && first == 1) {
-                 if ((mp_copy(fp_cache[idx2].LUT[zB]->x, R->x) != MP_OKAY) ||
-                     (mp_copy(fp_cache[idx2].LUT[zB]->y, R->y) != MP_OKAY) ||
-                     (mp_copy(&fp_cache[idx2].mu,        R->z) != MP_OKAY)) {
+                 if ((mp_copy(fp2->LUT[zB]->x, R->x) != MP_OKAY) ||
+                     (mp_copy(fp2->LUT[zB]->y, R->y) != MP_OKAY) ||
+                     (mp_copy(&fp2->mu,        R->z) != MP_OKAY)) {
                      err = MP_MEM;
                      break;
                  }
@@ -14363,6 +14464,12 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
 {
    int  idx1 = -1, idx2 = -1, err, mpInit = 0;
    mp_digit mp = 0;
+   fp_cache_t* fp1 = NULL;
+   fp_cache_t* fp2 = NULL;
+#ifdef FP_ECC_SHARED
+   fp_shared_t* shared1;
+   fp_shared_t* shared2;
+#endif
 #ifdef WOLFSSL_SMALL_STACK
    mp_int   *mu = (mp_int *)XMALLOC(sizeof *mu, NULL, DYNAMIC_TYPE_ECC_BUFFER);
 
@@ -14378,6 +14485,26 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
        return err;
    }
 
+#ifdef FP_ECC_SHARED
+   /* pinned tables are used in place of entries in the cache */
+   shared1 = fp_shared_find(A, modulus);
+   shared2 = fp_shared_find(B, modulus);
+   if (shared1 != NULL)
+      fp1 = &shared1->fp;
+   if (shared2 != NULL)
+      fp2 = &shared2->fp;
+   if (fp1 != NULL && fp2 != NULL) {
+      err = mp_montgomery_setup(modulus, &mp);
+      if (err == MP_OKAY)
+         err = accel_fp_mul2add(fp1, fp2, kA, kB, C, a, modulus, mp);
+      fp_shared_release(shared2);
+      fp_shared_release(shared1);
+      mp_clear(mu);
+      WC_FREE_VAR_EX(mu, NULL, DYNAMIC_TYPE_ECC_BUFFER);
+      return err;
+   }
+#endif
+
 #ifndef HAVE_THREAD_LS
 #ifndef WOLFSSL_MUTEX_INITIALIZER
    if (initMutex == 0) { /* extra sanity check if wolfCrypt_Init not called */
@@ -14387,19 +14514,24 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
 #endif
 
    if (wc_LockMutex(&ecc_fp_lock) != 0) {
+#ifdef FP_ECC_SHARED
+       fp_shared_release(shared2);
+       fp_shared_release(shared1);
+#endif
        WC_FREE_VAR_EX(mu, NULL, DYNAMIC_TYPE_ECC_BUFFER);
       return BAD_MUTEX_E;
    }
 #endif /* HAVE_THREAD_LS */
 
       /* find point */
-      idx1 = find_base(A);
+      if (fp1 == NULL)
+         idx1 = find_base(A);
 
       /* no entry? */
-      if (idx1 == -1) {
+      if (idx1 == -1 && fp1 == NULL) {
          /* find hole and add it */
          if ((idx1 = find_hole()) >= 0) {
-            err = add_entry(idx1, A);
+            err = add_entry(&fp_cache[idx1], A);
          }
       }
       if (err == MP_OKAY && idx1 != -1 && fp_cache[idx1].lru_count < (INT_MAX-1)) {
@@ -14409,13 +14541,14 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
 
       if (err == MP_OKAY) {
         /* find point */
-        idx2 = find_base(B);
+        if (fp2 == NULL)
+           idx2 = find_base(B);
 
         /* no entry? */
-        if (idx2 == -1) {
+        if (idx2 == -1 && fp2 == NULL) {
            /* find hole and add it */
            if ((idx2 = find_hole()) >= 0)
-              err = add_entry(idx2, B);
+              err = add_entry(&fp_cache[idx2], B);
          }
       }
 
@@ -14437,7 +14570,7 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
 
            if (err == MP_OKAY)
              /* build the LUT */
-             err = build_lut(idx1, a, modulus, mp, mu);
+             err = build_lut(&fp_cache[idx1], a, modulus, mp, mu);
         }
       }
 
@@ -14455,20 +14588,24 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
 
             if (err == MP_OKAY)
               /* build the LUT */
-              err = build_lut(idx2, a, modulus, mp, mu);
+              err = build_lut(&fp_cache[idx2], a, modulus, mp, mu);
         }
       }
 
 
       if (err == MP_OKAY) {
-        if (idx1 >=0 && idx2 >= 0 && fp_cache[idx1].LUT_set &&
-                                     fp_cache[idx2].LUT_set) {
+        if (fp1 == NULL && idx1 >= 0 && fp_cache[idx1].LUT_set)
+           fp1 = &fp_cache[idx1];
+        if (fp2 == NULL && idx2 >= 0 && fp_cache[idx2].LUT_set)
+           fp2 = &fp_cache[idx2];
+
+        if (fp1 != NULL && fp2 != NULL) {
            if (mpInit == 0) {
               /* compute mp */
               err = mp_montgomery_setup(modulus, &mp);
            }
            if (err == MP_OKAY)
-             err = accel_fp_mul2add(idx1, idx2, kA, kB, C, a, modulus, mp);
+             err = accel_fp_mul2add(fp1, fp2, kA, kB, C, a, modulus, mp);
         } else {
            err = normal_ecc_mul2add(A, kA, B, kB, C, a, modulus, heap);
         }
@@ -14477,6 +14614,10 @@ int ecc_mul2add(ecc_point* A, mp_int* kA,
 #ifndef HAVE_THREAD_LS
     wc_UnLockMutex(&ecc_fp_lock);
 #endif /* HAVE_THREAD_LS */
+#ifdef FP_ECC_SHARED
+    fp_shared_release(shared2);
+    fp_shared_release(shared1);
+#endif
     mp_clear(mu);
     WC_FREE_VAR_EX(mu, NULL, DYNAMIC_TYPE_ECC_BUFFER);
 
@@ -14503,6 +14644,9 @@ int wc_ecc_mulmod_ex(const mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
    mp_digit mp = 0;
    WC_DECLARE_VAR(mu, mp_int, 1, 0);
    int      mpSetup = 0;
+#ifdef FP_ECC_SHARED
+   fp_shared_t* shared;
+#endif
 #ifndef HAVE_THREAD_LS
    int got_ecc_fp_lock = 0;
 #endif
@@ -14526,6 +14670,18 @@ int wc_ecc_mulmod_ex(const mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
        goto out;
    }
 
+#ifdef FP_ECC_SHARED
+   shared = fp_shared_find(G, modulus);
+   if (shared != NULL) {
+      /* pinned table, the per thread cache is not needed */
+      err = mp_montgomery_setup(modulus, &mp);
+      if (err == MP_OKAY)
+         err = accel_fp_mul(&shared->fp, k, R, a, modulus, mp, map);
+      fp_shared_release(shared);
+      goto out;
+   }
+#endif
+
 #ifndef HAVE_THREAD_LS
 #ifndef WOLFSSL_MUTEX_INITIALIZER
    if (initMutex == 0) { /* extra sanity check if wolfCrypt_Init not called */
@@ -14550,7 +14706,7 @@ int wc_ecc_mulmod_ex(const mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
          idx = find_hole();
 
          if (idx >= 0)
-            err = add_entry(idx, G);
+            err = add_entry(&fp_cache[idx], G);
       }
       if (err == MP_OKAY && idx >= 0 && fp_cache[idx].lru_count < (INT_MAX-1)) {
          /* increment LRU */
@@ -14572,7 +14728,7 @@ int wc_ecc_mulmod_ex(const mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
 
            if (err == MP_OKAY)
              /* build the LUT */
-             err = build_lut(idx, a, modulus, mp, mu);
+             err = build_lut(&fp_cache[idx], a, modulus, mp, mu);
         }
       }
 
@@ -14583,7 +14739,7 @@ int wc_ecc_mulmod_ex(const mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
               err = mp_montgomery_setup(modulus, &mp);
            }
            if (err == MP_OKAY)
-             err = accel_fp_mul(idx, k, R, a, modulus, mp, map);
+             err = accel_fp_mul(&fp_cache[idx], k, R, a, modulus, mp, map);
         } else {
            err = normal_ecc_mulmod(k, G, R, a, modulus, NULL, map, heap);
         }
@@ -14661,6 +14817,9 @@ int wc_ecc_mulmod_ex2(const mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
    mp_digit mp = 0;
    WC_DECLARE_VAR(mu, mp_int, 1, 0);
    int      mpSetup = 0;
+#ifdef FP_ECC_SHARED
+   fp_shared_t* shared;
+#endif
 #ifndef HAVE_THREAD_LS
    int got_ecc_fp_lock = 0;
 #endif
@@ -14685,6 +14844,18 @@ int wc_ecc_mulmod_ex2(const mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
        goto out;
    }
 
+#ifdef FP_ECC_SHARED
+   shared = fp_shared_find(G, modulus);
+   if (shared != NULL) {
+      /* pinned table, the per thread cache is not needed */
+      err = mp_montgomery_setup(modulus, &mp);
+      if (err == MP_OKAY)
+         err = accel_fp_mul(&shared->fp, k, R, a, modulus, mp, map);
+      fp_shared_release(shared);
+      goto out;
+   }
+#endif
+
 #ifndef HAVE_THREAD_LS
 #ifndef WOLFSSL_MUTEX_INITIALIZER
    if (initMutex == 0) { /* extra sanity check if wolfCrypt_Init not called */
@@ -14709,7 +14880,7 @@ int wc_ecc_mulmod_ex2(const mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
          idx = find_hole();
 
          if (idx >= 0)
-            err = add_entry(idx, G);
+            err = add_entry(&fp_cache[idx], G);
       }
       if (err == MP_OKAY && idx >= 0 && fp_cache[idx].lru_count < (INT_MAX-1)) {
          /* increment LRU */
@@ -14731,7 +14902,7 @@ int wc_ecc_mulmod_ex2(const mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
 
            if (err == MP_OKAY)
              /* build the LUT */
-             err = build_lut(idx, a, modulus, mp, mu);
+             err = build_lut(&fp_cache[idx], a, modulus, mp, mu);
         }
       }
 
@@ -14742,7 +14913,7 @@ int wc_ecc_mulmod_ex2(const mp_int* k, ecc_point *G, ecc_point *R, mp_int* a,
               err = mp_montgomery_setup(modulus, &mp);
            }
            if (err == MP_OKAY)
-             err = accel_fp_mul(idx, k, R, a, modulus, mp, map);
+             err = accel_fp_mul(&fp_cache[idx], k, R, a, modulus, mp, map);
         } else {
           err = normal_ecc_mulmod(k, G, R, a, modulus, rng, map, heap);
         }
@@ -14829,6 +15000,20 @@ static void wc_ecc_fp_free_cache(void)
 #endif
 
 
+#ifdef FP_ECC_SHARED
+/* the lock of the pinned table store is only set up by wc_ecc_fp_init(),
+ * called from wolfCrypt_Init(), so the store is unusable until then */
+static int fp_shared_lock_check(void)
+{
+   if (fp_shared_lock_init == 0) {
+      WOLFSSL_MSG("FP ECC shared store used before wolfCrypt_Init");
+      return BAD_STATE_E;
+   }
+   return 0;
+}
+#endif
+
+
 /** Init the Fixed Point cache */
 void wc_ecc_fp_init(void)
 {
@@ -14841,6 +15026,13 @@ void wc_ecc_fp_init(void)
    }
 #endif
 #endif
+#ifdef FP_ECC_SHARED
+   if (fp_shared_lock_init == 0) {
+      if (wc_InitRwLock(&fp_shared_lock) == 0) {
+         fp_shared_lock_init = 1;
+      }
+   }
+#endif
 #endif
 }
 
@@ -14875,6 +15067,578 @@ void wc_ecc_fp_free(void)
 }
 
 
+#ifdef FP_ECC_SHARED
+
+/* version of the exported pinned table format */
+#define FP_SHARED_VERSION   1
+/* version, LUT bits and two byte entry count */
+#define FP_SHARED_HDR_SZ    4
+
+/* number of bytes exported for an entry of a curve with field size sz:
+ * curve id, base point (x, y, z), mu and affine LUT entries 1..2^FP_LUT-1 */
+#define FP_SHARED_ENTRY_SZ(sz) \
+    (2 + (word32)(sz) * (3 + 1 + 2 * ((1U << FP_LUT) - 1)))
+
+/* allocate a pinned table entry for the point g on the curve, the LUT is
+ * not built */
+static int fp_shared_new_entry(const ecc_set_type* dp, mp_int* prime,
+                               ecc_point* g, fp_shared_t** out)
+{
+   int err;
+   fp_shared_t* e;
+
+   e = (fp_shared_t*)XMALLOC(sizeof(fp_shared_t), NULL, DYNAMIC_TYPE_ECC);
+   if (e == NULL) {
+      return MEMORY_E;
+   }
+   XMEMSET(e, 0, sizeof(fp_shared_t));
+   e->curve_id = dp->id;
+
+   /* reference held by the store once inserted */
+   wolfSSL_RefInit(&e->ref, &err);
+   if (err != 0) {
+      XFREE(e, NULL, DYNAMIC_TYPE_ECC);
+      return err;
+   }
+   err = mp_init_multi(&e->prime, &e->fp.mu, NULL, NULL, NULL, NULL);
+   if (err == MP_OKAY)
+      err = mp_copy(prime, &e->prime);
+   if (err == MP_OKAY)
+      err = add_entry(&e->fp, g);
+
+   if (err != MP_OKAY) {
+      fp_shared_free_entry(e);
+      return err;
+   }
+   *out = e;
+   return MP_OKAY;
+}
+
+/* add a fully built entry to the store, freed when the point is already
+ * pinned */
+static int fp_shared_insert(fp_shared_t* e)
+{
+   fp_shared_t* cur;
+   word32 h = fp_shared_hash(e->fp.g, &e->prime);
+
+   if (wc_LockRwLock_Wr(&fp_shared_lock) != 0) {
+      fp_shared_free_entry(e);
+      return BAD_MUTEX_E;
+   }
+   for (cur = fp_shared[h]; cur != NULL; cur = cur->next) {
+      if (fp_shared_match(cur, e->fp.g, &e->prime)) {
+         break;
+      }
+   }
+   if (cur == NULL) {
+      e->next = fp_shared[h];
+      fp_shared[h] = e;
+   }
+   wc_UnLockRwLock(&fp_shared_lock);
+
+   if (cur != NULL) {
+      fp_shared_free_entry(e);
+   }
+   return MP_OKAY;
+}
+
+/* pin the table of point g on the curve at index curve_idx */
+static int fp_shared_add(int curve_idx, ecc_point* g)
+{
+   int err;
+   mp_digit mp = 0;
+   fp_shared_t* e = NULL;
+   fp_shared_t* pinned = NULL;
+   DECLARE_CURVE_SPECS(3);
+   WC_DECLARE_VAR(mu, mp_int, 1, 0);
+
+   if ((err = fp_shared_lock_check()) != 0) {
+      return err;
+   }
+
+#ifdef WOLFSSL_SMALL_STACK
+   if ((mu = (mp_int *)XMALLOC(sizeof(*mu), NULL, DYNAMIC_TYPE_ECC_BUFFER)) == NULL)
+       return MEMORY_E;
+#endif
+   err = mp_init(mu);
+
+   ALLOC_CURVE_SPECS(3, err);
+   if (err == MP_OKAY) {
+      err = wc_ecc_curve_load(ecc_sets + curve_idx, &curve,
+                              ECC_CURVE_FIELD_PRIME | ECC_CURVE_FIELD_AF |
+                              ECC_CURVE_FIELD_BF);
+   }
+
+   /* only affine points on the curve are pinned */
+   if (err == MP_OKAY)
+      err = wc_ecc_is_point(g, curve->Af, curve->Bf, curve->prime);
+
+   /* nothing to do when already pinned */
+   if (err == MP_OKAY)
+      pinned = fp_shared_find(g, curve->prime);
+   if (err == MP_OKAY && pinned == NULL) {
+      err = fp_shared_new_entry(ecc_sets + curve_idx, curve->prime, g, &e);
+      if (err == MP_OKAY)
+         err = mp_montgomery_setup(curve->prime, &mp);
+      if (err == MP_OKAY)
+         err = mp_montgomery_calc_normalization(mu, curve->prime);
+      if (err == MP_OKAY) {
+         err = build_lut(&e->fp, curve->Af, curve->prime, mp, mu);
+         if (err == MP_OKAY)
+            err = fp_shared_insert(e);
+         else
+            fp_shared_free_entry(e);
+      }
+      else if (e != NULL) {
+         fp_shared_free_entry(e);
+      }
+   }
+   fp_shared_release(pinned);
+
+   wc_ecc_curve_free(curve);
+   FREE_CURVE_SPECS();
+   mp_clear(mu);
+   WC_FREE_VAR_EX(mu, NULL, DYNAMIC_TYPE_ECC_BUFFER);
+
+   return err;
+}
+
+/** Pin the fixed point table of a point so that all threads share it.
+    curve_id  Identifier of the curve the point is on
+    point     Point to precompute the table for, in affine coordinates
+    return MP_OKAY when pinned or already pinned
+*/
+int wc_ecc_fp_share_point(int curve_id, ecc_point* point)
+{
+   int curve_idx;
+
+   if (point == NULL) {
+      return BAD_FUNC_ARG;
+   }
+   curve_idx = wc_ecc_get_curve_idx(curve_id);
+   if (curve_idx < 0) {
+      return ECC_BAD_ARG_E;
+   }
+
+   return fp_shared_add(curve_idx, point);
+}
+
+/** Pin the fixed point tables used with a key: the base point of the curve,
+    used when signing and generating keys, and the public point when set,
+    used when verifying.
+    key  ECC key to pin tables for
+    return MP_OKAY on success
+*/
+int wc_ecc_fp_share_key(ecc_key* key)
+{
+   int err;
+   ecc_point* base;
+
+   if (key == NULL || key->dp == NULL || key->idx < 0) {
+      return BAD_FUNC_ARG;
+   }
+
+   base = wc_ecc_new_point_h(key->heap);
+   if (base == NULL) {
+      return MEMORY_E;
+   }
+   err = mp_read_radix(base->x, key->dp->Gx, MP_RADIX_HEX);
+   if (err == MP_OKAY)
+      err = mp_read_radix(base->y, key->dp->Gy, MP_RADIX_HEX);
+   if (err == MP_OKAY)
+      err = mp_set(base->z, 1);
+   if (err == MP_OKAY)
+      err = fp_shared_add(key->idx, base);
+   wc_ecc_del_point_h(base, key->heap);
+
+   if (err == MP_OKAY && (key->type == ECC_PUBLICKEY ||
+                          key->type == ECC_PRIVATEKEY)) {
+      err = fp_shared_add(key->idx, &key->pubkey);
+   }
+
+   return err;
+}
+
+/* write a number as a fixed length big-endian value */
+static int fp_shared_write(mp_int* a, byte** out, int sz)
+{
+   int err = mp_to_unsigned_bin_len(a, *out, sz);
+   *out += sz;
+   return err;
+}
+
+/* write an entry: curve id, base point, montgomery constant and LUT */
+static int fp_shared_export_entry(fp_shared_t* e, byte** out)
+{
+   int err;
+   unsigned x;
+   int fSz = mp_unsigned_bin_size(&e->prime);
+
+   *(*out)++ = (byte)(e->curve_id >> 8);
+   *(*out)++ = (byte)e->curve_id;
+   err = fp_shared_write(e->fp.g->x, out, fSz);
+   if (err == MP_OKAY)
+      err = fp_shared_write(e->fp.g->y, out, fSz);
+   if (err == MP_OKAY)
+      err = fp_shared_write(e->fp.g->z, out, fSz);
+   if (err == MP_OKAY)
+      err = fp_shared_write(&e->fp.mu, out, fSz);
+   for (x = 1; x < (1U<<FP_LUT) && err == MP_OKAY; x++) {
+      err = fp_shared_write(e->fp.LUT[x]->x, out, fSz);
+      if (err == MP_OKAY)
+         err = fp_shared_write(e->fp.LUT[x]->y, out, fSz);
+   }
+   return err;
+}
+
+/** Export all pinned tables so that they can be imported at startup instead
+    of being computed again.
+    out    Buffer to write to, NULL to get the length
+    outSz  [in/out] Size of buffer, set to length of data
+    return MP_OKAY on success, LENGTH_ONLY_E when out is NULL
+*/
+int wc_ecc_fp_export_shared(byte* out, word32* outSz)
+{
+   int err = MP_OKAY;
+   word32 h, cnt = 0, sz = FP_SHARED_HDR_SZ;
+   fp_shared_t* e;
+
+   if (outSz == NULL) {
+      return BAD_FUNC_ARG;
+   }
+   if ((err = fp_shared_lock_check()) != 0) {
+      return err;
+   }
+   if (wc_LockRwLock_Rd(&fp_shared_lock) != 0) {
+      return BAD_MUTEX_E;
+   }
+
+   for (h = 0; h < FP_SHARED_BUCKETS; h++) {
+      for (e = fp_shared[h]; e != NULL; e = e->next) {
+         cnt++;
+         sz += FP_SHARED_ENTRY_SZ(mp_unsigned_bin_size(&e->prime));
+      }
+   }
+   if (cnt > 0xFFFF) {
+      err = BUFFER_E;
+   }
+   else if (out == NULL) {
+      *outSz = sz;
+      err = WC_NO_ERR_TRACE(LENGTH_ONLY_E);
+   }
+   else if (*outSz < sz) {
+      err = BUFFER_E;
+   }
+
+   if (err == MP_OKAY) {
+      *outSz = sz;
+      *out++ = FP_SHARED_VERSION;
+      *out++ = (byte)FP_LUT;
+      *out++ = (byte)(cnt >> 8);
+      *out++ = (byte)cnt;
+      for (h = 0; h < FP_SHARED_BUCKETS && err == MP_OKAY; h++) {
+         for (e = fp_shared[h]; e != NULL && err == MP_OKAY; e = e->next) {
+            err = fp_shared_export_entry(e, &out);
+         }
+      }
+   }
+
+   wc_UnLockRwLock(&fp_shared_lock);
+
+   return err;
+}
+
+/* check that the jacobian point p is the affine LUT entry q, both in
+ * montgomery form: X = x * Z^2 and Y = y * Z^3 */
+static int fp_shared_same_point(ecc_point* p, ecc_point* q, mp_int* prime,
+                                mp_digit mp, mp_int* t1, mp_int* t2)
+{
+   int err = MP_OKAY;
+
+   /* the point at infinity is never an entry */
+   if (mp_iszero(p->z) || (mp_iszero(p->x) && mp_iszero(p->y))) {
+      err = IS_POINT_E;
+   }
+
+   if (err == MP_OKAY)
+      err = mp_sqr(p->z, t1);
+   if (err == MP_OKAY)
+      err = mp_montgomery_reduce(t1, prime, mp);
+   if (err == MP_OKAY)
+      err = mp_mul(q->x, t1, t2);
+   if (err == MP_OKAY)
+      err = mp_montgomery_reduce(t2, prime, mp);
+   if (err == MP_OKAY && mp_cmp(t2, p->x) != MP_EQ)
+      err = IS_POINT_E;
+
+   if (err == MP_OKAY)
+      err = mp_mul(t1, p->z, t2);
+   if (err == MP_OKAY)
+      err = mp_montgomery_reduce(t2, prime, mp);
+   if (err == MP_OKAY)
+      err = mp_mul(q->y, t2, t1);
+   if (err == MP_OKAY)
+      err = mp_montgomery_reduce(t1, prime, mp);
+   if (err == MP_OKAY && mp_cmp(t1, p->y) != MP_EQ)
+      err = IS_POINT_E;
+
+   return err;
+}
+
+/* load an affine LUT entry as a jacobian point with z one, in montgomery
+ * form */
+static int fp_shared_load(ecc_point* p, ecc_point* q, mp_int* one)
+{
+   int err = mp_copy(q->x, p->x);
+   if (err == MP_OKAY)
+      err = mp_copy(q->y, p->y);
+   if (err == MP_OKAY)
+      err = mp_copy(one, p->z);
+   return err;
+}
+
+/* check an imported entry against the base point and curve.
+ * Every LUT entry is checked to be the multiple of the base point that
+ * build_lut() computes: single bit entries by doubling the previous one and
+ * all others by adding the two entries they are built from. This is done in
+ * jacobian coordinates, without the inversions of building the LUT. */
+static int fp_shared_check(fp_shared_t* e, mp_int* a, mp_int* b,
+                           mp_int* prime)
+{
+   int err;
+   unsigned x, y, bitlen, lut_gap;
+   int infinity;
+   mp_digit mp = 0;
+   ecc_point* t;
+   ecc_point* t1 = NULL;
+   ecc_point* t2 = NULL;
+
+   t = wc_ecc_new_point();
+   if (t == NULL) {
+      return MEMORY_E;
+   }
+   t1 = wc_ecc_new_point();
+   t2 = wc_ecc_new_point();
+   err = (t1 == NULL || t2 == NULL) ? MEMORY_E : MP_OKAY;
+
+   /* affine base point on the curve */
+   if (err == MP_OKAY && mp_cmp_d(e->fp.g->z, 1) != MP_EQ)
+      err = ECC_BAD_ARG_E;
+   if (err == MP_OKAY)
+      err = wc_ecc_is_point(e->fp.g, a, b, prime);
+
+   /* all values must be reduced */
+   if (err == MP_OKAY && mp_cmp(&e->fp.mu, prime) != MP_LT)
+      err = ECC_OUT_OF_RANGE_E;
+   for (x = 1; x < (1U<<FP_LUT) && err == MP_OKAY; x++) {
+      if (mp_cmp(e->fp.LUT[x]->x, prime) != MP_LT ||
+          mp_cmp(e->fp.LUT[x]->y, prime) != MP_LT) {
+         err = ECC_OUT_OF_RANGE_E;
+      }
+   }
+
+   if (err == MP_OKAY)
+      err = mp_montgomery_setup(prime, &mp);
+   if (err == MP_OKAY)
+      err = mp_montgomery_calc_normalization(t->z, prime);
+   if (err == MP_OKAY && mp_cmp(t->z, &e->fp.mu) != MP_EQ)
+      err = ECC_BAD_ARG_E;
+
+   /* first entry is the base point in montgomery form */
+   if (err == MP_OKAY)
+      err = mp_mulmod(e->fp.g->x, &e->fp.mu, prime, t->x);
+   if (err == MP_OKAY)
+      err = mp_mulmod(e->fp.g->y, &e->fp.mu, prime, t->y);
+   if (err == MP_OKAY && (mp_cmp(t->x, e->fp.LUT[1]->x) != MP_EQ ||
+                          mp_cmp(t->y, e->fp.LUT[1]->y) != MP_EQ)) {
+      err = IS_POINT_E;
+   }
+
+   /* same spacing of bits as build_lut() */
+   bitlen = (unsigned)mp_unsigned_bin_size(prime) << 3;
+   x = bitlen % FP_LUT;
+   if (x) {
+      bitlen += FP_LUT - x;
+   }
+   lut_gap = bitlen / FP_LUT;
+
+   /* single bit entries */
+   for (x = 1; x < FP_LUT && err == MP_OKAY; x++) {
+      err = fp_shared_load(t, e->fp.LUT[1U << (x-1)], &e->fp.mu);
+      for (y = 0; y < lut_gap && err == MP_OKAY; y++) {
+         err = ecc_projective_dbl_point_safe(t, t, a, prime, mp);
+      }
+      if (err == MP_OKAY)
+         err = fp_shared_same_point(t, e->fp.LUT[1U << x], prime, mp,
+                                    t1->x, t1->y);
+   }
+
+   /* entries of two or more bits */
+   for (y = 1; y < (1U<<FP_LUT) && err == MP_OKAY; y++) {
+      if (lut_orders[y].ham < 2)
+         continue;
+      err = fp_shared_load(t1, e->fp.LUT[lut_orders[y].terma], &e->fp.mu);
+      if (err == MP_OKAY)
+         err = fp_shared_load(t2, e->fp.LUT[lut_orders[y].termb], &e->fp.mu);
+      infinity = 0;
+      if (err == MP_OKAY)
+         err = ecc_projective_add_point_safe(t1, t2, t, a, prime, mp,
+                                             &infinity);
+      if (err == MP_OKAY && infinity)
+         err = IS_POINT_E;
+      if (err == MP_OKAY)
+         err = fp_shared_same_point(t, e->fp.LUT[y], prime, mp,
+                                    t1->x, t1->y);
+   }
+
+   wc_ecc_del_point(t2);
+   wc_ecc_del_point(t1);
+   wc_ecc_del_point(t);
+   return err;
+}
+
+/* import and pin one exported entry of the curve at index curve_idx */
+static int fp_shared_import_entry(const byte* in, int curve_idx)
+{
+   int err;
+   unsigned x;
+   word32 fSz = (word32)ecc_sets[curve_idx].size;
+   fp_shared_t* e = NULL;
+   ecc_point* g;
+   DECLARE_CURVE_SPECS(3);
+
+   g = wc_ecc_new_point();
+   if (g == NULL) {
+      return MEMORY_E;
+   }
+
+   ALLOC_CURVE_SPECS(3, err);
+   if (err == MP_OKAY) {
+      err = wc_ecc_curve_load(ecc_sets + curve_idx, &curve,
+                              ECC_CURVE_FIELD_PRIME | ECC_CURVE_FIELD_AF |
+                              ECC_CURVE_FIELD_BF);
+   }
+
+   if (err == MP_OKAY)
+      err = mp_read_unsigned_bin(g->x, in, fSz);
+   if (err == MP_OKAY)
+      err = mp_read_unsigned_bin(g->y, in + fSz, fSz);
+   if (err == MP_OKAY)
+      err = mp_read_unsigned_bin(g->z, in + 2 * fSz, fSz);
+   in += 3 * fSz;
+   if (err == MP_OKAY)
+      err = fp_shared_new_entry(ecc_sets + curve_idx, curve->prime, g, &e);
+
+   if (err == MP_OKAY)
+      err = mp_read_unsigned_bin(&e->fp.mu, in, fSz);
+   in += fSz;
+   for (x = 1; x < (1U<<FP_LUT) && err == MP_OKAY; x++) {
+      err = mp_read_unsigned_bin(e->fp.LUT[x]->x, in, fSz);
+      if (err == MP_OKAY)
+         err = mp_read_unsigned_bin(e->fp.LUT[x]->y, in + fSz, fSz);
+      in += 2 * fSz;
+   }
+
+   if (err == MP_OKAY)
+      err = fp_shared_check(e, curve->Af, curve->Bf, curve->prime);
+   if (err == MP_OKAY) {
+      e->fp.LUT_set = 1;
+      err = fp_shared_insert(e);
+   }
+   else if (e != NULL) {
+      fp_shared_free_entry(e);
+   }
+
+   wc_ecc_curve_free(curve);
+   FREE_CURVE_SPECS();
+   wc_ecc_del_point(g);
+
+   return err;
+}
+
+/** Import tables exported with wc_ecc_fp_export_shared() and pin them.
+    Imported tables are checked before being used.
+    in    Exported tables
+    inSz  Length of exported tables
+    return MP_OKAY on success
+*/
+int wc_ecc_fp_import_shared(const byte* in, word32 inSz)
+{
+   int err;
+   word32 cnt, i, idx = FP_SHARED_HDR_SZ;
+
+   if (in == NULL) {
+      return BAD_FUNC_ARG;
+   }
+   if (inSz < FP_SHARED_HDR_SZ || in[0] != FP_SHARED_VERSION) {
+      return BUFFER_E;
+   }
+   /* tables are only usable with the same LUT size */
+   if (in[1] != (byte)FP_LUT) {
+      return BAD_FUNC_ARG;
+   }
+   if ((err = fp_shared_lock_check()) != 0) {
+      return err;
+   }
+   cnt = ((word32)in[2] << 8) | in[3];
+
+   for (i = 0; i < cnt && err == MP_OKAY; i++) {
+      int curve_idx;
+
+      if (inSz - idx < 2) {
+         err = BUFFER_E;
+         break;
+      }
+      curve_idx = wc_ecc_get_curve_idx(((int)in[idx] << 8) | in[idx + 1]);
+      if (curve_idx < 0) {
+         err = ECC_BAD_ARG_E;
+         break;
+      }
+      if (inSz - idx < FP_SHARED_ENTRY_SZ(ecc_sets[curve_idx].size)) {
+         err = BUFFER_E;
+         break;
+      }
+      err = fp_shared_import_entry(in + idx + 2, curve_idx);
+      idx += FP_SHARED_ENTRY_SZ(ecc_sets[curve_idx].size);
+   }
+
+   return err;
+}
+
+/** Free all pinned tables.
+    Tables in use by other threads are freed when their operation completes.
+*/
+void wc_ecc_fp_free_shared(void)
+{
+   word32 h;
+   fp_shared_t* e;
+
+   if (fp_shared_lock_init == 0) {
+      return;
+   }
+   if (wc_LockRwLock_Wr(&fp_shared_lock) == 0) {
+      for (h = 0; h < FP_SHARED_BUCKETS; h++) {
+         while ((e = fp_shared[h]) != NULL) {
+            fp_shared[h] = e->next;
+            fp_shared_release(e);
+         }
+      }
+      wc_UnLockRwLock(&fp_shared_lock);
+   }
+}
+
+/* Free all pinned tables and the lock of the store, called on cleanup. */
+void wc_ecc_fp_shared_cleanup(void)
+{
+   if (fp_shared_lock_init != 0) {
+      wc_ecc_fp_free_shared();
+      wc_FreeRwLock(&fp_shared_lock);
+      fp_shared_lock_init = 0;
+   }
+}
+
+#endif /* FP_ECC_SHARED */
+
 #endif /* FP_ECC */
 
 int wc_ecc_set_rng(ecc_key* key, WC_RNG* rng)
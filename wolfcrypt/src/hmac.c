@@ -1773,6 +1773,169 @@ int wolfSSL_GetHmacMaxSize(void)
     return WC_MAX_DIGEST_SIZE;
 }
 
+#if defined(WOLFSSL_SHA2_BATCH) && (!defined(NO_SHA256) || \
+    (defined(WOLFSSL_SHA512) && !defined(WOLF_CRYPTO_CB_ONLY_SHA512)))
+
+/* Messages whose inner digests are held at once by a batch HMAC. */
+#define HMAC_BATCH_CHUNK    16
+
+typedef int (*HmacBatchHash)(const byte* prefix, const byte* const* data,
+    const word32* len, byte* const* hash, word32 cnt);
+
+/* HMAC many messages with one key using the multi-buffer hash.
+ *
+ * The inner hashes of a chunk of messages are computed in parallel, then the
+ * outer hashes over the inner digests.
+ *
+ * @param [in]  hashBatch  Multi-buffer hash with a prefix block.
+ * @param [in]  blockSz    Block size of hash.
+ * @param [in]  digestSz   Digest size of hash.
+ * @param [in]  key        Key. May be NULL when keySz is 0.
+ * @param [in]  keySz      Size of key in bytes.
+ * @param [in]  data       Messages. Entry may be NULL when its length is 0.
+ * @param [in]  len        Length of each message in bytes.
+ * @param [out] mac        Buffer of digestSz bytes for each MAC.
+ * @param [in]  cnt        Number of messages.
+ * @return  0 on success.
+ * @return  BAD_FUNC_ARG when key is NULL and keySz is not 0.
+ */
+static int HmacBatch(HmacBatchHash hashBatch, word32 blockSz, word32 digestSz,
+    const byte* key, word32 keySz, const byte* const* data, const word32* len,
+    byte* const* mac, word32 cnt)
+{
+    int ret = 0;
+    word32 i;
+    word32 j;
+    byte ipad[WC_HMAC_BLOCK_SIZE];
+    byte opad[WC_HMAC_BLOCK_SIZE];
+    byte inner[HMAC_BATCH_CHUNK * WC_MAX_DIGEST_SIZE];
+    const byte* innerData[HMAC_BATCH_CHUNK];
+    byte* innerHash[HMAC_BATCH_CHUNK];
+    word32 innerLen[HMAC_BATCH_CHUNK];
+
+    if ((key == NULL) && (keySz != 0)) {
+        return BAD_FUNC_ARG;
+    }
+
+    XMEMSET(ipad, 0, blockSz);
+    if (keySz > blockSz) {
+        /* Long keys are hashed down to a digest. */
+        byte* keyHash = ipad;
+
+        ret = hashBatch(NULL, &key, &keySz, &keyHash, 1);
+    }
+    else if (keySz > 0) {
+        XMEMCPY(ipad, key, keySz);
+    }
+    if (ret == 0) {
+        for (i = 0; i < blockSz; i++) {
+            opad[i] = (byte)(ipad[i] ^ OPAD);
+            ipad[i] ^= IPAD;
+        }
+        for (j = 0; j < HMAC_BATCH_CHUNK; j++) {
+            innerData[j] = inner + j * digestSz;
+            innerHash[j] = inner + j * digestSz;
+            innerLen[j] = digestSz;
+        }
+    }
+
+    for (i = 0; (ret == 0) && (i < cnt); i += HMAC_BATCH_CHUNK) {
+        word32 n = ((cnt - i) < HMAC_BATCH_CHUNK) ? (cnt - i) :
+                                                    HMAC_BATCH_CHUNK;
+
+        /* H(K ^ ipad || m) */
+        ret = hashBatch(ipad, data + i, len + i, innerHash, n);
+        if (ret == 0) {
+            /* H(K ^ opad || H(K ^ ipad || m)) */
+            ret = hashBatch(opad, innerData, innerLen, mac + i, n);
+        }
+    }
+
+    ForceZero(ipad, sizeof(ipad));
+    ForceZero(opad, sizeof(opad));
+    ForceZero(inner, sizeof(inner));
+    return ret;
+}
+
+/* Check the arrays of a batch HMAC call.
+ *
+ * @param [in] data  Messages.
+ * @param [in] len   Length of each message in bytes.
+ * @param [in] mac   Buffer for each MAC.
+ * @param [in] cnt   Number of messages.
+ * @return  0 when valid.
+ * @return  BAD_FUNC_ARG when an array or message is NULL.
+ */
+static int HmacBatchCheck(const byte* const* data, const word32* len,
+    byte* const* mac, word32 cnt)
+{
+    word32 i;
+
+    if ((cnt > 0) && ((data == NULL) || (len == NULL) || (mac == NULL))) {
+        return BAD_FUNC_ARG;
+    }
+    for (i = 0; i < cnt; i++) {
+        if (((data[i] == NULL) && (len[i] != 0)) || (mac[i] == NULL)) {
+            return BAD_FUNC_ARG;
+        }
+    }
+    return 0;
+}
+
+#ifndef NO_SHA256
+/* HMAC-SHA256 many independent messages with one key.
+ *
+ * @param [in]  key    Key. May be NULL when keySz is 0.
+ * @param [in]  keySz  Size of key in bytes.
+ * @param [in]  data   Messages. Entry may be NULL when its length is 0.
+ * @param [in]  len    Length of each message in bytes.
+ * @param [out] mac    Buffer of WC_SHA256_DIGEST_SIZE bytes for each MAC.
+ * @param [in]  cnt    Number of messages.
+ * @return  0 on success.
+ * @return  BAD_FUNC_ARG when an array, message or the key is NULL.
+ * @return  MEMORY_E when dynamic memory allocation fails.
+ */
+int wc_HmacSha256Batch(const byte* key, word32 keySz, const byte* const* data,
+    const word32* len, byte* const* mac, word32 cnt)
+{
+    int ret = HmacBatchCheck(data, len, mac, cnt);
+
+    if (ret == 0) {
+        ret = HmacBatch(wc_Sha256HashBatch_ex, WC_SHA256_BLOCK_SIZE,
+            WC_SHA256_DIGEST_SIZE, key, keySz, data, len, mac, cnt);
+    }
+    return ret;
+}
+#endif /* !NO_SHA256 */
+
+#if defined(WOLFSSL_SHA512) && !defined(WOLF_CRYPTO_CB_ONLY_SHA512)
+/* HMAC-SHA512 many independent messages with one key.
+ *
+ * @param [in]  key    Key. May be NULL when keySz is 0.
+ * @param [in]  keySz  Size of key in bytes.
+ * @param [in]  data   Messages. Entry may be NULL when its length is 0.
+ * @param [in]  len    Length of each message in bytes.
+ * @param [out] mac    Buffer of WC_SHA512_DIGEST_SIZE bytes for each MAC.
+ * @param [in]  cnt    Number of messages.
+ * @return  0 on success.
+ * @return  BAD_FUNC_ARG when an array, message or the key is NULL.
+ * @return  MEMORY_E when dynamic memory allocation fails.
+ */
+int wc_HmacSha512Batch(const byte* key, word32 keySz, const byte* const* data,
+    const word32* len, byte* const* mac, word32 cnt)
+{
+    int ret = HmacBatchCheck(data, len, mac, cnt);
+
+    if (ret == 0) {
+        ret = HmacBatch(wc_Sha512HashBatch_ex, WC_SHA512_BLOCK_SIZE,
+            WC_SHA512_DIGEST_SIZE, key, keySz, data, len, mac, cnt);
+    }
+    return ret;
+}
+#endif /* WOLFSSL_SHA512 && !WOLF_CRYPTO_CB_ONLY_SHA512 */
+
+#endif /* WOLFSSL_SHA2_BATCH */
+
 #ifdef HAVE_HKDF
     /* HMAC-KDF-Extract.
      * RFC 5869 - HMAC-based Extract-and-Expand Key Derivation Function (HKDF).
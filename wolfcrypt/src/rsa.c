@@ -338,6 +338,20 @@ int wc_InitRsaKey_ex(RsaKey* key, void* heap, int devId)
         mp_clear(&key->e);
         return ret;
     }
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    {
+        int i;
+        for (i = 0; (ret == MP_OKAY) && (i < WC_RSA_MAX_PRIMES - 2); i++) {
+            ret = mp_init_multi(&key->other[i].r, &key->other[i].d,
+                &key->other[i].t, NULL, NULL, NULL);
+        }
+        if (ret != MP_OKAY) {
+            mp_clear(&key->n);
+            mp_clear(&key->e);
+            return ret;
+        }
+    }
+#endif
 #else
     ret = mp_init(&key->n);
     if (ret != MP_OKAY)
@@ -682,6 +696,17 @@ int wc_FreeRsaKey(RsaKey* key)
     /* Forcezero all private key fields that are present in this build
      * configuration, since they may contain residual sensitive data even when
      * key->type is not RSA_PRIVATE (e.g., after a partial key decode failure). */
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    {
+        int i;
+        for (i = 0; i < WC_RSA_MAX_PRIMES - 2; i++) {
+            mp_forcezero(&key->other[i].t);
+            mp_forcezero(&key->other[i].d);
+            mp_forcezero(&key->other[i].r);
+        }
+        key->otherCnt = 0;
+    }
+#endif
 #if defined(WOLFSSL_KEY_GEN) || defined(OPENSSL_EXTRA) || !defined(RSA_LOW_MEM)
     mp_forcezero(&key->u);
     mp_forcezero(&key->dQ);
@@ -887,6 +912,17 @@ int wc_CheckRsaKey(RsaKey* key)
             ret = MP_EXPTMOD_E;
         }
     }
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    /* Check p*q*r_3*...*r_u = n for a multi-prime key. */
+    if (ret == 0) {
+        int i;
+        for (i = 0; (ret == 0) && (i < key->otherCnt); i++) {
+            if (mp_mul(tmp, &key->other[i].r, tmp) != MP_OKAY) {
+                ret = MP_EXPTMOD_E;
+            }
+        }
+    }
+#endif
     if (ret == 0 ) {
         if (mp_cmp(&key->n, tmp) != MP_EQ) {
             ret = MP_EXPTMOD_E;
@@ -973,6 +1009,31 @@ int wc_CheckRsaKey(RsaKey* key)
             }
         }
     }
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    /* Check the CRT exponent of each other prime. */
+    if (ret == 0) {
+        int i;
+        for (i = 0; (ret == 0) && (i < key->otherCnt); i++) {
+            RsaOtherPrime* o = &key->other[i];
+
+            if (mp_sub_d(&o->r, 1, tmp) != MP_OKAY) {
+                ret = MP_EXPTMOD_E;
+            }
+            /* Check d_i < r_i-1. */
+            if ((ret == 0) && (mp_cmp(&o->d, tmp) != MP_LT)) {
+                ret = MP_EXPTMOD_E;
+            }
+            /* Check e*d_i mod r_i-1 = 1. */
+            if ((ret == 0) && (mp_mulmod(&o->d, &key->e, tmp, tmp) !=
+                    MP_OKAY)) {
+                ret = MP_EXPTMOD_E;
+            }
+            if ((ret == 0) && !mp_isone(tmp)) {
+                ret = MP_EXPTMOD_E;
+            }
+        }
+    }
+#endif
 
     mp_forcezero(tmp);
 
@@ -2877,6 +2938,126 @@ static int RsaFunction_SP(const byte* in, word32 inLen, byte* out,
 
 #if !defined(WOLFSSL_SP_MATH)
 #if !defined(WOLFSSL_RSA_PUBLIC_ONLY) && !defined(WOLFSSL_RSA_VERIFY_ONLY)
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+/* Private key operation of a multi-prime key using the CRT (RFC 8017, 5.1.2).
+ *
+ * Each exponentiation is modulo a prime of n/u bits rather than n/2 bits.
+ * Caller blinds the input.
+ *
+ * @param [in, out] tmp  Input on entry, result on exit.
+ * @param [in]      key  Multi-prime RSA private key.
+ * @return  0 on success.
+ * @return  MEMORY_E when dynamic memory allocation fails.
+ * @return  MP_* error code when a math operation fails.
+ */
+static int RsaFunctionPrivateMulti(mp_int* tmp, RsaKey* key)
+{
+    int ret = 0;
+    int i;
+    DECL_MP_INT_SIZE_DYN(c, mp_bitsused(&key->n), RSA_MAX_SIZE);
+    DECL_MP_INT_SIZE_DYN(m, mp_bitsused(&key->n), RSA_MAX_SIZE);
+    DECL_MP_INT_SIZE_DYN(h, mp_bitsused(&key->n), RSA_MAX_SIZE);
+    DECL_MP_INT_SIZE_DYN(r, mp_bitsused(&key->n), RSA_MAX_SIZE);
+
+    NEW_MP_INT_SIZE(c, mp_bitsused(&key->n), key->heap, DYNAMIC_TYPE_RSA);
+    NEW_MP_INT_SIZE(m, mp_bitsused(&key->n), key->heap, DYNAMIC_TYPE_RSA);
+    NEW_MP_INT_SIZE(h, mp_bitsused(&key->n), key->heap, DYNAMIC_TYPE_RSA);
+    NEW_MP_INT_SIZE(r, mp_bitsused(&key->n), key->heap, DYNAMIC_TYPE_RSA);
+#ifdef MP_INT_SIZE_CHECK_NULL
+    if ((c == NULL) || (m == NULL) || (h == NULL) || (r == NULL)) {
+        FREE_MP_INT_SIZE(r, key->heap, DYNAMIC_TYPE_RSA);
+        FREE_MP_INT_SIZE(h, key->heap, DYNAMIC_TYPE_RSA);
+        FREE_MP_INT_SIZE(m, key->heap, DYNAMIC_TYPE_RSA);
+        FREE_MP_INT_SIZE(c, key->heap, DYNAMIC_TYPE_RSA);
+        return MEMORY_E;
+    }
+#endif
+
+    if ((INIT_MP_INT_SIZE(c, mp_bitsused(&key->n)) != MP_OKAY) ||
+            (INIT_MP_INT_SIZE(m, mp_bitsused(&key->n)) != MP_OKAY) ||
+            (INIT_MP_INT_SIZE(h, mp_bitsused(&key->n)) != MP_OKAY) ||
+            (INIT_MP_INT_SIZE(r, mp_bitsused(&key->n)) != MP_OKAY)) {
+        ret = MP_INIT_E;
+    }
+#ifdef WOLFSSL_CHECK_MEM_ZERO
+    if (ret == 0) {
+        mp_memzero_add("RSA Multi c", c);
+        mp_memzero_add("RSA Multi m", m);
+        mp_memzero_add("RSA Multi h", h);
+        mp_memzero_add("RSA Multi r", r);
+    }
+#endif
+
+    if ((ret == 0) && (mp_copy(tmp, c) != MP_OKAY))
+        ret = MP_READ_E;
+
+    /* m = c^dQ mod q */
+    if ((ret == 0) && (mp_exptmod(c, &key->dQ, &key->q, m) != MP_OKAY))
+        ret = MP_EXPTMOD_E;
+    /* h = c^dP mod p */
+    if ((ret == 0) && (mp_exptmod(c, &key->dP, &key->p, h) != MP_OKAY))
+        ret = MP_EXPTMOD_E;
+    /* h = (h - m) * qInv mod p */
+    if ((ret == 0) && (mp_submod(h, m, &key->p, h) != MP_OKAY))
+        ret = MP_SUB_E;
+    if ((ret == 0) && (mp_mulmod(h, &key->u, &key->p, h) != MP_OKAY))
+        ret = MP_MULMOD_E;
+    /* m = m + q * h */
+    if ((ret == 0) && (mp_mul(h, &key->q, h) != MP_OKAY))
+        ret = MP_MUL_E;
+    if ((ret == 0) && (mp_add(m, h, m) != MP_OKAY))
+        ret = MP_ADD_E;
+    /* r = p * q */
+    if ((ret == 0) && (mp_mul(&key->p, &key->q, r) != MP_OKAY))
+        ret = MP_MUL_E;
+
+    for (i = 0; (ret == 0) && (i < key->otherCnt); i++) {
+        RsaOtherPrime* o = &key->other[i];
+
+        /* h = c^d_i mod r_i */
+        if (mp_exptmod(c, &o->d, &o->r, h) != MP_OKAY)
+            ret = MP_EXPTMOD_E;
+        /* tmp = m mod r_i */
+        if ((ret == 0) && (mp_mod(m, &o->r, tmp) != MP_OKAY))
+            ret = MP_MOD_E;
+        /* h = (h - tmp) * t_i mod r_i */
+        if ((ret == 0) && (mp_submod(h, tmp, &o->r, h) != MP_OKAY))
+            ret = MP_SUB_E;
+        if ((ret == 0) && (mp_mulmod(h, &o->t, &o->r, h) != MP_OKAY))
+            ret = MP_MULMOD_E;
+        /* m = m + r * h */
+        if ((ret == 0) && (mp_mul(h, r, h) != MP_OKAY))
+            ret = MP_MUL_E;
+        if ((ret == 0) && (mp_add(m, h, m) != MP_OKAY))
+            ret = MP_ADD_E;
+        /* r = r * r_i */
+        if ((ret == 0) && (i + 1 < key->otherCnt) &&
+                (mp_mul(r, &o->r, r) != MP_OKAY)) {
+            ret = MP_MUL_E;
+        }
+    }
+
+    if ((ret == 0) && (mp_copy(m, tmp) != MP_OKAY))
+        ret = MP_TO_E;
+
+    mp_forcezero(r);
+    mp_forcezero(h);
+    mp_forcezero(m);
+    mp_forcezero(c);
+    FREE_MP_INT_SIZE(r, key->heap, DYNAMIC_TYPE_RSA);
+    FREE_MP_INT_SIZE(h, key->heap, DYNAMIC_TYPE_RSA);
+    FREE_MP_INT_SIZE(m, key->heap, DYNAMIC_TYPE_RSA);
+    FREE_MP_INT_SIZE(c, key->heap, DYNAMIC_TYPE_RSA);
+#if !defined(MP_INT_SIZE_CHECK_NULL) && defined(WOLFSSL_CHECK_MEM_ZERO)
+    mp_memzero_check(r);
+    mp_memzero_check(h);
+    mp_memzero_check(m);
+    mp_memzero_check(c);
+#endif
+    return ret;
+}
+#endif /* WOLFSSL_RSA_MULTI_PRIME */
+
 static int RsaFunctionPrivate(mp_int* tmp, RsaKey* key, WC_RNG* rng)
 {
     int    ret = 0;
@@ -2957,6 +3138,11 @@ static int RsaFunctionPrivate(mp_int* tmp, RsaKey* key, WC_RNG* rng)
             ret = MP_EXPTMOD_E;
         }
     }
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    else if ((ret == 0) && (key->otherCnt > 0)) {
+        ret = RsaFunctionPrivateMulti(tmp, key);
+    }
+#endif
     else if (ret == 0) {
         mp_int* tmpa = tmp;
 #if defined(WC_RSA_BLINDING) && !defined(WC_NO_RNG)
@@ -3129,7 +3315,12 @@ static int RsaFunctionSync(const byte* in, word32 inLen, byte* out,
         }
     }
 #ifdef WOLFSSL_RSA_CHECK_D_ON_DECRYPT
-    if ((ret == 0) && (type == RSA_PRIVATE_DECRYPT)) {
+    /* phi = n - p - q + 1 only holds for two-prime keys. */
+    if ((ret == 0) && (type == RSA_PRIVATE_DECRYPT)
+    #ifdef WOLFSSL_RSA_MULTI_PRIME
+            && (key->otherCnt == 0)
+    #endif
+            ) {
         mp_sub(&key->n, &key->p, tmp);
         mp_sub(tmp, &key->q, tmp);
         mp_add_d(tmp, 1, tmp);
@@ -5989,6 +6180,339 @@ int wc_MakeRsaKey(RsaKey* key, int size, long e, WC_RNG* rng)
 #endif /* !FIPS || FIPS_VER >= 2 */
 #endif /* WOLFSSL_KEY_GEN */
 
+#if defined(WOLFSSL_KEY_GEN) && defined(WOLFSSL_RSA_MULTI_PRIME)
+/* Maximum number of primes allowed for a modulus size.
+ * Keeps each prime large enough that factoring it is no easier than factoring
+ * a two-prime modulus of the same size with the best known algorithms.
+ */
+static int RsaMultiPrimeMax(int size)
+{
+    if (size < 4096)
+        return 3;
+    if (size < 8192)
+        return 4;
+    return 5;
+}
+
+/* Generate a random prime of exactly bits bits for a multi-prime key.
+ *
+ * The top two bits are set so that the product of the primes has close to the
+ * sum of their sizes in bits. gcd(r-1, e) is 1 so that e is invertible.
+ *
+ * @param [out] r     Prime generated.
+ * @param [in]  bits  Size of prime in bits.
+ * @param [in]  e     Public exponent.
+ * @param [in]  tmp1  Temporary.
+ * @param [in]  tmp2  Temporary.
+ * @param [in]  buf   Buffer of at least (bits + 7) / 8 bytes.
+ * @param [in]  rng   Random number generator.
+ * @return  0 on success.
+ * @return  PRIME_GEN_E when no prime found in the allowed number of attempts.
+ * @return  Other negative on failure.
+ */
+static int _MakeRsaMultiPrime(mp_int* r, int bits, mp_int* e, mp_int* tmp1,
+    mp_int* tmp2, byte* buf, WC_RNG* rng)
+{
+    int err = 0;
+    int isPrime = 0;
+    int i;
+    word32 sz = ((word32)bits + 7) / 8;
+    int topBits = bits - (int)(sz - 1) * 8;
+
+    for (i = 0; (err == 0) && (!isPrime) && (i < 5 * bits); i++) {
+        err = wc_RNG_GenerateBlock(rng, buf, sz);
+        if (err == 0) {
+            /* Keep only bits bits. */
+            buf[0] &= (byte)(0xff >> (8 - topBits));
+            err = mp_read_unsigned_bin(r, buf, sz);
+        }
+        if (err == MP_OKAY)
+            err = mp_set_bit(r, bits - 1);
+        if (err == MP_OKAY)
+            err = mp_set_bit(r, bits - 2);
+        /* make candidate odd */
+        if (err == MP_OKAY)
+            err = mp_set_bit(r, 0);
+
+        /* Check that GCD(r-1, e) == 1 */
+        if (err == MP_OKAY)
+            err = mp_sub_d(r, 1, tmp1);
+        if (err == MP_OKAY)
+            err = mp_gcd(tmp1, e, tmp2);
+        if ((err == MP_OKAY) && mp_isone(tmp2))
+            err = mp_prime_is_prime_ex(r, 8, &isPrime, rng);
+
+        if (err == 0)
+            err = WC_CHECK_FOR_INTR_SIGNALS();
+        WC_RELAX_LONG_LOOP();
+    }
+
+    ForceZero(buf, sz);
+    mp_forcezero(tmp1);
+
+    if ((err == 0) && (!isPrime))
+        err = PRIME_GEN_E;
+    return err;
+}
+
+/* Make a multi-prime RSA key (RFC 8017, 3.2).
+ *
+ * n is the product of primes primes of about size/primes bits each. The
+ * private key operation then uses the CRT over primes smaller moduli which is
+ * cheaper than over two. p and q are the first two primes.
+ *
+ * @param [in, out] key     Initialized RSA key to fill.
+ * @param [in]      size    Size of modulus in bits.
+ * @param [in]      e       Public exponent.
+ * @param [in]      primes  Number of primes. Two makes a standard key.
+ * @param [in]      rng     Random number generator.
+ * @return  0 on success.
+ * @return  BAD_FUNC_ARG when key or rng is NULL, size or e is invalid or
+ *          primes is out of range for size.
+ * @return  PRIME_GEN_E when a prime could not be generated.
+ * @return  Other negative on failure.
+ */
+int wc_MakeRsaKeyMultiPrime(RsaKey* key, int size, long e, int primes,
+    WC_RNG* rng)
+{
+#ifdef WOLFSSL_SMALL_STACK
+    mp_int *tmp1 = NULL;
+    mp_int *tmp2 = NULL;
+    mp_int *tmp3 = NULL;
+#else
+    mp_int tmp1_buf, *tmp1 = &tmp1_buf;
+    mp_int tmp2_buf, *tmp2 = &tmp2_buf;
+    mp_int tmp3_buf, *tmp3 = &tmp3_buf;
+#endif
+#ifndef WOLFSSL_NO_MALLOC
+    byte* buf = NULL;
+#else
+    byte buf[RSA_MAX_SIZE/8];
+#endif
+    mp_int* r = NULL;
+    int bits = 0;
+    int i;
+    int j;
+    int err = 0;
+
+    if ((key == NULL) || (rng == NULL)) {
+        return BAD_FUNC_ARG;
+    }
+    if (primes == 2) {
+        return wc_MakeRsaKey(key, size, e, rng);
+    }
+    if ((!RsaSizeCheck(size)) || (primes < 2) ||
+            (primes > WC_RSA_MAX_PRIMES) || (primes > RsaMultiPrimeMax(size))) {
+        return BAD_FUNC_ARG;
+    }
+    if ((e < 3) || ((e & 1) == 0)) {
+        return BAD_FUNC_ARG;
+    }
+
+#ifdef WOLFSSL_SMALL_STACK
+    tmp1 = (mp_int *)XMALLOC(sizeof *tmp1, key->heap, DYNAMIC_TYPE_RSA);
+    tmp2 = (mp_int *)XMALLOC(sizeof *tmp2, key->heap, DYNAMIC_TYPE_RSA);
+    tmp3 = (mp_int *)XMALLOC(sizeof *tmp3, key->heap, DYNAMIC_TYPE_RSA);
+    if ((tmp1 == NULL) || (tmp2 == NULL) || (tmp3 == NULL)) {
+        XFREE(tmp3, key->heap, DYNAMIC_TYPE_RSA);
+        XFREE(tmp2, key->heap, DYNAMIC_TYPE_RSA);
+        XFREE(tmp1, key->heap, DYNAMIC_TYPE_RSA);
+        return MEMORY_E;
+    }
+#endif
+    err = mp_init_multi(tmp1, tmp2, tmp3, NULL, NULL, NULL);
+#ifndef WOLFSSL_NO_MALLOC
+    if (err == MP_OKAY) {
+        buf = (byte*)XMALLOC((word32)size / 8, key->heap, DYNAMIC_TYPE_RSA);
+        if (buf == NULL)
+            err = MEMORY_E;
+    }
+#endif
+#ifdef WOLFSSL_CHECK_MEM_ZERO
+    if (err == 0) {
+        mp_memzero_add("RSA multi gen tmp1", tmp1);
+        mp_memzero_add("RSA multi gen tmp2", tmp2);
+        mp_memzero_add("RSA multi gen tmp3", tmp3);
+    }
+#endif
+
+    /* tmp3 = e */
+    if (err == MP_OKAY)
+        err = mp_set_int(tmp3, (unsigned long)e);
+
+    /* Generate primes, n = r_1 * ... * r_u */
+    for (i = 0; (err == MP_OKAY) && (i < primes); i++) {
+        r = (i == 0) ? &key->p : ((i == 1) ? &key->q : &key->other[i-2].r);
+        bits = size / primes + ((i < size % primes) ? 1 : 0);
+
+        for (;;) {
+            err = _MakeRsaMultiPrime(r, bits, tmp3, tmp1, tmp2, buf, rng);
+            if (err != MP_OKAY)
+                break;
+            /* Primes must all be different. */
+            for (j = 0; j < i; j++) {
+                if (mp_cmp(r, (j == 0) ? &key->p : ((j == 1) ? &key->q :
+                        &key->other[j-2].r)) == MP_EQ) {
+                    break;
+                }
+            }
+            if (j < i)
+                continue;
+
+            if (i == 0) {
+                err = mp_copy(r, &key->n);
+                break;
+            }
+            err = mp_mul(&key->n, r, tmp1);
+            /* Last prime must make n exactly size bits. */
+            if ((err == MP_OKAY) && (i == primes - 1) &&
+                    (mp_count_bits(tmp1) != size)) {
+                continue;
+            }
+            if (err == MP_OKAY)
+                err = mp_copy(tmp1, &key->n);
+            break;
+        }
+    }
+
+    /* tmp2 = (p-1)(q-1)(r_3-1)...(r_u-1) */
+    if (err == MP_OKAY)
+        err = mp_sub_d(&key->p, 1, tmp2);
+    for (i = 1; (err == MP_OKAY) && (i < primes); i++) {
+        r = (i == 1) ? &key->q : &key->other[i-2].r;
+        err = mp_sub_d(r, 1, tmp1);
+        if (err == MP_OKAY)
+            err = mp_mul(tmp2, tmp1, tmp2);
+    }
+
+    /* make key */
+    if (err == MP_OKAY)                /* key->e = e */
+        err = mp_set_int(&key->e, (unsigned long)e);
+#ifdef WC_RSA_BLINDING
+    /* Blind the inverse operation with a value that is invertable */
+    if (err == MP_OKAY) {
+        do {
+            err = mp_rand(tmp1, mp_get_digit_count(tmp2), rng);
+            if (err == MP_OKAY)
+                err = mp_set_bit(tmp1, 0);
+            if (err == MP_OKAY)
+                err = mp_set_bit(tmp1, size - 1);
+            if (err == MP_OKAY)
+                err = mp_gcd(tmp1, tmp2, &key->d);
+        }
+        while ((err == MP_OKAY) && !mp_isone(&key->d));
+    }
+    if (err == MP_OKAY)
+        err = mp_mul(tmp1, &key->e, &key->e);
+#endif
+    if (err == MP_OKAY)                /* key->d = 1/e mod phi(n) */
+        err = mp_invmod(&key->e, tmp2, &key->d);
+#ifdef WC_RSA_BLINDING
+    /* Take off blinding from d and reset e */
+    if (err == MP_OKAY)
+        err = mp_mulmod(&key->d, tmp1, tmp2, &key->d);
+    if (err == MP_OKAY)
+        err = mp_set_int(&key->e, (unsigned long)e);
+#endif
+
+    /* CRT exponents: d mod (r_i - 1) */
+    if (err == MP_OKAY)
+        err = mp_sub_d(&key->p, 1, tmp1);
+    if (err == MP_OKAY)                /* key->dP = d mod(p-1) */
+        err = mp_mod(&key->d, tmp1, &key->dP);
+    if (err == MP_OKAY)
+        err = mp_sub_d(&key->q, 1, tmp1);
+    if (err == MP_OKAY)                /* key->dQ = d mod(q-1) */
+        err = mp_mod(&key->d, tmp1, &key->dQ);
+    for (i = 0; (err == MP_OKAY) && (i < primes - 2); i++) {
+        err = mp_sub_d(&key->other[i].r, 1, tmp1);
+        if (err == MP_OKAY)
+            err = mp_mod(&key->d, tmp1, &key->other[i].d);
+    }
+
+    /* CRT coefficients */
+#ifdef WOLFSSL_MP_INVMOD_CONSTANT_TIME
+    if (err == MP_OKAY)                /* key->u = 1/q mod p */
+        err = mp_invmod(&key->q, &key->p, &key->u);
+#else
+    if (err == MP_OKAY)
+        err = mp_sub_d(&key->p, 2, tmp3);
+    if (err == MP_OKAY)                /* key->u = 1/q mod p = q^p-2 mod p */
+        err = mp_exptmod(&key->q, tmp3, &key->p, &key->u);
+#endif
+    if (err == MP_OKAY)                /* tmp2 = p * q */
+        err = mp_mul(&key->p, &key->q, tmp2);
+    for (i = 0; (err == MP_OKAY) && (i < primes - 2); i++) {
+        r = &key->other[i].r;
+        err = mp_mod(tmp2, r, tmp1);
+    #ifdef WOLFSSL_MP_INVMOD_CONSTANT_TIME
+        if (err == MP_OKAY)            /* t_i = 1/(r_1...r_(i-1)) mod r_i */
+            err = mp_invmod(tmp1, r, &key->other[i].t);
+    #else
+        if (err == MP_OKAY)
+            err = mp_sub_d(r, 2, tmp3);
+        if (err == MP_OKAY)            /* t_i = (r_1...r_(i-1))^(r_i-2) mod r_i */
+            err = mp_exptmod(tmp1, tmp3, r, &key->other[i].t);
+    #endif
+        if (err == MP_OKAY)
+            err = mp_mul(tmp2, r, tmp2);
+    }
+
+    if (err == MP_OKAY) {
+        key->otherCnt = primes - 2;
+        key->type = RSA_PRIVATE;
+    }
+
+#ifdef WOLFSSL_CHECK_MEM_ZERO
+    if (err == MP_OKAY) {
+        mp_memzero_add("Make RSA key d", &key->d);
+        mp_memzero_add("Make RSA key p", &key->p);
+        mp_memzero_add("Make RSA key q", &key->q);
+        mp_memzero_add("Make RSA key dP", &key->dP);
+        mp_memzero_add("Make RSA key dQ", &key->dQ);
+        mp_memzero_add("Make RSA key u", &key->u);
+        for (i = 0; i < primes - 2; i++) {
+            mp_memzero_add("Make RSA key r_i", &key->other[i].r);
+            mp_memzero_add("Make RSA key d_i", &key->other[i].d);
+            mp_memzero_add("Make RSA key t_i", &key->other[i].t);
+        }
+    }
+#endif
+
+    /* Last value blinding or a prime minus 1. */
+    mp_forcezero(tmp1);
+    /* Last value phi(n) or product of primes. */
+    mp_forcezero(tmp2);
+    /* Last value a prime minus 2. */
+    mp_forcezero(tmp3);
+
+#ifdef WOLFSSL_RSA_KEY_CHECK
+    /* Perform the pair-wise consistency test on the new key. */
+    if (err == 0)
+        err = _ifc_pairwise_consistency_test(key, rng);
+#endif
+
+    if (err != 0) {
+        wc_FreeRsaKey(key);
+    }
+
+#ifndef WOLFSSL_NO_MALLOC
+    XFREE(buf, key->heap, DYNAMIC_TYPE_RSA);
+#endif
+#ifdef WOLFSSL_SMALL_STACK
+    XFREE(tmp3, key->heap, DYNAMIC_TYPE_RSA);
+    XFREE(tmp2, key->heap, DYNAMIC_TYPE_RSA);
+    XFREE(tmp1, key->heap, DYNAMIC_TYPE_RSA);
+#elif defined(WOLFSSL_CHECK_MEM_ZERO)
+    mp_memzero_check(tmp1);
+    mp_memzero_check(tmp2);
+    mp_memzero_check(tmp3);
+#endif
+
+    return err;
+}
+#endif /* WOLFSSL_KEY_GEN && WOLFSSL_RSA_MULTI_PRIME */
+
 #ifndef WC_NO_RNG
 int wc_RsaSetRNG(RsaKey* key, WC_RNG* rng)
 {
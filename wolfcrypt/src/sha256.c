@@ -3471,4 +3471,536 @@ int wc_Sha256GetFlags(wc_Sha256* sha256, word32* flags)
 #endif
 #endif /* !WOLFSSL_TI_HASH */
 
+#ifdef WOLFSSL_SHA2_BATCH
+
+/* Multi-buffer SHA-256.
+ *
+ * Independent messages are hashed side by side, one message per SIMD lane.
+ * Message words are transposed so that word j of every lane is contiguous and
+ * the compression function runs once for all lanes. Lanes whose message has
+ * no more blocks keep being computed (on stale words) and their output is
+ * ignored - the digest of each lane is taken after its last block.
+ */
+
+#ifdef NEED_SOFT_SHA256
+
+/* Stride, in words, of the transposed state and message schedule. */
+#define SHA256_BATCH_STRIDE     WC_SHA256_BATCH_LANES
+/* Lanes computed by the C kernel. */
+#define SHA256_BATCH_C_LANES    8
+
+#if defined(WOLFSSL_X86_64_BUILD) && defined(USE_INTEL_SPEEDUP) && \
+    (defined(__GNUC__) || defined(__clang__)) && !defined(NO_AVX2_SUPPORT)
+    #include <immintrin.h>
+
+    #define SHA256_BATCH_AVX2
+    #define SHA256_BATCH_AVX2_TARGET    __attribute__((target("avx2")))
+    #ifndef NO_AVX512_SUPPORT
+        #define SHA256_BATCH_AVX512
+        #define SHA256_BATCH_AVX512_TARGET  __attribute__((target("avx512f")))
+    #endif
+#endif
+
+typedef void (*Sha256BatchTransform)(word32* s, const word32* w);
+
+#define SHA256_BATCH_S(x, n)    rotrFixed(x, n)
+#define SHA256_BATCH_S0(x) \
+    (SHA256_BATCH_S(x, 2) ^ SHA256_BATCH_S(x, 13) ^ SHA256_BATCH_S(x, 22))
+#define SHA256_BATCH_S1(x) \
+    (SHA256_BATCH_S(x, 6) ^ SHA256_BATCH_S(x, 11) ^ SHA256_BATCH_S(x, 25))
+#define SHA256_BATCH_G0(x) \
+    (SHA256_BATCH_S(x, 7) ^ SHA256_BATCH_S(x, 18) ^ ((x) >> 3))
+#define SHA256_BATCH_G1(x) \
+    (SHA256_BATCH_S(x, 17) ^ SHA256_BATCH_S(x, 19) ^ ((x) >> 10))
+
+#if !defined(SHA256_BATCH_AVX2) && !defined(SHA256_BATCH_AVX512)
+/* Compress one block for each of the C kernel's lanes. Only used when there
+ * are no vector kernels, the assembly single stream transforms are faster
+ * than it on x86_64.
+ *
+ * The lane loop is innermost so that compilers can vectorize it.
+ *
+ * @param [in, out] s  Transposed state: s[j * stride + lane].
+ * @param [in]      w  Transposed message block: w[j * stride + lane].
+ */
+static void Sha256Batch_Transform_C(word32* s, const word32* w)
+{
+    word32 v[8][SHA256_BATCH_C_LANES];
+    word32 x[16][SHA256_BATCH_C_LANES];
+    int i;
+    int j;
+    int l;
+
+    for (j = 0; j < 8; j++) {
+        for (l = 0; l < SHA256_BATCH_C_LANES; l++) {
+            v[j][l] = s[j * SHA256_BATCH_STRIDE + l];
+        }
+    }
+    for (j = 0; j < 16; j++) {
+        for (l = 0; l < SHA256_BATCH_C_LANES; l++) {
+            x[j][l] = w[j * SHA256_BATCH_STRIDE + l];
+        }
+    }
+
+    for (i = 0; i < 64; i++) {
+        for (l = 0; l < SHA256_BATCH_C_LANES; l++) {
+            word32 t1;
+            word32 t2;
+
+            if (i >= 16) {
+                x[i & 15][l] += SHA256_BATCH_G1(x[(i - 2) & 15][l]) +
+                    x[(i - 7) & 15][l] + SHA256_BATCH_G0(x[(i - 15) & 15][l]);
+            }
+            t1 = v[7][l] + SHA256_BATCH_S1(v[4][l]) +
+                 Ch(v[4][l], v[5][l], v[6][l]) + K[i] + x[i & 15][l];
+            t2 = SHA256_BATCH_S0(v[0][l]) + Maj(v[0][l], v[1][l], v[2][l]);
+            v[7][l] = v[6][l];
+            v[6][l] = v[5][l];
+            v[5][l] = v[4][l];
+            v[4][l] = v[3][l] + t1;
+            v[3][l] = v[2][l];
+            v[2][l] = v[1][l];
+            v[1][l] = v[0][l];
+            v[0][l] = t1 + t2;
+        }
+    }
+
+    for (j = 0; j < 8; j++) {
+        for (l = 0; l < SHA256_BATCH_C_LANES; l++) {
+            s[j * SHA256_BATCH_STRIDE + l] += v[j][l];
+        }
+    }
+}
+#endif /* !SHA256_BATCH_AVX2 && !SHA256_BATCH_AVX512 */
+
+#ifdef SHA256_BATCH_AVX2
+#define SHA256_BATCH_ROR256(x, n)                                              \
+    _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+/* Compress one block for each of eight lanes with AVX2.
+ *
+ * @param [in, out] s  Transposed state: s[j * stride + lane].
+ * @param [in]      w  Transposed message block: w[j * stride + lane].
+ */
+static SHA256_BATCH_AVX2_TARGET void Sha256Batch_Transform_AVX2(word32* s,
+    const word32* w)
+{
+    __m256i v[8];
+    __m256i x[16];
+    __m256i t1;
+    __m256i t2;
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        v[i] = _mm256_loadu_si256((const __m256i*)&s[i * SHA256_BATCH_STRIDE]);
+    }
+    for (i = 0; i < 16; i++) {
+        x[i] = _mm256_loadu_si256((const __m256i*)&w[i * SHA256_BATCH_STRIDE]);
+    }
+
+    for (i = 0; i < 64; i++) {
+        if (i >= 16) {
+            __m256i x2 = x[(i - 2) & 15];
+            __m256i x15 = x[(i - 15) & 15];
+
+            t1 = _mm256_xor_si256(_mm256_xor_si256(SHA256_BATCH_ROR256(x2, 17),
+                SHA256_BATCH_ROR256(x2, 19)), _mm256_srli_epi32(x2, 10));
+            t2 = _mm256_xor_si256(_mm256_xor_si256(SHA256_BATCH_ROR256(x15, 7),
+                SHA256_BATCH_ROR256(x15, 18)), _mm256_srli_epi32(x15, 3));
+            x[i & 15] = _mm256_add_epi32(_mm256_add_epi32(x[i & 15], t1),
+                _mm256_add_epi32(x[(i - 7) & 15], t2));
+        }
+        /* t1 = h + S1(e) + Ch(e,f,g) + K[i] + W[i] */
+        t1 = _mm256_xor_si256(_mm256_xor_si256(SHA256_BATCH_ROR256(v[4], 6),
+            SHA256_BATCH_ROR256(v[4], 11)), SHA256_BATCH_ROR256(v[4], 25));
+        t1 = _mm256_add_epi32(_mm256_add_epi32(v[7], t1),
+            _mm256_xor_si256(_mm256_and_si256(v[4],
+                _mm256_xor_si256(v[5], v[6])), v[6]));
+        t1 = _mm256_add_epi32(t1, _mm256_add_epi32(
+            _mm256_set1_epi32((int)K[i]), x[i & 15]));
+        /* t2 = S0(a) + Maj(a,b,c) */
+        t2 = _mm256_xor_si256(_mm256_xor_si256(SHA256_BATCH_ROR256(v[0], 2),
+            SHA256_BATCH_ROR256(v[0], 13)), SHA256_BATCH_ROR256(v[0], 22));
+        t2 = _mm256_add_epi32(t2, _mm256_or_si256(_mm256_and_si256(v[0], v[1]),
+            _mm256_and_si256(v[2], _mm256_or_si256(v[0], v[1]))));
+        v[7] = v[6];
+        v[6] = v[5];
+        v[5] = v[4];
+        v[4] = _mm256_add_epi32(v[3], t1);
+        v[3] = v[2];
+        v[2] = v[1];
+        v[1] = v[0];
+        v[0] = _mm256_add_epi32(t1, t2);
+    }
+
+    for (i = 0; i < 8; i++) {
+        __m256i* p = (__m256i*)&s[i * SHA256_BATCH_STRIDE];
+        _mm256_storeu_si256(p, _mm256_add_epi32(_mm256_loadu_si256(p), v[i]));
+    }
+    /* Clean upper state so following SSE code doesn't stall. */
+    _mm256_zeroupper();
+}
+#endif /* SHA256_BATCH_AVX2 */
+
+#ifdef SHA256_BATCH_AVX512
+/* Compress one block for each of sixteen lanes with AVX-512.
+ *
+ * @param [in, out] s  Transposed state: s[j * stride + lane].
+ * @param [in]      w  Transposed message block: w[j * stride + lane].
+ */
+static SHA256_BATCH_AVX512_TARGET void Sha256Batch_Transform_AVX512(word32* s,
+    const word32* w)
+{
+    __m512i v[8];
+    __m512i x[16];
+    __m512i t1;
+    __m512i t2;
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        v[i] = _mm512_loadu_si512(&s[i * SHA256_BATCH_STRIDE]);
+    }
+    for (i = 0; i < 16; i++) {
+        x[i] = _mm512_loadu_si512(&w[i * SHA256_BATCH_STRIDE]);
+    }
+
+    for (i = 0; i < 64; i++) {
+        if (i >= 16) {
+            __m512i x2 = x[(i - 2) & 15];
+            __m512i x15 = x[(i - 15) & 15];
+
+            t1 = _mm512_ternarylogic_epi32(_mm512_ror_epi32(x2, 17),
+                _mm512_ror_epi32(x2, 19), _mm512_srli_epi32(x2, 10), 0x96);
+            t2 = _mm512_ternarylogic_epi32(_mm512_ror_epi32(x15, 7),
+                _mm512_ror_epi32(x15, 18), _mm512_srli_epi32(x15, 3), 0x96);
+            x[i & 15] = _mm512_add_epi32(_mm512_add_epi32(x[i & 15], t1),
+                _mm512_add_epi32(x[(i - 7) & 15], t2));
+        }
+        /* t1 = h + S1(e) + Ch(e,f,g) + K[i] + W[i] */
+        t1 = _mm512_ternarylogic_epi32(_mm512_ror_epi32(v[4], 6),
+            _mm512_ror_epi32(v[4], 11), _mm512_ror_epi32(v[4], 25), 0x96);
+        t1 = _mm512_add_epi32(_mm512_add_epi32(v[7], t1),
+            _mm512_ternarylogic_epi32(v[4], v[5], v[6], 0xca));
+        t1 = _mm512_add_epi32(t1, _mm512_add_epi32(
+            _mm512_set1_epi32((int)K[i]), x[i & 15]));
+        /* t2 = S0(a) + Maj(a,b,c) */
+        t2 = _mm512_ternarylogic_epi32(_mm512_ror_epi32(v[0], 2),
+            _mm512_ror_epi32(v[0], 13), _mm512_ror_epi32(v[0], 22), 0x96);
+        t2 = _mm512_add_epi32(t2,
+            _mm512_ternarylogic_epi32(v[0], v[1], v[2], 0xe8));
+        v[7] = v[6];
+        v[6] = v[5];
+        v[5] = v[4];
+        v[4] = _mm512_add_epi32(v[3], t1);
+        v[3] = v[2];
+        v[2] = v[1];
+        v[1] = v[0];
+        v[0] = _mm512_add_epi32(t1, t2);
+    }
+
+    for (i = 0; i < 8; i++) {
+        word32* p = &s[i * SHA256_BATCH_STRIDE];
+        _mm512_storeu_si512(p, _mm512_add_epi32(_mm512_loadu_si512(p), v[i]));
+    }
+    /* Clean upper state so following SSE code doesn't stall. */
+    _mm256_zeroupper();
+}
+#endif /* SHA256_BATCH_AVX512 */
+
+#if defined(SHA256_BATCH_AVX2) || defined(SHA256_BATCH_AVX512)
+static cpuid_flags_atomic_t sha256_batch_flags = WC_CPUID_ATOMIC_INITIALIZER;
+#endif
+
+/* Choose the multi-buffer kernel for this CPU.
+ *
+ * @param [out] lanes  Number of lanes the kernel computes.
+ * @param [out] simd   Whether the kernel uses vector registers.
+ * @return  Kernel to use or NULL when hashing one message at a time is faster.
+ */
+static Sha256BatchTransform Sha256Batch_GetTransform(int* lanes, int* simd)
+{
+#if defined(SHA256_BATCH_AVX2) || defined(SHA256_BATCH_AVX512)
+    cpuid_get_flags_atomic(&sha256_batch_flags);
+
+    *simd = 1;
+    #ifdef SHA256_BATCH_AVX512
+    if (IS_INTEL_AVX512(sha256_batch_flags)) {
+        *lanes = 16;
+        return Sha256Batch_Transform_AVX512;
+    }
+    #endif
+    /* A single stream with the SHA extensions outruns eight AVX2 lanes. */
+    if (IS_INTEL_AVX2(sha256_batch_flags) &&
+            !IS_INTEL_SHA(sha256_batch_flags)) {
+        *lanes = 8;
+        return Sha256Batch_Transform_AVX2;
+    }
+    /* The assembly single stream transforms beat the C kernel. */
+    *simd = 0;
+    *lanes = 1;
+    return NULL;
+#else
+    *simd = 0;
+    *lanes = SHA256_BATCH_C_LANES;
+    return Sha256Batch_Transform_C;
+#endif
+}
+
+/* Put a big-endian message block into a lane of the transposed schedule.
+ *
+ * @param [out] w     Transposed message block.
+ * @param [in]  lane  Lane to fill.
+ * @param [in]  blk   64-byte message block.
+ */
+static WC_INLINE void Sha256Batch_LoadBlock(word32* w, int lane,
+    const byte* blk)
+{
+    int j;
+
+    for (j = 0; j < 16; j++) {
+        ato32(blk + j * 4, &w[j * SHA256_BATCH_STRIDE + lane]);
+    }
+}
+
+/* Hash up to one kernel's worth of messages.
+ *
+ * @param [in]  transform  Multi-buffer kernel.
+ * @param [in]  lanes      Number of lanes the kernel computes.
+ * @param [in]  prefix     Block hashed before each message. May be NULL.
+ * @param [in]  data       Messages.
+ * @param [in]  len        Length of each message in bytes.
+ * @param [out] hash       Buffer for each digest.
+ * @param [in]  cnt        Number of messages. At most lanes.
+ * @param [in]  s          Transposed state.
+ * @param [in]  w          Transposed message block.
+ * @param [in]  tail       Two blocks per lane for the padded message end.
+ */
+static void Sha256Batch_Lanes(Sha256BatchTransform transform, int lanes,
+    const byte* prefix, const byte* const* data, const word32* len,
+    byte* const* hash, int cnt, word32* s, word32* w, byte* tail)
+{
+    static const word32 iv[8] = {
+        0x6A09E667L, 0xBB67AE85L, 0x3C6EF372L, 0xA54FF53AL,
+        0x510E527FL, 0x9B05688CL, 0x1F83D9ABL, 0x5BE0CD19L
+    };
+    word32 full[WC_SHA256_BATCH_LANES];
+    word32 blocks[WC_SHA256_BATCH_LANES];
+    word32 maxBlocks = 0;
+    word32 b;
+    int j;
+    int l;
+
+    for (l = 0; l < cnt; l++) {
+        byte* t = tail + l * 2 * WC_SHA256_BLOCK_SIZE;
+        word32 rem = len[l] & (WC_SHA256_BLOCK_SIZE - 1);
+        word32 tailSz = (rem < WC_SHA256_PAD_SIZE) ? WC_SHA256_BLOCK_SIZE :
+                                                     2 * WC_SHA256_BLOCK_SIZE;
+        word32 hi;
+        word32 lo;
+
+        full[l] = len[l] / WC_SHA256_BLOCK_SIZE;
+        blocks[l] = full[l] + tailSz / WC_SHA256_BLOCK_SIZE;
+        if (blocks[l] > maxBlocks) {
+            maxBlocks = blocks[l];
+        }
+
+        /* Last bytes, 0x80, zeros and the length in bits. */
+        XMEMSET(t, 0, tailSz);
+        if (rem > 0) {
+            XMEMCPY(t, data[l] + full[l] * WC_SHA256_BLOCK_SIZE, rem);
+        }
+        t[rem] = 0x80;
+        hi = len[l] >> 29;
+        lo = len[l] << 3;
+        if (prefix != NULL) {
+            /* Block of prefix: 512 bits. */
+            lo += WC_SHA256_BLOCK_SIZE * 8;
+            if (lo < WC_SHA256_BLOCK_SIZE * 8) {
+                hi++;
+            }
+        }
+        c32toa(hi, t + tailSz - 8);
+        c32toa(lo, t + tailSz - 4);
+    }
+
+    for (j = 0; j < 8; j++) {
+        for (l = 0; l < lanes; l++) {
+            s[j * SHA256_BATCH_STRIDE + l] = iv[j];
+        }
+    }
+    if (prefix != NULL) {
+        for (l = 0; l < lanes; l++) {
+            Sha256Batch_LoadBlock(w, l, prefix);
+        }
+        transform(s, w);
+    }
+
+    for (b = 0; b < maxBlocks; b++) {
+        for (l = 0; l < cnt; l++) {
+            if (b < full[l]) {
+                Sha256Batch_LoadBlock(w, l,
+                    data[l] + b * WC_SHA256_BLOCK_SIZE);
+            }
+            else if (b < blocks[l]) {
+                Sha256Batch_LoadBlock(w, l, tail +
+                    (l * 2 + b - full[l]) * WC_SHA256_BLOCK_SIZE);
+            }
+        }
+        transform(s, w);
+        for (l = 0; l < cnt; l++) {
+            if (b + 1 == blocks[l]) {
+                for (j = 0; j < 8; j++) {
+                    c32toa(s[j * SHA256_BATCH_STRIDE + l], hash[l] + j * 4);
+                }
+            }
+        }
+    }
+}
+
+#endif /* NEED_SOFT_SHA256 */
+
+/* Hash each message, after an optional prefix block, one at a time.
+ *
+ * @param [in]  prefix  Block hashed before each message. May be NULL.
+ * @param [in]  data    Messages.
+ * @param [in]  len     Length of each message in bytes.
+ * @param [out] hash    Buffer for each digest.
+ * @param [in]  cnt     Number of messages.
+ * @return  0 on success.
+ */
+static int Sha256Batch_Serial(const byte* prefix, const byte* const* data,
+    const word32* len, byte* const* hash, word32 cnt)
+{
+    int ret;
+    word32 i;
+    WC_DECLARE_VAR(sha256, wc_Sha256, 1, NULL);
+
+    WC_ALLOC_VAR_EX(sha256, wc_Sha256, 1, NULL, DYNAMIC_TYPE_TMP_BUFFER,
+        return MEMORY_E);
+
+    ret = wc_InitSha256_ex(sha256, NULL, INVALID_DEVID);
+    for (i = 0; (ret == 0) && (i < cnt); i++) {
+        if (prefix != NULL) {
+            ret = wc_Sha256Update(sha256, prefix, WC_SHA256_BLOCK_SIZE);
+        }
+        if (ret == 0) {
+            ret = wc_Sha256Update(sha256, data[i], len[i]);
+        }
+        if (ret == 0) {
+            /* Final re-initializes the object. */
+            ret = wc_Sha256Final(sha256, hash[i]);
+        }
+    }
+    wc_Sha256Free(sha256);
+
+    WC_FREE_VAR_EX(sha256, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    return ret;
+}
+
+/* Hash many independent messages, each after an optional prefix block.
+ *
+ * The prefix is how HMAC hashes the padded key before each message.
+ *
+ * @param [in]  prefix  Block of WC_SHA256_BLOCK_SIZE bytes hashed before each
+ *                      message. May be NULL.
+ * @param [in]  data    Messages. Entry may be NULL when its length is 0.
+ * @param [in]  len     Length of each message in bytes.
+ * @param [out] hash    Buffer of WC_SHA256_DIGEST_SIZE bytes for each digest.
+ * @param [in]  cnt     Number of messages.
+ * @return  0 on success.
+ * @return  BAD_FUNC_ARG when an array or message is NULL.
+ * @return  MEMORY_E when dynamic memory allocation fails.
+ */
+int wc_Sha256HashBatch_ex(const byte* prefix, const byte* const* data,
+    const word32* len, byte* const* hash, word32 cnt)
+{
+    int ret = 0;
+    word32 i;
+#ifdef NEED_SOFT_SHA256
+    Sha256BatchTransform transform;
+    int lanes;
+    int simd;
+    WC_DECLARE_VAR(tail, byte, WC_SHA256_BATCH_LANES * 2 * WC_SHA256_BLOCK_SIZE,
+        NULL);
+    ALIGN64 word32 s[8 * SHA256_BATCH_STRIDE];
+    ALIGN64 word32 w[16 * SHA256_BATCH_STRIDE];
+#endif
+
+    if ((cnt > 0) && ((data == NULL) || (len == NULL) || (hash == NULL))) {
+        return BAD_FUNC_ARG;
+    }
+    for (i = 0; i < cnt; i++) {
+        if (((data[i] == NULL) && (len[i] != 0)) || (hash[i] == NULL)) {
+            return BAD_FUNC_ARG;
+        }
+    }
+    if (cnt == 0) {
+        return 0;
+    }
+
+#ifdef NEED_SOFT_SHA256
+    transform = Sha256Batch_GetTransform(&lanes, &simd);
+    /* A single message gains nothing from the lanes. */
+    if ((transform == NULL) || (cnt == 1)) {
+        return Sha256Batch_Serial(prefix, data, len, hash, cnt);
+    }
+
+    WC_ALLOC_VAR_EX(tail, byte,
+        WC_SHA256_BATCH_LANES * 2 * WC_SHA256_BLOCK_SIZE, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER, return MEMORY_E);
+    XMEMSET(s, 0, sizeof(s));
+    XMEMSET(w, 0, sizeof(w));
+
+    if (simd) {
+        ret = SAVE_VECTOR_REGISTERS2();
+    }
+    if (ret == 0) {
+        for (i = 0; i < cnt; i += (word32)lanes) {
+            int n = ((cnt - i) < (word32)lanes) ? (int)(cnt - i) : lanes;
+
+            Sha256Batch_Lanes(transform, lanes, prefix, data + i, len + i,
+                hash + i, n, s, w, tail);
+        }
+        if (simd) {
+            RESTORE_VECTOR_REGISTERS();
+        }
+    }
+    else {
+        /* Vector registers not available - hash the messages one by one. */
+        ret = Sha256Batch_Serial(prefix, data, len, hash, cnt);
+    }
+
+    /* Message and state may be derived from a key. */
+    ForceZero(s, sizeof(s));
+    ForceZero(w, sizeof(w));
+    ForceZero(tail, WC_SHA256_BATCH_LANES * 2 * WC_SHA256_BLOCK_SIZE);
+    WC_FREE_VAR_EX(tail, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+#else
+    ret = Sha256Batch_Serial(prefix, data, len, hash, cnt);
+#endif
+
+    return ret;
+}
+
+/* Hash many independent messages with SHA-256.
+ *
+ * Messages are hashed in parallel across SIMD lanes where the CPU supports
+ * it. Messages of similar length make best use of the lanes.
+ *
+ * @param [in]  data  Messages. Entry may be NULL when its length is 0.
+ * @param [in]  len   Length of each message in bytes.
+ * @param [out] hash  Buffer of WC_SHA256_DIGEST_SIZE bytes for each digest.
+ * @param [in]  cnt   Number of messages.
+ * @return  0 on success.
+ * @return  BAD_FUNC_ARG when an array or message is NULL.
+ * @return  MEMORY_E when dynamic memory allocation fails.
+ */
+int wc_Sha256HashBatch(const byte* const* data, const word32* len,
+    byte* const* hash, word32 cnt)
+{
+    return wc_Sha256HashBatch_ex(NULL, data, len, hash, cnt);
+}
+
+#endif /* WOLFSSL_SHA2_BATCH */
+
 #endif /* NO_SHA256 */
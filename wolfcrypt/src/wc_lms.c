@@ -108,7 +108,7 @@
  * @param [in, out] state   LMS state.
  * @param [in]      params  LMS parameters.
  */
-static int wc_lmskey_state_init(LmsState* state, const LmsParams* params)
+int wc_lmskey_state_init(LmsState* state, const LmsParams* params)
 {
     int ret;
 
@@ -147,7 +147,7 @@ static int wc_lmskey_state_init(LmsState* state, const LmsParams* params)
  *
  * @param [in] state  LMS state.
  */
-static void wc_lmskey_state_free(LmsState* state)
+void wc_lmskey_state_free(LmsState* state)
 {
 #ifdef WOLFSSL_LMS_SHAKE256
     if (LMS_IS_SHAKE(state->params->lmOtsType)) {
@@ -1133,6 +1133,42 @@ int wc_LmsKey_SetContext(LmsKey* key, void* context)
     return ret;
 }
 
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+/* Sets the number of threads used to compute the leaf nodes of the trees.
+ *
+ * Used when making a key and when reloading a key. The calling thread does a
+ * share of the work so a value of 1 computes everything on the calling thread.
+ * The keys and signatures are the same whatever the number of threads.
+ *
+ * @param [in, out] key      LMS key.
+ * @param [in]      threads  Number of threads to use.
+ * @return  0 on success.
+ * @return  BAD_FUNC_ARG when key is NULL or threads is out of range.
+ * @return  BAD_STATE_E when key state is invalid.
+ */
+int wc_LmsKey_SetThreads(LmsKey* key, int threads)
+{
+    int ret = 0;
+
+    /* Validate parameters. */
+    if ((key == NULL) || (threads < 1) || (threads > WC_LMS_MAX_THREADS)) {
+        ret = BAD_FUNC_ARG;
+    }
+    /* Tree caches are already built for a working key. */
+    if ((ret == 0) && (key->state == WC_LMS_STATE_OK)) {
+        WOLFSSL_MSG("error: wc_LmsKey_SetThreads: key in use");
+        ret = BAD_STATE_E;
+    }
+
+    if (ret == 0) {
+        /* Set the thread count into the key. */
+        key->threads = (word8)threads;
+    }
+
+    return ret;
+}
+#endif /* WOLFSSL_LMS_XMSS_THREADS */
+
 /* Make the LMS private/public key pair. The key must have its parameters
  * set before calling this.
  *
@@ -1227,6 +1263,9 @@ int wc_LmsKey_MakeKey(LmsKey* key, WC_RNG* rng)
             /* Initialize working state for use. */
             ret = wc_lmskey_state_init(state, key->params);
             if (ret == 0) {
+            #ifdef WOLFSSL_LMS_XMSS_THREADS
+                state->threads = key->threads;
+            #endif
                 /* Make the HSS key. */
                 ret = wc_hss_make_key(state, rng, key->priv_raw, &key->priv,
                     key->priv_data, key->pub);
@@ -1377,6 +1416,9 @@ int wc_LmsKey_Reload(LmsKey* key)
             /* Initialize working state for use. */
             ret = wc_lmskey_state_init(state, key->params);
             if (ret == 0) {
+            #ifdef WOLFSSL_LMS_XMSS_THREADS
+                state->threads = key->threads;
+            #endif
                 /* Reload the key ready for signing. */
                 ret = wc_hss_reload_key(state, key->priv_raw, &key->priv,
                     key->priv_data, NULL);
@@ -32,6 +32,9 @@
  *   Enable when using hardware SHA-256.
  * WOLFSSL_LMS_VERIFY_ONLY                               Default: OFF
  *   Only compiles in verification code.
+ * WOLFSSL_LMS_XMSS_THREADS                              Default: OFF
+ *   Computes leaf nodes on multiple threads when making and reloading a key.
+ *   Number of threads set with wc_LmsKey_SetThreads().
  * WOLFSSL_WC_LMS_SMALL                                  Default: OFF
  *   Implementation is smaller code size with slow signing.
  *   Enable when memory is limited.
@@ -2022,6 +2025,248 @@ static int wc_lms_interior_hash(LmsState* state, byte* sp, word32 r,
     return ret;
 }
 
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+/* Number of leaf nodes computed by each thread in one batch. */
+#ifndef WC_LMS_THREAD_LEAVES
+    #define WC_LMS_THREAD_LEAVES    64
+#endif
+
+/* Work for one thread computing a contiguous range of leaf nodes. */
+typedef struct LmsLeafWork {
+    /* LMS state to compute with - own buffer and hash objects. */
+    LmsState* state;
+    /* Private seed to generate x. */
+    const byte* seed;
+    /* Index of first leaf to compute. */
+    word32 idx;
+    /* Number of leaves to compute. */
+    word32 cnt;
+    /* Buffer to hold leaf node hashes. */
+    byte* leaves;
+    /* Thread computing the leaves. */
+    THREAD_TYPE thread;
+    /* Result of computing leaves. */
+    int ret;
+} LmsLeafWork;
+
+/* Batch of leaf node hashes computed ahead by multiple threads. */
+typedef struct LmsLeafBatch {
+    /* Leaf node hashes. */
+    byte* leaves;
+    /* Index of first leaf node in batch. */
+    word32 idx;
+    /* Number of leaf nodes in batch. */
+    word32 cnt;
+    /* Number of threads to use - 0 when not batching. */
+    word32 threads;
+    /* States for the extra threads. */
+    LmsState* states;
+    /* Work for each thread. */
+    LmsLeafWork* work;
+} LmsLeafBatch;
+
+/* Compute a range of leaf node hashes.
+ *
+ * @param [in, out] work  Work of thread.
+ */
+static void wc_lms_leaf_work(LmsLeafWork* work)
+{
+    const LmsParams* params = work->state->params;
+    word32 max_h = (word32)1 << params->height;
+    word32 k;
+
+    work->ret = 0;
+    for (k = 0; (work->ret == 0) && (k < work->cnt); k++) {
+        word32 i = work->idx + k;
+        work->ret = wc_lms_leaf_hash(work->state, work->seed, i, i + max_h,
+            work->leaves + k * params->hash_len);
+    }
+}
+
+/* Thread function computing a range of leaf node hashes.
+ *
+ * @param [in, out] arg  Work of thread.
+ * @return  0 always.
+ */
+static THREAD_RETURN WOLFSSL_THREAD wc_lms_leaf_thread(void* arg)
+{
+    wc_lms_leaf_work((LmsLeafWork*)arg);
+    WOLFSSL_RETURN_FROM_THREAD(0);
+}
+
+/* Initialize a batch of leaf node computations.
+ *
+ * Batching only happens when there are enough leaves to compute for the number
+ * of threads. When not batching, leaves are computed on demand by the caller.
+ * Any failure to set up leaves the batch disabled.
+ *
+ * @param [in, out] state  LMS state. I must be in buffer.
+ * @param [out]     batch  Leaf batch.
+ * @param [in]      cnt    Number of leaves to be computed.
+ */
+static void wc_lms_leaf_batch_init(LmsState* state, LmsLeafBatch* batch,
+    word32 cnt)
+{
+    word32 threads = state->threads;
+    word32 t;
+
+    XMEMSET(batch, 0, sizeof(*batch));
+
+    if ((threads > 1) && (cnt >= 2 * threads)) {
+        batch->leaves = (byte*)XMALLOC((size_t)threads * WC_LMS_THREAD_LEAVES *
+            state->params->hash_len, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        batch->states = (LmsState*)XMALLOC((threads - 1) * sizeof(LmsState),
+            NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        batch->work = (LmsLeafWork*)XMALLOC(threads * sizeof(LmsLeafWork),
+            NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        if ((batch->leaves != NULL) && (batch->states != NULL) &&
+                (batch->work != NULL)) {
+            for (t = 0; t < threads - 1; t++) {
+                if (wc_lmskey_state_init(&batch->states[t], state->params) !=
+                        0) {
+                    break;
+                }
+                /* Each state has the same I at the start of its buffer. */
+                XMEMCPY(batch->states[t].buffer, state->buffer, LMS_I_LEN);
+            }
+            batch->threads = t + 1;
+        }
+        if (batch->threads < 2) {
+            XFREE(batch->work, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+            XFREE(batch->states, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+            XFREE(batch->leaves, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+            XMEMSET(batch, 0, sizeof(*batch));
+        }
+    }
+}
+
+/* Free a batch of leaf node computations.
+ *
+ * @param [in, out] batch  Leaf batch.
+ */
+static void wc_lms_leaf_batch_free(LmsLeafBatch* batch)
+{
+    word32 t;
+
+    if (batch->threads > 0) {
+        for (t = 0; t < batch->threads - 1; t++) {
+            wc_lmskey_state_free(&batch->states[t]);
+        }
+        /* Buffers hold private data. */
+        ForceZero(batch->states, (batch->threads - 1) * sizeof(LmsState));
+        XFREE(batch->work, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(batch->states, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(batch->leaves, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    }
+}
+
+/* Compute the next batch of leaf nodes using multiple threads.
+ *
+ * The leaves are shared out evenly. The calling thread computes the first
+ * share with its own state. If a thread can't be started then its share is
+ * computed on the calling thread.
+ *
+ * @param [in, out] state  LMS state.
+ * @param [in, out] batch  Leaf batch.
+ * @param [in]      seed   Private seed to generate x.
+ * @param [in]      i      Index of first leaf to compute.
+ * @param [in]      end    Index after last leaf to compute.
+ * @return  0 on success.
+ */
+static int wc_lms_leaf_batch_fill(LmsState* state, LmsLeafBatch* batch,
+    const byte* seed, word32 i, word32 end)
+{
+    int ret = 0;
+    word32 hLen = state->params->hash_len;
+    word32 cnt = end - i;
+    word32 share;
+    word32 off = 0;
+    word32 t;
+
+    if (cnt > batch->threads * WC_LMS_THREAD_LEAVES) {
+        cnt = batch->threads * WC_LMS_THREAD_LEAVES;
+    }
+    share = (cnt + batch->threads - 1) / batch->threads;
+
+    for (t = 0; t < batch->threads; t++) {
+        LmsLeafWork* work = &batch->work[t];
+
+        work->state = (t == 0) ? state : &batch->states[t - 1];
+        work->seed = seed;
+        work->idx = i + off;
+        work->cnt = (cnt - off < share) ? (cnt - off) : share;
+        work->leaves = batch->leaves + off * hLen;
+        work->ret = 0;
+        off += work->cnt;
+    }
+    for (t = 1; t < batch->threads; t++) {
+        LmsLeafWork* work = &batch->work[t];
+
+        if ((work->cnt > 0) && (wolfSSL_NewThread(&work->thread,
+                wc_lms_leaf_thread, work) != 0)) {
+            /* Compute share on this thread instead. */
+            wc_lms_leaf_work(work);
+            work->cnt = 0;
+        }
+    }
+    wc_lms_leaf_work(&batch->work[0]);
+    for (t = 0; t < batch->threads; t++) {
+        LmsLeafWork* work = &batch->work[t];
+
+        if ((t > 0) && (work->cnt > 0) &&
+                (wolfSSL_JoinThread(work->thread) != 0) && (ret == 0)) {
+            ret = BAD_STATE_E;
+        }
+        if (ret == 0) {
+            ret = work->ret;
+        }
+    }
+
+    if (ret == 0) {
+        batch->idx = i;
+        batch->cnt = cnt;
+    }
+    else {
+        batch->cnt = 0;
+    }
+    return ret;
+}
+
+/* Get a leaf node hash - from the batch or by computing it.
+ *
+ * The caller's buffer is overwritten when computing a batch.
+ *
+ * @param [in, out] state  LMS state.
+ * @param [in, out] batch  Leaf batch.
+ * @param [in]      seed   Private seed to generate x.
+ * @param [in]      i      Index of leaf.
+ * @param [in]      end    Index after last leaf that will be wanted.
+ * @param [out]     leaf   Leaf node hash.
+ * @return  0 on success.
+ */
+static int wc_lms_leaf_get(LmsState* state, LmsLeafBatch* batch,
+    const byte* seed, word32 i, word32 end, byte* leaf)
+{
+    int ret = 0;
+    word32 hLen = state->params->hash_len;
+
+    if (batch->threads == 0) {
+        ret = wc_lms_leaf_hash(state, seed, i,
+            i + ((word32)1 << state->params->height), leaf);
+    }
+    else {
+        if ((i < batch->idx) || (i >= batch->idx + batch->cnt)) {
+            ret = wc_lms_leaf_batch_fill(state, batch, seed, i, end);
+        }
+        if (ret == 0) {
+            XMEMCPY(leaf, batch->leaves + (i - batch->idx) * hLen, hLen);
+        }
+    }
+
+    return ret;
+}
+#endif /* WOLFSSL_LMS_XMSS_THREADS */
+
 #ifdef WOLFSSL_WC_LMS_SMALL
 /* Computes hash of the Merkle tree and gets the authentication path for q.
  *
@@ -2064,9 +2309,15 @@ static int wc_lms_treehash(LmsState* state, const byte* id, const byte* seed,
     WC_DECLARE_VAR(stack, byte, (LMS_MAX_HEIGHT + 1) * LMS_MAX_NODE_LEN, 0);
     byte* sp;
     word32 i;
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    LmsLeafBatch batch;
+#endif
 
     /* I || ... */
     XMEMCPY(buffer, id, LMS_I_LEN);
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    wc_lms_leaf_batch_init(state, &batch, (word32)1 << params->height);
+#endif
 
     /* Allocate stack of left side hashes. */
     WC_ALLOC_VAR_EX(stack, byte,
@@ -2083,7 +2334,12 @@ static int wc_lms_treehash(LmsState* state, const byte* id, const byte* seed,
         word32 r = i + ((word32)1 << (params->height));
 
         /* Calculate leaf node hash. */
+    #ifdef WOLFSSL_LMS_XMSS_THREADS
+        ret = wc_lms_leaf_get(state, &batch, seed, i,
+            (word32)1 << params->height, temp);
+    #else
         ret = wc_lms_leaf_hash(state, seed, i, r, temp);
+    #endif
 
         /* Store the node if on the authentication path. */
         if ((ret == 0) && (auth_path != NULL) && ((q ^ 0x1) == i)) {
@@ -2120,6 +2376,9 @@ static int wc_lms_treehash(LmsState* state, const byte* id, const byte* seed,
         /* Public key, root node, is top of data stack. */
         XMEMCPY(pub, stack, params->hash_len);
     }
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    wc_lms_leaf_batch_free(&batch);
+#endif
     WC_FREE_VAR_EX(stack, NULL, DYNAMIC_TYPE_TMP_BUFFER);
     return ret;
 }
@@ -2196,6 +2455,9 @@ static int wc_lms_treehash_init(LmsState* state, LmsPrivState* privState,
     word32 i;
     word32 max_h = (word32)1 << params->height;
     word32 max_cb = (word32)1 << params->cacheBits;
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    LmsLeafBatch batch;
+#endif
 
     privState->stack.offset = 0;
     /* Reset the cached stack. */
@@ -2207,6 +2469,9 @@ static int wc_lms_treehash_init(LmsState* state, LmsPrivState* privState,
 
     /* I || ... */
     XMEMCPY(buffer, id, LMS_I_LEN);
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    wc_lms_leaf_batch_init(state, &batch, max_h);
+#endif
 
     /* Allocate stack of left side hashes. */
     WC_ALLOC_VAR_EX(stack, byte,
@@ -2222,7 +2487,11 @@ static int wc_lms_treehash_init(LmsState* state, LmsPrivState* privState,
         word32 r = i + max_h;
 
         /* Calculate leaf node hash. */
+    #ifdef WOLFSSL_LMS_XMSS_THREADS
+        ret = wc_lms_leaf_get(state, &batch, seed, i, max_h, temp);
+    #else
         ret = wc_lms_leaf_hash(state, seed, i, r, temp);
+    #endif
 
         /* Cache leaf node if in range. */
         if ((ret == 0) && (i >= leaf->idx) && (i < leaf->idx + max_cb)) {
@@ -2274,6 +2543,9 @@ static int wc_lms_treehash_init(LmsState* state, LmsPrivState* privState,
         }
     }
 
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    wc_lms_leaf_batch_free(&batch);
+#endif
     WC_FREE_VAR_EX(stack, NULL, DYNAMIC_TYPE_TMP_BUFFER);
     return ret;
 }
@@ -2323,9 +2595,15 @@ static int wc_lms_treehash_update(LmsState* state, LmsPrivState* privState,
     byte* sp;
     word32 max_cb = (word32)1 << params->cacheBits;
     word32 i;
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    LmsLeafBatch batch;
+#endif
 
     /* I || ... */
     XMEMCPY(buffer, id, LMS_I_LEN);
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    wc_lms_leaf_batch_init(state, &batch, max_idx - min_idx + 1);
+#endif
 
     /* Allocate stack of left side hashes. */
     WC_ALLOC_VAR_EX(stack, byte,
@@ -2356,7 +2634,16 @@ static int wc_lms_treehash_update(LmsState* state, LmsPrivState* privState,
         }
         else {
             /* Calculate leaf node hash. */
+        #ifdef WOLFSSL_LMS_XMSS_THREADS
+            /* Don't compute ahead into the cached leaves. */
+            word32 end = max_idx + 1;
+            if ((i < leaf->idx) && (leaf->idx < end)) {
+                end = leaf->idx;
+            }
+            ret = wc_lms_leaf_get(state, &batch, seed, i, end, temp);
+        #else
             ret = wc_lms_leaf_hash(state, seed, i, r, temp);
+        #endif
 
             /* Slide the leaf cache forward by one slot when i is exactly the
              * leaf immediately past the cached window and still within the
@@ -2449,6 +2736,9 @@ static int wc_lms_treehash_update(LmsState* state, LmsPrivState* privState,
         }
     }
 
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    wc_lms_leaf_batch_free(&batch);
+#endif
     WC_FREE_VAR_EX(stack, NULL, DYNAMIC_TYPE_TMP_BUFFER);
     return ret;
 }
@@ -1426,6 +1426,203 @@ static int wc_mlkemkey_check_h(MlKemKey* key)
 }
 #endif
 
+#if defined(WOLFSSL_MLKEM_BATCH) && (!defined(WOLFSSL_MLKEM_NO_ENCAPSULATE) || \
+    !defined(WOLFSSL_MLKEM_NO_DECAPSULATE))
+#if !defined(WOLFSSL_MLKEM_ENCAPSULATE_SMALL_MEM) && !defined(WOLFSSL_NO_MALLOC)
+/* Encrypt messages to cipher texts with the encryption keys of many keys.
+ *
+ * Same as mlkemkey_encapsulate() but generates the noise and matrices of all
+ * the keys together so the Keccak work can be spread over SIMD lanes.
+ *
+ * @param  [in]  key  ML-KEM key objects. All of the same ML-KEM type.
+ * @param  [in]  m    Random bytes - one per key.
+ * @param  [in]  r    Seeds to feed to PRF when generating y, e1 and e2.
+ * @param  [out] c    Calculated cipher texts.
+ * @param  [in]  cnt  Number of keys. At most WC_ML_KEM_BATCH_SZ.
+ * @return  0 on success.
+ * @return  NOT_COMPILED_IN when key type is not supported.
+ * @return  MEMORY_E when dynamic memory allocation failed.
+ */
+static int mlkemkey_encapsulate_batch(MlKemKey** key, const byte** m,
+    byte** r, byte** c, int cnt)
+{
+    int ret = 0;
+    int i;
+    int n = 0;
+    unsigned int k = 0;
+    unsigned int compVecSz = 0;
+    size_t sz = 0;
+    sword16* buf = NULL;
+    sword16* y[WC_ML_KEM_BATCH_SZ];
+    sword16* a[WC_ML_KEM_BATCH_SZ];
+    sword16* mu[WC_ML_KEM_BATCH_SZ];
+    sword16* e1[WC_ML_KEM_BATCH_SZ];
+    sword16* e2[WC_ML_KEM_BATCH_SZ];
+    sword16* gen[WC_ML_KEM_BATCH_SZ];
+    byte* seed[WC_ML_KEM_BATCH_SZ];
+
+    /* Establish parameters based on key type. */
+    switch (key[0]->type) {
+#ifdef WOLFSSL_WC_ML_KEM_512
+    case WC_ML_KEM_512:
+        k = WC_ML_KEM_512_K;
+        compVecSz = WC_ML_KEM_512_POLY_VEC_COMPRESSED_SZ;
+        break;
+#endif
+#ifdef WOLFSSL_WC_ML_KEM_768
+    case WC_ML_KEM_768:
+        k = WC_ML_KEM_768_K;
+        compVecSz = WC_ML_KEM_768_POLY_VEC_COMPRESSED_SZ;
+        break;
+#endif
+#ifdef WOLFSSL_WC_ML_KEM_1024
+    case WC_ML_KEM_1024:
+        k = WC_ML_KEM_1024_K;
+        compVecSz = WC_ML_KEM_1024_POLY_VEC_COMPRESSED_SZ;
+        break;
+#endif
+    default:
+        /* No other values supported. */
+        ret = NOT_COMPILED_IN;
+        break;
+    }
+
+    if (ret == 0) {
+        /* Same layout as mlkemkey_encapsulate() for each key.
+         * y (b) | a (m) | mu (p) | e1 (p) | e2 (v) | u (v) | v (p) */
+        sz = ((k + 3) * k + 3) * MLKEM_N;
+        buf = (sword16*)XMALLOC(sz * (size_t)cnt * sizeof(sword16),
+            key[0]->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        if (buf == NULL) {
+            ret = MEMORY_E;
+        }
+    }
+    if (ret == 0) {
+        for (i = 0; i < cnt; i++) {
+            y[i]  = buf + sz * (size_t)i;
+            a[i]  = y[i]  + MLKEM_N * k;
+            mu[i] = a[i]  + MLKEM_N * k * k;
+            e1[i] = mu[i] + MLKEM_N;
+            e2[i] = e1[i] + MLKEM_N * k;
+
+            /* Step 20: mu <- Decompress_1(ByteDecode_1(m)) */
+            mlkem_from_msg(mu[i], m[i]);
+        }
+
+        /* Steps 9-17: generate y, e_1, e_2 for all keys. */
+        ret = mlkem_get_noise_batch(&key[0]->prf, (int)k, y, e1, e2, r, cnt);
+    }
+    if (ret == 0) {
+        for (i = 0; i < cnt; i++) {
+        #ifdef WOLFSSL_MLKEM_CACHE_A
+            if ((key[i]->flags & MLKEM_FLAG_A_SET) != 0) {
+                unsigned int ri;
+                unsigned int ci;
+                /* Transpose matrix.
+                 *   Steps 4-8: generate matrix A_hat (from original) */
+                for (ri = 0; ri < k; ri++) {
+                    for (ci = 0; ci < k; ci++) {
+                        XMEMCPY(&a[i][(ri * k + ci) * MLKEM_N],
+                                &key[i]->a[(ci * k + ri) * MLKEM_N],
+                                MLKEM_N * 2);
+                    }
+                }
+                continue;
+            }
+        #endif
+            gen[n] = a[i];
+            seed[n] = key[i]->pubSeed;
+            n++;
+        }
+        if (n > 0) {
+            /* Steps 4-8: generate the transposed matrices A_hat. */
+            ret = mlkem_gen_matrix_batch(&key[0]->prf, gen, (int)k, seed, n,
+                1);
+        }
+    }
+    for (i = 0; (ret == 0) && (i < cnt); i++) {
+        sword16* u = e2[i] + MLKEM_N;
+        sword16* v = u + MLKEM_N * k;
+        byte* c1 = c[i];
+        byte* c2 = c[i] + compVecSz;
+
+        /* Steps 18-19, 21: calculate u and v */
+        mlkem_encapsulate(key[i]->pub, u, v, a[i], y[i], e1[i], e2[i], mu[i],
+            (int)k);
+
+    #if defined(WOLFSSL_WC_ML_KEM_512) || defined(WOLFSSL_WC_ML_KEM_768)
+        if (k != WC_ML_KEM_1024_K) {
+            /* Step 22: c_1 <- ByteEncode_d_u(Compress_d_u(u)) */
+            mlkem_vec_compress_10(c1, u, k);
+            /* Step 23: c_2 <- ByteEncode_d_v(Compress_d_v(v)) */
+            mlkem_compress_4(c2, v);
+        }
+    #endif
+    #ifdef WOLFSSL_WC_ML_KEM_1024
+        if (k == WC_ML_KEM_1024_K) {
+            /* Step 22: c_1 <- ByteEncode_d_u(Compress_d_u(u)) */
+            mlkem_vec_compress_11(c1, u);
+            /* Step 23: c_2 <- ByteEncode_d_v(Compress_d_v(v)) */
+            mlkem_compress_5(c2, v);
+        }
+    #endif
+    }
+
+    if (buf != NULL) {
+        /* Noise and message polynomials are secret. */
+        ForceZero(buf, sz * (size_t)cnt * sizeof(sword16));
+        XFREE(buf, key[0]->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    }
+
+    return ret;
+}
+#endif /* !WOLFSSL_MLKEM_ENCAPSULATE_SMALL_MEM && !WOLFSSL_NO_MALLOC */
+
+/* Number of keys, from the start, that can be worked on together.
+ *
+ * Keys must be ML-KEM (not Kyber), of the same type and not on a device.
+ *
+ * @param  [in]  key  ML-KEM key objects.
+ * @param  [in]  cnt  Number of keys.
+ * @return  Number of keys to work on together - at least 1.
+ */
+static int mlkem_batch_run(MlKemKey** key, int cnt)
+{
+    int n = 1;
+
+#if !defined(WOLFSSL_MLKEM_ENCAPSULATE_SMALL_MEM) && !defined(WOLFSSL_NO_MALLOC)
+    if (cnt > WC_ML_KEM_BATCH_SZ) {
+        cnt = WC_ML_KEM_BATCH_SZ;
+    }
+    for (; n < cnt; n++) {
+        if (key[n]->type != key[0]->type) {
+            break;
+        }
+    #ifdef WOLF_CRYPTO_CB
+        if (key[n]->devId != INVALID_DEVID) {
+            break;
+        }
+    #endif
+    }
+    #ifdef WOLF_CRYPTO_CB
+    if (key[0]->devId != INVALID_DEVID) {
+        n = 1;
+    }
+    #endif
+    #ifdef WOLFSSL_MLKEM_KYBER
+    if ((key[0]->type & MLKEM_KYBER) != 0) {
+        n = 1;
+    }
+    #endif
+#else
+    (void)key;
+    (void)cnt;
+#endif
+
+    return n;
+}
+#endif /* WOLFSSL_MLKEM_BATCH */
+
 #ifndef WOLFSSL_MLKEM_NO_ENCAPSULATE
 /**
  * Encapsulate with random number generator and derive secret.
@@ -1724,6 +1921,144 @@ int wc_MlKemKey_EncapsulateWithRandom(MlKemKey* key, unsigned char* ct,
 
     return ret;
 }
+#ifdef WOLFSSL_MLKEM_BATCH
+/**
+ * Encapsulate with random data and derive secrets for many keys.
+ *
+ * Same as calling wc_MlKemKey_EncapsulateWithRandom() for each key. Runs of up
+ * to WC_ML_KEM_BATCH_SZ keys of the same ML-KEM type are worked on together:
+ * the matrix and noise generation of all of them is spread over the x4
+ * (AVX2) or x8 (AVX-512) Keccak lanes.
+ *
+ * @param  [in]   key   ML-KEM key objects.
+ * @param  [out]  ct    Cipher texts - one per key.
+ * @param  [out]  ss    Shared secrets generated - one per key.
+ * @param  [in]   rand  Random bytes - WC_ML_KEM_ENC_RAND_SZ bytes per key.
+ * @param  [in]   cnt   Number of keys.
+ * @return  0 on success.
+ * @return  BAD_FUNC_ARG when key, ct, ss, rand or one of their entries is
+ *          NULL or cnt is negative.
+ * @return  BAD_STATE_E when a public key is not set.
+ * @return  NOT_COMPILED_IN when a key type is not supported.
+ * @return  MEMORY_E when dynamic memory allocation failed.
+ */
+int wc_MlKemKey_EncapsulateBatchWithRandom(MlKemKey** key, unsigned char** ct,
+    unsigned char** ss, const unsigned char** rand, int cnt)
+{
+    int ret = 0;
+    int i;
+    int j;
+    int n;
+    byte kr[WC_ML_KEM_BATCH_SZ][2 * WC_ML_KEM_SYM_SZ + 1];
+    byte* r[WC_ML_KEM_BATCH_SZ];
+
+    /* Validate parameters. */
+    if ((key == NULL) || (ct == NULL) || (ss == NULL) || (rand == NULL) ||
+            (cnt < 0)) {
+        ret = BAD_FUNC_ARG;
+    }
+    for (i = 0; (ret == 0) && (i < cnt); i++) {
+        if ((key[i] == NULL) || (ct[i] == NULL) || (ss[i] == NULL) ||
+                (rand[i] == NULL)) {
+            ret = BAD_FUNC_ARG;
+        }
+        /* Check the public key has been set. */
+        else if ((key[i]->flags & MLKEM_FLAG_PUB_SET) == 0) {
+            ret = BAD_STATE_E;
+        }
+    }
+
+    for (i = 0; (ret == 0) && (i < cnt); i += n) {
+        n = mlkem_batch_run(key + i, cnt - i);
+        if (n == 1) {
+            ret = wc_MlKemKey_EncapsulateWithRandom(key[i], ct[i], ss[i],
+                rand[i], WC_ML_KEM_ENC_RAND_SZ);
+            continue;
+        }
+
+    #if !defined(WOLFSSL_MLKEM_ENCAPSULATE_SMALL_MEM) && \
+        !defined(WOLFSSL_NO_MALLOC)
+        for (j = 0; (ret == 0) && (j < n); j++) {
+            ret = wc_mlkemkey_check_h(key[i + j]);
+            if (ret == 0) {
+                /* Step 1: (K,r) <- G(m||H(ek)) */
+                ret = MLKEM_HASH_G(&key[i + j]->hash, rand[i + j],
+                    WC_ML_KEM_SYM_SZ, key[i + j]->h, WC_ML_KEM_SYM_SZ, kr[j]);
+            }
+            r[j] = kr[j] + WC_ML_KEM_SYM_SZ;
+        }
+        if (ret == 0) {
+            /* Step 2: c <- K-PKE.Encrypt(ek,m,r) */
+            ret = mlkemkey_encapsulate_batch(key + i, rand + i, r, ct + i, n);
+        }
+        for (j = 0; (ret == 0) && (j < n); j++) {
+            /* return (K,c) */
+            XMEMCPY(ss[i + j], kr[j], WC_ML_KEM_SS_SZ);
+        }
+    #endif
+    }
+
+    ForceZero(kr, sizeof(kr));
+    (void)j;
+    (void)r;
+
+    return ret;
+}
+
+#ifndef WC_NO_RNG
+/**
+ * Encapsulate with random number generator and derive secrets for many keys.
+ *
+ * Same as calling wc_MlKemKey_Encapsulate() for each key. See
+ * wc_MlKemKey_EncapsulateBatchWithRandom().
+ *
+ * @param  [in]   key  ML-KEM key objects.
+ * @param  [out]  ct   Cipher texts - one per key.
+ * @param  [out]  ss   Shared secrets generated - one per key.
+ * @param  [in]   rng  Random number generator.
+ * @param  [in]   cnt  Number of keys.
+ * @return  0 on success.
+ * @return  BAD_FUNC_ARG when key, ct, ss, rng or an entry is NULL or cnt is
+ *          negative.
+ * @return  BAD_STATE_E when a public key is not set.
+ * @return  NOT_COMPILED_IN when a key type is not supported.
+ * @return  MEMORY_E when dynamic memory allocation failed.
+ */
+int wc_MlKemKey_EncapsulateBatch(MlKemKey** key, unsigned char** ct,
+    unsigned char** ss, WC_RNG* rng, int cnt)
+{
+    int ret = 0;
+    int i;
+    int j;
+    int n = 0;
+    byte m[WC_ML_KEM_BATCH_SZ][WC_ML_KEM_ENC_RAND_SZ];
+    const byte* rand[WC_ML_KEM_BATCH_SZ];
+
+    if ((key == NULL) || (ct == NULL) || (ss == NULL) || (rng == NULL) ||
+            (cnt < 0)) {
+        ret = BAD_FUNC_ARG;
+    }
+
+    for (i = 0; (ret == 0) && (i < cnt); i += n) {
+        n = (cnt - i < WC_ML_KEM_BATCH_SZ) ? (cnt - i) : WC_ML_KEM_BATCH_SZ;
+        /* Step 1: m is 32 random bytes for each key. */
+        ret = wc_RNG_GenerateBlock(rng, m[0], (word32)(n * (int)sizeof(m[0])));
+        for (j = 0; j < n; j++) {
+            rand[j] = m[j];
+        }
+        if (ret == 0) {
+            ret = wc_MlKemKey_EncapsulateBatchWithRandom(key + i, ct + i,
+                ss + i, rand, n);
+        }
+    }
+
+    /* The shared secrets are derived from m. */
+    ForceZero(m, sizeof(m));
+
+    return ret;
+}
+#endif /* !WC_NO_RNG */
+#endif /* WOLFSSL_MLKEM_BATCH */
 #endif /* !WOLFSSL_MLKEM_NO_ENCAPSULATE */
 
 /******************************************************************************/
@@ -2122,6 +2457,139 @@ int wc_MlKemKey_Decapsulate(MlKemKey* key, unsigned char* ss,
 
     return ret;
 }
+#ifdef WOLFSSL_MLKEM_BATCH
+/**
+ * Decapsulate the cipher texts to calculate the shared secrets of many keys.
+ *
+ * Same as calling wc_MlKemKey_Decapsulate() for each key. Runs of up to
+ * WC_ML_KEM_BATCH_SZ keys of the same ML-KEM type are worked on together: the
+ * re-encryption of all of them generates the matrices and noise across the
+ * x4 (AVX2) or x8 (AVX-512) Keccak lanes.
+ *
+ * @param  [in]   key  ML-KEM key objects.
+ * @param  [out]  ss   Shared secrets - one per key.
+ * @param  [in]   ct   Cipher texts - one per key.
+ * @param  [in]   len  Lengths of cipher texts - one per key.
+ * @param  [in]   cnt  Number of keys.
+ * @return  0 on success.
+ * @return  BAD_FUNC_ARG when key, ss, ct, len or an entry is NULL or cnt is
+ *          negative.
+ * @return  BAD_STATE_E when a private key is not set.
+ * @return  NOT_COMPILED_IN when a key type is not supported.
+ * @return  BUFFER_E when a length is not the length of cipher text for the key
+ *          type.
+ * @return  MEMORY_E when dynamic memory allocation failed.
+ */
+int wc_MlKemKey_DecapsulateBatch(MlKemKey** key, unsigned char** ss,
+    const unsigned char** ct, const word32* len, int cnt)
+{
+    int ret = 0;
+    int i;
+    int j;
+    int n;
+    word32 ctSz = 0;
+    byte msg[WC_ML_KEM_BATCH_SZ][WC_ML_KEM_SYM_SZ];
+    byte kr[WC_ML_KEM_BATCH_SZ][2 * WC_ML_KEM_SYM_SZ + 1];
+    const byte* m[WC_ML_KEM_BATCH_SZ];
+    byte* r[WC_ML_KEM_BATCH_SZ];
+    byte* c[WC_ML_KEM_BATCH_SZ];
+    byte* cmp = NULL;
+    void* heap = NULL;
+
+    /* Validate parameters. */
+    if ((key == NULL) || (ss == NULL) || (ct == NULL) || (len == NULL) ||
+            (cnt < 0)) {
+        ret = BAD_FUNC_ARG;
+    }
+    for (i = 0; (ret == 0) && (i < cnt); i++) {
+        if ((key[i] == NULL) || (ss[i] == NULL) || (ct[i] == NULL)) {
+            ret = BAD_FUNC_ARG;
+        }
+        else if ((key[i]->flags & MLKEM_FLAG_PRIV_SET) == 0) {
+            ret = BAD_STATE_E;
+        }
+    }
+
+    for (i = 0; (ret == 0) && (i < cnt); i += n) {
+        n = mlkem_batch_run(key + i, cnt - i);
+        if (n == 1) {
+            ret = wc_MlKemKey_Decapsulate(key[i], ss[i], ct[i], len[i]);
+            continue;
+        }
+
+    #if !defined(WOLFSSL_MLKEM_ENCAPSULATE_SMALL_MEM) && \
+        !defined(WOLFSSL_NO_MALLOC)
+        ret = wc_MlKemKey_CipherTextSize(key[i], &ctSz);
+        for (j = 0; (ret == 0) && (j < n); j++) {
+            /* Ensure the cipher text passed in is the correct size. */
+            if (len[i + j] != ctSz) {
+                ret = BUFFER_E;
+            }
+        }
+        if ((ret == 0) && (cmp == NULL)) {
+            /* Allocate memory for cipher texts that are generated. */
+            heap = key[i]->heap;
+            cmp = (byte*)XMALLOC(WC_ML_KEM_MAX_CIPHER_TEXT_SIZE *
+                WC_ML_KEM_BATCH_SZ, heap, DYNAMIC_TYPE_TMP_BUFFER);
+            if (cmp == NULL) {
+                ret = MEMORY_E;
+            }
+        }
+        for (j = 0; (ret == 0) && (j < n); j++) {
+            /* Step 5: m' <- K-PKE.Decrypt(dk_PKE, c) */
+            ret = mlkemkey_decapsulate(key[i + j], msg[j], ct[i + j]);
+            if (ret == 0) {
+                ret = wc_mlkemkey_check_h(key[i + j]);
+            }
+            if (ret == 0) {
+                /* Step 6: (K', r') <- G(m'||h) */
+                ret = MLKEM_HASH_G(&key[i + j]->hash, msg[j], WC_ML_KEM_SYM_SZ,
+                    key[i + j]->h, WC_ML_KEM_SYM_SZ, kr[j]);
+            }
+            m[j] = msg[j];
+            r[j] = kr[j] + WC_ML_KEM_SYM_SZ;
+            c[j] = cmp + ctSz * (word32)j;
+        }
+        if (ret == 0) {
+            /* Step 8: c' <- K-PKE.Encrypt(ek_PKE, m', r') */
+            ret = mlkemkey_encapsulate_batch(key + i, m, r, c, n);
+        }
+        for (j = 0; (ret == 0) && (j < n); j++) {
+            unsigned int k;
+            /* Step 9: compare generated cipher text with that passed in. */
+            int fail = mlkem_cmp(ct[i + j], c[j], (int)ctSz);
+
+            /* Step 7: K_bar <- J(z||c) */
+            ret = mlkem_derive_secret(&key[i + j]->prf, key[i + j]->z,
+                ct[i + j], ctSz, msg[j]);
+            if (ret == 0) {
+                /* Steps 10-12: K' or K_bar on comparison failure. */
+                for (k = 0; k < WC_ML_KEM_SYM_SZ; k++) {
+                    ss[i + j][k] = (byte)(kr[j][k] ^
+                        ((kr[j][k] ^ msg[j][k]) & fail));
+                }
+            }
+        }
+    #endif
+    }
+
+    if (cmp != NULL) {
+        /* Re-encrypted cipher texts are computed from secret messages. */
+        ForceZero(cmp, WC_ML_KEM_MAX_CIPHER_TEXT_SIZE * WC_ML_KEM_BATCH_SZ);
+        XFREE(cmp, heap, DYNAMIC_TYPE_TMP_BUFFER);
+    }
+    ForceZero(msg, sizeof(msg));
+    ForceZero(kr, sizeof(kr));
+    (void)j;
+    (void)m;
+    (void)r;
+    (void)c;
+    (void)heap;
+    (void)ctSz;
+
+    return ret;
+}
+#endif /* WOLFSSL_MLKEM_BATCH */
 #endif /* WOLFSSL_MLKEM_NO_DECAPSULATE */
 
 /******************************************************************************/
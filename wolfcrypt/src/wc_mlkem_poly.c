@@ -5591,6 +5591,419 @@ int mlkem_get_noise(MLKEM_PRF_T* prf, int k, sword16* vec1, sword16* vec2,
     return ret;
 }
 
+#ifdef WOLFSSL_MLKEM_BATCH
+#if defined(USE_INTEL_SPEEDUP) && !defined(WC_SHA3_NO_ASM)
+/* Most Keccak lanes permuted at once when working across keys. */
+#define MLKEM_BATCH_MAX_LANES   8
+/* Bytes of XOF/PRF output kept per lane - largest of matrix and ETA3. */
+#define MLKEM_BATCH_LANE_SZ     (GEN_MATRIX_SIZE + 8)
+
+/* A polynomial to sample from one Keccak lane. */
+typedef struct MlKemBatchJob {
+    /* Seed to absorb (rho for matrix, r/sigma for noise). */
+    const byte* seed;
+    /* Polynomial to write. */
+    sword16* p;
+    /* Bytes absorbed after seed, with the SHAKE domain padding. */
+    word64 tail;
+    /* Noise width for PRF jobs. */
+    int eta;
+} MlKemBatchJob;
+
+/* Number of Keccak lanes to use across keys.
+ *
+ * @return  8 when AVX-512 is available, 4 with AVX2, otherwise 0.
+ */
+static int mlkem_batch_lanes(void)
+{
+#ifdef WOLFSSL_MLKEM_HAVE_INTEL_AVX512
+    if (USE_INTEL_AVX512(cpuid_flags)) {
+        return 8;
+    }
+#endif
+    if (IS_INTEL_AVX2(cpuid_flags)) {
+        return 4;
+    }
+    return 0;
+}
+
+/* Permute all lanes of the interleaved Keccak state.
+ *
+ * @param  [in, out]  state  Interleaved states - word i of lane l at
+ *                           state[i * lanes + l].
+ * @param  [in]       lanes  Number of lanes: 4 or 8.
+ */
+static void mlkem_batch_permute(word64* state, int lanes)
+{
+#ifdef WOLFSSL_MLKEM_HAVE_INTEL_AVX512
+    if (lanes == 8) {
+        sha3_blocksx8_avx512(state);
+        return;
+    }
+#endif
+    (void)lanes;
+    sha3_blocksx4_avx2(state);
+}
+
+/* Load a job's seed, trailing bytes and padding into one lane and permute.
+ *
+ * @param  [out]  state  Interleaved Keccak states.
+ * @param  [in]   lanes  Number of lanes.
+ * @param  [in]   job    Jobs - one per lane.
+ * @param  [in]   rate   Rate of the XOF/PRF in 64-bit words.
+ */
+static void mlkem_batch_absorb(word64* state, int lanes,
+    const MlKemBatchJob* job, int rate)
+{
+    int i;
+    int l;
+    word64 w[WC_ML_KEM_SYM_SZ / 8];
+
+    XMEMSET(state, 0, sizeof(word64) * 25 * (size_t)lanes);
+    for (l = 0; l < lanes; l++) {
+        readUnalignedWords64(w, job[l].seed, WC_ML_KEM_SYM_SZ / 8);
+        for (i = 0; i < WC_ML_KEM_SYM_SZ / 8; i++) {
+            state[i * lanes + l] = w[i];
+        }
+        state[4 * lanes + l] = job[l].tail;
+        state[(rate - 1) * lanes + l] = W64LIT(0x8000000000000000);
+    }
+    mlkem_batch_permute(state, lanes);
+}
+
+/* Copy words out of each lane of the interleaved Keccak state.
+ *
+ * @param  [in]   state  Interleaved Keccak states.
+ * @param  [in]   lanes  Number of lanes.
+ * @param  [out]  rand   Output buffer - lane l at rand + l * stride.
+ * @param  [in]   stride Number of bytes between lane outputs.
+ * @param  [in]   words  Number of words to copy from each lane.
+ */
+static void mlkem_batch_squeeze(const word64* state, int lanes, byte* rand,
+    int stride, int words)
+{
+    int i;
+    int l;
+
+    for (l = 0; l < lanes; l++) {
+        for (i = 0; i < words; i++) {
+            XMEMCPY(rand + l * stride + i * 8, &state[i * lanes + l], 8);
+        }
+    }
+}
+
+/* Generate matrix polynomials for many keys, one polynomial per lane.
+ *
+ * @param  [in]  job    Matrix jobs.
+ * @param  [in]  cnt    Number of jobs.
+ * @param  [in]  lanes  Number of lanes.
+ * @return  0 on success.
+ * @return  MEMORY_E when dynamic memory allocation fails.
+ */
+static int mlkem_gen_matrix_lanes(MlKemBatchJob* job, int cnt, int lanes)
+{
+    int j;
+    int l;
+    int n;
+    unsigned int ctr[MLKEM_BATCH_MAX_LANES];
+    MlKemBatchJob grp[MLKEM_BATCH_MAX_LANES];
+    WC_DECLARE_VAR(state, word64, 25 * MLKEM_BATCH_MAX_LANES, 0);
+    WC_DECLARE_VAR(rand, byte, MLKEM_BATCH_MAX_LANES * MLKEM_BATCH_LANE_SZ, 0);
+
+    WC_ALLOC_VAR_EX(state, word64, 25 * MLKEM_BATCH_MAX_LANES, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER, return MEMORY_E);
+    WC_ALLOC_VAR_EX(rand, byte, MLKEM_BATCH_MAX_LANES * MLKEM_BATCH_LANE_SZ,
+        NULL, DYNAMIC_TYPE_TMP_BUFFER,
+        WC_FREE_VAR_EX(state, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        return MEMORY_E);
+
+    /* Rejection sampling loads 64 bits at a time and only uses 48. */
+    for (l = 0; l < lanes; l++) {
+        XMEMSET(rand + l * MLKEM_BATCH_LANE_SZ + GEN_MATRIX_SIZE, 0xff,
+            MLKEM_BATCH_LANE_SZ - GEN_MATRIX_SIZE);
+    }
+
+    for (j = 0; j < cnt; j += lanes) {
+        int more;
+
+        /* Unused lanes repeat the first job and are discarded. */
+        n = (cnt - j < lanes) ? (cnt - j) : lanes;
+        for (l = 0; l < lanes; l++) {
+            grp[l] = job[j + ((l < n) ? l : 0)];
+        }
+
+        mlkem_batch_absorb(state, lanes, grp, WC_SHA3_128_COUNT);
+        for (l = 0; l < GEN_MATRIX_SIZE; l += SHA3_128_BYTES) {
+            if (l != 0) {
+                mlkem_batch_permute(state, lanes);
+            }
+            mlkem_batch_squeeze(state, lanes, rand + l, MLKEM_BATCH_LANE_SZ,
+                WC_SHA3_128_COUNT);
+        }
+        more = 0;
+        for (l = 0; l < n; l++) {
+            ctr[l] = mlkem_rej_uniform_n_ins(grp[l].p, MLKEM_N,
+                rand + l * MLKEM_BATCH_LANE_SZ, GEN_MATRIX_SIZE);
+            more |= (ctr[l] < MLKEM_N);
+        }
+        /* Create more blocks if too many rejected. */
+        while (more) {
+            mlkem_batch_permute(state, lanes);
+            mlkem_batch_squeeze(state, lanes, rand, MLKEM_BATCH_LANE_SZ,
+                WC_SHA3_128_COUNT);
+            more = 0;
+            for (l = 0; l < n; l++) {
+                if (ctr[l] < MLKEM_N) {
+                    ctr[l] += mlkem_rej_uniform_ins(grp[l].p + ctr[l],
+                        MLKEM_N - ctr[l], rand + l * MLKEM_BATCH_LANE_SZ,
+                        XOF_BLOCK_SIZE);
+                    more |= (ctr[l] < MLKEM_N);
+                }
+            }
+        }
+    }
+
+    WC_FREE_VAR_EX(rand, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    WC_FREE_VAR_EX(state, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    return 0;
+}
+
+/* Generate noise polynomials for many keys, one polynomial per lane.
+ *
+ * All jobs must have the same eta.
+ *
+ * @param  [in]  job    Noise jobs.
+ * @param  [in]  cnt    Number of jobs.
+ * @param  [in]  lanes  Number of lanes.
+ * @return  0 on success.
+ * @return  MEMORY_E when dynamic memory allocation fails.
+ */
+static int mlkem_get_noise_lanes(MlKemBatchJob* job, int cnt, int lanes)
+{
+    int j;
+    int l;
+    int n;
+    MlKemBatchJob grp[MLKEM_BATCH_MAX_LANES];
+    WC_DECLARE_VAR(state, word64, 25 * MLKEM_BATCH_MAX_LANES, 0);
+    WC_DECLARE_VAR(rand, byte, MLKEM_BATCH_MAX_LANES * PRF_RAND_SZ, 0);
+
+    WC_ALLOC_VAR_EX(state, word64, 25 * MLKEM_BATCH_MAX_LANES, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER, return MEMORY_E);
+    WC_ALLOC_VAR_EX(rand, byte, MLKEM_BATCH_MAX_LANES * PRF_RAND_SZ, NULL,
+        DYNAMIC_TYPE_TMP_BUFFER,
+        WC_FREE_VAR_EX(state, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        return MEMORY_E);
+
+    for (j = 0; j < cnt; j += lanes) {
+        n = (cnt - j < lanes) ? (cnt - j) : lanes;
+        for (l = 0; l < lanes; l++) {
+            grp[l] = job[j + ((l < n) ? l : 0)];
+        }
+
+        mlkem_batch_absorb(state, lanes, grp, WC_SHA3_256_COUNT);
+        mlkem_batch_squeeze(state, lanes, rand, PRF_RAND_SZ,
+            WC_SHA3_256_COUNT);
+        if (grp[0].eta == MLKEM_CBD_ETA3) {
+            /* ETA3 needs more than one block of output. */
+            mlkem_batch_permute(state, lanes);
+            mlkem_batch_squeeze(state, lanes, rand + SHA3_256_BYTES,
+                PRF_RAND_SZ, WC_SHA3_256_COUNT);
+        }
+        for (l = 0; l < n; l++) {
+            if (grp[l].eta == MLKEM_CBD_ETA3) {
+                mlkem_cbd_eta3_ins(grp[l].p, rand + l * PRF_RAND_SZ);
+            }
+            else {
+                mlkem_cbd_eta2_ins(grp[l].p, rand + l * PRF_RAND_SZ);
+            }
+        }
+    }
+
+    /* state and rand are secret-seeded. */
+    ForceZero(rand, MLKEM_BATCH_MAX_LANES * PRF_RAND_SZ);
+    ForceZero(state, sizeof(word64) * 25 * MLKEM_BATCH_MAX_LANES);
+    WC_FREE_VAR_EX(rand, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    WC_FREE_VAR_EX(state, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+    return 0;
+}
+#endif /* USE_INTEL_SPEEDUP && !WC_SHA3_NO_ASM */
+
+/* Deterministically generate the matrices (or transposes) of many keys.
+ *
+ * With AVX2 or AVX-512 the XOFs of all the keys are spread over 4 or 8 Keccak
+ * lanes, so no lane is idle until the last group. Otherwise each matrix is
+ * generated on its own.
+ *
+ * @param  [in]  prf         XOF object used when not working across lanes.
+ * @param  [out] a           Matrices of uniform integers - one per key.
+ * @param  [in]  k           Number of dimensions. k x k polynomials.
+ * @param  [in]  seed        Bytes to seed XOF generation - one per key.
+ * @param  [in]  cnt         Number of keys. At most WC_ML_KEM_BATCH_SZ.
+ * @param  [in]  transposed  Whether A or A^T is generated.
+ * @return  0 on success.
+ * @return  MEMORY_E when dynamic memory allocation fails.
+ */
+int mlkem_gen_matrix_batch(MLKEM_PRF_T* prf, sword16** a, int k,
+    byte** seed, int cnt, int transposed)
+{
+    int ret = 0;
+    int i;
+
+#if defined(USE_INTEL_SPEEDUP) && !defined(WC_SHA3_NO_ASM)
+    int lanes = mlkem_batch_lanes();
+
+    if ((lanes > 0) && (cnt > 1) && (SAVE_VECTOR_REGISTERS2() == 0)) {
+        MlKemBatchJob* job;
+        int r;
+        int c;
+        int n = 0;
+
+        job = (MlKemBatchJob*)XMALLOC(sizeof(MlKemBatchJob) * (size_t)cnt *
+            (size_t)(k * k), NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        if (job == NULL) {
+            ret = MEMORY_E;
+        }
+        for (i = 0; (ret == 0) && (i < cnt); i++) {
+            for (r = 0; r < k; r++) {
+                for (c = 0; c < k; c++) {
+                    job[n].seed = seed[i];
+                    job[n].p = a[i] + (r * k + c) * MLKEM_N;
+                    /* XOF(rho || j || i) with SHAKE128 domain padding. */
+                    if (!transposed) {
+                        job[n].tail = (word64)(0x1f0000 + (r << 8) + c);
+                    }
+                    else {
+                        job[n].tail = (word64)(0x1f0000 + (c << 8) + r);
+                    }
+                    job[n].eta = 0;
+                    n++;
+                }
+            }
+        }
+        if (ret == 0) {
+            ret = mlkem_gen_matrix_lanes(job, n, lanes);
+        }
+        RESTORE_VECTOR_REGISTERS();
+        XFREE(job, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        return ret;
+    }
+#endif
+
+    for (i = 0; (ret == 0) && (i < cnt); i++) {
+        ret = mlkem_gen_matrix(prf, a[i], k, seed[i], transposed);
+    }
+
+    return ret;
+}
+
+/* Get the noise/error of many keys by calculating random bytes and sampling
+ * to a binomial distribution.
+ *
+ * With AVX2 or AVX-512 the PRF calls of all the keys are spread over 4 or 8
+ * Keccak lanes. Otherwise the noise of each key is generated on its own.
+ *
+ * @param  [in, out]  prf   PRF object used when not working across lanes.
+ * @param  [in]       k     Number of polynomials in vector.
+ * @param  [out]      vec1  First vector of polynomials - one per key.
+ * @param  [out]      vec2  Second vector of polynomials - one per key.
+ * @param  [out]      poly  Polynomial - one per key.
+ * @param  [in, out]  seed  Seed to use when calculating random - one per key.
+ * @param  [in]       cnt   Number of keys. At most WC_ML_KEM_BATCH_SZ.
+ * @return  0 on success.
+ * @return  MEMORY_E when dynamic memory allocation fails.
+ */
+int mlkem_get_noise_batch(MLKEM_PRF_T* prf, int k, sword16** vec1,
+    sword16** vec2, sword16** poly, byte** seed, int cnt)
+{
+    int ret = 0;
+    int i;
+
+#if defined(USE_INTEL_SPEEDUP) && !defined(WC_SHA3_NO_ASM)
+    int lanes = mlkem_batch_lanes();
+
+    if ((lanes > 0) && (cnt > 1) && (SAVE_VECTOR_REGISTERS2() == 0)) {
+        MlKemBatchJob* job;
+        int eta1 = MLKEM_CBD_ETA2;
+        int j;
+        int n1 = 0;
+        int n2 = 0;
+        int sz = cnt * (2 * k + 1);
+
+    #if defined(WOLFSSL_KYBER512) || defined(WOLFSSL_WC_ML_KEM_512)
+        if (k == WC_ML_KEM_512_K) {
+            eta1 = MLKEM_CBD_ETA3;
+        }
+    #endif
+
+        /* ETA3 jobs from the front, ETA2 jobs from the back. */
+        job = (MlKemBatchJob*)XMALLOC(sizeof(MlKemBatchJob) * (size_t)sz, NULL,
+            DYNAMIC_TYPE_TMP_BUFFER);
+        if (job == NULL) {
+            ret = MEMORY_E;
+        }
+        for (i = 0; (ret == 0) && (i < cnt); i++) {
+            for (j = 0; j < 2 * k + 1; j++) {
+                sword16* p;
+                int eta;
+
+                if (j < k) {
+                    p = vec1[i] + j * MLKEM_N;
+                    eta = eta1;
+                }
+                else if (j < 2 * k) {
+                    if (vec2 == NULL) {
+                        continue;
+                    }
+                    p = vec2[i] + (j - k) * MLKEM_N;
+                    /* Key generation uses eta1 for both vectors. */
+                    eta = (poly == NULL) ? eta1 : MLKEM_CBD_ETA2;
+                }
+                else {
+                    if (poly == NULL) {
+                        continue;
+                    }
+                    p = poly[i];
+                    eta = MLKEM_CBD_ETA2;
+                }
+                if (eta == MLKEM_CBD_ETA3) {
+                    job[n1].p = p;
+                    job[n1].seed = seed[i];
+                    /* PRF(s, N) with SHAKE256 domain padding. */
+                    job[n1].tail = (word64)(0x1f00 + j);
+                    job[n1].eta = eta;
+                    n1++;
+                }
+                else {
+                    n2++;
+                    job[sz - n2].p = p;
+                    job[sz - n2].seed = seed[i];
+                    job[sz - n2].tail = (word64)(0x1f00 + j);
+                    job[sz - n2].eta = eta;
+                }
+            }
+        }
+        if ((ret == 0) && (n1 > 0)) {
+            ret = mlkem_get_noise_lanes(job, n1, lanes);
+        }
+        if ((ret == 0) && (n2 > 0)) {
+            ret = mlkem_get_noise_lanes(job + sz - n2, n2, lanes);
+        }
+        RESTORE_VECTOR_REGISTERS();
+        XFREE(job, NULL, DYNAMIC_TYPE_TMP_BUFFER);
+        return ret;
+    }
+#endif
+
+    for (i = 0; (ret == 0) && (i < cnt); i++) {
+        mlkem_prf_init(prf);
+        ret = mlkem_get_noise(prf, k, vec1[i], (vec2 == NULL) ? NULL : vec2[i],
+            (poly == NULL) ? NULL : poly[i], seed[i]);
+    }
+
+    return ret;
+}
+#endif /* WOLFSSL_MLKEM_BATCH */
+
 #if defined(WOLFSSL_MLKEM_MAKEKEY_SMALL_MEM) || \
     defined(WOLFSSL_MLKEM_ENCAPSULATE_SMALL_MEM)
 /* Get the noise/error by calculating random bytes and sampling to a binomial
@@ -825,6 +825,9 @@ int wolfCrypt_Cleanup(void)
     #ifdef FP_ECC
         wc_ecc_fp_free();
     #endif
+    #ifdef FP_ECC_SHARED
+        wc_ecc_fp_shared_cleanup();
+    #endif
     #ifdef ECC_CACHE_CURVE
         wc_ecc_curve_cache_free();
     #endif
@@ -3068,6 +3071,51 @@ int wolfSSL_HwPkMutexUnLock(void)
             return BAD_MUTEX_E;
     }
 
+    #ifdef WC_HAVE_SHARED_MUTEX
+    #ifdef WC_HAVE_ROBUST_MUTEX
+        #include <errno.h>
+    #endif
+
+    int wc_InitMutexShared(wolfSSL_Mutex* m)
+    {
+        int ret = BAD_MUTEX_E;
+        pthread_mutexattr_t attr;
+
+        if (pthread_mutexattr_init(&attr) != 0)
+            return BAD_MUTEX_E;
+        if (pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED) == 0 &&
+        #ifdef WC_HAVE_ROBUST_MUTEX
+                pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST) == 0 &&
+        #endif
+                pthread_mutex_init(m, &attr) == 0) {
+            ret = 0;
+        }
+        pthread_mutexattr_destroy(&attr);
+
+        return ret;
+    }
+
+    int wc_LockMutexShared(wolfSSL_Mutex* m, int* ownerDied)
+    {
+        int ret = pthread_mutex_lock(m);
+
+        *ownerDied = 0;
+    #ifdef WC_HAVE_ROBUST_MUTEX
+        if (ret == EOWNERDEAD) {
+            /* Locked, but what it protects may be half changed. */
+            *ownerDied = 1;
+            ret = pthread_mutex_consistent(m);
+            if (ret != 0)
+                pthread_mutex_unlock(m);
+        }
+    #endif
+        if (ret == 0)
+            return 0;
+        else
+            return BAD_MUTEX_E;
+    }
+    #endif /* WC_HAVE_SHARED_MUTEX */
+
 
     int wc_FreeMutex(wolfSSL_Mutex* m)
     {
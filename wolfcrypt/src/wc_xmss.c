@@ -132,11 +132,14 @@ static void wc_xmss_digest_free(XmssState* state)
  * @return  NOT_COMPILED_IN when digest algorithm not supported.
  * @return  Other negative when digest algorithm initialization failed.
  */
-static WC_INLINE int wc_xmss_state_init(XmssState* state,
-    const XmssParams* params, void* heap)
+int wc_xmss_state_init(XmssState* state, const XmssParams* params,
+    void* heap)
 {
     state->params = params;
     state->heap = heap;
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    state->threads = 1;
+#endif
     state->ret = 0;
     return wc_xmss_digest_init(state);
 }
@@ -145,7 +148,7 @@ static WC_INLINE int wc_xmss_state_init(XmssState* state,
  *
  * @param [in, out] state  XMSS/MT state including digest and parameters.
  */
-static WC_INLINE void wc_xmss_state_free(XmssState* state)
+void wc_xmss_state_free(XmssState* state)
 {
     wc_xmss_digest_free(state);
 }
@@ -1161,6 +1164,41 @@ int wc_XmssKey_SetContext(XmssKey* key, void* context)
     return ret;
 }
 
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+/* Sets the number of threads used to compute the leaf nodes of the trees.
+ *
+ * Used when making a key. The calling thread does a share of the work so a
+ * value of 1 computes everything on the calling thread.
+ *
+ * @param [in, out] key      The XMSS key.
+ * @param [in]      threads  Number of threads to use.
+ *
+ * @return  0 on success.
+ * @return  BAD_FUNC_ARG when key is NULL or threads is out of range.
+ * @return  BAD_STATE_E when wrong state for operation.
+ */
+int wc_XmssKey_SetThreads(XmssKey* key, int threads)
+{
+    int ret = 0;
+
+    /* Validate parameters. */
+    if ((key == NULL) || (threads < 1) || (threads > WC_XMSS_MAX_THREADS)) {
+        ret = BAD_FUNC_ARG;
+    }
+    /* Tree is already computed for a working key. */
+    else if (key->state == WC_XMSS_STATE_OK) {
+        WOLFSSL_MSG("error: wc_XmssKey_SetThreads: key in use");
+        ret = BAD_STATE_E;
+    }
+    else {
+        /* Set the thread count into the key. */
+        key->threads = (word8)threads;
+    }
+
+    return ret;
+}
+#endif /* WOLFSSL_LMS_XMSS_THREADS */
+
 /* Make the XMSS/XMSS^MT private/public key pair. The key must have its
  * parameters set before calling this.
  *
@@ -1256,6 +1294,11 @@ int wc_XmssKey_MakeKey(XmssKey* key, WC_RNG* rng)
             /* Initialize state for use in key generation. */
             ret = wc_xmss_state_init(state, key->params, key->heap);
             if (ret == 0) {
+            #ifdef WOLFSSL_LMS_XMSS_THREADS
+                if (key->threads > 1) {
+                    state->threads = key->threads;
+                }
+            #endif
                 /* Finally make the private/public key pair. Immediately write
                  * it to NV storage and then clear from memory. */
             #ifndef WOLFSSL_WC_XMSS_SMALL
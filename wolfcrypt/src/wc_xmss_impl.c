@@ -2785,6 +2785,228 @@ static int wc_xmss_bds_state_store(const XmssState* state, byte* sk,
  * BDS
  ********************************************/
 
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+/* Number of leaf nodes computed by each thread in one batch. */
+#ifndef WC_XMSS_THREAD_LEAVES
+    #define WC_XMSS_THREAD_LEAVES   32
+#endif
+
+/* Work for one thread computing a contiguous range of leaf nodes. */
+typedef struct XmssLeafWork {
+    /* XMSS/MT state to compute with - own digest and buffers. */
+    XmssState* state;
+    /* Random secret/private seed. */
+    const byte* sk_seed;
+    /* Random public seed. */
+    const byte* pk_seed;
+    /* Subtree hash address. */
+    const word32* addr;
+    /* Index of first leaf to compute. */
+    word32 idx;
+    /* Number of leaves to compute. */
+    word32 cnt;
+    /* Buffer to hold leaf nodes. */
+    byte* leaves;
+    /* Thread computing the leaves. */
+    THREAD_TYPE thread;
+} XmssLeafWork;
+
+/* Batch of leaf nodes computed ahead by multiple threads. */
+typedef struct XmssLeafBatch {
+    /* Leaf nodes. */
+    byte* leaves;
+    /* Index of first leaf node in batch. */
+    word32 idx;
+    /* Number of leaf nodes in batch. */
+    word32 cnt;
+    /* Number of threads to use - 0 when not batching. */
+    word32 threads;
+    /* States for the extra threads. */
+    XmssState* states;
+    /* Work for each thread. */
+    XmssLeafWork* work;
+} XmssLeafBatch;
+
+/* Compute a range of leaf nodes.
+ *
+ * RFC 8391: 4.1.6, Algorithm 9: treeHash
+ *       ...
+ *       ADRS.setType(0);   # Type = OTS hash address
+ *       ADRS.setOTSAddress(s + i);
+ *       pk = WOTS_genPK (getWOTS_SK(SK, s + i), SEED, ADRS);
+ *       ADRS.setType(1);   # Type = L-tree address
+ *       ADRS.setLTreeAddress(s + i);
+ *       node = ltree(pk, SEED, ADRS);
+ *       ...
+ *
+ * @param [in, out] work  Work of thread.
+ */
+static void wc_xmss_leaf_work(XmssLeafWork* work)
+{
+    XmssState* state = work->state;
+    const word8 n = state->params->n;
+    HashAddress addr;
+    word32 k;
+
+    for (k = 0; (state->ret == 0) && (k < work->cnt); k++) {
+        /* Same hash address as computing leaf in order. */
+        XMSS_ADDR_OTS_SET_SUBTREE(addr, work->addr);
+        addr[XMSS_ADDR_OTS] = work->idx + k;
+        wc_xmss_wots_gen_pk(state, work->sk_seed, work->pk_seed, addr,
+            state->pk);
+        addr[XMSS_ADDR_TYPE] = WC_XMSS_ADDR_TYPE_LTREE;
+        wc_xmss_ltree(state, state->pk, work->pk_seed, addr,
+            work->leaves + k * n);
+    }
+}
+
+/* Thread function computing a range of leaf nodes.
+ *
+ * @param [in, out] arg  Work of thread.
+ * @return  0 always.
+ */
+static THREAD_RETURN WOLFSSL_THREAD wc_xmss_leaf_thread(void* arg)
+{
+    wc_xmss_leaf_work((XmssLeafWork*)arg);
+    WOLFSSL_RETURN_FROM_THREAD(0);
+}
+
+/* Initialize a batch of leaf node computations.
+ *
+ * Batching only happens when there are enough leaves to compute for the number
+ * of threads. When not batching, leaves are computed in order by the caller.
+ * Any failure to set up leaves the batch disabled.
+ *
+ * @param [in]  state  XMSS/MT state including digest and parameters.
+ * @param [out] batch  Leaf batch.
+ * @param [in]  cnt    Number of leaves to be computed.
+ */
+static void wc_xmss_leaf_batch_init(XmssState* state, XmssLeafBatch* batch,
+    word32 cnt)
+{
+    word32 threads = state->threads;
+    word32 t;
+
+    XMEMSET(batch, 0, sizeof(*batch));
+
+    if ((threads > 1) && (cnt >= 2 * threads)) {
+        batch->leaves = (byte*)XMALLOC((size_t)threads *
+            WC_XMSS_THREAD_LEAVES * state->params->n, state->heap,
+            DYNAMIC_TYPE_TMP_BUFFER);
+        batch->states = (XmssState*)XMALLOC((threads - 1) * sizeof(XmssState),
+            state->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        batch->work = (XmssLeafWork*)XMALLOC(threads * sizeof(XmssLeafWork),
+            state->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        if ((batch->leaves != NULL) && (batch->states != NULL) &&
+                (batch->work != NULL)) {
+            for (t = 0; t < threads - 1; t++) {
+                if (wc_xmss_state_init(&batch->states[t], state->params,
+                        state->heap) != 0) {
+                    break;
+                }
+            }
+            batch->threads = t + 1;
+        }
+        if (batch->threads < 2) {
+            XFREE(batch->work, state->heap, DYNAMIC_TYPE_TMP_BUFFER);
+            XFREE(batch->states, state->heap, DYNAMIC_TYPE_TMP_BUFFER);
+            XFREE(batch->leaves, state->heap, DYNAMIC_TYPE_TMP_BUFFER);
+            XMEMSET(batch, 0, sizeof(*batch));
+        }
+    }
+}
+
+/* Free a batch of leaf node computations.
+ *
+ * @param [in]      state  XMSS/MT state including digest and parameters.
+ * @param [in, out] batch  Leaf batch.
+ */
+static void wc_xmss_leaf_batch_free(XmssState* state, XmssLeafBatch* batch)
+{
+    word32 t;
+
+    if (batch->threads > 0) {
+        for (t = 0; t < batch->threads - 1; t++) {
+            wc_xmss_state_free(&batch->states[t]);
+        }
+        /* Buffers hold private data. */
+        ForceZero(batch->states, (batch->threads - 1) * sizeof(XmssState));
+        XFREE(batch->work, state->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(batch->states, state->heap, DYNAMIC_TYPE_TMP_BUFFER);
+        XFREE(batch->leaves, state->heap, DYNAMIC_TYPE_TMP_BUFFER);
+    }
+}
+
+/* Compute the next batch of leaf nodes using multiple threads.
+ *
+ * The leaves are shared out evenly. The calling thread computes the first
+ * share with its own state. If a thread can't be started then its share is
+ * computed on the calling thread.
+ * Errors are stored in state.
+ *
+ * @param [in, out] state    XMSS/MT state including digest and parameters.
+ * @param [in, out] batch    Leaf batch.
+ * @param [in]      sk_seed  Random secret/private seed.
+ * @param [in]      pk_seed  Random public seed.
+ * @param [in]      addr     Subtree hash address.
+ * @param [in]      i        Index of first leaf to compute.
+ * @param [in]      end      Index after last leaf to compute.
+ */
+static void wc_xmss_leaf_batch_fill(XmssState* state, XmssLeafBatch* batch,
+    const byte* sk_seed, const byte* pk_seed, const HashAddress addr,
+    word32 i, word32 end)
+{
+    const word8 n = state->params->n;
+    word32 cnt = end - i;
+    word32 share;
+    word32 off = 0;
+    word32 t;
+
+    if (cnt > batch->threads * WC_XMSS_THREAD_LEAVES) {
+        cnt = batch->threads * WC_XMSS_THREAD_LEAVES;
+    }
+    share = (cnt + batch->threads - 1) / batch->threads;
+
+    for (t = 0; t < batch->threads; t++) {
+        XmssLeafWork* work = &batch->work[t];
+
+        work->state = (t == 0) ? state : &batch->states[t - 1];
+        work->sk_seed = sk_seed;
+        work->pk_seed = pk_seed;
+        work->addr = addr;
+        work->idx = i + off;
+        work->cnt = (cnt - off < share) ? (cnt - off) : share;
+        work->leaves = batch->leaves + off * n;
+        off += work->cnt;
+    }
+    for (t = 1; t < batch->threads; t++) {
+        XmssLeafWork* work = &batch->work[t];
+
+        if ((work->cnt > 0) && (wolfSSL_NewThread(&work->thread,
+                wc_xmss_leaf_thread, work) != 0)) {
+            /* Compute share on this thread instead. */
+            wc_xmss_leaf_work(work);
+            work->cnt = 0;
+        }
+    }
+    wc_xmss_leaf_work(&batch->work[0]);
+    for (t = 1; t < batch->threads; t++) {
+        XmssLeafWork* work = &batch->work[t];
+
+        if ((work->cnt > 0) && (wolfSSL_JoinThread(work->thread) != 0) &&
+                (state->ret == 0)) {
+            state->ret = BAD_STATE_E;
+        }
+        if (state->ret == 0) {
+            state->ret = work->state->ret;
+        }
+    }
+
+    batch->idx = i;
+    batch->cnt = (state->ret == 0) ? cnt : 0;
+}
+#endif /* WOLFSSL_LMS_XMSS_THREADS */
+
 /* Compute node at next index.
  *
  * RFC 8391: 4.1.6, Algorithm 9: treeHash
@@ -2811,11 +3033,12 @@ static int wc_xmss_bds_state_store(const XmssState* state, byte* sk,
  * @param [in]  sk_seed  Random secret/private seed.
  * @param [in]  pk_seed  Random public seed.
  * @param [in]  addr     Hash address.
+ * @param [in]  leaf     Leaf node already computed. May be NULL.
  * @param [out] root     Root node.
  */
 static void wc_xmss_bds_next_idx(XmssState* state, BdsState* bds,
-    const byte* sk_seed, const byte* pk_seed, HashAddress addr, word32 i,
-    word8* height, word8* offset, word8** sp)
+    const byte* sk_seed, const byte* pk_seed, HashAddress addr,
+    const byte* leaf, word32 i, word8* height, word8* offset, word8** sp)
 {
     const XmssParams* params = state->params;
     const word8 hs = params->sub_h;
@@ -2825,13 +3048,19 @@ static void wc_xmss_bds_next_idx(XmssState* state, BdsState* bds,
     word8* node = *sp;
     word8 h;
 
-    /* Calculate WOTS+ public key. */
-    addr[XMSS_ADDR_TYPE] = WC_XMSS_ADDR_TYPE_OTS;
-    addr[XMSS_ADDR_OTS] = (word32)i;
-    wc_xmss_wots_gen_pk(state, sk_seed, pk_seed, addr, state->pk);
-    /* Calculate public value. */
-    addr[XMSS_ADDR_TYPE] = WC_XMSS_ADDR_TYPE_LTREE;
-    wc_xmss_ltree(state, state->pk, pk_seed, addr, node);
+    if (leaf != NULL) {
+        /* Leaf node computed ahead. */
+        XMEMCPY(node, leaf, n);
+    }
+    else {
+        /* Calculate WOTS+ public key. */
+        addr[XMSS_ADDR_TYPE] = WC_XMSS_ADDR_TYPE_OTS;
+        addr[XMSS_ADDR_OTS] = (word32)i;
+        wc_xmss_wots_gen_pk(state, sk_seed, pk_seed, addr, state->pk);
+        /* Calculate public value. */
+        addr[XMSS_ADDR_TYPE] = WC_XMSS_ADDR_TYPE_LTREE;
+        wc_xmss_ltree(state, state->pk, pk_seed, addr, node);
+    }
     addr[XMSS_ADDR_TYPE] = WC_XMSS_ADDR_TYPE_TREE;
     addr[XMSS_ADDR_TREE_ZERO] = 0;
 
@@ -2927,6 +3156,9 @@ static void wc_xmss_bds_treehash_initial(XmssState* state, BdsState* bds,
     word8 offset = 0;
     word32 maxIdx = (word32)1U << params->sub_h;
     word32 i;
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    XmssLeafBatch batch;
+#endif
 
     /* First signing index will be 0 - setup BDS state. */
     bds->offset = 0;
@@ -2941,16 +3173,38 @@ static void wc_xmss_bds_treehash_initial(XmssState* state, BdsState* bds,
     /* Copy hash address into local. */
     XMSS_ADDR_OTS_SET_SUBTREE(addrCopy, addr);
 
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    wc_xmss_leaf_batch_init(state, &batch, maxIdx);
+#endif
+
     /* Compute each node in tree. */
     for (i = 0; i < maxIdx; i++) {
-        wc_xmss_bds_next_idx(state, bds, sk_seed, pk_seed, addrCopy, i, height,
-            &offset, &node);
+        const byte* leaf = NULL;
+
+    #ifdef WOLFSSL_LMS_XMSS_THREADS
+        if (batch.threads > 0) {
+            /* Compute next batch of leaf nodes when needed. */
+            if (i >= batch.idx + batch.cnt) {
+                wc_xmss_leaf_batch_fill(state, &batch, sk_seed, pk_seed, addr,
+                    i, maxIdx);
+            }
+            if (state->ret != 0) {
+                break;
+            }
+            leaf = batch.leaves + (i - batch.idx) * n;
+        }
+    #endif
+        wc_xmss_bds_next_idx(state, bds, sk_seed, pk_seed, addrCopy, leaf, i,
+            height, &offset, &node);
         offset++;
         node += n;
         /* Rest the hash address for reuse. */
         addrCopy[XMSS_ADDR_TREE_HEIGHT] = 0;
         addrCopy[XMSS_ADDR_TREE_INDEX] = 0;
     }
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    wc_xmss_leaf_batch_free(state, &batch);
+#endif
 
     /* Copy the root node. */
     XMEMCPY(root, state->stack, n);
@@ -3149,8 +3403,8 @@ static void wc_xmss_bds_update(XmssState* state, BdsState* bds,
             state->ret = WC_FAILURE;
             return;
         }
-        wc_xmss_bds_next_idx(state, bds, sk_seed, pk_seed, addrCopy, bds->next,
-            bds->height, &bds->offset, &sp);
+        wc_xmss_bds_next_idx(state, bds, sk_seed, pk_seed, addrCopy, NULL,
+            bds->next, bds->height, &bds->offset, &sp);
         bds->offset++;
         bds->next++;
     }
@@ -40,6 +40,9 @@ WOLFSSL_LOCAL void FreeCRL(WOLFSSL_CRL* crl, int dynamic);
 WOLFSSL_LOCAL int  LoadCRL(WOLFSSL_CRL* crl, const char* path, int type,
                            int monitor);
 WOLFSSL_LOCAL int  StoreCRL(WOLFSSL_CRL* crl, const char* file, int type);
+#ifdef HAVE_CRL_MMAP
+WOLFSSL_LOCAL int  LoadMappedCRL(WOLFSSL_CRL* crl, const char* file);
+#endif
 WOLFSSL_LOCAL int  BufferLoadCRL(WOLFSSL_CRL* crl, const byte* buff, long sz,
                                  int type, int verify);
 WOLFSSL_LOCAL int  BufferStoreCRL(WOLFSSL_CRL* crl, byte* buff, long* inOutSz,
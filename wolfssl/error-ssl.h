@@ -253,7 +253,10 @@ enum wolfSSL_ErrorCodes {
     OCSP_NO_URL                  = -522,   /* Cert advertises no OCSP responder
                                             * and no override URL is set */
 
-    WOLFSSL_LAST_E               = -522
+    KTLS_UNAVAILABLE_E           = -523,   /* Kernel TLS offload not available
+                                            * for this socket or cipher suite */
+
+    WOLFSSL_LAST_E               = -523
 
     /* codes -1000 to -1999 are reserved for wolfCrypt. */
 };
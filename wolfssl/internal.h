@@ -2495,8 +2495,56 @@ typedef struct {
     word32 bufferSize;   /* current buffer size */
     byte   dynamicFlag;  /* dynamic memory currently in use */
     byte   offset;       /* alignment offset attempt */
+#ifdef WOLFSSL_IO_BUFFER_POOL
+    byte   poolClass;    /* CTX buffer pool size class + 1, 0 not pooled */
+#endif
 } bufferStatic;
 
+#ifdef WOLFSSL_IO_BUFFER_POOL
+/* Per-CTX pool of dynamic I/O buffers, used while SSL_MODE_RELEASE_BUFFERS is
+ * set. A drained connection hands its input/output buffer back here and the
+ * next read/write takes one out again, so idle connections hold no dynamic
+ * buffers and busy ones do not pay a malloc/free per record. Requests are
+ * rounded up to the smallest size class that fits; larger ones bypass the
+ * pool. The free list is linked through the first bytes of each buffer. */
+#define WOLFSSL_BUFFER_POOL_CLASSES 4
+#ifndef WOLFSSL_BUFFER_POOL_DEPTH
+    #define WOLFSSL_BUFFER_POOL_DEPTH 32  /* max free buffers kept per class */
+#endif
+#ifndef WOLFSSL_BUFFER_POOL_MAX_SZ
+    /* largest class: a full record plus alignment slack */
+    #define WOLFSSL_BUFFER_POOL_MAX_SZ (WOLFSSL_READ_AHEAD_SZ + 64)
+#endif
+
+typedef struct BufferPool {
+    byte*  head[WOLFSSL_BUFFER_POOL_CLASSES];  /* free list per size class */
+    word16 count[WOLFSSL_BUFFER_POOL_CLASSES]; /* free buffers per class */
+#ifndef SINGLE_THREADED
+    wolfSSL_Mutex lock;
+#endif
+    byte   init;
+} BufferPool;
+
+WOLFSSL_LOCAL int  InitBufferPool(BufferPool* pool);
+WOLFSSL_LOCAL void FreeBufferPool(BufferPool* pool, void* heap);
+#endif /* WOLFSSL_IO_BUFFER_POOL */
+
+#ifdef WOLFSSL_TLS_RNG_BANK
+/* Library-wide bank of DRBGs that connections generate from instead of each
+ * instantiating its own WC_RNG. Created by wolfSSL_Init(). A thread prefers
+ * the same instance on every checkout and fails over to the next free one. */
+#ifndef WOLFSSL_TLS_RNG_BANK_SZ
+    #define WOLFSSL_TLS_RNG_BANK_SZ 8  /* DRBG instances in the bank */
+#endif
+#ifndef WOLFSSL_TLS_RNG_BANK_RESEED_CONNS
+    /* connections after which every instance is reseeded, 0 for never */
+    #define WOLFSSL_TLS_RNG_BANK_RESEED_CONNS 65536
+#endif
+
+WOLFSSL_LOCAL int  InitTlsRngBank(void);
+WOLFSSL_LOCAL int  FreeTlsRngBank(void);
+#endif /* WOLFSSL_TLS_RNG_BANK */
+
 /* Cipher Suites holder */
 struct Suites {
     word16 suiteSz;                 /* suite length in bytes        */
@@ -2600,6 +2648,10 @@ struct WOLFSSL_CIPHER {
 
 /* wolfSSL OCSP controller */
 #ifdef HAVE_OCSP
+#ifdef WOLFSSL_OCSP_STAPLE_CACHE
+typedef struct OcspStapleCache OcspStapleCache;
+#endif
+
 struct WOLFSSL_OCSP {
     WOLFSSL_CERT_MANAGER* cm;            /* pointer back to cert manager */
     OcspEntry*            ocspList;      /* OCSP response list */
@@ -2607,6 +2659,9 @@ struct WOLFSSL_OCSP {
     int                   error;
     int(*statusCb)(WOLFSSL*, void*);
     void*                 statusCbArg;
+#ifdef WOLFSSL_OCSP_STAPLE_CACHE
+    OcspStapleCache*      stapleCache;   /* prefetched responses to staple */
+#endif
 };
 #endif
 
@@ -2630,6 +2685,15 @@ typedef struct CRL_Entry CRL_Entry;
         #error CRL_MAX_REVOKED_CERTS too big, max is 22000
     #endif
 #endif
+#ifdef CRL_REVOKED_INDEX
+    #ifndef CRL_REVOKED_INDEX_MIN
+        #define CRL_REVOKED_INDEX_MIN 16
+    #endif
+    typedef struct CRL_RevokedIndex CRL_RevokedIndex;
+#endif
+#ifdef HAVE_CRL_MMAP
+    typedef struct CRL_Map CRL_Map;
+#endif
 
 #ifdef HAVE_CRL
 /* Complete CRL */
@@ -2641,6 +2705,12 @@ struct CRL_Entry {
 #endif
 #if defined(OPENSSL_EXTRA)
     WOLFSSL_X509_NAME*    issuer;     /* X509_NAME type issuer */
+#endif
+#ifdef CRL_REVOKED_INDEX
+    CRL_RevokedIndex* revokedIdx;         /* lookup index over certs */
+#endif
+#ifdef HAVE_CRL_MMAP
+    CRL_Map* map;                         /* mapped DER revoked certs */
 #endif
     CRL_Entry* next;                      /* next entry */
     wolfSSL_Mutex verifyMutex;
@@ -2749,6 +2819,12 @@ struct WOLFSSL_CRL {
 #ifdef WOLFSSL_TRUST_PEER_CERT
     #define TP_TABLE_SIZE 11
 #endif
+#ifdef WOLFSSL_CA_INDEX
+    typedef struct CA_Index CA_Index;
+#endif
+#ifdef WOLFSSL_CHAIN_CACHE
+    typedef struct ChainCache ChainCache;
+#endif
 
 /* wolfSSL Certificate Manager */
 struct WOLFSSL_CERT_MANAGER {
@@ -2776,6 +2852,14 @@ struct WOLFSSL_CERT_MANAGER {
     CbOCSPIO        ocspIOCb;              /* I/O callback for OCSP lookup */
     CbOCSPRespFree  ocspRespFreeCb;        /* Frees OCSP Response from IO Cb */
     wolfSSL_Mutex   caLock;                /* CA list lock */
+#ifdef WOLFSSL_CA_INDEX
+    CA_Index*       caIdx;                 /* resizable index over caTable */
+    wolfSSL_RwLock  caIdxLock;             /* caIdx lock, readers only */
+#endif
+#ifdef WOLFSSL_CHAIN_CACHE
+    ChainCache*     chainCache;            /* verified peer chain cache */
+    wolfSSL_Mutex   chainCacheLock;        /* chainCache lock */
+#endif
     byte            crlEnabled:1;          /* is CRL on ? */
     byte            crlCheckAll:1;         /* always leaf, but all ? */
     byte            ocspEnabled:1;         /* is OCSP on ? */
@@ -2793,6 +2877,13 @@ struct WOLFSSL_CERT_MANAGER {
      * DoCertManagerFree can dispose of them safely even when construction
      * fails partway through. */
     WC_BITFIELD     caLockInit:1;          /* caLock has been initialized */
+#ifdef WOLFSSL_CA_INDEX
+    WC_BITFIELD     caIdxLockInit:1;       /* caIdxLock has been initialized */
+#endif
+#ifdef WOLFSSL_CHAIN_CACHE
+    WC_BITFIELD     chainCacheLockInit:1;  /* chainCacheLock has been
+                                            * initialized */
+#endif
 #ifdef WOLFSSL_TRUST_PEER_CERT
     WC_BITFIELD     tpLockInit:1;          /* tpLock has been initialized */
 #endif
@@ -2838,6 +2929,13 @@ WOLFSSL_LOCAL int CM_MemSaveCertCache(WOLFSSL_CERT_MANAGER* cm, void* mem,
 WOLFSSL_LOCAL int CM_MemRestoreCertCache(WOLFSSL_CERT_MANAGER* cm,
                                          const void* mem, int sz);
 WOLFSSL_LOCAL int CM_GetCertCacheMemSize(WOLFSSL_CERT_MANAGER* cm);
+#ifdef WOLFSSL_CHAIN_CACHE
+WOLFSSL_LOCAL int CM_ChainCacheLookup(WOLFSSL_CERT_MANAGER* cm,
+        const byte* digest, word32* gen);
+WOLFSSL_LOCAL void CM_ChainCacheAdd(WOLFSSL_CERT_MANAGER* cm,
+        const byte* digest, word32 gen);
+WOLFSSL_LOCAL void CM_ChainCacheInvalidate(WOLFSSL_CERT_MANAGER* cm);
+#endif
 WOLFSSL_LOCAL int CM_VerifyBuffer_ex(WOLFSSL_CERT_MANAGER* cm, const byte* buff,
                                      long sz, int format, int prev_err);
 
@@ -2859,6 +2957,9 @@ typedef struct ProcPeerCertArgs {
     int    certIdx;
     int    lastErr;
     int    leafVerifyErr;
+#ifdef WOLFSSL_CHAIN_CACHE
+    word32 chainCacheGen; /* chain cache generation at lookup */
+#endif
 #ifdef WOLFSSL_TLS13
     byte   ctxSz;
 #endif
@@ -2871,6 +2972,10 @@ typedef struct ProcPeerCertArgs {
 #ifdef WOLFSSL_TRUST_PEER_CERT
     word16 haveTrustPeer:1; /* was cert verified by loaded trusted peer cert */
 #endif
+#ifdef WOLFSSL_CHAIN_CACHE
+    word16 chainCacheHit:1;  /* chain verified before, skip signatures */
+    word16 chainCacheSkip:1; /* an error was seen, don't cache the chain */
+#endif
 } ProcPeerCertArgs;
 WOLFSSL_LOCAL int DoVerifyCallback(WOLFSSL_CERT_MANAGER* cm, WOLFSSL* ssl,
         int cert_err, ProcPeerCertArgs* args);
@@ -3956,6 +4061,25 @@ WOLFSSL_LOCAL int TLSX_KeyShare_Parse_ClientHello(const WOLFSSL* ssl,
         const byte* input, word16 length, TLSX** extensions);
 WOLFSSL_LOCAL int TLSX_KeyShare_HandlePqcHybridKeyServer(WOLFSSL* ssl,
         KeyShareEntry* keyShareEntry, byte* data, word16 len);
+
+#ifdef WOLFSSL_KEY_SHARE_POOL
+/* Pools of pre-generated ephemeral key shares, one list per group, that
+ * handshakes take from instead of generating a key pair. */
+#ifndef WOLFSSL_KEY_SHARE_POOL_MAX_GROUPS
+    #define WOLFSSL_KEY_SHARE_POOL_MAX_GROUPS 8   /* groups in one pool */
+#endif
+#ifndef WOLFSSL_KEY_SHARE_POOL_MAX_DEPTH
+    #define WOLFSSL_KEY_SHARE_POOL_MAX_DEPTH  64  /* ready keys per group */
+#endif
+
+typedef struct KeySharePool KeySharePool;
+
+WOLFSSL_LOCAL int  TLSX_KeySharePool_New(WOLFSSL_CTX* ctx,
+        const word16* groups, int count, int depth);
+WOLFSSL_LOCAL void TLSX_KeySharePool_Free(WOLFSSL_CTX* ctx);
+WOLFSSL_LOCAL int  TLSX_KeySharePool_Refill(KeySharePool* pool);
+WOLFSSL_LOCAL int  TLSX_KeySharePool_Count(KeySharePool* pool, word16 group);
+#endif /* WOLFSSL_KEY_SHARE_POOL */
 #ifdef WOLFSSL_DUAL_ALG_CERTS
 #ifdef WOLFSSL_API_PREFIX_MAP
     #define TLSX_CKS_Parse wolfSSL_TLSX_CKS_Parse
@@ -4209,6 +4333,10 @@ struct WOLFSSL_CTX {
     byte        haveStaticECC:1;  /* static server ECC private key */
     byte        partialWrite:1;   /* only one msg per write call */
     byte        autoRetry:1;      /* retry read/write on a WANT_{READ|WRITE} */
+    byte        releaseBuffers:1; /* return drained I/O buffers to pool */
+#ifdef WOLFSSL_TLS_RNG_BANK
+    byte        noRngBank:1;      /* connections instantiate their own RNG */
+#endif
     byte        quietShutdown:1;  /* don't send close notify */
     byte        groupMessages:1;  /* group handshake messages before sending */
     byte        minDowngrade;     /* minimum downgrade version */
@@ -4409,6 +4537,20 @@ struct WOLFSSL_CTX {
 #ifdef HAVE_EX_DATA
     WOLFSSL_CRYPTO_EX_DATA ex_data;
 #endif
+#if defined(OPENSSL_EXTRA) && !defined(NO_SESSION_CACHE)
+    /* wolfSSL_CTX_sess_set_cache_size() limit on this context's sessions in
+     * the session cache, which is shared by all contexts. */
+    long            sessCacheSize;    /* 0 when only the cache size limits */
+    byte*           sessCacheIds;     /* IDs of sessions added, oldest first,
+                                       * in a ring */
+    word32          sessCacheIdsMax;  /* ring capacity in IDs */
+    word32          sessCacheIdsIdx;  /* index of oldest ID */
+    word32          sessCacheIdsCnt;  /* number of IDs in ring */
+    #ifndef SINGLE_THREADED
+    wolfSSL_Mutex   sessCacheLock;
+    byte            sessCacheLockInit;
+    #endif
+#endif
 #if defined(HAVE_ALPN) && (defined(OPENSSL_ALL) || defined(WOLFSSL_NGINX) || \
     defined(WOLFSSL_HAPROXY) || defined(HAVE_LIGHTY) || defined(WOLFSSL_QUIC))
     CallbackALPNSelect alpnSelect;
@@ -4579,6 +4721,12 @@ struct WOLFSSL_CTX {
     wolfSSL_Mutex staticKELock;
     #endif
 #endif
+#ifdef WOLFSSL_IO_BUFFER_POOL
+    BufferPool  bufferPool;       /* released connection I/O buffers */
+#endif
+#ifdef WOLFSSL_KEY_SHARE_POOL
+    KeySharePool* keySharePool;   /* pre-generated ephemeral key shares */
+#endif
 #ifdef WOLFSSL_QUIC
     struct {
         const WOLFSSL_QUIC_METHOD *method;
@@ -5234,6 +5382,13 @@ typedef struct ThreadCrypt {
     #define WOLFSSL_TLS13_STREAM_CERT_VERIFY
 #endif
 
+/* Application data can be sent from and received into an array of iovecs
+ * (wolfSSL_writev() and wolfSSL_readv()). */
+#if !defined(_WIN32) && !defined(USE_WINDOWS_API) && !defined(NO_WRITEV) && \
+    !defined(NO_TLS)
+    #define WOLFSSL_HAVE_IOV
+#endif
+
 /* buffers for struct WOLFSSL */
 typedef struct Buffers {
     bufferStatic    inputBuffer;
@@ -5250,6 +5405,17 @@ typedef struct Buffers {
                                               when got WANT_WRITE            */
     word32          plainSz;               /* plain text bytes in buffer to send
                                               when got WANT_WRITE            */
+#ifdef WOLFSSL_HAVE_IOV
+    const struct iovec* sendIov;           /* wolfSSL_writev() segments that
+                                              SendData() sends from          */
+    int             sendIovCnt;            /* number of send segments        */
+    byte*           sendIovGather;         /* holds a record spanning send
+                                              segments                       */
+    word32          sendIovGatherSz;       /* size of gather buffer          */
+    const struct iovec* recvIov;           /* wolfSSL_readv() segments that
+                                              ReceiveData() fills            */
+    int             recvIovCnt;            /* number of receive segments     */
+#endif
     byte            weOwnCert;             /* SSL own cert flag */
     byte            weOwnCertChain;        /* SSL own cert chain flag */
     byte            weOwnKey;              /* SSL own key flag */
@@ -5434,6 +5600,7 @@ struct Options {
 #endif
 #endif
     word16            partialWrite:1;     /* only one msg per write call */
+    word16            releaseBuffers:1;   /* return drained I/O buffers */
     word16            quietShutdown:1;    /* don't send close notify */
     word16            certOnly:1;         /* stop once we get cert */
     word16            groupMessages:1;    /* group handshake messages */
@@ -5552,6 +5719,10 @@ struct Options {
 #endif
     word16            returnOnGoodCh:1;
     word16            disableRead:1;
+#ifdef WOLFSSL_KTLS
+    word16            ktlsTx:1;           /* Kernel encrypts sent records */
+    word16            ktlsRx:1;           /* Kernel decrypts received records */
+#endif
 #if defined(WOLFSSL_ASYNC_CRYPT) && defined(WOLFSSL_ASYNC_CERT_YIELD)
     /* Opt-in (WOLFSSL_ASYNC_CERT_YIELD): set when we deliberately returned
      * WC_PENDING_E between peer certificate verifies so a cooperative scheduler
@@ -6077,6 +6248,17 @@ typedef struct MsgsReceived {
 } MsgsReceived;
 
 
+/* Handshake hashes, as bits of HS_Hashes started */
+enum {
+    HS_HASH_MD5    = 0x01,
+    HS_HASH_SHA    = 0x02,
+    HS_HASH_SHA256 = 0x04,
+    HS_HASH_SHA384 = 0x08,
+    HS_HASH_SHA512 = 0x10,
+    HS_HASH_SM3    = 0x20,
+    HS_HASH_ALL    = 0x3f
+};
+
 /* Handshake hashes */
 typedef struct HS_Hashes {
     Hashes          verifyHashes;
@@ -6107,8 +6289,23 @@ typedef struct HS_Hashes {
     int             length;             /* length of handshake messages' data */
     int             prevLen;            /* length of messages but last */
 #endif
+#ifdef WOLFSSL_LAZY_HS_HASHES
+    byte*           transcript;         /* messages kept until hashes chosen */
+    word32          transcriptSz;       /* length of transcript data */
+    word32          transcriptMax;      /* size of transcript buffer */
+    word16          started;            /* HS_HASH_* bits of running hashes */
+    byte            selected;           /* no other hashes will be started */
+#endif
 } HS_Hashes;
 
+#ifdef WOLFSSL_LAZY_HS_HASHES
+    /* Whether the hash is running and needs updating. */
+    #define HS_HASH_RUNNING(hsHashes, hash) \
+        (((hsHashes)->started & (hash)) != 0)
+#else
+    #define HS_HASH_RUNNING(hsHashes, hash)     1
+#endif
+
 
 #ifndef WOLFSSL_NO_TLS12
 /* Persistable BuildMessage arguments */
@@ -6920,6 +7117,16 @@ struct WOLFSSL {
                                           * content have not been handled yet by quic */
     } quic;
 #endif /* WOLFSSL_QUIC */
+#ifdef WOLFSSL_KTLS
+    struct {
+        byte*  rxBuf;                    /* we own, received non-application
+                                          * record with a plaintext header */
+        word32 rxLen;                    /* bytes of record in rxBuf */
+        word32 rxIdx;                    /* bytes of rxBuf already consumed */
+        byte   txKeyUpdate;              /* KeyUpdate not all sent, new TX
+                                          * keys wait until it is */
+    } ktls;
+#endif /* WOLFSSL_KTLS */
 #if defined(WOLFSSL_TLS13) && defined(HAVE_ECH)
     WOLFSSL_EchConfig* echConfigs;
     WOLFSSL_EchConfig* echRetryConfigs;
@@ -7413,6 +7620,7 @@ WOLFSSL_LOCAL word32 MacSize(const WOLFSSL* ssl);
 
 #ifdef WOLFSSL_TLS13
     WOLFSSL_LOCAL int SendTls13KeyUpdate(WOLFSSL* ssl);
+    WOLFSSL_LOCAL int Tls13KeyUpdateSendKeys(WOLFSSL* ssl);
 #endif
 
 #ifdef WOLFSSL_DTLS
@@ -7628,6 +7836,16 @@ WOLFSSL_LOCAL void Free_HS_Hashes(HS_Hashes* hsHashes, void* heap);
 WOLFSSL_LOCAL void FreeHandshakeHashes(WOLFSSL* ssl);
 WOLFSSL_LOCAL int InitHandshakeHashesAndCopy(WOLFSSL* ssl, HS_Hashes* source,
     HS_Hashes** destination);
+#ifdef WOLFSSL_LAZY_HS_HASHES
+WOLFSSL_LOCAL int HashTranscriptAdd(HS_Hashes* hsHashes, void* heap,
+    const byte* data, word32 sz);
+WOLFSSL_LOCAL int StartHandshakeHashes(const WOLFSSL* ssl, word16 hashes);
+WOLFSSL_LOCAL int SelectHandshakeHashes(WOLFSSL* ssl);
+WOLFSSL_TEST_VIS word16 HandshakeHashForMac(byte macAlgo);
+#else
+    #define StartHandshakeHashes(ssl, hashes)   0
+    #define SelectHandshakeHashes(ssl)          0
+#endif
 
 
 #ifndef WOLFSSL_NO_TLS12
@@ -7874,6 +8092,22 @@ WOLFSSL_LOCAL int wolfSSL_quic_keys_active(WOLFSSL* ssl, enum encrypt_side side)
 #define WOLFSSL_IS_QUIC(s) 0
 #endif /* WOLFSSL_QUIC (else) */
 
+#ifdef WOLFSSL_KTLS
+#define WOLFSSL_IS_KTLS(s, isSend) \
+    ((isSend) ? (s)->options.ktlsTx : (s)->options.ktlsRx)
+WOLFSSL_LOCAL int wolfSSL_ktls_receive(WOLFSSL* ssl, byte* buf, word32 sz);
+WOLFSSL_LOCAL int wolfSSL_ktls_send(WOLFSSL* ssl);
+WOLFSSL_LOCAL int wolfSSL_ktls_send_data(WOLFSSL* ssl, const byte* data,
+                                         int sz, int sent);
+WOLFSSL_LOCAL int wolfSSL_ktls_receive_data(WOLFSSL* ssl, byte* output,
+                                            int sz);
+WOLFSSL_LOCAL int wolfSSL_ktls_keys_active(WOLFSSL* ssl,
+                                           enum encrypt_side side);
+WOLFSSL_LOCAL void wolfSSL_ktls_free(WOLFSSL* ssl);
+#else
+#define WOLFSSL_IS_KTLS(s, isSend) 0
+#endif /* WOLFSSL_KTLS (else) */
+
 #if defined(SHOW_SECRETS) && defined(WOLFSSL_SSLKEYLOGFILE)
 WOLFSSL_LOCAL int tls13ShowSecrets(WOLFSSL* ssl, int id, const unsigned char* secret,
     int secretSz, void* ctx);
@@ -75,6 +75,22 @@ WOLFSSL_LOCAL int CheckOcspResponse(WOLFSSL_OCSP *ocsp, byte *response, int resp
                                     OcspEntry *entry, OcspRequest *ocspRequest,
                                     void* heap, WOLFSSL* ssl);
 
+#ifdef WOLFSSL_OCSP_STAPLE_CACHE
+WOLFSSL_LOCAL int  OcspStapleCacheEnable(WOLFSSL_OCSP* ocsp, int maxEntries);
+WOLFSSL_LOCAL void OcspStapleCacheFree(WOLFSSL_OCSP* ocsp);
+WOLFSSL_LOCAL int  OcspStapleCacheAdd(WOLFSSL_OCSP* ocsp, const byte* der,
+                                      word32 derSz);
+WOLFSSL_LOCAL int  OcspStapleCacheRefresh(WOLFSSL_OCSP* ocsp, int force);
+WOLFSSL_LOCAL int  OcspStapleCacheStartRefresh(WOLFSSL_OCSP* ocsp,
+                                               word32 interval);
+WOLFSSL_LOCAL int  OcspStapleCacheStopRefresh(WOLFSSL_OCSP* ocsp);
+WOLFSSL_LOCAL int  OcspStapleCacheGetMemSize(WOLFSSL_OCSP* ocsp);
+WOLFSSL_LOCAL int  OcspStapleCacheMemSave(WOLFSSL_OCSP* ocsp, void* mem,
+                                          int sz, int* used);
+WOLFSSL_LOCAL int  OcspStapleCacheMemRestore(WOLFSSL_OCSP* ocsp,
+                                             const void* mem, int sz);
+#endif
+
 #ifndef CheckOcspResponder
 WOLFSSL_LOCAL int CheckOcspResponder(OcspResponse *bs, byte* subjectNameHash,
         byte* subjectKeyHash, byte extExtKeyUsage, byte* issuerNameHash,
@@ -302,6 +302,47 @@ WOLFSSL_API
 SSL_SNIFFER_API int ssl_DecodePacket_GetStream(SnifferStreamInfo* info,
         const byte* packet, int length, char* error);
 
+/* Multi-threaded decode pipeline. Packets of a batch are sharded by
+ * connection over worker threads, so each connection is always decoded by
+ * the same thread and in the order it appears in the batch. Needs thread
+ * local storage so that each shard has its own sniffer tables. */
+#if !defined(SINGLE_THREADED) && defined(WOLFSSL_COND) && \
+    defined(HAVE_THREAD_LS) && !defined(NO_THREAD_LS) && \
+    !defined(WOLFSSL_ASYNC_CRYPT) && !defined(WOLFSSL_SNIFFER_NO_PIPELINE)
+    #define WOLFSSL_SNIFFER_PIPELINE
+#endif
+
+#ifdef WOLFSSL_SNIFFER_PIPELINE
+
+typedef struct SSLSnifferPacket {
+    const unsigned char* packet;  /* in:  IP/TCP packet, link layer removed */
+    int                  length;  /* in:  packet length */
+    SSLInfo*             sslInfo; /* in:  optional, session info output */
+    char*                error;   /* in:  optional, MAX_ERROR_LEN buffer */
+    unsigned char*       data;    /* out: decoded data, release with
+                                   *      ssl_FreeZeroDecodeBuffer() */
+    int                  ret;     /* out: ssl_DecodePacket() return value */
+} SSLSnifferPacket;
+
+typedef struct SSLSnifferPipeline SSLSnifferPipeline;
+
+/* Called on each shard thread before it decodes, to load the server keys into
+ * that thread's tables. Return 0 on success. */
+typedef int (*SSLShardInitCb)(int shard, void* ctx, char* error);
+
+WOLFSSL_API
+SSL_SNIFFER_API int ssl_NewSnifferPipeline(SSLSnifferPipeline** pipeline,
+        int shards, SSLShardInitCb initCb, void* ctx, char* error);
+
+WOLFSSL_API
+SSL_SNIFFER_API int ssl_DecodePacketBatch(SSLSnifferPipeline* pipeline,
+        SSLSnifferPacket* packets, int count, char* error);
+
+WOLFSSL_API
+SSL_SNIFFER_API void ssl_FreeSnifferPipeline(SSLSnifferPipeline* pipeline);
+
+#endif /* WOLFSSL_SNIFFER_PIPELINE */
+
 #ifdef WOLFSSL_ASYNC_CRYPT
 
 WOLFSSL_API
@@ -1488,6 +1488,14 @@ WOLFSSL_API int wolfSSL_read_ex(WOLFSSL* ssl, void* data, size_t sz, size_t* rd)
 WOLFSSL_API int  wolfSSL_peek(WOLFSSL* ssl, void* data, int sz);
 WOLFSSL_ABI WOLFSSL_API int  wolfSSL_accept(WOLFSSL* ssl);
 WOLFSSL_API int wolfSSL_inject(WOLFSSL* ssl, const void* data, int sz);
+#ifdef WOLFSSL_KTLS
+/* Directions for kernel TLS offload. */
+#define WOLFSSL_KTLS_TX     0x01
+#define WOLFSSL_KTLS_RX     0x02
+WOLFSSL_API int  wolfSSL_UseKTLS(WOLFSSL* ssl, int dir);
+WOLFSSL_API int  wolfSSL_GetKTLS(const WOLFSSL* ssl);
+WOLFSSL_API int  wolfSSL_sendfile(WOLFSSL* ssl, int fd, long offset, int sz);
+#endif
 WOLFSSL_API int  wolfSSL_CTX_mutual_auth(WOLFSSL_CTX* ctx, int req);
 WOLFSSL_API int  wolfSSL_mutual_auth(WOLFSSL* ssl, int req);
 
@@ -1567,6 +1575,17 @@ WOLFSSL_API long wolfSSL_SESSION_set_time(WOLFSSL_SESSION *ses, long t);
 WOLFSSL_ABI WOLFSSL_API WOLFSSL_SESSION* wolfSSL_get_session(WOLFSSL* ssl);
 WOLFSSL_ABI WOLFSSL_API void wolfSSL_flush_sessions(WOLFSSL_CTX* ctx, long tm);
 WOLFSSL_API void wolfSSL_CTX_flush_sessions(WOLFSSL_CTX* ctx, long tm);
+#ifndef NO_SESSION_CACHE
+WOLFSSL_API int  wolfSSL_SetSessionCacheLocks(int locks);
+WOLFSSL_API int  wolfSSL_GetSessionCacheLocks(void);
+WOLFSSL_API int  wolfSSL_GetSessionCacheLocksMax(void);
+WOLFSSL_API int  wolfSSL_set_session_cache_size(long sz);
+WOLFSSL_API long wolfSSL_get_session_cache_size(void);
+#ifdef SESSION_CACHE_SHARED_MEM
+WOLFSSL_API int  wolfSSL_get_session_cache_shared_memsize(void);
+WOLFSSL_API int  wolfSSL_set_session_cache_shared(void* mem, int sz);
+#endif
+#endif
 WOLFSSL_API int  wolfSSL_SetServerID(WOLFSSL* ssl, const unsigned char* id, int len, int newSession);
 
 #if defined(OPENSSL_ALL) || defined(WOLFSSL_ASIO) || defined(WOLFSSL_HAPROXY) \
@@ -2873,14 +2892,17 @@ enum {
     WOLFSSL_CB_MODE_READ = 1,
     WOLFSSL_CB_MODE_WRITE = 2,
 
+    /* Modes are bits and can be OR'd together. The older values 3 for
+     * AUTO_RETRY and -1 for RELEASE_BUFFERS are still accepted. */
     WOLFSSL_MODE_ENABLE_PARTIAL_WRITE = 2,
-    WOLFSSL_MODE_AUTO_RETRY = 3, /* wolfSSL default is to return WANT_{READ|WRITE}
+    WOLFSSL_MODE_AUTO_RETRY = 8, /* wolfSSL default is to return WANT_{READ|WRITE}
                               * to the user. This is set by default with
                               * OPENWOLFSSL_COMPATIBLE_DEFAULTS. The macro
                               * WOLFWOLFSSL_MODE_AUTO_RETRY_ATTEMPTS is used to
                               * limit the possibility of an infinite retry loop
                               */
-    WOLFSSL_MODE_RELEASE_BUFFERS = -1, /* For libwebsockets build. No current use. */
+    WOLFSSL_MODE_RELEASE_BUFFERS = 0x10, /* return idle connection I/O buffers
+                                          * to the WOLFSSL_CTX buffer pool */
 
     WOLFSSL_CRYPTO_LOCK = 1,
     WOLFSSL_CRYPTO_NUM_LOCKS = 10
@@ -3889,9 +3911,11 @@ WOLFSSL_API int wolfSSL_make_eap_keys(WOLFSSL* ssl, void* key, unsigned int len,
               !defined(WOLFSSL_NDS)
             #include <sys/uio.h>
         #endif
-        /* allow writev style writing */
+        /* allow writev/readv style writing and reading */
         WOLFSSL_API int wolfSSL_writev(WOLFSSL* ssl, const struct iovec* iov,
                                      int iovcnt);
+        WOLFSSL_API int wolfSSL_readv(WOLFSSL* ssl, const struct iovec* iov,
+                                     int iovcnt);
     #endif /* !NO_WRITEV */
 #endif /* !_WIN32 */
 
@@ -4042,6 +4066,9 @@ enum {
 };
 
 WOLFSSL_ABI WOLFSSL_API WC_RNG* wolfSSL_GetRNG(WOLFSSL* ssl);
+#ifdef WOLFSSL_TLS_RNG_BANK
+WOLFSSL_API int wolfSSL_CTX_UseRngBank(WOLFSSL_CTX* ctx, int enable);
+#endif
 
 WOLFSSL_ABI WOLFSSL_API int wolfSSL_CTX_SetMinVersion(WOLFSSL_CTX* ctx, int version);
 WOLFSSL_API int wolfSSL_SetMinVersion(WOLFSSL* ssl, int version);
@@ -4558,6 +4585,14 @@ WOLFSSL_API void wolfSSL_CTX_SetPerformTlsRecordProcessingCb(WOLFSSL_CTX* ctx,
 #ifdef WOLFSSL_TRUST_PEER_CERT
     WOLFSSL_API int wolfSSL_CertManagerUnload_trust_peers(
         WOLFSSL_CERT_MANAGER* cm);
+#endif
+#ifdef WOLFSSL_CHAIN_CACHE
+    WOLFSSL_API int wolfSSL_CertManagerEnableChainCache(
+        WOLFSSL_CERT_MANAGER* cm, int entries);
+    WOLFSSL_API int wolfSSL_CertManagerDisableChainCache(
+        WOLFSSL_CERT_MANAGER* cm);
+    WOLFSSL_API int wolfSSL_CertManagerGetChainCacheStats(
+        WOLFSSL_CERT_MANAGER* cm, word32* hits, word32* misses);
 #endif
     WOLFSSL_API int wolfSSL_CertManagerVerify(WOLFSSL_CERT_MANAGER* cm,
         const char* f, int format);
@@ -4665,6 +4700,26 @@ WOLFSSL_API WOLF_STACK_OF(WOLFSSL_X509)* wolfSSL_X509_STORE_get1_certs(
     WOLFSSL_API int wolfSSL_CTX_DisableOCSPStapling(WOLFSSL_CTX* ctx);
     WOLFSSL_API int wolfSSL_CTX_EnableOCSPMustStaple(WOLFSSL_CTX* ctx);
     WOLFSSL_API int wolfSSL_CTX_DisableOCSPMustStaple(WOLFSSL_CTX* ctx);
+#ifdef WOLFSSL_OCSP_STAPLE_CACHE
+    WOLFSSL_API int wolfSSL_CTX_EnableOCSPStapleCache(WOLFSSL_CTX* ctx,
+        int maxCerts);
+    WOLFSSL_API int wolfSSL_CTX_OCSPStapleCacheRefresh(WOLFSSL_CTX* ctx,
+        int force);
+    WOLFSSL_API int wolfSSL_CTX_StartOCSPStapleRefresh(WOLFSSL_CTX* ctx,
+        unsigned int intervalSec);
+    WOLFSSL_API int wolfSSL_CTX_StopOCSPStapleRefresh(WOLFSSL_CTX* ctx);
+#ifndef NO_FILESYSTEM
+    WOLFSSL_API int wolfSSL_CTX_save_ocsp_staple_cache(WOLFSSL_CTX* ctx,
+        const char* fname);
+    WOLFSSL_API int wolfSSL_CTX_restore_ocsp_staple_cache(WOLFSSL_CTX* ctx,
+        const char* fname);
+#endif
+    WOLFSSL_API int wolfSSL_CTX_memsave_ocsp_staple_cache(WOLFSSL_CTX* ctx,
+        void* mem, int sz, int* used);
+    WOLFSSL_API int wolfSSL_CTX_memrestore_ocsp_staple_cache(WOLFSSL_CTX* ctx,
+        const void* mem, int sz);
+    WOLFSSL_API int wolfSSL_CTX_get_ocsp_staple_cache_memsize(WOLFSSL_CTX* ctx);
+#endif /* WOLFSSL_OCSP_STAPLE_CACHE */
 #endif /* !NO_CERTS */
 
 
@@ -5008,6 +5063,12 @@ WOLFSSL_API int wolfSSL_CTX_UseSupportedCurve(WOLFSSL_CTX* ctx,
 #ifdef WOLFSSL_TLS13
 WOLFSSL_API int wolfSSL_UseKeyShare(WOLFSSL* ssl, word16 group);
 WOLFSSL_API int wolfSSL_NoKeyShares(WOLFSSL* ssl);
+#ifdef WOLFSSL_KEY_SHARE_POOL
+WOLFSSL_API int wolfSSL_CTX_UseKeySharePool(WOLFSSL_CTX* ctx,
+                                const word16* groups, int count, int depth);
+WOLFSSL_API int wolfSSL_CTX_KeySharePoolRefill(WOLFSSL_CTX* ctx);
+WOLFSSL_API int wolfSSL_CTX_KeySharePoolCount(WOLFSSL_CTX* ctx, word16 group);
+#endif
 #endif
 
 #ifdef WOLFSSL_DUAL_ALG_CERTS
@@ -5198,6 +5259,23 @@ typedef int (*ClientHelloGoodCb)(WOLFSSL* ssl, void*);
 WOLFSSL_API int wolfDTLS_SetChGoodCb(WOLFSSL* ssl, ClientHelloGoodCb cb, void* user_ctx);
 #endif
 
+#ifdef WOLFSSL_DTLS_DISPATCH
+/* Server side dispatcher of many DTLS peers on one UDP socket. */
+typedef struct WOLFSSL_DTLS_DISPATCHER WOLFSSL_DTLS_DISPATCHER;
+/* notify user of a new connection. Return non-zero to reject the peer. */
+typedef int (*WolfDtlsDispatchNewPeerCb)(WOLFSSL* ssl, void* arg);
+WOLFSSL_API WOLFSSL_DTLS_DISPATCHER* wolfDTLS_DispatchNew(WOLFSSL_CTX* ctx,
+    int sfd, int cidSz);
+WOLFSSL_API void wolfDTLS_DispatchFree(WOLFSSL_DTLS_DISPATCHER* d);
+WOLFSSL_API int wolfDTLS_DispatchSetNewPeerCb(WOLFSSL_DTLS_DISPATCHER* d,
+    WolfDtlsDispatchNewPeerCb cb, void* arg);
+WOLFSSL_API int wolfDTLS_DispatchRecv(WOLFSSL_DTLS_DISPATCHER* d,
+    WOLFSSL** ready, int max);
+WOLFSSL_API int wolfDTLS_DispatchFlush(WOLFSSL_DTLS_DISPATCHER* d);
+WOLFSSL_API int wolfDTLS_DispatchRemove(WOLFSSL_DTLS_DISPATCHER* d,
+    WOLFSSL* ssl);
+#endif
+
 /* notify user the handshake is done */
 typedef int (*HandShakeDoneCb)(WOLFSSL* ssl, void*);
 WOLFSSL_API int wolfSSL_SetHsDoneCb(WOLFSSL* ssl, HandShakeDoneCb cb, void* user_ctx);
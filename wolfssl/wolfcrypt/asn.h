@@ -3241,6 +3241,13 @@ struct RevokedCert {
 
 typedef struct DecodedCRL DecodedCRL;
 
+#ifdef HAVE_CRL_MMAP
+/* Called by ParseCRL() for each revoked cert instead of adding it to the
+ * certs list. serial points into the buffer being parsed. */
+typedef int (*wc_CrlRevokedCallback)(void* ctx, const byte* serial,
+                                     int serialSz);
+#endif
+
 struct DecodedCRL {
     word32  certBegin;               /* offset to start of cert          */
     word32  sigIndex;                /* offset to start of signature     */
@@ -3277,6 +3284,10 @@ struct DecodedCRL {
     wc_UnknownExtCallbackEx unknownExtCallbackEx;
     void*                   unknownExtCallbackExCtx;
 #endif
+#ifdef HAVE_CRL_MMAP
+    wc_CrlRevokedCallback   revokedCallback;
+    void*                   revokedCallbackCtx;
+#endif
 };
 
 WOLFSSL_LOCAL void InitDecodedCRL(DecodedCRL* dcrl, void* heap);
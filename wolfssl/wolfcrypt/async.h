@@ -265,6 +265,17 @@ struct WC_ASYNC_DEV;
     #endif
 #endif
 
+#ifdef WOLFSSL_ASYNC_THREADPOOL
+    /* software device worker pool: most workers started and most
+     * operations queued (not running) at once */
+    #ifndef WC_ASYNC_POOL_MAX_THREADS
+        #define WC_ASYNC_POOL_MAX_THREADS   16
+    #endif
+    #ifndef WC_ASYNC_POOL_MAX_JOBS
+        #define WC_ASYNC_POOL_MAX_JOBS      64
+    #endif
+#endif
+
 /* async thresholds - defaults */
 #ifdef WC_ASYNC_THRESH_NONE
     #undef  WC_ASYNC_THRESH_AES_CBC
@@ -391,6 +402,10 @@ typedef struct WC_ASYNC_DEV {
 #elif defined(WOLFSSL_ASYNC_CRYPT_SW)
     WC_ASYNC_SW         sw;
 #endif
+#ifdef WOLFSSL_ASYNC_THREADPOOL
+    int                 poolRet;   /* result of op run by a pool worker */
+    byte                poolState; /* guarded by the pool lock */
+#endif
 } WC_ASYNC_DEV;
 
 
@@ -433,6 +448,17 @@ WOLFSSL_API int wc_AsyncSleep(word32 ms);
     WOLFSSL_TEST_VIS void wolfAsync_SwForceSyncType(int type);
 #endif
 
+#ifdef WOLFSSL_ASYNC_THREADPOOL
+    /* Public key operations of the software device run on a pool of worker
+     * threads. wolfAsync_DevOpen() starts the pool and wolfAsync_DevClose()
+     * stops it; both are reference counted. The descriptor becomes readable
+     * when an operation completes: wait on it, clear it, then poll. */
+    WOLFSSL_API int wolfAsync_ThreadPoolInit(int threads);
+    WOLFSSL_API void wolfAsync_ThreadPoolFree(void);
+    WOLFSSL_API int wolfAsync_ThreadPoolGetFd(void);
+    WOLFSSL_API void wolfAsync_ThreadPoolClearFd(void);
+#endif
+
 /* Pthread Helpers */
 #ifndef WC_NO_ASYNC_THREADING
 #include <stdio.h>
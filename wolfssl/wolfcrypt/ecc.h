@@ -861,6 +861,20 @@ WOLFSSL_ABI WOLFSSL_API
 void wc_ecc_fp_free(void);
 WOLFSSL_API
 void wc_ecc_fp_init(void);
+#ifdef FP_ECC_SHARED
+WOLFSSL_API
+int wc_ecc_fp_share_point(int curve_id, ecc_point* point);
+WOLFSSL_API
+int wc_ecc_fp_share_key(ecc_key* key);
+WOLFSSL_API
+int wc_ecc_fp_export_shared(byte* out, word32* outSz);
+WOLFSSL_API
+int wc_ecc_fp_import_shared(const byte* in, word32 inSz);
+WOLFSSL_API
+void wc_ecc_fp_free_shared(void);
+WOLFSSL_LOCAL
+void wc_ecc_fp_shared_cleanup(void);
+#endif
 WOLFSSL_API
 int wc_ecc_set_rng(ecc_key* key, WC_RNG* rng);
 
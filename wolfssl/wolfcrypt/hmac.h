@@ -202,6 +202,17 @@ WOLFSSL_API void wc_HmacFree(Hmac* hmac);
 
 WOLFSSL_API int wolfSSL_GetHmacMaxSize(void);
 
+#ifdef WOLFSSL_SHA2_BATCH
+#ifndef NO_SHA256
+WOLFSSL_API int wc_HmacSha256Batch(const byte* key, word32 keySz,
+    const byte* const* data, const word32* len, byte* const* mac, word32 cnt);
+#endif
+#if defined(WOLFSSL_SHA512) && !defined(WOLF_CRYPTO_CB_ONLY_SHA512)
+WOLFSSL_API int wc_HmacSha512Batch(const byte* key, word32 keySz,
+    const byte* const* data, const word32* len, byte* const* mac, word32 cnt);
+#endif
+#endif /* WOLFSSL_SHA2_BATCH */
+
 WOLFSSL_LOCAL int _InitHmac(Hmac* hmac, int type, void* heap);
 WOLFSSL_LOCAL int _HmacInitIOHashes(Hmac* hmac);
 
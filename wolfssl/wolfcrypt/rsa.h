@@ -163,6 +163,23 @@ RSA keys can be used to encrypt, decrypt, sign and verify data.
 #ifdef WOLFSSL_ASYNC_CRYPT
     #include <wolfssl/wolfcrypt/async.h>
 #endif
+
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    /* Maximum number of primes in a multi-prime RSA private key. */
+    #ifndef WC_RSA_MAX_PRIMES
+        #define WC_RSA_MAX_PRIMES   3
+    #endif
+    #if WC_RSA_MAX_PRIMES < 3
+        #error "WC_RSA_MAX_PRIMES must be at least 3"
+    #endif
+
+/* Additional prime of a multi-prime RSA private key (RFC 8017, A.1.2). */
+typedef struct RsaOtherPrime {
+    mp_int r;   /* Prime factor. */
+    mp_int d;   /* CRT exponent: d mod (r-1). */
+    mp_int t;   /* CRT coefficient: (r_1 * ... * r_(i-1))^-1 mod r. */
+} RsaOtherPrime;
+#endif
 #if defined(WOLFSSL_MICROCHIP_TA100)
     #include <wolfssl/wolfcrypt/port/atmel/atmel.h>
 #endif /* WOLFSSL_MICROCHIP_TA100 */
@@ -236,6 +253,10 @@ struct RsaKey {
 #if defined(WOLFSSL_KEY_GEN) || defined(OPENSSL_EXTRA) || !defined(RSA_LOW_MEM)
     mp_int dP, dQ, u;
 #endif
+#ifdef WOLFSSL_RSA_MULTI_PRIME
+    RsaOtherPrime other[WC_RSA_MAX_PRIMES - 2]; /* primes after p and q */
+    int otherCnt;                               /* number of other primes */
+#endif
 #endif
     void* heap;                               /* for user memory overrides */
     byte* data;                               /* temp buffer for async RSA */
@@ -514,6 +535,10 @@ WOLFSSL_API int wc_RsaExportKey(const RsaKey* key,
 
 #ifdef WOLFSSL_KEY_GEN
     WOLFSSL_API int wc_MakeRsaKey(RsaKey* key, int size, long e, WC_RNG* rng);
+    #ifdef WOLFSSL_RSA_MULTI_PRIME
+    WOLFSSL_API int wc_MakeRsaKeyMultiPrime(RsaKey* key, int size, long e,
+                                            int primes, WC_RNG* rng);
+    #endif
     WOLFSSL_API int wc_CheckProbablePrime_ex(const byte* p, word32 pSz,
                                           const byte* q, word32 qSz,
                                           const byte* e, word32 eSz,
@@ -4023,7 +4023,10 @@
     #undef HAVE_WOLF_EVENT
     #define HAVE_WOLF_EVENT
 
-    #ifdef WOLFSSL_ASYNC_CRYPT_SW
+    #if defined(WOLFSSL_ASYNC_CRYPT_SW) && defined(WOLFSSL_ASYNC_THREADPOOL)
+        /* Room for the worker pool's result and state. */
+        #define WC_ASYNC_DEV_SIZE 184
+    #elif defined(WOLFSSL_ASYNC_CRYPT_SW)
         #define WC_ASYNC_DEV_SIZE 168
     #else
         #define WC_ASYNC_DEV_SIZE 336
@@ -4100,6 +4103,16 @@
     #error old TLS requires MD5 and SHA
 #endif
 
+#if defined(WOLFSSL_CHAIN_CACHE) && (defined(NO_SHA256) || defined(NO_CERTS))
+    #error The verified chain cache requires SHA-256 and certificate support
+#endif
+
+#if defined(WOLFSSL_OCSP_STAPLE_CACHE) && (!defined(HAVE_OCSP) || \
+    (!defined(HAVE_CERTIFICATE_STATUS_REQUEST) && \
+     !defined(HAVE_CERTIFICATE_STATUS_REQUEST_V2)))
+    #error The OCSP staple cache requires OCSP and OCSP stapling
+#endif
+
 /* for backwards compatibility */
 #if defined(TEST_IPV6) && !defined(WOLFSSL_IPV6)
     #define WOLFSSL_IPV6
@@ -5354,6 +5367,35 @@ blinding by defining WC_BLINDING_NO_RNG_ACKNOWLEDGE_WEAKNESS."
     #undef  WOLFSSL_NO_INT_DECODE
 #endif
 
+/* Threaded LMS/XMSS tree computation needs the threading API. */
+#if defined(WOLFSSL_LMS_XMSS_THREADS) && (defined(SINGLE_THREADED) || \
+    (!defined(WOLFSSL_HAVE_XMSS) && !defined(WOLFSSL_HAVE_LMS)))
+    #undef WOLFSSL_LMS_XMSS_THREADS
+#endif
+
+/* Multi-prime RSA needs the generic CRT private operation. */
+#if defined(WOLFSSL_RSA_MULTI_PRIME) && (defined(NO_RSA) || \
+    defined(WOLFSSL_RSA_PUBLIC_ONLY) || defined(WOLFSSL_RSA_VERIFY_ONLY) || \
+    defined(RSA_LOW_MEM) || defined(WOLFSSL_SP_MATH) || defined(HAVE_FIPS) || \
+    defined(WOLF_CRYPTO_CB_ONLY_RSA))
+    #undef WOLFSSL_RSA_MULTI_PRIME
+#endif
+
+/* The async worker pool runs the software device's ops on POSIX threads. */
+#if defined(WOLFSSL_ASYNC_THREADPOOL) && (!defined(WOLFSSL_ASYNC_CRYPT) || \
+    !defined(WOLFSSL_ASYNC_CRYPT_SW) || defined(HAVE_CAVIUM) || \
+    defined(HAVE_INTEL_QA) || defined(WC_NO_ASYNC_THREADING) || \
+    defined(SINGLE_THREADED))
+    #undef WOLFSSL_ASYNC_THREADPOOL
+#endif
+
+/* The I/O buffer pool hands buffers between connections, which static memory
+ * IO pools do not allow. */
+#if defined(WOLFSSL_IO_BUFFER_POOL) && (defined(WOLFSSL_STATIC_MEMORY) || \
+    defined(NO_TLS))
+    #undef WOLFSSL_IO_BUFFER_POOL
+#endif
+
 /* DTLS v1.3 requires AES ECB if using AES */
 #if defined(WOLFSSL_DTLS13) && !defined(NO_AES) && \
     !defined(WOLFSSL_AES_DIRECT)
@@ -5494,6 +5536,9 @@ blinding by defining WC_BLINDING_NO_RNG_ACKNOWLEDGE_WEAKNESS."
 #if defined(SESSION_CACHE_DYNAMIC_MEM) && defined(PERSIST_SESSION_CACHE)
 #error "Dynamic session cache currently does not support persistent session cache."
 #endif
+#if defined(SESSION_CACHE_DYNAMIC_MEM) && defined(SESSION_CACHE_SHARED_MEM)
+#error "Shared memory session cache needs the sessions stored in the rows."
+#endif
 
 #ifdef WOLFSSL_HARDEN_TLS
     #if defined(HAVE_TRUNCATED_HMAC) && !defined(WOLFSSL_HARDEN_TLS_ALLOW_TRUNCATED_HMAC)
@@ -5639,6 +5684,9 @@ blinding by defining WC_BLINDING_NO_RNG_ACKNOWLEDGE_WEAKNESS."
 #if defined(FP_ECC) && !defined(HAVE_ECC)
     #error "FP_ECC requires ECC (HAVE_ECC)"
 #endif
+#if defined(FP_ECC_SHARED) && (!defined(FP_ECC) || defined(WOLFSSL_SP_MATH))
+    #error "FP_ECC_SHARED requires FP_ECC and is not supported with WOLFSSL_SP_MATH"
+#endif
 #if defined(HAVE_ECC_ENCRYPT) && !defined(HAVE_ECC)
     #error "ECC encrypt (HAVE_ECC_ENCRYPT) requires ECC (HAVE_ECC)"
 #endif
@@ -5907,6 +5955,36 @@ blinding by defining WC_BLINDING_NO_RNG_ACKNOWLEDGE_WEAKNESS."
     #undef WC_RNG_BANK_SUPPORT
 #endif
 
+/* The TLS RNG bank is allocated from the global heap and shared by every
+ * connection, which static memory does not allow. */
+#if defined(WOLFSSL_TLS_RNG_BANK) && (!defined(WC_RNG_BANK_SUPPORT) || \
+    defined(WC_RNG_BANK_STATIC) || defined(WOLFSSL_STATIC_MEMORY) || \
+    defined(NO_TLS))
+    #undef WOLFSSL_TLS_RNG_BANK
+#endif
+
+/* Pooled key shares are generated from the CTX heap ahead of any connection,
+ * which static memory pools don't allow. */
+#if defined(WOLFSSL_KEY_SHARE_POOL) && (!defined(WOLFSSL_TLS13) || \
+    !defined(HAVE_SUPPORTED_CURVES) || defined(WOLFSSL_STATIC_MEMORY) || \
+    defined(NO_TLS))
+    #undef WOLFSSL_KEY_SHARE_POOL
+#endif
+
+#if defined(WOLFSSL_MLKEM_BATCH) && (!defined(WOLFSSL_HAVE_MLKEM) || \
+    defined(WOLFSSL_NO_ML_KEM))
+    #undef WOLFSSL_MLKEM_BATCH
+#endif
+
+/* The DTLS dispatcher is a server reading and writing a BSD UDP socket with
+ * the wolfSSL socket I/O. */
+#if defined(WOLFSSL_DTLS_DISPATCH) && (!defined(WOLFSSL_DTLS) || \
+    defined(NO_WOLFSSL_SERVER) || defined(WOLFSSL_USER_IO) || \
+    defined(WOLFSSL_NO_SOCK) || defined(USE_WINDOWS_API) || \
+    defined(WOLFCRYPT_ONLY))
+    #undef WOLFSSL_DTLS_DISPATCH
+#endif
+
 /* The OCSP responder time-stamps every response it generates (producedAt,
  * thisUpdate and, for revoked certs, revocationDate), so it needs ASN time
  * support. */
@@ -5932,6 +6010,25 @@ blinding by defining WC_BLINDING_NO_RNG_ACKNOWLEDGE_WEAKNESS."
     #endif
 #endif
 
+/* Mapped CRLs are served from a revoked cert index over the file bytes. */
+#ifdef HAVE_CRL_MMAP
+    #ifndef HAVE_CRL
+        #error "HAVE_CRL_MMAP requires HAVE_CRL"
+    #endif
+    #ifndef WOLFSSL_ASN_TEMPLATE
+        #error "HAVE_CRL_MMAP requires WOLFSSL_ASN_TEMPLATE"
+    #endif
+    #ifdef CRL_STATIC_REVOKED_LIST
+        #error "HAVE_CRL_MMAP is incompatible with CRL_STATIC_REVOKED_LIST"
+    #endif
+    #if defined(NO_FILESYSTEM) || defined(USE_WINDOWS_API)
+        #error "HAVE_CRL_MMAP requires a POSIX file system"
+    #endif
+    #ifndef CRL_REVOKED_INDEX
+        #define CRL_REVOKED_INDEX
+    #endif
+#endif
+
 #ifdef __CHERI_PURE_CAPABILITY__
     #define WC_NO_PTR_INT_CAST
 #endif
@@ -292,6 +292,16 @@ WOLFSSL_API void wc_Sha256SizeSet(wc_Sha256* sha256, word32 len);
     WOLFSSL_API int wc_Sha256GetFlags(wc_Sha256* sha256, word32* flags);
 #endif
 
+#ifdef WOLFSSL_SHA2_BATCH
+/* Most messages hashed at once by a multi-buffer SHA-256 kernel. */
+#define WC_SHA256_BATCH_LANES   16
+
+WOLFSSL_API int wc_Sha256HashBatch(const byte* const* data, const word32* len,
+    byte* const* hash, word32 cnt);
+WOLFSSL_LOCAL int wc_Sha256HashBatch_ex(const byte* prefix,
+    const byte* const* data, const word32* len, byte* const* hash, word32 cnt);
+#endif
+
 #ifdef WOLFSSL_SHA224
 /* avoid redefinition of structs */
 #if !defined(HAVE_FIPS) || \
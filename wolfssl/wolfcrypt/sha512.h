@@ -275,6 +275,16 @@ WOLFSSL_API int wc_Sha512Copy(wc_Sha512* src, wc_Sha512* dst);
     WOLFSSL_API int wc_Sha512GetFlags(wc_Sha512* sha512, word32* flags);
 #endif
 
+#if defined(WOLFSSL_SHA2_BATCH) && !defined(WOLF_CRYPTO_CB_ONLY_SHA512)
+/* Most messages hashed at once by a multi-buffer SHA-512 kernel. */
+#define WC_SHA512_BATCH_LANES   8
+
+WOLFSSL_API int wc_Sha512HashBatch(const byte* const* data, const word32* len,
+    byte* const* hash, word32 cnt);
+WOLFSSL_LOCAL int wc_Sha512HashBatch_ex(const byte* prefix,
+    const byte* const* data, const word32* len, byte* const* hash, word32 cnt);
+#endif
+
 #if (defined(OPENSSL_EXTRA) || defined(HAVE_CURL)) && \
     !defined(WOLF_CRYPTO_CB_ONLY_SHA512)
 WOLFSSL_API int wc_Sha512Transform(wc_Sha512* sha, const unsigned char* data);
@@ -1482,7 +1482,8 @@ enum {
     DYNAMIC_TYPE_SNIFFER_KEY          = 1006,
     DYNAMIC_TYPE_SNIFFER_KEYLOG_NODE  = 1007,
     DYNAMIC_TYPE_SNIFFER_CHAIN_BUFFER = 1008,
-    DYNAMIC_TYPE_AES_EAX = 1009
+    DYNAMIC_TYPE_AES_EAX = 1009,
+    DYNAMIC_TYPE_SNIFFER_PIPELINE     = 1010
 };
 
 #ifndef WOLFSSL_NO_DILITHIUM_LEGACY_NAMES
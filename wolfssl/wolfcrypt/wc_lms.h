@@ -653,6 +653,10 @@ typedef struct LmsState {
 #endif
     /* LMS parameters. */
     const LmsParams* params;
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    /* Number of threads to compute leaf nodes with. */
+    word8 threads;
+#endif
 #ifdef WOLFSSL_LMS_SHAKE256
     /* The LMS instance uses exactly one hash family at a time, selected at
      * init time by params->lmOtsType (see wc_lms.c LMS_IS_SHAKE dispatch).
@@ -749,6 +753,13 @@ typedef struct HssPrivKey {
 #define LMS_MAX_LABEL_LEN           32
 #endif
 
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+/* Maximum number of threads that compute leaf nodes of a tree. */
+#ifndef WC_LMS_MAX_THREADS
+#define WC_LMS_MAX_THREADS          64
+#endif
+#endif
+
 struct LmsKey {
     /* Public key. */
     ALIGN16 byte pub[HSS_PUBLIC_KEY_LEN(LMS_MAX_NODE_LEN)];
@@ -769,6 +780,10 @@ struct LmsKey {
     void*                context;
     /* Dynamic memory hint. */
     void* heap;
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    /* Number of threads to compute leaf nodes with. */
+    word8 threads;
+#endif
 #endif /* !WOLFSSL_LMS_VERIFY_ONLY */
     /* Parameters of key. */
     const LmsParams* params;
@@ -821,6 +836,9 @@ WOLFSSL_API int  wc_LmsKey_SetWriteCb(LmsKey* key,
 WOLFSSL_API int  wc_LmsKey_SetReadCb(LmsKey* key,
     wc_lms_read_private_key_cb read_cb);
 WOLFSSL_API int  wc_LmsKey_SetContext(LmsKey* key, void* context);
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+WOLFSSL_API int  wc_LmsKey_SetThreads(LmsKey* key, int threads);
+#endif
 WOLFSSL_API int  wc_LmsKey_MakeKey(LmsKey* key, WC_RNG* rng);
 WOLFSSL_API int  wc_LmsKey_Reload(LmsKey* key);
 WOLFSSL_API int  wc_LmsKey_GetPrivLen(const LmsKey* key, word32* len);
@@ -851,6 +869,8 @@ WOLFSSL_API const byte* wc_LmsKey_GetKidFromPrivRaw(const byte* priv,
     word32 privSz);
 #endif
 
+int wc_lmskey_state_init(LmsState* state, const LmsParams* params);
+void wc_lmskey_state_free(LmsState* state);
 int wc_hss_make_key(LmsState* state, WC_RNG* rng, byte* priv_raw,
     HssPrivKey* priv_key, byte* priv_data, byte* pub);
 int wc_hss_reload_key(LmsState* state, const byte* priv_raw,
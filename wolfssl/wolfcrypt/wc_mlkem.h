@@ -199,6 +199,15 @@
 #endif
 #endif /* WC_ML_KEM_MAX_K */
 
+#ifdef WOLFSSL_MLKEM_BATCH
+/* Most keys worked on together by the batch encapsulate/decapsulate APIs.
+ * Longer batches are split. A multiple of 8 keeps the x4 and x8 Keccak lanes
+ * full for every key type. */
+#ifndef WC_ML_KEM_BATCH_SZ
+    #define WC_ML_KEM_BATCH_SZ          8
+#endif
+#endif
+
 #define KYBER_N             MLKEM_N
 
 /* Size of a polynomial vector based on dimensions. */
@@ -453,6 +462,15 @@ WOLFSSL_API int wc_MlKemKey_EncapsulateWithRandom(MlKemKey* key,
     unsigned char* ct, unsigned char* ss, const unsigned char* rand, int len);
 WOLFSSL_API int wc_MlKemKey_Decapsulate(MlKemKey* key, unsigned char* ss,
     const unsigned char* ct, word32 len);
+#ifdef WOLFSSL_MLKEM_BATCH
+WOLFSSL_API int wc_MlKemKey_EncapsulateBatch(MlKemKey** key,
+    unsigned char** ct, unsigned char** ss, WC_RNG* rng, int cnt);
+WOLFSSL_API int wc_MlKemKey_EncapsulateBatchWithRandom(MlKemKey** key,
+    unsigned char** ct, unsigned char** ss, const unsigned char** rand,
+    int cnt);
+WOLFSSL_API int wc_MlKemKey_DecapsulateBatch(MlKemKey** key,
+    unsigned char** ss, const unsigned char** ct, const word32* len, int cnt);
+#endif
 
 WOLFSSL_API int wc_MlKemKey_DecodePrivateKey(MlKemKey* key,
     const unsigned char* in, word32 len);
@@ -524,6 +542,14 @@ int mlkem_gen_matrix(MLKEM_PRF_T* prf, sword16* a, int kp, byte* seed,
 WOLFSSL_LOCAL
 int mlkem_get_noise(MLKEM_PRF_T* prf, int kp, sword16* vec1, sword16* vec2,
     sword16* poly, byte* seed);
+#ifdef WOLFSSL_MLKEM_BATCH
+WOLFSSL_LOCAL
+int mlkem_gen_matrix_batch(MLKEM_PRF_T* prf, sword16** a, int kp,
+    byte** seed, int cnt, int transposed);
+WOLFSSL_LOCAL
+int mlkem_get_noise_batch(MLKEM_PRF_T* prf, int kp, sword16** vec1,
+    sword16** vec2, sword16** poly, byte** seed, int cnt);
+#endif
 
 #if defined(USE_INTEL_SPEEDUP) || \
         (defined(WOLFSSL_ARMASM) && defined(__aarch64__))
@@ -1032,6 +1032,22 @@ WOLFSSL_API wolfSSL_Mutex* wc_InitAndAllocMutex(void);
     WOLFSSL_API int wc_LockRwLock_Rd(wolfSSL_RwLock* m);
     WOLFSSL_API int wc_UnLockRwLock(wolfSSL_RwLock* m);
 #endif
+#if defined(WOLFSSL_PTHREADS) && !defined(SINGLE_THREADED) && \
+    !defined(WC_MUTEX_OPS_INLINE) && !defined(WC_RWLOCK_OPS_INLINE) && \
+    !defined(__WATCOMC__) && !defined(MAXQ10XX_MUTEX)
+    /* Mutex that can be used by several processes when it is placed in shared
+     * memory. Unlock and free it with wc_UnLockMutex() and wc_FreeMutex().
+     * With WC_HAVE_ROBUST_MUTEX, when the process holding it dies the next
+     * wc_LockMutexShared() gets it and sets ownerDied so the caller can
+     * repair what it protects. Otherwise the other processes block forever. */
+    #define WC_HAVE_SHARED_MUTEX
+    #if (defined(__GLIBC__) || defined(__FreeBSD__)) && \
+        !defined(WOLFSSL_NO_ROBUST_MUTEX)
+        #define WC_HAVE_ROBUST_MUTEX
+    #endif
+    WOLFSSL_API int wc_InitMutexShared(wolfSSL_Mutex* m);
+    WOLFSSL_API int wc_LockMutexShared(wolfSSL_Mutex* m, int* ownerDied);
+#endif
 #if defined(OPENSSL_EXTRA) || defined(HAVE_WEBSERVER)
 /* dynamically set which mutex to use. unlock / lock is controlled by flag */
 typedef void (mutex_cb)(int flag, int type, const char* file, int line);
@@ -349,6 +349,13 @@ typedef struct XmssParams {
 #define XMSS_MAX_LABEL_LEN           32
 #endif
 
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+/* Maximum number of threads that compute leaf nodes of a tree. */
+#ifndef WC_XMSS_MAX_THREADS
+#define WC_XMSS_MAX_THREADS          64
+#endif
+#endif
+
 struct XmssKey {
     /* Public key. */
     unsigned char        pk[2 * WC_XMSS_MAX_N];
@@ -369,6 +376,10 @@ struct XmssKey {
     wc_xmss_read_private_key_cb  read_private_key;
     /* Context arg passed to callbacks. */
     void*                context;
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    /* Number of threads to compute leaf nodes with. */
+    word8                threads;
+#endif
 #endif /* ifndef WOLFSSL_XMSS_VERIFY_ONLY */
     /* Dynamic memory hint. */
     void*                heap;
@@ -398,6 +409,10 @@ struct XmssKey {
 typedef struct XmssState {
     const XmssParams* params;
     void* heap;
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+    /* Number of threads to compute leaf nodes with. */
+    word8 threads;
+#endif
 
     /* Digest is assumed to be at the end. */
     union {
@@ -448,6 +463,9 @@ WOLFSSL_API int  wc_XmssKey_SetWriteCb(XmssKey* key,
 WOLFSSL_API int  wc_XmssKey_SetReadCb(XmssKey* key,
     wc_xmss_read_private_key_cb read_cb);
 WOLFSSL_API int  wc_XmssKey_SetContext(XmssKey* key, void* context);
+#ifdef WOLFSSL_LMS_XMSS_THREADS
+WOLFSSL_API int  wc_XmssKey_SetThreads(XmssKey* key, int threads);
+#endif
 WOLFSSL_API int  wc_XmssKey_MakeKey(XmssKey* key, WC_RNG* rng);
 WOLFSSL_API int  wc_XmssKey_Reload(XmssKey* key);
 WOLFSSL_API int  wc_XmssKey_GetPrivLen(const XmssKey* key, word32* len);
@@ -472,6 +490,10 @@ WOLFSSL_API int  wc_XmssKey_ImportPubRaw_ex(XmssKey* key, const byte* in,
 WOLFSSL_API int  wc_XmssKey_Verify(XmssKey* key, const byte* sig, word32 sigSz,
     const byte* msg, int msgSz);
 
+WOLFSSL_LOCAL int wc_xmss_state_init(XmssState* state,
+    const XmssParams* params, void* heap);
+WOLFSSL_LOCAL void wc_xmss_state_free(XmssState* state);
+
 WOLFSSL_LOCAL int wc_xmssmt_keygen(XmssState *state, const unsigned char* seed,
     unsigned char *sk, unsigned char *pk);
 WOLFSSL_LOCAL int wc_xmss_keygen(XmssState *state, const unsigned char* seed,
@@ -576,6 +576,12 @@ WOLFSSL_API int wolfIO_TcpAccept(SOCKET_T sockfd, SOCKADDR* peer_addr, XSOCKLENT
 WOLFSSL_API int wolfIO_TcpBind(SOCKET_T* sockfd, word16 port);
 WOLFSSL_API  int wolfIO_Send(SOCKET_T sd, char *buf, int sz, int wrFlags);
 WOLFSSL_API  int wolfIO_Recv(SOCKET_T sd, char *buf, int sz, int rdFlags);
+#ifdef WOLFSSL_KTLS
+WOLFSSL_LOCAL int wolfIO_SendRecord(SOCKET_T sd, byte type, const byte* buf,
+    int sz, int wrFlags);
+WOLFSSL_LOCAL int wolfIO_RecvRecord(SOCKET_T sd, byte* type, byte* buf,
+    int sz, int rdFlags);
+#endif
 
 #ifdef WOLFSSL_HAVE_BIO_ADDR
 